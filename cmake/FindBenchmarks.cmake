@@ -1,3 +1,4 @@
+# Copyright (C) 2026  Igara Studio S.A.
 # Copyright (C) 2017  David Capello
 # Find benchmarks
 
@@ -9,6 +10,7 @@ function(find_benchmarks dir dependencies)
     get_filename_component(benchmarkname ${benchmarksourcefile} NAME_WE)
 
     add_executable(${benchmarkname} ${benchmarksourcefile})
+    set_property(GLOBAL APPEND PROPERTY aseprite_benchmarks ${benchmarkname})
 
     if(MSVC)
       # Fix problem compiling gen from a Visual Studio solution
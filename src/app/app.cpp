@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -41,6 +41,7 @@
 #include "app/resource_finder.h"
 #include "app/send_crash.h"
 #include "app/site.h"
+#include "app/startup_trace.h"
 #include "app/tools/active_tool.h"
 #include "app/tools/tool_box.h"
 #include "app/ui/backup_indicator.h"
@@ -129,16 +130,25 @@ public:
 
 class App::Modules {
 public:
+  // The StartupTrace marks attribute the construction time of the
+  // members above each mark to that mark (members are constructed in
+  // declaration order), so --trace-startup can report which module
+  // makes a cold start slow.
   LoggerModule m_loggerModule;
   FileSystemModule m_file_system_module;
   Extensions m_extensions;
+  StartupTrace::Mark m_extensionsMark{ "modules: extensions" };
   Strings m_strings; // Load main language (after loading the extensions)
+  StartupTrace::Mark m_stringsMark{ "modules: i18n strings" };
   tools::ToolBox m_toolbox;
+  StartupTrace::Mark m_toolboxMark{ "modules: toolbox (gui.xml)" };
   tools::ActiveToolManager m_activeToolManager;
   Commands m_commands;
+  StartupTrace::Mark m_commandsMark{ "modules: commands" };
   RecentFiles m_recent_files;
   InputChain m_inputChain;
   Clipboard m_clipboard;
+  StartupTrace::Mark m_otherMark{ "modules: recent files/clipboard" };
 #ifdef ENABLE_DATA_RECOVERY
   // This is a raw pointer because we want to delete it explicitly.
   // (e.g. if an exception occurs, the ~Modules() doesn't have to
@@ -249,6 +259,9 @@ App::App(AppMod* mod)
 
 int App::initialize(const AppOptions& options)
 {
+  if (options.traceStartup())
+    StartupTrace::instance()->enable();
+
   const os::SystemRef system = os::System::instance();
 
   // Without Skia backend we don't have GUI.
@@ -322,6 +335,7 @@ int App::initialize(const AppOptions& options)
   }
 
   initialize_color_spaces(pref);
+  StartupTrace::instance()->mark("core modules/UI system");
 
 #ifdef ENABLE_DRM
   LOG("APP: Initializing DRM...\n");
@@ -337,8 +351,11 @@ int App::initialize(const AppOptions& options)
   // Load modules
   m_modules = std::make_unique<Modules>(createLogInDesktop, pref);
   m_legacy = std::make_unique<LegacyModules>(isGui() ? REQUIRE_INTERFACE : 0);
+  StartupTrace::instance()->mark("legacy modules");
   m_appMenus = std::make_unique<AppMenus>(recentFiles());
+  StartupTrace::instance()->mark("menus");
   m_brushes = std::make_unique<AppBrushes>();
+  StartupTrace::instance()->mark("brushes");
 
   // Data recovery is enabled only in GUI mode
   if (isGui() && pref.general.dataRecovery())
@@ -350,6 +367,7 @@ int App::initialize(const AppOptions& options)
   // Load or create the default palette, or migrate the default
   // palette from an old format palette to the new one, etc.
   load_default_palette();
+  StartupTrace::instance()->mark("default palette");
 
   // Initialize GUI interface
   if (isGui()) {
@@ -372,6 +390,7 @@ int App::initialize(const AppOptions& options)
     m_mainWindow->initialize();
     if (m_mod)
       m_mod->modMainWindow(m_mainWindow.get());
+    StartupTrace::instance()->mark("main window");
 
     // Data recovery is enabled only in GUI mode
     if (pref.general.dataRecovery())
@@ -400,12 +419,26 @@ int App::initialize(const AppOptions& options)
     const bool gpu = Preferences::instance().general.gpuAcceleration();
     manager->updateAllDisplays(scale, gpu);
 #endif
+
+    StartupTrace::instance()->mark("open window");
   }
 
 #ifdef ENABLE_SCRIPTING
-  // Call the init() function from all plugins
-  LOG("APP: Initializing scripts...\n");
-  extensions().executeInitActions();
+  // Call the init() function from all plugins. When the GUI starts
+  // without CLI work to process, we defer this to the first
+  // event-loop cycle, so the main window can paint before (possibly
+  // slow) extension scripts run.
+  if (isGui() && options.values().empty()) {
+    ui::execute_from_ui_thread([this] {
+      LOG("APP: Initializing scripts...\n");
+      extensions().executeInitActions();
+    });
+  }
+  else {
+    LOG("APP: Initializing scripts...\n");
+    extensions().executeInitActions();
+    StartupTrace::instance()->mark("plugin init scripts");
+  }
 #endif
 
   // Process options
@@ -421,9 +454,12 @@ int App::initialize(const AppOptions& options)
     CliProcessor cli(delegate.get(), options);
     code = cli.process(context());
   }
+  StartupTrace::instance()->mark("process CLI options");
 
   LOG("APP: Finish launching...\n");
   system->finishLaunching();
+
+  StartupTrace::instance()->report();
   return code;
 }
 
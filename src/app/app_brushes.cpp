@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2024  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This program is distributed under the terms of
@@ -24,6 +24,7 @@
 
 #include "tinyxml2.h"
 
+#include <algorithm>
 #include <fstream>
 
 namespace app {
@@ -295,6 +296,67 @@ bool AppBrushes::isBrushSlotLocked(slot_id slot) const
     return false;
 }
 
+BrushRef AppBrushes::getComputedBrush(const BrushType type, const int size, const int angle)
+{
+  static const int kMaxComputedBrushes = 8;
+
+  // We check the current brush fields (instead of remembering the key
+  // it was created with) so a brush modified externally (setSize(),
+  // etc.) just stops matching.
+  for (auto it = m_computedBrushes.begin(); it != m_computedBrushes.end(); ++it) {
+    const BrushRef& cached = *it;
+    if (cached->type() == type && cached->size() == size && cached->angle() == angle) {
+      BrushRef result = cached;
+      m_computedBrushes.erase(it);
+      m_computedBrushes.push_back(result);
+      return result;
+    }
+  }
+
+  BrushRef brush = std::make_shared<Brush>(type, size, angle);
+  if (int(m_computedBrushes.size()) >= kMaxComputedBrushes)
+    m_computedBrushes.erase(m_computedBrushes.begin());
+  m_computedBrushes.push_back(brush);
+  return brush;
+}
+
+const MaskBoundaries& AppBrushes::getBrushBoundaries(const Brush* brush)
+{
+  ASSERT(brush);
+  static const int kMaxCachedBoundaries = 8;
+
+  const bool isImageBrush = (brush->type() == kImageBrushType);
+  for (auto it = m_boundariesCache.begin(); it != m_boundariesCache.end(); ++it) {
+    // Image brushes are matched by generation (gen() == 0 is
+    // ambiguous: freshly shared clones start there, so we never
+    // match it); computed brushes are fully determined by their
+    // (type, size, angle).
+    const bool match = (isImageBrush ? (it->gen != 0 && it->gen == brush->gen()) :
+                                       (it->type == brush->type() && it->size == brush->size() &&
+                                        it->angle == brush->angle()));
+    if (match) {
+      if (it != m_boundariesCache.end() - 1)
+        std::rotate(it, it + 1, m_boundariesCache.end());
+      return m_boundariesCache.back().boundaries;
+    }
+  }
+
+  if (int(m_boundariesCache.size()) >= kMaxCachedBoundaries)
+    m_boundariesCache.erase(m_boundariesCache.begin());
+
+  m_boundariesCache.push_back(
+    CachedBoundaries{ brush->type(), brush->size(), brush->angle(), brush->gen(), {} });
+  CachedBoundaries& entry = m_boundariesCache.back();
+
+  // Non-bitmap brushes (e.g. image brushes) keep a separated scanline
+  // mask, plain brushes are already a bitmap.
+  const Image* mask = (brush->image()->pixelFormat() != IMAGE_BITMAP ? brush->maskBitmap() :
+                                                                       brush->image());
+  ASSERT(mask);
+  entry.boundaries.regen(mask);
+  return entry.boundaries;
+}
+
 static const int kBrushFlags = int(BrushSlot::Flags::BrushType) | int(BrushSlot::Flags::BrushSize) |
                                int(BrushSlot::Flags::BrushAngle);
 
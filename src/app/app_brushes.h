@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2021  Igara Studio S.A.
+// Copyright (C) 2021-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This program is distributed under the terms of
@@ -11,6 +11,7 @@
 
 #include "app/brush_slot.h"
 #include "doc/brushes.h"
+#include "doc/mask_boundaries.h"
 #include "obs/signal.h"
 
 #include <string>
@@ -44,6 +45,21 @@ public:
   void unlockBrushSlot(slot_id slot);
   bool isBrushSlotLocked(slot_id slot) const;
 
+  // Returns a shared brush equivalent to Brush(type, size, angle),
+  // reusing a recently created instance when possible. Useful with
+  // dynamics, where the brush changes on each pointer event and
+  // recreating it means regenerating its image and scanline mask
+  // every time. Don't use it for brushes whose image will be modified
+  // in-place (e.g. dynamic gradient brushes converted to dithering
+  // brushes).
+  doc::BrushRef getComputedBrush(doc::BrushType type, int size, int angle);
+
+  // Returns the boundary segments that outline the brush mask,
+  // cached per (type, size, angle) for computed brushes and per
+  // generation for image brushes, so showing the brush edges doesn't
+  // cost a boundary trace per mouse event (or per editor).
+  const doc::MaskBoundaries& getBrushBoundaries(const doc::Brush* brush);
+
   obs::signal<void()> ItemsChange;
 
   static std::string userBrushesFilename();
@@ -53,9 +69,21 @@ private:
   void load(const std::string& filename);
   void save(const std::string& filename) const;
 
+  struct CachedBoundaries {
+    doc::BrushType type;
+    int size;
+    int angle;
+    int gen;
+    doc::MaskBoundaries boundaries;
+  };
+
   doc::Brushes m_standard;
   BrushSlots m_slots;
   std::string m_userBrushesFilename;
+
+  // Small MRU caches (most recently used items at the end).
+  doc::Brushes m_computedBrushes;
+  std::vector<CachedBoundaries> m_boundariesCache;
 };
 
 } // namespace app
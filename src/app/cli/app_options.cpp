@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2024  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -165,6 +165,7 @@ AppOptions::AppOptions(int argc, const char* argv[])
       m_po.add("export-tileset").description("Export only tilesets from visible tilemap layers"))
   , m_verbose(m_po.add("verbose").mnemonic('v').description("Explain what is being done"))
   , m_debug(m_po.add("debug").description("Extreme verbose mode and\ncopy log to desktop"))
+  , m_traceStartup(m_po.add("trace-startup").description("Print startup timings per module"))
 #ifdef ENABLE_STEAM
   , m_noInApp(m_po.add("noinapp").description(
       "Disable \"in game\" visibility on Steam\nDoesn't count playtime"))
@@ -206,6 +207,11 @@ bool AppOptions::hasExporterParams() const
   return m_po.enabled(m_data) || m_po.enabled(m_sheet);
 }
 
+bool AppOptions::traceStartup() const
+{
+  return m_po.enabled(m_traceStartup);
+}
+
 #ifdef ENABLE_STEAM
 bool AppOptions::noInApp() const
 {
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2024  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -95,6 +95,7 @@ public:
   const Option& exportTileset() const { return m_exportTileset; }
 
   bool hasExporterParams() const;
+  bool traceStartup() const;
 #ifdef ENABLE_STEAM
   bool noInApp() const;
 #endif
@@ -171,6 +172,7 @@ private:
 
   Option& m_verbose;
   Option& m_debug;
+  Option& m_traceStartup;
 #ifdef ENABLE_STEAM
   Option& m_noInApp;
 #endif
@@ -183,6 +183,27 @@ int CliProcessor::process(Context* ctx)
     render::DitheringAlgorithm ditheringAlgorithm = render::DitheringAlgorithm::None;
     std::string ditheringMatrix;
 
+    // In batch mode we start decoding all the given files in
+    // background jobs, so each openFile() call below just takes the
+    // already loaded document and something like
+    // "aseprite -b *.aseprite --save-as ..." saturates the CPU cores
+    // instead of decoding one file at a time.
+    if (!ctx->isUIAvailable()) {
+      base::paths allFramesFiles, oneFrameFiles;
+      bool oneFrame = false;
+      for (const auto& value : m_options.values()) {
+        const AppOptions::Option* opt = value.option();
+        if (!opt)
+          (oneFrame ? oneFrameFiles : allFramesFiles).push_back(base::normalize_path(value.value()));
+        else if (opt == &m_options.oneFrame())
+          oneFrame = true;
+      }
+      if (allFramesFiles.size() + oneFrameFiles.size() > 1) {
+        m_batch.prefetch(ctx, allFramesFiles, false);
+        m_batch.prefetch(ctx, oneFrameFiles, true);
+      }
+    }
+
     for (const auto& value : m_options.values()) {
       const AppOptions::Option* opt = value.option();
 
@@ -605,6 +626,10 @@ int CliProcessor::process(Context* ctx)
       }
     }
 
+    // Discard prefetched files that were never opened (e.g. files
+    // that were consumed as part of an image sequence).
+    OpenFilePrefetch::instance()->clear();
+
     if (m_exporter) {
       // Rows sprite sheet as the default type
       if (sheetType == SpriteSheetType::None)
@@ -1,4 +1,5 @@
 // Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -12,12 +13,116 @@
 #include "base/debug.h"
 #include "base/mem_utils.h"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <typeinfo>
+#include <vector>
 
 #define CMD_TRACE(...)
 
 namespace app {
 
+namespace {
+
+// Size-segregated pool behind Cmd::operator new/delete. Commands are
+// allocated in bursts while a transaction is being built and released
+// much later (when their undo state leaves the history), so chunks
+// are carved out of shared 64 KB blocks and recycled through per-size
+// free lists. Blocks are never returned to the system: the working
+// set is bounded by the undo history limit and stabilizes quickly.
+class CmdPool {
+public:
+  void* alloc(const std::size_t size)
+  {
+    const int c = sizeClass(size);
+    if (c < 0)
+      return ::operator new(size);
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_freelists[c]) {
+      // Carve a new block into chunks of this size class.
+      const std::size_t chunkSize = (kMinChunkSize << c);
+      auto block = std::make_unique<uint8_t[]>(kBlockSize);
+      uint8_t* p = block.get();
+      for (std::size_t i = 0; i + chunkSize <= kBlockSize; i += chunkSize)
+        push(c, p + i);
+      m_blocks.push_back(std::move(block));
+    }
+    FreeNode* node = m_freelists[c];
+    m_freelists[c] = node->next;
+    return node;
+  }
+
+  void free(void* ptr, const std::size_t size)
+  {
+    if (!ptr)
+      return;
+
+    const int c = sizeClass(size);
+    if (c < 0) {
+      ::operator delete(ptr);
+      return;
+    }
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    push(c, ptr);
+  }
+
+private:
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  // Chunks of 32, 64, 128, 256, and 512 bytes (almost all commands
+  // fit, bulky state like image backups lives in containers the
+  // commands point to anyway).
+  static const std::size_t kMinChunkSize = 32;
+  static const int kSizeClasses = 5;
+  static const std::size_t kBlockSize = 64 * 1024;
+
+  static int sizeClass(const std::size_t size)
+  {
+    std::size_t chunkSize = kMinChunkSize;
+    for (int c = 0; c < kSizeClasses; ++c, chunkSize <<= 1) {
+      if (size <= chunkSize)
+        return c;
+    }
+    return -1;
+  }
+
+  void push(const int c, void* ptr)
+  {
+    FreeNode* node = static_cast<FreeNode*>(ptr);
+    node->next = m_freelists[c];
+    m_freelists[c] = node;
+  }
+
+  std::mutex m_mutex;
+  FreeNode* m_freelists[kSizeClasses] = { nullptr };
+  std::vector<std::unique_ptr<uint8_t[]>> m_blocks;
+};
+
+CmdPool& cmd_pool()
+{
+  // Intentionally leaked so commands deleted during static
+  // destruction don't touch an already destroyed pool.
+  static CmdPool* pool = new CmdPool;
+  return *pool;
+}
+
+} // anonymous namespace
+
+void* Cmd::operator new(const std::size_t size)
+{
+  return cmd_pool().alloc(size);
+}
+
+void Cmd::operator delete(void* ptr, const std::size_t size)
+{
+  cmd_pool().free(ptr, size);
+}
+
 Cmd::Cmd()
 #if _DEBUG
   : m_state(State::NotExecuted)
@@ -89,6 +194,21 @@ size_t Cmd::memSize() const
   return onMemSize();
 }
 
+void Cmd::compressData()
+{
+  onCompressData();
+}
+
+bool Cmd::absorb(Cmd* cmd)
+{
+  return onAbsorb(cmd);
+}
+
+bool Cmd::modifiedRegion(gfx::Region& rgn) const
+{
+  return onModifiedRegion(rgn);
+}
+
 void Cmd::onExecute()
 {
   // Do nothing
@@ -120,4 +240,21 @@ size_t Cmd::onMemSize() const
   return sizeof(*this);
 }
 
+void Cmd::onCompressData()
+{
+  // Do nothing
+}
+
+bool Cmd::onAbsorb(Cmd* cmd)
+{
+  // By default commands don't know how to absorb other ones
+  return false;
+}
+
+bool Cmd::onModifiedRegion(gfx::Region& rgn) const
+{
+  // By default the modified region is unknown
+  return false;
+}
+
 } // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2023  Igara Studio SA
+// Copyright (C) 2023-2026  Igara Studio SA
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -10,8 +10,10 @@
 #pragma once
 
 #include "base/disable_copying.h"
+#include "gfx/fwd.h"
 #include "undo/undo_command.h"
 
+#include <cstddef>
 #include <string>
 
 namespace app {
@@ -23,6 +25,16 @@ public:
   Cmd();
   virtual ~Cmd();
 
+  // Pooled allocation for all commands: one stroke creates dozens of
+  // small Cmd objects, and the general-purpose allocator shows up in
+  // stroke-commit profiles (and scatters the commands of a sequence
+  // all over the heap, which is the worst case to replay them on
+  // undo/redo). Small commands are carved out of shared blocks that
+  // are recycled through free lists, bigger ones fall back to the
+  // global operator new.
+  void* operator new(std::size_t size);
+  void operator delete(void* ptr, std::size_t size);
+
   void execute(Context* ctx);
 
   // undo::UndoCommand impl
@@ -33,6 +45,31 @@ public:
   std::string label() const;
   size_t memSize() const;
 
+  // Compacts cold data kept by this command (e.g. compressing image
+  // backups) when the command is deep enough in the undo history
+  // (called by DocUndo, possibly from a background thread). Commands
+  // restore their data transparently when it's needed again, so this
+  // only trades undo/redo latency of old states for memory.
+  void compressData();
+
+  // Tries to absorb the given command (already executed, placed
+  // right after this one in the same sequence) into this one, so
+  // long runs of homogeneous commands -- e.g. a script moving
+  // thousands of cels -- collapse into one array-backed command
+  // instead of one Cmd (plus its undo bookkeeping) per edit. Returns
+  // true if "cmd" was merged into this command and the caller must
+  // dispose it (see CmdSequence::addAndExecute()).
+  bool absorb(Cmd* cmd);
+
+  // Returns true if this command knows the exact area of the sprite
+  // canvas that executing/undoing/redoing it repaints, adding that
+  // area (in canvas coordinates) to "rgn". With this information the
+  // editors can repaint just the modified region after an undo/redo
+  // instead of invalidating the whole sprite. Returning false means
+  // "unknown" (e.g. the command modifies an image but cannot locate
+  // it in the canvas), which falls back to a full update.
+  bool modifiedRegion(gfx::Region& rgn) const;
+
   Context* context() const { return m_ctx; }
 
 protected:
@@ -42,6 +79,9 @@ protected:
   virtual void onFireNotifications();
   virtual std::string onLabel() const;
   virtual size_t onMemSize() const;
+  virtual void onCompressData();
+  virtual bool onAbsorb(Cmd* cmd);
+  virtual bool onModifiedRegion(gfx::Region& rgn) const;
 
 private:
   // TODO I think we could just remove this field (but we'll need to
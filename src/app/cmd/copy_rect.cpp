@@ -11,8 +11,11 @@
 
 #include "app/cmd/copy_rect.h"
 
+#include "base/exception.h"
 #include "doc/image.h"
 
+#include "zlib.h"
+
 #include <algorithm>
 
 namespace app { namespace cmd {
@@ -53,11 +56,47 @@ void CopyRect::onRedo()
   swap();
 }
 
+void CopyRect::onCompressData()
+{
+  // Already compressed, or too small to be worth it
+  if (m_rawSize > 0 || m_data.size() < 1024)
+    return;
+
+  uLongf outSize = compressBound(m_data.size());
+  std::vector<uint8_t> compressed(outSize);
+  if (compress2(compressed.data(), &outSize, m_data.data(), m_data.size(), Z_BEST_SPEED) != Z_OK)
+    return; // Keep the raw pixels
+  if (outSize >= m_data.size())
+    return; // Incompressible data
+
+  compressed.resize(outSize);
+  compressed.shrink_to_fit();
+  m_rawSize = m_data.size();
+  m_data.swap(compressed);
+}
+
+void CopyRect::uncompressData()
+{
+  if (m_rawSize == 0)
+    return;
+
+  std::vector<uint8_t> raw(m_rawSize);
+  uLongf outSize = m_rawSize;
+  if (uncompress(raw.data(), &outSize, m_data.data(), m_data.size()) != Z_OK ||
+      outSize != m_rawSize) {
+    throw base::Exception("Error restoring compressed undo data");
+  }
+  m_data.swap(raw);
+  m_rawSize = 0;
+}
+
 void CopyRect::swap()
 {
   if (m_clip.size.w < 1 || m_clip.size.h < 1)
     return;
 
+  uncompressData();
+
   Image* image = this->image();
   int lineSize = this->lineSize();
   std::vector<uint8_t> tmp(lineSize);
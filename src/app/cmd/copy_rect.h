@@ -31,13 +31,20 @@ protected:
   void onUndo() override;
   void onRedo() override;
   size_t onMemSize() const override { return sizeof(*this) + m_data.size(); }
+  void onCompressData() override;
 
 private:
   void swap();
+  void uncompressData();
   int lineSize();
 
   gfx::Clip m_clip;
   std::vector<uint8_t> m_data;
+
+  // Size of the uncompressed m_data when it's deflated as a cold undo
+  // state (see Cmd::onCompressData()), or 0 if m_data contains the
+  // raw pixels.
+  size_t m_rawSize = 0;
 };
 
 }} // namespace app::cmd
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2020  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This program is distributed under the terms of
@@ -13,19 +13,25 @@
 
 #include "app/doc.h"
 #include "app/util/buffer_region.h"
+#include "base/exception.h"
+#include "doc/cel.h"
 #include "doc/image.h"
 #include "doc/sprite.h"
 #include "doc/tileset.h"
 
+#include "zlib.h"
+
 namespace app { namespace cmd {
 
 CopyRegion::CopyRegion(Image* dst,
                        const Image* src,
                        const gfx::Region& region,
                        const gfx::Point& dstPos,
-                       bool alreadyCopied)
+                       bool alreadyCopied,
+                       const doc::Cel* cel)
   : WithImage(dst)
   , m_alreadyCopied(alreadyCopied)
+  , m_celId(cel ? cel->id() : NullId)
 {
   ASSERT(!region.isEmpty());
 
@@ -75,12 +81,69 @@ void CopyRegion::swap()
   Image* image = this->image();
   ASSERT(image);
 
+  uncompressBuffer();
+
   swap_image_region_with_buffer(m_region, image, m_buffer);
   image->incrementVersion();
 
   rehash();
 }
 
+void CopyRegion::onCompressData()
+{
+  // Already compressed, or too small to be worth it
+  if (m_rawSize > 0 || m_buffer.size() < 1024)
+    return;
+
+  uLongf outSize = compressBound(m_buffer.size());
+  base::buffer compressed(outSize);
+  if (compress2(compressed.data(), &outSize, m_buffer.data(), m_buffer.size(), Z_BEST_SPEED) !=
+      Z_OK) {
+    return; // Keep the raw pixels
+  }
+  if (outSize >= m_buffer.size())
+    return; // Incompressible data
+
+  compressed.resize(outSize);
+  compressed.shrink_to_fit();
+  m_rawSize = m_buffer.size();
+  m_buffer.swap(compressed);
+}
+
+bool CopyRegion::onModifiedRegion(gfx::Region& rgn) const
+{
+  // Without a cel we cannot know where the image is inside the sprite
+  // canvas (doc::Image has no back-pointer to its cel).
+  if (m_celId == NullId)
+    return false;
+
+  const Cel* cel = get<Cel>(m_celId);
+  ASSERT(cel);
+  if (!cel)
+    return false;
+
+  // m_region is in "dst" image coordinates
+  gfx::Region canvasRgn = m_region;
+  canvasRgn.offset(cel->position());
+  rgn |= canvasRgn;
+  return true;
+}
+
+void CopyRegion::uncompressBuffer()
+{
+  if (m_rawSize == 0)
+    return;
+
+  base::buffer raw(m_rawSize);
+  uLongf outSize = m_rawSize;
+  if (uncompress(raw.data(), &outSize, m_buffer.data(), m_buffer.size()) != Z_OK ||
+      outSize != m_rawSize) {
+    throw base::Exception("Error restoring compressed undo data");
+  }
+  m_buffer.swap(raw);
+  m_rawSize = 0;
+}
+
 void CopyTileRegion::rehash()
 {
   ASSERT(m_tileIndex != notile);
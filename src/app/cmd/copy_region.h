@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2020  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This program is distributed under the terms of
@@ -12,13 +12,15 @@
 #include "app/cmd.h"
 #include "app/cmd/with_image.h"
 #include "base/buffer.h"
+#include "doc/object_id.h"
 #include "doc/tile.h"
 #include "gfx/point.h"
 #include "gfx/region.h"
 
 namespace doc {
+class Cel;
 class Tileset;
-}
+} // namespace doc
 
 namespace app { namespace cmd {
 using namespace doc;
@@ -30,25 +32,40 @@ public:
   // pixels from src to dst. If it's true, it means that "onExecute"
   // should do nothing, because modified pixels are alreadt on "dst"
   // (so we use "src" as the original image).
+  //
+  // The optional "cel" is the cel that contains "dst", used only to
+  // locate the copied region inside the sprite canvas (so undo/redo
+  // can repaint just that area). Specify it only when the cel
+  // position doesn't change along the life of this command.
   CopyRegion(Image* dst,
              const Image* src,
              const gfx::Region& region,
              const gfx::Point& dstPos,
-             bool alreadyCopied = false);
+             bool alreadyCopied = false,
+             const doc::Cel* cel = nullptr);
 
 protected:
   void onExecute() override;
   void onUndo() override;
   void onRedo() override;
   size_t onMemSize() const override { return sizeof(*this) + m_buffer.size(); }
+  void onCompressData() override;
+  bool onModifiedRegion(gfx::Region& rgn) const override;
 
 private:
   void swap();
+  void uncompressBuffer();
   virtual void rehash() {}
 
   bool m_alreadyCopied;
   gfx::Region m_region;
   base::buffer m_buffer;
+  doc::ObjectId m_celId;
+
+  // Size of the uncompressed m_buffer when it's deflated as a cold
+  // undo state (see Cmd::onCompressData()), or 0 if m_buffer contains
+  // the raw pixels.
+  size_t m_rawSize = 0;
 };
 
 class CopyTileRegion : public CopyRegion {
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -28,6 +28,7 @@
 #include "app/doc.h"
 #include "app/i18n/strings.h"
 #include "app/restore_visible_layers.h"
+#include "app/sprite_job.h"
 #include "doc/algorithm/shrink_bounds.h"
 #include "doc/cel.h"
 #include "doc/layer.h"
@@ -36,6 +37,7 @@
 #include "render/render.h"
 
 #include <algorithm>
+#include <vector>
 
 namespace app { namespace cmd {
 
@@ -92,9 +94,6 @@ void FlattenLayers::onExecute()
     area.setSize(spec.size());
   }
 
-  // Create a temporary image.
-  ImageRef image(Image::create(spec));
-
   LayerImage* flatLayer; // The layer onto which everything will be flattened.
   color_t bgcolor;       // The background color to use for flatLayer.
   bool newFlatLayer = false;
@@ -119,10 +118,6 @@ void FlattenLayers::onExecute()
     bgcolor = sprite->transparentColor();
   }
 
-  render::Render render;
-  render.setNewBlend(m_options.newBlendMethod);
-  render.setBgOptions(render::BgOptions::MakeNone());
-
   {
     // Show only the layers to be flattened so other layers are hidden
     // temporarily.
@@ -134,42 +129,69 @@ void FlattenLayers::onExecute()
     // Map draw area to image coords
     const gfx::ClipF area_to_image(0, 0, area);
 
-    // Copy all frames to the background.
-    for (frame_t frame(0); frame < sprite->totalFrames(); ++frame) {
-      // If the flatLayer is the only cel in this frame, we can skip
-      // this frame to keep existing links in the flatLayer.
-      const bool anotherCelExists = std::any_of(visibleLayers.begin(),
-                                                visibleLayers.end(),
-                                                [flatLayer, frame](const Layer* other) {
-                                                  return (flatLayer != other && other->cel(frame));
-                                                });
-      if (!anotherCelExists)
-        continue;
+    const frame_t nframes = sprite->totalFrames();
+
+    // If the flatLayer is the only cel in a frame, we can skip that
+    // frame to keep existing links in the flatLayer.
+    std::vector<bool> renderFrame(nframes, false);
+    for (frame_t frame(0); frame < nframes; ++frame) {
+      renderFrame[frame] = std::any_of(visibleLayers.begin(),
+                                       visibleLayers.end(),
+                                       [flatLayer, frame](const Layer* other) {
+                                         return (flatLayer != other && other->cel(frame));
+                                       });
+    }
 
-      // Clear the image and render this frame.
+    // Render all frames in parallel (each render only reads the
+    // sprite and writes its own temporary image, which is then
+    // shrunk to the exact bounds of the rendered content, a null
+    // image meaning a fully transparent frame). Modifying the sprite
+    // with the undoable sub-cmds is left for the serial loop below.
+    std::vector<ImageRef> newImages(nframes);
+    std::vector<gfx::Rect> newBounds(nframes);
+    SpriteJob::forkJoinCels(nframes, nullptr, [&](int i, render::TaskDelegate*) {
+      const frame_t frame(i);
+      if (!renderFrame[frame])
+        return;
+
+      ImageRef image(Image::create(spec));
       clear_image(image.get(), bgcolor);
+
+      render::Render render;
+      render.setNewBlend(m_options.newBlendMethod);
+      render.setBgOptions(render::BgOptions::MakeNone());
       render.renderSprite(image.get(), sprite, frame, area_to_image);
 
       // Get exact bounds for rendered frame
       gfx::Rect bounds = image->bounds();
-      const bool shrink = doc::algorithm::shrink_bounds(image.get(),
-                                                        image->maskColor(),
-                                                        nullptr,
-                                                        image->bounds(),
-                                                        bounds);
+      if (doc::algorithm::shrink_bounds(image.get(),
+                                        image->maskColor(),
+                                        nullptr,
+                                        image->bounds(),
+                                        bounds)) {
+        // Apply shrunk bounds to new image
+        newImages[frame] = ImageRef(doc::crop_image(image.get(), bounds, image->maskColor()));
+        newBounds[frame] = bounds;
+      }
+    });
+
+    // Copy all frames to the background.
+    for (frame_t frame(0); frame < nframes; ++frame) {
+      if (!renderFrame[frame])
+        continue;
+
+      const ImageRef new_image = newImages[frame];
+      const gfx::Rect bounds = newBounds[frame];
 
       // Skip when fully transparent
       Cel* cel = flatLayer->cel(frame);
-      if (!shrink) {
+      if (!new_image) {
         if (!newFlatLayer && cel)
           executeAndAdd(new cmd::RemoveCel(cel));
 
         continue;
       }
 
-      // Apply shrunk bounds to new image
-      const ImageRef new_image(doc::crop_image(image.get(), bounds, image->maskColor()));
-
       // Replace image on existing cel
       if (cel) {
         // TODO Keep cel links when possible
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2016  David Capello
 //
 // This program is distributed under the terms of
@@ -51,6 +51,11 @@ void PatchCel::onExecute()
     newBounds = cel->bounds() | gfx::Rect(m_region.bounds()).offset(m_pos);
   }
 
+  // TrimCel can shrink the cel afterwards, but the trimmed borders
+  // were transparent anyway, so the visible changes are inside these
+  // bounds.
+  m_affectedBounds = newBounds;
+
   if (cel->bounds() != newBounds)
     executeAndAdd(new CropCel(cel, newBounds));
 
@@ -67,4 +72,12 @@ void PatchCel::onExecute()
   m_patch = nullptr;
 }
 
+bool PatchCel::onModifiedRegion(gfx::Region& rgn) const
+{
+  if (m_affectedBounds.isEmpty())
+    return false;
+  rgn |= gfx::Region(m_affectedBounds);
+  return true;
+}
+
 }} // namespace app::cmd
@@ -1,4 +1,5 @@
 // Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This program is distributed under the terms of
@@ -12,6 +13,7 @@
 #include "app/cmd_sequence.h"
 #include "gfx/fwd.h"
 #include "gfx/point.h"
+#include "gfx/rect.h"
 
 namespace doc {
 class Cel;
@@ -30,10 +32,16 @@ public:
 
 protected:
   void onExecute() override;
+  bool onModifiedRegion(gfx::Region& rgn) const override;
 
   const doc::Image* m_patch;
   const gfx::Region& m_region;
   gfx::Point m_pos;
+
+  // Canvas area covered by the whole patch (old cel bounds + patched
+  // region), calculated in onExecute(). Used to report the exact
+  // region that undoing/redoing this patch repaints.
+  gfx::Rect m_affectedBounds;
 };
 
 }} // namespace app::cmd
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2023  Igara Studio S.A.
+// Copyright (C) 2023-2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This program is distributed under the terms of
@@ -34,12 +34,18 @@ ReplaceImage::ReplaceImage(Sprite* sprite, const ImageRef& oldImage, const Image
 
 void ReplaceImage::onExecute()
 {
-  // Save old image in m_copy. We cannot keep an ImageRef to this
-  // image, because there are other undo branches that could try to
-  // modify/re-add this same image ID
+  // Save old image in m_diff/m_copy. We cannot keep an ImageRef to
+  // this image, because there are other undo branches that could try
+  // to modify/re-add this same image ID.
+  //
+  // When both images have the same specs (e.g. a filter or a color
+  // mode conversion between same-size images) we save only the
+  // pixels of the region where they differ, which is a lot cheaper
+  // than a full copy for localized edits on big images.
   ImageRef oldImage = sprite()->getImageRef(m_oldImageId);
   ASSERT(oldImage);
-  m_copy.reset(Image::createCopy(oldImage.get()));
+  if (!m_diff.create(oldImage.get(), m_newImage.get()))
+    m_copy.reset(Image::createCopy(oldImage.get()));
 
   replaceImage(m_oldImageId, m_newImage);
   m_newImage.reset();
@@ -50,10 +56,20 @@ void ReplaceImage::onUndo()
   ImageRef newImage = sprite()->getImageRef(m_newImageId);
   ASSERT(newImage);
   ASSERT(!sprite()->getImageRef(m_oldImageId));
-  m_copy->setId(m_oldImageId);
 
-  replaceImage(m_newImageId, m_copy);
-  m_copy.reset(Image::createCopy(newImage.get()));
+  ImageRef restore;
+  if (m_diff.valid()) {
+    // Recreate the old image from the new one + the saved diff
+    // pixels (the diff flips to keep the new side for onRedo()).
+    restore = m_diff.apply(newImage.get());
+  }
+  else {
+    restore = m_copy;
+    m_copy.reset(Image::createCopy(newImage.get()));
+  }
+  restore->setId(m_oldImageId);
+
+  replaceImage(m_newImageId, restore);
 }
 
 void ReplaceImage::onRedo()
@@ -61,10 +77,18 @@ void ReplaceImage::onRedo()
   ImageRef oldImage = sprite()->getImageRef(m_oldImageId);
   ASSERT(oldImage);
   ASSERT(!sprite()->getImageRef(m_newImageId));
-  m_copy->setId(m_newImageId);
 
-  replaceImage(m_oldImageId, m_copy);
-  m_copy.reset(Image::createCopy(oldImage.get()));
+  ImageRef restore;
+  if (m_diff.valid()) {
+    restore = m_diff.apply(oldImage.get());
+  }
+  else {
+    restore = m_copy;
+    m_copy.reset(Image::createCopy(oldImage.get()));
+  }
+  restore->setId(m_newImageId);
+
+  replaceImage(m_oldImageId, restore);
 }
 
 void ReplaceImage::replaceImage(ObjectId oldId, const ImageRef& newImage)
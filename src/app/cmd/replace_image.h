@@ -1,4 +1,5 @@
 // Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This program is distributed under the terms of
@@ -10,6 +11,7 @@
 
 #include "app/cmd.h"
 #include "app/cmd/with_sprite.h"
+#include "app/util/image_diff.h"
 #include "doc/image_ref.h"
 
 #include <sstream>
@@ -26,7 +28,11 @@ protected:
   void onExecute() override;
   void onUndo() override;
   void onRedo() override;
-  size_t onMemSize() const override { return sizeof(*this) + (m_copy ? m_copy->getMemSize() : 0); }
+  size_t onMemSize() const override
+  {
+    return sizeof(*this) + (m_copy ? m_copy->getMemSize() : 0) + m_diff.memSize();
+  }
+  void onCompressData() override { m_diff.compress(); }
 
 private:
   void replaceImage(ObjectId oldId, const ImageRef& newImage);
@@ -38,6 +44,11 @@ private:
   // ReplaceImage() ctor until the ReplaceImage::onExecute() call.
   // Then the reference is not used anymore.
   ImageRef m_newImage;
+
+  // When both images have the same specs we keep only the pixels of
+  // the region where they differ (m_diff), in other case m_copy
+  // keeps a full copy of the replaced image.
+  ImageDiff m_diff;
   ImageRef m_copy;
 };
 
@@ -1,4 +1,5 @@
 // Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This program is distributed under the terms of
@@ -48,6 +49,12 @@ void SetCelData::onUndo()
 
   if (m_dataCopy) {
     ASSERT(!cel->sprite()->getCelDataRef(m_oldDataId));
+
+    // Recreate the old image from the new one (still in the cel)
+    // plus the saved diff pixels.
+    if (m_diff.valid())
+      m_dataCopy->setImage(m_diff.apply(cel->image()), cel->layer());
+
     m_dataCopy->setId(m_oldDataId);
     m_dataCopy->image()->setId(m_oldImageId);
 
@@ -81,7 +88,28 @@ void SetCelData::createCopy()
 
   ASSERT(!m_dataCopy);
   m_dataCopy.reset(new CelData(*cel->data()));
-  m_dataCopy->setImage(ImageRef(Image::createCopy(cel->image())), cel->layer());
+
+  CelDataRef newData = (m_newData ? m_newData : cel->sprite()->getCelDataRef(m_newDataId));
+  ASSERT(newData);
+
+  if (m_diff.valid()) {
+    // Redo case: flip the diff so it keeps the old side pixels
+    // again for the next onUndo() (the returned new image copy is
+    // discarded, the real new image is alive in the sprite).
+    m_diff.apply(cel->image());
+  }
+  else if (!m_diff.create(cel->image(), newData->image())) {
+    // Different specs: keep a full copy of the old image.
+    m_dataCopy->setImage(ImageRef(Image::createCopy(cel->image())), cel->layer());
+    return;
+  }
+
+  // When the images have the same specs we save only the pixels of
+  // the region where they differ. We cannot keep the old image
+  // alive in the undo history (that's the whole copy we are
+  // avoiding), so we share the new one (alive in the sprite) as a
+  // placeholder until onUndo() recreates the old image.
+  m_dataCopy->setImage(newData->imageRef(), cel->layer());
 }
 
 }} // namespace app::cmd
@@ -1,4 +1,5 @@
 // Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This program is distributed under the terms of
@@ -10,6 +11,7 @@
 
 #include "app/cmd.h"
 #include "app/cmd/with_cel.h"
+#include "app/util/image_diff.h"
 #include "doc/cel_data.h"
 
 #include <sstream>
@@ -28,8 +30,13 @@ protected:
   void onRedo() override;
   size_t onMemSize() const override
   {
+    // When the diff is valid, m_dataCopy shares the live image (see
+    // SetCelData::createCopy()), so we don't count its memory here.
+    if (m_diff.valid())
+      return sizeof(*this) + (m_dataCopy ? sizeof(CelData) : 0) + m_diff.memSize();
     return sizeof(*this) + (m_dataCopy ? m_dataCopy->getMemSize() : 0);
   }
+  void onCompressData() override { m_diff.compress(); }
 
 private:
   void createCopy();
@@ -39,6 +46,11 @@ private:
   ObjectId m_newDataId;
   CelDataRef m_dataCopy;
 
+  // When the old and new images have the same specs we keep only
+  // the pixels of the region where they differ instead of a full
+  // copy of the old image inside m_dataCopy.
+  ImageDiff m_diff;
+
   // Reference used only to keep the copy of the new CelData from
   // the SetCelData() ctor until the SetCelData::onExecute() call.
   // Then the reference is not used anymore.
@@ -1,4 +1,5 @@
 // Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -19,34 +20,62 @@ namespace app { namespace cmd {
 using namespace doc;
 
 SetCelPosition::SetCelPosition(Cel* cel, int x, int y)
-  : WithCel(cel)
-  , m_oldX(cel->x())
-  , m_oldY(cel->y())
-  , m_newX(x)
-  , m_newY(y)
 {
+  m_entries.push_back(Entry{ cel->id(), cel->x(), cel->y(), x, y });
 }
 
 void SetCelPosition::onExecute()
 {
-  cel()->data()->setPosition(gfx::Point(m_newX, m_newY));
-  cel()->data()->incrementVersion();
+  for (const Entry& entry : m_entries) {
+    Cel* cel = get<Cel>(entry.celId);
+    cel->data()->setPosition(gfx::Point(entry.newX, entry.newY));
+    cel->data()->incrementVersion();
+  }
 }
 
 void SetCelPosition::onUndo()
 {
-  cel()->data()->setPosition(gfx::Point(m_oldX, m_oldY));
-  cel()->data()->incrementVersion();
+  for (auto it = m_entries.rbegin(), end = m_entries.rend(); it != end; ++it) {
+    Cel* cel = get<Cel>(it->celId);
+    cel->data()->setPosition(gfx::Point(it->oldX, it->oldY));
+    cel->data()->incrementVersion();
+  }
+}
+
+bool SetCelPosition::onAbsorb(Cmd* cmd)
+{
+  auto* other = dynamic_cast<SetCelPosition*>(cmd);
+  if (!other)
+    return false;
+
+  for (const Entry& entry : other->m_entries) {
+    // Collapse consecutive movements of the same cel into one entry
+    // (keeping the oldest position to undo), so the undo information
+    // doesn't grow while e.g. dragging one cel around.
+    if (!m_entries.empty() && m_entries.back().celId == entry.celId) {
+      m_entries.back().newX = entry.newX;
+      m_entries.back().newY = entry.newY;
+    }
+    else {
+      m_entries.push_back(entry);
+    }
+  }
+  return true;
 }
 
 void SetCelPosition::onFireNotifications()
 {
-  Cel* cel = this->cel();
-  Doc* doc = static_cast<Doc*>(cel->document());
-  DocEvent ev(doc);
-  ev.sprite(cel->sprite());
-  ev.cel(cel);
-  doc->notify_observers<DocEvent&>(&DocObserver::onCelPositionChanged, ev);
+  for (const Entry& entry : m_entries) {
+    Cel* cel = get<Cel>(entry.celId);
+    if (!cel)
+      continue;
+
+    Doc* doc = static_cast<Doc*>(cel->document());
+    DocEvent ev(doc);
+    ev.sprite(cel->sprite());
+    ev.cel(cel);
+    doc->notify_observers<DocEvent&>(&DocObserver::onCelPositionChanged, ev);
+  }
 }
 
 }} // namespace app::cmd
@@ -1,4 +1,5 @@
 // Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This program is distributed under the terms of
@@ -9,25 +10,41 @@
 #pragma once
 
 #include "app/cmd.h"
-#include "app/cmd/with_cel.h"
+#include "doc/object_id.h"
+
+#include <vector>
+
+namespace doc {
+class Cel;
+}
 
 namespace app { namespace cmd {
 using namespace doc;
 
-class SetCelPosition : public Cmd,
-                       public WithCel {
+class SetCelPosition : public Cmd {
 public:
   SetCelPosition(Cel* cel, int x, int y);
 
 protected:
   void onExecute() override;
   void onUndo() override;
+  bool onAbsorb(Cmd* cmd) override;
   void onFireNotifications() override;
-  size_t onMemSize() const override { return sizeof(*this); }
+  size_t onMemSize() const override
+  {
+    return sizeof(*this) + sizeof(Entry) * m_entries.capacity();
+  }
 
 private:
-  int m_oldX, m_oldY;
-  int m_newX, m_newY;
+  // One entry per moved cel. Runs of consecutive SetCelPosition
+  // commands (e.g. a script repositioning all the cels of a rig) are
+  // absorbed into one command instead of keeping one Cmd per cel.
+  struct Entry {
+    ObjectId celId;
+    int oldX, oldY;
+    int newX, newY;
+  };
+  std::vector<Entry> m_entries;
 };
 
 }} // namespace app::cmd
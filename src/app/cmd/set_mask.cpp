@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -13,51 +13,155 @@
 
 #include "app/doc.h"
 #include "doc/mask.h"
+#include "doc/primitives.h"
+
+#include <memory>
 
 namespace app { namespace cmd {
 
+namespace {
+
+// Returns the region with the pixels that are selected in one mask
+// but not in the other one (masks can be nullptr = empty).
+gfx::Region calc_xor_region(const Mask* a, const Mask* b)
+{
+  gfx::Region delta;
+  gfx::Rect bounds;
+  if (a)
+    bounds = a->bounds();
+  if (b)
+    bounds = bounds.createUnion(b->bounds());
+
+  for (int y = bounds.y; y < bounds.y2(); ++y) {
+    int runStart = 0;
+    bool inRun = false;
+    for (int x = bounds.x; x < bounds.x2(); ++x) {
+      const bool diff = ((a && a->containsPoint(x, y)) != (b && b->containsPoint(x, y)));
+      if (diff && !inRun) {
+        runStart = x;
+        inRun = true;
+      }
+      else if (!diff && inRun) {
+        delta |= gfx::Region(gfx::Rect(runStart, y, x - runStart, 1));
+        inRun = false;
+      }
+    }
+    if (inRun)
+      delta |= gfx::Region(gfx::Rect(runStart, y, bounds.x2() - runStart, 1));
+  }
+  return delta;
+}
+
+// Inverts the bits of the mask bitmap inside the given rectangle
+// (given in canvas coordinates).
+void toggle_mask_rect(Mask* mask, const gfx::Rect& rc)
+{
+  gfx::Rect localRc = (rc & mask->bounds());
+  localRc.offset(-mask->bounds().x, -mask->bounds().y);
+  if (localRc.isEmpty())
+    return;
+
+  LockImageBits<BitmapTraits> bits(mask->bitmap(), localRc);
+  for (auto it = bits.begin(), end = bits.end(); it != end; ++it)
+    *it = (*it ? 0 : 1);
+}
+
+// Rebuilds the mask at one endpoint of the delta: copies the current
+// mask bits inside "bounds" and toggles all pixels covered by the
+// delta region.
+std::unique_ptr<Mask> reconstruct_mask(const Mask* current,
+                                       const gfx::Region& delta,
+                                       const gfx::Rect& bounds,
+                                       const std::string& name)
+{
+  std::unique_ptr<Mask> mask(new Mask);
+  mask->setName(name.c_str());
+  if (!bounds.isEmpty()) {
+    mask->reserve(bounds);
+    if (current && current->bitmap()) {
+      copy_image(mask->bitmap(),
+                 current->bitmap(),
+                 current->bounds().x - bounds.x,
+                 current->bounds().y - bounds.y);
+    }
+    for (const auto& rc : delta)
+      toggle_mask_rect(mask.get(), rc);
+  }
+  return mask;
+}
+
+} // anonymous namespace
+
 SetMask::SetMask(Doc* doc, const Mask* newMask)
   : WithDocument(doc)
-  , m_oldMask(doc->isMaskVisible() ? new Mask(*doc->mask()) : nullptr)
-  , m_newMask(newMask && !newMask->isEmpty() ? new Mask(*newMask) : nullptr)
 {
+  calcDelta((doc->isMaskVisible() ? doc->mask() : nullptr),
+            (newMask && !newMask->isEmpty() ? newMask : nullptr));
 }
 
 void SetMask::setNewMask(const Mask* newMask)
 {
-  m_newMask.reset(newMask ? new Mask(*newMask) : nullptr);
-  setMask(m_newMask.get());
+  Doc* doc = document();
+
+  // The document contains the mask set by onExecute() at this point,
+  // so we undo the delta to recover the old mask and recompute the
+  // delta against the replacement.
+  std::unique_ptr<Mask> oldMask = reconstruct_mask((doc->isMaskVisible() ? doc->mask() : nullptr),
+                                                   m_delta,
+                                                   m_oldBounds,
+                                                   m_oldName);
+  calcDelta((oldMask->isEmpty() ? nullptr : oldMask.get()),
+            (newMask && !newMask->isEmpty() ? newMask : nullptr));
+
+  if (newMask)
+    setMask(newMask);
+  else {
+    Mask empty;
+    setMask(&empty);
+  }
 }
 
 void SetMask::onExecute()
 {
-  setMask(m_newMask.get());
+  applyDelta(m_newBounds, m_newName);
 }
 
 void SetMask::onUndo()
 {
-  setMask(m_oldMask.get());
+  applyDelta(m_oldBounds, m_oldName);
 }
 
 size_t SetMask::onMemSize() const
 {
-  return sizeof(*this) + (m_oldMask ? m_oldMask->getMemSize() : 0) +
-         (m_newMask ? m_newMask->getMemSize() : 0);
+  return sizeof(*this) + m_delta.size() * sizeof(gfx::Rect);
+}
+
+void SetMask::calcDelta(const Mask* oldMask, const Mask* newMask)
+{
+  m_oldBounds = (oldMask ? oldMask->bounds() : gfx::Rect());
+  m_newBounds = (newMask ? newMask->bounds() : gfx::Rect());
+  m_oldName = (oldMask ? oldMask->name() : std::string());
+  m_newName = (newMask ? newMask->name() : std::string());
+  m_delta = calc_xor_region(oldMask, newMask);
+}
+
+void SetMask::applyDelta(const gfx::Rect& targetBounds, const std::string& targetName)
+{
+  Doc* doc = document();
+  std::unique_ptr<Mask> target = reconstruct_mask((doc->isMaskVisible() ? doc->mask() : nullptr),
+                                                  m_delta,
+                                                  targetBounds,
+                                                  targetName);
+  setMask(target.get());
 }
 
 void SetMask::setMask(const Mask* mask)
 {
+  ASSERT(mask);
   Doc* doc = document();
 
-  if (mask) {
-    doc->setMask(mask);
-    doc->setMaskVisible(!mask->isEmpty());
-  }
-  else {
-    Mask empty;
-    doc->setMask(&empty);
-    doc->setMaskVisible(false);
-  }
+  doc->setMask(mask);
+  doc->setMaskVisible(!mask->isEmpty());
 
   doc->notifySelectionChanged();
 }
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -11,9 +11,10 @@
 
 #include "app/cmd.h"
 #include "app/cmd/with_document.h"
+#include "gfx/rect.h"
+#include "gfx/region.h"
 
-#include <memory>
-#include <sstream>
+#include <string>
 
 namespace doc {
 class Mask;
@@ -36,10 +37,20 @@ protected:
   size_t onMemSize() const override;
 
 private:
+  void calcDelta(const Mask* oldMask, const Mask* newMask);
+  void applyDelta(const gfx::Rect& targetBounds, const std::string& targetName);
   void setMask(const Mask* mask);
 
-  std::unique_ptr<Mask> m_oldMask;
-  std::unique_ptr<Mask> m_newMask;
+  // Instead of snapshotting the old/new masks (which costs two
+  // full bitmaps per marquee adjustment in the undo history), we
+  // store the XOR between both masks as a region, so each selection
+  // step costs a few rectangles and undo/redo just toggles the delta
+  // over the current mask.
+  gfx::Region m_delta;
+  gfx::Rect m_oldBounds;
+  gfx::Rect m_newBounds;
+  std::string m_oldName;
+  std::string m_newName;
 };
 
 }} // namespace app::cmd
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -18,36 +18,44 @@
 #include "app/cmd/set_transparent_color.h"
 #include "app/doc.h"
 #include "app/doc_event.h"
+#include "app/sprite_job.h"
 #include "doc/cel.h"
 #include "doc/cels_range.h"
 #include "doc/document.h"
 #include "doc/layer.h"
+#include "doc/octree_map.h"
 #include "doc/palette.h"
 #include "doc/rgbmap.h"
+#include "doc/rgbmap_rgb5a3.h"
 #include "doc/sprite.h"
 #include "doc/tilesets.h"
 #include "render/quantization.h"
 #include "render/task_delegate.h"
 
+#include <memory>
+#include <vector>
+
 namespace app { namespace cmd {
 
 using namespace doc;
 
 namespace {
 
-class SuperDelegate : public render::TaskDelegate {
+// Forwards the progress of one step (one image or a group of them)
+// to the portion [from, to] of the whole task progress.
+class PortionDelegate : public render::TaskDelegate {
 public:
-  SuperDelegate(int nimages, render::TaskDelegate* delegate)
-    : m_nimages(nimages)
-    , m_curImage(0)
-    , m_delegate(delegate)
+  PortionDelegate(render::TaskDelegate* delegate, const double from, const double to)
+    : m_delegate(delegate)
+    , m_from(from)
+    , m_to(to)
   {
   }
 
   void notifyTaskProgress(double progress) override
   {
     if (m_delegate)
-      m_delegate->notifyTaskProgress((progress + m_curImage) / m_nimages);
+      m_delegate->notifyTaskProgress(m_from + progress * (m_to - m_from));
   }
 
   bool continueTask() override
@@ -58,12 +66,10 @@ public:
       return true;
   }
 
-  void nextImage() { ++m_curImage; }
-
 private:
-  int m_nimages;
-  int m_curImage;
   TaskDelegate* m_delegate;
+  double m_from;
+  double m_to;
 };
 
 } // anonymous namespace
@@ -82,12 +88,17 @@ SetPixelFormat::SetPixelFormat(Sprite* sprite,
   if (sprite->pixelFormat() == newFormat)
     return;
 
-  // Calculate the number of images to convert just to show a proper
-  // progress bar.
-  tile_index nimages = 0;
+  // Collect the cel images to convert (they are unique cels, so
+  // each one has its own image and can be converted independently of
+  // the others).
+  std::vector<Cel*> cels;
   for (Cel* cel : sprite->uniqueCels())
     if (!cel->layer()->isTilemap())
-      ++nimages;
+      cels.push_back(cel);
+
+  // Calculate the number of images to convert just to show a proper
+  // progress bar.
+  tile_index nimages = tile_index(cels.size());
   if (sprite->hasTilesets()) {
     for (Tileset* tileset : *sprite->tilesets()) {
       if (tileset)
@@ -95,29 +106,36 @@ SetPixelFormat::SetPixelFormat(Sprite* sprite,
     }
   }
 
-  SuperDelegate superDel(nimages, delegate);
-
-  // Convert cel images
-  for (Cel* cel : sprite->uniqueCels()) {
-    if (cel->layer()->isTilemap())
-      continue;
-
-    ImageRef oldImage = cel->imageRef();
-    convertImage(sprite,
-                 dithering,
-                 oldImage,
-                 cel->frame(),
-                 cel->layer()->isBackground(),
-                 mapAlgorithm,
-                 toGray,
-                 &superDel,
-                 fitCriteria);
-
-    superDel.nextImage();
+  // Convert cel images in parallel, one task per cel. Each
+  // conversion reads shared state (palettes, layers) and writes only
+  // its own new image, so the only serial part is adding the
+  // undoable image replacements below.
+  std::vector<ImageRef> newImages(cels.size());
+  {
+    PortionDelegate portionDel(delegate, 0.0, double(cels.size()) / nimages);
+    SpriteJob::forkJoinCels(int(cels.size()),
+                            &portionDel,
+                            [&](int i, render::TaskDelegate* taskDelegate) {
+                              Cel* cel = cels[i];
+                              newImages[i] = convertImage(sprite,
+                                                          dithering,
+                                                          cel->imageRef(),
+                                                          cel->frame(),
+                                                          cel->layer()->isBackground(),
+                                                          mapAlgorithm,
+                                                          toGray,
+                                                          taskDelegate,
+                                                          fitCriteria);
+                            });
+  }
+  for (int i = 0; i < int(cels.size()); ++i) {
+    if (newImages[i])
+      m_pre.add(new cmd::ReplaceImage(sprite, cels[i]->imageRef(), newImages[i]));
   }
 
   // Convert tileset images
   if (sprite->hasTilesets()) {
+    int curImage = int(cels.size());
     for (Tileset* tileset : *sprite->tilesets()) {
       if (!tileset)
         continue;
@@ -125,18 +143,23 @@ SetPixelFormat::SetPixelFormat(Sprite* sprite,
       for (tile_index i = 0; i < tileset->size(); ++i) {
         ImageRef oldImage = tileset->get(i);
         if (oldImage) {
-          convertImage(sprite,
-                       dithering,
-                       oldImage,
-                       0,     // TODO select a frame or generate other tilesets?
-                       false, // TODO is background? it depends of the layer where this tileset is
-                              // used
-                       mapAlgorithm,
-                       toGray,
-                       &superDel,
-                       fitCriteria);
+          PortionDelegate portionDel(delegate,
+                                     double(curImage) / nimages,
+                                     double(curImage + 1) / nimages);
+          ImageRef newImage = convertImage(sprite,
+                                           dithering,
+                                           oldImage,
+                                           0,     // TODO select a frame or generate other tilesets?
+                                           false, // TODO is background? it depends of the layer
+                                                  // where this tileset is used
+                                           mapAlgorithm,
+                                           toGray,
+                                           &portionDel,
+                                           fitCriteria);
+          if (newImage)
+            m_pre.add(new cmd::ReplaceImage(sprite, oldImage, newImage));
         }
-        superDel.nextImage();
+        ++curImage;
       }
     }
   }
@@ -228,45 +251,59 @@ void SetPixelFormat::setFormat(PixelFormat format)
   doc->notify_observers<DocEvent&>(&DocObserver::onPixelFormatChanged, ev);
 }
 
-void SetPixelFormat::convertImage(doc::Sprite* sprite,
-                                  const render::Dithering& dithering,
-                                  const doc::ImageRef& oldImage,
-                                  const doc::frame_t frame,
-                                  const bool isBackground,
-                                  const doc::RgbMapAlgorithm mapAlgorithm,
-                                  doc::rgba_to_graya_func toGray,
-                                  render::TaskDelegate* delegate,
-                                  const doc::FitCriteria fitCriteria)
+doc::ImageRef SetPixelFormat::convertImage(const doc::Sprite* sprite,
+                                           const render::Dithering& dithering,
+                                           const doc::ImageRef& oldImage,
+                                           const doc::frame_t frame,
+                                           const bool isBackground,
+                                           const doc::RgbMapAlgorithm mapAlgorithm,
+                                           doc::rgba_to_graya_func toGray,
+                                           render::TaskDelegate* delegate,
+                                           const doc::FitCriteria fitCriteria)
 {
   ASSERT(oldImage);
   ASSERT(oldImage->pixelFormat() != IMAGE_TILEMAP);
 
-  // Making the RGBMap for Image->INDEXDED conversion.
-  // TODO: this is needed only when newImage
-  RgbMap* rgbmap;
+  // Making the RGBMap for Image->INDEXED conversion. We cannot use
+  // the Sprite::rgbMap() cache here because this function runs in
+  // several threads at the same time (one per cel) and the map
+  // lookups fill the cache lazily, so we build a private map (same
+  // algorithm/criteria that Sprite::rgbMap() would use) from the
+  // palette of this frame.
+  std::unique_ptr<RgbMap> rgbmap;
   int newMaskIndex = (isBackground ? -1 : 0);
   if (m_newFormat == IMAGE_INDEXED) {
-    rgbmap = sprite->rgbMap(frame, sprite->rgbMapForSprite(), mapAlgorithm, fitCriteria);
+    switch (mapAlgorithm) {
+      case RgbMapAlgorithm::RGB5A3: rgbmap.reset(new RgbMapRGB5A3); break;
+      case RgbMapAlgorithm::DEFAULT:
+      case RgbMapAlgorithm::OCTREE: rgbmap.reset(new OctreeMap); break;
+      default:
+        ASSERT(false);
+        return nullptr;
+    }
+    rgbmap->fitCriteria(fitCriteria);
+
+    const Palette* palette = sprite->palette(frame);
+    int maskIndex = palette->findMaskColor();
+    if (maskIndex == -1)
+      maskIndex = (sprite->rgbMapForSprite() == Sprite::RgbMapFor::OpaqueLayer ? -1 : 0);
+    rgbmap->regenerateMap(palette, maskIndex, fitCriteria);
+
     if (m_oldFormat == IMAGE_INDEXED)
       newMaskIndex = sprite->transparentColor();
     else
       newMaskIndex = rgbmap->maskIndex();
   }
-  else {
-    rgbmap = nullptr;
-  }
-  ImageRef newImage(render::convert_pixel_format(oldImage.get(),
-                                                 nullptr,
-                                                 m_newFormat,
-                                                 dithering,
-                                                 rgbmap,
-                                                 sprite->palette(frame),
-                                                 isBackground,
-                                                 newMaskIndex,
-                                                 toGray,
-                                                 delegate));
-
-  m_pre.add(new cmd::ReplaceImage(sprite, oldImage, newImage));
+  return ImageRef(render::convert_pixel_format(oldImage.get(),
+                                               nullptr,
+                                               m_newFormat,
+                                               dithering,
+                                               rgbmap.get(),
+                                               sprite->palette(frame),
+                                               isBackground,
+                                               newMaskIndex,
+                                               toGray,
+                                               delegate));
 }
 
 }} // namespace app::cmd
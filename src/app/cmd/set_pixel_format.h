@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -48,15 +48,19 @@ protected:
 
 private:
   void setFormat(doc::PixelFormat format);
-  void convertImage(doc::Sprite* sprite,
-                    const render::Dithering& dithering,
-                    const doc::ImageRef& oldImage,
-                    const doc::frame_t frame,
-                    const bool isBackground,
-                    const doc::RgbMapAlgorithm mapAlgorithm,
-                    doc::rgba_to_graya_func toGray,
-                    render::TaskDelegate* delegate,
-                    const doc::FitCriteria fitCriteria = doc::FitCriteria::DEFAULT);
+
+  // Returns the given image converted to the new pixel format. It
+  // can be called from several threads at the same time (one per
+  // cel/tileset image to convert).
+  doc::ImageRef convertImage(const doc::Sprite* sprite,
+                             const render::Dithering& dithering,
+                             const doc::ImageRef& oldImage,
+                             const doc::frame_t frame,
+                             const bool isBackground,
+                             const doc::RgbMapAlgorithm mapAlgorithm,
+                             doc::rgba_to_graya_func toGray,
+                             render::TaskDelegate* delegate,
+                             const doc::FitCriteria fitCriteria = doc::FitCriteria::DEFAULT);
 
   doc::PixelFormat m_oldFormat;
   doc::PixelFormat m_newFormat;
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2023  Igara Studio S.A.
+// Copyright (C) 2023-2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This program is distributed under the terms of
@@ -11,6 +11,8 @@
 
 #include "app/cmd_sequence.h"
 
+#include "gfx/region.h"
+
 namespace app {
 
 CmdSequence::CmdSequence()
@@ -50,6 +52,18 @@ void CmdSequence::addAndExecute(Context* ctx, Cmd* cmd)
     m_cmds.erase(m_cmds.begin() + i);
     throw;
   }
+
+  // Try to collapse runs of homogeneous commands: if the new command
+  // is still the last one (i.e. its execution didn't add other
+  // commands to the sequence) and the previous command can absorb
+  // it, we keep just the absorbing command. This way bulk edits
+  // (e.g. a script moving thousands of cels) don't create one Cmd
+  // per modification.
+  const size_t n = m_cmds.size();
+  if (n >= 2 && m_cmds[n - 1] == cmd && m_cmds[n - 2]->absorb(cmd)) {
+    m_cmds.pop_back();
+    cmd->dispose();
+  }
 }
 
 void CmdSequence::onExecute()
@@ -80,6 +94,24 @@ size_t CmdSequence::onMemSize() const
   return size;
 }
 
+void CmdSequence::onCompressData()
+{
+  for (auto it = m_cmds.begin(), end = m_cmds.end(); it != end; ++it)
+    (*it)->compressData();
+}
+
+bool CmdSequence::onModifiedRegion(gfx::Region& rgn) const
+{
+  // The sequence knows its modified region only when every child
+  // command knows its own one (an unknown child means that some area
+  // outside "rgn" could have been modified too).
+  for (auto it = m_cmds.begin(), end = m_cmds.end(); it != end; ++it) {
+    if (!(*it)->modifiedRegion(rgn))
+      return false;
+  }
+  return true;
+}
+
 void CmdSequence::executeAndAdd(Cmd* cmd)
 {
   addAndExecute(context(), cmd);
@@ -90,11 +90,13 @@ void CmdTransaction::onExecute()
 
 void CmdTransaction::onUndo()
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   CmdSequence::onUndo();
 }
 
 void CmdTransaction::onRedo()
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   CmdSequence::onRedo();
 }
 
@@ -103,8 +105,15 @@ std::string CmdTransaction::onLabel() const
   return m_label;
 }
 
+void CmdTransaction::onCompressData()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  CmdSequence::onCompressData();
+}
+
 size_t CmdTransaction::onMemSize() const
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   size_t size = CmdSequence::onMemSize();
   if (m_ranges) {
     size += (m_ranges->m_before.tellp() + m_ranges->m_after.tellp());
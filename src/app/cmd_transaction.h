@@ -14,6 +14,7 @@
 #include "view/range.h"
 
 #include <memory>
+#include <mutex>
 #include <sstream>
 
 namespace app {
@@ -46,6 +47,7 @@ protected:
   void onRedo() override;
   std::string onLabel() const override;
   size_t onMemSize() const override;
+  void onCompressData() override;
 
 private:
   SpritePosition calcSpritePosition() const;
@@ -62,6 +64,10 @@ private:
   std::unique_ptr<Ranges> m_ranges;
   std::string m_label;
   bool m_changeSavedState;
+
+  // Serializes undo/redo/memSize() with the background compression
+  // of cold undo states (see DocUndo and Cmd::compressData()).
+  mutable std::mutex m_mutex;
 };
 
 } // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -17,6 +17,10 @@
 #include "os/window.h"
 #include "ui/display.h"
 
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
 namespace app {
 
 // We use this variable to avoid accessing Preferences::instance()
@@ -24,6 +28,40 @@ namespace app {
 // spaces must be done.
 static bool g_manage = false;
 
+namespace {
+
+// Cache of conversions between (src, dst) color space pairs, so
+// creating a ConvertCS (e.g. one per redraw/frame) doesn't rebuild
+// the same transform again and again. Keeping the color space
+// references alive in each entry guarantees that matching by pointer
+// is valid (a dead color space address cannot be reused by a new
+// one). There are just a few pairs in play (documents/working space x
+// displays) so a linear search is enough.
+struct CachedConversion {
+  os::ColorSpaceRef srcCS;
+  os::ColorSpaceRef dstCS;
+  os::Ref<os::ColorSpaceConversion> conversion;
+};
+
+std::mutex g_conversionsMutex;
+std::vector<CachedConversion> g_conversions;
+
+os::Ref<os::ColorSpaceConversion> get_cached_conversion(const os::ColorSpaceRef& srcCS,
+                                                        const os::ColorSpaceRef& dstCS)
+{
+  std::lock_guard<std::mutex> lock(g_conversionsMutex);
+  for (const auto& cached : g_conversions) {
+    if (cached.srcCS.get() == srcCS.get() && cached.dstCS.get() == dstCS.get())
+      return cached.conversion;
+  }
+
+  auto conversion = os::System::instance()->convertBetweenColorSpace(srcCS, dstCS);
+  g_conversions.push_back(CachedConversion{ srcCS, dstCS, conversion });
+  return conversion;
+}
+
+} // anonymous namespace
+
 void initialize_color_spaces(Preferences& pref)
 {
   g_manage = pref.color.manage();
@@ -67,14 +105,14 @@ ConvertCS::ConvertCS(ui::Display* display, Doc* doc)
     auto srcCS = get_current_color_space(display, doc);
     auto dstCS = display->colorSpace();
     if (srcCS && dstCS)
-      m_conversion = os::System::instance()->convertBetweenColorSpace(srcCS, dstCS);
+      m_conversion = get_cached_conversion(srcCS, dstCS);
   }
 }
 
 ConvertCS::ConvertCS(const os::ColorSpaceRef& srcCS, const os::ColorSpaceRef& dstCS)
 {
   if (g_manage) {
-    m_conversion = os::System::instance()->convertBetweenColorSpace(srcCS, dstCS);
+    m_conversion = get_cached_conversion(srcCS, dstCS);
   }
 }
 
@@ -94,6 +132,14 @@ gfx::Color ConvertCS::operator()(const gfx::Color c)
   }
 }
 
+void ConvertCS::operator()(uint32_t* dst, const uint32_t* src, int n)
+{
+  if (m_conversion)
+    m_conversion->convertRgba(dst, src, n);
+  else if (dst != src)
+    std::copy(src, src + n, dst);
+}
+
 ConvertCS convert_from_current_to_display_color_space(ui::Display* display)
 {
   return ConvertCS(display);
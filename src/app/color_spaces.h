@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (c) 2018-2025  Igara Studio S.A.
+// Copyright (c) 2018-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -40,6 +40,12 @@ public:
   ConvertCS& operator=(const ConvertCS&) = delete;
   gfx::Color operator()(const gfx::Color c);
 
+  // Converts a whole range of RGBA pixels at once, which lets the
+  // underlying conversion process the run in one call instead of
+  // paying the per-call overhead for each pixel. "dst" can be equal
+  // to "src" to convert in-place.
+  void operator()(uint32_t* dst, const uint32_t* src, int n);
+
 private:
   os::Ref<os::ColorSpaceConversion> m_conversion;
 };
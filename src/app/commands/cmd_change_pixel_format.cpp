@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -64,7 +64,13 @@ rgba_to_graya_func get_gray_func(gen::ToGrayAlgorithm toGray)
 
 class ConvertThread : public render::TaskDelegate {
 public:
-  ConvertThread(const doc::ImageRef& dstImage,
+  // "srcImage" is the flattened visible area of the sprite in its
+  // original color mode. If "renderSrc" is true this thread renders
+  // it before converting (and the caller can reuse it in future
+  // threads, e.g. when just a dithering parameter changed).
+  ConvertThread(const doc::ImageRef& srcImage,
+                const bool renderSrc,
+                const doc::ImageRef& dstImage,
                 const doc::Sprite* sprite,
                 const doc::frame_t frame,
                 const doc::ColorMode colorMode,
@@ -78,13 +84,15 @@ public:
     , m_stopFlag(false)
     , m_progress(0.0)
     , m_thread([this,
+                srcImage,
+                renderSrc,
                 sprite,
                 frame,
                 colorMode,
                 dithering,
                 toGray,
                 newBlend]() { // Copy the matrix
-      run(sprite, frame, colorMode, dithering, toGray, newBlend);
+      run(srcImage, renderSrc, sprite, frame, colorMode, dithering, toGray, newBlend);
     })
   {
   }
@@ -100,23 +108,25 @@ public:
   double progress() const { return m_progress; }
 
 private:
-  void run(const Sprite* sprite,
+  void run(const doc::ImageRef& srcImage,
+           const bool renderSrc,
+           const Sprite* sprite,
            const doc::frame_t frame,
            const doc::ColorMode colorMode,
            const render::Dithering& dithering,
            const gen::ToGrayAlgorithm toGray,
            const bool newBlend)
   {
-    doc::ImageRef tmp(Image::create(sprite->pixelFormat(), m_image->width(), m_image->height()));
-
-    render::Render render;
-    render.setNewBlend(newBlend);
-    render.renderSprite(tmp.get(),
-                        sprite,
-                        frame,
-                        gfx::Clip(0, 0, m_pos.x, m_pos.y, m_image->width(), m_image->height()));
+    if (renderSrc) {
+      render::Render render;
+      render.setNewBlend(newBlend);
+      render.renderSprite(srcImage.get(),
+                          sprite,
+                          frame,
+                          gfx::Clip(0, 0, m_pos.x, m_pos.y, m_image->width(), m_image->height()));
+    }
 
-    render::convert_pixel_format(tmp.get(),
+    render::convert_pixel_format(srcImage.get(),
                                  m_image.get(),
                                  (PixelFormat)colorMode,
                                  dithering,
@@ -395,7 +405,23 @@ private:
     progress()->setVisible(false);
     layout();
 
-    m_bgThread.reset(new ConvertThread(m_image,
+    // Reuse the flattened render of the visible area between
+    // restarts: changing the dithering matrix/factor or the mapping
+    // algorithm doesn't modify the source pixels, so only the
+    // conversion has to run again. The previous thread was already
+    // joined in stop(), and the render itself is not interrupted by
+    // the stop flag, so a non-empty cache is always fully rendered.
+    const bool renderSrc = (!m_srcImage || m_srcImageBounds != visibleBounds);
+    if (renderSrc) {
+      m_srcImage.reset(Image::create(m_editor->sprite()->pixelFormat(),
+                                     visibleBounds.w,
+                                     visibleBounds.h));
+      m_srcImageBounds = visibleBounds;
+    }
+
+    m_bgThread.reset(new ConvertThread(m_srcImage,
+                                       renderSrc,
+                                       m_image,
                                        m_editor->sprite(),
                                        m_editor->frame(),
                                        dstColorMode,
@@ -452,6 +478,8 @@ private:
   Timer m_timer;
   Editor* m_editor;
   doc::ImageRef m_image;
+  doc::ImageRef m_srcImage; // Cached flattened render of the visible area
+  gfx::Rect m_srcImageBounds;
   doc::ImageBufferPtr m_imageBuffer;
   std::unique_ptr<ConvertThread> m_bgThread;
   ConversionItem* m_selectedItem;
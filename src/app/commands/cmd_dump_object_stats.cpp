@@ -0,0 +1,71 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/commands/command.h"
+#include "app/i18n/strings.h"
+#include "app/resource_finder.h"
+#include "app/ui/status_bar.h"
+#include "base/fstream_path.h"
+#include "base/mem_utils.h"
+#include "doc/object.h"
+
+#include <fstream>
+
+namespace app {
+
+// Saves a report of the live doc::Object instances per type (counts
+// and memory) gathered by the opt-in allocation instrumentation of
+// the doc library. The first execution enables the tracking, so a
+// user can bind the command to a key, work for a while, and press it
+// again to dump the stats of everything allocated in-between.
+class DumpObjectStatsCommand : public Command {
+public:
+  DumpObjectStatsCommand();
+
+protected:
+  void onExecute(Context* ctx) override;
+};
+
+DumpObjectStatsCommand::DumpObjectStatsCommand() : Command(CommandId::DumpObjectStats())
+{
+}
+
+void DumpObjectStatsCommand::onExecute(Context* ctx)
+{
+  if (!doc::object_stats_enabled()) {
+    doc::set_object_stats_enabled(true);
+    if (ctx->isUIAvailable())
+      StatusBar::instance()->showTip(2000, Strings::dump_object_stats_tracking());
+    return;
+  }
+
+  ResourceFinder rf;
+  rf.includeUserDir("object-stats.txt");
+  const std::string fn = rf.getFirstOrCreateDefault();
+
+  std::ofstream out(FSTREAM_PATH(fn));
+  for (const auto& it : doc::get_object_stats()) {
+    const doc::ObjectStats& stats = it.second;
+    out << doc::object_type_name(it.first) << ": live=" << stats.liveCount << " ("
+        << base::get_pretty_memory_size(stats.liveBytes)
+        << "), peak=" << base::get_pretty_memory_size(stats.peakBytes)
+        << ", total=" << stats.totalCount << "\n";
+  }
+
+  if (ctx->isUIAvailable())
+    StatusBar::instance()->showTip(2000, Strings::dump_object_stats_saved(fn));
+}
+
+Command* CommandFactory::createDumpObjectStatsCommand()
+{
+  return new DumpObjectStatsCommand;
+}
+
+} // namespace app
@@ -0,0 +1,64 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/commands/command.h"
+#include "app/i18n/strings.h"
+#include "app/resource_finder.h"
+#include "app/ui/status_bar.h"
+#include "base/fstream_path.h"
+#include "ui/perf_probe.h"
+
+#include <fstream>
+
+namespace app {
+
+// Saves the buffered ui::PerfProbe events as a JSON trace that can be
+// opened with chrome://tracing or Perfetto. If probes were not
+// capturing yet, the first execution starts the capture, so a user
+// can bind the command to a key, reproduce a hitch, and press it
+// again to get the trace.
+class DumpPerfTraceCommand : public Command {
+public:
+  DumpPerfTraceCommand();
+
+protected:
+  void onExecute(Context* ctx) override;
+};
+
+DumpPerfTraceCommand::DumpPerfTraceCommand() : Command(CommandId::DumpPerfTrace())
+{
+}
+
+void DumpPerfTraceCommand::onExecute(Context* ctx)
+{
+  if (!ui::perf_probes_enabled()) {
+    ui::set_perf_probes_enabled(true);
+    if (ctx->isUIAvailable())
+      StatusBar::instance()->showTip(2000, Strings::dump_perf_trace_capturing());
+    return;
+  }
+
+  ResourceFinder rf;
+  rf.includeUserDir("perf-trace.json");
+  const std::string fn = rf.getFirstOrCreateDefault();
+
+  std::ofstream out(FSTREAM_PATH(fn), std::ofstream::binary);
+  ui::write_perf_trace(out);
+
+  if (ctx->isUIAvailable())
+    StatusBar::instance()->showTip(2000, Strings::dump_perf_trace_saved(fn));
+}
+
+Command* CommandFactory::createDumpPerfTraceCommand()
+{
+  return new DumpPerfTraceCommand;
+}
+
+} // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -994,7 +994,8 @@ private:
 
     std::unique_ptr<Task> task(new Task);
     task->run(
-      [this, params](base::task_token& token) { generateSpriteSheetOnBackground(params, token); });
+      [this, params](base::task_token& token) { generateSpriteSheetOnBackground(params, token); },
+      Task::Priority::kExport);
     m_genTask = std::move(task);
     m_genTimer.start();
     onGenTimerTick();
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -41,6 +41,7 @@
 #include "keyboard_shortcuts.xml.h"
 
 #include <algorithm>
+#include <iterator>
 #include <map>
 #include <memory>
 
@@ -557,22 +558,56 @@ private:
   void fillAllLists()
   {
     deleteAllKeyItems();
+    for (bool& filled : m_listFilled)
+      filled = false;
+
+    // Each list is populated lazily the first time its section is
+    // displayed (or when a search needs it, see ensureListFilled()),
+    // as building every item of every section (mainly the menus tree
+    // and one item per command) was the slowest part of opening this
+    // dialog.
+    section()->selectIndex(m_curSection);
+    updateViews();
+  }
 
-    // Fill each list box with the keyboard shortcuts...
+  void ensureListFilled(const int s)
+  {
+    if (s < 0 || s >= int(std::size(m_listFilled)) || m_listFilled[s])
+      return;
 
-    fillMenusList(menus(), AppMenus::instance()->getRootMenu(), 0);
+    switch (s) {
+      case 0: // Menus
+        fillMenusList(menus(), AppMenus::instance()->getRootMenu(), 0);
 
-    {
-      // Create a pseudo-item for the palette menu
-      KeyItemBase* listItem = new KeyItemBase(Strings::palette_popup_menu_title());
-      menus()->addChild(listItem);
-      fillMenusList(menus(), AppMenus::instance()->getPalettePopupMenu(), 1);
+        {
+          // Create a pseudo-item for the palette menu
+          KeyItemBase* listItem = new KeyItemBase(Strings::palette_popup_menu_title());
+          menus()->addChild(listItem);
+          fillMenusList(menus(), AppMenus::instance()->getPalettePopupMenu(), 1);
+        }
+        break;
+
+      // Both lists are filled from the same m_keys pass
+      case 1: // Commands
+      case 3: // Action Modifiers
+        fillCommandsAndActionsLists();
+        m_listFilled[1] = m_listFilled[3] = true;
+        break;
+
+      case 2: // Tools
+        fillToolsList(tools(), App::instance()->toolBox());
+        tools()->sortItems();
+        break;
+
+      case 4: fillWheelActionsList(); break;
+      case 5: fillDragActionsList(); break;
     }
 
-    fillToolsList(tools(), App::instance()->toolBox());
-    fillWheelActionsList();
-    fillDragActionsList();
+    m_listFilled[s] = true;
+  }
 
+  void fillCommandsAndActionsLists()
+  {
     // Fill the 'Commands' and 'Action Modifier' lists
     for (const KeyPtr& key : m_keys) {
       // If it's not a listed Command or Action key, we go to the next key...
@@ -607,11 +642,7 @@ private:
     }
 
     commands()->sortItems();
-    tools()->sortItems();
     actions()->sortItems();
-
-    section()->selectIndex(m_curSection);
-    updateViews();
   }
 
   void deleteList(Widget* listbox)
@@ -629,6 +660,10 @@ private:
   {
     deleteList(searchList());
 
+    // The search iterates the items of every section
+    for (int s = 0; s < int(std::size(m_listFilled)); ++s)
+      ensureListFilled(s);
+
     MatchWords match(search);
 
     int sectionIdx = 0; // index 0 is menus
@@ -710,6 +745,7 @@ private:
   void fillWheelActionsList()
   {
     deleteList(wheelActions());
+    m_listFilled[4] = true;
     for (const KeyPtr& key : m_keys) {
       if (key->type() == KeyType::WheelAction) {
         KeyItem* keyItem =
@@ -801,8 +837,10 @@ private:
   void updateViews()
   {
     int s = section()->getSelectedIndex();
-    if (s >= 0)
+    if (s >= 0) {
       m_curSection = s;
+      ensureListFilled(s);
+    }
 
     searchView()->setVisible(s < 0);
     menusView()->setVisible(s == 0);
@@ -971,6 +1009,8 @@ private:
   app::KeyboardShortcuts& m_keys;
   MenuKeys& m_menuKeys;
   std::vector<ListBox*> m_listBoxes;
+  // One flag per section of m_listBoxes (see ensureListFilled())
+  bool m_listFilled[6] = { false, false, false, false, false, false };
   bool m_searchChange;
   bool m_wasDefault;
   HeaderItem m_headerItem;
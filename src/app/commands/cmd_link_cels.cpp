@@ -1,4 +1,5 @@
 // Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -11,6 +12,7 @@
 #include "app/app.h"
 #include "app/cmd/copy_cel.h"
 #include "app/commands/command.h"
+#include "app/commands/params.h"
 #include "app/context_access.h"
 #include "app/i18n/strings.h"
 #include "app/modules/gui.h"
@@ -18,6 +20,7 @@
 #include "app/ui/status_bar.h"
 #include "doc/cel.h"
 #include "doc/layer.h"
+#include "doc/sprite.h"
 
 namespace app {
 
@@ -26,17 +29,33 @@ public:
   LinkCelsCommand();
 
 protected:
+  void onLoadParams(const Params& params) override;
   bool onEnabled(Context* context) override;
   void onExecute(Context* context) override;
+  std::string onGetFriendlyName() const override;
+
+private:
+  // True to scan the whole sprite linking only cels that already have
+  // identical content (so they share one image buffer), instead of
+  // linking the selected range of cels.
+  bool m_matchDuplicates = false;
 };
 
 LinkCelsCommand::LinkCelsCommand() : Command(CommandId::LinkCels())
 {
 }
 
+void LinkCelsCommand::onLoadParams(const Params& params)
+{
+  m_matchDuplicates = params.get_as<bool>("matchDuplicates");
+}
+
 bool LinkCelsCommand::onEnabled(Context* context)
 {
   if (context->checkFlags(ContextFlags::ActiveDocumentIsWritable)) {
+    if (m_matchDuplicates)
+      return true;
+
     auto site = context->activeSite();
     return (site.inTimeline() && site.selectedFrames().size() > 1);
   }
@@ -49,7 +68,34 @@ void LinkCelsCommand::onExecute(Context* context)
   ContextWriter writer(context);
   Doc* document(writer.document());
   bool nonEditableLayers = false;
-  {
+
+  if (m_matchDuplicates) {
+    // Link cels of the same layer that already have identical content
+    // (same image, position, and opacity), so all the duplicates end
+    // up sharing just one image buffer.
+    std::vector<CelList> groups;
+    document->sprite()->getDuplicatedCels(groups);
+
+    Tx tx(writer, friendlyName());
+    for (const CelList& group : groups) {
+      Layer* layer = group.front()->layer();
+      if (!layer->isEditableHierarchy()) {
+        nonEditableLayers = true;
+        continue;
+      }
+
+      LayerImage* layerImage = static_cast<LayerImage*>(layer);
+      for (std::size_t i = 1; i < group.size(); ++i) {
+        tx(new cmd::CopyCel(layerImage,
+                            group.front()->frame(),
+                            layerImage,
+                            group[i]->frame(),
+                            true)); // true = force links
+      }
+    }
+    tx.commit();
+  }
+  else {
     auto site = context->activeSite();
     if (!site.inTimeline())
       return;
@@ -93,6 +139,13 @@ void LinkCelsCommand::onExecute(Context* context)
   update_screen_for_document(document);
 }
 
+std::string LinkCelsCommand::onGetFriendlyName() const
+{
+  if (m_matchDuplicates)
+    return Strings::commands_LinkCels_Duplicates();
+  return Strings::commands_LinkCels();
+}
+
 Command* CommandFactory::createLinkCelsCommand()
 {
   return new LinkCelsCommand;
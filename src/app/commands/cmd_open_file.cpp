@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -37,6 +37,8 @@ OpenFileCommand::OpenFileCommand()
   , m_ui(true)
   , m_repeatCheckbox(false)
   , m_oneFrame(false)
+  , m_readOnly(false)
+  , m_frame(0)
   , m_seqDecision(gen::SequenceDecision::ASK)
 {
 }
@@ -54,6 +56,18 @@ void OpenFileCommand::onLoadParams(const Params& params)
   m_repeatCheckbox = params.get_as<bool>("repeat_checkbox");
   m_oneFrame = params.get_as<bool>("oneframe");
 
+  // Open the document as a read-only reference: it cannot be edited,
+  // so it's excluded from the crash backup machinery and can be
+  // dropped from memory while its tab is in the background.
+  m_readOnly = params.get_as<bool>("readonly");
+
+  // Specific frame to load (implies "oneframe"), e.g. useful from
+  // scripts to extract one frame of a big animation without decoding
+  // the whole file.
+  m_frame = doc::frame_t(params.get_as<int>("frame"));
+  if (m_frame > 0)
+    m_oneFrame = true;
+
   std::string sequence = params.get("sequence");
   if (m_oneFrame || sequence == "skip" || sequence == "no") {
     m_seqDecision = gen::SequenceDecision::NO;
@@ -66,6 +80,26 @@ void OpenFileCommand::onLoadParams(const Params& params)
   }
 }
 
+// static
+int OpenFileCommand::loadDocumentFlags(const bool repeatCheckbox,
+                                       const gen::SequenceDecision seqDecision,
+                                       const bool oneFrame)
+{
+  int flags = FILE_LOAD_DATA_FILE | FILE_LOAD_CREATE_PALETTE |
+              (repeatCheckbox ? FILE_LOAD_SEQUENCE_ASK_CHECKBOX : 0);
+
+  switch (seqDecision) {
+    case gen::SequenceDecision::ASK: flags |= FILE_LOAD_SEQUENCE_ASK; break;
+    case gen::SequenceDecision::YES: flags |= FILE_LOAD_SEQUENCE_YES; break;
+    case gen::SequenceDecision::NO:  flags |= FILE_LOAD_SEQUENCE_NONE; break;
+  }
+
+  if (oneFrame)
+    flags |= FILE_LOAD_ONE_FRAME;
+
+  return flags;
+}
+
 void OpenFileCommand::onExecute(Context* context)
 {
   Console console;
@@ -105,9 +139,6 @@ void OpenFileCommand::onExecute(Context* context)
   if (filenames.empty())
     return;
 
-  int flags = FILE_LOAD_DATA_FILE | FILE_LOAD_CREATE_PALETTE |
-              (m_repeatCheckbox ? FILE_LOAD_SEQUENCE_ASK_CHECKBOX : 0);
-
   if (context->isUIAvailable() && m_seqDecision == gen::SequenceDecision::ASK) {
     if (Preferences::instance().openFile.openSequence() == gen::SequenceDecision::ASK) {
       // Do nothing (ask by default, or whatever the command params
@@ -118,21 +149,25 @@ void OpenFileCommand::onExecute(Context* context)
     }
   }
 
-  switch (m_seqDecision) {
-    case gen::SequenceDecision::ASK: flags |= FILE_LOAD_SEQUENCE_ASK; break;
-    case gen::SequenceDecision::YES: flags |= FILE_LOAD_SEQUENCE_YES; break;
-    case gen::SequenceDecision::NO:  flags |= FILE_LOAD_SEQUENCE_NONE; break;
-  }
-
-  if (m_oneFrame)
-    flags |= FILE_LOAD_ONE_FRAME;
+  int flags = loadDocumentFlags(m_repeatCheckbox, m_seqDecision, m_oneFrame);
 
   std::string filename;
   while (!filenames.empty()) {
     filename = filenames[0];
     filenames.erase(filenames.begin());
 
-    std::unique_ptr<FileOp> fop(FileOp::createLoadDocumentOperation(context, filename, flags));
+    // Use the prefetched operation if the file was already decoded
+    // (or is being decoded) in a background job (prefetched files are
+    // always decoded from the first frame).
+    std::unique_ptr<FileOp> fop;
+    if (m_frame == 0)
+      fop = OpenFilePrefetch::instance()->take(filename, flags);
+    const bool prefetched = (fop != nullptr);
+    if (!fop) {
+      fop.reset(FileOp::createLoadDocumentOperation(context, filename, flags));
+      if (fop)
+        fop->setFrameToLoad(m_frame);
+    }
     bool unrecent = false;
 
     // Do nothing (the user cancelled or something like that)
@@ -170,8 +205,10 @@ void OpenFileCommand::onExecute(Context* context)
         m_usedFiles.push_back(fn);
       }
 
-      OpenFileJob task(fop.get(), m_ui);
-      task.showProgressWindow();
+      if (!prefetched) {
+        OpenFileJob task(fop.get(), m_ui);
+        task.showProgressWindow();
+      }
 
       // Post-load processing, it is called from the GUI because may require user intervention.
       fop->postLoad();
@@ -182,6 +219,14 @@ void OpenFileCommand::onExecute(Context* context)
 
       Doc* doc = fop->document();
       if (doc) {
+        // Mark the document before it reaches the context, so
+        // observers that decide what to track on onAddDocument()
+        // (e.g. crash::BackupObserver) already see it as read-only.
+        if (m_readOnly) {
+          doc->markAsReadOnly();
+          doc->setInhibitBackup(true);
+        }
+
         if (context->isUIAvailable()) {
           App::instance()->recentFiles()->addRecentFile(fop->filename().c_str());
           auto& docPref = Preferences::instance().document(doc);
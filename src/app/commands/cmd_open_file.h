@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2024  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2016-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -13,6 +13,7 @@
 #include "app/commands/params.h"
 #include "app/pref/preferences.h"
 #include "base/paths.h"
+#include "doc/frame.h"
 
 #include <string>
 
@@ -26,6 +27,14 @@ public:
 
   gen::SequenceDecision seqDecision() const { return m_seqDecision; }
 
+  // Flags for FileOp::createLoadDocumentOperation() given the command
+  // parameters. Used by OpenBatchOfFiles/OpenFilePrefetch to start
+  // decoding files in advance with the same flags that this command
+  // will use to open them.
+  static int loadDocumentFlags(const bool repeatCheckbox,
+                               const gen::SequenceDecision seqDecision,
+                               const bool oneFrame);
+
 protected:
   void onLoadParams(const Params& params) override;
   void onExecute(Context* context) override;
@@ -37,6 +46,8 @@ private:
   bool m_ui;
   bool m_repeatCheckbox;
   bool m_oneFrame;
+  bool m_readOnly;
+  doc::frame_t m_frame;
   base::paths m_usedFiles;
   gen::SequenceDecision m_seqDecision;
 };
@@ -0,0 +1,63 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/app.h"
+#include "app/commands/command.h"
+#include "app/context_access.h"
+#include "app/modules/gui.h"
+#include "app/tx.h"
+#include "app/util/duplicate_frames.h"
+#include "doc/sprite.h"
+
+namespace app {
+
+class RemoveDuplicateFramesCommand : public Command {
+public:
+  RemoveDuplicateFramesCommand();
+
+protected:
+  bool onEnabled(Context* context) override;
+  void onExecute(Context* context) override;
+};
+
+RemoveDuplicateFramesCommand::RemoveDuplicateFramesCommand()
+  : Command(CommandId::RemoveDuplicateFrames())
+{
+}
+
+bool RemoveDuplicateFramesCommand::onEnabled(Context* context)
+{
+  if (!context->checkFlags(ContextFlags::ActiveDocumentIsWritable | ContextFlags::HasActiveSprite))
+    return false;
+
+  const ContextReader reader(context);
+  const Sprite* sprite(reader.sprite());
+  return sprite && sprite->totalFrames() > 1;
+}
+
+void RemoveDuplicateFramesCommand::onExecute(Context* context)
+{
+  ContextWriter writer(context);
+  Doc* document(writer.document());
+  Sprite* sprite(writer.sprite());
+  {
+    Tx tx(writer, "Remove Duplicate Frames");
+    if (merge_duplicate_frames(document, sprite, tx) > 0)
+      tx.commit();
+  }
+  update_screen_for_document(document);
+}
+
+Command* CommandFactory::createRemoveDuplicateFramesCommand()
+{
+  return new RemoveDuplicateFramesCommand;
+}
+
+} // namespace app
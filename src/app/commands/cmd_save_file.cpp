@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -25,6 +25,7 @@
 #include "app/file_selector.h"
 #include "app/i18n/strings.h"
 #include "app/job.h"
+#include "app/job_scheduler.h"
 #include "app/modules/gui.h"
 #include "app/pref/preferences.h"
 #include "app/recent_files.h"
@@ -194,6 +195,13 @@ void SaveFileBaseCommand::saveDocumentInBackground(const Context* context,
     return;
   }
 
+  // Encode a snapshot of the document in the background without
+  // blocking the UI.
+  if (params().async()) {
+    saveDocumentAsync(context, document, filename, markAsSaved, resizeOnTheFly, scale);
+    return;
+  }
+
   gfx::Rect bounds;
   if (params().bounds.isSet()) {
     // Export the specific given bounds (e.g. the selection bounds)
@@ -256,6 +264,104 @@ void SaveFileBaseCommand::saveDocumentInBackground(const Context* context,
   }
 }
 
+// Saves the document without blocking the UI: takes a snapshot of
+// the document (a plain memory copy, a lot cheaper than the encoding
+// itself) and encodes the snapshot in the worker pool while the user
+// keeps editing the original document (snapshot isolation).
+// [main thread]
+void SaveFileBaseCommand::saveDocumentAsync(const Context* context,
+                                            Doc* document,
+                                            const std::string& filename,
+                                            const MarkAsSaved markAsSaved,
+                                            const ResizeOnTheFly resizeOnTheFly,
+                                            const gfx::PointF& scale)
+{
+  std::shared_ptr<Doc> snapshot(document->duplicate(DuplicateExactCopy));
+
+  gfx::Rect bounds;
+  if (params().bounds.isSet())
+    bounds = params().bounds();
+  else
+    bounds = snapshot->sprite()->bounds();
+
+  // The ROI and the whole FileOp reference only the snapshot, so the
+  // encoding doesn't need any lock on the original document.
+  FileOpROI roi(snapshot.get(),
+                bounds,
+                params().slice(),
+                params().tag(),
+                m_framesSeq,
+                m_adjustFramesByTag);
+
+  std::shared_ptr<FileOp> fop(FileOp::createSaveDocumentOperation(context,
+                                                                  roi,
+                                                                  filename,
+                                                                  params().filenameFormat(),
+                                                                  params().ignoreEmpty()));
+  if (!fop)
+    return;
+
+  if (resizeOnTheFly == ResizeOnTheFly::On)
+    fop->setOnTheFlyScale(scale);
+
+  // To know if we can mark the original document as saved when the
+  // encoding finishes (i.e. only if it wasn't modified while we were
+  // saving the snapshot).
+  const undo::UndoState* stateWhenSaving = document->undoHistory()->currentState();
+  const doc::ObjectId docId = document->id();
+  const bool addToRecents = should_add_file_to_recents(context, params());
+  const bool showStatus = (context->isUIAvailable() && params().ui());
+
+  JobScheduler::instance()->submitJob(
+    [fop, snapshot, docId, stateWhenSaving, markAsSaved, filename, addToRecents, showStatus]() {
+      try {
+        fop->operate();
+      }
+      catch (const std::exception& e) {
+        fop->setError("Error saving file:\n%s", e.what());
+      }
+      fop->done();
+
+      ui::execute_from_ui_thread(
+        [fop, snapshot, docId, stateWhenSaving, markAsSaved, filename, addToRecents, showStatus]() {
+          // The document could have been closed while we were
+          // encoding the snapshot.
+          Context* ctx = (App::instance() ? App::instance()->context() : nullptr);
+          Doc* doc = (ctx ? ctx->documents().getById(docId) : nullptr);
+
+          if (fop->hasError()) {
+            Console console;
+            console.printf(fop->error().c_str());
+
+            // We don't know if the file was saved correctly or not.
+            // So mark it as it should be saved again.
+            if (doc && !doc->isReadOnly())
+              doc->impossibleToBackToSavedState();
+            return;
+          }
+
+          if (addToRecents)
+            App::instance()->recentFiles()->addRecentFile(filename);
+
+          if (doc && markAsSaved == MarkAsSaved::On &&
+              doc->undoHistory()->currentState() == stateWhenSaving) {
+            // Mark as saved only if the document is still in the
+            // same undo state that we snapshotted, in other case the
+            // file on disk doesn't match the current sprite.
+            doc->markAsSaved();
+            doc->setFilename(filename);
+            doc->incrementVersion();
+          }
+
+          if (showStatus && StatusBar::instance()) {
+            StatusBar::instance()->setStatusText(
+              2000,
+              Strings::save_file_saved(base::get_file_name(filename)));
+          }
+        });
+    });
+}
+
 //////////////////////////////////////////////////////////////////////
 
 class SaveFileCommand : public SaveFileBaseCommand {
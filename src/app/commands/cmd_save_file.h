@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2021-2024  Igara Studio S.A.
+// Copyright (C) 2021-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -59,6 +59,9 @@ struct SaveFileParams : public NewParams {
   Param<double> scale{ this, 1.0, "scale" };
   Param<gfx::Rect> bounds{ this, gfx::Rect(), "bounds" };
   Param<bool> playSubtags{ this, false, "playSubtags" };
+  // Encode a snapshot of the document in the background without
+  // blocking the UI (see SaveFileBaseCommand::saveDocumentAsync()).
+  Param<bool> async{ this, false, "async" };
 };
 
 class SaveFileBaseCommand : public CommandWithNewParams<SaveFileParams> {
@@ -85,6 +88,12 @@ protected:
                                 const MarkAsSaved markAsSaved,
                                 const ResizeOnTheFly resizeOnTheFly = ResizeOnTheFly::Off,
                                 const gfx::PointF& scale = gfx::PointF(1.0, 1.0));
+  void saveDocumentAsync(const Context* context,
+                         Doc* document,
+                         const std::string& filename,
+                         const MarkAsSaved markAsSaved,
+                         const ResizeOnTheFly resizeOnTheFly,
+                         const gfx::PointF& scale);
 
   doc::FramesSequence m_framesSeq;
   bool m_adjustFramesByTag;
@@ -0,0 +1,61 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/app.h"
+#include "app/commands/command.h"
+#include "app/context.h"
+#include "app/ui/main_window.h"
+#include "app/ui/navigator_window.h"
+
+namespace app {
+
+class ToggleNavigatorCommand : public Command {
+public:
+  ToggleNavigatorCommand();
+
+protected:
+  bool onEnabled(Context* context) override;
+  bool onChecked(Context* context) override;
+  void onExecute(Context* context) override;
+};
+
+ToggleNavigatorCommand::ToggleNavigatorCommand() : Command(CommandId::ToggleNavigator())
+{
+}
+
+bool ToggleNavigatorCommand::onEnabled(Context* context)
+{
+  return context->isUIAvailable() && context->checkFlags(ContextFlags::HasActiveSprite);
+}
+
+bool ToggleNavigatorCommand::onChecked(Context* context)
+{
+  MainWindow* mainWin = App::instance()->mainWindow();
+  if (!mainWin)
+    return false;
+
+  NavigatorWindow* navWin = mainWin->getNavigator();
+  return (navWin && navWin->isVisible());
+}
+
+void ToggleNavigatorCommand::onExecute(Context* context)
+{
+  NavigatorWindow* navWin = App::instance()->mainWindow()->getNavigator();
+
+  bool state = navWin->isNavigatorEnabled();
+  navWin->setNavigatorEnabled(!state);
+}
+
+Command* CommandFactory::createToggleNavigatorCommand()
+{
+  return new ToggleNavigatorCommand;
+}
+
+} // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2025  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -62,16 +62,23 @@ void UndoCommand::onExecute(Context* context)
   auto editor = Editor::activeEditor();
   Sprite* sprite = document->sprite();
   SpritePosition spritePosition;
+  if (m_type == Undo)
+    spritePosition = undo->nextUndoSpritePosition();
+  else
+    spritePosition = undo->nextRedoSpritePosition();
+
+  // Exact canvas region modified by the transaction that we are going
+  // to undo/redo, known only when every command inside the
+  // transaction can report its own modified region.
+  gfx::Region modifiedRegion;
+  const bool hasModifiedRegion = (m_type == Undo ? undo->nextUndoRegion(modifiedRegion) :
+                                                   undo->nextRedoRegion(modifiedRegion));
+
   const bool gotoModified = (Preferences::instance().undo.gotoModified() &&
                              context->isUIAvailable() && editor);
   if (gotoModified) {
     SpritePosition currentPosition(writer.site().layer(), writer.site().frame());
 
-    if (m_type == Undo)
-      spritePosition = undo->nextUndoSpritePosition();
-    else
-      spritePosition = undo->nextRedoSpritePosition();
-
     if (spritePosition != currentPosition) {
       Layer* selectLayer = spritePosition.layer();
       if (selectLayer)
@@ -142,7 +149,23 @@ void UndoCommand::onExecute(Context* context)
   document->generateMaskBoundaries();
   document->setExtraCel(ExtraCelRef(nullptr));
 
-  update_screen_for_document(document);
+  // When we know the exact region that changed, repaint just that
+  // area of the editors instead of invalidating them completely (a
+  // full invalidation re-renders the whole sprite, which is slow on
+  // big canvases just to undo/redo a small stroke).
+  if (hasModifiedRegion && context->isUIAvailable()) {
+    if (!modifiedRegion.isEmpty())
+      document->notifySpritePixelsModified(sprite, modifiedRegion, spritePosition.frame());
+
+    // The timeline (cel thumbnails) and tabs (modified flag) are
+    // refreshed completely anyway, they are cheap to repaint.
+    if (auto* timeline = App::instance()->timeline())
+      timeline->invalidate();
+    app_rebuild_documents_tabs();
+  }
+  else {
+    update_screen_for_document(document);
+  }
   set_current_palette(writer.palette(), false);
 }
 
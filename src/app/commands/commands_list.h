@@ -11,6 +11,7 @@ FOR_EACH_COMMAND(AdvancedMode)
 FOR_EACH_COMMAND(Apply)
 FOR_EACH_COMMAND(AutocropSprite)
 FOR_EACH_COMMAND(BackgroundFromLayer)
+FOR_EACH_COMMAND(BoxBlur)
 FOR_EACH_COMMAND(BrightnessContrast)
 FOR_EACH_COMMAND(Cancel)
 FOR_EACH_COMMAND(CanvasSize)
@@ -40,6 +41,8 @@ FOR_EACH_COMMAND(Cut)
 FOR_EACH_COMMAND(DeselectMask)
 FOR_EACH_COMMAND(Despeckle)
 FOR_EACH_COMMAND(DiscardBrush)
+FOR_EACH_COMMAND(DumpObjectStats)
+FOR_EACH_COMMAND(DumpPerfTrace)
 FOR_EACH_COMMAND(DuplicateLayer)
 FOR_EACH_COMMAND(DuplicateSlice)
 FOR_EACH_COMMAND(DuplicateSprite)
@@ -118,6 +121,7 @@ FOR_EACH_COMMAND(PlayPreviewAnimation)
 FOR_EACH_COMMAND(Redo)
 FOR_EACH_COMMAND(Refresh)
 FOR_EACH_COMMAND(Register)
+FOR_EACH_COMMAND(RemoveDuplicateFrames)
 FOR_EACH_COMMAND(RemoveFrame)
 FOR_EACH_COMMAND(RemoveFrameTag)
 FOR_EACH_COMMAND(RemoveLayer)
@@ -171,6 +175,7 @@ FOR_EACH_COMMAND(SymmetryMode)
 FOR_EACH_COMMAND(TiledMode)
 FOR_EACH_COMMAND(TilesetMode)
 FOR_EACH_COMMAND(Timeline)
+FOR_EACH_COMMAND(ToggleNavigator)
 FOR_EACH_COMMAND(ToggleOtherLayersOpacity)
 FOR_EACH_COMMAND(TogglePlayAll)
 FOR_EACH_COMMAND(TogglePlayOnce)
@@ -0,0 +1,134 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/commands/command.h"
+#include "app/commands/filters/filter_manager_impl.h"
+#include "app/commands/filters/filter_window.h"
+#include "app/commands/new_params.h"
+#include "app/context.h"
+#include "app/ini_file.h"
+#include "filters/box_blur_filter.h"
+#include "ui/entry.h"
+
+#include "box_blur.xml.h"
+
+namespace app {
+
+using namespace filters;
+
+struct BoxBlurParams : public NewParams {
+  Param<bool> ui{ this, true, "ui" };
+  Param<filters::Target> channels{ this, 0, "channels" };
+  Param<int> radius{ this, 4, "radius" };
+  Param<int> passes{ this, 3, "passes" };
+};
+
+static const char* ConfigSection = "BoxBlur";
+
+class BoxBlurWindow : public FilterWindow {
+public:
+  BoxBlurWindow(BoxBlurFilter& filter, FilterManagerImpl& filterMgr)
+    : FilterWindow("Box Blur",
+                   ConfigSection,
+                   &filterMgr,
+                   WithChannelsSelector,
+                   WithoutTiledCheckBox)
+    , m_filter(filter)
+    , m_controlsWidget(new gen::BoxBlur)
+    , m_radiusEntry(m_controlsWidget->radius())
+    , m_passesEntry(m_controlsWidget->passes())
+  {
+    getContainer()->addChild(m_controlsWidget.get());
+
+    m_radiusEntry->setTextf("%d", m_filter.getRadius());
+    m_passesEntry->setTextf("%d", m_filter.getPasses());
+
+    m_radiusEntry->Change.connect(&BoxBlurWindow::onParamsChange, this);
+    m_passesEntry->Change.connect(&BoxBlurWindow::onParamsChange, this);
+  }
+
+private:
+  void onParamsChange()
+  {
+    // Stop the background preview before touching the filter
+    // parameters, as it can be blurring the image with them right
+    // now.
+    stopPreview();
+
+    m_filter.setRadius(std::clamp(m_radiusEntry->textInt(), 1, 200));
+    m_filter.setPasses(std::clamp(m_passesEntry->textInt(), 1, 8));
+    restartPreview();
+  }
+
+  BoxBlurFilter& m_filter;
+  std::unique_ptr<gen::BoxBlur> m_controlsWidget;
+  ExprEntry* m_radiusEntry;
+  ExprEntry* m_passesEntry;
+};
+
+class BoxBlurCommand : public CommandWithNewParams<BoxBlurParams> {
+public:
+  BoxBlurCommand();
+
+protected:
+  bool onEnabled(Context* context) override;
+  void onExecute(Context* context) override;
+};
+
+BoxBlurCommand::BoxBlurCommand() : CommandWithNewParams<BoxBlurParams>(CommandId::BoxBlur())
+{
+}
+
+bool BoxBlurCommand::onEnabled(Context* context)
+{
+  return context->checkFlags(ContextFlags::ActiveDocumentIsWritable |
+                             ContextFlags::HasActiveSprite);
+}
+
+void BoxBlurCommand::onExecute(Context* context)
+{
+  const bool ui = (params().ui() && context->isUIAvailable());
+
+  BoxBlurFilter filter;
+
+  FilterManagerImpl filterMgr(context, &filter);
+  filterMgr.setTarget(TARGET_RED_CHANNEL | TARGET_GREEN_CHANNEL | TARGET_BLUE_CHANNEL |
+                      TARGET_GRAY_CHANNEL | TARGET_ALPHA_CHANNEL);
+
+  if (ui) {
+    filter.setRadius(get_config_int(ConfigSection, "Radius", 4));
+    filter.setPasses(get_config_int(ConfigSection, "Passes", 3));
+  }
+
+  if (params().radius.isSet())
+    filter.setRadius(params().radius());
+  if (params().passes.isSet())
+    filter.setPasses(params().passes());
+  if (params().channels.isSet())
+    filterMgr.setTarget(params().channels());
+
+  if (ui) {
+    BoxBlurWindow window(filter, filterMgr);
+    if (window.doModal()) {
+      set_config_int(ConfigSection, "Radius", filter.getRadius());
+      set_config_int(ConfigSection, "Passes", filter.getPasses());
+    }
+  }
+  else {
+    filterMgr.startWorker();
+  }
+}
+
+Command* CommandFactory::createBoxBlurCommand()
+{
+  return new BoxBlurCommand;
+}
+
+} // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -19,6 +19,7 @@
 #include "app/context_access.h"
 #include "app/doc.h"
 #include "app/ini_file.h"
+#include "app/job_scheduler.h"
 #include "app/modules/palettes.h"
 #include "app/site.h"
 #include "app/transaction.h"
@@ -42,15 +43,93 @@
 #include "ui/widget.h"
 #include "view/cels.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
 #include <set>
+#include <thread>
 
 namespace app {
 
 using namespace std;
 using namespace ui;
 
+// A FilterManager with its own row cursor and mask iterator so that
+// several threads can apply the same filter to different rows of the
+// same target at the same time. Everything else (images, bounds,
+// target, indexed data) is shared with the main FilterManagerImpl.
+class FilterManagerImpl::ParallelRows : public FilterManager {
+public:
+  ParallelRows(FilterManagerImpl& main) : m_main(main), m_row(0) {}
+
+  // Applies the filter to one row. Returns false if the row is
+  // outside the mask bitmap (mirrors the checks in applyStep()).
+  bool applyRow(const doc::PixelFormat pixelFormat, const int row)
+  {
+    m_row = row;
+
+    const Mask* mask = m_main.m_mask;
+    const bool useMask = (mask && mask->bitmap());
+    if (useMask) {
+      int x = m_main.m_bounds.x - mask->bounds().x;
+      int y = m_main.m_bounds.y - mask->bounds().y + row;
+      if ((x >= m_main.m_bounds.w) || (y >= m_main.m_bounds.h))
+        return false;
+
+      m_maskBits = mask->bitmap()->lockBits<BitmapTraits>(Image::ReadLock,
+                                                          gfx::Rect(x, y, m_main.m_bounds.w - x, 1));
+      m_maskIterator = m_maskBits.begin();
+    }
+
+    switch (pixelFormat) {
+      case IMAGE_RGB:       m_main.m_filter->applyToRgba(this); break;
+      case IMAGE_GRAYSCALE: m_main.m_filter->applyToGrayscale(this); break;
+      case IMAGE_INDEXED:   m_main.m_filter->applyToIndexed(this); break;
+    }
+
+    if (useMask)
+      m_maskBits.unlock();
+    return true;
+  }
+
+  // FilterManager implementation
+  doc::PixelFormat pixelFormat() const override { return m_main.pixelFormat(); }
+  const void* getSourceAddress() override
+  {
+    return m_main.m_src->getPixelAddress(m_main.m_bounds.x, m_main.m_bounds.y + m_row);
+  }
+  void* getDestinationAddress() override
+  {
+    return m_main.m_dst->getPixelAddress(m_main.m_bounds.x, m_main.m_bounds.y + m_row);
+  }
+  int getWidth() override { return m_main.m_bounds.w; }
+  Target getTarget() override { return m_main.m_target; }
+  FilterIndexedData* getIndexedData() override { return &m_main; }
+  bool skipPixel() override
+  {
+    bool skip = false;
+    if (m_main.m_mask && m_main.m_mask->bitmap()) {
+      if (!*m_maskIterator)
+        skip = true;
+      ++m_maskIterator;
+    }
+    return skip;
+  }
+  const doc::Image* getSourceImage() override { return m_main.m_src.get(); }
+  int x() const override { return m_main.m_bounds.x; }
+  int y() const override { return m_main.m_bounds.y + m_row; }
+  bool isFirstRow() const override { return false; } // The palette was already processed
+  bool isMaskActive() const override { return m_main.isMaskActive(); }
+  base::task_token& taskToken() const override { return m_main.taskToken(); }
+
+private:
+  FilterManagerImpl& m_main;
+  int m_row;
+  doc::ImageBits<doc::BitmapTraits> m_maskBits;
+  doc::ImageBits<doc::BitmapTraits>::iterator m_maskIterator;
+};
+
 FilterManagerImpl::FilterManagerImpl(Context* context, Filter* filter)
   : m_reader(context)
   , m_site(const_cast<Site&>(m_reader.site()))
@@ -59,6 +138,10 @@ FilterManagerImpl::FilterManagerImpl(Context* context, Filter* filter)
   , m_src(nullptr)
   , m_dst(nullptr)
   , m_row(0)
+  , m_rowsApplied(0)
+  , m_interlacedPreview(false)
+  , m_flushMinRow(0)
+  , m_flushMaxRow(0)
   , m_mask(nullptr)
   , m_previewMask(nullptr)
   , m_targetOrig(TARGET_ALL_CHANNELS)
@@ -119,6 +202,8 @@ void FilterManagerImpl::begin()
   Doc* document = m_site.document();
 
   m_row = 0;
+  m_rowsApplied = 0;
+  m_interlacedPreview = false;
   m_mask = (document->isMaskVisible() ? document->mask() : nullptr);
   m_taskToken = &m_noToken; // Don't use the preview token (which can be canceled)
   updateBounds(m_mask);
@@ -135,7 +220,10 @@ void FilterManagerImpl::beginForPreview()
     m_previewMask->replace(m_site.sprite()->bounds());
   }
 
-  m_row = m_nextRowToFlush = 0;
+  m_row = 0;
+  m_rowsApplied = 0;
+  m_interlacedPreview = false;
+  m_flushMinRow = m_flushMaxRow = 0;
   m_mask = m_previewMask.get();
 
   // If we have a tiled mode enabled, we'll apply the filter to the whole areaes
@@ -159,6 +247,14 @@ void FilterManagerImpl::beginForPreview()
     m_row = -1;
     return;
   }
+  m_flushMinRow = m_bounds.h;
+
+  // Progressive preview: when the filter can process rows in any
+  // order (the same requirement of applyRowsInParallel()), rows are
+  // applied in the interlaced order of previewRow(), so a coarse
+  // version of the whole preview area is visible after a quarter of
+  // the work and then it's refined with the remaining rows.
+  m_interlacedPreview = (m_filter->supportsParallelRows() && m_bounds.h >= 8);
 }
 
 void FilterManagerImpl::end()
@@ -193,25 +289,51 @@ bool FilterManagerImpl::applyStep()
     case IMAGE_GRAYSCALE: m_filter->applyToGrayscale(this); break;
     case IMAGE_INDEXED:   m_filter->applyToIndexed(this); break;
   }
-  ++m_row;
+
+  m_flushMinRow = std::min(m_flushMinRow, m_row);
+  m_flushMaxRow = std::max(m_flushMaxRow, m_row + 1);
+
+  if (m_interlacedPreview) {
+    ++m_rowsApplied;
+    m_row = (m_rowsApplied < m_bounds.h ? previewRow(m_rowsApplied) : m_bounds.h);
+  }
+  else
+    ++m_row;
 
   return true;
 }
 
+int FilterManagerImpl::previewRow(const int i) const
+{
+  // Interlaced order: first every 4th row (a coarse preview of the
+  // whole area as fast as possible), then the rows in between so the
+  // preview is progressively refined to full resolution.
+  const int h = m_bounds.h;
+  const int pass0 = (h + 3) / 4; // Rows 0, 4, 8, ...
+  const int pass1 = (h + 1) / 4; // Rows 2, 6, 10, ...
+  if (i < pass0)
+    return 4 * i;
+  if (i < pass0 + pass1)
+    return 4 * (i - pass0) + 2;
+  return 2 * (i - pass0 - pass1) + 1; // Rows 1, 3, 5, ...
+}
+
 void FilterManagerImpl::apply()
 {
   CommandResult result;
   bool cancelled = false;
 
   begin();
-  while (!cancelled && applyStep()) {
-    if (m_progressDelegate) {
-      // Report progress.
-      m_progressDelegate->reportProgress(m_progressBase +
-                                         m_progressWidth * (m_row + 1) / m_bounds.h);
-
-      // Does the user cancelled the whole process?
-      cancelled = m_progressDelegate->isCancelled();
+  if (!applyRowsInParallel(&cancelled)) {
+    while (!cancelled && applyStep()) {
+      if (m_progressDelegate) {
+        // Report progress.
+        m_progressDelegate->reportProgress(m_progressBase +
+                                           m_progressWidth * (m_row + 1) / m_bounds.h);
+
+        // Does the user cancelled the whole process?
+        cancelled = m_progressDelegate->isCancelled();
+      }
     }
   }
 
@@ -258,6 +380,54 @@ void FilterManagerImpl::apply()
     init(m_site.cel());
 }
 
+bool FilterManagerImpl::applyRowsInParallel(bool* cancelled)
+{
+  if (!m_filter->supportsParallelRows())
+    return false;
+
+  // Indexed images are excluded because RgbMap::mapColor() can
+  // regenerate its internal map lazily (not thread-safe).
+  const PixelFormat fmt = m_site.sprite()->pixelFormat();
+  if (fmt != IMAGE_RGB && fmt != IMAGE_GRAYSCALE)
+    return false;
+
+  JobScheduler* scheduler = JobScheduler::instance();
+  if (scheduler->threads() < 2 || m_bounds.h < 2)
+    return false;
+
+  applyToPaletteIfNeeded();
+
+  const std::thread::id caller = std::this_thread::get_id();
+  std::atomic<bool> stop(false);
+  std::atomic<int> rowsDone(0);
+
+  scheduler->forkJoinBands(0, m_bounds.h, [&](int first, int last) {
+    ParallelRows rows(*this);
+    for (int row = first; row < last && !stop; ++row) {
+      if (!rows.applyRow(fmt, row))
+        break;
+      ++rowsDone;
+
+      // Only the caller thread talks to the progress delegate (the
+      // delegate is not required to be thread-safe).
+      if (m_progressDelegate && std::this_thread::get_id() == caller) {
+        m_progressDelegate->reportProgress(m_progressBase +
+                                           m_progressWidth * rowsDone / m_bounds.h);
+        if (m_progressDelegate->isCancelled())
+          stop = true;
+      }
+    }
+  });
+
+  if (m_progressDelegate && !stop)
+    *cancelled = m_progressDelegate->isCancelled();
+  else
+    *cancelled = stop;
+
+  m_row = m_bounds.h;
+  return true;
+}
+
 void FilterManagerImpl::applyToTarget()
 {
   applyToPaletteIfNeeded();
@@ -351,20 +521,22 @@ void FilterManagerImpl::commitTransaction()
 
 void FilterManagerImpl::flush()
 {
-  int h = m_row - m_nextRowToFlush;
+  const int minRow = m_flushMinRow;
+  const int h = m_flushMaxRow - minRow;
 
   if (m_row >= 0 && h > 0) {
-    // Redraw the color palette
-    if (m_nextRowToFlush == 0 && paletteHasChanged())
+    // Redraw the color palette (the first flushed range is the only
+    // one that can start at the first applied row)
+    if (minRow == 0 && paletteHasChanged())
       redrawColorPalette();
 
     for (Editor* editor : UIContext::instance()->getAllEditorsIncludingPreview(document())) {
       // We expand the region one pixel at the top and bottom of the
-      // region [m_row,m_nextRowToFlush) to be updated on the screen to
-      // avoid screen artifacts when we apply filters like convolution
-      // matrices.
+      // region [m_flushMinRow,m_flushMaxRow) to be updated on the
+      // screen to avoid screen artifacts when we apply filters like
+      // convolution matrices.
       gfx::Rect rect(
-        editor->editorToScreen(gfx::Point(m_bounds.x, m_bounds.y + m_nextRowToFlush - 1)),
+        editor->editorToScreen(gfx::Point(m_bounds.x, m_bounds.y + minRow - 1)),
         gfx::Size(editor->projection().applyX(m_bounds.w),
                   (editor->projection().scaleY() >= 1 ? editor->projection().applyY(h + 2) :
                                                         editor->projection().removeY(h + 2))));
@@ -379,7 +551,8 @@ void FilterManagerImpl::flush()
       editor->invalidateRegion(reg1);
     }
 
-    m_nextRowToFlush = m_row + 1;
+    m_flushMinRow = m_bounds.h;
+    m_flushMaxRow = 0;
   }
 }
 
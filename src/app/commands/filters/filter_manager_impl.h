@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -134,8 +134,23 @@ public:
   void startWorker();
 
 private:
+  // Per-thread row cursor used to apply filter rows in parallel
+  // (defined in filter_manager_impl.cpp).
+  class ParallelRows;
+
   void init(doc::Cel* cel);
   void apply();
+
+  // Applies the whole filter dispatching row bands to the shared
+  // JobScheduler pool. Returns false if the filter/image cannot be
+  // processed in parallel and the caller must use the serial
+  // applyStep() loop.
+  bool applyRowsInParallel(bool* cancelled);
+
+  // Maps a step index to the row to apply when the preview uses the
+  // interlaced/progressive order (see beginForPreview()).
+  int previewRow(const int i) const;
+
   void applyToCel(doc::Cel* cel);
   bool updateBounds(doc::Mask* mask);
 
@@ -155,7 +170,17 @@ private:
   doc::ImageRef m_src;
   doc::ImageRef m_dst;
   int m_row;
-  int m_nextRowToFlush;
+
+  // Progressive preview: number of rows already applied and whether
+  // applyStep() advances in the interlaced order of previewRow()
+  // (instead of top to bottom).
+  int m_rowsApplied;
+  bool m_interlacedPreview;
+
+  // Range of applied rows [min, max) not yet flushed to the editors.
+  int m_flushMinRow;
+  int m_flushMaxRow;
+
   gfx::Rect m_bounds;
   doc::Mask* m_mask;
   std::unique_ptr<doc::Mask> m_previewMask;
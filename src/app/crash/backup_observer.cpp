@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2023  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -83,6 +83,14 @@ void BackupObserver::stop()
 
 void BackupObserver::onAddDocument(Doc* document)
 {
+  // Read-only documents (e.g. references opened with the OpenFile
+  // "readonly" param) cannot be modified, so there will never be
+  // changes to back up and we don't even track them.
+  if (document->isReadOnly()) {
+    RECO_TRACE("RECO: Ignoring read-only document %p\n", document);
+    return;
+  }
+
   RECO_TRACE("RECO: Observe document %p\n", document);
 
   std::unique_lock<std::mutex> lock(m_mutex);
@@ -19,6 +19,12 @@ namespace app { namespace crash {
 
 const uint32_t MAGIC_NUMBER = 0x454E4946; // 'FINE' in ASCII
 
+// Maximum length of a chain of delta-encoded cel images in a session:
+// the writer saves one complete image every few cels of a layer, so a
+// single corrupted or rotated out file cannot invalidate the whole
+// layer and the reader resolves short chains only.
+const int kMaxDeltaChain = 8;
+
 class ObjVersions {
 public:
   ObjVersions()
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -15,6 +15,7 @@
 #include "app/crash/internals.h"
 #include "app/crash/log.h"
 #include "app/doc.h"
+#include "app/job_scheduler.h"
 #include "base/convert_to.h"
 #include "base/exception.h"
 #include "base/fs.h"
@@ -49,6 +50,8 @@
 
 #include <fstream>
 #include <map>
+#include <mutex>
+#include <utility>
 
 namespace app { namespace crash {
 
@@ -77,6 +80,12 @@ public:
     , m_loadInfo(nullptr)
     , m_taskToken(t)
   {
+    struct ScannedFile {
+      std::string fn;
+      ObjectId id;
+      ObjectVersion ver;
+    };
+    std::vector<ScannedFile> files;
     for (const auto& fn : base::list_files(dir, base::ItemType::Files)) {
       auto i = fn.find('-');
       if (i == std::string::npos)
@@ -91,27 +100,47 @@ public:
       if (!id || !ver)
         continue; // Error converting strings to ID/ver
 
-      // Checking for the magic number of each file takes a long time,
-      // we can guess that all files are valid when there is no
-      // m_taskToken, i.e. when we have to just show the description
-      // of the doc in the list of backups.
-      if (m_taskToken && !check_magic_number(base::join_path(m_dir, fn))) {
-        RECO_TRACE("RECO: Ignoring invalid file %s (no magic number)\n", fn.c_str());
+      files.push_back({ fn, id, ver });
+    }
+
+    // Checking for the magic number of each file takes a long time
+    // (it's one short read, but the latency adds up with thousands
+    // of object files), so we check all the files in parallel. We
+    // can guess that all files are valid when there is no
+    // m_taskToken, i.e. when we have to just show the description of
+    // the doc in the list of backups.
+    std::vector<char> valid(files.size(), 1);
+    if (m_taskToken) {
+      JobScheduler::instance()->forkJoin(int(files.size()), [&](int i) {
+        valid[i] = check_magic_number(base::join_path(m_dir, files[i].fn));
+      });
+    }
+
+    for (size_t i = 0; i < files.size(); ++i) {
+      const ScannedFile& file = files[i];
+      if (!valid[i]) {
+        RECO_TRACE("RECO: Ignoring invalid file %s (no magic number)\n", file.fn.c_str());
         continue;
       }
 
-      ObjVersions& versions = m_objVersions[id];
-      versions.add(ver);
+      const bool firstTime = (m_objVersions.find(file.id) == m_objVersions.end());
+      ObjVersions& versions = m_objVersions[file.id];
+      versions.add(file.ver);
 
-      if (fn.compare(0, 3, "doc") == 0) {
+      if (file.fn.compare(0, 3, "doc") == 0) {
         if (!m_docId)
-          m_docId = id;
+          m_docId = file.id;
         else {
-          ASSERT(m_docId == id);
+          ASSERT(m_docId == file.id);
         }
 
         m_docVersions = &versions;
       }
+      // Remember which objects are images to preload them in
+      // parallel (see preloadImages()).
+      else if (firstTime && file.fn.compare(0, 3, "img") == 0) {
+        m_imageIds.push_back(file.id);
+      }
     }
   }
 
@@ -160,9 +189,17 @@ private:
   }
 
   template<typename T>
-  T loadObject(const char* prefix, ObjectId id, T (Reader::*readMember)(std::ifstream&))
+  T loadObject(const char* prefix,
+               ObjectId id,
+               T (Reader::*readMember)(std::ifstream&),
+               const bool quiet = false)
   {
-    const ObjVersions& versions = m_objVersions[id];
+    // find() instead of operator[] so this function doesn't modify
+    // m_objVersions and can be called from several threads at the
+    // same time (see preloadImages()).
+    const auto versionsIt = m_objVersions.find(id);
+    const ObjVersions versions = (versionsIt != m_objVersions.end() ? versionsIt->second :
+                                                                      ObjVersions());
 
     for (size_t i = 0; i < versions.size(); ++i) {
       ObjectVersion ver = versions[i];
@@ -192,12 +229,33 @@ private:
     }
 
     // Show error only if we've failed to load all versions
-    if (!m_loadInfo)
+    if (!quiet && !m_loadInfo)
       Console().printf("Error loading object %s #%d\n", prefix, id);
 
     return nullptr;
   }
 
+  // Preloads all the images of the session in parallel, which is
+  // most of the I/O and decompression work of the recovery process.
+  // Linked cels keep sharing one image because getImageRef() will
+  // find these images already memoized. Images that fail to load
+  // here are quietly discarded and retried (and reported) by the
+  // regular getImageRef() path.
+  void preloadImages()
+  {
+    std::vector<ImageRef> images(m_imageIds.size());
+    JobScheduler::instance()->forkJoin(int(m_imageIds.size()), [&](int i) {
+      if (canceled())
+        return;
+      images[i].reset(loadObject<Image*>("img", m_imageIds[i], &Reader::readImage, true));
+    });
+
+    for (size_t i = 0; i < m_imageIds.size(); ++i) {
+      if (images[i])
+        m_images[m_imageIds[i]] = images[i];
+    }
+  }
+
   Doc* readDocument(std::ifstream& s)
   {
     ObjectId sprId = read32(s);
@@ -318,6 +376,11 @@ private:
       Console().printf("Invalid number of layers #%d\n", nlayers);
     }
 
+    if (canceled())
+      return nullptr;
+
+    preloadImages();
+
     // Read all cels
     for (size_t i = 0; i < m_celsToLoad.size(); ++i) {
       if (canceled())
@@ -516,7 +579,63 @@ private:
 
   CelData* readCelData(std::ifstream& s) { return read_celdata(s, this, false, m_serial); }
 
-  Image* readImage(std::ifstream& s) { return read_image(s, false); }
+  Image* readImage(std::ifstream& s) { return readImage(s, 0); }
+
+  Image* readImage(std::ifstream& s, const int depth)
+  {
+    // Delta-encoded images (see doc::write_image_delta()) need their
+    // base image blob to reconstruct the pixels.
+    const std::streampos pos = s.tellg();
+    ObjectId baseId = 0;
+    ObjectVersion baseVersion = 0;
+    if (read_image_delta_ref(s, baseId, baseVersion)) {
+      s.seekg(pos);
+
+      // The writer saves a complete image every few cels, a longer
+      // chain means a corrupted file.
+      if (depth >= 2 * kMaxDeltaChain)
+        return nullptr;
+
+      ImageRef base = getDeltaBaseImage(baseId, baseVersion, depth);
+      if (!base)
+        return nullptr;
+
+      return read_image_delta(s, base.get(), false);
+    }
+    s.seekg(pos);
+    return read_image(s, false);
+  }
+
+  // Loads the exact img-<id>.<version> blob referenced by a
+  // delta-encoded image. The cache is shared by the preloadImages()
+  // workers, hence the mutex (m_images cannot be used here: it's
+  // keyed by object ID only and updated without locking in the
+  // serial phase).
+  ImageRef getDeltaBaseImage(const ObjectId id, const ObjectVersion version, const int depth)
+  {
+    {
+      const std::lock_guard<std::mutex> lock(m_deltaBasesMutex);
+      const auto it = m_deltaBases.find(std::make_pair(id, version));
+      if (it != m_deltaBases.end())
+        return it->second;
+    }
+
+    std::string fn = "img-";
+    fn += base::convert_to<std::string>(id);
+    fn.push_back('.');
+    fn += base::convert_to<std::string>(version);
+
+    std::ifstream s(FSTREAM_PATH(base::join_path(m_dir, fn)), std::ifstream::binary);
+    ImageRef image;
+    if (read32(s) == MAGIC_NUMBER)
+      image.reset(readImage(s, depth + 1));
+
+    if (image) {
+      const std::lock_guard<std::mutex> lock(m_deltaBasesMutex);
+      m_deltaBases.emplace(std::make_pair(id, version), image);
+    }
+    return image;
+  }
 
   Palette* readPalette(std::ifstream& s) { return read_palette(s); }
 
@@ -589,9 +708,15 @@ private:
   ObjVersionsMap m_objVersions;
   ObjVersions* m_docVersions;
   DocumentInfo* m_loadInfo;
+  std::vector<ObjectId> m_imageIds;
   std::vector<std::pair<ObjectId, ObjectId>> m_celsToLoad;
   std::map<ObjectId, ImageRef> m_images;
   std::map<ObjectId, CelDataRef> m_celdatas;
+
+  // Cache of the exact blobs referenced by delta-encoded images (see
+  // getDeltaBaseImage()), shared by the preloadImages() workers.
+  std::map<std::pair<ObjectId, ObjectVersion>, ImageRef> m_deltaBases;
+  std::mutex m_deltaBasesMutex;
   // Each ObjectId is a tileset ID that didn't contain the empty tile
   // as the first tile (this was an old format used in internal betas)
   std::set<ObjectId> m_updateOldTilemapWithTileset;
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -30,6 +30,7 @@
 #include "doc/layer_tilemap.h"
 #include "doc/palette.h"
 #include "doc/palette_io.h"
+#include "doc/primitives.h"
 #include "doc/serial_format.h"
 #include "doc/slice.h"
 #include "doc/slice_io.h"
@@ -55,8 +56,30 @@ using namespace doc;
 
 namespace {
 
+// Content hash of the last saved blob of each cel image, used to skip
+// re-compressing/rewriting images whose version changed but whose
+// pixels didn't (e.g. after an undo+redo cycle or a no-op edit).
+//
+// When the blob on disk is delta-encoded (doc::write_image_delta()
+// against the previous cel image of the same layer), baseId/
+// baseVersion reference the base blob and chainDepth counts how many
+// deltas have to be resolved to reach a complete image.
+struct ImageHashRec {
+  uint32_t hash = 0;
+  bool saved = false;
+  doc::ObjectId baseId = 0;
+  doc::ObjectVersion baseVersion = 0;
+  int chainDepth = 0;
+
+  // Version of the blob that is really on disk (versions recorded by
+  // the content-hash shortcut don't have their own file).
+  doc::ObjectVersion diskVersion = 0;
+};
+typedef std::map<doc::ObjectId, ImageHashRec> ImageHashMap;
+
 static std::map<ObjectId, ObjVersionsMap> g_docVersions;
 static std::map<ObjectId, base::paths> g_deleteFiles;
+static std::map<ObjectId, ImageHashMap> g_docImageHashes;
 
 class Writer {
 public:
@@ -65,6 +88,7 @@ public:
     , m_doc(doc)
     , m_objVersions(g_docVersions[doc->id()])
     , m_deleteFiles(g_deleteFiles[doc->id()])
+    , m_imageHashes(g_docImageHashes[doc->id()])
     , m_cancel(cancel)
   {
   }
@@ -107,13 +131,19 @@ public:
       CelList cels;
       lay->getCels(cels);
 
+      // Previous cel image saved in this layer, used as the base for
+      // delta-encoded blobs (adjacent frames tend to be similar).
+      Image* prevImage = nullptr;
+
       for (Cel* cel : cels) {
         if (cel->link()) // Skip link
           continue;
 
-        if (!saveObject("img", cel->image(), &Writer::writeImage))
+        if (!saveImage(cel->image(), prevImage))
           return false;
 
+        prevImage = cel->image();
+
         if (!saveObject("celdata", cel->data(), &Writer::writeCelData))
           return false;
       }
@@ -302,6 +332,101 @@ private:
 
   bool writeImage(std::ofstream& s, Image* img) { return write_image(s, img, m_cancel); }
 
+  bool writeImageDelta(std::ofstream& s, Image* img)
+  {
+    return write_image_delta(s, img, m_deltaBase, m_deltaBaseVersion, m_cancel);
+  }
+
+  // Like saveObject() for cel images, but with a content-hash
+  // shortcut: when the object version was bumped but the pixels are
+  // identical to the blob already on disk, we only record the new
+  // version as saved (the reader picks the newest existing file per
+  // object ID, so the old blob remains valid).
+  //
+  // "prevImage" is the previous cel image of the same layer (or
+  // nullptr): when it matches this image layout, the blob is written
+  // as a XOR delta against it, which shrinks backups of animations by
+  // an order of magnitude.
+  bool saveImage(Image* image, const Image* prevImage)
+  {
+    if (isCanceled())
+      return false;
+
+    if (!image->version())
+      image->incrementVersion();
+
+    ObjVersions& versions = m_objVersions[image->id()];
+    ImageHashRec& rec = m_imageHashes[image->id()];
+
+    // If the blob on disk is a delta and its base blob was just
+    // rewritten, this one has to be rewritten too (the referenced
+    // base file rotates out after a couple of saves and would leave
+    // the delta unreadable), even when this image itself didn't
+    // change.
+    const bool baseStale = (rec.saved && rec.baseId != 0 &&
+                            m_imageHashes[rec.baseId].diskVersion != rec.baseVersion);
+
+    if (!baseStale && versions.newer() == image->version())
+      return true;
+
+    const uint32_t hash = calculate_image_hash(image, image->bounds());
+
+    if (!baseStale) {
+      if (versions.newer() != 0 && rec.saved && rec.hash == hash) {
+        versions.rotateRevisions(image->version());
+        RECO_TRACE(" - Unchanged img #%d v%d (content hash match)\n", image->id(), image->version());
+        return true;
+      }
+    }
+    else if (versions.newer() == image->version()) {
+      // saveObject() names files after the object version, a rewrite
+      // needs a fresh one.
+      image->incrementVersion();
+    }
+
+    // Use the previous cel image as the delta base when it has a
+    // blob on disk, matches this image layout, and its own chain is
+    // short enough (every kMaxDeltaChain-th image is complete).
+    const Image* base = nullptr;
+    int baseChainDepth = 0;
+    if (prevImage && prevImage != image && prevImage->id() != image->id() &&
+        prevImage->pixelFormat() == image->pixelFormat() &&
+        prevImage->width() == image->width() && prevImage->height() == image->height()) {
+      const auto it = m_imageHashes.find(prevImage->id());
+      if (it != m_imageHashes.end() && it->second.saved && it->second.diskVersion != 0 &&
+          it->second.chainDepth < kMaxDeltaChain - 1) {
+        base = prevImage;
+        baseChainDepth = it->second.chainDepth;
+      }
+    }
+
+    if (base) {
+      m_deltaBase = base;
+      m_deltaBaseVersion = m_imageHashes[base->id()].diskVersion;
+      const bool ok = saveObject("img", image, &Writer::writeImageDelta);
+      m_deltaBase = nullptr;
+      if (!ok)
+        return false;
+
+      rec.baseId = base->id();
+      rec.baseVersion = m_deltaBaseVersion;
+      rec.chainDepth = baseChainDepth + 1;
+    }
+    else {
+      if (!saveObject("img", image, &Writer::writeImage))
+        return false;
+
+      rec.baseId = 0;
+      rec.baseVersion = 0;
+      rec.chainDepth = 0;
+    }
+
+    rec.hash = hash;
+    rec.saved = true;
+    rec.diskVersion = image->version();
+    return true;
+  }
+
   bool writePalette(std::ofstream& s, Palette* pal)
   {
     write_palette(s, pal);
@@ -391,7 +516,13 @@ private:
   Doc* m_doc;
   ObjVersionsMap& m_objVersions;
   base::paths& m_deleteFiles;
+  ImageHashMap& m_imageHashes;
   doc::CancelIO* m_cancel;
+
+  // Base image for writeImageDelta() (set by saveImage() around the
+  // saveObject() call).
+  const Image* m_deltaBase = nullptr;
+  doc::ObjectVersion m_deltaBaseVersion = 0;
 };
 
 } // anonymous namespace
@@ -421,6 +552,11 @@ void delete_document_internals(Doc* doc)
     if (it != g_deleteFiles.end())
       g_deleteFiles.erase(it);
   }
+  {
+    auto it = g_docImageHashes.find(doc->id());
+    if (it != g_docImageHashes.end())
+      g_docImageHashes.erase(it);
+  }
 }
 
 }} // namespace app::crash
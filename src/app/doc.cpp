@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -23,13 +23,16 @@
 #include "app/flatten.h"
 #include "app/pref/preferences.h"
 #include "app/util/cel_ops.h"
+#include "app/util/tuning.h"
 #include "base/memory.h"
+#include "base/thread_pool.h"
 #include "doc/cel.h"
 #include "doc/layer.h"
 #include "doc/layer_tilemap.h"
 #include "doc/mask.h"
 #include "doc/mask_boundaries.h"
 #include "doc/palette.h"
+#include "doc/primitives.h"
 #include "doc/slice.h"
 #include "doc/sprite.h"
 #include "doc/tag.h"
@@ -41,6 +44,7 @@
 
 #include <limits>
 #include <map>
+#include <mutex>
 
 #define DOC_TRACE(...) // TRACEARGS(__VA_ARGS__)
 
@@ -445,21 +449,30 @@ void Doc::destroyMaskBoundaries()
   notifySelectionBoundariesChanged();
 }
 
-void Doc::generateMaskBoundaries(const Mask* mask)
+void Doc::generateMaskBoundaries(const Mask* mask, const gfx::Rect& dirtyBounds)
 {
-  m_maskBoundaries.reset();
-
   // No mask specified? Use the current one in the document
   if (!mask) {
-    if (!isMaskVisible()) // The mask is hidden
-      return;             // Done, without boundaries
+    if (!isMaskVisible()) { // The mask is hidden
+      m_maskBoundaries.reset();
+      notifySelectionBoundariesChanged();
+      return; // Done, without boundaries
+    }
     else
       mask = this->mask(); // Use the document mask
   }
 
   ASSERT(mask);
 
-  if (!mask->isEmpty()) {
+  if (mask->isEmpty()) {
+    m_maskBoundaries.reset();
+  }
+  else if (!dirtyBounds.isEmpty()) {
+    // Update only the segments touching the modified region
+    m_maskBoundaries.regen(mask, dirtyBounds);
+  }
+  else {
+    m_maskBoundaries.reset();
     m_maskBoundaries.regen(mask->bitmap());
     m_maskBoundaries.offset(mask->bounds().x, mask->bounds().y);
   }
@@ -516,6 +529,14 @@ void Doc::resetTransformation()
 // Copying
 
 void Doc::copyLayerContent(const Layer* sourceLayer0, Doc* destDoc, Layer* destLayer0) const
+{
+  copyLayerContent(sourceLayer0, destDoc, destLayer0, nullptr);
+}
+
+void Doc::copyLayerContent(const Layer* sourceLayer0,
+                           Doc* destDoc,
+                           Layer* destLayer0,
+                           std::vector<std::pair<ImageRef, ImageRef>>* deferredCopies) const
 {
   LayerFlags dstFlags = sourceLayer0->flags();
 
@@ -557,11 +578,34 @@ void Doc::copyLayerContent(const Layer* sourceLayer0, Doc* destDoc, Layer* destL
         newCel->copyNonsharedPropertiesFrom(sourceCel);
       }
       else {
-        newCel.reset(create_cel_copy(nullptr, // TODO add undo information?
-                                     sourceCel,
-                                     destLayer->sprite(),
-                                     destLayer,
-                                     sourceCel->frame()));
+        const Image* srcImage = sourceCel->image();
+
+        // When the cel can be copied verbatim we just create an empty
+        // image of the same spec and defer the pixels copy. This also
+        // avoids create_cel_copy() re-rendering tilemaps through the
+        // tileset (in an exact duplicate the destination tileset is
+        // already an identical copy, so tile references are valid).
+        if (deferredCopies && srcImage && !sourceLayer->isReference() &&
+            sourceLayer->isTilemap() == destLayer->isTilemap() &&
+            srcImage->pixelFormat() ==
+              (destLayer->isTilemap() ? IMAGE_TILEMAP : destLayer->sprite()->pixelFormat())) {
+          ImageRef dstImage(Image::create(srcImage->spec()));
+
+          newCel.reset(new Cel(sourceCel->frame(), dstImage));
+          newCel->setOpacity(sourceCel->opacity());
+          newCel->copyNonsharedPropertiesFrom(sourceCel);
+          newCel->data()->setUserData(sourceCel->data()->userData());
+          newCel->setPosition(sourceCel->position());
+
+          deferredCopies->push_back(std::make_pair(sourceCel->imageRef(), dstImage));
+        }
+        else {
+          newCel.reset(create_cel_copy(nullptr, // TODO add undo information?
+                                       sourceCel,
+                                       destLayer->sprite(),
+                                       destLayer,
+                                       sourceCel->frame()));
+        }
         linked.insert(std::make_pair(sourceCel->data()->id(), newCel.get()));
       }
 
@@ -585,11 +629,11 @@ void Doc::copyLayerContent(const Layer* sourceLayer0, Doc* destDoc, Layer* destL
           destChild.reset(new LayerImage(destLayer->sprite()));
         }
 
-        copyLayerContent(sourceChild, destDoc, destChild.get());
+        copyLayerContent(sourceChild, destDoc, destChild.get(), deferredCopies);
       }
       else if (sourceChild->isGroup()) {
         destChild.reset(new LayerGroup(destLayer->sprite()));
-        copyLayerContent(sourceChild, destDoc, destChild.get());
+        copyLayerContent(sourceChild, destDoc, destChild.get(), deferredCopies);
       }
       else {
         ASSERT(false);
@@ -662,13 +706,32 @@ Doc* Doc::duplicate(DuplicateType type) const
   }
 
   switch (type) {
-    case DuplicateExactCopy:
-      // Copy the layer group
-      copyLayerContent(sourceSprite->root(), documentCopy.get(), spriteCopy->root());
+    case DuplicateExactCopy: {
+      // Copy the layer group deferring the cel image copies, which
+      // are the biggest cost when cloning a document, so we can run
+      // all of them in parallel at the end.
+      std::vector<std::pair<ImageRef, ImageRef>> deferredCopies;
+      copyLayerContent(sourceSprite->root(), documentCopy.get(), spriteCopy->root(),
+                       &deferredCopies);
+
+      if (!deferredCopies.empty()) {
+        // One shared pool for all documents (same pattern as the
+        // tiled renderer in render::Render).
+        static base::thread_pool pool(tuned_worker_count());
+        static std::mutex poolMutex;
+
+        std::lock_guard lock(poolMutex);
+        for (const auto& [srcImage, dstImage] : deferredCopies) {
+          pool.execute(
+            [srcImage, dstImage] { doc::copy_image(dstImage.get(), srcImage.get()); });
+        }
+        pool.wait_all();
+      }
 
       ASSERT((spriteCopy->backgroundLayer() && sourceSprite->backgroundLayer()) ||
              (!spriteCopy->backgroundLayer() && !sourceSprite->backgroundLayer()));
       break;
+    }
 
     case DuplicateWithFlattenLayers: {
       // Flatten layers
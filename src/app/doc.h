@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -19,6 +19,7 @@
 #include "doc/color.h"
 #include "doc/document.h"
 #include "doc/frame.h"
+#include "doc/image_ref.h"
 #include "doc/mask_boundaries.h"
 #include "doc/pixel_format.h"
 #include "gfx/rect.h"
@@ -28,6 +29,8 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace doc {
 class Cel;
@@ -193,7 +196,12 @@ public:
   // Boundaries
 
   void destroyMaskBoundaries();
-  void generateMaskBoundaries(const Mask* mask = nullptr);
+
+  // If dirtyBounds is not empty, only the boundary segments
+  // intersecting that region (in sprite coordinates) are updated,
+  // avoiding a full regen after small selection edits.
+  void generateMaskBoundaries(const Mask* mask = nullptr,
+                              const gfx::Rect& dirtyBounds = gfx::Rect());
 
   const MaskBoundaries& maskBoundaries() const { return m_maskBoundaries; }
 
@@ -248,6 +256,18 @@ public:
   // Copying
 
   void copyLayerContent(const Layer* sourceLayer, Doc* destDoc, Layer* destLayer) const;
+
+  // Like copyLayerContent(), but when a cel can be copied verbatim
+  // (same layer kind and pixel format, the case of an exact
+  // duplicate), the new cel image is created empty and the
+  // source/destination pair is appended to "deferredCopies" so the
+  // caller can copy all the pixels at the end (duplicate() does it in
+  // parallel).
+  void copyLayerContent(const Layer* sourceLayer,
+                        Doc* destDoc,
+                        Layer* destLayer,
+                        std::vector<std::pair<ImageRef, ImageRef>>* deferredCopies) const;
+
   Doc* duplicate(DuplicateType type) const;
 
   void close();
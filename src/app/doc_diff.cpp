@@ -17,7 +17,6 @@
 #include "doc/layer.h"
 #include "doc/layer_tilemap.h"
 #include "doc/palette.h"
-#include "doc/primitives.h"
 #include "doc/sprite.h"
 #include "doc/tag.h"
 #include "doc/tileset.h"
@@ -162,7 +161,7 @@ DocDiff compare_docs(const Doc* a, const Doc* b)
       }
       else {
         for (tile_index ti = 0; ti < aTileset->size(); ++ti) {
-          if (!is_same_image(aTileset->get(ti).get(), bTileset->get(ti).get())) {
+          if (aTileset->get(ti)->contentHash() != bTileset->get(ti)->contentHash()) {
             diff.anything = diff.tilesets = true;
             goto done;
           }
@@ -219,8 +218,13 @@ DocDiff compare_docs(const Doc* a, const Doc* b)
               TRACEDIFF(aCel->data()->userData(), bCel->data()->userData());
             }
             if (aCel->image() && bCel->image()) {
+              // Comparing content hashes (cached per-image until its
+              // version changes) instead of pixels makes this
+              // periodic scan O(modified images): untouched
+              // cels/tiles reuse the hash calculated in previous
+              // scans.
               if (aCel->image()->bounds() != bCel->image()->bounds() ||
-                  !is_same_image(aCel->image(), bCel->image()))
+                  aCel->image()->contentHash() != bCel->image()->contentHash())
                 diff.anything = diff.images = true;
             }
             // In case one is nullptr and the other not
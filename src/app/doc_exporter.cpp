@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -18,6 +18,7 @@
 #include "app/doc.h"
 #include "app/file/file.h"
 #include "app/filename_formatter.h"
+#include "app/job_scheduler.h"
 #include "app/restore_visible_layers.h"
 #include "app/snap_to_grid.h"
 #include "app/util/autocrop.h"
@@ -31,6 +32,7 @@
 #include "doc/image.h"
 #include "doc/images_map.h"
 #include "doc/layer.h"
+#include "doc/layer_tilemap.h"
 #include "doc/palette.h"
 #include "doc/primitives.h"
 #include "doc/selected_frames.h"
@@ -38,6 +40,7 @@
 #include "doc/slice.h"
 #include "doc/sprite.h"
 #include "doc/tag.h"
+#include "doc/tileset.h"
 #include "gfx/packing_rects.h"
 #include "gfx/rect_io.h"
 #include "gfx/size.h"
@@ -48,10 +51,13 @@
 #include "ver/info.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstdio>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <set>
 #include <vector>
@@ -70,6 +76,40 @@ std::string escape_for_json(const std::string& path)
   return res;
 }
 
+// Header of the pack manifest saved next to the texture file (see
+// DocExporter::renderTexture() for how it's used on re-exports).
+const char* kPackManifestMagic = "aseprite-pack";
+constexpr int kPackManifestVersion = 1;
+
+// 64-bit FNV-1a used to fingerprint the source content of each
+// sprite sheet sample in the pack manifest.
+constexpr uint64_t kHashBasis = 0xcbf29ce484222325ull;
+
+uint64_t hash_bytes(uint64_t h, const void* data, const size_t size)
+{
+  auto* p = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    h ^= p[i];
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+uint64_t hash_int(const uint64_t h, const int64_t value)
+{
+  return hash_bytes(h, &value, sizeof(value));
+}
+
+uint64_t hash_image(uint64_t h, const doc::Image* image)
+{
+  h = hash_int(h, image->pixelFormat());
+  h = hash_int(h, image->width());
+  h = hash_int(h, image->height());
+  for (int y = 0; y < image->height(); ++y)
+    h = hash_bytes(h, image->getPixelAddress(0, y), image->widthBytes());
+  return h;
+}
+
 // Forward declaration
 void serialize_properties(const doc::UserData::Properties& props, std::ostream& os);
 
@@ -402,6 +442,143 @@ public:
     }
   }
 
+  // Identity of this sample in the pack manifest. It must be stable
+  // across program runs so we build it from the source file name and
+  // the frame/tag/layers that produce the sample (object IDs are
+  // regenerated on each session and cannot be used here).
+  std::string packKey() const
+  {
+    std::string key = m_document->filename();
+    key += "|";
+    key += base::convert_to<std::string>(int(m_frame));
+    key += "|";
+    if (m_tag)
+      key += m_tag->name();
+    if (m_selLayers) {
+      std::vector<std::string> names;
+      for (const Layer* layer : *m_selLayers)
+        names.push_back(layer->name());
+      std::sort(names.begin(), names.end());
+      for (const auto& name : names) {
+        key += "|";
+        key += name;
+      }
+    }
+    key += "|";
+    key += m_filename;
+    return key;
+  }
+
+  // Hash of everything that determines the pixels that
+  // renderSample() will produce for this sample. Like packKey() this
+  // must be comparable across sessions, so we hash the source pixels
+  // themselves instead of relying on doc::Object versions.
+  uint64_t contentHash() const
+  {
+    uint64_t h = kHashBasis;
+    h = hash_int(h, m_trimmedBounds.x);
+    h = hash_int(h, m_trimmedBounds.y);
+    h = hash_int(h, m_trimmedBounds.w);
+    h = hash_int(h, m_trimmedBounds.h);
+    if (m_image)
+      return hash_image(h, m_image.get());
+
+    h = hash_int(h, m_sprite->pixelFormat());
+    h = hash_int(h, m_sprite->transparentColor());
+    const Palette* pal = m_sprite->palette(m_frame);
+    h = hash_int(h, pal->size());
+    for (int i = 0; i < pal->size(); ++i)
+      h = hash_int(h, pal->getEntry(i));
+
+    for (const Layer* layer : m_sprite->allLayers()) {
+      // renderSample() shows the selected layers only (if any), in
+      // other case it renders the currently visible layers.
+      if (m_selLayers) {
+        if (!m_selLayers->contains(layer))
+          continue;
+      }
+      else if (!layer->isVisibleHierarchy())
+        continue;
+
+      if (!layer->isImage())
+        continue;
+
+      h = hash_int(h, layer->opacity());
+      h = hash_int(h, int(layer->blendMode()));
+
+      if (layer->isTilemap()) {
+        const Tileset* tileset = static_cast<const LayerTilemap*>(layer)->tileset();
+        for (tile_index ti = 0; ti < tileset->size(); ++ti) {
+          if (const ImageRef& tileImg = tileset->get(ti))
+            h = hash_image(h, tileImg.get());
+        }
+      }
+
+      const Cel* cel = layer->cel(m_frame);
+      if (!cel)
+        continue;
+      h = hash_int(h, cel->x());
+      h = hash_int(h, cel->y());
+      h = hash_int(h, cel->opacity());
+      h = hash_int(h, cel->zIndex());
+      h = hash_image(h, cel->image());
+    }
+    return h;
+  }
+
+  // Session-local key with everything that determines the pixels
+  // that renderSample() will produce, aggregating doc::Object
+  // IDs/versions instead of reading pixels. Two samples with the
+  // same non-empty key render exactly the same image, so the layout
+  // algorithms can skip rendering duplicated frames entirely.
+  // Unlike packKey()/contentHash() it's not comparable across
+  // sessions, and two samples from different sprites never share a
+  // key even with equal pixels (the pixel-based dedup still catches
+  // those).
+  std::vector<uint64_t> versionKey() const
+  {
+    std::vector<uint64_t> key;
+    if (m_image)
+      return key; // Pre-rendered samples fall back to pixel comparison
+
+    key.reserve(32);
+    key.push_back(m_sprite->id());
+    key.push_back(uint64_t(uint32_t(m_trimmedBounds.x)) |
+                  (uint64_t(uint32_t(m_trimmedBounds.y)) << 32));
+    key.push_back(uint64_t(uint32_t(m_trimmedBounds.w)) |
+                  (uint64_t(uint32_t(m_trimmedBounds.h)) << 32));
+
+    const Palette* pal = m_sprite->palette(m_frame);
+    key.push_back(pal->id());
+    key.push_back(pal->getModifications());
+
+    for (const Layer* layer : m_sprite->allLayers()) {
+      // Same layer filter used in renderSample()/contentHash().
+      if (m_selLayers) {
+        if (!m_selLayers->contains(layer))
+          continue;
+      }
+      else if (!layer->isVisibleHierarchy())
+        continue;
+
+      if (!layer->isImage())
+        continue;
+
+      // The layer ID covers its per-session constant properties
+      // (opacity, blend mode, tileset content, etc.).
+      key.push_back(layer->id());
+
+      const Cel* cel = layer->cel(m_frame);
+      if (!cel)
+        continue;
+      key.push_back(uint64_t(uint32_t(cel->x())) | (uint64_t(uint32_t(cel->y())) << 32));
+      key.push_back(uint64_t(cel->opacity()) | (uint64_t(uint32_t(cel->zIndex())) << 32));
+      key.push_back(cel->image()->id());
+      key.push_back(cel->image()->version());
+    }
+    return key;
+  }
+
   void setPixelFormat(const doc::PixelFormat newPixelFormat)
   {
     if (!m_image || m_image->pixelFormat() == newPixelFormat)
@@ -516,6 +693,7 @@ public:
     const Tag* oldTag = nullptr;
 
     doc::ImagesMap duplicates;
+    std::map<std::vector<uint64_t>, uint32_t> versionDups;
     gfx::Point framePt(borderPadding, borderPadding);
     gfx::Size rowSize(0, 0);
 
@@ -541,6 +719,20 @@ public:
       }
 
       if (m_mergeDups || sample.isLinked()) {
+        // Cheap version-based detection first, to avoid rendering
+        // frames that hold the same cels as a previous sample.
+        std::vector<uint64_t> key = sample.versionKey();
+        if (!key.empty()) {
+          auto keyIt = versionDups.find(key);
+          if (keyIt != versionDups.end()) {
+            sample.setDuplicated();
+            sample.setSharedBounds(samples[keyIt->second].sharedBounds());
+            ++i;
+            continue;
+          }
+          versionDups[std::move(key)] = i;
+        }
+
         doc::ImageBufferPtr sampleBuf = std::make_shared<doc::ImageBuffer>();
         doc::ImageRef sampleRender(sample.createRender(sampleBuf));
         auto it = duplicates.find(sampleRender);
@@ -644,6 +836,99 @@ private:
   bool m_mergeDups;
 };
 
+namespace {
+
+// Bottom-left skyline rectangle packer used for the thousands-of-
+// samples case, where the gfx::PackingRects best-fit search is too
+// slow. Rectangles are placed (sorted by height) at the position with
+// the lowest possible top edge.
+class SkylinePacker {
+public:
+  explicit SkylinePacker(const int width) : m_width(width)
+  {
+    m_skyline.push_back(Segment{ 0, 0, width });
+  }
+
+  int usedHeight() const { return m_usedHeight; }
+
+  bool add(const gfx::Size& sz, gfx::Rect& output)
+  {
+    int bestY = -1, bestX = 0;
+    size_t bestSeg = 0;
+    for (size_t i = 0; i < m_skyline.size(); ++i) {
+      int y;
+      if (fits(i, sz.w, y) && (bestY < 0 || y < bestY || (y == bestY && m_skyline[i].x < bestX))) {
+        bestY = y;
+        bestX = m_skyline[i].x;
+        bestSeg = i;
+      }
+    }
+    if (bestY < 0)
+      return false;
+
+    output = gfx::Rect(bestX, bestY, sz.w, sz.h);
+    place(bestSeg, output);
+    m_usedHeight = std::max(m_usedHeight, output.y2());
+    return true;
+  }
+
+private:
+  // The skyline always tiles the whole [0, m_width) range with
+  // contiguous segments.
+  struct Segment {
+    int x, y, w;
+  };
+
+  // Checks if a rectangle of the given width fits in the skyline
+  // starting at the i-th segment, returning the y position where it
+  // would rest (the maximum height of all the spanned segments).
+  bool fits(const size_t i, const int w, int& y) const
+  {
+    const int x2 = m_skyline[i].x + w;
+    if (x2 > m_width)
+      return false;
+    y = m_skyline[i].y;
+    for (size_t j = i; j < m_skyline.size() && m_skyline[j].x < x2; ++j)
+      y = std::max(y, m_skyline[j].y);
+    return true;
+  }
+
+  void place(const size_t i, const gfx::Rect& rc)
+  {
+    m_skyline.insert(m_skyline.begin() + i, Segment{ rc.x, rc.y2(), rc.w });
+
+    // Erase/shrink the segments shadowed by the new one.
+    size_t j = i + 1;
+    while (j < m_skyline.size() && m_skyline[j].x < rc.x2()) {
+      const int overlap = rc.x2() - m_skyline[j].x;
+      if (overlap >= m_skyline[j].w) {
+        m_skyline.erase(m_skyline.begin() + j);
+      }
+      else {
+        m_skyline[j].x += overlap;
+        m_skyline[j].w -= overlap;
+        break;
+      }
+    }
+
+    // Merge consecutive segments with the same height.
+    for (j = 0; j + 1 < m_skyline.size();) {
+      if (m_skyline[j].y == m_skyline[j + 1].y) {
+        m_skyline[j].w += m_skyline[j + 1].w;
+        m_skyline.erase(m_skyline.begin() + j + 1);
+      }
+      else
+        ++j;
+    }
+  }
+
+  int m_width;
+  int m_usedHeight = 0;
+  std::vector<Segment> m_skyline;
+};
+
+} // anonymous namespace
+
 class DocExporter::BestFitLayoutSamples : public DocExporter::LayoutSamples {
 public:
   void layoutSamples(Samples& samples,
@@ -653,26 +938,86 @@ public:
                      int& height,
                      base::task_token& token) override
   {
-    gfx::PackingRects pr(borderPadding, shapePadding);
     doc::ImagesMap duplicates;
 
-    uint32_t i = 0;
-    for (auto& sample : samples) {
+    // Detect duplicated samples comparing cel/palette versions, so
+    // they aren't rasterized at all. The pixel-based dedup below
+    // still catches duplicates with different keys (e.g. equal
+    // content coming from different sprites).
+    std::vector<int> dupOf(samples.size(), -1);
+    {
+      std::map<std::vector<uint64_t>, int> versionDups;
+      int idx = 0;
+      for (auto& sample : samples) {
+        if (!sample.isEmpty()) {
+          std::vector<uint64_t> key = sample.versionKey();
+          if (!key.empty()) {
+            auto it = versionDups.find(key);
+            if (it != versionDups.end())
+              dupOf[idx] = it->second;
+            else
+              versionDups[std::move(key)] = idx;
+          }
+        }
+        ++idx;
+      }
+    }
+
+    // Rasterize all the unique samples (needed to look for
+    // duplicates) parallelizing between sprites: samples of the same
+    // sprite are rendered serially because renderSample() can change
+    // the layers visibility of its sprite temporarily.
+    std::vector<doc::ImageRef> renders(samples.size());
+    {
+      std::vector<std::vector<int>> groups;
+      std::map<const Sprite*, size_t> groupOf;
+      int idx = 0;
+      for (auto& sample : samples) {
+        if (!sample.isEmpty() && dupOf[idx] < 0) {
+          auto it = groupOf.find(sample.sprite());
+          if (it == groupOf.end()) {
+            it = groupOf.insert(std::make_pair(sample.sprite(), groups.size())).first;
+            groups.emplace_back();
+          }
+          groups[it->second].push_back(idx);
+        }
+        ++idx;
+      }
+
+      token.set_progress_range(0.2f, 0.3f);
+      std::atomic<int> done(0);
+      JobScheduler::instance()->forkJoin(int(groups.size()), [&](int g) {
+        for (const int i : groups[g]) {
+          if (token.canceled())
+            return;
+
+          // We have to use one ImageBuffer for each image because
+          // we're going to store all images in the "duplicates" map.
+          doc::ImageBufferPtr sampleBuf = std::make_shared<doc::ImageBuffer>();
+          renders[i] = (samples.begin() + i)->createRender(sampleBuf);
+          token.set_progress(float(++done) / samples.size());
+        }
+      });
       if (token.canceled())
         return;
-      token.set_progress_range(0.2f, 0.3f);
-      token.set_progress(float(i) / samples.size());
+    }
 
+    uint32_t i = 0;
+    std::vector<gfx::Size> sizes; // Sizes to pack, in samples order
+    for (auto& sample : samples) {
       if (sample.isEmpty()) {
         ++i;
         continue;
       }
 
-      // We have to use one ImageBuffer for each image because we're
-      // going to store all images in the "duplicates" map.
-      doc::ImageBufferPtr sampleBuf = std::make_shared<doc::ImageBuffer>();
-      doc::ImageRef sampleRender(sample.createRender(sampleBuf));
-      auto it = duplicates.find(sampleRender);
+      if (dupOf[i] >= 0) {
+        sample.setDuplicated();
+        sample.setSharedBounds(samples[dupOf[i]].sharedBounds());
+        ++i;
+        continue;
+      }
+
+      auto it = duplicates.find(renders[i]);
       if (it != duplicates.end()) {
         const uint32_t j = it->second;
 
@@ -680,32 +1025,92 @@ public:
         sample.setSharedBounds(samples[j].sharedBounds());
       }
       else {
-        duplicates[sampleRender] = i;
-        pr.add(sample.requiredSize());
+        duplicates[renders[i]] = i;
+        sizes.push_back(sample.requiredSize());
       }
       ++i;
     }
 
     token.set_progress_range(0.3f, 0.4f);
-    if (width == 0 || height == 0) {
-      gfx::Size sz = pr.bestFit(token, width, height);
-      width = sz.w;
-      height = sz.h;
+    std::vector<gfx::Rect> packedRects;
+    if ((width == 0 || height == 0) && int(sizes.size()) >= kSkylinePackingThreshold) {
+      // With thousands of samples the best-fit search of
+      // gfx::PackingRects is too slow, use the skyline packer to
+      // auto-size the texture.
+      packSkyline(sizes, borderPadding, shapePadding, width, height, packedRects);
     }
     else {
-      pr.pack(gfx::Size(width, height), token);
+      gfx::PackingRects pr(borderPadding, shapePadding);
+      for (const auto& size : sizes)
+        pr.add(size);
+
+      if (width == 0 || height == 0) {
+        gfx::Size sz = pr.bestFit(token, width, height);
+        width = sz.w;
+        height = sz.h;
+      }
+      else {
+        pr.pack(gfx::Size(width, height), token);
+      }
+      packedRects.assign(pr.begin(), pr.end());
     }
     token.set_progress_range(0.0f, 1.0f);
 
-    auto it = pr.begin();
+    auto it = packedRects.begin();
     for (auto& sample : samples) {
       if (sample.isLinked() || sample.isDuplicated() || sample.isEmpty())
         continue;
 
-      ASSERT(it != pr.end());
+      ASSERT(it != packedRects.end());
       sample.setInTextureBounds(*(it++));
     }
   }
+
+private:
+  // Number of unique samples from which we prefer the skyline packer
+  // over gfx::PackingRects to auto-size the texture.
+  static const int kSkylinePackingThreshold = 1024;
+
+  static void packSkyline(const std::vector<gfx::Size>& sizes,
+                          const int borderPadding,
+                          const int shapePadding,
+                          int& width,
+                          int& height,
+                          std::vector<gfx::Rect>& output)
+  {
+    // Pack taller (then wider) samples first to get a compact
+    // skyline, but return the rectangles in the input order.
+    std::vector<int> order(sizes.size());
+    for (int i = 0; i < int(order.size()); ++i)
+      order[i] = i;
+    std::sort(order.begin(), order.end(), [&sizes](int a, int b) {
+      return (sizes[a].h > sizes[b].h || (sizes[a].h == sizes[b].h && sizes[a].w > sizes[b].w));
+    });
+
+    uint64_t area = 0;
+    int maxW = 1;
+    for (const auto& sz : sizes) {
+      area += uint64_t(sz.w + shapePadding) * uint64_t(sz.h + shapePadding);
+      maxW = std::max(maxW, sz.w);
+    }
+
+    // Packing width for a roughly square texture, rounded up to a
+    // power of two.
+    int packWidth = 1;
+    while (packWidth < maxW + shapePadding || uint64_t(packWidth) * uint64_t(packWidth) < area)
+      packWidth *= 2;
+
+    SkylinePacker packer(packWidth);
+    output.resize(sizes.size());
+    for (const int i : order) {
+      gfx::Rect rc;
+      packer.add(gfx::Size(sizes[i].w + shapePadding, sizes[i].h + shapePadding), rc);
+      output[i] = gfx::Rect(rc.x + borderPadding, rc.y + borderPadding, sizes[i].w, sizes[i].h);
+    }
+
+    width = packWidth + 2 * borderPadding;
+    height = std::max(1, packer.usedHeight() - shapePadding) + 2 * borderPadding;
+  }
 };
 
 DocExporter::DocExporter()
@@ -833,8 +1238,13 @@ Doc* DocExporter::exportSheet(Context* ctx, base::task_token& token)
     DX_TRACE("DX: exportSheet", m_textureFilename);
     textureDocument->setFilename(m_textureFilename.c_str());
     int ret = save_document(ctx, textureDocument.get());
-    if (ret == 0)
+    if (ret == 0) {
       textureDocument->markAsSaved();
+
+      // Save the pack manifest so the next export over this file can
+      // reuse the unchanged samples (see renderTexture()).
+      savePackManifest(texture->pixelFormat());
+    }
   }
 
   token.set_progress(1.0f);
@@ -1365,26 +1775,168 @@ Doc* DocExporter::createEmptyTexture(const Samples& samples, base::task_token& t
 void DocExporter::renderTexture(Context* ctx,
                                 const Samples& samples,
                                 Image* textureImage,
-                                base::task_token& token) const
+                                base::task_token& token)
 {
   textureImage->clear(textureImage->maskColor());
 
-  int i = 0;
-  for (const auto& sample : samples) {
-    if (token.canceled())
-      return;
-    token.set_progress(0.6f + 0.2f * i / int(samples.size()));
+  // Incremental re-export: if a pack manifest from a previous export
+  // exists next to the texture file, samples whose source content
+  // didn't change (and kept the same place in the layout) are copied
+  // straight from the old atlas, and only the modified ones are
+  // re-rendered.
+  m_packEntries.clear();
+  const bool trackSamples = !m_textureFilename.empty();
+  std::map<std::string, PackEntry> prevEntries;
+  ImageRef prevTexture;
+  if (trackSamples) {
+    std::vector<PackEntry> entries;
+    if (loadPackManifest(textureImage->pixelFormat(), entries)) {
+      prevTexture = loadPreviousTexture(textureImage->pixelFormat());
+      if (prevTexture) {
+        for (const auto& entry : entries)
+          prevEntries[entry.key] = entry;
+      }
+    }
+  }
 
-    if (sample.isLinked() || sample.isDuplicated() || sample.isEmpty()) {
-      ++i;
-      continue;
+  std::atomic<int> done(0);
+  const int total = std::max<int>(1, samples.size());
+
+  // Group the samples by sprite so we can render sprites in parallel.
+  // Samples of the same sprite must be rendered serially because
+  // renderSample() can change the layers visibility of its sprite
+  // temporarily. Samples never overlap in the texture, so different
+  // jobs write disjoint areas of "textureImage".
+  std::vector<std::vector<const Sample*>> groups;
+  {
+    std::map<const Sprite*, size_t> groupOf;
+    for (const auto& sample : samples) {
+      if (sample.isLinked() || sample.isDuplicated() || sample.isEmpty())
+        continue;
+
+      if (trackSamples) {
+        PackEntry entry;
+        entry.key = sample.packKey();
+        entry.hash = sample.contentHash();
+        entry.bounds = sample.inTextureBounds();
+        m_packEntries.push_back(entry);
+
+        if (prevTexture) {
+          auto it = prevEntries.find(entry.key);
+          if (it != prevEntries.end() && it->second.hash == entry.hash &&
+              it->second.bounds == entry.bounds && prevTexture->bounds().contains(entry.bounds)) {
+            textureImage->copy(prevTexture.get(),
+                               gfx::Clip(entry.bounds.x, entry.bounds.y, entry.bounds));
+            token.set_progress(0.6f + 0.2f * (++done) / total);
+            continue;
+          }
+        }
+      }
+
+      auto it = groupOf.find(sample.sprite());
+      if (it == groupOf.end()) {
+        it = groupOf.insert(std::make_pair(sample.sprite(), groups.size())).first;
+        groups.emplace_back();
+      }
+      groups[it->second].push_back(&sample);
+    }
+  }
+  JobScheduler::instance()->forkJoin(int(groups.size()), [&](int g) {
+    for (const Sample* sample : groups[g]) {
+      if (token.canceled())
+        return;
+
+      sample->renderSample(textureImage,
+                           sample->inTextureBounds().x + m_innerPadding,
+                           sample->inTextureBounds().y + m_innerPadding,
+                           m_extrude);
+      token.set_progress(0.6f + 0.2f * (++done) / total);
     }
-    sample.renderSample(textureImage,
-                        sample.inTextureBounds().x + m_innerPadding,
-                        sample.inTextureBounds().y + m_innerPadding,
-                        m_extrude);
-    ++i;
+  });
+}
+
+std::string DocExporter::packManifestFilename() const
+{
+  ASSERT(!m_textureFilename.empty());
+  return m_textureFilename + ".pack";
+}
+
+bool DocExporter::loadPackManifest(const doc::PixelFormat textureFormat,
+                                   std::vector<PackEntry>& entries) const
+{
+  std::ifstream f(FSTREAM_PATH(packManifestFilename()));
+  if (!f)
+    return false;
+
+  // The header records the settings that change the pixels inside
+  // each sample rect; if they don't match the current export the
+  // whole manifest is useless.
+  std::string magic;
+  int version, format, innerPadding, extrude;
+  if (!(f >> magic >> version >> format >> innerPadding >> extrude) ||
+      magic != kPackManifestMagic || version != kPackManifestVersion ||
+      format != int(textureFormat) || innerPadding != m_innerPadding || extrude != int(m_extrude))
+    return false;
+
+  PackEntry entry;
+  while (f >> std::hex >> entry.hash >> std::dec >> entry.bounds.x >> entry.bounds.y >>
+         entry.bounds.w >> entry.bounds.h) {
+    f.ignore(); // Skip the space before the key
+    if (!std::getline(f, entry.key))
+      break;
+    entries.push_back(entry);
   }
+  return !entries.empty();
+}
+
+void DocExporter::savePackManifest(const doc::PixelFormat textureFormat) const
+{
+  std::ofstream f(FSTREAM_PATH(packManifestFilename()), std::ios::out);
+  if (!f)
+    return;
+
+  f << kPackManifestMagic << " " << kPackManifestVersion << " " << int(textureFormat) << " "
+    << m_innerPadding << " " << int(m_extrude) << "\n";
+  for (const PackEntry& entry : m_packEntries) {
+    f << std::hex << std::setfill('0') << std::setw(16) << entry.hash << std::dec << " "
+      << entry.bounds.x << " " << entry.bounds.y << " " << entry.bounds.w << " " << entry.bounds.h
+      << " " << entry.key << "\n";
+  }
+}
+
+doc::ImageRef DocExporter::loadPreviousTexture(const doc::PixelFormat textureFormat) const
+{
+  // The manifest is only usable with RGB/grayscale atlases: an
+  // indexed atlas is re-quantized on each export, so equal pixels in
+  // the old file can map to different palette indexes.
+  if (textureFormat != IMAGE_RGB && textureFormat != IMAGE_GRAYSCALE)
+    return nullptr;
+
+  if (!base::is_file(m_textureFilename))
+    return nullptr;
+
+  // Load the atlas saved by the previous export without a context
+  // (so the document is never added to the UI).
+  std::unique_ptr<FileOp> fop(
+    FileOp::createLoadDocumentOperation(nullptr,
+                                        m_textureFilename,
+                                        FILE_LOAD_SEQUENCE_NONE | FILE_LOAD_ONE_FRAME));
+  if (!fop)
+    return nullptr;
+  fop->operate();
+  fop->done();
+  fop->postLoad();
+
+  std::unique_ptr<Doc> doc(fop->releaseDocument());
+  if (fop->hasError() || !doc || !doc->sprite() ||
+      doc->sprite()->pixelFormat() != textureFormat)
+    return nullptr;
+
+  const Sprite* sprite = doc->sprite();
+  doc::ImageRef image(Image::create(sprite->spec()));
+  render::Render render;
+  render.renderSprite(image.get(), sprite, frame_t(0));
+  return image;
 }
 
 void DocExporter::trimTexture(const Samples& samples, doc::Sprite* texture) const
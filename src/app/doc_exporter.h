@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -18,6 +18,7 @@
 #include "doc/image_ref.h"
 #include "doc/object_id.h"
 #include "doc/object_version.h"
+#include "doc/pixel_format.h"
 #include "gfx/fwd.h"
 #include "gfx/rect.h"
 
@@ -114,10 +115,26 @@ private:
   void renderTexture(Context* ctx,
                      const Samples& samples,
                      doc::Image* textureImage,
-                     base::task_token& token) const;
+                     base::task_token& token);
   void trimTexture(const Samples& samples, doc::Sprite* texture) const;
   void createDataFile(const Samples& samples, std::ostream& os, doc::Sprite* texture);
 
+  // Incremental re-export support: a pack manifest saved next to the
+  // texture file maps each rendered sample to its rect in the atlas
+  // and a hash of its source content, so the next export over the
+  // same file can copy unchanged samples from the previous atlas
+  // instead of re-rendering them (see renderTexture()).
+  struct PackEntry {
+    std::string key;
+    uint64_t hash;
+    gfx::Rect bounds;
+  };
+  std::string packManifestFilename() const;
+  bool loadPackManifest(const doc::PixelFormat textureFormat,
+                        std::vector<PackEntry>& entries) const;
+  void savePackManifest(const doc::PixelFormat textureFormat) const;
+  doc::ImageRef loadPreviousTexture(const doc::PixelFormat textureFormat) const;
+
   class Item {
   public:
     Doc* doc = nullptr;
@@ -187,6 +204,10 @@ private:
     bool trimmedByGrid;
   } m_cache;
 
+  // Entries for the pack manifest of the last renderTexture() call
+  // (saved to disk only after the texture file is saved).
+  std::vector<PackEntry> m_packEntries;
+
   DISABLE_COPYING(DocExporter);
 };
 
@@ -0,0 +1,208 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/doc_hibernation.h"
+
+#include "app/doc.h"
+#include "app/pref/preferences.h"
+#include "base/convert_to.h"
+#include "base/fs.h"
+#include "base/fstream_path.h"
+#include "base/process.h"
+#include "doc/cel.h"
+#include "doc/cel_data.h"
+#include "doc/cels_range.h"
+#include "doc/image.h"
+#include "doc/image_io.h"
+#include "doc/image_ref.h"
+#include "doc/image_spec.h"
+#include "doc/layer.h"
+#include "doc/object.h"
+#include "doc/sprite.h"
+
+#include <fstream>
+
+#define HIBERNATE_TRACE(...) // TRACEARGS
+
+namespace app {
+
+namespace {
+
+std::string spill_filename(const Doc* doc)
+{
+  // The process id avoids collisions between two running instances
+  // that happen to assign the same object id to a document.
+  return base::join_path(base::get_temp_path(),
+                         "aseprite-hibernated-" +
+                           base::convert_to<std::string>(int(base::get_current_process_id())) +
+                           "-" + base::convert_to<std::string>(int(doc->id())) + ".img");
+}
+
+} // anonymous namespace
+
+DocHibernation::~DocHibernation()
+{
+  // Normally all documents were already removed (and their spill
+  // files deleted) when they were closed, this is just a safety net.
+  for (const auto& it : m_spilled) {
+    try {
+      base::delete_file(it.second.path);
+    }
+    catch (const std::exception&) {
+      // The temp file will be removed by the OS eventually
+    }
+  }
+}
+
+void DocHibernation::onActiveDocumentChange(Doc* doc)
+{
+  const base::tick_t now = base::current_tick();
+
+  if (doc) {
+    rehydrate(doc);
+    m_lastActivation[doc] = now;
+  }
+
+  auto& pref = Preferences::instance();
+  const bool hibernateCold = pref.memory.hibernateColdDocs();
+  const base::tick_t coldMSecs = base::tick_t(1000.0 * 60.0 * pref.memory.hibernateColdDocsFor());
+
+  for (const auto& it : m_lastActivation) {
+    Doc* other = const_cast<Doc*>(it.first);
+    if (other == doc || isHibernated(other))
+      continue;
+
+    // Read-only documents (reference tabs) spill as soon as they
+    // leave the foreground, even with the cold-docs preference
+    // disabled: they cannot be modified, so dropping their buffers is
+    // always safe and keeps dozens of open references near zero
+    // resident memory.
+    if (!other->isReadOnly() && (!hibernateCold || now - it.second < coldMSecs))
+      continue;
+
+    // Modified documents must stay resident for the periodic backups
+    // (crash::BackupObserver reads their cel images at any time).
+    if (other->isModified() || !other->sprite())
+      continue;
+
+    hibernate(other);
+  }
+}
+
+void DocHibernation::removeDocument(Doc* doc)
+{
+  rehydrate(doc);
+  m_lastActivation.erase(doc);
+}
+
+void DocHibernation::hibernate(Doc* doc)
+{
+  doc::Sprite* sprite = doc->sprite();
+  SpilledDoc spilled;
+  spilled.path = spill_filename(doc);
+
+  HIBERNATE_TRACE("HIBERNATE: Spilling", doc->name(), "to", spilled.path);
+
+  // First pass: serialize all cel images to the spill file. Only if
+  // the whole file is written correctly we drop the buffers, so a
+  // full disk cannot leave a half-empty document.
+  {
+    std::ofstream f(FSTREAM_PATH(spilled.path), std::ofstream::binary);
+    if (!f)
+      return;
+
+    for (doc::Cel* cel : sprite->uniqueCels()) {
+      // Tilemap cels are tiny (they store tile indexes); the heavy
+      // pixels live in the tilesets, which stay resident.
+      if (cel->layer()->isTilemap())
+        continue;
+
+      doc::Image* image = cel->image();
+      if (!image)
+        continue;
+
+      SpilledImage rec;
+      rec.celData = cel->data()->id();
+      rec.offset = size_t(f.tellp());
+      if (!doc::write_image(f, image))
+        break;
+
+      spilled.images.push_back(rec);
+    }
+
+    f.close();
+    if (f.fail() || spilled.images.empty()) {
+      try {
+        base::delete_file(spilled.path);
+      }
+      catch (const std::exception&) {
+        // Ignore
+      }
+      return;
+    }
+  }
+
+  // Second pass: replace each spilled image with an empty lazy-strips
+  // placeholder of the same dimensions, which only costs its row
+  // table (see ImageSpec::lazyStrips()), releasing the pixel buffers.
+  for (const SpilledImage& rec : spilled.images) {
+    doc::CelData* celData = doc::get<doc::CelData>(rec.celData);
+    ASSERT(celData);
+    if (!celData)
+      continue;
+
+    doc::ImageSpec spec = celData->image()->spec();
+    spec.setLazyStrips(true);
+    celData->setImage(doc::ImageRef(doc::Image::create(spec)), nullptr);
+  }
+
+  m_spilled[doc] = std::move(spilled);
+}
+
+void DocHibernation::rehydrate(Doc* doc)
+{
+  auto it = m_spilled.find(doc);
+  if (it == m_spilled.end())
+    return;
+
+  SpilledDoc& spilled = it->second;
+
+  HIBERNATE_TRACE("HIBERNATE: Rehydrating", doc->name(), "from", spilled.path);
+
+  {
+    std::ifstream f(FSTREAM_PATH(spilled.path), std::ifstream::binary);
+    for (const SpilledImage& rec : spilled.images) {
+      doc::CelData* celData = doc::get<doc::CelData>(rec.celData);
+      if (!celData || !f)
+        continue;
+
+      f.seekg(rec.offset);
+
+      // read_image() restores the object id serialized by
+      // write_image(), so undo commands that reference the image by
+      // id keep working after the hibernation round trip.
+      doc::ImageRef image(doc::read_image(f));
+      ASSERT(image);
+      if (image)
+        celData->setImage(image, nullptr);
+    }
+  }
+
+  try {
+    base::delete_file(spilled.path);
+  }
+  catch (const std::exception&) {
+    // The temp file will be removed by the OS eventually
+  }
+
+  m_spilled.erase(it);
+}
+
+} // namespace app
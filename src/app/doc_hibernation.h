@@ -0,0 +1,72 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_DOC_HIBERNATION_H_INCLUDED
+#define APP_DOC_HIBERNATION_H_INCLUDED
+#pragma once
+
+#include "base/time.h"
+#include "doc/object_id.h"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace app {
+class Doc;
+
+// Spills the cel images of cold documents (tabs inactive for some
+// minutes, see the memory.hibernate_cold_docs_* preferences) to a
+// temporary file and replaces them with empty lazy-strips
+// placeholders of the same dimensions, so sessions with dozens of
+// open reference tabs don't keep every pixel buffer resident. A
+// hibernated document is transparently rehydrated when its tab is
+// activated again (or before it's closed, so the closed-docs list
+// always receives complete documents). Read-only reference documents
+// don't wait for the cold timeout: they spill as soon as their tab
+// leaves the foreground.
+//
+// Only unmodified documents are hibernated: modified ones are being
+// written periodically by crash::BackupObserver (which reads the cel
+// images), and their undo history would keep most buffers alive
+// anyway. Tilemap cels are left untouched too, as the heavy pixels
+// live in the tilesets, which are shared between cels.
+class DocHibernation {
+public:
+  ~DocHibernation();
+
+  // Called when the active document changes: rehydrates "doc" if it
+  // was hibernated, stamps its activation time, and takes the chance
+  // to hibernate other documents that got cold.
+  void onActiveDocumentChange(Doc* doc);
+
+  // Forgets everything about the document (e.g. when it's going to
+  // be closed), rehydrating it first if needed.
+  void removeDocument(Doc* doc);
+
+  bool isHibernated(const Doc* doc) const { return m_spilled.find(doc) != m_spilled.end(); }
+
+private:
+  struct SpilledImage {
+    doc::ObjectId celData;
+    size_t offset; // Offset of the image inside the spill file
+  };
+  struct SpilledDoc {
+    std::string path;
+    std::vector<SpilledImage> images;
+  };
+
+  void hibernate(Doc* doc);
+  void rehydrate(Doc* doc);
+
+  std::map<const Doc*, base::tick_t> m_lastActivation;
+  std::map<const Doc*, SpilledDoc> m_spilled;
+};
+
+} // namespace app
+
+#endif
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -331,8 +331,7 @@ static DocRange drop_range_op(Doc* doc,
         if (srcLayers.empty() || dstLayers.empty())
           throw std::invalid_argument("You need to specify a non-empty cels range");
 
-        if (find_layer_index(allLayers, srcLayers.front()) <
-            find_layer_index(allLayers, dstLayers.front())) {
+        if (sprite->layerIndex(srcLayers.front()) < sprite->layerIndex(dstLayers.front())) {
           std::reverse(srcLayers.begin(), srcLayers.end());
           std::reverse(dstLayers.begin(), dstLayers.end());
         }
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2022-2023  Igara Studio S.A.
+// Copyright (C) 2022-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -17,6 +17,8 @@
 #include "app/console.h"
 #include "app/context.h"
 #include "app/doc_undo_observer.h"
+#include "app/job_scheduler.h"
+#include "app/memory_budget.h"
 #include "app/pref/preferences.h"
 #include "base/mem_utils.h"
 #include "base/scoped_value.h"
@@ -31,13 +33,44 @@
 
 namespace app {
 
+namespace {
+
+// Number of the most recent undo states that are kept uncompressed
+// ("hot"): the current state and the previous one, so a quick
+// undo+redo of the last action never waits for decompression.
+constexpr int kHotUndoStates = 2;
+
+} // anonymous namespace
+
 DocUndo::DocUndo() : m_undoHistory(this)
 {
 }
 
+DocUndo::~DocUndo()
+{
+  // No-op in the regular flow (setContext(nullptr) already
+  // unregistered us when the doc left its context).
+  MemoryBudget::instance()->removeDelegate(this);
+
+  // Wait until every background compression job finished before the
+  // undo states (the data being compressed) are destroyed.
+  std::unique_lock<std::mutex> lock(m_compressMutex);
+  m_compressCond.wait(lock, [this] { return m_compressing.empty(); });
+}
+
 void DocUndo::setContext(Context* ctx)
 {
   m_ctx = ctx;
+
+  // Register in the memory budget only while the document belongs to
+  // a context: closed documents are deleted by the ClosedDocs
+  // background thread, and the budget must never hold a delegate
+  // that can be destroyed outside the main thread in the middle of
+  // an eviction walk.
+  if (ctx)
+    MemoryBudget::instance()->addDelegate(this);
+  else
+    MemoryBudget::instance()->removeDelegate(this);
 }
 
 void DocUndo::add(CmdTransaction* cmd)
@@ -82,9 +115,69 @@ void DocUndo::add(CmdTransaction* cmd)
     }
   }
 
+  // Old states are compressed in the background, so they are
+  // accounted (and evicted) by their compressed size, which gives us
+  // a lot more undo depth inside the same memory limit.
+  compressColdState();
+
+  // Global budget for all caches (memory.cache_limit preference):
+  // under pressure the service shrinks re-creatable caches first and
+  // falls back to evictMemory() on the undo histories.
+  MemoryBudget::instance()->checkPressure();
+
   UNDO_TRACE("UNDO: New undo size %s\n", base::get_pretty_memory_size(m_totalUndoSize).c_str());
 }
 
+size_t DocUndo::evictMemory(size_t bytes)
+{
+  const size_t before = m_totalUndoSize;
+  while (m_undoHistory.firstState() && before - m_totalUndoSize < bytes) {
+    if (!m_undoHistory.deleteFirstState())
+      break;
+  }
+  if (before != m_totalUndoSize)
+    notify_observers(&DocUndoObserver::onTotalUndoSizeChange, this);
+  return before - m_totalUndoSize;
+}
+
+void DocUndo::compressColdState()
+{
+  const undo::UndoState* state = currentState();
+  for (int i = 0; state && i < kHotUndoStates; ++i)
+    state = state->prev();
+  if (!state)
+    return;
+
+  CmdTransaction* cmd = STATE_CMD(state);
+  {
+    std::lock_guard<std::mutex> lock(m_compressMutex);
+    // Already queued or running (e.g. non-linear histories can walk
+    // over the same state twice)
+    if (!m_compressing.insert(cmd).second)
+      return;
+  }
+
+  JobScheduler::instance()->submitJob([this, cmd] {
+    const size_t before = cmd->memSize();
+    cmd->compressData();
+    const size_t after = cmd->memSize();
+    m_totalUndoSize -= (before - after);
+
+    // Notifying under the lock guarantees that a waiter cannot
+    // destroy the condition variable between our erase() and
+    // notify_all() calls.
+    std::lock_guard<std::mutex> lock(m_compressMutex);
+    m_compressing.erase(cmd);
+    m_compressCond.notify_all();
+  });
+}
+
+void DocUndo::waitCompression(Cmd* cmd)
+{
+  std::unique_lock<std::mutex> lock(m_compressMutex);
+  m_compressCond.wait(lock, [this, cmd] { return m_compressing.count(cmd) == 0; });
+}
+
 bool DocUndo::canUndo() const
 {
   return m_undoHistory.canUndo();
@@ -224,6 +317,24 @@ std::string DocUndo::nextRedoLabel() const
     return "";
 }
 
+bool DocUndo::nextUndoRegion(gfx::Region& rgn) const
+{
+  const undo::UndoState* state = nextUndo();
+  if (state)
+    return STATE_CMD(state)->modifiedRegion(rgn);
+  else
+    return false;
+}
+
+bool DocUndo::nextRedoRegion(gfx::Region& rgn) const
+{
+  const undo::UndoState* state = nextRedo();
+  if (state)
+    return STATE_CMD(state)->modifiedRegion(rgn);
+  else
+    return false;
+}
+
 SpritePosition DocUndo::nextUndoSpritePosition() const
 {
   const undo::UndoState* state = nextUndo();
@@ -281,7 +392,12 @@ void DocUndo::moveToState(const undo::UndoState* state)
   // sprite on its "change" event.
   notify_observers(&DocUndoObserver::onCurrentUndoStateChange, this);
 
-  // Recalculate the total undo size
+  // Recalculate the total undo size (waiting for in-flight
+  // compression jobs first, so sizes don't change while we sum them)
+  {
+    std::unique_lock<std::mutex> lock(m_compressMutex);
+    m_compressCond.wait(lock, [this] { return m_compressing.empty(); });
+  }
   size_t oldSize = m_totalUndoSize;
   m_totalUndoSize = 0;
   const undo::UndoState* s = m_undoHistory.firstState();
@@ -312,6 +428,10 @@ void DocUndo::onDeleteUndoState(undo::UndoState* state)
   ASSERT(state);
   Cmd* cmd = STATE_CMD(state);
 
+  // The state data cannot be freed while a background job is
+  // compressing it.
+  waitCompression(cmd);
+
   UNDO_TRACE("UNDO: Deleting undo state <%s> of %s from %s\n",
              cmd->label().c_str(),
              base::get_pretty_memory_size(cmd->memSize()).c_str(),
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2022-2023  Igara Studio S.A.
+// Copyright (C) 2022-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -10,13 +10,19 @@
 #pragma once
 
 #include "app/doc_range.h"
+#include "app/memory_budget.h"
 #include "app/sprite_position.h"
 #include "base/disable_copying.h"
 #include "base/exception.h"
+#include "gfx/fwd.h"
 #include "obs/observable.h"
 #include "undo/undo_history.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <iosfwd>
+#include <mutex>
+#include <set>
 #include <string>
 
 namespace app {
@@ -39,9 +45,11 @@ public:
 };
 
 class DocUndo : public obs::observable<DocUndoObserver>,
-                public undo::UndoHistoryDelegate {
+                public undo::UndoHistoryDelegate,
+                public MemoryBudgetDelegate {
 public:
   DocUndo();
+  ~DocUndo();
 
   size_t totalUndoSize() const { return m_totalUndoSize; }
 
@@ -85,6 +93,12 @@ public:
   std::string nextUndoLabel() const;
   std::string nextRedoLabel() const;
 
+  // Returns true if the next transaction to undo/redo knows the
+  // exact canvas region that undoing/redoing it repaints, adding
+  // that area to "rgn" (see Cmd::modifiedRegion()).
+  bool nextUndoRegion(gfx::Region& rgn) const;
+  bool nextRedoRegion(gfx::Region& rgn) const;
+
   SpritePosition nextUndoSpritePosition() const;
   SpritePosition nextRedoSpritePosition() const;
   std::istream* nextUndoDocRange() const;
@@ -104,13 +118,36 @@ private:
   const undo::UndoState* nextUndo() const;
   const undo::UndoState* nextRedo() const;
 
+  // Schedules the background compression of the undo state that just
+  // left the "hot" window (the most recent states are kept raw so
+  // undo/redo of recent work stays instantaneous).
+  void compressColdState();
+
+  // Waits until no background compression job is running/queued for
+  // the given command.
+  void waitCompression(Cmd* cmd);
+
   // undo::UndoHistoryDelegate impl
   void onDeleteUndoState(undo::UndoState* state) override;
 
+  // MemoryBudgetDelegate impl. Undo states cannot be regenerated, so
+  // they are dropped (oldest first) only after the other caches were
+  // shrunk (cold states are already stored compressed).
+  int evictionPriority() const override { return 1; }
+  size_t memoryUsage() const override { return m_totalUndoSize; }
+  size_t evictMemory(size_t bytes) override;
+
+  // Background compression bookkeeping. Declared before
+  // m_undoHistory so it's still alive while the history (and its
+  // states) is being destroyed.
+  std::mutex m_compressMutex;
+  std::condition_variable m_compressCond;
+  std::set<Cmd*> m_compressing;
+
   undo::UndoHistory m_undoHistory;
   const undo::UndoState* m_savedState = nullptr;
   Context* m_ctx = nullptr;
-  size_t m_totalUndoSize = 0;
+  std::atomic<size_t> m_totalUndoSize = { 0 };
 
   // True when we are undoing/redoing. Used to avoid adding new undo
   // information when we are moving through the undo history.
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2025  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2017-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -17,6 +17,7 @@
 #include "app/commands/commands.h"
 #include "app/console.h"
 #include "app/ini_file.h"
+#include "app/job_scheduler.h"
 #include "app/load_matrix.h"
 #include "app/pref/preferences.h"
 #include "app/resource_finder.h"
@@ -682,8 +683,10 @@ void Extension::initScripts()
     // Reset global init()/exit() functions
     engine->evalCode("init=nil exit=nil");
 
-    // Eval the code of the script (it should define an init() and an exit() function)
-    engine->evalFile(script.fn);
+    // Eval the code of the script (it should define an init() and an
+    // exit() function). Plugins are loaded at each startup, so we use
+    // the bytecode cache to skip the Lua compiler for unchanged files.
+    engine->evalFileCached(script.fn);
 
     if (lua_getglobal(L, "exit") == LUA_TFUNCTION) {
       // Save a reference to the exit() function of this script
@@ -820,8 +823,17 @@ Extensions::Extensions()
   rf.includeUserDir("extensions");
   rf.includeDataDir("extensions");
 
-  // Load extensions from data/ directory on all possible locations
-  // (installed folder and user folder)
+  // Enumerate extensions from data/ directory on all possible
+  // locations (installed folder and user folder)
+  struct Candidate {
+    std::string dir;
+    std::string packageFn;
+    bool isBuiltinExtension;
+    json11::Json json;
+    std::string error;
+  };
+  std::vector<Candidate> candidates;
+
   while (rf.next()) {
     const auto& extensionsDir = rf.filename();
 
@@ -841,12 +853,35 @@ Extensions::Extensions()
         continue;
       }
 
-      try {
-        loadExtension(dir, fullFn, isBuiltinExtension);
-      }
-      catch (const std::exception& ex) {
-        LOG("EXT: Error loading JSON file: %s\n", ex.what());
-      }
+      candidates.push_back(Candidate{ dir, fullFn, isBuiltinExtension });
+    }
+  }
+
+  // Read and parse all package.json files in parallel (with many
+  // extensions installed this is the part of the startup that
+  // actually blocks, mostly waiting on the disk). Extension objects
+  // are then created serially, in the enumeration order, so config
+  // access and signals stay in the calling thread.
+  JobScheduler::instance()->forkJoin(int(candidates.size()), [&candidates](int i) {
+    try {
+      read_json_file(candidates[i].packageFn, candidates[i].json);
+    }
+    catch (const std::exception& ex) {
+      candidates[i].error = ex.what();
+    }
+  });
+
+  for (const auto& candidate : candidates) {
+    if (!candidate.error.empty()) {
+      LOG("EXT: Error loading JSON file: %s\n", candidate.error.c_str());
+      continue;
+    }
+
+    try {
+      loadExtension(candidate.dir, candidate.json, candidate.isBuiltinExtension);
+    }
+    catch (const std::exception& ex) {
+      LOG("EXT: Error loading extension: %s\n", ex.what());
     }
   }
 }
@@ -1112,6 +1147,13 @@ Extension* Extensions::loadExtension(const std::string& path,
 {
   json11::Json json;
   read_json_file(fullPackageFilename, json);
+  return loadExtension(path, json, isBuiltinExtension);
+}
+
+Extension* Extensions::loadExtension(const std::string& path,
+                                     const json11::Json& json,
+                                     const bool isBuiltinExtension)
+{
   const auto& name = json["name"].string_value();
   const auto& version = json["version"].string_value();
   const auto& displayName = json["displayName"].string_value();
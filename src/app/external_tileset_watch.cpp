@@ -0,0 +1,171 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/external_tileset_watch.h"
+
+#include "app/doc.h"
+#include "app/doc_access.h"
+#include "app/file/file.h"
+#include "base/fs.h"
+#include "doc/image.h"
+#include "doc/image_ref.h"
+#include "doc/primitives.h"
+#include "doc/sprite.h"
+#include "doc/tileset.h"
+#include "doc/tilesets.h"
+
+#include <memory>
+
+namespace app {
+
+ExternalTilesetWatch::~ExternalTilesetWatch()
+{
+  for (const auto& it : m_watches) {
+    for (const Watch& watch : it.second)
+      FileWatcher::instance()->unwatch(watch.watchId);
+  }
+}
+
+void ExternalTilesetWatch::addDocument(Doc* doc)
+{
+  if (!doc->sprite() || !doc->sprite()->hasTilesets())
+    return;
+
+  for (doc::Tileset* tileset : *doc->sprite()->tilesets()) {
+    if (!tileset || tileset->externalFilename().empty())
+      continue;
+
+    // External filenames are commonly relative to the document
+    // location.
+    std::string path = tileset->externalFilename();
+    if (!base::is_file(path))
+      path = base::join_path(base::get_file_path(doc->filename()), path);
+    if (!base::is_file(path))
+      continue;
+
+    Watch watch;
+    watch.tilesetId = tileset->id();
+    watch.watchId = FileWatcher::instance()->watch(
+      path,
+      [this, doc, tilesetId = watch.tilesetId](const std::string& changedPath) {
+        onFileChange(doc, tilesetId, changedPath);
+      });
+    m_watches[doc].push_back(watch);
+  }
+}
+
+void ExternalTilesetWatch::removeDocument(Doc* doc)
+{
+  auto it = m_watches.find(doc);
+  if (it == m_watches.end())
+    return;
+
+  for (const Watch& watch : it->second)
+    FileWatcher::instance()->unwatch(watch.watchId);
+  m_watches.erase(it);
+}
+
+void ExternalTilesetWatch::onFileChange(Doc* doc,
+                                        const doc::ObjectId tilesetId,
+                                        const std::string& path)
+{
+  // The document could have been closed between the change detection
+  // and this callback (FileWatcher callbacks can arrive right after
+  // unwatch()).
+  auto it = m_watches.find(doc);
+  if (it == m_watches.end())
+    return;
+
+  doc::Tileset* tileset = nullptr;
+  if (doc->sprite() && doc->sprite()->hasTilesets()) {
+    for (doc::Tileset* ts : *doc->sprite()->tilesets()) {
+      if (ts && ts->id() == tilesetId) {
+        tileset = ts;
+        break;
+      }
+    }
+  }
+  if (!tileset)
+    return;
+
+  try {
+    DocWriter writer(doc, 500);
+    reloadTileset(doc, tileset, path);
+  }
+  catch (const CannotWriteDocException&) {
+    // The document is busy (e.g. a tool stroke in progress), skip
+    // this change; the next save of the external file will retry.
+  }
+  catch (const std::exception&) {
+    // A truncated/corrupted file mid-save; the watcher coalesces
+    // writes, but a final broken file just doesn't reload.
+  }
+}
+
+void ExternalTilesetWatch::reloadTileset(Doc* doc, doc::Tileset* tileset, const std::string& path)
+{
+  // Tilesets are global to the sprite, so decoding one frame is
+  // enough (same nested load used by the thumbnail generator).
+  std::unique_ptr<FileOp> fop(
+    FileOp::createLoadDocumentOperation(nullptr,
+                                        path,
+                                        FILE_LOAD_SEQUENCE_NONE | FILE_LOAD_ONE_FRAME));
+  if (!fop)
+    return;
+
+  fop->operate();
+  fop->done();
+  if (fop->hasError())
+    return;
+
+  std::unique_ptr<Doc> srcDoc(fop->releaseDocument());
+  if (!srcDoc || !srcDoc->sprite() || !srcDoc->sprite()->hasTilesets())
+    return;
+
+  const doc::Sprite* srcSprite = srcDoc->sprite();
+  const doc::tileset_index tsi = tileset->externalTileset();
+  doc::Tileset* srcTileset = srcSprite->tilesets()->get(tsi);
+  if (!srcTileset ||
+      // We cannot reinterpret tiles of other dimensions/color modes.
+      srcTileset->grid().tileSize() != tileset->grid().tileSize() ||
+      srcSprite->pixelFormat() != doc->sprite()->pixelFormat()) {
+    return;
+  }
+
+  if (tileset->size() != srcTileset->size())
+    tileset->resize(srcTileset->size());
+
+  // Replace/re-hash only the tiles whose pixels actually changed;
+  // unchanged tiles keep their images and hash entries.
+  bool changed = false;
+  for (doc::tile_index ti = 1; ti < tileset->size(); ++ti) {
+    doc::ImageRef srcImage = srcTileset->get(ti);
+    doc::ImageRef dstImage = tileset->get(ti);
+    if (!srcImage || (dstImage && doc::is_same_image(srcImage.get(), dstImage.get())))
+      continue;
+
+    if (dstImage && dstImage->spec() == srcImage->spec()) {
+      doc::copy_image(dstImage.get(), srcImage.get());
+      dstImage->incrementVersion();
+      tileset->notifyTileContentChange(ti);
+    }
+    else {
+      tileset->set(ti, doc::ImageRef(doc::Image::createCopy(srcImage.get())));
+    }
+    changed = true;
+  }
+
+  if (changed) {
+    tileset->incrementVersion();
+    doc->notifyTilesetChanged(tileset);
+  }
+}
+
+} // namespace app
@@ -0,0 +1,55 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_EXTERNAL_TILESET_WATCH_INCLUDED
+#define APP_EXTERNAL_TILESET_WATCH_INCLUDED
+#pragma once
+
+#include "app/file_watcher.h"
+#include "doc/object_id.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace doc {
+class Tileset;
+}
+
+namespace app {
+class Doc;
+
+// Watches the external files referenced by the tilesets of open
+// documents (doc::Tileset::externalFilename()) and reloads just the
+// affected tileset when one of them changes on disk: only the tiles
+// whose pixels actually differ are replaced/re-hashed, and a single
+// tileset-changed notification invalidates the views, so editing a
+// shared tileset in another program doesn't require reloading the
+// whole document.
+class ExternalTilesetWatch {
+public:
+  ~ExternalTilesetWatch();
+
+  // Starts/stops watching the external tileset files of the given
+  // document.
+  void addDocument(Doc* doc);
+  void removeDocument(Doc* doc);
+
+private:
+  struct Watch {
+    FileWatcher::WatchId watchId;
+    doc::ObjectId tilesetId;
+  };
+
+  void onFileChange(Doc* doc, const doc::ObjectId tilesetId, const std::string& path);
+  void reloadTileset(Doc* doc, doc::Tileset* tileset, const std::string& path);
+
+  std::map<const Doc*, std::vector<Watch>> m_watches;
+};
+
+} // namespace app
+
+#endif
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -15,8 +15,11 @@
 #include "app/file/file.h"
 #include "app/file/file_format.h"
 #include "app/file/format_options.h"
+#include "app/util/tuning.h"
+#include "base/buffer.h"
 #include "base/cfile.h"
 #include "base/exception.h"
+#include "base/thread_pool.h"
 #include "base/file_handle.h"
 #include "base/fs.h"
 #include "base/mem_utils.h"
@@ -25,6 +28,7 @@
 #include "dio/aseprite_decoder.h"
 #include "dio/decode_delegate.h"
 #include "dio/file_interface.h"
+#include "dio/mapped_file_interface.h"
 #include "doc/doc.h"
 #include "fixmath/fixmath.h"
 #include "fmt/format.h"
@@ -32,9 +36,13 @@
 #include "ver/info.h"
 #include "zlib.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <deque>
+#include <map>
+#include <memory>
 #include <variant>
+#include <vector>
 
 #define ASEFILE_TRACE(...) // TRACE(__VA_ARGS__)
 
@@ -62,6 +70,17 @@ public:
 
   bool decodeOneFrame() override { return m_fop->isOneFrame(); }
 
+  doc::frame_t frameToDecode() override { return m_fop->frameToLoad(); }
+
+  void onFrameDecoded(doc::Sprite* sprite, doc::frame_t frame) override
+  {
+    // As soon as the first frame is complete, publish a downsampled
+    // composite so the UI can show it while the remaining frames are
+    // still being decoded.
+    if (frame == 0 && !m_fop->isOneFrame())
+      m_fop->makeLoadingPreviewImage(sprite, frame);
+  }
+
   doc::color_t defaultSliceColor() override
   {
     auto color = m_fop->config().defaultSliceColor;
@@ -74,6 +93,8 @@ public:
 
   bool cacheCompressedTilesets() const override { return m_fop->config().cacheCompressedTilesets; }
 
+  bool cacheCompressedCels() const override { return m_fop->config().cacheCompressedCels; }
+
 private:
   FileOp* m_fop;
   doc::Sprite* m_sprite;
@@ -140,6 +161,14 @@ static void ase_file_write_header_filesize(FILE* f, dio::AsepriteHeader* header)
 static void ase_file_prepare_frame_header(FILE* f, dio::AsepriteFrameHeader* frame_header);
 static void ase_file_write_frame_header(FILE* f, dio::AsepriteFrameHeader* frame_header);
 
+static void ase_file_write_frame_index_chunk(FILE* f,
+                                             dio::AsepriteFrameHeader* frame_header,
+                                             const int nframes,
+                                             long& offsets_pos);
+static void ase_file_patch_frame_index_chunk(FILE* f,
+                                             const long offsets_pos,
+                                             const std::vector<long>& frame_offsets);
+
 static void ase_file_write_layers(FILE* f,
                                   FileOp* fop,
                                   const dio::AsepriteHeader* header,
@@ -147,6 +176,19 @@ static void ase_file_write_layers(FILE* f,
                                   const dio::AsepriteExternalFiles& ext_files,
                                   const Layer* layer,
                                   int child_level);
+// Deflated pixel data of cel images, precompressed in parallel before
+// the frame loop (cel chunks are still written strictly in order,
+// just copying these buffers, so the on-disk format is unchanged).
+struct PrecompressedCel {
+  base::buffer data;
+  bool ok = false;
+};
+using PrecompressedCels = std::map<doc::ObjectId, PrecompressedCel>;
+
+static void ase_file_precompress_cels(FileOp* fop,
+                                      const Sprite* sprite,
+                                      PrecompressedCels& precompressedCels);
+
 static layer_t ase_file_write_cels(FILE* f,
                                    FileOp* fop,
                                    dio::AsepriteFrameHeader* frame_header,
@@ -154,7 +196,8 @@ static layer_t ase_file_write_cels(FILE* f,
                                    const Sprite* sprite,
                                    const Layer* layer,
                                    layer_t layer_index,
-                                   const frame_t frame);
+                                   const frame_t frame,
+                                   const PrecompressedCels& precompressedCels);
 
 static void ase_file_write_padding(FILE* f, int bytes);
 static void ase_file_write_string(FILE* f, const std::string& string);
@@ -185,7 +228,8 @@ static void ase_file_write_cel_chunk(FILE* f,
                                      const LayerImage* layer,
                                      const layer_t layer_index,
                                      const Sprite* sprite,
-                                     const frame_t firstFrame);
+                                     const frame_t firstFrame,
+                                     const PrecompressedCels& precompressedCels);
 static void ase_file_write_cel_extra_chunk(FILE* f,
                                            dio::AsepriteFrameHeader* frame_header,
                                            const Cel* cel);
@@ -299,12 +343,23 @@ FileFormat* CreateAseFormat()
 
 bool AseFormat::onLoad(FileOp* fop)
 {
-  FileHandle handle(open_file_with_exception(fop->filename(), "rb"));
-  dio::StdioFileInterface fileInterface(handle.get());
+  // Prefer a memory-mapped view of the file: chunk headers are
+  // decoded straight from the mapping and the OS pages cel data in on
+  // demand, instead of streaming everything through stdio.
+  dio::MappedFileInterface mappedInterface(fop->filename());
+
+  FileHandle handle;
+  std::unique_ptr<dio::StdioFileInterface> stdioInterface;
+  dio::FileInterface* fileInterface = &mappedInterface;
+  if (!mappedInterface.ok()) {
+    handle = open_file_with_exception(fop->filename(), "rb");
+    stdioInterface = std::make_unique<dio::StdioFileInterface>(handle.get());
+    fileInterface = stdioInterface.get();
+  }
 
   DecodeDelegate delegate(fop);
   dio::AsepriteDecoder decoder;
-  decoder.initialize(&delegate, &fileInterface);
+  decoder.initialize(&delegate, fileInterface);
   if (!decoder.decode())
     return false;
 
@@ -394,10 +449,20 @@ bool AseFormat::onSave(FileOp* fop)
     }
   }
 
+  // Deflate all unique cel images concurrently before the (ordered)
+  // frame loop below
+  PrecompressedCels precompressedCels;
+  ase_file_precompress_cels(fop, sprite, precompressedCels);
+
   // Write frames
   int outputFrame = 0;
+  std::vector<long> frameOffsets;
+  long frameIndexOffsetsPos = 0;
   dio::AsepriteExternalFiles ext_files;
   for (frame_t frame : fop->roi().framesSequence()) {
+    // File offset of this frame for the frame index chunk
+    frameOffsets.push_back(ftell(f));
+
     // Prepare the frame header
     dio::AsepriteFrameHeader frame_header;
     ase_file_prepare_frame_header(f, &frame_header);
@@ -412,6 +477,17 @@ bool AseFormat::onSave(FileOp* fop)
       // Save color profile in first frame
       if (fop->preserveColorProfile())
         ase_file_write_color_profile(f, &frame_header, sprite);
+
+      // Reserve the frame index chunk, its offsets table is patched
+      // after all frames are written. Opt-in because older versions
+      // of the program report unknown chunks as an incompatibility
+      // and open the file as read-only.
+      if (fop->config().writeFrameIndexChunk && fop->roi().frames() > 1) {
+        ase_file_write_frame_index_chunk(f,
+                                         &frame_header,
+                                         fop->roi().frames(),
+                                         frameIndexOffsetsPos);
+      }
     }
 
     // is the first frame or did the palette change?
@@ -473,7 +549,15 @@ bool AseFormat::onSave(FileOp* fop)
     }
 
     // Write cel chunks
-    ase_file_write_cels(f, fop, &frame_header, ext_files, sprite, sprite->root(), 0, frame);
+    ase_file_write_cels(f,
+                        fop,
+                        &frame_header,
+                        ext_files,
+                        sprite,
+                        sprite->root(),
+                        0,
+                        frame,
+                        precompressedCels);
 
     // Write the frame header
     ase_file_write_frame_header(f, &frame_header);
@@ -487,6 +571,10 @@ bool AseFormat::onSave(FileOp* fop)
       break;
   }
 
+  // Write the missing offsets table of the frame index chunk.
+  if (frameIndexOffsetsPos > 0)
+    ase_file_patch_frame_index_chunk(f, frameIndexOffsetsPos, frameOffsets);
+
   // Write the missing field (filesize) of the header.
   ase_file_write_header_filesize(f, &header);
 
@@ -631,6 +719,35 @@ static void ase_file_write_frame_header(FILE* f, dio::AsepriteFrameHeader* frame
   fseek(f, end, SEEK_SET);
 }
 
+// Writes the frame index chunk with a zeroed offsets table (the frame
+// offsets are known only after writing all the frames, so the table
+// is patched at the end with ase_file_patch_frame_index_chunk()).
+static void ase_file_write_frame_index_chunk(FILE* f,
+                                             dio::AsepriteFrameHeader* frame_header,
+                                             const int nframes,
+                                             long& offsets_pos)
+{
+  ChunkWriter chunk(f, frame_header, ASE_FILE_CHUNK_FRAME_INDEX);
+
+  fputl(nframes, f);
+  offsets_pos = ftell(f);
+  for (int i = 0; i < nframes; ++i)
+    fputl(0, f);
+}
+
+static void ase_file_patch_frame_index_chunk(FILE* f,
+                                             const long offsets_pos,
+                                             const std::vector<long>& frame_offsets)
+{
+  long end = ftell(f);
+
+  fseek(f, offsets_pos, SEEK_SET);
+  for (long offset : frame_offsets)
+    fputl(offset, f);
+
+  fseek(f, end, SEEK_SET);
+}
+
 static void ase_file_write_layers(FILE* f,
                                   FileOp* fop,
                                   const dio::AsepriteHeader* header,
@@ -656,7 +773,8 @@ static layer_t ase_file_write_cels(FILE* f,
                                    const Sprite* sprite,
                                    const Layer* layer,
                                    layer_t layer_index,
-                                   const frame_t frame)
+                                   const frame_t frame,
+                                   const PrecompressedCels& precompressedCels)
 {
   if (layer->isImage()) {
     const Cel* cel = layer->cel(frame);
@@ -668,7 +786,8 @@ static layer_t ase_file_write_cels(FILE* f,
                                static_cast<const LayerImage*>(layer),
                                layer_index,
                                sprite,
-                               fop->roi().fromFrame());
+                               fop->roi().fromFrame(),
+                               precompressedCels);
 
       if (layer->isReference())
         ase_file_write_cel_extra_chunk(f, frame_header, cel);
@@ -684,8 +803,15 @@ static layer_t ase_file_write_cels(FILE* f,
 
   if (layer->isGroup()) {
     for (const Layer* child : static_cast<const LayerGroup*>(layer)->layers()) {
-      layer_index =
-        ase_file_write_cels(f, fop, frame_header, ext_files, sprite, child, layer_index, frame);
+      layer_index = ase_file_write_cels(f,
+                                        fop,
+                                        frame_header,
+                                        ext_files,
+                                        sprite,
+                                        child,
+                                        layer_index,
+                                        frame,
+                                        precompressedCels);
     }
   }
 
@@ -960,8 +1086,18 @@ static void write_raw_image(FILE* f, ScanlinesGen* gen, PixelFormat pixelFormat)
 // Compressed Image
 //////////////////////////////////////////////////////////////////////
 
+// Deflate level used for cels/tilesets (-1 keeps the zlib default,
+// see FileOpConfig::asepriteCompressionLevel).
+static int compression_level(const FileOp* fop)
+{
+  return std::clamp(fop->config().asepriteCompressionLevel, -1, 9);
+}
+
 template<typename ImageTraits>
-static void write_compressed_image_templ(FILE* f, ScanlinesGen* gen, base::buffer* compressedOutput)
+static void write_compressed_image_templ(FILE* f,
+                                         ScanlinesGen* gen,
+                                         base::buffer* compressedOutput,
+                                         const int compressionLevel)
 {
   PixelIO<ImageTraits> pixel_io;
   z_stream zstream;
@@ -970,7 +1106,7 @@ static void write_compressed_image_templ(FILE* f, ScanlinesGen* gen, base::buffe
   zstream.zalloc = (alloc_func)0;
   zstream.zfree = (free_func)0;
   zstream.opaque = (voidpf)0;
-  err = deflateInit(&zstream, Z_DEFAULT_COMPRESSION);
+  err = deflateInit(&zstream, compressionLevel);
   if (err != Z_OK)
     throw base::Exception("ZLib error %d in deflateInit().", err);
 
@@ -999,7 +1135,9 @@ static void write_compressed_image_templ(FILE* f, ScanlinesGen* gen, base::buffe
 
       int output_bytes = compressed.size() - zstream.avail_out;
       if (output_bytes > 0) {
-        if ((fwrite(&compressed[0], 1, output_bytes, f) != (size_t)output_bytes) || ferror(f))
+        // "f" can be null when we just want the compressed buffer
+        // (e.g. precompressing cels in a worker thread)
+        if (f && ((fwrite(&compressed[0], 1, output_bytes, f) != (size_t)output_bytes) || ferror(f)))
           throw base::Exception("Error writing compressed image pixels.\n");
 
         // Save the whole compressed buffer to re-use in following
@@ -1024,25 +1162,110 @@ static void write_compressed_image_templ(FILE* f, ScanlinesGen* gen, base::buffe
 static void write_compressed_image(FILE* f,
                                    ScanlinesGen* gen,
                                    PixelFormat pixelFormat,
-                                   base::buffer* compressedOutput = nullptr)
+                                   base::buffer* compressedOutput = nullptr,
+                                   const int compressionLevel = Z_DEFAULT_COMPRESSION)
 {
   switch (pixelFormat) {
-    case IMAGE_RGB: write_compressed_image_templ<RgbTraits>(f, gen, compressedOutput); break;
+    case IMAGE_RGB:
+      write_compressed_image_templ<RgbTraits>(f, gen, compressedOutput, compressionLevel);
+      break;
 
     case IMAGE_GRAYSCALE:
-      write_compressed_image_templ<GrayscaleTraits>(f, gen, compressedOutput);
+      write_compressed_image_templ<GrayscaleTraits>(f, gen, compressedOutput, compressionLevel);
       break;
 
     case IMAGE_INDEXED:
-      write_compressed_image_templ<IndexedTraits>(f, gen, compressedOutput);
+      write_compressed_image_templ<IndexedTraits>(f, gen, compressedOutput, compressionLevel);
       break;
 
     case IMAGE_TILEMAP:
-      write_compressed_image_templ<TilemapTraits>(f, gen, compressedOutput);
+      write_compressed_image_templ<TilemapTraits>(f, gen, compressedOutput, compressionLevel);
       break;
   }
 }
 
+// Deflates every unique cel image of the ROI concurrently on a worker
+// pool. Chunks are written later in their regular order, copying the
+// resulting buffers, so the on-disk format does not change. A failed
+// task just leaves its entry unusable and that cel is compressed
+// inline as before.
+static void ase_file_precompress_cels(FileOp* fop,
+                                      const Sprite* sprite,
+                                      PrecompressedCels& precompressedCels)
+{
+  const auto aseOptions = std::static_pointer_cast<AseFormat::AsepriteOptions>(
+    fop->formatOptions());
+  const bool rawCels = (aseOptions && aseOptions->celType == ASE_FILE_RAW_CEL);
+
+  for (const Layer* layer : sprite->allLayers()) {
+    if (!layer->isImage())
+      continue;
+    // Raw cel option applies to regular cels; tilemaps are always
+    // compressed.
+    if (rawCels && !layer->isTilemap())
+      continue;
+
+    for (frame_t frame : fop->roi().framesSequence()) {
+      const Cel* cel = layer->cel(frame);
+      if (!cel || cel->link() || !cel->image())
+        continue;
+      PrecompressedCel& entry = precompressedCels[cel->image()->id()];
+
+      // Re-use the deflated bytes read from the original .aseprite
+      // file if the image wasn't modified since it was loaded (same
+      // as Tileset::compressedData() for unmodified tilesets).
+      if (!entry.ok && !cel->compressedData().empty() &&
+          cel->compressedDataImageId() == cel->image()->id() &&
+          cel->compressedDataVersion() == cel->image()->version()) {
+        entry.data = cel->compressedData();
+        entry.ok = true;
+      }
+    }
+  }
+
+  if (precompressedCels.empty())
+    return;
+
+  static base::thread_pool pool(tuned_worker_count());
+  const int level = compression_level(fop);
+  for (auto& it : precompressedCels) {
+    if (it.second.ok)
+      continue; // Verbatim copy of the original file bytes
+    const Image* image = doc::get<Image>(it.first);
+    PrecompressedCel* entry = &it.second;
+    pool.execute([image, entry, level] {
+      try {
+        ImageScanlines scan(image);
+        write_compressed_image(nullptr, &scan, image->pixelFormat(), &entry->data, level);
+        entry->ok = true;
+      }
+      catch (const std::exception&) {
+        // Leave entry->ok == false: this cel will be deflated inline
+      }
+    });
+  }
+  pool.wait_all();
+
+  // Refresh the per-cel cache with the freshly deflated data, so the
+  // next save of each still-unmodified cel is a verbatim copy too
+  // (like tilesets do with Tileset::setCompressedData() after being
+  // written).
+  if (!fop->config().cacheCompressedCels)
+    return;
+  for (const Layer* layer : sprite->allLayers()) {
+    if (!layer->isImage() || (rawCels && !layer->isTilemap()))
+      continue;
+    for (frame_t frame : fop->roi().framesSequence()) {
+      const Cel* cel = layer->cel(frame);
+      if (!cel || cel->link() || !cel->image())
+        continue;
+      const auto it = precompressedCels.find(cel->image()->id());
+      if (it != precompressedCels.end() && it->second.ok)
+        cel->setCompressedData(it->second.data);
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////
 // Cel Chunk
 //////////////////////////////////////////////////////////////////////
@@ -1054,11 +1277,21 @@ static void ase_file_write_cel_chunk(FILE* f,
                                      const LayerImage* layer,
                                      const layer_t layer_index,
                                      const Sprite* sprite,
-                                     const frame_t firstFrame)
+                                     const frame_t firstFrame,
+                                     const PrecompressedCels& precompressedCels)
 {
   const auto aseOptions = std::static_pointer_cast<AseFormat::AsepriteOptions>(
     fop->formatOptions());
 
+  // Returns the deflated pixel data if this image was precompressed
+  // by ase_file_precompress_cels()
+  auto precompressed = [&precompressedCels](const Image* image) -> const base::buffer* {
+    auto it = precompressedCels.find(image->id());
+    if (it != precompressedCels.end() && it->second.ok)
+      return &it->second.data;
+    return nullptr;
+  };
+
   ChunkWriter chunk(f, frame_header, ASE_FILE_CHUNK_CEL);
 
   const Cel* link = cel->link();
@@ -1123,8 +1356,15 @@ static void ase_file_write_cel_chunk(FILE* f,
         fputw(image->width(), f);
         fputw(image->height(), f);
 
-        ImageScanlines scan(image);
-        write_compressed_image(f, &scan, image->pixelFormat());
+        if (const base::buffer* data = precompressed(image)) {
+          if (!data->empty() &&
+              (fwrite(data->data(), 1, data->size(), f) != data->size() || ferror(f)))
+            throw base::Exception("Error writing compressed image pixels.\n");
+        }
+        else {
+          ImageScanlines scan(image);
+          write_compressed_image(f, &scan, image->pixelFormat(), nullptr, compression_level(fop));
+        }
       }
       else {
         // Width and height
@@ -1148,8 +1388,15 @@ static void ase_file_write_cel_chunk(FILE* f,
       fputl(tile_f_dflip, f);
       ase_file_write_padding(f, 10);
 
-      ImageScanlines scan(image);
-      write_compressed_image(f, &scan, IMAGE_TILEMAP);
+      if (const base::buffer* data = precompressed(image)) {
+        if (!data->empty() &&
+            (fwrite(data->data(), 1, data->size(), f) != data->size() || ferror(f)))
+          throw base::Exception("Error writing compressed image pixels.\n");
+      }
+      else {
+        ImageScanlines scan(image);
+        write_compressed_image(f, &scan, IMAGE_TILEMAP, nullptr, compression_level(fop));
+      }
     }
   }
 }
@@ -1592,7 +1839,11 @@ static void ase_file_write_tileset_chunk(FILE* f,
       if (fop->config().cacheCompressedTilesets)
         compressedDataPtr = &compressedData;
 
-      write_compressed_image(f, &gen, tileset->sprite()->pixelFormat(), compressedDataPtr);
+      write_compressed_image(f,
+                             &gen,
+                             tileset->sprite()->pixelFormat(),
+                             compressedDataPtr,
+                             compression_level(fop));
 
       // As we've just compressed the tileset, we can cache this same
       // data (so saving the file again will not need recompressing).
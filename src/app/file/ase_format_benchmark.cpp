@@ -0,0 +1,92 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/context.h"
+#include "app/doc.h"
+#include "app/file/file.h"
+#include "base/fs.h"
+#include "doc/algorithm/random_image.h"
+#include "doc/cel.h"
+#include "doc/image.h"
+#include "doc/layer.h"
+#include "doc/sprite.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+using namespace app;
+
+namespace {
+
+const char* kBenchFn = "bench.ase";
+
+// Random pixels barely compress, so these numbers are dominated by
+// the zlib deflate/inflate of the cel data (the worst case of a
+// hand-drawn sprite).
+std::unique_ptr<Doc> make_random_doc(Context* ctx, const int w, const int h, doc::ColorMode mode)
+{
+  std::unique_ptr<Doc> doc(ctx->documents().add(w, h, mode, 256));
+  doc->setFilename(kBenchFn);
+  doc::algorithm::random_image(doc->sprite()->root()->firstLayer()->cel(0)->image());
+  return doc;
+}
+
+} // anonymous namespace
+
+void BM_SaveAse(benchmark::State& state)
+{
+  const int w = state.range(0);
+  const int h = state.range(1);
+  const auto mode = doc::ColorMode(state.range(2));
+  Context ctx;
+  std::unique_ptr<Doc> doc = make_random_doc(&ctx, w, h, mode);
+  for (auto _ : state) {
+    save_document(&ctx, doc.get());
+  }
+  state.SetBytesProcessed(state.iterations() * int64_t(w) * h * doc->sprite()->spec().bytesPerPixel());
+  doc->close();
+  base::delete_file(kBenchFn);
+}
+
+void BM_LoadAse(benchmark::State& state)
+{
+  const int w = state.range(0);
+  const int h = state.range(1);
+  const auto mode = doc::ColorMode(state.range(2));
+  Context ctx;
+  {
+    std::unique_ptr<Doc> doc = make_random_doc(&ctx, w, h, mode);
+    save_document(&ctx, doc.get());
+    doc->close();
+  }
+  int64_t bytesPerPixel = 0;
+  for (auto _ : state) {
+    std::unique_ptr<Doc> doc(load_document(&ctx, kBenchFn));
+    bytesPerPixel = doc->sprite()->spec().bytesPerPixel();
+    doc->close();
+  }
+  state.SetBytesProcessed(state.iterations() * int64_t(w) * h * bytesPerPixel);
+  base::delete_file(kBenchFn);
+}
+
+#define ASE_ARGS()                                                                                 \
+  ->Args({ 256, 256, int(doc::ColorMode::RGB) })                                                   \
+    ->Args({ 1024, 1024, int(doc::ColorMode::RGB) })                                               \
+    ->Args({ 1024, 1024, int(doc::ColorMode::INDEXED) })                                           \
+    ->Args({ 4096, 4096, int(doc::ColorMode::RGB) })
+
+BENCHMARK(BM_SaveAse)
+ASE_ARGS()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_LoadAse)
+ASE_ARGS()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
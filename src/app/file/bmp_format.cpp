@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2023  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -24,6 +24,9 @@
 #include "doc/doc.h"
 #include "fmt/format.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace app {
 
 // Max supported .bmp size (to filter out invalid image sizes)
@@ -486,122 +489,73 @@ static void read_bmicolors(FileOp* fop, int bytes, FILE* f, bool win_flag)
     fgetc(f);
 }
 
+/* bmp_rowsize:
+ *  On-disk size of one row of uncompressed bitmap data (each row is
+ *  aligned to a DWORD boundary).
+ */
+static int bmp_rowsize(int length, int bitCount)
+{
+  return ((length * bitCount + 31) / 32) * 4;
+}
+
+/* read_row:
+ *  Reads one on-disk row into the given buffer, completing it with
+ *  zeros if the file is truncated.
+ */
+static void read_row(FILE* f, std::vector<uint8_t>& row)
+{
+  const size_t bytes = fread(&row[0], 1, row.size(), f);
+  if (bytes < row.size())
+    std::fill(row.begin() + bytes, row.end(), uint8_t(0));
+}
+
 /* read_1bit_line:
  *  Support function for reading the 1 bit bitmap file format.
  */
-static void read_1bit_line(int length, FILE* f, Image* image, int line)
+static void read_1bit_line(int length, const uint8_t* buf, Image* image, int line)
 {
-  unsigned char b[32];
-  unsigned long n;
-  int i, j, k;
-  int pix;
-
-  for (i = 0; i < length; i++) {
-    j = i % 32;
-    if (j == 0) {
-      n = fgetl(f);
-      n = ((n & 0x000000ff) << 24) | ((n & 0x0000ff00) << 8) | ((n & 0x00ff0000) >> 8) |
-          ((n & 0xff000000) >> 24);
-      for (k = 0; k < 32; k++) {
-        b[31 - k] = (char)(n & 1);
-        n = n >> 1;
-      }
-    }
-    pix = b[j];
-    put_pixel(image, i, line, pix);
+  for (int i = 0; i < length; i++) {
+    const int pix = (buf[i >> 3] >> (7 - (i & 7))) & 1;
+    put_pixel_fast<IndexedTraits>(image, i, line, pix);
   }
 }
 
 /* read_2bit_line (not standard):
  *  Support function for reading the 2 bit bitmap file format.
  */
-static void read_2bit_line(int length, FILE* f, Image* image, int line)
+static void read_2bit_line(int length, const uint8_t* buf, Image* image, int line)
 {
-  unsigned char b[16];
-  unsigned long n;
-  int i, j, k;
-  int temp;
-  int pix;
-
-  for (i = 0; i < length; i++) {
-    j = i % 16;
-    if (j == 0) {
-      n = fgetl(f);
-      for (k = 0; k < 4; k++) {
-        temp = n & 255;
-        b[k * 4 + 3] = temp & 3;
-        temp = temp >> 2;
-        b[k * 4 + 2] = temp & 3;
-        temp = temp >> 2;
-        b[k * 4 + 1] = temp & 3;
-        temp = temp >> 2;
-        b[k * 4] = temp & 3;
-        n = n >> 8;
-      }
-    }
-    pix = b[j];
-    put_pixel(image, i, line, pix);
+  for (int i = 0; i < length; i++) {
+    const int pix = (buf[i >> 2] >> (6 - 2 * (i & 3))) & 3;
+    put_pixel_fast<IndexedTraits>(image, i, line, pix);
   }
 }
 
 /* read_4bit_line:
  *  Support function for reading the 4 bit bitmap file format.
  */
-static void read_4bit_line(int length, FILE* f, Image* image, int line)
+static void read_4bit_line(int length, const uint8_t* buf, Image* image, int line)
 {
-  unsigned char b[8];
-  unsigned long n;
-  int i, j, k;
-  int temp;
-  int pix;
-
-  for (i = 0; i < length; i++) {
-    j = i % 8;
-    if (j == 0) {
-      n = fgetl(f);
-      for (k = 0; k < 4; k++) {
-        temp = n & 255;
-        b[k * 2 + 1] = temp & 15;
-        temp = temp >> 4;
-        b[k * 2] = temp & 15;
-        n = n >> 8;
-      }
-    }
-    pix = b[j];
-    put_pixel(image, i, line, pix);
+  for (int i = 0; i < length; i++) {
+    const int pix = (buf[i >> 1] >> (4 - 4 * (i & 1))) & 15;
+    put_pixel_fast<IndexedTraits>(image, i, line, pix);
   }
 }
 
 /* read_8bit_line:
  *  Support function for reading the 8 bit bitmap file format.
  */
-static void read_8bit_line(int length, FILE* f, Image* image, int line)
+static void read_8bit_line(int length, const uint8_t* buf, Image* image, int line)
 {
-  unsigned char b[4];
-  unsigned long n;
-  int i, j, k;
-  int pix;
-
-  for (i = 0; i < length; i++) {
-    j = i % 4;
-    if (j == 0) {
-      n = fgetl(f);
-      for (k = 0; k < 4; k++) {
-        b[k] = (char)(n & 255);
-        n = n >> 8;
-      }
-    }
-    pix = b[j];
-    put_pixel(image, i, line, pix);
-  }
+  std::copy(buf, buf + length, image->getPixelAddress(0, line));
 }
 
-static void read_16bit_line(int length, FILE* f, Image* image, int line, bool& withAlpha)
+static void read_16bit_line(int length, const uint8_t* buf, Image* image, int line, bool& withAlpha)
 {
   int i, r, g, b, a, word;
 
   for (i = 0; i < length; i++) {
-    word = fgetw(f);
+    word = buf[2 * i] | (buf[2 * i + 1] << 8);
 
     r = (word >> 10) & 0x1f;
     g = (word >> 5) & 0x1f;
@@ -609,47 +563,38 @@ static void read_16bit_line(int length, FILE* f, Image* image, int line, bool& w
     a = (word & 0x8000 ? 255 : 0);
     if (a)
       withAlpha = true;
-    put_pixel(image,
-              i,
-              line,
-              rgba(scale_5bits_to_8bits(r), scale_5bits_to_8bits(g), scale_5bits_to_8bits(b), a));
+    put_pixel_fast<RgbTraits>(
+      image,
+      i,
+      line,
+      rgba(scale_5bits_to_8bits(r), scale_5bits_to_8bits(g), scale_5bits_to_8bits(b), a));
   }
-
-  i = (2 * i) % 4;
-  if (i > 0)
-    while (i++ < 4)
-      fgetc(f);
 }
 
-static void read_24bit_line(int length, FILE* f, Image* image, int line)
+static void read_24bit_line(int length, const uint8_t* buf, Image* image, int line)
 {
   int i, r, g, b;
 
   for (i = 0; i < length; i++) {
-    b = fgetc(f);
-    g = fgetc(f);
-    r = fgetc(f);
-    put_pixel(image, i, line, rgba(r, g, b, 255));
+    b = buf[3 * i];
+    g = buf[3 * i + 1];
+    r = buf[3 * i + 2];
+    put_pixel_fast<RgbTraits>(image, i, line, rgba(r, g, b, 255));
   }
-
-  i = (3 * i) % 4;
-  if (i > 0)
-    while (i++ < 4)
-      fgetc(f);
 }
 
-static void read_32bit_line(int length, FILE* f, Image* image, int line, bool& withAlpha)
+static void read_32bit_line(int length, const uint8_t* buf, Image* image, int line, bool& withAlpha)
 {
   int i, r, g, b, a;
 
   for (i = 0; i < length; i++) {
-    b = fgetc(f);
-    g = fgetc(f);
-    r = fgetc(f);
-    a = fgetc(f);
+    b = buf[4 * i];
+    g = buf[4 * i + 1];
+    r = buf[4 * i + 2];
+    a = buf[4 * i + 3];
     if (a)
       withAlpha = true;
-    put_pixel(image, i, line, rgba(r, g, b, a));
+    put_pixel_fast<RgbTraits>(image, i, line, rgba(r, g, b, a));
   }
 }
 
@@ -669,20 +614,30 @@ static void read_image(FILE* f,
   dir = height < 0 ? 1 : -1;
   height = ABS(height);
 
+  // One buffered fread() per row, pixels are converted from memory
+  // (per-pixel fgetc()/fgetw() calls are too slow for big images).
+  std::vector<uint8_t> row(bmp_rowsize(infoheader->biWidth, infoheader->biBitCount));
+
   for (i = 0; i < height; i++, line += dir) {
+    read_row(f, row);
+
     switch (infoheader->biBitCount) {
-      case 1:  read_1bit_line(infoheader->biWidth, f, image, line); break;
-      case 2:  read_2bit_line(infoheader->biWidth, f, image, line); break;
-      case 4:  read_4bit_line(infoheader->biWidth, f, image, line); break;
-      case 8:  read_8bit_line(infoheader->biWidth, f, image, line); break;
-      case 16: read_16bit_line(infoheader->biWidth, f, image, line, withAlpha); break;
-      case 24: read_24bit_line(infoheader->biWidth, f, image, line); break;
-      case 32: read_32bit_line(infoheader->biWidth, f, image, line, withAlpha); break;
+      case 1:  read_1bit_line(infoheader->biWidth, &row[0], image, line); break;
+      case 2:  read_2bit_line(infoheader->biWidth, &row[0], image, line); break;
+      case 4:  read_4bit_line(infoheader->biWidth, &row[0], image, line); break;
+      case 8:  read_8bit_line(infoheader->biWidth, &row[0], image, line); break;
+      case 16: read_16bit_line(infoheader->biWidth, &row[0], image, line, withAlpha); break;
+      case 24: read_24bit_line(infoheader->biWidth, &row[0], image, line); break;
+      case 32: read_32bit_line(infoheader->biWidth, &row[0], image, line, withAlpha); break;
     }
 
-    fop->setProgress((float)(i + 1) / (float)(height));
-    if (fop->isStop())
-      break;
+    // Batch progress notifications/stop checks (one per row floods
+    // the FileOp mutex when the image has thousands of rows).
+    if ((i & 127) == 0 || i == height - 1) {
+      fop->setProgress((float)(i + 1) / (float)(height));
+      if (fop->isStop())
+        break;
+    }
   }
 
   if ((infoheader->biBitCount == 32 || infoheader->biBitCount == 16) && !withAlpha) {
@@ -895,12 +850,18 @@ static int read_bitfields_image(FILE* f,
   bits_per_pixel = infoheader->biBitCount;
   bytes_per_pixel = ((bits_per_pixel / 8) + ((bits_per_pixel % 8) > 0 ? 1 : 0));
 
+  /* one buffered fread() per row (see read_image()) */
+  std::vector<uint8_t> row(bmp_rowsize(infoheader->biWidth, 8 * bytes_per_pixel));
+
   for (i = 0; i < height; i++, line += dir) {
-    for (j = 0; j < (int)infoheader->biWidth; j++) {
-      /* read the DWORD, WORD or BYTE in little-endian order */
+    read_row(f, row);
+    const uint8_t* p = &row[0];
+
+    for (j = 0; j < (int)infoheader->biWidth; j++, p += bytes_per_pixel) {
+      /* the DWORD, WORD or BYTE is in little-endian order */
       buffer = 0;
       for (k = 0; k < bytes_per_pixel; k++)
-        buffer |= fgetc(f) << (k << 3);
+        buffer |= p[k] << (k << 3);
 
       r = (buffer & rmask) >> rshift;
       g = (buffer & gmask) >> gshift;
@@ -916,11 +877,6 @@ static int read_bitfields_image(FILE* f,
         withAlpha = true;
       put_pixel_fast<RgbTraits>(image, j, line, rgba(r, g, b, a));
     }
-
-    j = (bytes_per_pixel * j) % 4;
-    if (j > 0)
-      while (j++ < 4)
-        fgetc(f);
   }
 
   if (!withAlpha) {
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2024  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -24,6 +24,7 @@
 #include "app/file/split_filename.h"
 #include "app/filename_formatter.h"
 #include "app/i18n/strings.h"
+#include "app/job_scheduler.h"
 #include "app/modules/gui.h"
 #include "app/modules/palettes.h"
 #include "app/pref/preferences.h"
@@ -55,6 +56,32 @@ namespace app {
 
 using namespace base;
 
+// Renders "clip.size.h" rows of the given sprite frame into "dst",
+// splitting the work in horizontal bands rendered in parallel (each
+// band writes a disjoint range of rows of "dst").
+static void render_sprite_in_bands(doc::Image* dst,
+                                   const doc::Sprite* sprite,
+                                   const doc::frame_t frame,
+                                   const gfx::Clip& clip,
+                                   const bool newBlend,
+                                   const render::BgOptions& bg)
+{
+  JobScheduler::instance()->forkJoinBands(0, clip.size.h, [&](int from, int to) {
+    render::Render render;
+    render.setNewBlend(newBlend);
+    render.setBgOptions(bg);
+    render.renderSprite(dst,
+                        sprite,
+                        frame,
+                        gfx::Clip(clip.dst.x,
+                                  clip.dst.y + from,
+                                  clip.src.x,
+                                  clip.src.y + from,
+                                  clip.size.w,
+                                  to - from));
+  });
+}
+
 class FileOp::FileAbstractImageImpl : public FileAbstractImage {
 public:
   FileAbstractImageImpl(FileOp* fop)
@@ -128,10 +155,31 @@ public:
     return m_sprite->getPalettes();
   }
 
+  // Enables rendering the given frame in horizontal bands on demand
+  // from getScanline() (for formats with FILE_ENCODE_SCANLINE_BANDS),
+  // so we don't need a whole pre-rendered frame, which can be huge
+  // for sprite sheets. It cannot be combined with on-the-fly scaling.
+  void setUnscaledBandsToSave(const doc::frame_t frame, const gfx::Rect& frameBounds)
+  {
+    ASSERT(!needResize());
+    m_bandMode = true;
+    m_bandFrame = frame;
+    m_bandFrameBounds = frameBounds;
+    m_bandImage.reset();
+    m_tmpScaledImage.reset();
+  }
+
+  bool needResize() const { return (m_scale != gfx::PointF(1.0, 1.0)); }
+
   const doc::ImageRef getScaledImage() const override { return m_tmpScaledImage; }
 
   const uint8_t* getScanline(int y) const override
   {
+    if (m_bandMode) {
+      if (!m_bandImage || y < m_bandY || y >= m_bandY + m_bandImage->height())
+        renderBand(y);
+      return m_bandImage->getPixelAddress(0, y - m_bandY);
+    }
     return m_tmpScaledImage->getPixelAddress(0, y);
   }
 
@@ -148,13 +196,12 @@ public:
       m_tmpUnscaledRender.reset(doc::Image::create(spec));
     }
 
-    render::Render render;
-    render.setNewBlend(m_newBlend);
-    render.setBgOptions(render::BgOptions::MakeNone());
-    render.renderSprite((needResize ? m_tmpUnscaledRender.get() : dst),
-                        m_sprite,
-                        frame,
-                        gfx::Clip(gfx::Point(0, 0), frameBounds));
+    render_sprite_in_bands((needResize ? m_tmpUnscaledRender.get() : dst),
+                           m_sprite,
+                           frame,
+                           gfx::Clip(gfx::Point(0, 0), frameBounds),
+                           m_newBlend,
+                           render::BgOptions::MakeNone());
 
     if (needResize) {
       doc::algorithm::resize_image(m_tmpUnscaledRender.get(),
@@ -166,6 +213,46 @@ public:
     }
   }
 
+  uint64_t frameFingerprint(const doc::frame_t frame) const override
+  {
+    // 64-bit FNV-1a over the object IDs/versions that determine the
+    // rendered pixels of the frame. Per-layer properties that don't
+    // change between frames (opacity, blend mode, tileset content,
+    // etc.) are covered by the object IDs themselves, as the
+    // fingerprints are only compared between frames of this same
+    // save operation.
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&hash](const uint64_t value) {
+      for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (8 * i)) & 0xff;
+        hash *= 0x100000001b3ull;
+      }
+    };
+
+    for (const Cel* cel : m_sprite->cels(frame)) {
+      const Layer* layer = cel->layer();
+      if (!layer->isVisibleHierarchy())
+        continue;
+      // Reference layers can have a fractional position that the cel
+      // origin doesn't capture.
+      if (layer->isReference())
+        return 0;
+
+      mix(layer->id());
+      mix(cel->image()->id());
+      mix(cel->image()->version());
+      mix(uint64_t(uint32_t(cel->x())) | (uint64_t(uint32_t(cel->y())) << 32));
+      mix(uint64_t(cel->opacity()) | (uint64_t(uint32_t(cel->zIndex())) << 32));
+    }
+
+    const doc::Palette* pal = palette(frame);
+    mix(pal->id());
+    mix(pal->getModifications());
+
+    // Zero is reserved for "no fingerprint available"
+    return (hash != 0 ? hash : 1);
+  }
+
   void setScale(const gfx::PointF& scale)
   {
     m_scale = scale;
@@ -174,7 +261,34 @@ public:
   }
 
 private:
-  bool needResize() const { return (m_scale != gfx::PointF(1.0, 1.0)); }
+  // Renders the band of scanlines that contains the "y" row of the
+  // frame configured with setUnscaledBandsToSave(). Bands are aligned
+  // to multiples of the band height, so encoders iterating rows in
+  // order (top-down or bottom-up) render each band just once.
+  void renderBand(const int y) const
+  {
+    // Band height so one band of a huge sprite sheet stays in a few
+    // megabytes of memory.
+    constexpr int kBandHeight = 256;
+
+    const int y0 = y - (y % kBandHeight);
+    const int h = std::min(kBandHeight, m_spec.height() - y0);
+
+    if (!m_bandImage || m_bandImage->height() != h) {
+      auto spec = m_spec;
+      spec.setSize(m_spec.width(), h);
+      m_bandImage.reset(doc::Image::create(spec));
+    }
+
+    render_sprite_in_bands(
+      m_bandImage.get(),
+      m_sprite,
+      m_bandFrame,
+      gfx::Clip(0, 0, m_bandFrameBounds.x, m_bandFrameBounds.y + y0, m_bandFrameBounds.w, h),
+      m_newBlend,
+      render::BgOptions::MakeNone());
+    m_bandY = y0;
+  }
 
   const Doc* m_doc;
   const doc::Sprite* m_sprite;
@@ -184,6 +298,13 @@ private:
   doc::ImageRef m_tmpScaledImage = nullptr;
   mutable doc::ImageRef m_tmpUnscaledRender = nullptr;
   gfx::PointF m_scale = gfx::PointF(1.0, 1.0);
+
+  // On-demand band rendering (setUnscaledBandsToSave())
+  bool m_bandMode = false;
+  doc::frame_t m_bandFrame = 0;
+  gfx::Rect m_bandFrameBounds;
+  mutable doc::ImageRef m_bandImage = nullptr;
+  mutable int m_bandY = -1;
 };
 
 base::paths get_readable_extensions()
@@ -795,90 +916,99 @@ void FileOp::operate(IFileOpProgress* progress)
       // Load the sequence
       frame_t frames(m_seq.filename_list.size());
       frame_t frame(0);
-      Image* old_image = nullptr;
       gfx::Size canvasSize(0, 0);
 
-      // TODO setPalette for each frame???
-      auto add_image = [&]() {
-        canvasSize |= m_seq.image->size();
-
-        m_seq.last_cel->data()->setImage(m_seq.image, m_seq.layer);
-        m_seq.layer->addCel(m_seq.last_cel);
-
-        if (m_document->sprite()->palette(frame)->countDiff(m_seq.palette, NULL, NULL) > 0) {
-          m_seq.palette->setFrame(frame);
-          m_document->sprite()->setPalette(m_seq.palette, true);
-        }
-
-        old_image = m_seq.image.get();
-        m_seq.image.reset();
-        m_seq.last_cel = NULL;
-      };
-
       m_seq.has_alpha = false;
       m_seq.progress_offset = 0.0f;
       m_seq.progress_fraction = 1.0f / (double)frames;
 
-      auto it = m_seq.filename_list.begin(), end = m_seq.filename_list.end();
-      for (; it != end; ++it) {
-        m_filename = it->c_str();
+      // With several files we decode them concurrently (almost all
+      // the load time of a rendered sequence is single-threaded
+      // libpng/libjpeg time).
+      if (frames > 1) {
+        loadSequenceParallel(canvasSize, frame);
+      }
+      else {
+        Image* old_image = nullptr;
 
-        // Call the "load" procedure to read the first bitmap.
-        bool loadres = m_format->load(this);
-        if (!loadres) {
-          setError("Error loading frame %d from file \"%s\"\n", frame + 1, m_filename.c_str());
-        }
+        // TODO setPalette for each frame???
+        auto add_image = [&]() {
+          canvasSize |= m_seq.image->size();
 
-        // For the first frame...
-        if (!old_image) {
-          // Error reading the first frame
-          if (!loadres || !m_document || !m_seq.last_cel) {
-            m_seq.image.reset();
-            delete m_seq.last_cel;
-            delete m_document;
-            m_document = nullptr;
-            break;
-          }
-          // Read ok
-          else {
-            // Add the keyframe
-            add_image();
+          m_seq.last_cel->data()->setImage(m_seq.image, m_seq.layer);
+          m_seq.layer->addCel(m_seq.last_cel);
+
+          if (m_document->sprite()->palette(frame)->countDiff(m_seq.palette, NULL, NULL) > 0) {
+            m_seq.palette->setFrame(frame);
+            m_document->sprite()->setPalette(m_seq.palette, true);
           }
-        }
-        // For other frames
-        else {
-          // All done (or maybe not enough memory)
-          if (!loadres || !m_seq.last_cel) {
-            m_seq.image.reset();
-            delete m_seq.last_cel;
-            break;
+
+          old_image = m_seq.image.get();
+          m_seq.image.reset();
+          m_seq.last_cel = NULL;
+        };
+
+        auto it = m_seq.filename_list.begin(), end = m_seq.filename_list.end();
+        for (; it != end; ++it) {
+          m_filename = it->c_str();
+
+          // Call the "load" procedure to read the first bitmap.
+          bool loadres = m_format->load(this);
+          if (!loadres) {
+            setError("Error loading frame %d from file \"%s\"\n", frame + 1, m_filename.c_str());
           }
 
-          // Compare the old frame with the new one
-#if USE_LINK // TODO this should be configurable through a check-box
-          if (count_diff_between_images(old_image, m_seq.image)) {
-            add_image();
+          // For the first frame...
+          if (!old_image) {
+            // Error reading the first frame
+            if (!loadres || !m_document || !m_seq.last_cel) {
+              m_seq.image.reset();
+              delete m_seq.last_cel;
+              delete m_document;
+              m_document = nullptr;
+              break;
+            }
+            // Read ok
+            else {
+              // Add the keyframe
+              add_image();
+            }
           }
-          // We don't need this image
+          // For other frames
           else {
-            m_seq.image.reset();
-
-            // But add a link frame
-            m_seq.last_cel->image = image_index;
-            layer_add_frame(m_seq.layer, m_seq.last_cel);
+            // All done (or maybe not enough memory)
+            if (!loadres || !m_seq.last_cel) {
+              m_seq.image.reset();
+              delete m_seq.last_cel;
+              break;
+            }
 
-            m_seq.last_image = NULL;
-            m_seq.last_cel = NULL;
-          }
+            // Compare the old frame with the new one
+#if USE_LINK // TODO this should be configurable through a check-box
+            if (count_diff_between_images(old_image, m_seq.image)) {
+              add_image();
+            }
+            // We don't need this image
+            else {
+              m_seq.image.reset();
+
+              // But add a link frame
+              m_seq.last_cel->image = image_index;
+              layer_add_frame(m_seq.layer, m_seq.last_cel);
+
+              m_seq.last_image = NULL;
+              m_seq.last_cel = NULL;
+            }
 #else
-          add_image();
+            add_image();
 #endif
-        }
+          }
 
-        m_document->sprite()->setFrameDuration(frame, m_seq.duration);
+          m_document->sprite()->setFrameDuration(frame, m_seq.duration);
 
-        ++frame;
-        m_seq.progress_offset += m_seq.progress_fraction;
+          ++frame;
+          m_seq.progress_offset += m_seq.progress_fraction;
+        }
       }
       m_filename = *m_seq.filename_list.begin();
 
@@ -946,17 +1076,29 @@ void FileOp::operate(IFileOpProgress* progress)
 
       Sprite* sprite = m_document->sprite();
 
+      // Formats that can encode from scanlines rendered on demand
+      // (FILE_ENCODE_SCANLINE_BANDS) don't need each whole frame
+      // pre-rendered: frames are rendered in horizontal bands from
+      // getScanline(), capping memory usage for huge sprite sheets.
+      bool streamBands = (m_format->support(FILE_ENCODE_ABSTRACT_IMAGE) &&
+                          m_format->support(FILE_ENCODE_SCANLINE_BANDS) && !m_ignoreEmpty);
+      if (streamBands) {
+        makeAbstractImage();
+        // On-the-fly scaling needs the whole frame to resize it.
+        if (m_abstractImage->needResize())
+          streamBands = false;
+      }
+
       // Create a temporary bitmap
-      m_seq.image.reset(
-        Image::create(sprite->pixelFormat(), m_roi.fileCanvasSize().w, m_roi.fileCanvasSize().h));
+      if (!streamBands) {
+        m_seq.image.reset(
+          Image::create(sprite->pixelFormat(), m_roi.fileCanvasSize().w, m_roi.fileCanvasSize().h));
+      }
 
       m_seq.progress_offset = 0.0f;
       m_seq.progress_fraction = 1.0f / (double)sprite->totalFrames();
 
       // For each frame in the sprite.
-      render::Render render;
-      render.setNewBlend(m_config.newBlend);
-
       frame_t outputFrame = 0;
       for (frame_t frame : m_roi.framesSequence()) {
         gfx::Rect bounds = m_roi.frameBounds(frame);
@@ -967,8 +1109,18 @@ void FileOp::operate(IFileOpProgress* progress)
           m_abstractImage->setSpecSize(m_roi.fileCanvasSize(), bounds.size());
         }
 
-        // Render the (unscaled) sequenced image.
-        render.renderSprite(m_seq.image.get(), sprite, frame, gfx::Clip(gfx::Point(0, 0), bounds));
+        if (streamBands) {
+          m_abstractImage->setUnscaledBandsToSave(frame, bounds);
+        }
+        else {
+          // Render the (unscaled) sequenced image in parallel bands.
+          render_sprite_in_bands(m_seq.image.get(),
+                                 sprite,
+                                 frame,
+                                 gfx::Clip(gfx::Point(0, 0), bounds),
+                                 m_config.newBlend,
+                                 render::BgOptions::MakeTransparent());
+        }
 
         bool save = true;
 
@@ -1322,6 +1474,146 @@ ImageRef FileOp::sequenceImageToLoad(const PixelFormat pixelFormat, const int w,
   return m_seq.image;
 }
 
+void FileOp::loadSequenceParallel(gfx::Size& canvasSize, frame_t& frame)
+{
+  // Each file is decoded with a nested one-frame FileOp (the same
+  // mechanism used to prefetch files and generate thumbnails in
+  // background threads) and the resulting documents are consumed in
+  // order. The list is processed in bounded batches so a long
+  // sequence doesn't accumulate thousands of decoded images in
+  // memory.
+  int nestedFlags = FILE_LOAD_SEQUENCE_NONE | FILE_LOAD_ONE_FRAME;
+  if (m_createPaletteFromRgba)
+    nestedFlags |= FILE_LOAD_CREATE_PALETTE;
+
+  JobScheduler* scheduler = JobScheduler::instance();
+  const size_t window = std::max<size_t>(2, 2 * scheduler->threads());
+
+  for (size_t i = 0; i < m_seq.filename_list.size(); i += window) {
+    const size_t end = std::min(i + window, m_seq.filename_list.size());
+
+    std::vector<std::unique_ptr<FileOp>> fops(end - i);
+    scheduler->forkJoin(int(end - i), [this, &fops, i, nestedFlags](int k) {
+      std::unique_ptr<FileOp> fop(FileOp::createLoadDocumentOperation(nullptr,
+                                                                      m_seq.filename_list[i + k],
+                                                                      nestedFlags,
+                                                                      &m_config));
+      if (fop && !fop->hasError()) {
+        try {
+          fop->operate();
+        }
+        catch (const std::exception& e) {
+          fop->setError("Error loading file:\n%s", e.what());
+        }
+        fop->done();
+      }
+      fops[k] = std::move(fop);
+    });
+
+    for (size_t j = i; j < end; ++j) {
+      FileOp* srcFop = fops[j - i].get();
+      m_filename = m_seq.filename_list[j];
+
+      std::unique_ptr<Doc> srcDoc;
+      if (srcFop && !srcFop->hasError())
+        srcDoc.reset(srcFop->releaseDocument());
+
+      if (!srcDoc || !addSequenceFrame(srcFop, srcDoc->sprite(), canvasSize, frame)) {
+        if (srcFop && srcFop->hasError())
+          setError("%s", srcFop->error().c_str());
+        setError("Error loading frame %d from file \"%s\"\n", frame + 1, m_filename.c_str());
+
+        // Error reading the first frame: no document at all (same
+        // behavior as the serial path in operate()).
+        if (frame == 0) {
+          delete m_document;
+          m_document = nullptr;
+        }
+        return;
+      }
+
+      m_seq.progress_offset += m_seq.progress_fraction;
+      setProgress(m_seq.progress_offset);
+      if (isStop())
+        return;
+    }
+  }
+}
+
+bool FileOp::addSequenceFrame(FileOp* srcFop,
+                              Sprite* srcSprite,
+                              gfx::Size& canvasSize,
+                              frame_t& frame)
+{
+  Layer* srcLayer = srcSprite->root()->firstLayer();
+  if (!srcLayer || !srcLayer->isImage())
+    return false;
+
+  Cel* srcCel = srcLayer->cel(0);
+  if (!srcCel || !srcCel->image())
+    return false;
+
+  // The first frame creates the destination document (just like
+  // sequenceImageToLoad() does for the serial path).
+  if (!m_document) {
+    Sprite* sprite = new Sprite(ImageSpec(srcSprite->colorMode(),
+                                          srcSprite->width(),
+                                          srcSprite->height()),
+                                256);
+    try {
+      LayerImage* layer = new LayerImage(sprite);
+      sprite->root()->addLayer(layer);
+      sprite->setColorSpace(srcSprite->colorSpace());
+
+      if (sprite->pixelFormat() == IMAGE_INDEXED)
+        sprite->rgbMap(0,
+                       Sprite::RgbMapFor(sprite->isOpaque()),
+                       m_config.rgbMapAlgorithm,
+                       m_config.fitCriteria);
+
+      createDocument(sprite);
+      m_seq.layer = layer;
+    }
+    catch (...) {
+      delete sprite;
+      throw;
+    }
+  }
+  else if (m_document->sprite()->pixelFormat() != srcSprite->pixelFormat()) {
+    setError("Error: image does not match color mode\n");
+    return false;
+  }
+
+  canvasSize |= srcCel->image()->size();
+
+  // The image is shared with the temporary document of the nested
+  // FileOp, which is discarded after this.
+  m_seq.layer->addCel(new Cel(frame, srcCel->imageRef()));
+
+  // Palette read from this file of the sequence
+  const Palette* srcPal = srcSprite->palette(0);
+  if (m_document->sprite()->palette(frame)->countDiff(srcPal, nullptr, nullptr) > 0) {
+    Palette pal(*srcPal);
+    pal.setFrame(frame);
+    m_document->sprite()->setPalette(&pal, true);
+  }
+
+  if (srcFop->sequenceGetHasAlpha())
+    m_seq.has_alpha = true;
+
+  if (srcFop->hasEmbeddedColorProfile())
+    setEmbeddedColorProfile();
+
+  // Like the serial path, keep the format options of the latest
+  // loaded file.
+  if (srcFop->m_formatOptions)
+    m_formatOptions = srcFop->m_formatOptions;
+
+  m_document->sprite()->setFrameDuration(frame, m_seq.duration);
+  ++frame;
+  return true;
+}
+
 void FileOp::makeAbstractImage()
 {
   ASSERT(m_format->support(FILE_ENCODE_ABSTRACT_IMAGE));
@@ -1335,8 +1627,9 @@ FileAbstractImage* FileOp::abstractImageToSave()
 
   makeAbstractImage();
 
-  // Use sequenceImageToSave() to fill the current image
-  if (m_format->support(FILE_SUPPORT_SEQUENCES)) {
+  // Use sequenceImageToSave() to fill the current image (if we are
+  // rendering frames in bands on demand there is no sequence image)
+  if (m_format->support(FILE_SUPPORT_SEQUENCES) && m_seq.image) {
     m_abstractImage->setUnscaledImageToSave(m_seq.frame++, m_seq.image);
   }
 
@@ -1394,6 +1687,41 @@ void FileOp::setProgress(double progress)
     m_progressInterface->ackFileOpProgress(progress);
 }
 
+void FileOp::makeLoadingPreviewImage(const doc::Sprite* sprite, const doc::frame_t frame)
+{
+  // Maximum side of the preview (same cap used for file-list
+  // thumbnails, enough for the loading alert).
+  constexpr int kMaxPreviewSize = 128;
+
+  const int w = sprite->width() * sprite->pixelRatio().w;
+  const int h = sprite->height() * sprite->pixelRatio().h;
+  int previewW = kMaxPreviewSize * w / std::max(w, h);
+  int previewH = kMaxPreviewSize * h / std::max(w, h);
+  if (std::max(previewW, previewH) > std::max(w, h)) {
+    previewW = w;
+    previewH = h;
+  }
+  previewW = std::clamp(previewW, 1, kMaxPreviewSize);
+  previewH = std::clamp(previewH, 1, kMaxPreviewSize);
+
+  doc::ImageRef image(doc::Image::create(IMAGE_RGB, previewW, previewH));
+  render::Projection proj(sprite->pixelRatio(), render::Zoom(previewW, w));
+  render::Render render;
+  render.setNewBlend(m_config.newBlend);
+  render.setBgOptions(render::BgOptions::MakeTransparent());
+  render.setProjection(proj);
+  render.renderSprite(image.get(), sprite, frame, gfx::Clip(0, 0, 0, 0, w, h));
+
+  const std::lock_guard lock(m_mutex);
+  m_loadingPreview = image;
+}
+
+doc::ImageRef FileOp::loadingPreviewImage() const
+{
+  const std::lock_guard lock(m_mutex);
+  return m_loadingPreview;
+}
+
 void FileOp::getFilenameList(base::paths& output) const
 {
   if (isSequence()) {
@@ -1446,6 +1774,7 @@ FileOp::FileOp(FileOpType type, Context* context, const FileOpConfig* config)
   , m_done(false)
   , m_stop(false)
   , m_oneframe(false)
+  , m_frameToLoad(0)
   , m_createPaletteFromRgba(false)
   , m_ignoreEmpty(false)
   , m_avoidBackgroundLayer(false)
@@ -1480,9 +1809,17 @@ void FileOp::prepareForSequence()
 void FileOp::makeDirectories()
 {
   std::string dir = base::get_file_path(m_filename);
+
+  // Saving a sequence calls this once per frame, generally with all
+  // the frames going to the same directory, so avoid hitting the file
+  // system again for a directory we've just checked/created.
+  if (dir == m_createdDirectory)
+    return;
+
   try {
     if (!base::is_directory(dir))
       base::make_all_directories(dir);
+    m_createdDirectory = dir;
   }
   catch (const std::exception& ex) {
     // Ignore errors and make the delegate fail
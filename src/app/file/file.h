@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2023  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -25,6 +25,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 // Flags for FileOp::createLoadDocumentOperation()
 #define FILE_LOAD_SEQUENCE_NONE          0x00000001
@@ -138,6 +139,15 @@ public:
   virtual void renderFrame(const doc::frame_t frame,
                            const gfx::Rect& frameBounds,
                            doc::Image* dst) const = 0;
+
+  // Fingerprint of the content rendered for the given frame,
+  // aggregating cel/palette versions (doc::Object::version()), or 0
+  // if it cannot be calculated. Two frames with the same non-zero
+  // fingerprint produce exactly the same pixels from renderFrame(),
+  // so encoders can reference/join duplicated frames without
+  // rendering them again. Fingerprints are only valid during the
+  // save operation (object IDs are session-local).
+  virtual uint64_t frameFingerprint(const doc::frame_t frame) const { return 0; }
 };
 
 // Structure to load & save files.
@@ -165,6 +175,11 @@ public:
 
   bool isSequence() const { return !m_seq.filename_list.empty(); }
   bool isOneFrame() const { return m_oneframe; }
+
+  // Frame to load when isOneFrame() is true (formats with a frame
+  // index like .aseprite can seek directly to it).
+  doc::frame_t frameToLoad() const { return m_frameToLoad; }
+  void setFrameToLoad(const doc::frame_t frame) { m_frameToLoad = frame; }
   bool preserveColorProfile() const { return m_config.preserveColorProfile; }
   const FileFormat* fileFormat() const { return m_format; }
 
@@ -245,6 +260,17 @@ public:
   void sequenceSetHasAlpha(bool hasAlpha) { m_seq.has_alpha = hasAlpha; }
   int sequenceFlags() const { return m_seq.flags; }
 
+  // Scratch buffer that encoders can use to convert rows/frames. It's
+  // owned by the FileOp so when a sequence is saved all the frames
+  // reuse the same allocation (it just grows to the largest requested
+  // size) instead of allocating a new buffer per file.
+  std::vector<uint8_t>& sequenceEncodeBuffer(const size_t size)
+  {
+    if (m_seq.encode_buffer.size() < size)
+      m_seq.encode_buffer.resize(size);
+    return m_seq.encode_buffer;
+  }
+
   // Can be used to encode sequences/static files (e.g. png files)
   // or animations (e.g. gif) resizing the result on the fly. This
   // function is called for each frame to be saved for sequence-like
@@ -263,6 +289,14 @@ public:
   double progress() const;
   void setProgress(double progress);
 
+  // Preview for load operations: the file format can publish a
+  // downsampled RGBA composite of the first decoded frame while the
+  // rest of the file is still being decoded, so the UI can show the
+  // sprite content as soon as possible instead of just a progress bar
+  // (see OpenFileJob). Both are thread-safe.
+  void makeLoadingPreviewImage(const doc::Sprite* sprite, const doc::frame_t frame);
+  doc::ImageRef loadingPreviewImage() const;
+
   void getFilenameList(base::paths& output) const;
 
   void setEmbeddedColorProfile() { m_embeddedColorProfile = true; }
@@ -289,6 +323,7 @@ private:
   std::string m_filename;     // File-name to load/save.
   std::string m_dataFilename; // File-name for a special XML .aseprite-data where extra sprite data
                               // can be stored
+  std::string m_createdDirectory; // Last directory checked/created by makeDirectories().
   FileOpROI m_roi;
 
   // Shared fields between threads.
@@ -297,11 +332,14 @@ private:
   IFileOpProgress* m_progressInterface;
   std::string m_error;                // Error string.
   std::string m_incompatibilityError; // Incompatibility error string.
+  doc::ImageRef m_loadingPreview;     // See makeLoadingPreviewImage().
   bool m_done;                        // True if the operation finished.
   bool m_stop;                        // Force the break of the operation.
   bool m_oneframe;                    // Load just one frame (in formats
                                       // that support animation like
                                       // GIF/FLI/ASE).
+  doc::frame_t m_frameToLoad;         // Specific frame to load when
+                                      // m_oneframe is true.
   bool m_createPaletteFromRgba;
   bool m_ignoreEmpty;
   bool m_avoidBackgroundLayer;
@@ -333,12 +371,17 @@ private:
     int duration;
     // Flags after the user choose what to do with the sequence.
     int flags;
+    // Scratch buffer shared by all the saved frames (see
+    // sequenceEncodeBuffer()).
+    std::vector<uint8_t> encode_buffer;
   } m_seq;
 
   class FileAbstractImageImpl;
   std::unique_ptr<FileAbstractImageImpl> m_abstractImage;
 
   void prepareForSequence();
+  void loadSequenceParallel(gfx::Size& canvasSize, frame_t& frame);
+  bool addSequenceFrame(FileOp* srcFop, Sprite* srcSprite, gfx::Size& canvasSize, frame_t& frame);
   void makeAbstractImage();
   void makeDirectories();
 };
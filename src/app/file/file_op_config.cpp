@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -27,6 +27,9 @@ void FileOpConfig::fillFromPreferences()
   rgbMapAlgorithm = pref.quantization.rgbmapAlgorithm();
   fitCriteria = pref.quantization.fitCriteria();
   cacheCompressedTilesets = pref.tileset.cacheCompressedTilesets();
+  cacheCompressedCels = pref.asepriteFormat.cacheCompressedCels();
+  asepriteCompressionLevel = pref.asepriteFormat.compressionLevel();
+  writeFrameIndexChunk = pref.asepriteFormat.frameIndexChunk();
   composeGroups = pref.experimental.composeGroups();
 }
 
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -47,6 +47,25 @@ struct FileOpConfig {
   // compressed data that was loaded as-is).
   bool cacheCompressedTilesets = true;
 
+  // Same thing for cels: when a compressed cel is loaded from a
+  // .aseprite file, keep its deflated bytes in memory so saving the
+  // file again writes them back verbatim for each cel that wasn't
+  // modified (instead of re-deflating the whole sprite).
+  bool cacheCompressedCels = true;
+
+  // Zlib level used to deflate cels/tilesets when saving .aseprite
+  // files (-1 = zlib default). Low levels (e.g. 1) make saving and
+  // backups considerably faster at the cost of slightly bigger
+  // files; the file format doesn't change so any version of the
+  // program can open the result.
+  int asepriteCompressionLevel = -1;
+
+  // True to write the frame index chunk (fast frame seeking) when
+  // saving multi-frame .aseprite files. Disabled by default because
+  // older versions of the program report files with unknown chunks
+  // as incompatible (opening them as read-only).
+  bool writeFrameIndexChunk = false;
+
   // True if layer groups are composed in a separate image first,
   // and then composed with the rest of the sprite. In this case
   // blend mode and opacity fields are valid for groups too.
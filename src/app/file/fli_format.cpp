@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2023  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -124,8 +124,10 @@ bool FliFormat::onLoad(FileOp* fop)
       palChange = true;
     }
 
-    // First frame, or the frame changes
-    if (!prevCel || (count_diff_between_images(prevCel->image(), bmp.get()))) {
+    // First frame, or the frame changes (is_same_image() stops at the
+    // first different row instead of counting every difference, which
+    // matters when most delta frames of a long FLIC do change)
+    if (!prevCel || !is_same_image(prevCel->image(), bmp.get())) {
       // Add the new frame
       ImageRef image(Image::createCopy(bmp.get()));
       Cel* cel = new Cel(frame_out, image);
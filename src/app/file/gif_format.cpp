@@ -18,6 +18,7 @@
 #include "app/file/format_options.h"
 #include "app/file/gif_format.h"
 #include "app/file/gif_options.h"
+#include "app/job_scheduler.h"
 #include "app/modules/gui.h"
 #include "app/pref/preferences.h"
 #include "app/util/autocrop.h"
@@ -35,6 +36,8 @@
 #include "gif_options.xml.h"
 
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 
 #include <gif_lib.h>
 
@@ -1084,22 +1087,40 @@ public:
     m_currentImage = m_images[1].get();
     m_nextImage = m_images[2].get();
 
-    auto frame_beg = m_fop->roi().framesSequence().begin();
-  #if _DEBUG
-    auto frame_end = m_fop->roi().framesSequence().end();
-  #endif
-    auto frame_it = frame_beg;
+    // Collapse runs of consecutive frames with identical content
+    // (comparing cel/palette versions through frameFingerprint())
+    // into one GIF frame with the accumulated duration, so
+    // duplicated/hold frames aren't rendered nor quantized again. A
+    // run is broken before the accumulated delay overflows the
+    // 16-bit GIF delay field.
+    std::vector<frame_t> frames;
+    std::vector<int> durations; // Accumulated duration of each GIF frame in msecs
+    uint64_t prevFingerprint = 0;
+    gfx::Rect prevFrameBounds;
+    for (const frame_t frame : m_fop->roi().framesSequence()) {
+      const uint64_t fingerprint = m_img->frameFingerprint(frame);
+      const gfx::Rect frameBounds = m_fop->roi().frameBounds(frame);
+      const int duration = m_img->frameDuration(frame);
+      if (fingerprint != 0 && fingerprint == prevFingerprint && frameBounds == prevFrameBounds &&
+          durations.back() + duration <= 10 * 0xffff) {
+        durations.back() += duration;
+      }
+      else {
+        frames.push_back(frame);
+        durations.push_back(duration);
+      }
+      prevFingerprint = fingerprint;
+      prevFrameBounds = frameBounds;
+    }
 
     // In this code "gifFrame" will be the GIF frame, and "frame" will
     // be the doc::Sprite frame.
-    gifframe_t nframes = totalFrames();
+    const gifframe_t nframes = gifframe_t(frames.size());
     for (gifframe_t gifFrame = 0; gifFrame < nframes; ++gifFrame) {
-      ASSERT(frame_it != frame_end);
       if (m_fop->isStop())
         break;
 
-      frame_t frame = *frame_it;
-      ++frame_it;
+      const frame_t frame = frames[gifFrame];
 
       if (gifFrame == 0)
         renderFrame(frame, m_nextImage);
@@ -1109,7 +1130,7 @@ public:
       // Render next frame
       std::swap(m_currentImage, m_nextImage);
       if (gifFrame + 1 < nframes)
-        renderFrame(*frame_it, m_nextImage);
+        renderFrame(frames[gifFrame + 1], m_nextImage);
 
       gfx::Rect frameBounds = m_spriteBounds;
       DisposalMethod disposal = DisposalMethod::DO_NOT_DISPOSE;
@@ -1124,9 +1145,9 @@ public:
       calculateDeltaImageFrameBoundsDisposal(gifFrame, frameBounds, disposal);
 
       writeImage(gifFrame,
-                 frame,
                  frameBounds,
                  disposal,
+                 durations[gifFrame],
                  // Only the last frame in the animation needs the fix
                  (fix_last_frame_duration && gifFrame == nframes - 1));
 
@@ -1148,19 +1169,23 @@ private:
       // but when the next frame (frame 1) has a "pixel clearing",
       // we must change disposal to RESTORE_BGCOLOR.
 
-      // "Pixel clearing" detection:
+      // "Pixel clearing" detection (scanning row bands in parallel):
       if (!m_hasBackground && !m_preservePaletteOrder) {
-        const LockImageBits<RgbTraits> bits2(m_currentImage);
-        const LockImageBits<RgbTraits> bits3(m_nextImage);
-        typename LockImageBits<RgbTraits>::const_iterator it2, it3, end2, end3;
-        for (it2 = bits2.begin(), end2 = bits2.end(), it3 = bits3.begin(), end3 = bits3.end();
-             it2 != end2 && it3 != end3;
-             ++it2, ++it3) {
-          if (rgba_geta(*it2) != 0 && rgba_geta(*it3) == 0) {
-            disposal = DisposalMethod::RESTORE_BGCOLOR;
-            break;
+        std::atomic<bool> pixelClearing(false);
+        JobScheduler::instance()->forkJoinBands(0, m_spriteBounds.h, [&](int fromY, int toY) {
+          for (int y = fromY; y < toY && !pixelClearing; ++y) {
+            auto it2 = (const uint32_t*)m_currentImage->getPixelAddress(0, y);
+            auto it3 = (const uint32_t*)m_nextImage->getPixelAddress(0, y);
+            for (int x = 0; x < m_spriteBounds.w; ++x, ++it2, ++it3) {
+              if (rgba_geta(*it2) != 0 && rgba_geta(*it3) == 0) {
+                pixelClearing = true;
+                break;
+              }
+            }
           }
-        }
+        });
+        if (pixelClearing)
+          disposal = DisposalMethod::RESTORE_BGCOLOR;
       }
       else if (m_preservePaletteOrder)
         disposal = DisposalMethod::RESTORE_BGCOLOR;
@@ -1189,53 +1214,69 @@ private:
           y1 = m_spriteBounds.h - 1;
         }
 
-        int i = 0;
-        int x, y;
-        const LockImageBits<RgbTraits> bits1(m_previousImage);
-        LockImageBits<RgbTraits> bits2(m_currentImage);
-        const LockImageBits<RgbTraits> bits3(m_nextImage);
         m_deltaImage.reset(
           Image::create(PixelFormat::IMAGE_RGB, m_spriteBounds.w, m_spriteBounds.h));
         clear_image(m_deltaImage.get(), 0);
-        LockImageBits<RgbTraits> deltaBits(m_deltaImage.get());
-        typename LockImageBits<RgbTraits>::iterator deltaIt;
-        typename LockImageBits<RgbTraits>::iterator it2, end2;
-        typename LockImageBits<RgbTraits>::const_iterator it1, it3, end1, deltaEnd;
 
+        // Diff previous/current/next frames scanning row bands in
+        // parallel, each band accumulates its own bounds/flags that
+        // are merged at the end (rows are disjoint so writing the
+        // delta/current images is thread-safe).
         bool previousImageMatchsCurrent = true;
-        for (it1 = bits1.begin(),
-            end1 = bits1.end(),
-            it2 = bits2.begin(),
-            end2 = bits2.end(),
-            it3 = bits3.begin(),
-            deltaIt = deltaBits.begin();
-             it1 != end1 && it2 != end2;
-             ++it1, ++it2, ++it3, ++deltaIt, ++i) {
-          x = i % m_spriteBounds.w;
-          y = i / m_spriteBounds.w;
-          // While we are checking color differences,
-          // we enlarge the frameBounds where the color differences take place
-          if ((rgba_geta(*it2) != 0 && *it1 != *it2) || rgba_geta(*it3) == 0) {
-            previousImageMatchsCurrent = false;
-            *it2 = (rgba_geta(*it2) ? *it2 : 0);
-            *deltaIt = *it2;
-            if (x < x1)
-              x1 = x;
-            if (x > x2)
-              x2 = x;
-            if (y < y1)
-              y1 = y;
-            if (y > y2)
-              y2 = y;
+        bool pixelClearing = false;
+        std::mutex mergeMutex;
+        JobScheduler::instance()->forkJoinBands(0, m_spriteBounds.h, [&](int fromY, int toY) {
+          int bx1 = m_spriteBounds.w, by1 = m_spriteBounds.h;
+          int bx2 = -1, by2 = -1;
+          bool bandDiff = false;
+          bool bandClearing = false;
+
+          for (int y = fromY; y < toY; ++y) {
+            auto it1 = (const uint32_t*)m_previousImage->getPixelAddress(0, y);
+            auto it2 = (uint32_t*)m_currentImage->getPixelAddress(0, y);
+            auto it3 = (const uint32_t*)m_nextImage->getPixelAddress(0, y);
+            auto deltaIt = (uint32_t*)m_deltaImage->getPixelAddress(0, y);
+
+            for (int x = 0; x < m_spriteBounds.w; ++x, ++it1, ++it2, ++it3, ++deltaIt) {
+              // While we are checking color differences,
+              // we enlarge the frameBounds where the color differences take place
+              if ((rgba_geta(*it2) != 0 && *it1 != *it2) || rgba_geta(*it3) == 0) {
+                bandDiff = true;
+                *it2 = (rgba_geta(*it2) ? *it2 : 0);
+                *deltaIt = *it2;
+                if (x < bx1)
+                  bx1 = x;
+                if (x > bx2)
+                  bx2 = x;
+                if (y < by1)
+                  by1 = y;
+                if (y > by2)
+                  by2 = y;
+              }
+
+              // We need to change disposal mode DO_NOT_DISPOSE to RESTORE_BGCOLOR only
+              // if we found a "pixel clearing" in the next Image. RESTORE_BGCOLOR is
+              // our way to clear pixels.
+              if (rgba_geta(*it2) != 0 && rgba_geta(*it3) == 0) {
+                bandClearing = true;
+              }
+            }
           }
 
-          // We need to change disposal mode DO_NOT_DISPOSE to RESTORE_BGCOLOR only
-          // if we found a "pixel clearing" in the next Image. RESTORE_BGCOLOR is
-          // our way to clear pixels.
-          if (rgba_geta(*it2) != 0 && rgba_geta(*it3) == 0) {
-            disposal = DisposalMethod::RESTORE_BGCOLOR;
+          const std::lock_guard lock(mergeMutex);
+          if (bandDiff) {
+            previousImageMatchsCurrent = false;
+            x1 = std::min(x1, bx1);
+            y1 = std::min(y1, by1);
+            x2 = std::max(x2, bx2);
+            y2 = std::max(y2, by2);
           }
-        }
+          if (bandClearing)
+            pixelClearing = true;
+        });
+        if (pixelClearing)
+          disposal = DisposalMethod::RESTORE_BGCOLOR;
+
         if (previousImageMatchsCurrent)
           frameBounds = gfx::Rect(m_lastFrameBounds);
         else
@@ -1323,13 +1364,13 @@ private:
   // Writes graphics extension record (to save the duration of the
   // frame and maybe the transparency index).
   void writeExtension(const gifframe_t gifFrame,
-                      const frame_t frame,
+                      const int frameDuration,
                       const int transparentIndex,
                       const DisposalMethod disposalMethod,
                       const bool fixDuration)
   {
     unsigned char extension_bytes[5];
-    int frameDelay = m_img->frameDuration(frame) / 10;
+    int frameDelay = frameDuration / 10;
 
     // Fix duration for Twitter. It looks like the last frame must be
     // 1/4 of its duration for some strange reason in the Twitter
@@ -1364,9 +1405,9 @@ private:
   }
 
   void writeImage(const gifframe_t gifFrame,
-                  const frame_t frame,
                   const gfx::Rect& frameBounds,
                   const DisposalMethod disposal,
+                  const int frameDuration,
                   const bool fixDuration)
   {
     Palette framePalette;
@@ -1375,8 +1416,6 @@ private:
     else
       framePalette = calculatePalette();
 
-    OctreeMap octree;
-    octree.regenerateMap(&framePalette, m_transparentIndex);
     ImageRef frameImage(
       Image::create(IMAGE_INDEXED, frameBounds.w, frameBounds.h, m_frameImageBuf));
 
@@ -1390,48 +1429,61 @@ private:
     Remap remap(256);
 
     if (!m_preservePaletteOrder) {
-      const LockImageBits<RgbTraits> srcBits(m_deltaImage.get());
-      LockImageBits<IndexedTraits> dstBits(frameImage.get());
-
-      auto srcIt = srcBits.begin();
-      auto dstIt = dstBits.begin();
-
-      for (int y = 0; y < frameBounds.h; ++y) {
-        for (int x = 0; x < frameBounds.w; ++x, ++srcIt, ++dstIt) {
-          ASSERT(srcIt != srcBits.end());
-          ASSERT(dstIt != dstBits.end());
-
-          color_t color = *srcIt;
-          int i;
-
-          if (rgba_geta(color) > 0) {
-            i = framePalette.findExactMatch(rgba_getr(color),
-                                            rgba_getg(color),
-                                            rgba_getb(color),
-                                            255,
-                                            m_transparentIndex);
-            if (i < 0)
-              i = octree.mapColor(color | rgba_a_mask); // alpha=255
+      // Quantize the delta image in parallel row bands. Each band
+      // uses its own OctreeMap because mapColor() memoizes best-fit
+      // indexes inside the octree (it's not thread-safe), and
+      // accumulates its own used colors.
+      std::mutex mergeMutex;
+      JobScheduler::instance()->forkJoinBands(0, frameBounds.h, [&](int fromY, int toY) {
+        OctreeMap octree;
+        octree.regenerateMap(&framePalette, m_transparentIndex);
+        PalettePicks bandUsedColors(framePalette.size());
+
+        for (int y = fromY; y < toY; ++y) {
+          auto srcIt = (const uint32_t*)m_deltaImage->getPixelAddress(0, y);
+          auto dstIt = (uint8_t*)frameImage->getPixelAddress(0, y);
+
+          for (int x = 0; x < frameBounds.w; ++x, ++srcIt, ++dstIt) {
+            color_t color = *srcIt;
+            int i;
+
+            if (rgba_geta(color) > 0) {
+              i = framePalette.findExactMatch(rgba_getr(color),
+                                              rgba_getg(color),
+                                              rgba_getb(color),
+                                              255,
+                                              m_transparentIndex);
+              if (i < 0)
+                i = octree.mapColor(color | rgba_a_mask); // alpha=255
+            }
+            else {
+              if (m_transparentIndex >= 0)
+                i = m_transparentIndex;
+              else
+                i = m_bgIndex;
+            }
+
+            ASSERT(i >= 0);
+
+            // This can happen when transparent color is outside the
+            // palette range (TODO something that shouldn't be possible
+            // from the program).
+            if (i >= bandUsedColors.size())
+              bandUsedColors.resize(i + 1);
+            bandUsedColors[i] = true;
+
+            *dstIt = i;
           }
-          else {
-            if (m_transparentIndex >= 0)
-              i = m_transparentIndex;
-            else
-              i = m_bgIndex;
-          }
-
-          ASSERT(i >= 0);
-
-          // This can happen when transparent color is outside the
-          // palette range (TODO something that shouldn't be possible
-          // from the program).
-          if (i >= usedColors.size())
-            usedColors.resize(i + 1);
-          usedColors[i] = true;
+        }
 
-          *dstIt = i;
+        const std::lock_guard lock(mergeMutex);
+        if (bandUsedColors.size() > usedColors.size())
+          usedColors.resize(bandUsedColors.size());
+        for (int i = 0; i < bandUsedColors.size(); ++i) {
+          if (bandUsedColors[i])
+            usedColors[i] = true;
         }
-      }
+      });
 
       int usedNColors = usedColors.picks();
 
@@ -1464,7 +1516,7 @@ private:
     }
 
     // Write extension record.
-    writeExtension(gifFrame, frame, localTransparent, disposal, fixDuration);
+    writeExtension(gifFrame, frameDuration, localTransparent, disposal, fixDuration);
 
     // Write the image record.
     if (EGifPutImageDesc(m_gifFile,
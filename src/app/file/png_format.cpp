@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2022  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -16,12 +16,15 @@
 #include "app/file/format_options.h"
 #include "app/file/png_format.h"
 #include "app/file/png_options.h"
+#include "app/job_scheduler.h"
 #include "base/file_handle.h"
 #include "doc/doc.h"
 #include "gfx/color_space.h"
 
+#include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
+#include <vector>
 
 #include "png.h"
 
@@ -42,7 +45,8 @@ class PngFormat : public FileFormat {
   {
     return FILE_SUPPORT_LOAD | FILE_SUPPORT_SAVE | FILE_SUPPORT_RGB | FILE_SUPPORT_RGBA |
            FILE_SUPPORT_GRAY | FILE_SUPPORT_GRAYA | FILE_SUPPORT_INDEXED | FILE_SUPPORT_SEQUENCES |
-           FILE_SUPPORT_PALETTE_WITH_ALPHA | FILE_ENCODE_ABSTRACT_IMAGE;
+           FILE_SUPPORT_PALETTE_WITH_ALPHA | FILE_ENCODE_ABSTRACT_IMAGE |
+           FILE_ENCODE_SCANLINE_BANDS;
   }
 
   bool onLoad(FileOp* fop) override;
@@ -488,7 +492,7 @@ bool PngFormat::onSave(FileOp* fop)
 {
   png_infop info;
   png_colorp palette = nullptr;
-  png_bytep row_pointer;
+  png_bytep rows_buffer;
   int color_type = 0;
 
   FileHandle handle(open_file_with_exception_sync_on_close(fop->filename(), "wb"));
@@ -572,6 +576,11 @@ bool PngFormat::onSave(FileOp* fop)
     png_set_unknown_chunks(png, info, &unknowns[0], num_unknowns);
   }
 
+  // Trade compression ratio for encoding speed if it was requested
+  // for this file (e.g. when saving big sprite sheets).
+  if (opts && opts->compressionLevel() >= 0)
+    png_set_compression_level(png, opts->compressionLevel());
+
   if (fop->preserveColorProfile() && spec.colorSpace()) {
     saveColorSpace(png, info, spec.colorSpace().get());
   }
@@ -625,12 +634,12 @@ bool PngFormat::onSave(FileOp* fop)
   png_write_info(png, info);
   png_set_packing(png);
 
-  row_pointer = (png_bytep)png_malloc(png, png_get_rowbytes(png, info));
-
-  for (png_uint_32 y = 0; y < height; ++y) {
-    uint8_t* dst_address = row_pointer;
+  const int out_color_type = png_get_color_type(png, info);
 
-    if (png_get_color_type(png, info) == PNG_COLOR_TYPE_RGB_ALPHA) {
+  // Converts one of our scanlines to one PNG row. Doesn't touch the
+  // png struct so it can run in any thread.
+  const auto convert_row = [&](const png_uint_32 y, uint8_t* dst_address) {
+    if (out_color_type == PNG_COLOR_TYPE_RGB_ALPHA) {
       unsigned int x, c, a;
       bool opaque = true;
 
@@ -681,7 +690,7 @@ bool PngFormat::onSave(FileOp* fop)
         }
       }
     }
-    else if (png_get_color_type(png, info) == PNG_COLOR_TYPE_RGB) {
+    else if (out_color_type == PNG_COLOR_TYPE_RGB) {
       auto src_address = (const uint32_t*)img->getScanline(y);
       unsigned int x, c;
 
@@ -692,7 +701,7 @@ bool PngFormat::onSave(FileOp* fop)
         *(dst_address++) = rgba_getb(c);
       }
     }
-    else if (png_get_color_type(png, info) == PNG_COLOR_TYPE_GRAY_ALPHA) {
+    else if (out_color_type == PNG_COLOR_TYPE_GRAY_ALPHA) {
       auto src_address = (const uint16_t*)img->getScanline(y);
       unsigned int x, c, a;
       bool opaque = true;
@@ -712,7 +721,7 @@ bool PngFormat::onSave(FileOp* fop)
         *(dst_address++) = a;
       }
     }
-    else if (png_get_color_type(png, info) == PNG_COLOR_TYPE_GRAY) {
+    else if (out_color_type == PNG_COLOR_TYPE_GRAY) {
       auto src_address = (const uint16_t*)img->getScanline(y);
       unsigned int x, c;
 
@@ -721,20 +730,41 @@ bool PngFormat::onSave(FileOp* fop)
         *(dst_address++) = graya_getv(c);
       }
     }
-    else if (png_get_color_type(png, info) == PNG_COLOR_TYPE_PALETTE) {
+    else if (out_color_type == PNG_COLOR_TYPE_PALETTE) {
       auto src_address = (const uint8_t*)img->getScanline(y);
       unsigned int x;
 
       for (x = 0; x < width; ++x)
         *(dst_address++) = *(src_address++);
     }
+  };
+
+  // Convert scanlines to PNG rows in parallel bands, streaming each
+  // band to libpng (which compresses single-threaded). The band is
+  // kept small so the temporary buffer stays cheap even for huge
+  // sprite sheets. The buffer belongs to the FileOp, so all the
+  // frames of a saved sequence reuse the same allocation.
+  const size_t rowbytes = png_get_rowbytes(png, info);
+  const png_uint_32 bandHeight = std::min<png_uint_32>(height, 256);
+
+  rows_buffer = (png_bytep)fop->sequenceEncodeBuffer(bandHeight * rowbytes).data();
+  std::vector<png_bytep> rows(bandHeight);
+
+  for (png_uint_32 y = 0; y < height; y += bandHeight) {
+    const png_uint_32 bandRows = std::min(bandHeight, height - y);
+
+    JobScheduler::instance()->forkJoinBands(0, int(bandRows), [&](int from, int to) {
+      for (int i = from; i < to; ++i)
+        convert_row(y + i, rows_buffer + i * rowbytes);
+    });
 
-    png_write_rows(png, &row_pointer, 1);
+    for (png_uint_32 i = 0; i < bandRows; ++i)
+      rows[i] = rows_buffer + i * rowbytes;
+    png_write_rows(png, rows.data(), bandRows);
 
-    fop->setProgress((double)(y + 1) / (double)(height));
+    fop->setProgress((double)(y + bandRows) / (double)(height));
   }
 
-  png_free(png, row_pointer);
   png_write_end(png, info);
 
   if (spec.colorMode() == ColorMode::INDEXED) {
@@ -33,8 +33,15 @@ public:
 
   const Chunks& chunks() const { return m_userChunks; }
 
+  // Zlib compression level (0-9) used to encode the file, or -1 to
+  // keep the libpng default. Lower levels trade file size for
+  // encoding speed (useful when saving big sprite sheets).
+  void setCompressionLevel(const int level) { m_compressionLevel = level; }
+  int compressionLevel() const { return m_compressionLevel; }
+
 private:
   Chunks m_userChunks;
+  int m_compressionLevel = -1;
 };
 
 } // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2021  Igara Studio S.A.
+// Copyright (C) 2021-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -15,6 +15,8 @@
 #include "doc/sprite.h"
 #include "psd/psd.h"
 
+#include <algorithm>
+
 namespace app {
 
 doc::PixelFormat psd_cmode_to_ase_format(const psd::ColorMode mode)
@@ -267,54 +269,61 @@ public:
       return;
 
     const int dataCount = bytes / (img.depth >= 8 ? (img.depth / 8) : 1);
+    const int w = std::min(dataCount, m_currentImage->width());
     uint8_t* dstGenericAddress = m_currentImage->getPixelAddress(0, y);
 
     if (m_pixelFormat == doc::PixelFormat::IMAGE_INDEXED) {
       IndexedTraits::address_t dstAddress = (IndexedTraits::address_t)dstGenericAddress;
-      for (int x = 0; x < dataCount && x < m_currentImage->width(); ++x) {
+      for (int x = 0; x < w; ++x) {
         *(dstAddress)++ = getNormalizedPixelValue(data, img.depth);
       }
     }
     else if (m_pixelFormat == doc::PixelFormat::IMAGE_GRAYSCALE) {
+      // Resolve the destination component of this channel once per
+      // scanline instead of once per pixel.
+      int shift;
+      if (chanID == psd::ChannelID::Red)
+        shift = graya_v_shift;
+      else if (chanID == psd::ChannelID::Alpha || chanID == psd::ChannelID::TransparencyMask)
+        shift = graya_a_shift;
+      else
+        return;
+
+      const auto chanMask = GrayscaleTraits::pixel_t(0xff) << shift;
+      // Layers without an alpha channel are forced to be opaque.
+      const auto opaque = (m_layerHasTransparentChannel || shift == graya_a_shift ?
+                             0 :
+                             GrayscaleTraits::pixel_t(255) << graya_a_shift);
+
       GrayscaleTraits::address_t dstAddress = (GrayscaleTraits::address_t)dstGenericAddress;
-      uint8_t v = 0, a = 0;
-      for (int x = 0; x < dataCount && x < m_currentImage->width(); ++x) {
-        const GrayscaleTraits::pixel_t pixel = *dstAddress;
+      for (int x = 0; x < w; ++x, ++dstAddress) {
         const uint8_t newPixelValue = getNormalizedPixelValue(data, img.depth);
-        if (chanID == psd::ChannelID::Red) {
-          v = newPixelValue;
-          a = m_layerHasTransparentChannel ? graya_geta(pixel) : 255;
-        }
-        else if (chanID == psd::ChannelID::Alpha || chanID == psd::ChannelID::TransparencyMask) {
-          a = newPixelValue;
-          v = graya_getv(pixel);
-        }
-        *(dstAddress++) = graya(v, a);
+        *dstAddress = (*dstAddress & ~chanMask) |
+                      (GrayscaleTraits::pixel_t(newPixelValue) << shift) | opaque;
       }
     }
     else if (m_pixelFormat == doc::PixelFormat::IMAGE_RGB) {
+      int shift;
+      switch (chanID) {
+        case psd::ChannelID::Red:   shift = rgba_r_shift; break;
+        case psd::ChannelID::Green: shift = rgba_g_shift; break;
+        case psd::ChannelID::Blue:  shift = rgba_b_shift; break;
+        case psd::ChannelID::Alpha:
+        case psd::ChannelID::TransparencyMask:
+          shift = rgba_a_shift;
+          break;
+        default: return;
+      }
+
+      const color_t chanMask = color_t(0xff) << shift;
+      const color_t opaque = (m_layerHasTransparentChannel || shift == rgba_a_shift ?
+                                0 :
+                                color_t(255) << rgba_a_shift);
+
       RgbTraits::address_t dstAddress = (RgbTraits::address_t)dstGenericAddress;
-      uint8_t r, g, b, a;
-      for (int x = 0; x < dataCount && x < m_currentImage->width(); ++x) {
+      for (int x = 0; x < w; ++x, ++dstAddress) {
         const uint8_t newPixelValue = getNormalizedPixelValue(data, img.depth);
-        const color_t c = *(dstAddress);
-        r = rgba_getr(c);
-        g = rgba_getg(c);
-        b = rgba_getb(c);
-        a = m_layerHasTransparentChannel ? rgba_geta(c) : 255;
-        if (chanID == psd::ChannelID::Red) {
-          r = newPixelValue;
-        }
-        else if (chanID == psd::ChannelID::Green) {
-          g = newPixelValue;
-        }
-        else if (chanID == psd::ChannelID::Blue) {
-          b = newPixelValue;
-        }
-        else if (chanID == psd::ChannelID::Alpha || chanID == psd::ChannelID::TransparencyMask) {
-          a = newPixelValue;
-        }
-        *(dstAddress++) = rgba(r, g, b, a);
+        *dstAddress = (*dstAddress & ~chanMask) | (color_t(newPixelValue) << shift) | opaque;
       }
     }
   }
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2023  Igara Studio S.A.
+// Copyright (C) 2023-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -10,7 +10,14 @@
 
 #include "app/file/file.h"
 #include "app/file/file_format.h"
+#include "app/file/qoi_options.h"
+#include "app/util/tuning.h"
 #include "base/file_handle.h"
+#include "base/thread_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 #define QOI_NO_STDIO
 #define QOI_IMPLEMENTATION
@@ -20,6 +27,72 @@ namespace app {
 
 using namespace base;
 
+namespace {
+
+// Striped QOI variant: after the regular header each horizontal
+// stripe is encoded as an independent QOI stream (fresh encoder
+// state), followed by the standard end padding and a footer with the
+// byte-length of each stripe:
+//
+//   u32le lengths[nstripes], u32le rowsPerStripe, u32le nstripes, "qoiS"
+//
+// As the stripes don't share encoder state they can be encoded and
+// decoded in parallel. Only stripe 0 is decodable by standard QOI
+// readers, so this mode is opt-in (QoiOptions::striped()) and meant
+// for fast intermediate saves.
+const char kStripeMagic[4] = { 'q', 'o', 'i', 'S' };
+const int kMinRowsPerStripe = 64;
+
+void push32le(std::vector<uint8_t>& v, const uint32_t x)
+{
+  v.push_back(x & 0xff);
+  v.push_back((x >> 8) & 0xff);
+  v.push_back((x >> 16) & 0xff);
+  v.push_back((x >> 24) & 0xff);
+}
+
+uint32_t read32le(const uint8_t* p)
+{
+  return (uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) |
+          (uint32_t(p[3]) << 24));
+}
+
+uint32_t read32be(const uint8_t* p)
+{
+  return (uint32_t(p[3]) | (uint32_t(p[2]) << 8) | (uint32_t(p[1]) << 16) |
+          (uint32_t(p[0]) << 24));
+}
+
+// Copies decoded RGB/RGBA bytes into "rows" rows of the image
+// starting at row y0.
+void copy_pixels_to_image(doc::Image* image,
+                          const int y0,
+                          const int rows,
+                          const int width,
+                          const int channels,
+                          const uint8_t* src)
+{
+  for (int y = y0; y < y0 + rows; ++y) {
+    auto dst = (uint32_t*)image->getPixelAddress(0, y);
+    switch (channels) {
+      case 4:
+        for (int x = 0; x < width; ++x, ++dst) {
+          *dst = doc::rgba(src[0], src[1], src[2], src[3]);
+          src += 4;
+        }
+        break;
+      case 3:
+        for (int x = 0; x < width; ++x, ++dst) {
+          *dst = doc::rgba(src[0], src[1], src[2], 255);
+          src += 3;
+        }
+        break;
+    }
+  }
+}
+
+} // anonymous namespace
+
 class QoiFormat : public FileFormat {
   const char* onGetName() const override { return "qoi"; }
 
@@ -61,35 +134,114 @@ bool QoiFormat::onLoad(FileOp* fop)
 
   qoi_desc desc;
   auto bytes_read = fread(data, 1, size, f);
-  auto pixels = qoi_decode(data, bytes_read, &desc, 0);
-  QOI_FREE(data);
-  if (!pixels)
-    return false;
+  const auto* bytes = (const uint8_t*)data;
+
+  // Striped variant? (see kStripeMagic comment above)
+  const long minStripedSize = QOI_HEADER_SIZE + (long)sizeof(qoi_padding) + 12;
+  if ((long)bytes_read > minStripedSize &&
+      std::memcmp(bytes + bytes_read - 4, kStripeMagic, 4) == 0) {
+    const uint32_t nstripes = read32le(bytes + bytes_read - 8);
+    const uint32_t rowsPerStripe = read32le(bytes + bytes_read - 12);
+
+    desc.width = read32be(bytes + 4);
+    desc.height = read32be(bytes + 8);
+    desc.channels = bytes[12];
+    desc.colorspace = bytes[13];
+
+    if (std::memcmp(bytes, "qoif", 4) != 0 || desc.width == 0 || desc.height == 0 ||
+        (desc.channels != 3 && desc.channels != 4) || nstripes == 0 || rowsPerStripe == 0 ||
+        uint64_t(nstripes) * rowsPerStripe < desc.height ||
+        uint64_t(nstripes - 1) * rowsPerStripe >= desc.height ||
+        (long)bytes_read < minStripedSize + 4 * (long)nstripes) {
+      QOI_FREE(data);
+      return false;
+    }
 
-  ImageRef image = fop->sequenceImageToLoad(IMAGE_RGB, desc.width, desc.height);
-  if (!image)
-    return false;
+    const uint8_t* lengths = bytes + bytes_read - 12 - 4 * std::size_t(nstripes);
+    std::vector<std::size_t> offsets(nstripes);
+    std::size_t offset = QOI_HEADER_SIZE;
+    for (uint32_t i = 0; i < nstripes; ++i) {
+      offsets[i] = offset;
+      offset += read32le(lengths + 4 * i);
+    }
+    if (offset + sizeof(qoi_padding) + 12 + 4 * std::size_t(nstripes) != bytes_read) {
+      QOI_FREE(data);
+      return false;
+    }
 
-  auto src = (const uint8_t*)pixels;
-  for (int y = 0; y < desc.height; ++y) {
-    auto dst = (uint32_t*)image->getPixelAddress(0, y);
-    switch (desc.channels) {
-      case 4:
-        for (int x = 0; x < desc.width; ++x, ++dst) {
-          *dst = doc::rgba(src[0], src[1], src[2], src[3]);
-          src += 4;
-        }
-        break;
-      case 3:
-        for (int x = 0; x < desc.width; ++x, ++dst) {
-          *dst = doc::rgba(src[0], src[1], src[2], 255);
-          src += 3;
+    ImageRef image = fop->sequenceImageToLoad(IMAGE_RGB, desc.width, desc.height);
+    if (!image) {
+      QOI_FREE(data);
+      return false;
+    }
+
+    // Decode all the stripes in parallel, each one is an independent
+    // QOI stream (we re-add a header/padding per stripe to decode it
+    // with the regular qoi_decode()).
+    static base::thread_pool pool(tuned_worker_count());
+    std::vector<uint8_t> ok(nstripes, 0);
+    for (uint32_t i = 0; i < nstripes; ++i) {
+      pool.execute([&, i] {
+        const int rows = std::min<int>(rowsPerStripe, desc.height - i * rowsPerStripe);
+        const std::size_t len = read32le(lengths + 4 * i);
+
+        std::vector<uint8_t> buf(QOI_HEADER_SIZE + len + sizeof(qoi_padding));
+        std::memcpy(&buf[0], bytes, QOI_HEADER_SIZE);
+        buf[8] = (rows >> 24) & 0xff; // Patch the height (big-endian)
+        buf[9] = (rows >> 16) & 0xff;
+        buf[10] = (rows >> 8) & 0xff;
+        buf[11] = rows & 0xff;
+        std::memcpy(&buf[QOI_HEADER_SIZE], bytes + offsets[i], len);
+        std::memcpy(&buf[QOI_HEADER_SIZE + len], qoi_padding, sizeof(qoi_padding));
+
+        qoi_desc sdesc;
+        auto pixels = qoi_decode(&buf[0], int(buf.size()), &sdesc, 0);
+        if (pixels && sdesc.width == desc.width && sdesc.height == uint32_t(rows)) {
+          copy_pixels_to_image(image.get(),
+                               i * rowsPerStripe,
+                               rows,
+                               desc.width,
+                               sdesc.channels,
+                               (const uint8_t*)pixels);
+          ok[i] = 1;
         }
-        break;
+        if (pixels)
+          QOI_FREE(pixels);
+      });
     }
+    pool.wait_all();
+    QOI_FREE(data);
+
+    for (uint32_t i = 0; i < nstripes; ++i) {
+      if (!ok[i])
+        return false;
+    }
+
+    // Keep the striped mode if the file is saved again.
+    auto opts = std::make_shared<QoiOptions>();
+    opts->striped(true);
+    fop->setLoadedFormatOptions(opts);
   }
+  else {
+    auto pixels = qoi_decode(data, bytes_read, &desc, 0);
+    QOI_FREE(data);
+    if (!pixels)
+      return false;
+
+    ImageRef image = fop->sequenceImageToLoad(IMAGE_RGB, desc.width, desc.height);
+    if (!image) {
+      QOI_FREE(pixels);
+      return false;
+    }
 
-  QOI_FREE(pixels);
+    copy_pixels_to_image(image.get(),
+                         0,
+                         desc.height,
+                         desc.width,
+                         desc.channels,
+                         (const uint8_t*)pixels);
+    QOI_FREE(pixels);
+  }
 
   if (desc.channels == 4)
     fop->sequenceSetHasAlpha(true);
@@ -167,15 +319,81 @@ bool QoiFormat::onSave(FileOp* fop)
     }
   }
 
-  int size = 0;
-  auto encoded = qoi_encode(pixels, &desc, &size);
+  const auto opts = fop->formatOptionsForSaving<QoiOptions>();
+  bool ok = true;
+
+  if (opts->striped() && int(desc.height) >= 2 * kMinRowsPerStripe) {
+    // Encode independent stripes in parallel and stitch them with an
+    // index footer (see kStripeMagic comment above).
+    static base::thread_pool pool(tuned_worker_count());
+    const int h = desc.height;
+    const int wanted = std::clamp(h / kMinRowsPerStripe, 2, 4 * tuned_worker_count());
+    const int rowsPerStripe = (h + wanted - 1) / wanted;
+    const int nstripes = (h + rowsPerStripe - 1) / rowsPerStripe;
+    const std::size_t stride = std::size_t(desc.width) * desc.channels;
+
+    struct Stripe {
+      void* data = nullptr;
+      int len = 0;
+    };
+    std::vector<Stripe> stripes(nstripes);
+    for (int i = 0; i < nstripes; ++i) {
+      pool.execute([&, i] {
+        qoi_desc sdesc = desc;
+        sdesc.height = std::min(rowsPerStripe, h - i * rowsPerStripe);
+        stripes[i].data = qoi_encode(pixels + std::size_t(i) * rowsPerStripe * stride,
+                                     &sdesc,
+                                     &stripes[i].len);
+      });
+    }
+    pool.wait_all();
+
+    const int overhead = QOI_HEADER_SIZE + int(sizeof(qoi_padding));
+    for (const Stripe& s : stripes)
+      ok = (ok && s.data && s.len > overhead);
+
+    if (ok) {
+      uint8_t header[QOI_HEADER_SIZE];
+      std::memcpy(header, stripes[0].data, QOI_HEADER_SIZE);
+      header[8] = (h >> 24) & 0xff; // Restore the full image height (big-endian)
+      header[9] = (h >> 16) & 0xff;
+      header[10] = (h >> 8) & 0xff;
+      header[11] = h & 0xff;
+      fwrite(header, 1, QOI_HEADER_SIZE, f);
+
+      std::vector<uint8_t> footer;
+      for (const Stripe& s : stripes) {
+        const int len = s.len - overhead;
+        fwrite((const uint8_t*)s.data + QOI_HEADER_SIZE, 1, len, f);
+        push32le(footer, len);
+      }
+      fwrite(qoi_padding, 1, sizeof(qoi_padding), f);
+      push32le(footer, rowsPerStripe);
+      push32le(footer, nstripes);
+      footer.insert(footer.end(), kStripeMagic, kStripeMagic + 4);
+      fwrite(&footer[0], 1, footer.size(), f);
+    }
+
+    for (Stripe& s : stripes) {
+      if (s.data)
+        QOI_FREE(s.data);
+    }
+  }
+  else {
+    int size = 0;
+    auto encoded = qoi_encode(pixels, &desc, &size);
+    if (encoded) {
+      fwrite(encoded, 1, size, f);
+      QOI_FREE(encoded);
+    }
+    else
+      ok = false;
+  }
+
   QOI_FREE(pixels);
-  if (!encoded)
+  if (!ok)
     return false;
 
-  fwrite(encoded, 1, size, f);
-  QOI_FREE(encoded);
-
   if (ferror(handle.get())) {
     fop->setError("Error writing file.\n");
     return false;
@@ -0,0 +1,32 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_FILE_QOI_OPTIONS_H_INCLUDED
+#define APP_FILE_QOI_OPTIONS_H_INCLUDED
+#pragma once
+
+#include "app/file/format_options.h"
+
+namespace app {
+
+// Data for QOI files
+class QoiOptions : public FormatOptions {
+public:
+  // True to encode the image as independent horizontal stripes (in
+  // parallel) with a stripe index appended after the regular QOI
+  // stream. Striped files load/save several times faster on big
+  // canvases but can only be fully decoded by Aseprite, so the
+  // whole-image mode is the default.
+  bool striped() const { return m_striped; }
+  void striped(bool state) { m_striped = state; }
+
+private:
+  bool m_striped = false;
+};
+
+} // namespace app
+
+#endif
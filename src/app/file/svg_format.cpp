@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (c) 2018-2023  Igara Studio S.A.
+// Copyright (c) 2018-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -19,6 +19,7 @@
 #include "base/cfile.h"
 #include "base/file_handle.h"
 #include "doc/doc.h"
+#include "fmt/format.h"
 #include "ui/window.h"
 
 #include "svg_options.xml.h"
@@ -76,83 +77,106 @@ bool SvgFormat::onSave(FileOp* fop)
   FileHandle handle(open_file_with_exception_sync_on_close(fop->filename(), "wb"));
   FILE* f = handle.get();
 
-  auto printRect =
-    [f](int x, int y, int width, int height, int r, int g, int b, int a, int pxScale) {
-      fprintf(f,
-              "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"#%02X%02X%02X\" ",
-              x * pxScale,
-              y * pxScale,
-              width * pxScale,
-              height * pxScale,
-              r,
-              g,
-              b);
-      if (a != 255)
-        fprintf(f, "opacity=\"%f\" ", (float)a / 255.0);
-      fprintf(f, "/>\n");
-    };
-
-  // Helper function for greedy merge of same-colored pixels
+  // One same-color horizontal run of pixels, i.e. a pending <rect>
+  // that can still grow vertically while the next rows repeat exactly
+  // the same span with the same color.
+  struct Run {
+    int x, y, w, h;
+    int r, g, b, a;
+  };
+
+  // Rects are accumulated in this buffer and written in big chunks
+  // (one fwrite() per rect or attribute was the main cost for big
+  // images).
+  std::string buf;
+  buf.reserve(64 * 1024);
+
+  auto flushBuffer = [&] {
+    if (!buf.empty()) {
+      fwrite(buf.data(), 1, buf.size(), f);
+      buf.clear();
+    }
+  };
+
+  auto printRect = [&](const Run& rc) {
+    buf += fmt::format("<rect x=\"{}\" y=\"{}\" width=\"{}\" height=\"{}\" "
+                       "fill=\"#{:02X}{:02X}{:02X}\" ",
+                       rc.x * pixelScaleValue,
+                       rc.y * pixelScaleValue,
+                       rc.w * pixelScaleValue,
+                       rc.h * pixelScaleValue,
+                       rc.r,
+                       rc.g,
+                       rc.b);
+    if (rc.a != 255)
+      buf += fmt::format("opacity=\"{:f}\" ", rc.a / 255.0);
+    buf += "/>\n";
+    if (buf.size() >= 64 * 1024)
+      flushBuffer();
+  };
+
+  // Merges same-colored pixels in one streaming pass: each row is
+  // run-length encoded, and a run that repeats the exact span/color
+  // of a rectangle still growing from the previous rows extends it
+  // one row down, otherwise the rectangle is emitted. O(pixels) time
+  // and O(row) memory.
   auto mergePixels = [&](auto getPixelColor) {
-    std::vector<std::vector<bool>> processed(image->height(),
-                                             std::vector<bool>(image->width(), false));
+    std::vector<Run> active; // Rectangles that can still grow (sorted by x)
+    std::vector<Run> runs;   // Runs of the row being scanned
+    std::vector<Run> next;
 
     for (y = 0; y < image->height(); y++) {
-      for (x = 0; x < image->width(); x++) {
-        if (processed[y][x])
-          continue;
-
+      // Run-length encode this row
+      runs.clear();
+      for (x = 0; x < image->width();) {
         auto [pixelR, pixelG, pixelB, pixelA, shouldSkip] = getPixelColor(x, y);
         if (shouldSkip) {
-          processed[y][x] = true;
+          x++;
           continue;
         }
 
-        // Find the largest rectangle starting from this pixel
-        int maxWidth = 0;
-        int maxHeight = 0;
-
-        // Find maximum width for current row
-        for (int w = x; w < image->width(); w++) {
-          if (processed[y][w])
-            break;
-          auto [checkR, checkG, checkB, checkA, skip] = getPixelColor(w, y);
-          if (skip || checkR != pixelR || checkG != pixelG || checkB != pixelB || checkA != pixelA)
+        int x2 = x + 1;
+        for (; x2 < image->width(); x2++) {
+          auto [checkR, checkG, checkB, checkA, skip] = getPixelColor(x2, y);
+          if (skip || checkR != pixelR || checkG != pixelG || checkB != pixelB ||
+              checkA != pixelA)
             break;
-          maxWidth = w - x + 1;
         }
 
-        // Find maximum height with current width
-        for (int h = y; h < image->height(); h++) {
-          bool canExtend = true;
-          for (int w = x; w < x + maxWidth; w++) {
-            if (processed[h][w]) {
-              canExtend = false;
-              break;
-            }
-            auto [checkR, checkG, checkB, checkA, skip] = getPixelColor(w, h);
-            if (skip || checkR != pixelR || checkG != pixelG || checkB != pixelB ||
-                checkA != pixelA) {
-              canExtend = false;
-              break;
-            }
-          }
-          if (!canExtend)
-            break;
-          maxHeight = h - y + 1;
-        }
+        runs.push_back(Run{ x, y, x2 - x, 1, pixelR, pixelG, pixelB, pixelA });
+        x = x2;
+      }
 
-        // Mark rectangle as processed and output it
-        for (int h = y; h < y + maxHeight; h++) {
-          for (int w = x; w < x + maxWidth; w++) {
-            processed[h][w] = true;
+      // Grow or emit the active rectangles (both lists are sorted by
+      // x and runs don't overlap, so one left-to-right walk is enough)
+      next.clear();
+      size_t i = 0;
+      for (const Run& run : runs) {
+        while (i < active.size() && active[i].x < run.x)
+          printRect(active[i++]);
+
+        if (i < active.size() && active[i].x == run.x) {
+          Run& rc = active[i++];
+          if (rc.w == run.w && rc.r == run.r && rc.g == run.g && rc.b == run.b &&
+              rc.a == run.a) {
+            rc.h++;
+            next.push_back(rc);
+            continue;
           }
+          printRect(rc);
         }
-
-        printRect(x, y, maxWidth, maxHeight, pixelR, pixelG, pixelB, pixelA, pixelScaleValue);
+        next.push_back(run);
       }
+      while (i < active.size())
+        printRect(active[i++]);
+
+      active.swap(next);
       fop->setProgress((float)y / (float)(image->height()));
     }
+
+    // Rectangles that reached the last row
+    for (const Run& rc : active)
+      printRect(rc);
   };
 
   fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
@@ -216,6 +240,7 @@ bool SvgFormat::onSave(FileOp* fop)
       break;
     }
   }
+  flushBuffer();
   fprintf(f, "</svg>");
   if (ferror(f)) {
     fop->setError("Error writing file.\n");
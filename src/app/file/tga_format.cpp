@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2023  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -65,12 +65,19 @@ public:
   TgaDelegate(FileOp* fop) : m_fop(fop) {}
   bool notifyProgress(double progress) override
   {
-    m_fop->setProgress(progress);
+    // The decoder notifies progress one time per row, batch the
+    // updates (FileOp::setProgress() locks a mutex and one lock per
+    // row is noticeable on big images).
+    if (progress - m_lastProgress >= 1.0 / 128.0 || progress >= 1.0) {
+      m_fop->setProgress(progress);
+      m_lastProgress = progress;
+    }
     return !m_fop->isStop();
   }
 
 private:
   FileOp* m_fop;
+  double m_lastProgress = 0.0;
 };
 
 bool get_image_spec(const tga::Header& header, ImageSpec& spec)
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2023  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2015-2018  David Capello
 // Copyright (C) 2015  Gabriel Rauter
 //
@@ -19,6 +19,7 @@
 #include "app/file/format_options.h"
 #include "app/file/webp_options.h"
 #include "app/ini_file.h"
+#include "app/job_scheduler.h"
 #include "app/pref/preferences.h"
 #include "base/convert_to.h"
 #include "base/file_handle.h"
@@ -278,9 +279,16 @@ bool WebPFormat::onSave(FileOp* fop)
         fop->setError("Error in WebP configuration preset\n");
         return false;
       }
+      // Speed/quality trade-off (batch exports can use lower values
+      // to favor the encoding speed).
+      config.method = opts->speed();
       break;
   }
 
+  // Let libwebp split the encoding of each frame between several
+  // threads.
+  config.thread_level = 1;
+
   WebPAnimEncoderOptions enc_options;
   WebPAnimEncoderOptionsInit(&enc_options);
   enc_options.anim_params.loop_count = (opts->loop() ? 0 : // 0 = infinite
@@ -308,18 +316,21 @@ bool WebPFormat::onSave(FileOp* fop)
     sprite->renderFrame(frame, fop->roi().frameBounds(frame), image.get());
 
     // Switch R <-> B channels because WebPAnimEncoderAssemble()
-    // expects MODE_BGRA pictures.
-    {
-      LockImageBits<RgbTraits> bits(image.get(), Image::ReadWriteLock);
-      auto it = bits.begin(), end = bits.end();
-      for (; it != end; ++it) {
-        auto c = *it;
-        *it = rgba(rgba_getb(c), // Use blue in red channel
-                   rgba_getg(c),
-                   rgba_getr(c), // Use red in blue channel
-                   rgba_geta(c));
+    // expects MODE_BGRA pictures. This conversion runs once per
+    // frame over the whole canvas, so it's done in parallel row
+    // bands.
+    JobScheduler::instance()->forkJoinBands(0, h, [&image, w](int y0, int y1) {
+      for (int y = y0; y < y1; ++y) {
+        auto* row = (uint32_t*)image->getPixelAddress(0, y);
+        for (int x = 0; x < w; ++x) {
+          const auto c = row[x];
+          row[x] = rgba(rgba_getb(c), // Use blue in red channel
+                        rgba_getg(c),
+                        rgba_getr(c), // Use red in blue channel
+                        rgba_geta(c));
+        }
       }
-    }
+    });
 
     if (!WebPAnimEncoderAdd(enc, &pic, timestamp_ms, &config)) {
       if (!fop->isStop()) {
@@ -377,6 +388,8 @@ FormatOptionsPtr WebPFormat::onAskUserForFormatOptions(FileOp* fop)
             opts->setQuality(pref.webp.quality());
           if (pref.isSet(pref.webp.imagePreset))
             opts->setImagePreset(WebPPreset(pref.webp.imagePreset()));
+          if (pref.isSet(pref.webp.speed))
+            opts->setSpeed(pref.webp.speed());
           break;
       }
 
@@ -404,6 +417,7 @@ FormatOptionsPtr WebPFormat::onAskUserForFormatOptions(FileOp* fop)
         win.imageHint()->setSelectedItemIndex(opts->imageHint());
         win.quality()->setValue(static_cast<int>(opts->quality()));
         win.imagePreset()->setSelectedItemIndex(opts->imagePreset());
+        win.speed()->setValue(opts->speed());
 
         updatePanels();
         win.type()->Change.connect(updatePanels);
@@ -417,6 +431,7 @@ FormatOptionsPtr WebPFormat::onAskUserForFormatOptions(FileOp* fop)
           pref.webp.imageHint(base::convert_to<int>(win.imageHint()->getValue()));
           pref.webp.quality(win.quality()->getValue());
           pref.webp.imagePreset(base::convert_to<int>(win.imagePreset()->getValue()));
+          pref.webp.speed(win.speed()->getValue());
           pref.webp.showAlert(!win.dontShow()->isSelected());
 
           opts->setLoop(pref.webp.loop());
@@ -429,6 +444,7 @@ FormatOptionsPtr WebPFormat::onAskUserForFormatOptions(FileOp* fop)
             case WebPOptions::Lossy:
               opts->setQuality(pref.webp.quality());
               opts->setImagePreset(WebPPreset(pref.webp.imagePreset()));
+              opts->setSpeed(pref.webp.speed());
               break;
           }
         }
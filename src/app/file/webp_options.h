@@ -1,4 +1,5 @@
 // Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
 // Copyright (C) 2018  David Capello
 // Copyright (C) 2015  Gabriel Rauter
 //
@@ -11,6 +12,8 @@
 
 #include "app/file/format_options.h"
 
+#include <algorithm>
+
 #include <webp/decode.h>
 #include <webp/encode.h>
 
@@ -24,6 +27,9 @@ public:
   // By default we use 6, because 9 is too slow
   const int kDefaultCompression = 6;
 
+  // libwebp default speed/quality trade-off (WebPConfig::method)
+  const int kDefaultSpeed = 4;
+
   WebPOptions()
     : m_loop(true)
     , m_type(Type::Simple)
@@ -31,6 +37,7 @@ public:
     , m_imageHint(WEBP_HINT_DEFAULT)
     , m_quality(100)
     , m_imagePreset(WEBP_PRESET_DEFAULT)
+    , m_speed(kDefaultSpeed)
   {
   }
 
@@ -40,6 +47,7 @@ public:
   WebPImageHint imageHint() const { return m_imageHint; }
   int quality() const { return m_quality; }
   WebPPreset imagePreset() const { return m_imagePreset; }
+  int speed() const { return m_speed; }
 
   void setLoop(const bool loop) { m_loop = loop; }
 
@@ -77,6 +85,12 @@ public:
     m_imagePreset = imagePreset;
   }
 
+  void setSpeed(const int speed)
+  {
+    ASSERT(m_type == Type::Lossy);
+    m_speed = std::clamp(speed, 0, 6);
+  }
+
 private:
   bool m_loop;
   Type m_type;
@@ -86,6 +100,8 @@ private:
   // Lossy options
   int m_quality;            // Between 0 (smallest file) and 100 (biggest)
   WebPPreset m_imagePreset; // Image Preset for lossy webp.
+  int m_speed;              // Speed/quality trade-off (0=fastest, 6=slower-better),
+                            // lower values are useful for batch exports.
 };
 
 } // namespace app
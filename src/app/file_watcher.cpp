@@ -0,0 +1,131 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/file_watcher.h"
+
+#include "base/fs.h"
+#include "base/thread.h"
+#include "ui/system.h"
+
+#include <chrono>
+
+namespace app {
+
+namespace {
+
+// Time between two polls of the watched files. A stat per file per
+// second is cheap even with dozens of watched tilesets, and one
+// second of latency is fine for "the file changed on disk" events.
+const int kPollSeconds = 1;
+
+bool same_time(const base::Time& a, const base::Time& b)
+{
+  return (a.year == b.year && a.month == b.month && a.day == b.day && a.hour == b.hour &&
+          a.minute == b.minute && a.second == b.second);
+}
+
+} // anonymous namespace
+
+// static
+FileWatcher* FileWatcher::instance()
+{
+  static FileWatcher watcher;
+  return &watcher;
+}
+
+FileWatcher::~FileWatcher()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done = true;
+  }
+  m_wakeup.notify_one();
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+FileWatcher::WatchId FileWatcher::watch(const std::string& path, Callback callback)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  Item item;
+  item.id = m_nextId++;
+  item.path = path;
+  item.callback = std::move(callback);
+  try {
+    item.time = base::get_modification_time(path);
+    item.size = base::file_size(path);
+  }
+  catch (const std::exception&) {
+    // Missing file: the first time it appears will be reported as a
+    // change.
+  }
+  const WatchId id = item.id;
+  m_items.push_back(std::move(item));
+
+  if (!m_thread.joinable())
+    m_thread = std::thread([this] { backgroundThread(); });
+
+  return id;
+}
+
+void FileWatcher::unwatch(const WatchId id)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (auto it = m_items.begin(); it != m_items.end(); ++it) {
+    if (it->id == id) {
+      m_items.erase(it);
+      break;
+    }
+  }
+}
+
+void FileWatcher::backgroundThread()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  base::this_thread::set_name("file_watcher");
+
+  while (!m_done) {
+    m_wakeup.wait_for(lock, std::chrono::seconds(kPollSeconds));
+    if (m_done)
+      break;
+
+    for (Item& item : m_items) {
+      base::Time time;
+      size_t size = 0;
+      try {
+        time = base::get_modification_time(item.path);
+        size = base::file_size(item.path);
+      }
+      catch (const std::exception&) {
+        // The file is gone (or mid-replace); keep the last known
+        // state and wait for it to reappear.
+        continue;
+      }
+
+      if (!same_time(time, item.time) || size != item.size) {
+        // Still being written: record the new state and re-check in
+        // the next poll.
+        item.time = time;
+        item.size = size;
+        item.changing = true;
+      }
+      else if (item.changing) {
+        item.changing = false;
+
+        const std::string path = item.path;
+        const Callback callback = item.callback;
+        ui::execute_from_ui_thread([path, callback] { callback(path); });
+      }
+    }
+  }
+}
+
+} // namespace app
@@ -0,0 +1,71 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_FILE_WATCHER_H_INCLUDED
+#define APP_FILE_WATCHER_H_INCLUDED
+#pragma once
+
+#include "base/time.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace app {
+
+// Polls watched files for modifications from one background thread
+// and runs the registered callback in the UI thread when a file
+// changes. Events are coalesced: a file being written is reported
+// only once, after its mtime/size stop changing between two polls,
+// so a slow export from another program doesn't trigger several
+// partial reloads.
+//
+// Note that a callback that was already posted to the UI thread can
+// still run right after unwatch(), so callbacks must re-validate
+// whatever they reference.
+class FileWatcher {
+public:
+  typedef int WatchId;
+  typedef std::function<void(const std::string& path)> Callback;
+
+  static FileWatcher* instance();
+
+  ~FileWatcher();
+
+  // Starts watching the given file (the polling thread is created
+  // lazily with the first watch).
+  WatchId watch(const std::string& path, Callback callback);
+  void unwatch(const WatchId id);
+
+private:
+  struct Item {
+    WatchId id;
+    std::string path;
+    Callback callback;
+    base::Time time;
+    size_t size = 0;
+    // The file changed in the last poll and we're waiting for the
+    // mtime/size to settle before reporting the modification.
+    bool changing = false;
+  };
+
+  FileWatcher() {}
+  void backgroundThread();
+
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  std::vector<Item> m_items;
+  WatchId m_nextId = 1;
+  bool m_done = false;
+  std::thread m_thread;
+};
+
+} // namespace app
+
+#endif
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2025  Igara Studio S.A.
+// Copyright (C) 2025-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -12,10 +12,26 @@
 
 #include "app/fonts/font_data.h"
 #include "app/fonts/font_info.h"
+#include "app/resource_finder.h"
+#include "base/fs.h"
+#include "base/fstream_path.h"
 #include "text/font_mgr.h"
 
+#include <fstream>
+
 namespace app {
 
+namespace {
+
+std::string families_cache_filename()
+{
+  ResourceFinder rf;
+  rf.includeUserDir("fonts.cache");
+  return rf.getFirstOrCreateDefault();
+}
+
+} // namespace
+
 static Fonts* g_instance = nullptr;
 
 // static
@@ -95,4 +111,37 @@ text::FontRef Fonts::fontFromInfo(const FontInfo& fontInfo)
   return font;
 }
 
+std::vector<std::string> Fonts::cachedSystemFamilies()
+{
+  const std::lock_guard<std::mutex> lock(m_familiesMutex);
+  if (!m_familiesCacheLoaded) {
+    m_familiesCacheLoaded = true;
+
+    const std::string fn = families_cache_filename();
+    if (base::is_file(fn)) {
+      std::ifstream f(FSTREAM_PATH(fn));
+      std::string line;
+      while (std::getline(f, line)) {
+        if (!line.empty())
+          m_cachedFamilies.push_back(line);
+      }
+    }
+  }
+  return m_cachedFamilies;
+}
+
+void Fonts::saveSystemFamiliesCache(const std::vector<std::string>& names)
+{
+  const std::lock_guard<std::mutex> lock(m_familiesMutex);
+  if (m_familiesCacheLoaded && names == m_cachedFamilies)
+    return;
+
+  m_cachedFamilies = names;
+  m_familiesCacheLoaded = true;
+
+  std::ofstream f(FSTREAM_PATH(families_cache_filename()));
+  for (const std::string& name : names)
+    f << name << "\n";
+}
+
 } // namespace app
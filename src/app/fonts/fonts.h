@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2025  Igara Studio S.A.
+// Copyright (C) 2025-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -12,7 +12,9 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace app {
 
@@ -39,9 +41,22 @@ public:
   text::FontRef fontByName(const std::string& name, float size);
   text::FontRef fontFromInfo(const FontInfo& fontInfo);
 
+  // System font family names cached from a previous run (persisted
+  // in the user configuration directory), so the font popup can list
+  // them instantly while the real enumeration -- which can take
+  // seconds on machines with thousands of fonts -- runs in the
+  // background and reconciles the list.
+  std::vector<std::string> cachedSystemFamilies();
+  void saveSystemFamiliesCache(const std::vector<std::string>& names);
+
 private:
   text::FontMgrRef m_fontMgr;
   FontDataMap m_fonts;
+
+  // Loaded/saved from the UI thread and the font enumeration task.
+  std::mutex m_familiesMutex;
+  bool m_familiesCacheLoaded = false;
+  std::vector<std::string> m_cachedFamilies;
 };
 
 } // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2023-2024  Igara Studio S.A.
+// Copyright (C) 2023-2026  Igara Studio S.A.
 // Copyright (C) 2016-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -22,6 +22,7 @@
 #include "cfg/cfg.h"
 
 #include <algorithm>
+#include <cstring>
 
 namespace app {
 
@@ -29,6 +30,69 @@ static Strings* singleton = nullptr;
 
 const char* Strings::kDefLanguage = "en";
 
+void Strings::Catalog::clear()
+{
+  m_idArena.clear();
+  m_index.clear();
+  m_values.clear();
+}
+
+void Strings::Catalog::add(const std::string& id, std::string&& value)
+{
+  Entry entry;
+  entry.idOffset = uint32_t(m_idArena.size());
+  entry.valueIndex = uint32_t(m_values.size());
+  m_idArena.append(id);
+  m_idArena.push_back('\0');
+  m_index.push_back(entry);
+  m_values.push_back(std::move(value));
+}
+
+void Strings::Catalog::buildIndex()
+{
+  // Sort by ID, and if an ID was added twice (e.g. an extension
+  // overriding a string of the language file) the last added value
+  // wins.
+  std::stable_sort(m_index.begin(), m_index.end(), [this](const Entry& a, const Entry& b) {
+    return std::strcmp(&m_idArena[a.idOffset], &m_idArena[b.idOffset]) < 0;
+  });
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < m_index.size(); ++i) {
+    if (n > 0 &&
+        std::strcmp(&m_idArena[m_index[n - 1].idOffset], &m_idArena[m_index[i].idOffset]) == 0) {
+      m_index[n - 1] = m_index[i];
+    }
+    else {
+      m_index[n++] = m_index[i];
+    }
+  }
+  m_index.resize(n);
+
+  // Compact the value storage dropping overridden duplicates
+  std::vector<std::string> values;
+  values.reserve(m_index.size());
+  for (Entry& entry : m_index) {
+    values.push_back(std::move(m_values[entry.valueIndex]));
+    entry.valueIndex = uint32_t(values.size() - 1);
+  }
+  m_values.swap(values);
+  m_index.shrink_to_fit();
+  m_idArena.shrink_to_fit();
+}
+
+const std::string* Strings::Catalog::find(const char* id) const
+{
+  const auto it = std::lower_bound(m_index.begin(),
+                                   m_index.end(),
+                                   id,
+                                   [this](const Entry& entry, const char* id) {
+                                     return std::strcmp(&m_idArena[entry.idOffset], id) < 0;
+                                   });
+  if (it != m_index.end() && std::strcmp(&m_idArena[it->idOffset], id) == 0)
+    return &m_values[it->valueIndex];
+  return nullptr;
+}
+
 // static
 Strings* Strings::instance()
 {
@@ -152,17 +216,24 @@ std::string Strings::VFormat(const char* id, const fmt::format_args& vargs)
 
 void Strings::loadLanguage(const std::string& langId)
 {
-  m_strings.clear();
-  loadStringsFromDataDir(kDefLanguage);
-  m_default = m_strings;
+  m_default.clear();
+  m_overrides.clear();
+  m_untranslated.clear();
 
+  loadStringsFromDataDir(kDefLanguage, m_default);
+  m_default.buildIndex();
+
+  // The current language catalog keeps just the strings that differ
+  // from en.ini (i.e. for the default language we don't duplicate
+  // the whole English catalog).
   if (langId != kDefLanguage) {
-    loadStringsFromDataDir(langId);
-    loadStringsFromExtension(langId);
+    loadStringsFromDataDir(langId, m_overrides);
+    loadStringsFromExtension(langId, m_overrides);
   }
+  m_overrides.buildIndex();
 }
 
-void Strings::loadStringsFromDataDir(const std::string& langId)
+void Strings::loadStringsFromDataDir(const std::string& langId, Catalog& catalog)
 {
   // Load the English language file from the Aseprite data directory (so we have the most update
   // list of strings)
@@ -175,17 +246,17 @@ void Strings::loadStringsFromDataDir(const std::string& langId)
     return;
   }
   LOG("I18N: %s found\n", rf.filename().c_str());
-  loadStringsFromFile(rf.filename());
+  loadStringsFromFile(rf.filename(), catalog);
 }
 
-void Strings::loadStringsFromExtension(const std::string& langId)
+void Strings::loadStringsFromExtension(const std::string& langId, Catalog& catalog)
 {
   std::string fn = m_exts.languagePath(langId);
   if (!fn.empty() && base::is_file(fn))
-    loadStringsFromFile(fn);
+    loadStringsFromFile(fn, catalog);
 }
 
-void Strings::loadStringsFromFile(const std::string& fn)
+void Strings::loadStringsFromFile(const std::string& fn, Catalog& catalog)
 {
   cfg::CfgFile cfg;
   cfg.load(fn);
@@ -224,9 +295,9 @@ void Strings::loadStringsFromFile(const std::string& fn)
           ++i;
         }
       }
-      m_strings[textId] = value;
+      catalog.add(textId, std::move(value));
 
-      // TRACE("I18N: Reading string %s -> %s\n", textId.c_str(), m_strings[textId].c_str());
+      // TRACE("I18N: Reading string %s -> %s\n", textId.c_str(), value.c_str());
 
       textId.erase(section.size() + 1);
     }
@@ -235,18 +306,26 @@ void Strings::loadStringsFromFile(const std::string& fn)
 
 const std::string& Strings::translate(const char* id) const
 {
-  auto it = m_strings.find(id);
-  if (it != m_strings.end())
-    return it->second;
-  return m_strings[id] = id;
+  if (const std::string* value = m_overrides.find(id))
+    return *value;
+  if (const std::string* value = m_default.find(id))
+    return *value;
+  return untranslated(id);
 }
 
 const std::string& Strings::defaultString(const char* id) const
 {
-  auto it = m_default.find(id);
-  if (it != m_default.end())
+  if (const std::string* value = m_default.find(id))
+    return *value;
+  return untranslated(id);
+}
+
+const std::string& Strings::untranslated(const char* id) const
+{
+  auto it = m_untranslated.find(id);
+  if (it != m_untranslated.end())
     return it->second;
-  return m_default[id] = id;
+  return m_untranslated[id] = id;
 }
 
 } // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2023-2024  Igara Studio S.A.
+// Copyright (C) 2023-2026  Igara Studio S.A.
 // Copyright (C) 2016-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -14,9 +14,11 @@
 #include "obs/signal.h"
 #include "strings.ini.h"
 
+#include <cstdint>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace app {
 
@@ -63,15 +65,47 @@ public:
   obs::signal<void()> LanguageChange;
 
 private:
+  // Flat string catalog: all string IDs live contiguously in one
+  // arena and lookups are a binary search over the offset index, so
+  // translating a string costs zero allocations and there are no
+  // per-entry hash map nodes. Values are kept as individual
+  // std::string's because translate() returns stable references.
+  class Catalog {
+  public:
+    void clear();
+    void add(const std::string& id, std::string&& value);
+
+    // Sorts the index (must be called after the last add() and
+    // before the first find()), the last added value of each
+    // duplicated ID wins.
+    void buildIndex();
+
+    const std::string* find(const char* id) const;
+
+  private:
+    struct Entry {
+      uint32_t idOffset;
+      uint32_t valueIndex;
+    };
+
+    std::string m_idArena;      // All IDs, NUL-separated
+    std::vector<Entry> m_index; // Sorted by ID after buildIndex()
+    std::vector<std::string> m_values;
+  };
+
   void loadLanguage(const std::string& langId);
-  void loadStringsFromDataDir(const std::string& langId);
-  void loadStringsFromExtension(const std::string& langId);
-  void loadStringsFromFile(const std::string& fn);
+  void loadStringsFromDataDir(const std::string& langId, Catalog& catalog);
+  void loadStringsFromExtension(const std::string& langId, Catalog& catalog);
+  void loadStringsFromFile(const std::string& fn, Catalog& catalog);
+  const std::string& untranslated(const char* id) const;
 
   Preferences& m_pref;
   Extensions& m_exts;
-  mutable std::unordered_map<std::string, std::string> m_default; // Default strings from en.ini
-  mutable std::unordered_map<std::string, std::string> m_strings; // Strings from current language
+  Catalog m_default;   // Default strings from en.ini
+  Catalog m_overrides; // Strings overridden by the current language
+  // IDs without translation (returned as they are), cached so we can
+  // return a stable reference
+  mutable std::unordered_map<std::string, std::string> m_untranslated;
 };
 
 } // namespace app
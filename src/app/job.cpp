@@ -15,6 +15,7 @@
 #include "app/console.h"
 #include "app/context.h"
 #include "app/i18n/strings.h"
+#include "app/job_scheduler.h"
 #include "ui/alert.h"
 #include "ui/widget.h"
 #include "ui/window.h"
@@ -34,6 +35,7 @@ int Job::runningJobs()
 
 Job::Job(const std::string& jobName, const bool showProgress)
 {
+  m_running_flag = false;
   m_last_progress = 0.0;
   m_done_flag = false;
   m_canceled_flag = false;
@@ -60,7 +62,8 @@ Job::~Job()
 
 void Job::startJob()
 {
-  m_thread = std::thread(&Job::thread_proc, this);
+  m_running_flag = true;
+  JobScheduler::instance()->submitJob([this] { thread_proc(this); });
   ++g_runningJobs;
 
   if (m_alert_window) {
@@ -96,8 +99,10 @@ void Job::waitJob()
   if (m_timer && m_timer->isRunning())
     m_timer->stop();
 
-  if (m_thread.joinable()) {
-    m_thread.join();
+  if (m_running_flag) {
+    std::unique_lock<std::mutex> hold(m_mutex);
+    m_done_cond.wait(hold, [this] { return m_done_flag; });
+    m_running_flag = false;
 
     --g_runningJobs;
   }
@@ -131,6 +136,7 @@ void Job::done()
 {
   std::unique_lock<std::mutex> hold(m_mutex);
   m_done_flag = true;
+  m_done_cond.notify_all();
 }
 
 // Called to start the worker thread.
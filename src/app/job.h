@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2021-2024  Igara Studio S.A.
+// Copyright (C) 2021-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -13,10 +13,10 @@
 #include "ui/timer.h"
 
 #include <atomic>
+#include <condition_variable>
 #include <exception>
 #include <mutex>
 #include <string>
-#include <thread>
 
 namespace app {
 
@@ -46,8 +46,8 @@ public:
   bool isCanceled();
 
 protected:
-  // This member function is called from another dedicated thread
-  // outside the GUI one, so you can do some image processing here.
+  // This member function is called from a background thread of the
+  // shared JobScheduler pool, so you can do some image processing here.
   // Remember that you cannot use any GUI element in this handler.
   virtual void onJob() = 0;
 
@@ -55,6 +55,10 @@ protected:
   // It is executed from the main GUI thread.
   virtual void onMonitoringTick();
 
+  // Alert window showing the progress, or nullptr when the job was
+  // created without progress UI.
+  ui::Alert* alertWindow() const { return m_alert_window.get(); }
+
 private:
   void done();
 
@@ -62,9 +66,10 @@ private:
   static void monitor_proc(void* data);
   static void monitor_free(void* data);
 
-  std::thread m_thread;
   std::unique_ptr<ui::Timer> m_timer;
   std::mutex m_mutex;
+  std::condition_variable m_done_cond;
+  bool m_running_flag;
   ui::AlertPtr m_alert_window;
   std::atomic<double> m_last_progress;
   bool m_done_flag;
@@ -0,0 +1,119 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/job_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace app {
+
+// static
+JobScheduler* JobScheduler::instance()
+{
+  static JobScheduler scheduler;
+  return &scheduler;
+}
+
+JobScheduler::JobScheduler()
+  : m_threads(std::max<int>(1, std::thread::hardware_concurrency()))
+  , m_jobPool(m_threads)
+  , m_workPool(std::max(1, m_threads - 1))
+{
+}
+
+void JobScheduler::submitJob(std::function<void()>&& func)
+{
+  m_jobPool.execute(std::move(func));
+}
+
+void JobScheduler::forkJoin(int n, const std::function<void(int)>& fn)
+{
+  if (n <= 0)
+    return;
+
+  const int helpers = std::min(n, m_threads) - 1;
+  if (helpers <= 0) {
+    for (int i = 0; i < n; ++i)
+      fn(i);
+    return;
+  }
+
+  // Shared between the caller and the helper tasks. The caller blocks
+  // until "pending" reaches zero, so "fn" (captured by reference)
+  // outlives every helper.
+  struct State {
+    std::atomic<int> next = 0;
+    std::atomic<int> pending = 0;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::exception_ptr error;
+  };
+  auto state = std::make_shared<State>();
+  state->pending = helpers;
+
+  auto run = [state, n, &fn] {
+    int i;
+    while ((i = state->next++) < n) {
+      try {
+        fn(i);
+      }
+      catch (...) {
+        const std::lock_guard lock(state->mutex);
+        if (!state->error)
+          state->error = std::current_exception();
+      }
+    }
+  };
+
+  for (int i = 0; i < helpers; ++i) {
+    m_workPool.execute([state, run] {
+      run();
+      // Lock before notifying so the caller cannot miss the signal
+      // between its predicate check and its wait.
+      if (state->pending.fetch_sub(1) == 1) {
+        const std::lock_guard lock(state->mutex);
+        state->cond.notify_all();
+      }
+    });
+  }
+
+  // The calling thread steals iterations from the same counter.
+  run();
+
+  {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cond.wait(lock, [&state] { return state->pending == 0; });
+  }
+
+  if (state->error)
+    std::rethrow_exception(state->error);
+}
+
+void JobScheduler::forkJoinBands(int from, int to, const std::function<void(int, int)>& fn)
+{
+  const int total = to - from;
+  if (total <= 0)
+    return;
+
+  const int nbands = std::clamp(total, 1, m_threads);
+  forkJoin(nbands, [from, total, nbands, &fn](int band) {
+    const int begin = from + band * total / nbands;
+    const int end = from + (band + 1) * total / nbands;
+    if (begin < end)
+      fn(begin, end);
+  });
+}
+
+} // namespace app
@@ -0,0 +1,64 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_JOB_SCHEDULER_H_INCLUDED
+#define APP_JOB_SCHEDULER_H_INCLUDED
+#pragma once
+
+#include "base/thread_pool.h"
+
+#include <functional>
+
+namespace app {
+
+// Shared scheduler for all background work. It owns two thread pools:
+//
+// 1. A "job" pool where app::Job/app::SpriteJob submit whole
+//    background operations (one task per operation). Its size is
+//    bounded by the CPU count, so launching many concurrent exports
+//    queues them instead of oversubscribing the cores with one
+//    dedicated thread each.
+//
+// 2. A "work" pool used by the fork-join API below to parallelize
+//    inner loops (filters, exporters, quantization, etc.). The
+//    calling thread always participates in the loop, stealing
+//    iterations from the same counter as the workers, so fork-join
+//    calls nested inside a job (or inside another fork-join) make
+//    progress even when every pool thread is busy.
+class JobScheduler {
+public:
+  static JobScheduler* instance();
+
+  // Number of threads in the work pool (i.e. the maximum parallelism
+  // of one forkJoin() call, counting the caller).
+  int threads() const { return m_threads; }
+
+  // Submits a whole background operation (used by app::Job). The
+  // function is executed eventually in a job pool thread.
+  void submitJob(std::function<void()>&& func);
+
+  // Runs fn(i) for each i in [0, n), distributing iterations between
+  // the work pool and the calling thread. Returns when all iterations
+  // are done. If some fn(i) throws, the first exception is rethrown
+  // in the calling thread (after every iteration finished).
+  void forkJoin(int n, const std::function<void(int)>& fn);
+
+  // Splits [from, to) into contiguous bands (at most threads() of
+  // them) and calls fn(begin, end) for each band in parallel. Handy
+  // to process row ranges of an image.
+  void forkJoinBands(int from, int to, const std::function<void(int, int)>& fn);
+
+private:
+  JobScheduler();
+
+  int m_threads;
+  base::thread_pool m_jobPool;
+  base::thread_pool m_workPool;
+};
+
+} // namespace app
+
+#endif
@@ -0,0 +1,107 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/memory_budget.h"
+
+#include "app/app.h"
+#include "app/pref/preferences.h"
+#include "ui/system.h"
+
+#include <algorithm>
+
+namespace app {
+
+// static
+MemoryBudget* MemoryBudget::instance()
+{
+  static MemoryBudget* budget = new MemoryBudget;
+  return budget;
+}
+
+void MemoryBudget::addDelegate(MemoryBudgetDelegate* delegate)
+{
+  const std::lock_guard lock(m_mutex);
+  if (std::find(m_delegates.begin(), m_delegates.end(), delegate) == m_delegates.end())
+    m_delegates.push_back(delegate);
+}
+
+void MemoryBudget::removeDelegate(MemoryBudgetDelegate* delegate)
+{
+  const std::lock_guard lock(m_mutex);
+  auto it = std::find(m_delegates.begin(), m_delegates.end(), delegate);
+  if (it != m_delegates.end())
+    m_delegates.erase(it);
+}
+
+size_t MemoryBudget::budgetBytes() const
+{
+  // Preferences can be gone at exit when the last caches are
+  // destroyed.
+  if (!App::instance())
+    return 0;
+  return size_t(std::max(0, Preferences::instance().memory.cacheLimit())) * 1024 * 1024;
+}
+
+size_t MemoryBudget::usedBytes() const
+{
+  const std::lock_guard lock(m_mutex);
+  size_t used = 0;
+  for (const auto* delegate : m_delegates)
+    used += delegate->memoryUsage();
+  return used;
+}
+
+void MemoryBudget::checkPressure()
+{
+  // Runs in the main thread (which is the UI thread in GUI sessions,
+  // also where transactions are committed and where delegates can
+  // mutate their non-thread-safe structures).
+  const size_t budget = budgetBytes();
+  if (budget == 0)
+    return;
+
+  size_t used = usedBytes();
+  if (used <= budget)
+    return;
+
+  // Eviction can reenter this service (e.g. deleting undo states
+  // notifies observers), so we walk a copy of the delegate list.
+  // The copy stays valid during the walk because delegates register
+  // and unregister in the main thread only: a DocUndo leaves the
+  // budget with setContext(nullptr) when its doc is closed, before
+  // the doc can be deleted by the ClosedDocs background thread.
+  std::vector<MemoryBudgetDelegate*> delegates;
+  {
+    const std::lock_guard lock(m_mutex);
+    delegates = m_delegates;
+  }
+  std::sort(delegates.begin(),
+            delegates.end(),
+            [](const MemoryBudgetDelegate* a, const MemoryBudgetDelegate* b) {
+              return a->evictionPriority() < b->evictionPriority();
+            });
+
+  for (auto* delegate : delegates) {
+    if (used <= budget)
+      break;
+    used -= std::min(used, delegate->evictMemory(used - budget));
+  }
+}
+
+void MemoryBudget::checkPressureFromBackground()
+{
+  const size_t budget = budgetBytes();
+  if (budget == 0 || usedBytes() <= budget)
+    return;
+
+  ui::execute_from_ui_thread([] { MemoryBudget::instance()->checkPressure(); });
+}
+
+} // namespace app
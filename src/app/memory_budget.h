@@ -0,0 +1,76 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_MEMORY_BUDGET_H_INCLUDED
+#define APP_MEMORY_BUDGET_H_INCLUDED
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace app {
+
+// One cache registered in the MemoryBudget service. Implementations
+// must be thread-safe: usage is queried and eviction requested while
+// other threads can be filling the cache.
+class MemoryBudgetDelegate {
+public:
+  virtual ~MemoryBudgetDelegate() {}
+
+  // Caches with a lower priority value are asked to free memory
+  // first (e.g. thumbnails that can be regenerated go before undo
+  // states that cannot).
+  virtual int evictionPriority() const = 0;
+
+  // Current memory used by the cache in bytes.
+  virtual size_t memoryUsage() const = 0;
+
+  // Tries to release up to the given number of bytes and returns the
+  // amount actually freed. Called in the main thread.
+  virtual size_t evictMemory(size_t bytes) = 0;
+};
+
+// Central accounting of the memory used by the different caches
+// (undo histories of each document, timeline thumbnails, etc.).
+// Each cache registers a delegate; when the sum of their usage
+// exceeds the configured budget (memory.cache_limit preference) the
+// service asks the delegates to free memory in priority order, so we
+// shed cache data in a controlled way before the OS starts paging.
+class MemoryBudget {
+public:
+  static MemoryBudget* instance();
+
+  // Both must be called from the main thread: checkPressure() walks
+  // a snapshot of the delegate list, so a delegate removed from
+  // another thread could be destroyed while the walk is using it.
+  void addDelegate(MemoryBudgetDelegate* delegate);
+  void removeDelegate(MemoryBudgetDelegate* delegate);
+
+  // Budget in bytes from the preferences (0 = no limit).
+  size_t budgetBytes() const;
+
+  // Sum of the usage reported by all registered delegates.
+  size_t usedBytes() const;
+
+  // Evicts in priority order until the total usage fits in the
+  // budget. Caches call it (in the main thread) after growing.
+  void checkPressure();
+
+  // Variant for caches that grow in background threads: if the
+  // budget is exceeded, schedules checkPressure() in the UI thread.
+  void checkPressureFromBackground();
+
+private:
+  MemoryBudget() {}
+
+  mutable std::mutex m_mutex;
+  std::vector<MemoryBudgetDelegate*> m_delegates;
+};
+
+} // namespace app
+
+#endif
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2020  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -11,9 +11,11 @@
 
 #include "app/recent_files.h"
 
+#include "app/app.h"
 #include "app/ini_file.h"
 #include "base/fs.h"
 #include "fmt/format.h"
+#include "ui/system.h"
 
 #include <cstdio>
 #include <cstring>
@@ -41,13 +43,16 @@ struct compare_path {
 
 namespace app {
 
-RecentFiles::RecentFiles(const int limit) : m_limit(limit)
+RecentFiles::RecentFiles(const int limit) : m_limit(limit), m_uiToken(std::make_shared<int>(0))
 {
   load();
+  validateItemsInBackground();
 }
 
 RecentFiles::~RecentFiles()
 {
+  if (m_validationThread.joinable())
+    m_validationThread.join();
   save();
 }
 
@@ -184,14 +189,15 @@ void RecentFiles::load()
       }
 
       const char* fn = get_config_string(section, key.c_str(), nullptr);
-      if (fn && *fn &&
-          (((i == kPinnedFiles || i == kRecentFiles) && base::is_file(fn)) ||
-           ((i == kPinnedFolders || i == kRecentFolders) && base::is_directory(fn)))) {
-        std::string normalFn = normalizePath(fn);
-        m_paths[i].push_back(normalFn);
-      }
-      else if (i == kPinnedFonts) {
-        m_paths[i].push_back(fn);
+      if (fn && *fn) {
+        // The existence of each file/folder is checked later in a
+        // background thread (validateItemsInBackground()), so startup
+        // doesn't block stat()ing entries that live in slow or dead
+        // network mounts.
+        if (i == kPinnedFonts)
+          m_paths[i].push_back(fn);
+        else
+          m_paths[i].push_back(normalizePath(fn));
       }
     }
   }
@@ -224,4 +230,55 @@ void RecentFiles::save()
   }
 }
 
+void RecentFiles::validateItemsInBackground()
+{
+  // In batch mode there is no UI message loop to report the results
+  // to (and no Home tab showing the entries anyway), missing entries
+  // will be pruned in the next GUI session.
+  if (!App::instance() || !App::instance()->isGui())
+    return;
+
+  // Snapshot of the lists for the worker thread (m_paths must be
+  // used from the UI thread only).
+  base::paths files = m_paths[kPinnedFiles];
+  files.insert(files.end(), m_paths[kRecentFiles].begin(), m_paths[kRecentFiles].end());
+  base::paths folders = m_paths[kPinnedFolders];
+  folders.insert(folders.end(), m_paths[kRecentFolders].begin(), m_paths[kRecentFolders].end());
+
+  m_validationThread = std::thread(
+    [this, token = std::weak_ptr<void>(m_uiToken), files = std::move(files),
+     folders = std::move(folders)] { // Worker thread
+      base::paths missingFiles, missingFolders;
+      for (const auto& fn : files)
+        if (!base::is_file(fn))
+          missingFiles.push_back(fn);
+      for (const auto& dir : folders)
+        if (!base::is_directory(dir))
+          missingFolders.push_back(dir);
+
+      if (missingFiles.empty() && missingFolders.empty())
+        return;
+
+      ui::execute_from_ui_thread([this, token, missingFiles, missingFolders] {
+        // The RecentFiles instance could be gone if we are closing
+        if (token.lock())
+          removeMissingItems(missingFiles, missingFolders);
+      });
+    });
+}
+
+void RecentFiles::removeMissingItems(const base::paths& missingFiles,
+                                     const base::paths& missingFolders)
+{
+  for (const auto& fn : missingFiles) {
+    removeItem(m_paths[kPinnedFiles], fn);
+    removeItem(m_paths[kRecentFiles], fn);
+  }
+  for (const auto& dir : missingFolders) {
+    removeItem(m_paths[kPinnedFolders], dir);
+    removeItem(m_paths[kRecentFolders], dir);
+  }
+  Changed();
+}
+
 } // namespace app
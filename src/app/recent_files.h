@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2019  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -12,7 +12,9 @@
 #include "base/paths.h"
 #include "obs/signal.h"
 
+#include <memory>
 #include <string>
+#include <thread>
 
 namespace app {
 
@@ -47,9 +49,17 @@ private:
   void removeItem(base::paths& list, const std::string& filename);
   void load();
   void save();
+  void validateItemsInBackground();
+  void removeMissingItems(const base::paths& missingFiles, const base::paths& missingFolders);
 
   base::paths m_paths[kCollections];
   int m_limit;
+
+  // Background existence check for the entries loaded from the
+  // config file, so startup doesn't block stat()ing files on
+  // slow/dead network mounts (see validateItemsInBackground()).
+  std::thread m_validationThread;
+  std::shared_ptr<void> m_uiToken;
 };
 
 } // namespace app
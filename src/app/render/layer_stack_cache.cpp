@@ -0,0 +1,140 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/render/layer_stack_cache.h"
+
+#include "doc/cel.h"
+#include "doc/image.h"
+#include "doc/layer.h"
+#include "doc/primitives.h"
+#include "doc/sprite.h"
+
+namespace app {
+
+using namespace doc;
+
+// The cached path composites the checkered background first and each
+// half of the stack in isolation, which matches the regular pipeline
+// (layers over a transparent backdrop, background DST_OVER at the
+// end) only when every blend mode is NORMAL; e.g. a Multiply layer
+// above the active one would blend against transparency instead of
+// the composite below it.
+static bool all_normal_blend_modes(const Layer* layer)
+{
+  if (layer->blendMode() != BlendMode::NORMAL)
+    return false;
+  if (layer->isGroup()) {
+    for (const Layer* child : static_cast<const LayerGroup*>(layer)->layers()) {
+      if (!all_normal_blend_modes(child))
+        return false;
+    }
+  }
+  return true;
+}
+
+LayerStackCache::Entry LayerStackCache::makeEntry(const Layer* layer, frame_t frame)
+{
+  // Combine the layer version (visibility/opacity/blend mode changes)
+  // with the versions of the cel and its image on this frame, so any
+  // edit on the layer content invalidates the cache too.
+  ObjectVersion v = layer->version();
+  if (const Cel* cel = layer->cel(frame)) {
+    v += cel->version();
+    if (cel->image())
+      v += cel->image()->version();
+  }
+  return Entry{ layer->id(), v };
+}
+
+bool LayerStackCache::update(const Sprite* sprite, const Layer* activeLayer, frame_t frame)
+{
+  if (!sprite || !activeLayer)
+    return false;
+
+  // Only flat stacks are cached: if the active layer is nested in a
+  // group the below/above split doesn't map to two plain composites.
+  if (activeLayer->parent() != sprite->root())
+    return false;
+
+  // The active layer blends against the background + below composite
+  // in the cached path, so anything but NORMAL gives wrong pixels.
+  if (activeLayer->blendMode() != BlendMode::NORMAL)
+    return false;
+
+  std::vector<const Layer*> below, above;
+  std::vector<Entry> belowEntries, aboveEntries;
+  bool foundActive = false;
+  for (const Layer* layer : sprite->root()->layers()) {
+    if (layer == activeLayer) {
+      foundActive = true;
+      continue;
+    }
+    if (!layer->isVisible())
+      continue;
+    if (!all_normal_blend_modes(layer))
+      return false;
+    auto& layers = (foundActive ? above : below);
+    auto& entries = (foundActive ? aboveEntries : belowEntries);
+    layers.push_back(layer);
+    entries.push_back(makeEntry(layer, frame));
+  }
+  if (!foundActive)
+    return false;
+
+  if (m_spriteId == sprite->id() && m_activeLayerId == activeLayer->id() && m_frame == frame &&
+      m_belowEntries == belowEntries && m_aboveEntries == aboveEntries && m_below && m_above) {
+    return true; // Cache hit
+  }
+
+  m_spriteId = sprite->id();
+  m_activeLayerId = activeLayer->id();
+  m_frame = frame;
+  m_belowEntries = std::move(belowEntries);
+  m_aboveEntries = std::move(aboveEntries);
+  m_belowLayers = std::move(below);
+  m_aboveLayers = std::move(above);
+  rebuild(sprite, frame);
+  return true;
+}
+
+void LayerStackCache::rebuild(const Sprite* sprite, frame_t frame)
+{
+  const ImageSpec spec = sprite->spec();
+  if (!m_below || m_below->spec() != spec)
+    m_below.reset(Image::create(spec));
+  if (!m_above || m_above->spec() != spec)
+    m_above.reset(Image::create(spec));
+  clear_image(m_below.get(), m_below->maskColor());
+  clear_image(m_above.get(), m_above->maskColor());
+
+  // Composite each half of the stack with an identity-projection
+  // renderer (the zoom is applied later when blending the three
+  // resulting images into the editor canvas).
+  render::Render render;
+  for (const Layer* layer : m_belowLayers)
+    render.renderLayer(m_below.get(), layer, frame);
+  for (const Layer* layer : m_aboveLayers)
+    render.renderLayer(m_above.get(), layer, frame);
+}
+
+void LayerStackCache::invalidate()
+{
+  m_spriteId = NullId;
+  m_activeLayerId = NullId;
+  m_frame = -1;
+  m_belowEntries.clear();
+  m_aboveEntries.clear();
+  m_belowLayers.clear();
+  m_aboveLayers.clear();
+  m_below.reset();
+  m_above.reset();
+}
+
+} // namespace app
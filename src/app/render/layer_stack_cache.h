@@ -0,0 +1,64 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_RENDER_LAYER_STACK_CACHE_H_INCLUDED
+#define APP_RENDER_LAYER_STACK_CACHE_H_INCLUDED
+#pragma once
+
+#include "doc/frame.h"
+#include "doc/image_ref.h"
+#include "doc/object_id.h"
+#include "render/render.h"
+
+#include <vector>
+
+namespace doc {
+class Layer;
+class Sprite;
+}
+
+namespace app {
+
+// Caches the composite of all layers below and all layers above the
+// active layer, so that while the user is painting on one layer the
+// renderer only needs to re-blend three images (below + active +
+// above) instead of the whole layer stack. Cached composites are kept
+// at sprite resolution and rebuilt only when a layer outside the
+// active one changes (detected through doc::Object versions).
+class LayerStackCache {
+public:
+  // Ensures the below/above composites are up-to-date for the given
+  // active layer/frame. Returns false when the cache cannot be used
+  // (e.g. the active layer is inside a group); in that case the
+  // caller must fall back to a full re-composite.
+  bool update(const doc::Sprite* sprite, const doc::Layer* activeLayer, doc::frame_t frame);
+
+  const doc::Image* below() const { return m_below.get(); }
+  const doc::Image* above() const { return m_above.get(); }
+
+  void invalidate();
+
+private:
+  struct Entry {
+    doc::ObjectId id;
+    doc::ObjectVersion version;
+    bool operator==(const Entry& o) const { return id == o.id && version == o.version; }
+  };
+
+  static Entry makeEntry(const doc::Layer* layer, doc::frame_t frame);
+  void rebuild(const doc::Sprite* sprite, doc::frame_t frame);
+
+  doc::ObjectId m_spriteId = doc::NullId;
+  doc::ObjectId m_activeLayerId = doc::NullId;
+  doc::frame_t m_frame = -1;
+  std::vector<Entry> m_belowEntries, m_aboveEntries;
+  std::vector<const doc::Layer*> m_belowLayers, m_aboveLayers;
+  doc::ImageRef m_below, m_above;
+};
+
+} // namespace app
+
+#endif
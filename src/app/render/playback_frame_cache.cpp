@@ -0,0 +1,239 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/render/playback_frame_cache.h"
+
+#include "app/doc.h"
+#include "app/doc_access.h"
+#include "app/job_scheduler.h"
+#include "doc/cel.h"
+#include "doc/image.h"
+#include "doc/layer.h"
+#include "doc/palette.h"
+#include "doc/render_plan.h"
+#include "doc/sprite.h"
+#include "render/mipmap_pyramid.h"
+#include "render/render.h"
+
+#include <algorithm>
+
+namespace app {
+
+using namespace doc;
+
+PlaybackFrameCache::~PlaybackFrameCache()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_stop = true;
+  m_cond.wait(lock, [this] { return !m_jobRunning; });
+}
+
+bool PlaybackFrameCache::precompose(Doc* doc,
+                                    const Settings& settings,
+                                    const std::vector<frame_t>& upcoming)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (!(m_settings == settings)) {
+    m_settings = settings;
+    m_entries.clear();
+    m_bytes = 0;
+  }
+
+  if (m_stop)
+    return false;
+  if (m_jobRunning)
+    return true;
+
+  const Sprite* sprite = doc->sprite();
+  for (const frame_t frame : upcoming) {
+    uint64_t key;
+    if (!frameKey(sprite, frame, m_settings, key))
+      continue;
+
+    const bool cached = std::any_of(m_entries.begin(), m_entries.end(), [&](const Entry& e) {
+      return e.frame == frame && e.key == key;
+    });
+    if (cached)
+      continue;
+
+    m_jobRunning = true;
+    JobScheduler::instance()->submitJob([this, doc, frame] { precomposeJob(doc, frame); });
+    return true;
+  }
+  return false;
+}
+
+ImageRef PlaybackFrameCache::get(const Sprite* sprite, const frame_t frame, const int mipLevel)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto it = std::find_if(m_entries.begin(), m_entries.end(), [&](const Entry& e) {
+    return e.frame == frame;
+  });
+  if (it == m_entries.end())
+    return nullptr;
+
+  uint64_t key;
+  if (!frameKey(sprite, frame, m_settings, key) || it->key != key) {
+    // The frame was modified (or cannot be cached anymore), discard
+    // the old composite so precompose() rebuilds it.
+    m_bytes -= entryBytes(*it);
+    m_entries.erase(it);
+    return nullptr;
+  }
+
+  // Keep the entry as the most recently used one.
+  Entry entry = *it;
+  m_entries.erase(it);
+
+  if (mipLevel > 0 && (!entry.reduced || entry.reducedLevel != mipLevel)) {
+    m_bytes -= entryBytes(entry);
+    entry.reduced = render::MipmapPyramid::reduce(entry.image, mipLevel);
+    entry.reducedLevel = mipLevel;
+    m_bytes += entryBytes(entry);
+  }
+  m_entries.push_back(entry);
+  return (mipLevel > 0 ? entry.reduced : entry.image);
+}
+
+void PlaybackFrameCache::invalidate()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_bytes = 0;
+}
+
+bool PlaybackFrameCache::frameKey(const Sprite* sprite,
+                                  const frame_t frame,
+                                  const Settings& settings,
+                                  uint64_t& key)
+{
+  auto combine = [](const uint64_t h, const uint64_t v) {
+    return (h ^ v) * uint64_t(1099511628211ull); // FNV-1a style mixing
+  };
+
+  key = uint64_t(14695981039346656037ull);
+  key = combine(key, sprite->id());
+  key = combine(key, uint64_t(frame));
+  key = combine(key, uint64_t(settings.newBlend ? 1 : 0) | (uint64_t(settings.composeGroups ? 1 : 0) << 1));
+  key = combine(key, uint64_t(sprite->width()) | (uint64_t(sprite->height()) << 32));
+  if (const Palette* pal = sprite->palette(frame)) {
+    key = combine(key, pal->id());
+    key = combine(key, pal->version());
+  }
+
+  // The plan enumerates the visible leaf layers; the properties of
+  // the groups they live in still affect the composite, so they are
+  // hashed through the parent chain of each item.
+  RenderPlan plan;
+  plan.addLayer(sprite->root(), frame);
+  for (const auto& item : plan.items()) {
+    const Layer* layer = item.layer;
+    if (layer->isTilemap())
+      return false;
+
+    key = combine(key, layer->id());
+    key = combine(key, uint64_t(layer->opacity()) | (uint64_t(layer->blendMode()) << 16));
+    for (const Layer* group = layer->parent(); group; group = group->parent()) {
+      key = combine(key,
+                    group->id() | (uint64_t(group->opacity()) << 32) |
+                      (uint64_t(group->blendMode()) << 48));
+    }
+
+    const Cel* cel = (item.cel ? item.cel : layer->cel(frame));
+    if (!cel)
+      continue;
+
+    key = combine(key, cel->id());
+    key = combine(key, cel->image()->version());
+    key = combine(key, uint64_t(uint32_t(cel->x())) | (uint64_t(uint32_t(cel->y())) << 32));
+    key = combine(key, uint64_t(cel->opacity()) | (uint64_t(uint32_t(cel->zIndex())) << 16));
+  }
+  return true;
+}
+
+void PlaybackFrameCache::precomposeJob(Doc* doc, const frame_t frame)
+{
+  Settings settings;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stop) {
+      m_jobRunning = false;
+      m_cond.notify_all();
+      return;
+    }
+    settings = m_settings;
+  }
+
+  ImageRef plane;
+  uint64_t key = 0;
+  try {
+    // Don't block the scheduler thread if the document is being
+    // written, the frame is retried on the next playback tick.
+    DocReader reader(doc, 0);
+    const Sprite* sprite = doc->sprite();
+
+    // The key is taken under the same read lock that protects the
+    // composite, so an edit between this job and the tick that
+    // submitted it just produces an entry keyed with the new
+    // content.
+    if (frameKey(sprite, frame, settings, key)) {
+      plane.reset(Image::create(IMAGE_RGB, sprite->width(), sprite->height()));
+
+      render::Render render;
+      render.setRefLayersVisiblity(true);
+      render.setNewBlend(settings.newBlend);
+      render.setComposeGroups(settings.composeGroups);
+      render.setBgOptions(render::BgOptions::MakeNone());
+      render.renderSprite(plane.get(), sprite, frame);
+    }
+  }
+  catch (const LockedDocException&) {
+    plane.reset();
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_jobRunning = false;
+  m_cond.notify_all();
+
+  if (m_stop || !plane)
+    return;
+
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+    if (it->frame == frame) {
+      m_bytes -= entryBytes(*it);
+      m_entries.erase(it);
+      break;
+    }
+  }
+  m_entries.push_back(Entry{ frame, key, plane });
+  m_bytes += plane->getMemSize();
+  trim();
+}
+
+// static
+size_t PlaybackFrameCache::entryBytes(const Entry& e)
+{
+  return e.image->getMemSize() + (e.reduced ? e.reduced->getMemSize() : 0);
+}
+
+void PlaybackFrameCache::trim()
+{
+  // Keep at least the last two used entries even if a big canvas
+  // blows the byte budget (enough to overlap precomposition with the
+  // frame being displayed).
+  while ((m_bytes > kMaxBytes || m_entries.size() > kMaxEntries) && m_entries.size() > 2) {
+    m_bytes -= entryBytes(m_entries.front());
+    m_entries.erase(m_entries.begin());
+  }
+}
+
+} // namespace app
@@ -0,0 +1,112 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_RENDER_PLAYBACK_FRAME_CACHE_H_INCLUDED
+#define APP_RENDER_PLAYBACK_FRAME_CACHE_H_INCLUDED
+#pragma once
+
+#include "doc/frame.h"
+#include "doc/image_ref.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace doc {
+class Sprite;
+}
+
+namespace app {
+class Doc;
+
+// Bounded cache of fully composited frames used while an animation
+// is playing, so each loop through the same frames doesn't re-blend
+// the whole layer stack again (PlayState owns one next to its
+// doc::Playback and feeds it the upcoming frames of the sequence).
+//
+// Composites are kept at sprite resolution in RGBA and are built by
+// a scheduler job between playback ticks, trying a non-blocking read
+// lock on the document (if the document is being modified the frame
+// is just composited the slow way and retried on the next tick).
+// Each entry is keyed with a hash of the source layers/cels (like
+// the onion-skin planes in render::Render), so editing a frame while
+// it plays only invalidates that frame.
+class PlaybackFrameCache {
+public:
+  // Options that affect the composite and cannot be recovered from
+  // the sprite itself; changing them discards all the entries.
+  struct Settings {
+    bool newBlend = true;
+    bool composeGroups = false;
+    bool operator==(const Settings& o) const
+    {
+      return newBlend == o.newBlend && composeGroups == o.composeGroups;
+    }
+  };
+
+  ~PlaybackFrameCache();
+
+  // Called from the UI thread on each playback tick with the frames
+  // that the playback will show next (the current one first). If
+  // some of them is missing or out-of-date, a job is submitted to
+  // composite it in the background (one frame per call, the
+  // remaining ones are picked up by the following ticks). Returns
+  // true while there is still work in-flight (a job was submitted or
+  // is running), so non-periodic callers know they have to call
+  // again later.
+  bool precompose(Doc* doc, const Settings& settings, const std::vector<doc::frame_t>& upcoming);
+
+  // Returns the composite of the given frame if it's still
+  // up-to-date, or nullptr if the renderer must composite the frame
+  // from the layer stack. With mipLevel > 0 the composite is
+  // downscaled that number of halvings (box filter) and the reduced
+  // plane is kept next to the full one, so a zoomed-out preview
+  // playing in a loop reuses it on every pass.
+  doc::ImageRef get(const doc::Sprite* sprite, doc::frame_t frame, int mipLevel = 0);
+
+  void invalidate();
+
+private:
+  struct Entry {
+    doc::frame_t frame;
+    uint64_t key;
+    doc::ImageRef image;
+    doc::ImageRef reduced; // Downscaled composite (see get() with mipLevel > 0)
+    int reducedLevel = 0;
+  };
+
+  // Returns false when the frame cannot be cached at all (e.g. it
+  // contains tilemap layers, where cels don't change when the
+  // tileset content does).
+  static bool frameKey(const doc::Sprite* sprite,
+                       doc::frame_t frame,
+                       const Settings& settings,
+                       uint64_t& key);
+
+  static size_t entryBytes(const Entry& e);
+
+  void precomposeJob(Doc* doc, doc::frame_t frame);
+  void trim();
+
+  // Enough for hundreds of frames of a regular pixel-art sprite (or
+  // ~16 full-HD frames) without letting big canvases take the whole
+  // heap. The entry count cap bounds the key re-validation done on
+  // each repaint.
+  static constexpr size_t kMaxBytes = 128 * 1024 * 1024;
+  static constexpr size_t kMaxEntries = 256;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_jobRunning = false;
+  bool m_stop = false;
+  Settings m_settings;
+  size_t m_bytes = 0;
+  std::vector<Entry> m_entries; // LRU order (oldest first)
+};
+
+} // namespace app
+
+#endif
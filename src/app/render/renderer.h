@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2022-2023  Igara Studio S.A.
+// Copyright (C) 2022-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -20,6 +20,7 @@ class Surface;
 }
 
 namespace app {
+class PlaybackFrameCache;
 
 // Abstract class to render images from any editor to be displayed
 // in the screen mainly (to render images in files you can continue
@@ -86,6 +87,20 @@ public:
   virtual void setOnionskin(const render::OnionskinOptions& options) = 0;
   virtual void disableOnionskin() = 0;
 
+  // Cache of pre-composited frames used while an animation is
+  // playing (nullptr when nothing is playing). Optional, renderers
+  // without a fast path for it can just ignore the cache.
+  virtual void setPlaybackCache(PlaybackFrameCache* cache) {}
+  virtual void removePlaybackCache(const PlaybackFrameCache* cache) {}
+
+  // Number of 2x downsampling steps for the next renderSprite()
+  // calls, where the destination surface and area are given in
+  // reduced coordinates (the sprite size halved "level" times). Used
+  // by the preview editor to composite big sprites at the panel
+  // resolution. Optional, the caller must check that the renderer
+  // supports it before passing reduced areas.
+  virtual void setDownsampleLevel(const int level) {}
+
   // ----------------------------------------------------------------------
   // Compositing
 
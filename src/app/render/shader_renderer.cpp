@@ -18,6 +18,7 @@
   #include "os/common/generic_surface.h"
   #include "os/skia/skia_surface.h"
 
+  #include "include/core/SkBlender.h"
   #include "include/core/SkCanvas.h"
   #include "include/effects/SkRuntimeEffect.h"
 
@@ -56,6 +57,31 @@ half4 main(vec2 fragcoord) {
 }
 )";
 
+// Blend modes without a Skia counterpart, implemented as runtime
+// blenders following the same separable blend function used by the
+// CPU renderer (doc/blend_funcs.cpp): unpremultiply both colors,
+// apply the blend function mixed by the backdrop alpha, and composite
+// with the regular src-over equation.
+const char* kSubtractBlenderCode = R"(
+half4 main(half4 src, half4 dst) {
+ half3 s = (src.a > 0 ? src.rgb / src.a : half3(0));
+ half3 b = (dst.a > 0 ? dst.rgb / dst.a : half3(0));
+ half3 c = mix(s, max(b - s, 0), dst.a);
+ return half4(src.a * c + (1.0 - src.a) * dst.rgb,
+              src.a + (1.0 - src.a) * dst.a);
+}
+)";
+
+const char* kDivideBlenderCode = R"(
+half4 main(half4 src, half4 dst) {
+ half3 s = (src.a > 0 ? src.rgb / src.a : half3(0));
+ half3 b = (dst.a > 0 ? dst.rgb / dst.a : half3(0));
+ half3 c = mix(s, clamp(b / max(s, 0.0001), 0.0, 1.0), dst.a);
+ return half4(src.a * c + (1.0 - src.a) * dst.rgb,
+              src.a + (1.0 - src.a) * dst.a);
+}
+)";
+
 inline SkBlendMode to_skia(const doc::BlendMode bm)
 {
   switch (bm) {
@@ -76,8 +102,11 @@ inline SkBlendMode to_skia(const doc::BlendMode bm)
     case doc::BlendMode::HSL_COLOR:      return SkBlendMode::kColor;
     case doc::BlendMode::HSL_LUMINOSITY: return SkBlendMode::kLuminosity;
     case doc::BlendMode::ADDITION:       return SkBlendMode::kPlus;
-    case doc::BlendMode::SUBTRACT:       break; // TODO
-    case doc::BlendMode::DIVIDE:         break;         // TODO
+    case doc::BlendMode::SUBTRACT:
+    case doc::BlendMode::DIVIDE:
+      // Handled with runtime blenders in setPaintBlendMode()
+      ASSERT(false);
+      break;
   }
   return SkBlendMode::kSrc;
 }
@@ -92,6 +121,8 @@ ShaderRenderer::ShaderRenderer()
   m_bgEffect = make_shader(kBgShaderCode);
   m_indexedEffect = make_shader(kIndexedShaderCode);
   m_grayscaleEffect = make_shader(kGrayscaleShaderCode);
+  m_subtractBlender = make_blender(kSubtractBlenderCode)->makeBlender(nullptr);
+  m_divideBlender = make_blender(kDivideBlenderCode)->makeBlender(nullptr);
 }
 
 ShaderRenderer::~ShaderRenderer() = default;
@@ -402,7 +433,7 @@ void ShaderRenderer::drawImage(SkCanvas* canvas,
     case doc::ColorMode::RGB: {
       SkPaint p;
       p.setAlpha(opacity);
-      p.setBlendMode(to_skia(blendMode));
+      setPaintBlendMode(p, blendMode);
       canvas->drawImage(skImg.get(), SkIntToScalar(x), SkIntToScalar(y), SkSamplingOptions(), &p);
       break;
     }
@@ -413,7 +444,7 @@ void ShaderRenderer::drawImage(SkCanvas* canvas,
 
       SkPaint p;
       p.setAlpha(opacity);
-      p.setBlendMode(to_skia(blendMode));
+      setPaintBlendMode(p, blendMode);
       p.setStyle(SkPaint::kFill_Style);
       p.setShader(builder.makeShader());
 
@@ -440,7 +471,7 @@ void ShaderRenderer::drawImage(SkCanvas* canvas,
 
       SkPaint p;
       p.setAlpha(opacity);
-      p.setBlendMode(to_skia(blendMode));
+      setPaintBlendMode(p, blendMode);
       p.setStyle(SkPaint::kFill_Style);
       p.setShader(builder.makeShader());
 
@@ -453,6 +484,15 @@ void ShaderRenderer::drawImage(SkCanvas* canvas,
   }
 }
 
+void ShaderRenderer::setPaintBlendMode(SkPaint& p, const doc::BlendMode blendMode) const
+{
+  switch (blendMode) {
+    case doc::BlendMode::SUBTRACT: p.setBlender(m_subtractBlender); break;
+    case doc::BlendMode::DIVIDE:   p.setBlender(m_divideBlender); break;
+    default:                       p.setBlendMode(to_skia(blendMode)); break;
+  }
+}
+
 // TODO this is equal to Render::checkIfWeShouldUsePreview(const Cel*),
 //      we might think in a way to merge both functions
 bool ShaderRenderer::checkIfWeShouldUsePreview(const doc::Cel* cel) const
@@ -15,7 +15,9 @@
 
   #include "include/core/SkRefCnt.h"
 
+class SkBlender;
 class SkCanvas;
+class SkPaint;
 class SkRuntimeEffect;
 
 namespace doc {
@@ -89,6 +91,11 @@ private:
                  const int opacity,
                  const doc::BlendMode blendMode);
 
+  // Configures the blend mode of the paint, using the equivalent
+  // Skia blend mode or a runtime SkSL blender for the modes without
+  // Skia counterpart (Subtract/Divide).
+  void setPaintBlendMode(SkPaint& p, const doc::BlendMode blendMode) const;
+
   bool checkIfWeShouldUsePreview(const doc::Cel* cel) const;
   void afterBackgroundLayerIsPainted();
 
@@ -98,6 +105,8 @@ private:
   sk_sp<SkRuntimeEffect> m_bgEffect;
   sk_sp<SkRuntimeEffect> m_indexedEffect;
   sk_sp<SkRuntimeEffect> m_grayscaleEffect;
+  sk_sp<SkBlender> m_subtractBlender;
+  sk_sp<SkBlender> m_divideBlender;
   const doc::Sprite* m_sprite = nullptr;
   const doc::LayerImage* m_bgLayer = nullptr;
   // TODO these members are the same as in render::Render, we should
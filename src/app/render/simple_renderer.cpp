@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2022-2023  Igara Studio S.A.
+// Copyright (C) 2022-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -10,8 +10,12 @@
 
 #include "app/render/simple_renderer.h"
 
+#include "app/render/playback_frame_cache.h"
 #include "app/ui/editor/editor_render.h"
 #include "app/util/conversion_to_surface.h"
+#include "os/surface.h"
+
+#include <algorithm>
 
 namespace app {
 
@@ -29,11 +33,13 @@ void SimpleRenderer::setRefLayersVisiblity(const bool visible)
 
 void SimpleRenderer::setNonactiveLayersOpacity(const int opacity)
 {
+  m_nonactiveLayersOpacity = opacity;
   m_render.setNonactiveLayersOpacity(opacity);
 }
 
 void SimpleRenderer::setNewBlendMethod(const bool newBlend)
 {
+  m_newBlend = newBlend;
   m_render.setNewBlend(newBlend);
 }
 
@@ -44,11 +50,13 @@ void SimpleRenderer::setComposeGroups(const bool composeGroups)
 
 void SimpleRenderer::setBgOptions(const render::BgOptions& bg)
 {
+  m_bg = bg;
   m_render.setBgOptions(bg);
 }
 
 void SimpleRenderer::setProjection(const render::Projection& projection)
 {
+  m_projection = projection;
   m_render.setProjection(projection);
 }
 
@@ -64,11 +72,15 @@ void SimpleRenderer::setPreviewImage(const doc::Layer* layer,
                                      const gfx::Point& pos,
                                      const doc::BlendMode blendMode)
 {
+  m_previewLayer = layer;
+  m_previewFrame = frame;
   m_render.setPreviewImage(layer, frame, image, tileset, pos, blendMode);
 }
 
 void SimpleRenderer::removePreviewImage()
 {
+  m_previewLayer = nullptr;
+  m_previewFrame = -1;
   m_render.removePreviewImage();
 }
 
@@ -79,29 +91,74 @@ void SimpleRenderer::setExtraImage(render::ExtraType type,
                                    const doc::Layer* currentLayer,
                                    const doc::frame_t currentFrame)
 {
+  m_hasExtraImage = true;
   m_render.setExtraImage(type, cel, image, blendMode, currentLayer, currentFrame);
 }
 
 void SimpleRenderer::removeExtraImage()
 {
+  m_hasExtraImage = false;
   m_render.removeExtraImage();
 }
 
 void SimpleRenderer::setOnionskin(const render::OnionskinOptions& options)
 {
+  m_onionskinEnabled = (options.type() != render::OnionskinType::NONE);
   m_render.setOnionskin(options);
 }
 
 void SimpleRenderer::disableOnionskin()
 {
+  m_onionskinEnabled = false;
   m_render.disableOnionskin();
 }
 
+void SimpleRenderer::setPlaybackCache(PlaybackFrameCache* cache)
+{
+  m_playbackCache = cache;
+}
+
+void SimpleRenderer::removePlaybackCache(const PlaybackFrameCache* cache)
+{
+  // Only detach if the cache is still the attached one (with several
+  // playing editors each PlayState re-attaches its own cache on each
+  // playback tick).
+  if (m_playbackCache == cache)
+    m_playbackCache = nullptr;
+}
+
+void SimpleRenderer::setDownsampleLevel(const int level)
+{
+  m_downsampleLevel = level;
+}
+
 void SimpleRenderer::renderSprite(os::Surface* dstSurface,
                                   const doc::Sprite* sprite,
                                   const doc::frame_t frame,
                                   const gfx::ClipF& area)
 {
+  if (m_downsampleLevel > 0) {
+    renderSpriteReduced(dstSurface, sprite, frame, area);
+    return;
+  }
+
+  if (renderSpriteFromPlaybackCache(dstSurface, sprite, frame, area))
+    return;
+
+  if (renderSpriteWithStackCache(dstSurface, sprite, frame, area))
+    return;
+
+  // Zero-copy path: when the surface layout matches doc::rgba (the
+  // common Skia RGBA case) we composite directly into the surface
+  // pixels, skipping a full-canvas staging image + conversion copy
+  // per redraw.
+  os::SurfaceLock lock(dstSurface);
+  if (ImageRef wrapImage = wrap_surface_in_image(dstSurface, area.size.w, area.size.h)) {
+    m_render.renderSprite(wrapImage.get(), sprite, frame, area);
+    notify_surface_pixels_changed(dstSurface);
+    return;
+  }
+
   ImageRef dstImage(
     Image::create(IMAGE_RGB, area.size.w, area.size.h, EditorRender::getRenderImageBuffer()));
   m_render.renderSprite(dstImage.get(), sprite, frame, area);
@@ -117,10 +174,172 @@ void SimpleRenderer::renderSprite(os::Surface* dstSurface,
                            area.size.h);
 }
 
+bool SimpleRenderer::renderSpriteFromPlaybackCache(os::Surface* dstSurface,
+                                                   const doc::Sprite* sprite,
+                                                   const doc::frame_t frame,
+                                                   const gfx::ClipF& area)
+{
+  if (!m_playbackCache)
+    return false;
+
+  // Cached composites are the plain layer stack blended over a
+  // transparent canvas with the new blending method, so we cannot
+  // use them when some overlay/option changes the composite (the
+  // cache entry key already covers changes in the sprite itself).
+  if (m_previewLayer || m_hasExtraImage || m_onionskinEnabled || !m_newBlend ||
+      m_nonactiveLayersOpacity != 255 || m_bg.type != render::BgType::CHECKERED) {
+    return false;
+  }
+
+  ImageRef plane = m_playbackCache->get(sprite, frame);
+  if (!plane)
+    return false;
+
+  os::SurfaceLock lock(dstSurface);
+  ImageRef dstImage = wrap_surface_in_image(dstSurface, area.size.w, area.size.h);
+  const bool direct = (dstImage != nullptr);
+  if (!direct) {
+    dstImage.reset(
+      Image::create(IMAGE_RGB, area.size.w, area.size.h, EditorRender::getRenderImageBuffer()));
+  }
+
+  m_render.renderCheckeredBackground(dstImage.get(), gfx::Clip(area));
+
+  const Palette* pal = sprite->palette(frame);
+  m_render.renderImage(dstImage.get(),
+                       plane.get(),
+                       pal,
+                       -int(area.src.x),
+                       -int(area.src.y),
+                       255,
+                       BlendMode::NORMAL);
+
+  if (direct)
+    notify_surface_pixels_changed(dstSurface);
+  else
+    convert_image_to_surface(dstImage.get(), pal, dstSurface, 0, 0, 0, 0, area.size.w, area.size.h);
+  return true;
+}
+
+void SimpleRenderer::renderSpriteReduced(os::Surface* dstSurface,
+                                         const doc::Sprite* sprite,
+                                         const doc::frame_t frame,
+                                         const gfx::ClipF& area)
+{
+  const int level = m_downsampleLevel;
+
+  // Same conditions as renderSpriteFromPlaybackCache(): the cached
+  // planes are the plain layer stack, so any overlay/option that
+  // changes the composite makes them unusable.
+  ImageRef plane;
+  if (m_playbackCache && !m_previewLayer && !m_hasExtraImage && !m_onionskinEnabled && m_newBlend &&
+      m_nonactiveLayersOpacity == 255 && m_bg.type == render::BgType::CHECKERED) {
+    plane = m_playbackCache->get(sprite, frame, level);
+  }
+
+  os::SurfaceLock lock(dstSurface);
+  ImageRef dstImage = wrap_surface_in_image(dstSurface, area.size.w, area.size.h);
+  const bool direct = (dstImage != nullptr);
+  if (!direct) {
+    dstImage.reset(
+      Image::create(IMAGE_RGB, area.size.w, area.size.h, EditorRender::getRenderImageBuffer()));
+  }
+
+  const Palette* pal = sprite->palette(frame);
+  if (plane) {
+    // The background is composited directly at the reduced
+    // resolution, so the checkered squares are reduced too to keep
+    // their size on screen.
+    render::BgOptions bg = m_bg;
+    bg.stripeSize.w = std::max(1, bg.stripeSize.w >> level);
+    bg.stripeSize.h = std::max(1, bg.stripeSize.h >> level);
+    m_render.setBgOptions(bg);
+    m_render.renderCheckeredBackground(dstImage.get(), gfx::Clip(area));
+    m_render.setBgOptions(m_bg);
+
+    m_render.renderImage(dstImage.get(),
+                         plane.get(),
+                         pal,
+                         -int(area.src.x),
+                         -int(area.src.y),
+                         255,
+                         BlendMode::NORMAL);
+  }
+  else {
+    // Cache miss or active overlays: composite the layer stack with
+    // a scaled-down projection. This point-samples the cels, but
+    // it's a downscaled preview and (without overlays) just a
+    // transient until the playback cache job composites the frame.
+    m_render.setProjection(
+      render::Projection(doc::PixelRatio(1, 1), render::Zoom(1, 1 << level)));
+    m_render.renderSprite(dstImage.get(), sprite, frame, area);
+    m_render.setProjection(m_projection);
+  }
+
+  if (direct)
+    notify_surface_pixels_changed(dstSurface);
+  else
+    convert_image_to_surface(dstImage.get(), pal, dstSurface, 0, 0, 0, 0, area.size.w, area.size.h);
+}
+
+bool SimpleRenderer::renderSpriteWithStackCache(os::Surface* dstSurface,
+                                                const doc::Sprite* sprite,
+                                                const doc::frame_t frame,
+                                                const gfx::ClipF& area)
+{
+  // The cached path is only used while a brush stroke is being
+  // previewed on a top-level image layer, and only for setups where
+  // blending below + active + above is equivalent to the full
+  // composite (RGB sprite, no onion skin, no dimmed layers; the
+  // NORMAL-blend-modes-only check lives in LayerStackCache::update()).
+  if (!m_previewLayer || m_previewFrame != frame || !m_previewLayer->isImage() ||
+      sprite->pixelFormat() != IMAGE_RGB || m_onionskinEnabled ||
+      m_nonactiveLayersOpacity != 255 || m_bg.type != render::BgType::CHECKERED) {
+    m_stackCache.invalidate();
+    return false;
+  }
+
+  if (!m_stackCache.update(sprite, m_previewLayer, frame))
+    return false;
+
+  os::SurfaceLock lock(dstSurface);
+  ImageRef dstImage = wrap_surface_in_image(dstSurface, area.size.w, area.size.h);
+  const bool direct = (dstImage != nullptr);
+  if (!direct) {
+    dstImage.reset(
+      Image::create(IMAGE_RGB, area.size.w, area.size.h, EditorRender::getRenderImageBuffer()));
+  }
+
+  m_render.renderCheckeredBackground(dstImage.get(), gfx::Clip(area));
+
+  const Palette* pal = sprite->palette(frame);
+  const int x = -int(area.src.x);
+  const int y = -int(area.src.y);
+  m_render.renderImage(dstImage.get(), m_stackCache.below(), pal, x, y, 255, BlendMode::NORMAL);
+  m_render.renderLayer(dstImage.get(),
+                       m_previewLayer,
+                       frame,
+                       gfx::Clip(area)); // Uses the preview image of the active layer
+  m_render.renderImage(dstImage.get(), m_stackCache.above(), pal, x, y, 255, BlendMode::NORMAL);
+
+  if (direct)
+    notify_surface_pixels_changed(dstSurface);
+  else
+    convert_image_to_surface(dstImage.get(), pal, dstSurface, 0, 0, 0, 0, area.size.w, area.size.h);
+  return true;
+}
+
 void SimpleRenderer::renderCheckeredBackground(os::Surface* dstSurface,
                                                const doc::Sprite* sprite,
                                                const gfx::Clip& area)
 {
+  os::SurfaceLock lock(dstSurface);
+  if (ImageRef wrapImage = wrap_surface_in_image(dstSurface, area.size.w, area.size.h)) {
+    m_render.renderCheckeredBackground(wrapImage.get(), area);
+    notify_surface_pixels_changed(dstSurface);
+    return;
+  }
+
   ImageRef dstImage(
     Image::create(IMAGE_RGB, area.size.w, area.size.h, EditorRender::getRenderImageBuffer()));
 
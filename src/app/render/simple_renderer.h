@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2022-2023  Igara Studio S.A.
+// Copyright (C) 2022-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -8,6 +8,7 @@
 #define APP_RENDER_SIMPLE_RENDERER_H_INCLUDED
 #pragma once
 
+#include "app/render/layer_stack_cache.h"
 #include "app/render/renderer.h"
 
 namespace app {
@@ -45,6 +46,9 @@ public:
   void removeExtraImage() override;
   void setOnionskin(const render::OnionskinOptions& options) override;
   void disableOnionskin() override;
+  void setPlaybackCache(PlaybackFrameCache* cache) override;
+  void removePlaybackCache(const PlaybackFrameCache* cache) override;
+  void setDownsampleLevel(const int level) override;
 
   void renderSprite(os::Surface* dstSurface,
                     const doc::Sprite* sprite,
@@ -62,8 +66,48 @@ public:
                    const doc::BlendMode blendMode) override;
 
 private:
+  // Fast path used while painting: blends the cached below-composite,
+  // the active layer (with its preview image), and the cached
+  // above-composite instead of the whole layer stack. Returns false
+  // when the cache is not applicable and the caller must do a full
+  // re-composite.
+  bool renderSpriteWithStackCache(os::Surface* dstSurface,
+                                  const doc::Sprite* sprite,
+                                  const doc::frame_t frame,
+                                  const gfx::ClipF& area);
+
+  // Fast path used while an animation is playing: blends the
+  // pre-composited frame from the playback cache over the checkered
+  // background instead of re-compositing the layer stack. Returns
+  // false on a cache miss (or when some option makes the cached
+  // composite unusable) and the caller must do a full re-composite.
+  bool renderSpriteFromPlaybackCache(os::Surface* dstSurface,
+                                     const doc::Sprite* sprite,
+                                     const doc::frame_t frame,
+                                     const gfx::ClipF& area);
+
+  // Composites the sprite at 1/2^m_downsampleLevel resolution
+  // ("area" comes in reduced coordinates): blends the reduced plane
+  // from the playback cache when it's available, in other case the
+  // layer stack is composited with a scaled-down projection.
+  void renderSpriteReduced(os::Surface* dstSurface,
+                           const doc::Sprite* sprite,
+                           const doc::frame_t frame,
+                           const gfx::ClipF& area);
+
   Properties m_properties;
   render::Render m_render;
+  render::Projection m_projection;
+  LayerStackCache m_stackCache;
+  PlaybackFrameCache* m_playbackCache = nullptr;
+  const doc::Layer* m_previewLayer = nullptr;
+  doc::frame_t m_previewFrame = -1;
+  render::BgOptions m_bg;
+  bool m_onionskinEnabled = false;
+  bool m_hasExtraImage = false;
+  bool m_newBlend = true;
+  int m_nonactiveLayersOpacity = 255;
+  int m_downsampleLevel = 0;
 };
 
 } // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2018  David Capello
 //
 // This program is distributed under the terms of
@@ -15,6 +15,7 @@
 #include "app/commands/new_params.h"
 #include "app/commands/params.h"
 #include "app/context.h"
+#include "app/script/engine.h"
 #include "app/script/luacpp.h"
 
 namespace app { namespace script {
@@ -25,7 +26,7 @@ struct AppCommand {};
 
 int Command_call(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   if (!ctx)
     return 0;
 
@@ -65,7 +66,7 @@ int Command_call(lua_State* L)
 
 int Command_enabled(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   if (!ctx)
     return 0;
 
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2024  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2015-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -44,6 +44,7 @@
 #include "base/replace_string.h"
 #include "base/version.h"
 #include "doc/layer.h"
+#include "doc/object.h"
 #include "doc/primitives.h"
 #include "doc/tag.h"
 #include "render/render.h"
@@ -62,7 +63,7 @@ int load_sprite_from_file(lua_State* L, const char* filename, const LoadSpriteFr
   if (!ask_access(L, absFn.c_str(), FileAccessMode::Read, ResourceType::File))
     return luaL_error(L, "script doesn't have access to open file %s", absFn.c_str());
 
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   Doc* oldDoc = ctx->activeDocument();
 
   Command* openCommand = Commands::instance()->byId(CommandId::OpenFile());
@@ -109,6 +110,9 @@ int load_sprite_from_file(lua_State* L, const char* filename, const LoadSpriteFr
   return 1;
 }
 
+// Defined in task_class.cpp
+int App_spawn(lua_State* L);
+
 namespace {
 
 int App_open(lua_State* L)
@@ -118,7 +122,7 @@ int App_open(lua_State* L)
 
 int App_exit(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   if (ctx && ctx->isUIAvailable()) {
     Command* exitCommand = Commands::instance()->byId(CommandId::Exit());
     ctx->executeCommand(exitCommand);
@@ -147,7 +151,7 @@ int App_transaction(lua_State* L)
   }
 
   if (lua_isfunction(L, index)) {
-    app::Context* ctx = App::instance()->context();
+    app::Context* ctx = get_app_context(L);
     if (!ctx)
       return luaL_error(L, "no context");
 
@@ -174,7 +178,7 @@ int App_transaction(lua_State* L)
 
 int App_undo(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   if (ctx) {
     Command* undo = Commands::instance()->byId(CommandId::Undo());
     ctx->executeCommand(undo);
@@ -184,7 +188,7 @@ int App_undo(lua_State* L)
 
 int App_redo(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   if (ctx) {
     Command* redo = Commands::instance()->byId(CommandId::Redo());
     ctx->executeCommand(redo);
@@ -194,7 +198,7 @@ int App_redo(lua_State* L)
 
 int App_alert(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   if (!ctx || !ctx->isUIAvailable())
     return 0; // No UI to show the alert
   // app.alert("text...")
@@ -259,7 +263,7 @@ int App_alert(lua_State* L)
 
 int App_refresh(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   if (ctx && ctx->isUIAvailable())
     app_refresh_screen();
   return 0;
@@ -271,7 +275,7 @@ int App_useTool(lua_State* L)
   if (!lua_istable(L, 1))
     return luaL_error(L, "app.useTool() must be called with a table as its first argument");
 
-  auto ctx = App::instance()->context();
+  auto ctx = get_app_context(L);
   Site site = ctx->activeSite();
 
   // Draw in a specific cel, layer, or frame
@@ -500,7 +504,7 @@ int App_useTool(lua_State* L)
 
 int App_tip(lua_State* L)
 {
-  const auto* ctx = App::instance()->context();
+  const auto* ctx = get_app_context(L);
   if (!ctx || !ctx->isUIAvailable() || !StatusBar::instance())
     return 0; // No UI to show the tooltip
 
@@ -572,7 +576,7 @@ int App_get_clipboard(lua_State* L)
 
 int App_get_sprite(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   Doc* doc = ctx->activeDocument();
   if (doc)
     push_docobj(L, doc->sprite());
@@ -583,7 +587,7 @@ int App_get_sprite(lua_State* L)
 
 int App_get_layer(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   Site site = ctx->activeSite();
   if (site.layer())
     push_docobj(L, site.layer());
@@ -594,7 +598,7 @@ int App_get_layer(lua_State* L)
 
 int App_get_frame(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   Site site = ctx->activeSite();
   if (site.sprite())
     push_sprite_frame(L, site.sprite(), site.frame());
@@ -605,7 +609,7 @@ int App_get_frame(lua_State* L)
 
 int App_get_cel(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   Site site = ctx->activeSite();
   if (site.cel())
     push_sprite_cel(L, site.cel());
@@ -616,7 +620,7 @@ int App_get_cel(lua_State* L)
 
 int App_get_image(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   Site site = ctx->activeSite();
   if (site.cel())
     push_cel_image(L, site.cel());
@@ -629,7 +633,7 @@ int App_get_tag(lua_State* L)
 {
   Tag* tag = nullptr;
 
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   Site site = ctx->activeSite();
   if (site.sprite()) {
     if (App::instance()->timeline()) {
@@ -703,7 +707,7 @@ int App_set_bgTile(lua_State* L)
 
 int App_get_site(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   Site site = ctx->activeSite();
   push_obj(L, site);
   return 1;
@@ -711,7 +715,7 @@ int App_get_site(lua_State* L)
 
 int App_get_range(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   Site site = ctx->activeSite();
   push_doc_range(L, site);
   return 1;
@@ -719,7 +723,7 @@ int App_get_range(lua_State* L)
 
 int App_get_isUIAvailable(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   lua_pushboolean(L, ctx && ctx->isUIAvailable());
   return 1;
 }
@@ -732,6 +736,38 @@ int App_get_version(lua_State* L)
   return 1;
 }
 
+int App_get_objectStatsEnabled(lua_State* L)
+{
+  lua_pushboolean(L, doc::object_stats_enabled());
+  return 1;
+}
+
+int App_set_objectStatsEnabled(lua_State* L)
+{
+  doc::set_object_stats_enabled(lua_toboolean(L, 2));
+  return 0;
+}
+
+int App_get_objectStats(lua_State* L)
+{
+  // Table keyed by type name, e.g. stats.Image.liveBytes (empty
+  // until app.objectStatsEnabled is set to true).
+  lua_newtable(L);
+  for (const auto& it : doc::get_object_stats()) {
+    lua_newtable(L);
+    lua_pushinteger(L, it.second.liveCount);
+    lua_setfield(L, -2, "liveCount");
+    lua_pushinteger(L, it.second.liveBytes);
+    lua_setfield(L, -2, "liveBytes");
+    lua_pushinteger(L, it.second.peakBytes);
+    lua_setfield(L, -2, "peakBytes");
+    lua_pushinteger(L, it.second.totalCount);
+    lua_setfield(L, -2, "totalCount");
+    lua_setfield(L, -2, doc::object_type_name(it.first));
+  }
+  return 1;
+}
+
 int App_get_apiVersion(lua_State* L)
 {
   lua_pushinteger(L, API_VERSION);
@@ -782,7 +818,7 @@ int App_get_window(lua_State* L)
 int App_set_sprite(lua_State* L)
 {
   auto sprite = may_get_docobj<Sprite>(L, 2);
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   doc::Document* doc = (sprite ? sprite->document() : nullptr);
   ctx->setActiveDocument(static_cast<Doc*>(doc));
   return 0;
@@ -791,7 +827,7 @@ int App_set_sprite(lua_State* L)
 int App_set_layer(lua_State* L)
 {
   auto layer = get_docobj<Layer>(L, 2);
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   ctx->setActiveLayer(layer);
   return 0;
 }
@@ -799,7 +835,7 @@ int App_set_layer(lua_State* L)
 int App_set_frame(lua_State* L)
 {
   const doc::frame_t frame = get_frame_number_from_arg(L, 2);
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   ctx->setActiveFrame(frame);
   return 0;
 }
@@ -807,7 +843,7 @@ int App_set_frame(lua_State* L)
 int App_set_cel(lua_State* L)
 {
   const auto cel = get_docobj<Cel>(L, 2);
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   ctx->setActiveLayer(cel->layer());
   ctx->setActiveFrame(cel->frame());
   return 0;
@@ -819,7 +855,7 @@ int App_set_image(lua_State* L)
   if (!cel)
     return 0;
 
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   ctx->setActiveLayer(cel->layer());
   ctx->setActiveFrame(cel->frame());
   return 0;
@@ -858,6 +894,7 @@ const luaL_Reg App_methods[] = {
   { "alert",       App_alert       },
   { "refresh",     App_refresh     },
   { "useTool",     App_useTool     },
+  { "spawn",       App_spawn       },
   { "tip",         App_tip         },
   { nullptr,       nullptr         }
 };
@@ -900,6 +937,10 @@ const Property App_properties[] = {
   { "uiScale",        App_get_uiScale,        nullptr                },
   { "editor",         App_get_editor,         nullptr                },
   { "clipboard",      App_get_clipboard,      nullptr                },
+
+  // Allocation instrumentation of doc objects (see doc/object.h)
+  { "objectStatsEnabled", App_get_objectStatsEnabled, App_set_objectStatsEnabled },
+  { "objectStats",    App_get_objectStats,    nullptr                },
   { nullptr,          nullptr,                nullptr                }
 };
 
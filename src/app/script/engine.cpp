@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2024  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -16,6 +16,7 @@
 #include "app/doc_exporter.h"
 #include "app/doc_range.h"
 #include "app/pref/preferences.h"
+#include "app/resource_finder.h"
 #include "app/script/blend_mode.h"
 #include "app/script/luacpp.h"
 #include "app/script/require.h"
@@ -25,9 +26,11 @@
 #include "app/tileset_mode.h"
 #include "app/tools/ink_type.h"
 #include "base/chrono.h"
+#include "base/convert_to.h"
 #include "base/file_handle.h"
 #include "base/fs.h"
 #include "base/fstream_path.h"
+#include "base/sha1.h"
 #include "doc/algorithm/flip_type.h"
 #include "doc/anidir.h"
 #include "doc/color_mode.h"
@@ -36,6 +39,7 @@
 #include "ui/base.h"
 #include "ui/cursor_type.h"
 #include "ui/mouse_button.h"
+#include "ui/system.h"
 
 #include <fstream>
 #include <sstream>
@@ -73,6 +77,87 @@ public:
   ~AddScriptFilename() { current_script_dirs.pop(); }
 };
 
+// Directory with the precompiled bytecode of scripts loaded with
+// Engine::evalFileCached(). Entries are content-addressed (the file
+// name is the hash of the script source), so editing a script just
+// creates a new entry and a stale chunk is never executed.
+std::string bytecode_cache_dir()
+{
+  static std::string dir;
+  static bool initialized = false;
+  if (!initialized) {
+    initialized = true;
+    try {
+      ResourceFinder rf;
+      rf.includeUserDir(base::join_path("script-cache", ".").c_str());
+      std::string path = rf.getFirstOrCreateDefault();
+      if (!base::is_directory(path))
+        base::make_directory(path);
+      if (base::is_directory(path))
+        dir = path;
+    }
+    catch (const std::exception&) {
+      // Leave dir empty: cache disabled
+    }
+  }
+  return dir;
+}
+
+int bytecode_writer(lua_State*, const void* p, size_t size, void* ud)
+{
+  ((std::string*)ud)->append((const char*)p, size);
+  return 0;
+}
+
+// Returns the precompiled chunk of the given script source, from the
+// bytecode cache when a valid entry exists, compiling the source and
+// saving the result otherwise. Returns an empty string when the
+// source must be executed directly (cache disabled, or the script
+// doesn't compile and evalCode() will report the syntax error).
+std::string precompiled_chunk(lua_State* L, const std::string& source, const std::string& chunkName)
+{
+  const std::string dir = bytecode_cache_dir();
+  if (dir.empty())
+    return std::string();
+
+  const std::string fn = base::join_path(
+    dir,
+    base::convert_to<std::string>(base::Sha1::calculateFromString(source)) + ".luac");
+
+  if (base::is_file(fn)) {
+    std::stringstream buf;
+    std::ifstream s(FSTREAM_PATH(fn), std::ifstream::binary);
+    if (s) {
+      buf << s.rdbuf();
+      std::string chunk = buf.str();
+      // Check that this Lua can still load the chunk (the cache can
+      // contain bytecode of a previous Lua version).
+      if (!chunk.empty() &&
+          luaL_loadbuffer(L, chunk.c_str(), chunk.size(), chunkName.c_str()) == LUA_OK) {
+        lua_pop(L, 1);
+        return chunk;
+      }
+      lua_pop(L, 1);
+    }
+  }
+
+  // Compile the source and save its bytecode for the next execution.
+  if (luaL_loadbuffer(L, source.c_str(), source.size(), chunkName.c_str()) != LUA_OK) {
+    lua_pop(L, 1);
+    return std::string();
+  }
+  std::string chunk;
+  lua_dump(L, bytecode_writer, &chunk, 0); // strip=0 keeps debug info for tracebacks
+  lua_pop(L, 1);
+
+  if (!chunk.empty()) {
+    std::ofstream s(FSTREAM_PATH(fn), std::ofstream::binary);
+    if (s)
+      s.write(chunk.c_str(), chunk.size());
+  }
+  return chunk;
+}
+
 int print(lua_State* L)
 {
   std::string output;
@@ -200,6 +285,7 @@ void register_sprite_class(lua_State* L);
 void register_sprites_class(lua_State* L);
 void register_tag_class(lua_State* L);
 void register_tags_class(lua_State* L);
+void register_task_class(lua_State* L);
 void register_theme_classes(lua_State* L);
 void register_clipboard_classes(lua_State* L);
 void register_tile_class(lua_State* L);
@@ -213,6 +299,26 @@ void register_websocket_class(lua_State* L);
 
 void set_app_params(lua_State* L, const Params& params);
 
+// Address used as a key in the Lua registry to store the app::Context
+// associated with the Lua state.
+static const char* kAppContextKey = "AppContext";
+
+app::Context* get_app_context(lua_State* L)
+{
+  lua_rawgetp(L, LUA_REGISTRYINDEX, (void*)&kAppContextKey);
+  auto* ctx = (app::Context*)lua_touserdata(L, -1);
+  lua_pop(L, 1);
+  if (!ctx)
+    ctx = App::instance()->context();
+  return ctx;
+}
+
+void set_app_context(lua_State* L, app::Context* ctx)
+{
+  lua_pushlightuserdata(L, (void*)ctx);
+  lua_rawsetp(L, LUA_REGISTRYINDEX, (void*)&kAppContextKey);
+}
+
 Engine::Engine() : L(luaL_newstate()), m_delegate(nullptr), m_printLastResult(false)
 {
 #if _DEBUG
@@ -502,6 +608,7 @@ Engine::Engine() : L(luaL_newstate()), m_delegate(nullptr), m_printLastResult(fa
   register_sprites_class(L);
   register_tag_class(L);
   register_tags_class(L);
+  register_task_class(L);
   register_theme_classes(L);
   register_clipboard_classes(L);
   register_tile_class(L);
@@ -526,7 +633,10 @@ Engine::~Engine()
 
 void Engine::destroy()
 {
-  close_all_dialogs();
+  // Dialogs belong to the UI thread, engines destroyed in background
+  // threads (app.spawn() tasks) don't create them.
+  if (ui::is_ui_thread())
+    close_all_dialogs();
   lua_close(L);
   L = nullptr;
 }
@@ -632,6 +742,30 @@ bool Engine::evalFile(const std::string& filename, const Params& params)
   return result;
 }
 
+bool Engine::evalFileCached(const std::string& filename, const Params& params)
+{
+  // The debugger needs to step through the source code.
+  if (g_debuggerDelegate)
+    return evalFile(filename, params);
+
+  std::stringstream buf;
+  {
+    std::ifstream s(FSTREAM_PATH(filename));
+    // Returns false if we cannot open the file
+    if (!s)
+      return false;
+    buf << s.rdbuf();
+  }
+  std::string absFilename = base::get_absolute_path(filename);
+
+  AddScriptFilename addScript(absFilename);
+  set_app_params(L, params);
+
+  const std::string chunkName = "@" + absFilename;
+  const std::string chunk = precompiled_chunk(L, buf.str(), chunkName);
+  return evalCode(chunk.empty() ? buf.str() : chunk, chunkName);
+}
+
 bool Engine::evalUserFile(const std::string& filename, const Params& params)
 {
   // Set the _SCRIPT_PATH global so require() can find .lua files from
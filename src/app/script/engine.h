@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -61,6 +61,7 @@ class Window;
 
 namespace app {
 
+class Context;
 class Editor;
 class Site;
 
@@ -101,6 +102,11 @@ public:
   void printLastResult();
   bool evalCode(const std::string& code, const std::string& filename = std::string());
   bool evalFile(const std::string& filename, const Params& params = Params());
+  // Like evalFile(), but keeps the compiled bytecode of the script in
+  // a cache in the user configuration directory (keyed by content
+  // hash), so unchanged scripts skip the Lua compiler in the next
+  // execution. Used to load plugin scripts at startup.
+  bool evalFileCached(const std::string& filename, const Params& params = Params());
   bool evalUserFile(const std::string& filename, const Params& params = Params());
 
   void handleException(const std::exception& ex);
@@ -139,6 +145,13 @@ private:
   EngineDelegate* m_oldDelegate;
 };
 
+// Returns the app::Context where scripts running in the given Lua
+// state operate. By default it's the main application context
+// (App::instance()->context()), but engines spawned with app.spawn{}
+// run in a background thread with their own non-UI context.
+app::Context* get_app_context(lua_State* L);
+void set_app_context(lua_State* L, app::Context* ctx);
+
 void push_app_events(lua_State* L);
 void push_app_theme(lua_State* L, int uiscale = 1);
 void push_app_clipboard(lua_State* L);
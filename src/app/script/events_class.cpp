@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2021-2024  Igara Studio S.A.
+// Copyright (C) 2021-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -24,15 +24,21 @@
 #include "app/site.h"
 #include "app/ui/main_window.h"
 #include "doc/document.h"
+#include "doc/layer.h"
 #include "doc/sprite.h"
 #include "ui/app_state.h"
 #include "ui/resize_event.h"
+#include "ui/system.h"
 
+#include <algorithm>
 #include <any>
 #include <cstring>
 #include <initializer_list>
 #include <map>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 // This event was disabled because it can be triggered in a background thread
 // when any effect (e.g. like Replace Color or Convolution Matrix) is running.
@@ -45,49 +51,75 @@ using namespace doc;
 
 namespace {
 
-using EventListener = int;
+// A listener is a reference to a Lua callback function in the Lua
+// registry plus the subscription options given in the Events:on()
+// options table.
+struct EventListener {
+  int callbackRef;
+  // Deliver one callback per UI-loop cycle (with a "changes" counter
+  // in the "ev" argument) instead of one callback per notification,
+  // e.g. so painting doesn't fire dozens of "change" callbacks per
+  // stroke.
+  bool coalesce = false;
+  // Only deliver events related to this specific layer.
+  doc::ObjectId layerId = doc::NullId;
+};
 
 class AppEvents;
 class WindowEvents;
 class SpriteEvents;
+class Events;
 static std::unique_ptr<AppEvents> g_appEvents;
 static std::unique_ptr<WindowEvents> g_windowEvents;
 static std::map<doc::ObjectId, std::unique_ptr<SpriteEvents>> g_spriteEvents;
 
+// Events instances with coalesced calls waiting to be delivered in
+// the next UI-loop cycle (an Events removes itself in its dtor).
+static std::vector<Events*> g_pendingCoalesced;
+static bool g_coalescedFlushScheduled = false;
+
+static void schedule_coalesced_flush();
+
 class Events {
 public:
   using EventType = int;
+  using EventArgs = std::vector<std::pair<std::string, std::any>>;
 
   Events() {}
-  virtual ~Events() {}
+  virtual ~Events()
+  {
+    auto it = std::find(g_pendingCoalesced.begin(), g_pendingCoalesced.end(), this);
+    if (it != g_pendingCoalesced.end())
+      g_pendingCoalesced.erase(it);
+  }
   Events(const Events&) = delete;
   Events& operator=(const Events&) = delete;
 
   virtual EventType eventType(const char* eventName) const = 0;
 
-  bool hasListener(EventListener callbackRef) const
+  bool hasListener(int callbackRef) const
   {
     for (auto& listeners : m_listeners) {
-      for (EventListener listener : listeners) {
-        if (listener == callbackRef)
+      for (const EventListener& listener : listeners) {
+        if (listener.callbackRef == callbackRef)
           return true;
       }
     }
     return false;
   }
 
-  void add(EventType eventType, EventListener callbackRef)
+  void add(EventType eventType, const EventListener& listener)
   {
     if (eventType >= m_listeners.size())
       m_listeners.resize(eventType + 1);
 
     auto& listeners = m_listeners[eventType];
-    listeners.push_back(callbackRef);
+    listeners.push_back(listener);
     if (listeners.size() == 1)
       onAddFirstListener(eventType);
   }
 
-  void remove(EventListener callbackRef)
+  void remove(int callbackRef)
   {
     for (int i = 0; i < int(m_listeners.size()); ++i) {
       EventListeners& listeners = m_listeners[i];
@@ -95,7 +127,7 @@ public:
       auto end = listeners.end();
       bool removed = false;
       for (; it != end;) {
-        if (*it == callbackRef) {
+        if (it->callbackRef == callbackRef) {
           removed = true;
           it = listeners.erase(it);
           end = listeners.end();
@@ -108,50 +140,138 @@ public:
     }
   }
 
+  // Delivers the coalesced calls accumulated since the last UI-loop
+  // cycle, one callback per listener with the latest event fields and
+  // a "changes" counter.
+  void flushCoalesced()
+  {
+    std::vector<PendingCall> calls;
+    calls.swap(m_pendingCalls);
+
+    try {
+      for (auto& pending : calls) {
+        // Skip listeners removed while the call was pending
+        if (!hasListener(pending.callbackRef))
+          continue;
+
+        pending.args.emplace_back("changes", pending.changes);
+        callListener(pending.callbackRef, pending.args);
+      }
+    }
+    catch (const std::exception& ex) {
+      App::instance()->scriptEngine()->consolePrint(ex.what());
+    }
+  }
+
 protected:
   void call(EventType eventType,
-            const std::initializer_list<std::pair<const std::string, std::any>>& args = {})
+            const std::initializer_list<std::pair<const std::string, std::any>>& args = {},
+            const doc::Layer* layer = nullptr)
   {
     if (eventType >= m_listeners.size())
       return;
 
-    script::Engine* engine = App::instance()->scriptEngine();
-    lua_State* L = engine->luaState();
-
     try {
-      for (EventListener callbackRef : m_listeners[eventType]) {
-        // Get user-defined callback function
-        lua_rawgeti(L, LUA_REGISTRYINDEX, callbackRef);
-
-        int callbackArgs = 0;
-        if (args.size() > 0) {
-          ++callbackArgs;
-          lua_newtable(L); // Create "ev" argument with fields about the event
-          for (const auto& kv : args) {
-            push_value_to_lua(L, kv.second);
-            lua_setfield(L, -2, kv.first.c_str());
-          }
-        }
+      for (const EventListener& listener : m_listeners[eventType]) {
+        // Subscription filter by layer
+        if (listener.layerId != doc::NullId && (!layer || layer->id() != listener.layerId))
+          continue;
 
-        if (lua_pcall(L, callbackArgs, 0, 0)) {
-          if (const char* s = lua_tostring(L, -1))
-            engine->consolePrint(s);
-        }
+        if (listener.coalesce)
+          coalesce(eventType, listener.callbackRef, args);
+        else
+          callListener(listener.callbackRef, args);
       }
     }
     catch (const std::exception& ex) {
-      engine->consolePrint(ex.what());
+      App::instance()->scriptEngine()->consolePrint(ex.what());
     }
   }
 
 private:
+  template<typename Args>
+  void callListener(const int callbackRef, const Args& args)
+  {
+    script::Engine* engine = App::instance()->scriptEngine();
+    lua_State* L = engine->luaState();
+
+    // Get user-defined callback function
+    lua_rawgeti(L, LUA_REGISTRYINDEX, callbackRef);
+
+    int callbackArgs = 0;
+    if (args.size() > 0) {
+      ++callbackArgs;
+      lua_newtable(L); // Create "ev" argument with fields about the event
+      for (const auto& kv : args) {
+        push_value_to_lua(L, kv.second);
+        lua_setfield(L, -2, kv.first.c_str());
+      }
+    }
+
+    if (lua_pcall(L, callbackArgs, 0, 0)) {
+      if (const char* s = lua_tostring(L, -1))
+        engine->consolePrint(s);
+    }
+  }
+
+  void coalesce(const EventType eventType,
+                const int callbackRef,
+                const std::initializer_list<std::pair<const std::string, std::any>>& args)
+  {
+    for (auto& pending : m_pendingCalls) {
+      if (pending.eventType == eventType && pending.callbackRef == callbackRef) {
+        pending.args.assign(args.begin(), args.end());
+        ++pending.changes;
+        return;
+      }
+    }
+
+    PendingCall pending;
+    pending.eventType = eventType;
+    pending.callbackRef = callbackRef;
+    pending.args.assign(args.begin(), args.end());
+    m_pendingCalls.push_back(std::move(pending));
+
+    if (std::find(g_pendingCoalesced.begin(), g_pendingCoalesced.end(), this) ==
+        g_pendingCoalesced.end()) {
+      g_pendingCoalesced.push_back(this);
+      schedule_coalesced_flush();
+    }
+  }
+
   virtual void onAddFirstListener(EventType eventType) = 0;
   virtual void onRemoveLastListener(EventType eventType) = 0;
 
+  struct PendingCall {
+    EventType eventType;
+    int callbackRef;
+    EventArgs args; // Fields of the latest coalesced notification
+    int changes = 1;
+  };
+
   using EventListeners = std::vector<EventListener>;
   std::vector<EventListeners> m_listeners;
+  std::vector<PendingCall> m_pendingCalls;
 };
 
+static void schedule_coalesced_flush()
+{
+  if (g_coalescedFlushScheduled)
+    return;
+
+  g_coalescedFlushScheduled = true;
+  ui::execute_from_ui_thread([] {
+    g_coalescedFlushScheduled = false;
+    // Always re-read the global vector as a callback can create or
+    // destroy Events instances (e.g. closing a sprite)
+    while (!g_pendingCoalesced.empty()) {
+      Events* events = g_pendingCoalesced.front();
+      g_pendingCoalesced.erase(g_pendingCoalesced.begin());
+      events->flushCoalesced();
+    }
+  });
+}
+
 // Used in BeforeCommand
 static bool s_stopPropagationFlag = false;
 
@@ -477,7 +597,8 @@ public:
     call(LayerBlendMode,
          {
            { "layer", ev.layer() }
-    });
+    },
+         ev.layer());
   }
 
   void onLayerNameChange(DocEvent& ev) override
@@ -485,7 +606,8 @@ public:
     call(LayerName,
          {
            { "layer", ev.layer() }
-    });
+    },
+         ev.layer());
   }
 
   void onLayerOpacityChange(DocEvent& ev) override
@@ -493,7 +615,8 @@ public:
     call(LayerOpacity,
          {
            { "layer", ev.layer() }
-    });
+    },
+         ev.layer());
   }
 
   void onAfterLayerVisibilityChange(DocEvent& ev) override
@@ -501,7 +624,8 @@ public:
     call(LayerVisibility,
          {
            { "layer", ev.layer() }
-    });
+    },
+         ev.layer());
   }
 
 private:
@@ -558,13 +682,36 @@ int Events_on(lua_State* L)
   if (type < 0)
     return luaL_error(L, "invalid event name to listen");
 
-  if (!lua_isfunction(L, 3))
+  // An optional table with subscription options can be specified
+  // before the callback function, e.g.
+  //   sprite.events:on('change', { coalesce=true }, function(ev) ... end)
+  //   sprite.events:on('layername', { layer=layer }, function(ev) ... end)
+  EventListener listener;
+  int funcIndex = 3;
+  if (lua_istable(L, 3)) {
+    funcIndex = 4;
+
+    lua_getfield(L, 3, "coalesce");
+    listener.coalesce = (lua_toboolean(L, -1) ? true : false);
+    lua_pop(L, 1);
+
+    lua_getfield(L, 3, "layer");
+    if (!lua_isnil(L, -1)) {
+      if (auto layer = may_get_docobj<Layer>(L, -1))
+        listener.layerId = layer->id();
+    }
+    lua_pop(L, 1);
+  }
+
+  if (!lua_isfunction(L, funcIndex))
     return luaL_error(L, "second argument must be a function");
 
   // Copy the callback function to add it to the global registry
-  lua_pushvalue(L, 3);
-  int callbackRef = luaL_ref(L, LUA_REGISTRYINDEX);
-  evs->add(type, callbackRef);
+  lua_pushvalue(L, funcIndex);
+  listener.callbackRef = luaL_ref(L, LUA_REGISTRYINDEX);
+  evs->add(type, listener);
+
+  const int callbackRef = listener.callbackRef;
 
   // Return the callback ref (this is an EventListener easier to use
   // in Events_off())
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2015-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -401,6 +401,120 @@ int Image_getPixel(lua_State* L)
   return 1;
 }
 
+// Rehash the tileset if the image belongs to one (same as
+// Image:drawPixel() does after modifying the image).
+static void notify_image_change(lua_State* L, ImageObj* obj)
+{
+  if (obj->tilesetId) {
+    if (doc::Tileset* ts = obj->tileset(L)) {
+      ts->incrementVersion();
+      ts->notifyTileContentChange(obj->ti);
+    }
+  }
+}
+
+// Image:getBytes([rectangle]) returns the raw bytes of the given
+// rectangle (or the whole image) in one string, so scripts can
+// process pixels in bulk instead of crossing the Lua/C++ boundary
+// once per pixel with Image:getPixel().
+int Image_getBytes(lua_State* L)
+{
+  const auto img = get_obj<ImageObj>(L, 1)->image(L);
+  if (lua_isnoneornil(L, 2)) {
+    // Whole image, same as the "bytes" property.
+    lua_pushlstring(L, (const char*)img->getPixelAddress(0, 0), img->rowBytes() * img->height());
+    return 1;
+  }
+
+  gfx::Rect rc = convert_args_into_rect(L, 2);
+  rc &= img->bounds();
+  if (rc.isEmpty()) {
+    lua_pushlstring(L, "", 0);
+    return 1;
+  }
+
+  const size_t rowSize = rc.w * img->bytesPerPixel();
+  luaL_Buffer buf;
+  luaL_buffinit(L, &buf);
+  for (int y = rc.y; y < rc.y2(); ++y)
+    luaL_addlstring(&buf, (const char*)img->getPixelAddress(rc.x, y), rowSize);
+  luaL_pushresult(&buf);
+  return 1;
+}
+
+// Image:setBytes(bytes, [rectangle]) writes raw bytes into the given
+// rectangle (or the whole image), the bulk counterpart of
+// Image:drawPixel() and a ranged version of the "bytes" property
+// setter.
+int Image_setBytes(lua_State* L)
+{
+  auto obj = get_obj<ImageObj>(L, 1);
+  auto img = obj->image(L);
+  size_t bytes_size;
+  const char* bytes = lua_tolstring(L, 2, &bytes_size);
+
+  gfx::Rect rc;
+  if (lua_isnoneornil(L, 3))
+    rc = img->bounds();
+  else {
+    rc = convert_args_into_rect(L, 3);
+    if (!img->bounds().contains(rc)) {
+      lua_pushfstring(L, "Rectangle is out of the image bounds.");
+      lua_error(L);
+    }
+  }
+
+  const size_t rowSize = rc.w * img->bytesPerPixel();
+  const size_t bytes_needed = rowSize * rc.h;
+  if (bytes_size != bytes_needed) {
+    lua_pushfstring(L, "Data size does not match: given %d, needed %d.", bytes_size, bytes_needed);
+    lua_error(L);
+  }
+
+  for (int y = rc.y; y < rc.y2(); ++y, bytes += rowSize)
+    std::memcpy(img->getPixelAddress(rc.x, y), bytes, rowSize);
+
+  notify_image_change(L, obj);
+  return 0;
+}
+
+// Image:applyRows(function) calls the given function once per row
+// with (bytes, y); if the function returns a string of the same
+// length, the row is replaced with it. One call per row instead of
+// one call per pixel keeps the Lua overhead negligible for
+// procedural generators.
+int Image_applyRows(lua_State* L)
+{
+  auto obj = get_obj<ImageObj>(L, 1);
+  auto img = obj->image(L);
+  luaL_checktype(L, 2, LUA_TFUNCTION);
+
+  const size_t rowSize = img->width() * img->bytesPerPixel();
+  const int h = img->height();
+  bool modified = false;
+  for (int y = 0; y < h; ++y) {
+    lua_pushvalue(L, 2);
+    lua_pushlstring(L, (const char*)img->getPixelAddress(0, y), rowSize);
+    lua_pushinteger(L, y);
+    lua_call(L, 2, 1);
+    if (lua_isstring(L, -1)) {
+      size_t len;
+      const char* s = lua_tolstring(L, -1, &len);
+      if (len != rowSize) {
+        lua_pushfstring(L, "Row size does not match: given %d, needed %d.", len, rowSize);
+        lua_error(L);
+      }
+      std::memcpy(img->getPixelAddress(0, y), s, len);
+      modified = true;
+    }
+    lua_pop(L, 1);
+  }
+
+  if (modified)
+    notify_image_change(L, obj);
+  return 0;
+}
+
 int Image_isEqual(lua_State* L)
 {
   auto objA = get_obj<ImageObj>(L, 1);
@@ -507,7 +621,7 @@ int Image_saveAs(lua_State* L)
   sprite.release();
   doc->setFilename(absFn);
 
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   result = (save_document(ctx, doc.get()) >= 0);
 
   lua_pushboolean(L, result);
@@ -583,7 +697,7 @@ int Image_resize(lua_State* L)
     obj->imageId = cel->image()->id();
   }
   else {
-    Context* ctx = App::instance()->context();
+    Context* ctx = get_app_context(L);
     ASSERT(ctx);
     Site site = ctx->activeSite();
     const doc::Palette* pal = site.palette();
@@ -764,6 +878,9 @@ const luaL_Reg Image_methods[] = {
   { "drawSprite",   Image_drawSprite   },
   { "putSprite",    Image_drawSprite   }, // TODO putSprite is deprecated
   { "pixels",       Image_pixels       },
+  { "getBytes",     Image_getBytes     },
+  { "setBytes",     Image_setBytes     },
+  { "applyRows",    Image_applyRows    },
   { "isEqual",      Image_isEqual      },
   { "isEmpty",      Image_isEmpty      },
   { "isPlain",      Image_isPlain      },
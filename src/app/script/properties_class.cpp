@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2022-2025  Igara Studio S.A.
+// Copyright (C) 2022-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -122,7 +122,7 @@ int Properties_newindex(lua_State* L)
   // Set property value with undo info
   // TODO add Object::sprite() member function
   // if (obj->sprite()) {
-  if (Doc* doc = App::instance()->context()->activeDocument(); doc && doc->transaction()) {
+  if (Doc* doc = get_app_context(L)->activeDocument(); doc && doc->transaction()) {
     Tx tx(doc); // TODO propObj might not be member of "doc"
     if (propObj->ti != doc::notile) {
       tx(new cmd::SetTileDataProperty(static_cast<doc::Tileset*>(obj),
@@ -173,7 +173,7 @@ int Properties_call(lua_State* L)
 
   // TODO add Object::sprite() member function
   // if (obj->sprite()) {
-  if (Doc* doc = App::instance()->context()->activeDocument(); doc && doc->transaction()) {
+  if (Doc* doc = get_app_context(L)->activeDocument(); doc && doc->transaction()) {
     Tx tx(doc); // TODO propObj might not be member of "doc"
     if (propObj->ti != doc::notile) {
       tx(new cmd::SetTileDataProperties(static_cast<doc::Tileset*>(obj),
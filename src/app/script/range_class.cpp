@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2023  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -175,7 +175,7 @@ int Range_containsTile(lua_State* L)
 int Range_clear(lua_State* L)
 {
   auto obj = get_obj<RangeObj>(L, 1);
-  auto ctx = App::instance()->context();
+  auto ctx = get_app_context(L);
 
   // Set an empty range
   DocRange range;
@@ -304,7 +304,7 @@ int Range_get_slices(lua_State* L)
 int Range_set_layers(lua_State* L)
 {
   auto obj = get_obj<RangeObj>(L, 1);
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   DocRange range = ctx->activeSite().range();
 
   doc::SelectedLayers layers;
@@ -326,7 +326,7 @@ int Range_set_layers(lua_State* L)
 int Range_set_frames(lua_State* L)
 {
   auto obj = get_obj<RangeObj>(L, 1);
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   DocRange range = ctx->activeSite().range();
 
   doc::SelectedFrames frames;
@@ -348,7 +348,7 @@ int Range_set_frames(lua_State* L)
 int Range_set_colors(lua_State* L)
 {
   auto obj = get_obj<RangeObj>(L, 1);
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   doc::PalettePicks picks;
   if (lua_istable(L, 2)) {
     lua_pushnil(L);
@@ -369,7 +369,7 @@ int Range_set_colors(lua_State* L)
 int Range_set_tiles(lua_State* L)
 {
   auto obj = get_obj<RangeObj>(L, 1);
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   doc::PalettePicks picks;
   if (lua_istable(L, 2)) {
     lua_pushnil(L);
@@ -389,7 +389,7 @@ int Range_set_tiles(lua_State* L)
 int Range_set_slices(lua_State* L)
 {
   auto obj = get_obj<RangeObj>(L, 1);
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
 
   // TODO we should add support to CLI scripts
   if (auto editor = Editor::activeEditor()) {
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2018  David Capello
 //
 // This program is distributed under the terms of
@@ -315,7 +315,7 @@ bool ask_access(lua_State* L,
                 const int stackLevel)
 {
   // Ask for permission to open the file
-  if (App::instance()->context()->isUIAvailable()) {
+  if (get_app_context(L)->isUIAvailable()) {
     const std::string script = get_script_filename(L, stackLevel);
     if (script.empty()) {
       // No script
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2015-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -52,6 +52,7 @@
 #include "app/transaction.h"
 #include "app/tx.h"
 #include "app/ui/doc_view.h"
+#include "app/util/duplicate_frames.h"
 #include "base/convert_to.h"
 #include "base/fs.h"
 #include "base/gcd.h"
@@ -141,7 +142,7 @@ int Sprite_new(lua_State* L)
     sprite.release();
   }
 
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   doc->setContext(ctx);
 
   push_docobj(L, doc->sprite());
@@ -175,7 +176,7 @@ int Sprite_resize(lua_State* L)
   params.set("width", base::convert_to<std::string>(size.w).c_str());
   params.set("height", base::convert_to<std::string>(size.h).c_str());
 
-  app::Context* appCtx = App::instance()->context();
+  app::Context* appCtx = get_app_context(L);
   auto oldDoc = appCtx->activeDocument();
   appCtx->setActiveDocument(static_cast<Doc*>(sprite->document()));
   appCtx->executeCommand(resizeCommand, params);
@@ -215,7 +216,7 @@ int Sprite_saveAs_base(lua_State* L, std::string& absFn)
   const char* fn = luaL_checkstring(L, 2);
   if (fn && sprite) {
     Doc* doc = static_cast<Doc*>(sprite->document());
-    app::Context* appCtx = App::instance()->context();
+    app::Context* appCtx = get_app_context(L);
     appCtx->setActiveDocument(doc);
 
     absFn = base::get_absolute_path(fn);
@@ -452,6 +453,20 @@ int Sprite_deleteFrame(lua_State* L)
   return 0;
 }
 
+int Sprite_deleteDuplicateFrames(lua_State* L)
+{
+  auto sprite = get_docobj<Sprite>(L, 1);
+  Doc* doc = static_cast<Doc*>(sprite->document());
+
+  Tx tx(doc);
+  const int removed = merge_duplicate_frames(doc, sprite, tx);
+  if (removed > 0)
+    tx.commit();
+
+  lua_pushinteger(L, removed);
+  return 1;
+}
+
 int Sprite_newCel(lua_State* L)
 {
   auto sprite = get_docobj<Sprite>(L, 1);
@@ -1067,40 +1082,41 @@ int Sprite_get_undoHistory(lua_State* L)
 }
 
 const luaL_Reg Sprite_methods[] = {
-  { "__eq",              Sprite_eq                },
-  { "resize",            Sprite_resize            },
-  { "crop",              Sprite_crop              },
-  { "saveAs",            Sprite_saveAs            },
-  { "saveCopyAs",        Sprite_saveCopyAs        },
-  { "close",             Sprite_close             },
-  { "loadPalette",       Sprite_loadPalette       },
-  { "setPalette",        Sprite_setPalette        },
-  { "assignColorSpace",  Sprite_assignColorSpace  },
-  { "convertColorSpace", Sprite_convertColorSpace },
-  { "flatten",           Sprite_flatten           },
+  { "__eq",                  Sprite_eq                    },
+  { "resize",                Sprite_resize                },
+  { "crop",                  Sprite_crop                  },
+  { "saveAs",                Sprite_saveAs                },
+  { "saveCopyAs",            Sprite_saveCopyAs            },
+  { "close",                 Sprite_close                 },
+  { "loadPalette",           Sprite_loadPalette           },
+  { "setPalette",            Sprite_setPalette            },
+  { "assignColorSpace",      Sprite_assignColorSpace      },
+  { "convertColorSpace",     Sprite_convertColorSpace     },
+  { "flatten",               Sprite_flatten               },
   // Layers
-  { "newLayer",          Sprite_newLayer          },
-  { "newGroup",          Sprite_newGroup          },
-  { "deleteLayer",       Sprite_deleteLayer       },
+  { "newLayer",              Sprite_newLayer              },
+  { "newGroup",              Sprite_newGroup              },
+  { "deleteLayer",           Sprite_deleteLayer           },
   // Frames
-  { "newFrame",          Sprite_newFrame          },
-  { "newEmptyFrame",     Sprite_newEmptyFrame     },
-  { "deleteFrame",       Sprite_deleteFrame       },
+  { "newFrame",              Sprite_newFrame              },
+  { "newEmptyFrame",         Sprite_newEmptyFrame         },
+  { "deleteFrame",           Sprite_deleteFrame           },
+  { "deleteDuplicateFrames", Sprite_deleteDuplicateFrames },
   // Cel
-  { "newCel",            Sprite_newCel            },
-  { "deleteCel",         Sprite_deleteCel         },
+  { "newCel",                Sprite_newCel                },
+  { "deleteCel",             Sprite_deleteCel             },
   // Tag
-  { "newTag",            Sprite_newTag            },
-  { "deleteTag",         Sprite_deleteTag         },
+  { "newTag",                Sprite_newTag                },
+  { "deleteTag",             Sprite_deleteTag             },
   // Slices
-  { "newSlice",          Sprite_newSlice          },
-  { "deleteSlice",       Sprite_deleteSlice       },
+  { "newSlice",              Sprite_newSlice              },
+  { "deleteSlice",           Sprite_deleteSlice           },
   // Tilesets & Tiles
-  { "newTileset",        Sprite_newTileset        },
-  { "deleteTileset",     Sprite_deleteTileset     },
-  { "newTile",           Sprite_newTile           },
-  { "deleteTile",        Sprite_deleteTile        },
-  { nullptr,             nullptr                  }
+  { "newTileset",            Sprite_newTileset            },
+  { "deleteTileset",         Sprite_deleteTileset         },
+  { "newTile",               Sprite_newTile               },
+  { "deleteTile",            Sprite_deleteTile            },
+  { nullptr,                 nullptr                      }
 };
 
 const Property Sprite_properties[] = {
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2018  David Capello
 //
 // This program is distributed under the terms of
@@ -83,7 +83,7 @@ void register_sprites_class(lua_State* L)
 
 void push_sprites(lua_State* L)
 {
-  app::Context* ctx = App::instance()->context();
+  app::Context* ctx = get_app_context(L);
   push_new<SpritesObj>(L, ctx->documents());
 }
 
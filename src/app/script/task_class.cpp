@@ -0,0 +1,218 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/commands/params.h"
+#include "app/context.h"
+#include "app/script/engine.h"
+#include "app/script/luacpp.h"
+#include "app/script/security.h"
+#include "base/fs.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace app { namespace script {
+
+namespace {
+
+// State shared between the Task userdata (owned by the Lua state that
+// called app.spawn()) and the background thread running the script.
+struct TaskState {
+  std::thread thread;
+
+  // Written by the background thread before "done" is set to true,
+  // read by the parent script only after "done" is true (or after
+  // joining the thread in Task:wait()).
+  bool ok = false;
+  std::string error;
+  std::string output;
+  std::atomic<bool> done = { false };
+};
+
+// Collects the console output/errors of the background engine so they
+// can be inspected from the parent script when the task finishes.
+class TaskEngineDelegate : public EngineDelegate {
+public:
+  TaskEngineDelegate(TaskState* state) : m_state(state) {}
+
+  void onConsoleError(const char* text) override
+  {
+    if (text) {
+      m_state->error += text;
+      m_state->error += '\n';
+    }
+  }
+
+  void onConsolePrint(const char* text) override
+  {
+    if (text) {
+      m_state->output += text;
+      m_state->output += '\n';
+    }
+  }
+
+private:
+  TaskState* m_state;
+};
+
+struct Task {
+  std::shared_ptr<TaskState> state;
+  Task() : state(std::make_shared<TaskState>()) {}
+};
+
+int Task_gc(lua_State* L)
+{
+  auto obj = get_obj<Task>(L, 1);
+  if (obj->state->thread.joinable()) {
+    if (obj->state->done)
+      obj->state->thread.join();
+    else {
+      // Let the task run to completion, the thread keeps the shared
+      // state alive.
+      obj->state->thread.detach();
+    }
+  }
+  obj->~Task();
+  return 0;
+}
+
+int Task_wait(lua_State* L)
+{
+  auto obj = get_obj<Task>(L, 1);
+  if (obj->state->thread.joinable())
+    obj->state->thread.join();
+  lua_pushboolean(L, obj->state->ok);
+  return 1;
+}
+
+int Task_get_running(lua_State* L)
+{
+  const auto obj = get_obj<Task>(L, 1);
+  lua_pushboolean(L, !obj->state->done);
+  return 1;
+}
+
+int Task_get_error(lua_State* L)
+{
+  const auto obj = get_obj<Task>(L, 1);
+  if (obj->state->done && !obj->state->error.empty())
+    lua_pushstring(L, obj->state->error.c_str());
+  else
+    lua_pushnil(L);
+  return 1;
+}
+
+int Task_get_output(lua_State* L)
+{
+  const auto obj = get_obj<Task>(L, 1);
+  if (obj->state->done)
+    lua_pushstring(L, obj->state->output.c_str());
+  else
+    lua_pushnil(L);
+  return 1;
+}
+
+const luaL_Reg Task_methods[] = {
+  { "__gc",  Task_gc   },
+  { "wait",  Task_wait },
+  { nullptr, nullptr   }
+};
+
+const Property Task_properties[] = {
+  { "running", Task_get_running, nullptr },
+  { "error",   Task_get_error,   nullptr },
+  { "output",  Task_get_output,  nullptr },
+  { nullptr,   nullptr,          nullptr }
+};
+
+} // anonymous namespace
+
+DEF_MTNAME(Task);
+
+// app.spawn{ script=fn, params={...} }
+//
+// Runs the given script file in a background thread with its own Lua
+// state and its own (non-UI) app::Context, so several scripts can
+// open/process/save sprites in parallel without touching the UI or
+// the documents of the main context. The spawned script must not use
+// UI-related APIs (dialogs, app.alert, app.editor, etc.).
+int App_spawn(lua_State* L)
+{
+  if (!lua_istable(L, 1))
+    return luaL_error(L, "app.spawn() must be called with a table as its first argument");
+
+  lua_getfield(L, 1, "script");
+  const char* fn = lua_tostring(L, -1);
+  if (!fn)
+    return luaL_error(L, "app.spawn() needs a 'script' field with a file name");
+  std::string absFn = base::get_absolute_path(fn);
+  lua_pop(L, 1);
+
+  // The spawned script runs on a non-UI context with the same access
+  // level as scripts executed from the CLI (--script), so here we ask
+  // for full access to it.
+  if (!ask_access(L, absFn.c_str(), FileAccessMode::Full, ResourceType::File))
+    return luaL_error(L, "the script doesn't have access to run file %s", absFn.c_str());
+
+  Params params;
+  lua_getfield(L, 1, "params");
+  if (lua_istable(L, -1)) {
+    lua_pushnil(L);
+    while (lua_next(L, -2) != 0) {
+      // Don't convert the key in-place with lua_tostring() (it would
+      // confuse lua_next() for number keys)
+      if (lua_type(L, -2) == LUA_TSTRING) {
+        if (const char* value = lua_tostring(L, -1))
+          params.set(lua_tostring(L, -2), value);
+      }
+      lua_pop(L, 1);
+    }
+  }
+  lua_pop(L, 1);
+
+  auto task = push_new<Task>(L);
+  auto state = task->state;
+
+  state->thread = std::thread([state, absFn, params] {
+    TaskEngineDelegate delegate(state.get());
+    try {
+      // Isolated context for this task, the documents opened by the
+      // spawned script don't appear in the main context/UI.
+      app::Context ctx;
+      Engine engine;
+      engine.setDelegate(&delegate);
+      set_app_context(engine.luaState(), &ctx);
+      try {
+        state->ok = engine.evalFile(absFn, params);
+      }
+      catch (const std::exception& ex) {
+        delegate.onConsoleError(ex.what());
+        state->ok = false;
+      }
+      engine.destroy();
+    }
+    catch (const std::exception& ex) {
+      delegate.onConsoleError(ex.what());
+      state->ok = false;
+    }
+    state->done = true;
+  });
+  return 1;
+}
+
+void register_task_class(lua_State* L)
+{
+  REG_CLASS(L, Task);
+  REG_CLASS_PROPERTIES(L, Task);
+}
+
+}} // namespace app::script
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2021  Igara Studio S.A.
+// Copyright (C) 2021-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -13,12 +13,18 @@
 #include "app/script/engine.h"
 #include "app/script/luacpp.h"
 #include "app/script/security.h"
+#include "base/chrono.h"
+#include "doc/image.h"
 #include "ui/manager.h"
 #include "ui/system.h"
 #include "ui/timer.h"
 
 #include <ixwebsocket/IXNetSystem.h>
 #include <ixwebsocket/IXWebSocket.h>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
 #include <set>
 #include <sstream>
 
@@ -32,10 +38,129 @@ namespace {
 static std::unique_ptr<ui::Timer> g_timer;
 static std::set<ix::WebSocket*> g_connections;
 
+// Lua-side state of each socket with an onreceive callback (only
+// touched from the UI thread).
+struct Receiver {
+  lua_State* L = nullptr;
+  int onreceiveRef = LUA_NOREF;
+  // Target Image for binary payloads (see receiveBinaryInto()).
+  int imageRef = LUA_NOREF;
+};
+
+struct QueuedMessage {
+  ix::WebSocket* ws;
+  int type;
+  std::string data;
+  std::string error;
+};
+
+static std::map<ix::WebSocket*, Receiver> g_receivers;
+
+// Messages received from the socket threads, dispatched in batches
+// from the UI timer (see dispatch_queued_messages()).
+static std::mutex g_queueMutex;
+static std::deque<QueuedMessage> g_queue;
+
+// Per-tick time budget to run onreceive callbacks: when a live-link
+// peer floods us with messages, the rest of the queue waits for the
+// next timer tick so painting isn't starved.
+static const double kDispatchBudgetSecs = 0.004;
+
+// Copies a binary payload straight into the pixel buffer of the
+// Image bound with receiveBinaryInto(), avoiding the creation of one
+// Lua string per streamed frame. Returns false (falling back to the
+// regular string argument) if the image is gone or the payload size
+// doesn't match the image buffer exactly.
+static bool copy_payload_to_image(lua_State* L, const int imageRef, const std::string& data)
+{
+  lua_rawgeti(L, LUA_REGISTRYINDEX, imageRef);
+  doc::Image* img = may_get_image_from_arg(L, lua_gettop(L));
+  lua_pop(L, 1);
+  if (!img)
+    return false;
+
+  const size_t rowSize = img->width() * img->bytesPerPixel();
+  if (data.size() != rowSize * img->height())
+    return false;
+
+  const char* bytes = data.c_str();
+  for (int y = 0; y < img->height(); ++y, bytes += rowSize)
+    std::memcpy(img->getPixelAddress(0, y), bytes, rowSize);
+  return true;
+}
+
+static void dispatch_message(const QueuedMessage& msg)
+{
+  auto it = g_receivers.find(msg.ws);
+  if (it == g_receivers.end()) // The socket was closed in the meantime
+    return;
+
+  const Receiver& rx = it->second;
+  lua_State* L = rx.L;
+
+  bool dataInImage = false;
+  if (msg.type == MESSAGE_TYPE_BINARY && rx.imageRef != LUA_NOREF)
+    dataInImage = copy_payload_to_image(L, rx.imageRef, msg.data);
+
+  lua_rawgeti(L, LUA_REGISTRYINDEX, rx.onreceiveRef);
+  lua_pushinteger(L, msg.type);
+  if (dataInImage)
+    lua_pushnil(L); // The payload was already written into the bound Image
+  else
+    lua_pushlstring(L, msg.data.c_str(), msg.data.length());
+  lua_pushlstring(L, msg.error.c_str(), msg.error.length());
+
+  if (lua_pcall(L, 3, 0, 0)) {
+    if (const char* s = lua_tostring(L, -1)) {
+      App::instance()->scriptEngine()->consolePrint(s);
+      msg.ws->stop();
+    }
+    lua_pop(L, 1);
+  }
+}
+
+static void dispatch_queued_messages()
+{
+  base::Chrono chrono;
+  for (;;) {
+    QueuedMessage msg;
+    {
+      std::unique_lock<std::mutex> lock(g_queueMutex);
+      if (g_queue.empty())
+        break;
+      msg = std::move(g_queue.front());
+      g_queue.pop_front();
+    }
+
+    dispatch_message(msg);
+
+    if (chrono.elapsed() > kDispatchBudgetSecs)
+      break;
+  }
+}
+
 static void close_ws(ix::WebSocket* ws)
 {
   ws->stop();
 
+  auto it = g_receivers.find(ws);
+  if (it != g_receivers.end()) {
+    luaL_unref(it->second.L, LUA_REGISTRYINDEX, it->second.onreceiveRef);
+    if (it->second.imageRef != LUA_NOREF)
+      luaL_unref(it->second.L, LUA_REGISTRYINDEX, it->second.imageRef);
+    g_receivers.erase(it);
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(g_queueMutex);
+    for (auto msgIt = g_queue.begin(); msgIt != g_queue.end();) {
+      if (msgIt->ws == ws)
+        msgIt = g_queue.erase(msgIt);
+      else
+        ++msgIt;
+    }
+  }
+
   g_connections.erase(ws);
   if (g_connections.empty())
     g_timer.reset();
@@ -83,26 +208,32 @@ int WebSocket_new(lua_State* L)
 
     type = lua_getfield(L, 1, "onreceive");
     if (type == LUA_TFUNCTION) {
-      int onreceiveRef = luaL_ref(L, LUA_REGISTRYINDEX);
-
-      ws->setOnMessageCallback([L, ws, onreceiveRef](const ix::WebSocketMessagePtr& msg) {
-        int msgType = (msg->binary ? MESSAGE_TYPE_BINARY : static_cast<int>(msg->type));
-        std::string msgData = msg->str;
-        std::string msgError = msg->errorInfo.reason;
-
-        ui::execute_from_ui_thread([=]() {
-          lua_rawgeti(L, LUA_REGISTRYINDEX, onreceiveRef);
-          lua_pushinteger(L, msgType);
-          lua_pushlstring(L, msgData.c_str(), msgData.length());
-          lua_pushlstring(L, msgError.c_str(), msgError.length());
-
-          if (lua_pcall(L, 3, 0, 0)) {
-            if (const char* s = lua_tostring(L, -1)) {
-              App::instance()->scriptEngine()->consolePrint(s);
-              ws->stop();
-            }
-          }
-        });
+      Receiver rx;
+      rx.L = L;
+      rx.onreceiveRef = luaL_ref(L, LUA_REGISTRYINDEX);
+      g_receivers[ws] = rx;
+
+      // Messages are queued and dispatched in batches from the UI
+      // timer instead of posting one UI event per message, which
+      // floods the event queue when a live-link peer streams at a
+      // high rate (the payload is moved, not copied, out of the
+      // socket thread).
+      ws->setOnMessageCallback([ws](const ix::WebSocketMessagePtr& msg) {
+        QueuedMessage qm;
+        qm.ws = ws;
+        qm.type = (msg->binary ? MESSAGE_TYPE_BINARY : static_cast<int>(msg->type));
+        qm.data = std::move(msg->str);
+        qm.error = msg->errorInfo.reason;
+
+        if (App::instance()->isGui()) {
+          std::unique_lock<std::mutex> lock(g_queueMutex);
+          g_queue.push_back(std::move(qm));
+        }
+        else {
+          // Without the batching timer (CLI scripts) dispatch one
+          // message at a time, as before.
+          ui::execute_from_ui_thread([qm]() { dispatch_message(qm); });
+        }
       });
     }
     else {
@@ -195,6 +326,7 @@ int WebSocket_connect(lua_State* L)
   if (g_connections.empty()) {
     if (App::instance()->isGui()) {
       g_timer = std::make_unique<ui::Timer>(33, ui::Manager::getDefault());
+      g_timer->Tick.connect([] { dispatch_queued_messages(); });
       g_timer->start();
     }
   }
@@ -210,6 +342,34 @@ int WebSocket_close(lua_State* L)
   return 0;
 }
 
+// ws:receiveBinaryInto(image) binds the given Image as the target
+// buffer for binary messages: payloads whose size matches the image
+// pixel buffer exactly are written straight into it and the
+// onreceive callback receives nil as data, so streaming a canvas
+// frame doesn't intern one Lua string per message. Call it with nil
+// to unbind the image.
+int WebSocket_receiveBinaryInto(lua_State* L)
+{
+  auto ws = get_ptr<ix::WebSocket>(L, 1);
+
+  auto it = g_receivers.find(ws);
+  if (it == g_receivers.end())
+    return luaL_error(L, "WebSocket doesn't have an onreceive callback");
+
+  Receiver& rx = it->second;
+  if (rx.imageRef != LUA_NOREF) {
+    luaL_unref(L, LUA_REGISTRYINDEX, rx.imageRef);
+    rx.imageRef = LUA_NOREF;
+  }
+
+  if (!lua_isnoneornil(L, 2)) {
+    get_image_from_arg(L, 2); // Just to validate the argument type
+    lua_pushvalue(L, 2);
+    rx.imageRef = luaL_ref(L, LUA_REGISTRYINDEX);
+  }
+  return 0;
+}
+
 int WebSocket_get_url(lua_State* L)
 {
   auto ws = get_ptr<ix::WebSocket>(L, 1);
@@ -218,13 +378,14 @@ int WebSocket_get_url(lua_State* L)
 }
 
 const luaL_Reg WebSocket_methods[] = {
-  { "__gc",       WebSocket_gc         },
-  { "close",      WebSocket_close      },
-  { "connect",    WebSocket_connect    },
-  { "sendText",   WebSocket_sendText   },
-  { "sendBinary", WebSocket_sendBinary },
-  { "sendPing",   WebSocket_sendPing   },
-  { nullptr,      nullptr              }
+  { "__gc",              WebSocket_gc                },
+  { "close",             WebSocket_close             },
+  { "connect",           WebSocket_connect           },
+  { "sendText",          WebSocket_sendText          },
+  { "sendBinary",        WebSocket_sendBinary        },
+  { "sendPing",          WebSocket_sendPing          },
+  { "receiveBinaryInto", WebSocket_receiveBinaryInto },
+  { nullptr,             nullptr                     }
 };
 
 const Property WebSocket_properties[] = {
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -97,7 +97,8 @@ void SendCrash::search()
         }
       }
     }
-  });
+  },
+             Task::Priority::kBackground);
 
 #endif
 }
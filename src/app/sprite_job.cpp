@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2024  Igara Studio S.A.
+// Copyright (C) 2024-2026  Igara Studio S.A.
 // Copyright (C) 2017  David Capello
 //
 // This program is distributed under the terms of
@@ -11,10 +11,36 @@
 
 #include "app/sprite_job.h"
 
+#include "app/job_scheduler.h"
 #include "base/log.h"
 
+#include <atomic>
+
 namespace app {
 
+namespace {
+
+// Delegate given to each forkJoinCels() item: it forwards the
+// cancellation to the original delegate and discards the item
+// progress (items finish out of order, so forkJoinCels() reports
+// whole finished items instead).
+class ItemTaskDelegate : public render::TaskDelegate {
+public:
+  ItemTaskDelegate(render::TaskDelegate* delegate) : m_delegate(delegate) {}
+
+  bool continueTask() override { return (m_delegate ? m_delegate->continueTask() : true); }
+
+  void notifyTaskProgress(double progress) override
+  {
+    // Ignored
+  }
+
+private:
+  render::TaskDelegate* m_delegate;
+};
+
+} // anonymous namespace
+
 SpriteJob::SpriteJob(Context* ctx, Doc* doc, const std::string& jobName, const bool showProgress)
   : Job(jobName, showProgress)
   , m_doc(doc)
@@ -65,4 +91,25 @@ void SpriteJob::notifyTaskProgress(double progress)
   jobProgress(progress);
 }
 
+// static
+void SpriteJob::forkJoinCels(const int nitems,
+                             render::TaskDelegate* delegate,
+                             const std::function<void(int, render::TaskDelegate*)>& fn)
+{
+  if (nitems <= 0)
+    return;
+
+  ItemTaskDelegate itemDelegate(delegate);
+  std::atomic<int> done(0);
+  JobScheduler::instance()->forkJoin(nitems, [&](int i) {
+    if (delegate && !delegate->continueTask())
+      return;
+
+    fn(i, &itemDelegate);
+
+    if (delegate)
+      delegate->notifyTaskProgress(double(++done) / nitems);
+  });
+}
+
 } // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2024  Igara Studio S.A.
+// Copyright (C) 2024-2026  Igara Studio S.A.
 // Copyright (C) 2017-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -49,6 +49,22 @@ public:
     Job::startJob();
   }
 
+  // Runs fn(i, taskDelegate) for each i in [0, nitems) distributing
+  // the iterations between the JobScheduler worker threads. Useful
+  // for sprite-wide operations where each cel/frame/image can be
+  // processed independently. The given fn must not modify state
+  // shared with other items (e.g. adding sub-Cmds has to be done in
+  // a serial pass after this call returns).
+  //
+  // Progress is reported to the given delegate as the fraction of
+  // finished items, and pending items are not started after the
+  // delegate cancels the task. The taskDelegate received by fn can
+  // be used to poll the cancellation inside one item (its progress
+  // notifications are discarded as items finish out of order).
+  static void forkJoinCels(int nitems,
+                           render::TaskDelegate* delegate,
+                           const std::function<void(int i, render::TaskDelegate* taskDelegate)>& fn);
+
 private:
   virtual void onSpriteJob(Tx& tx);
 
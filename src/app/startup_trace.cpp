@@ -0,0 +1,56 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/startup_trace.h"
+
+#include <cstdio>
+
+namespace app {
+
+// static
+StartupTrace* StartupTrace::instance()
+{
+  static StartupTrace instance;
+  return &instance;
+}
+
+void StartupTrace::enable()
+{
+  m_enabled = true;
+  m_chrono.reset();
+  m_last = 0.0;
+}
+
+void StartupTrace::mark(const char* name)
+{
+  if (!m_enabled)
+    return;
+
+  const double now = m_chrono.elapsed();
+  m_entries.push_back(Entry{ name, (now - m_last) * 1000.0 });
+  m_last = now;
+}
+
+void StartupTrace::report()
+{
+  if (!m_enabled)
+    return;
+
+  double total = 0.0;
+  for (const Entry& entry : m_entries)
+    total += entry.msecs;
+
+  std::printf("Startup trace (%.1fms):\n", total);
+  for (const Entry& entry : m_entries)
+    std::printf("%9.1fms  %s\n", entry.msecs, entry.name);
+  std::fflush(stdout);
+}
+
+} // namespace app
@@ -0,0 +1,59 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_STARTUP_TRACE_H_INCLUDED
+#define APP_STARTUP_TRACE_H_INCLUDED
+#pragma once
+
+#include "base/chrono.h"
+
+#include <vector>
+
+namespace app {
+
+// Collects per-module timings of App::initialize() when the
+// --trace-startup CLI option is given. Each mark() records the time
+// elapsed since the previous mark, so surrounding a startup phase
+// with two marks attributes its cost to the second one. When the
+// trace is disabled (the default) each mark is one boolean check.
+class StartupTrace {
+public:
+  // Times class members: members are constructed in declaration
+  // order, so interleaving Mark members in a module list records the
+  // construction time of the members declared between two Marks
+  // without restructuring the list.
+  struct Mark {
+    Mark(const char* name) { StartupTrace::instance()->mark(name); }
+  };
+
+  static StartupTrace* instance();
+
+  void enable();
+
+  // Records the time since the previous mark under the given name,
+  // which must be a string literal (it's stored by pointer).
+  void mark(const char* name);
+
+  // Prints the collected timings to stdout.
+  void report();
+
+private:
+  StartupTrace() {}
+
+  struct Entry {
+    const char* name;
+    double msecs;
+  };
+
+  bool m_enabled = false;
+  base::Chrono m_chrono;
+  double m_last = 0.0;
+  std::vector<Entry> m_entries;
+};
+
+} // namespace app
+
+#endif
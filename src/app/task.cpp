@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -10,13 +10,38 @@
 
 #include "app/task.h"
 
+#include "app/util/tuning.h"
 #include "base/task.h"
 #include "base/thread.h"
 #include "base/thread_pool.h"
 
+#include <algorithm>
+
 namespace app {
 
-static base::thread_pool tasks_pool(4);
+// Pool sizes: interactive tasks are few but latency-sensitive, so
+// they get their own threads; exports are throughput work that must
+// still leave cores free for whatever the user keeps doing (e.g.
+// painting) while they run; maintenance runs strictly serialized.
+// Inner loops of these operations are parallelized through
+// JobScheduler::forkJoin() anyway, these threads only bound how many
+// whole operations of each class run at the same time.
+static base::thread_pool& pool_for(const Task::Priority priority)
+{
+  switch (priority) {
+    case Task::Priority::kInteractive: {
+      static base::thread_pool pool(std::max(2, tuned_worker_count() / 2));
+      return pool;
+    }
+    case Task::Priority::kExport: {
+      static base::thread_pool pool(std::max(1, tuned_worker_count() / 4));
+      return pool;
+    }
+    case Task::Priority::kBackground: break;
+  }
+  static base::thread_pool pool(1);
+  return pool;
+}
 
 Task::Task() : m_token(nullptr)
 {
@@ -26,11 +51,11 @@ Task::~Task()
 {
 }
 
-void Task::run(base::task::func_t&& func)
+void Task::run(base::task::func_t&& func, const Priority priority)
 {
   const std::lock_guard lock(m_token_mutex);
   m_task.on_execute(std::move(func));
-  m_token = &m_task.start(tasks_pool);
+  m_token = &m_task.start(pool_for(priority));
 }
 
 void Task::wait()
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2020  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -17,10 +17,21 @@ namespace app {
 
 class Task {
 public:
+  // Priority class of the task. Each class runs in its own bounded
+  // thread pool, so queued lower-priority work (e.g. an export) cannot
+  // saturate the cores that interactive operations and the UI thread
+  // need.
+  enum class Priority {
+    kInteractive, // Something the user is actively waiting for
+                  // (filter previews, font lists)
+    kExport,      // User-started exports and other long operations
+    kBackground,  // Maintenance work (crash reports, session cleanup)
+  };
+
   Task();
   ~Task();
 
-  void run(base::task::func_t&& func);
+  void run(base::task::func_t&& func, Priority priority = Priority::kInteractive);
   void wait();
 
   // Returns true when the task is completed (whether it was
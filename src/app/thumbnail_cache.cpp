@@ -0,0 +1,179 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/thumbnail_cache.h"
+
+#include "app/resource_finder.h"
+#include "base/convert_to.h"
+#include "base/fs.h"
+#include "base/fstream_path.h"
+#include "base/serialization.h"
+#include "base/sha1.h"
+#include "os/surface_format.h"
+#include "os/system.h"
+
+#include <fstream>
+#include <vector>
+
+namespace app {
+
+using namespace base::serialization;
+using namespace base::serialization::little_endian;
+
+namespace {
+
+// Bumping this invalidates all cached thumbnails
+const uint32_t kThumbnailCacheMagic = 0x54484D31; // 'THM1'
+
+std::string file_key(const std::string& path)
+{
+  // Key by path + mtime: a modified file gets a different key, and
+  // the stale entry is just never read again (old files are
+  // harmlessly left behind until the OS/user cleans the cache dir).
+  base::Time t;
+  try {
+    t = base::get_modification_time(path);
+  }
+  catch (const std::exception&) {
+    return std::string();
+  }
+  char buf[64];
+  std::snprintf(buf,
+                sizeof(buf),
+                "|%04d%02d%02d-%02d%02d%02d",
+                t.year,
+                t.month,
+                t.day,
+                t.hour,
+                t.minute,
+                t.second);
+  return path + buf;
+}
+
+} // anonymous namespace
+
+// static
+ThumbnailCache* ThumbnailCache::instance()
+{
+  static ThumbnailCache cache;
+  return &cache;
+}
+
+ThumbnailCache::ThumbnailCache()
+{
+  try {
+    ResourceFinder rf;
+    rf.includeUserDir(base::join_path("thumbnails", ".").c_str());
+    std::string dir = rf.getFirstOrCreateDefault();
+    if (!base::is_directory(dir))
+      base::make_directory(dir);
+    if (base::is_directory(dir))
+      m_dir = dir;
+  }
+  catch (const std::exception&) {
+    // Leave m_dir empty: cache disabled
+  }
+}
+
+std::string ThumbnailCache::cachePathFor(const std::string& path) const
+{
+  const std::string key = file_key(path);
+  if (m_dir.empty() || key.empty())
+    return std::string();
+  return base::join_path(m_dir,
+                         base::convert_to<std::string>(base::Sha1::calculateFromString(key)) +
+                           ".thumb");
+}
+
+os::SurfaceRef ThumbnailCache::load(const std::string& path)
+{
+  const std::string fn = cachePathFor(path);
+  if (fn.empty() || !base::is_file(fn))
+    return nullptr;
+
+  std::ifstream s(FSTREAM_PATH(fn), std::ifstream::binary);
+  if (!s)
+    return nullptr;
+
+  if (read32(s) != kThumbnailCacheMagic)
+    return nullptr;
+  const int w = read16(s);
+  const int h = read16(s);
+  if (w < 1 || h < 1 || w > 1024 || h > 1024)
+    return nullptr;
+
+  std::vector<uint32_t> rgba(w * h);
+  s.read((char*)rgba.data(), rgba.size() * 4);
+  if (!s)
+    return nullptr;
+
+  os::SurfaceRef surface = os::System::instance()->makeRgbaSurface(w, h);
+  if (!surface)
+    return nullptr;
+
+  os::SurfaceFormatData fd;
+  surface->getFormat(&fd);
+
+  os::SurfaceLock lock(surface.get());
+  const uint32_t* src = rgba.data();
+  for (int y = 0; y < h; ++y) {
+    auto* dst = (uint32_t*)surface->getData(0, y);
+    for (int x = 0; x < w; ++x, ++src, ++dst) {
+      const uint32_t c = *src;
+      *dst = (((c & 0xff) << fd.redShift) & fd.redMask) |
+             ((((c >> 8) & 0xff) << fd.greenShift) & fd.greenMask) |
+             ((((c >> 16) & 0xff) << fd.blueShift) & fd.blueMask) |
+             ((((c >> 24) & 0xff) << fd.alphaShift) & fd.alphaMask);
+    }
+  }
+  return surface;
+}
+
+void ThumbnailCache::save(const std::string& path, const os::SurfaceRef& thumbnail)
+{
+  if (!thumbnail)
+    return;
+
+  const std::string fn = cachePathFor(path);
+  if (fn.empty())
+    return;
+
+  const int w = thumbnail->width();
+  const int h = thumbnail->height();
+
+  os::SurfaceFormatData fd;
+  thumbnail->getFormat(&fd);
+
+  std::vector<uint32_t> rgba(w * h);
+  {
+    os::SurfaceLock lock(thumbnail.get());
+    uint32_t* dst = rgba.data();
+    for (int y = 0; y < h; ++y) {
+      const auto* src = (const uint32_t*)thumbnail->getData(0, y);
+      for (int x = 0; x < w; ++x, ++src, ++dst) {
+        const uint32_t c = *src;
+        *dst = (((c & fd.redMask) >> fd.redShift) & 0xff) |
+               ((((c & fd.greenMask) >> fd.greenShift) & 0xff) << 8) |
+               ((((c & fd.blueMask) >> fd.blueShift) & 0xff) << 16) |
+               ((((c & fd.alphaMask) >> fd.alphaShift) & 0xff) << 24);
+      }
+    }
+  }
+
+  std::ofstream s(FSTREAM_PATH(fn), std::ofstream::binary);
+  if (!s)
+    return;
+  write32(s, kThumbnailCacheMagic);
+  write16(s, w);
+  write16(s, h);
+  s.write((const char*)rgba.data(), rgba.size() * 4);
+}
+
+} // namespace app
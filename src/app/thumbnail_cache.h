@@ -0,0 +1,43 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_THUMBNAIL_CACHE_H_INCLUDED
+#define APP_THUMBNAIL_CACHE_H_INCLUDED
+#pragma once
+
+#include "os/surface.h"
+
+#include <string>
+
+namespace app {
+
+// Disk-backed cache of file-selector thumbnails, stored under the
+// user config dir ("thumbnails" folder). Entries are keyed by the
+// file full path + modification time, so an outdated thumbnail is
+// never returned and editing a file naturally invalidates its entry.
+class ThumbnailCache {
+public:
+  static ThumbnailCache* instance();
+
+  // Returns the cached thumbnail for the given file, or nullptr if
+  // there is no up-to-date entry. Can be called from any thread.
+  os::SurfaceRef load(const std::string& path);
+
+  // Stores the freshly generated thumbnail for the given file.
+  // Failures are ignored (the cache is only an accelerator).
+  void save(const std::string& path, const os::SurfaceRef& thumbnail);
+
+private:
+  ThumbnailCache();
+
+  std::string cachePathFor(const std::string& path) const;
+
+  std::string m_dir; // Empty if the cache dir is not available
+};
+
+} // namespace app
+
+#endif
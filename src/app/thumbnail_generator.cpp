@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -16,7 +16,9 @@
 #include "app/doc.h"
 #include "app/file/file.h"
 #include "app/file_system.h"
+#include "app/thumbnail_cache.h"
 #include "app/util/conversion_to_surface.h"
+#include "app/util/tuning.h"
 #include "base/thread.h"
 #include "doc/algorithm/rotate.h"
 #include "doc/image.h"
@@ -169,6 +171,10 @@ private:
           const std::lock_guard lock(m_mutex);
           m_item.fileitem->setThumbnail(thumbnail);
         }
+
+        // Store the thumbnail on disk so we don't decode this file
+        // again the next time its folder is listed.
+        ThumbnailCache::instance()->save(m_item.fileitem->fileName(), thumbnail);
       }
 
       THUMB_TRACE("FOP done with thumbnail: %s %s\n",
@@ -246,10 +252,11 @@ ThumbnailGenerator* ThumbnailGenerator::instance()
 
 ThumbnailGenerator::ThumbnailGenerator()
 {
-  int n = std::thread::hardware_concurrency() - 1;
-  if (n < 1)
-    n = 1;
-  m_maxWorkers = n;
+  // Use only half of the workers for thumbnails: each worker decodes
+  // a whole file, so keeping one thread per core was enough to make
+  // everything else (including the UI thread redrawing the file
+  // selector) compete for CPU time while browsing a big directory.
+  m_maxWorkers = std::max(1, tuned_worker_count() / 2);
 }
 
 bool ThumbnailGenerator::checkWorkers()
@@ -297,6 +304,13 @@ void ThumbnailGenerator::generateThumbnail(IFileItem* fileitem)
     return;
   }
 
+  // Check the on-disk cache before spawning a background worker that
+  // decodes the whole file again.
+  if (os::SurfaceRef thumbnail = ThumbnailCache::instance()->load(fileitem->fileName())) {
+    fileitem->setThumbnail(thumbnail);
+    return;
+  }
+
   // Set a starting progress so we don't enqueue the same item two times.
   fileitem->setThumbnailProgress(0.00001);
 
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2018  David Capello
 // Copyright (C) 2016  Carlo Caputo
 //
@@ -10,22 +10,38 @@
   #include "config.h"
 #endif
 
+#include "app/app.h"
 #include "app/color_spaces.h"
+#include "app/doc.h"
+#include "app/doc_access.h"
+#include "app/job_scheduler.h"
+#include "app/memory_budget.h"
+#include "app/ui/timeline/timeline.h"
 #include "app/util/conversion_to_surface.h"
 #include "doc/blend_mode.h"
 #include "doc/cel.h"
 #include "doc/layer.h"
+#include "doc/object.h"
 #include "doc/sprite.h"
 #include "os/surface.h"
 #include "os/system.h"
 #include "render/render.h"
+#include "ui/system.h"
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
 
 namespace app { namespace thumb {
 
-os::SurfaceRef get_cel_thumbnail(ui::Display* display,
-                                 const doc::Cel* cel,
-                                 const bool scaleUpToFit,
-                                 const gfx::Size& fitInSize)
+namespace {
+
+doc::ImageRef render_cel_thumbnail(const doc::Cel* cel,
+                                   const doc::Palette* palette,
+                                   const bool scaleUpToFit,
+                                   const gfx::Size& fitInSize)
 {
   gfx::Size newSize;
 
@@ -43,7 +59,6 @@ os::SurfaceRef get_cel_thumbnail(ui::Display* display,
   render::Projection proj(cel->sprite()->pixelRatio(), render::Zoom(newSize.w, cel->bounds().w));
   render.setProjection(proj);
 
-  const doc::Palette* palette = cel->sprite()->palette(cel->frame());
   render.renderCel(thumbnailImage.get(),
                    cel,
                    cel->sprite(),
@@ -55,11 +70,18 @@ os::SurfaceRef get_cel_thumbnail(ui::Display* display,
                    255,
                    doc::BlendMode::NORMAL);
 
-  if (os::SurfaceRef thumbnail = os::System::instance()->makeRgbaSurface(
-        thumbnailImage->width(),
-        thumbnailImage->height(),
-        get_current_color_space(display))) {
-    convert_image_to_surface(thumbnailImage.get(),
+  return thumbnailImage;
+}
+
+os::SurfaceRef make_thumbnail_surface(const doc::Image* thumbnailImage,
+                                      const doc::Palette* palette,
+                                      const os::ColorSpaceRef& colorSpace)
+{
+  os::SurfaceRef thumbnail = os::System::instance()->makeRgbaSurface(thumbnailImage->width(),
+                                                                     thumbnailImage->height(),
+                                                                     colorSpace);
+  if (thumbnail) {
+    convert_image_to_surface(thumbnailImage,
                              palette,
                              thumbnail.get(),
                              0,
@@ -68,10 +90,218 @@ os::SurfaceRef get_cel_thumbnail(ui::Display* display,
                              0,
                              thumbnailImage->width(),
                              thumbnailImage->height());
-    return thumbnail;
   }
-  else
+  return thumbnail;
+}
+
+// Key/state of the LRU thumbnail cache. Versions of the cel (its
+// data, e.g. position/opacity) and its image are part of the key, so
+// modifying the cel just leaves an old entry to be evicted instead
+// of requiring explicit invalidation.
+struct CacheKey {
+  doc::ObjectId cel;
+  doc::ObjectVersion celDataVersion;
+  doc::ObjectVersion imageVersion;
+  int w, h; // fitInSize
+  bool scaleUpToFit;
+
+  bool operator<(const CacheKey& b) const
+  {
+    return std::tie(cel, celDataVersion, imageVersion, w, h, scaleUpToFit) <
+           std::tie(b.cel, b.celDataVersion, b.imageVersion, b.w, b.h, b.scaleUpToFit);
+  }
+};
+
+struct CacheEntry {
+  os::SurfaceRef surface;
+  std::list<CacheKey>::iterator lruIt;
+};
+
+struct Cache : public MemoryBudgetDelegate {
+  // Budget for all cached surfaces, least-recently-used entries are
+  // evicted above this limit (the global MemoryBudget service can
+  // shrink the cache further under memory pressure).
+  static const size_t kMaxBytes = 8 * 1024 * 1024;
+
+  mutable std::mutex mutex;
+  std::map<CacheKey, CacheEntry> items;
+  std::list<CacheKey> lru; // Front = most recently used
+  size_t bytes = 0;
+  std::set<CacheKey> generating; // Keys with an in-flight job
+
+  // Removes least-recently-used entries until the cache fits in
+  // "maxBytes". Must be called with the mutex locked.
+  void shrinkTo(const size_t maxBytes)
+  {
+    while (bytes > maxBytes && !lru.empty()) {
+      auto it = items.find(lru.back());
+      ASSERT(it != items.end());
+      bytes -= 4 * it->second.surface->width() * it->second.surface->height();
+      items.erase(it);
+      lru.pop_back();
+    }
+  }
+
+  // MemoryBudgetDelegate impl. Thumbnails can always be regenerated,
+  // so this cache is shrunk before undo states are dropped.
+  int evictionPriority() const override { return 0; }
+  size_t memoryUsage() const override
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+  }
+  size_t evictMemory(size_t bytesToFree) override
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t before = bytes;
+    shrinkTo(bytes > bytesToFree ? bytes - bytesToFree : 0);
+    return before - bytes;
+  }
+};
+
+Cache* get_cache()
+{
+  // Heap-allocated and never deleted: cached os::Surfaces cannot be
+  // destroyed after the os::System is gone at exit.
+  static Cache* cache = [] {
+    auto* c = new Cache;
+    MemoryBudget::instance()->addDelegate(c);
+    return c;
+  }();
+  return cache;
+}
+
+void cache_put(Cache* cache, const CacheKey& key, const os::SurfaceRef& surface)
+{
+  const size_t bytes = 4 * surface->width() * surface->height();
+
+  {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    cache->generating.erase(key);
+    if (cache->items.find(key) != cache->items.end())
+      return;
+
+    cache->lru.push_front(key);
+    cache->items[key] = CacheEntry{ surface, cache->lru.begin() };
+    cache->bytes += bytes;
+
+    cache->shrinkTo(Cache::kMaxBytes);
+  }
+
+  // Without the cache mutex locked (the service queries our usage).
+  MemoryBudget::instance()->checkPressureFromBackground();
+}
+
+void generate_thumbnail_job(const doc::ObjectId docId,
+                            const CacheKey& key,
+                            const os::ColorSpaceRef& colorSpace)
+{
+  Cache* cache = get_cache();
+  os::SurfaceRef surface;
+  try {
+    // The document can be closed while the job is queued, so it's
+    // captured by ID instead of by pointer.
+    Doc* doc = static_cast<Doc*>(doc::get<doc::Document>(docId));
+    if (!doc) {
+      std::lock_guard<std::mutex> lock(cache->mutex);
+      cache->generating.erase(key);
+      return;
+    }
+
+    // Read-lock the document, the user can be modifying this same
+    // cel in the UI thread.
+    DocReader reader(doc, 100);
+
+    const doc::Cel* cel = doc::get<doc::Cel>(key.cel);
+    if (!cel || cel->data()->version() != key.celDataVersion ||
+        cel->image()->version() != key.imageVersion) {
+      // The cel was deleted/modified while the job was queued, a new
+      // job with the new key is scheduled from the next paint.
+      std::lock_guard<std::mutex> lock(cache->mutex);
+      cache->generating.erase(key);
+      return;
+    }
+
+    const doc::Palette* palette = cel->sprite()->palette(cel->frame());
+    doc::ImageRef thumbnailImage =
+      render_cel_thumbnail(cel, palette, key.scaleUpToFit, gfx::Size(key.w, key.h));
+    if (thumbnailImage)
+      surface = make_thumbnail_surface(thumbnailImage.get(), palette, colorSpace);
+  }
+  catch (const LockedDocException&) {
+    // Cannot read the document now, the next paint retries.
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    cache->generating.erase(key);
+    return;
+  }
+
+  if (!surface) {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    cache->generating.erase(key);
+    return;
+  }
+
+  cache_put(cache, key, surface);
+
+  // Repaint the timeline so the placeholder is replaced with the
+  // fresh thumbnail.
+  ui::execute_from_ui_thread([] {
+    if (App* app = App::instance()) {
+      if (Timeline* timeline = app->timeline())
+        timeline->invalidate();
+    }
+  });
+}
+
+} // anonymous namespace
+
+os::SurfaceRef get_cel_thumbnail(ui::Display* display,
+                                 const doc::Cel* cel,
+                                 const bool scaleUpToFit,
+                                 const gfx::Size& fitInSize)
+{
+  const doc::Palette* palette = cel->sprite()->palette(cel->frame());
+  doc::ImageRef thumbnailImage = render_cel_thumbnail(cel, palette, scaleUpToFit, fitInSize);
+  if (!thumbnailImage)
     return nullptr;
+
+  return make_thumbnail_surface(thumbnailImage.get(), palette, get_current_color_space(display));
+}
+
+os::SurfaceRef get_cached_cel_thumbnail(ui::Display* display,
+                                        Doc* doc,
+                                        const doc::Cel* cel,
+                                        const bool scaleUpToFit,
+                                        const gfx::Size& fitInSize)
+{
+  Cache* cache = get_cache();
+  const CacheKey key = { cel->id(),
+                         cel->data()->version(),
+                         cel->image()->version(),
+                         fitInSize.w,
+                         fitInSize.h,
+                         scaleUpToFit };
+
+  {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    auto it = cache->items.find(key);
+    if (it != cache->items.end()) {
+      // Cache hit, move the entry to the most-recently-used position.
+      cache->lru.splice(cache->lru.begin(), cache->lru, it->second.lruIt);
+      return it->second.surface;
+    }
+
+    if (cache->generating.find(key) != cache->generating.end())
+      return nullptr; // Already in-flight
+
+    cache->generating.insert(key);
+  }
+
+  JobScheduler::instance()->submitJob(
+    [docId = doc->id(), key, colorSpace = get_current_color_space(display)] {
+      generate_thumbnail_job(docId, key, colorSpace);
+    });
+  return nullptr;
 }
 
 }} // namespace app::thumb
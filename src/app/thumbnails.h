@@ -21,6 +21,10 @@ namespace os {
 class Surface;
 }
 
+namespace app {
+class Doc;
+}
+
 namespace app { namespace thumb {
 
 os::SurfaceRef get_cel_thumbnail(ui::Display* display,
@@ -28,6 +32,18 @@ os::SurfaceRef get_cel_thumbnail(ui::Display* display,
                                  const bool scaleUpToFit,
                                  const gfx::Size& fitInSize);
 
+// Cached/asynchronous variant of get_cel_thumbnail() for the
+// timeline: returns the thumbnail from a LRU cache (keyed on the cel
+// ID + version, so editing the cel regenerates it), or nullptr while
+// a background job generates the missing entry. The timeline is
+// invalidated when the thumbnail is ready, so the caller just paints
+// the cel without thumbnail this time.
+os::SurfaceRef get_cached_cel_thumbnail(ui::Display* display,
+                                        Doc* doc,
+                                        const doc::Cel* cel,
+                                        const bool scaleUpToFit,
+                                        const gfx::Size& fitInSize);
+
 }} // namespace app::thumb
 
 #endif
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2023  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -61,6 +61,7 @@ public:
   void pressButton(ToolLoop* loop, Stroke& stroke, const Stroke::Pt& pt) override
   {
     m_last = pt;
+    m_freshPoints = 0;
     stroke.addPoint(pt);
   }
 
@@ -69,6 +70,7 @@ public:
   void movement(ToolLoop* loop, Stroke& stroke, const Stroke::Pt& pt) override
   {
     m_last = pt;
+    ++m_freshPoints;
     stroke.addPoint(pt);
   }
 
@@ -78,13 +80,18 @@ public:
       output.addPoint(input[0]);
     }
     else if (input.size() >= 2) {
-      // The freehand controller returns only the last two points to
-      // interwine because we accumulate (TracePolicy::Accumulate) the
-      // previously painted points (i.e. don't want to redraw all the
-      // stroke from the very beginning)
-      output.addPoint(input[input.size() - 2]);
-      output.addPoint(input[input.size() - 1]);
+      // The freehand controller returns only the still-not-painted
+      // tail of the stroke to interwine because we accumulate
+      // (TracePolicy::Accumulate) the previously painted points
+      // (i.e. don't want to redraw all the stroke from the very
+      // beginning). The tail is usually one segment, but it can be a
+      // longer polyline when several queued pointer movements were
+      // coalesced into one trace step.
+      const int n = std::min(int(input.size()), m_freshPoints + 1);
+      for (int i = int(input.size()) - n; i < int(input.size()); ++i)
+        output.addPoint(input[i]);
     }
+    m_freshPoints = 0;
   }
 
   void getStatusBarText(ToolLoop* loop, const Stroke& stroke, std::string& text) override
@@ -103,6 +110,10 @@ public:
 
 private:
   Stroke::Pt m_last;
+
+  // Number of points added with movement() that weren't returned by
+  // getStrokeToInterwine() yet.
+  int m_freshPoints = 0;
 };
 
 // Controls clicks for tools like line
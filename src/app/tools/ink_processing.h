@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -11,6 +11,7 @@
 #include "app/util/wrap_value.h"
 #include "doc/blend_funcs.h"
 #include "doc/blend_internals.h"
+#include "doc/blend_rows.h"
 #include "doc/image.h"
 #include "doc/layer.h"
 #include "doc/palette.h"
@@ -23,6 +24,8 @@
 #include "render/dithering.h"
 #include "render/gradient.h"
 
+#include <unordered_map>
+
 namespace app { namespace tools {
 
 using namespace gfx;
@@ -93,7 +96,16 @@ public:
     }
 
     static_cast<Derived*>(this)->initIterators(loop, x1, y);
-    for (x = x1; x <= x2; ++x) {
+    static_cast<Derived*>(this)->processRow(x1, x2, y);
+  }
+
+  // Processes the whole (unmasked) scanline after initIterators().
+  // Inks that don't depend on x/y per pixel can shadow this function
+  // with a batched/vectorized row kernel (iterator positions are
+  // unspecified after the call).
+  void processRow(int x1, int x2, int y)
+  {
+    for (int x = x1; x <= x2; ++x) {
       static_cast<Derived*>(this)->processPixel(x, y);
       static_cast<Derived*>(this)->moveIterators();
     }
@@ -161,6 +173,13 @@ public:
 
   void processPixel(int x, int y) { *this->m_dstAddress = m_color; }
 
+  // The whole row takes the same color, no need to go pixel by pixel
+  void processRow(int x1, int x2, int y)
+  {
+    for (int x = x1; x <= x2; ++x, ++this->m_dstAddress)
+      *this->m_dstAddress = m_color;
+  }
+
 private:
   color_t m_color;
 };
@@ -279,6 +298,11 @@ public:
     // Do nothing
   }
 
+  void processRow(int x1, int x2, int y)
+  {
+    InkProcessing<TransparentInkProcessing<ImageTraits>>::processRow(x1, x2, y);
+  }
+
 private:
   color_t m_color;
   int m_opacity;
@@ -290,6 +314,13 @@ void TransparentInkProcessing<RgbTraits>::processPixel(int x, int y)
   *m_dstAddress = rgba_blender_normal(*m_srcAddress, m_color, m_opacity);
 }
 
+template<>
+void TransparentInkProcessing<RgbTraits>::processRow(int x1, int x2, int y)
+{
+  // Vectorized version of processPixel() for the whole row
+  rgba_blend_color_row(m_dstAddress, m_srcAddress, x2 - x1 + 1, m_color, m_opacity);
+}
+
 template<>
 void TransparentInkProcessing<GrayscaleTraits>::processPixel(int x, int y)
 {
@@ -823,11 +854,18 @@ public:
     for (app::Color color : shade) {
       m_shadePalette.setEntry(i++, color_utils::color_for_layer(color, loop->getLayer()));
     }
+
+    // Color -> shade slot table to avoid a linear palette search per
+    // pixel (insert() keeps the first occurrence of repeated colors,
+    // like findExactMatch() does).
+    for (i = 0; i < m_shadePalette.size(); ++i)
+      m_slots.insert({ m_shadePalette.getEntry(i), i });
   }
 
   int findIndex(uint8_t r, uint8_t g, uint8_t b, uint8_t a) const
   {
-    return m_shadePalette.findExactMatch(r, g, b, a, -1);
+    const auto it = m_slots.find(rgba(r, g, b, a));
+    return (it != m_slots.end() ? it->second : -1);
   }
 
   pixel_t operator()(const pixel_t src) const
@@ -849,6 +887,7 @@ public:
 
 private:
   Palette m_shadePalette;
+  std::unordered_map<color_t, int> m_slots;
   bool m_left;
 };
 
@@ -875,11 +914,16 @@ public:
     for (app::Color color : shade) {
       m_shadePalette.setEntry(i++, color_utils::color_for_target(color, target));
     }
+
+    // Color -> shade slot table, same as the RGB specialization.
+    for (i = 0; i < m_shadePalette.size(); ++i)
+      m_slots.insert({ m_shadePalette.getEntry(i), i });
   }
 
   int findIndex(uint8_t r, uint8_t g, uint8_t b, uint8_t a) const
   {
-    return m_shadePalette.findExactMatch(r, g, b, a, -1);
+    const auto it = m_slots.find(rgba(r, g, b, a));
+    return (it != m_slots.end() ? it->second : -1);
   }
 
   pixel_t operator()(const pixel_t src) const
@@ -903,6 +947,7 @@ public:
 
 private:
   Palette m_shadePalette;
+  std::unordered_map<color_t, int> m_slots;
   bool m_left;
 };
 
@@ -916,11 +961,17 @@ public:
     , m_remap(loop->getShadingRemap())
     , m_left(loop->getMouseButton() == ToolLoop::Left)
   {
+    // Color -> palette index table for findIndex(), built once per
+    // tool loop (the palette cannot change in the middle of it), as
+    // brush shading looks up each brush pixel in the whole palette.
+    for (int i = 0; i < m_palette->size(); ++i)
+      m_slots.insert({ m_palette->getEntry(i), i });
   }
 
   int findIndex(uint8_t r, uint8_t g, uint8_t b, uint8_t a) const
   {
-    return m_palette->findExactMatch(r, g, b, a, -1);
+    const auto it = m_slots.find(rgba(r, g, b, a));
+    return (it != m_slots.end() ? it->second : -1);
   }
 
   pixel_t operator()(pixel_t i) const
@@ -943,6 +994,7 @@ public:
 
 private:
   const Palette* m_palette;
+  std::unordered_map<color_t, int> m_slots;
   const Remap* m_remap;
   bool m_left;
 };
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2020  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -64,18 +64,13 @@ void Intertwine::doPointshapeStrokePt(const Stroke::Pt& pt, ToolLoop* loop)
 {
   Symmetry* symmetry = loop->getSymmetry();
   if (symmetry) {
-    // Convert the point to the sprite position so we can apply the
-    // symmetry transformation.
-    Stroke main_stroke;
-    main_stroke.addPoint(pt);
-
-    Strokes strokes;
-    symmetry->generateStrokes(main_stroke, strokes, loop);
-    for (const auto& stroke : strokes) {
-      // We call transformPoint() moving back each point to the cel
-      // origin.
-      doTransformPoint(stroke[0], loop);
-    }
+    // This function is called for each point of the stroke, so we
+    // reuse the same buffer for the mirrored points instead of
+    // creating temporary strokes each time.
+    m_symmetryPts.clear();
+    symmetry->generatePoints(pt, m_symmetryPts, loop);
+    for (const auto& pt2 : m_symmetryPts)
+      doTransformPoint(pt2, loop);
   }
   else {
     doTransformPoint(pt, loop);
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2021  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -60,6 +60,11 @@ protected:
   static doc::AlgoLineWithAlgoPixel getLineAlgo(ToolLoop* loop,
                                                 const Stroke::Pt& a,
                                                 const Stroke::Pt& b);
+
+private:
+  // Scratch buffer with the mirrored versions of one point, reused
+  // by doPointshapeStrokePt() for each point of the stroke.
+  Stroke::Pts m_symmetryPts;
 };
 
 }} // namespace app::tools
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -444,6 +444,12 @@ public:
 };
 
 class IntertwineAsPixelPerfect : public Intertwine {
+  // Whole stroke rasterized so far, kept incrementally between
+  // joinStroke() calls (TracePolicy::Accumulate): each call just
+  // rasterizes/paints the still-not-processed trailing segments, and
+  // the pixel-perfect cleanup re-checks only the last points, so long
+  // strokes aren't re-traced from the very beginning on each new
+  // point.
   Stroke m_pts;
   bool m_saveStrokeArea = false;
 
@@ -689,6 +695,9 @@ private:
     }
 
     m_restoredRegion.offset(loop->getCelOrigin());
+
+    // The rolled back pixels may belong to neighbor stamps too
+    loop->getPointShape()->onStrokeRollback();
   }
 
   void updateTempTileset(ToolLoop* loop, const tools::Stroke::Pt& pt)
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2024  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This program is distributed under the terms of
@@ -33,6 +33,21 @@ public:
                                doc::SymmetryIndex symmetry,
                                gfx::Rect& area) = 0;
 
+  // Point shapes that cannot estimate the modified area before
+  // drawing (e.g. flood fill, where getModifiedArea() has to assume
+  // the whole canvas) can track the exact area while the scanlines
+  // are emitted. ToolLoopManager resets the tracking before drawing
+  // a loop step and uses getExactModifiedArea() to shrink the final
+  // dirty region to what was actually touched.
+  virtual void resetExactModifiedArea() {}
+  virtual bool getExactModifiedArea(gfx::Rect& area) const { return false; }
+
+  // Called when the intertwiner rolls back pixels already painted in
+  // the current stroke (e.g. pixel-perfect point deletion), so point
+  // shapes that track the previous stamp to skip overlapped pixels
+  // must forget it.
+  virtual void onStrokeRollback() {}
+
 protected:
   // Calls loop->getInk()->inkHline() function for each horizontal-scanline
   // that should be drawn (applying the "tiled" mode loop->getTiledMode())
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -7,6 +7,7 @@
 
 #include "app/util/wrap_point.h"
 
+#include "app/app.h"
 #include "app/tools/ink.h"
 #include "app/tools/symmetry.h"
 #include "doc/algorithm/flip_image.h"
@@ -85,6 +86,14 @@ class BrushPointShape : public PointShape {
   Brush* m_lastBrush;
   BrushType m_origBrushType;
   std::array<std::shared_ptr<CompressedImage>, int(SymmetryIndex::ELEMENTS)> m_compressedImages;
+  // Last stamp of the current stroke for each symmetry index, to
+  // skip re-inking the pixels that consecutive overlapping stamps
+  // share (see transformPoint()).
+  struct PrevStamp {
+    Brush* brush = nullptr;
+    int x = 0, y = 0;
+  };
+  std::array<PrevStamp, int(SymmetryIndex::ELEMENTS)> m_prevStamps;
   // For dynamics
   DynamicsOptions m_dynamics;
   bool m_useDynamics;
@@ -98,6 +107,7 @@ public:
   {
     m_firstPoint = true;
     m_lastBrush = nullptr;
+    m_prevStamps.fill(PrevStamp());
     m_origBrushType = loop->getBrush()->type();
 
     m_dynamics = loop->getDynamics();
@@ -118,6 +128,8 @@ public:
     m_lastGradientValue = -1;
   }
 
+  void onStrokeRollback() override { m_prevStamps.fill(PrevStamp()); }
+
   void transformPoint(ToolLoop* loop, const Stroke::Pt& pt) override
   {
     int x = pt.x;
@@ -187,13 +199,15 @@ public:
       if ((brush->size() != size) ||
           (brush->angle() != angle && m_origBrushType != kCircleBrushType) ||
           (m_hasDynamicGradient && pt.gradient != m_lastGradientValue)) {
-        // TODO cache brushes
-        BrushRef newBrush = std::make_shared<Brush>(m_origBrushType, size, angle);
+        BrushRef newBrush;
 
-        // Dynamic gradient with dithering
+        // Dynamic gradient with dithering (the brush image is
+        // rewritten with the gradient colors, so we cannot share a
+        // cached brush instance in this case)
         bool prepareInk = false;
         if (m_hasDynamicGradient && !ink->isEraser() &&
             (m_dynamics.ditheringMatrix.rows() > 1 || m_dynamics.ditheringMatrix.cols() > 1)) {
+          newBrush = std::make_shared<Brush>(m_origBrushType, size, angle);
           convert_bitmap_brush_to_dithering_brush(newBrush.get(),
                                                   loop->sprite()->pixelFormat(),
                                                   m_dynamics.ditheringMatrix,
@@ -202,6 +216,12 @@ public:
                                                   m_primaryColor);
           prepareInk = true;
         }
+        else {
+          // Cached in AppBrushes, so changing the brush size/angle
+          // back and forth during the stroke doesn't regenerate the
+          // brush image and scanline mask each time.
+          newBrush = App::instance()->brushes().getComputedBrush(m_origBrushType, size, angle);
+        }
         m_lastGradientValue = pt.gradient;
 
         loop->setBrush(newBrush);
@@ -215,10 +235,12 @@ public:
     }
 
     // TODO cache compressed images (or remove them completelly)
-    if (m_lastBrush != brush) {
-      m_lastBrush = brush;
-      m_compressedImages.fill(nullptr);
-    }
+    // Don't drop the compressed images here: getCompressedImage()
+    // regenerates each one lazily (reusing its scanline storage) when
+    // it doesn't match the brush image anymore. This avoids
+    // reallocating the scanlines on each point when dynamics resize
+    // the brush.
+    m_lastBrush = brush;
 
     if (brush->type() == kImageBrushType && does_symmetry_rotate_image(pt.symmetry)) {
       x += brush->bounds().y;
@@ -256,11 +278,65 @@ public:
 
     ink->prepareForPointShape(loop, m_firstPoint, x, y, pt.symmetry);
 
-    for (auto scanline : getCompressedImage(pt.symmetry)) {
-      int u = x + scanline.x;
-      ink->prepareVForPointShape(loop, y + scanline.y);
-      doInkHline(u, y + scanline.y, u + scanline.w - 1, loop);
+    const CompressedImage& stamp = getCompressedImage(pt.symmetry);
+    PrevStamp& prev = m_prevStamps[int(pt.symmetry)];
+
+    // Overlap-skip: dense stroke interpolation stamps the same brush
+    // at almost the same position many times, so we can ink only the
+    // part of each scanline that the previous stamp didn't cover.
+    // Valid when the inked value of a pixel doesn't depend on the
+    // stamp position (plain paint/eraser, no dynamics, no image
+    // brush patterns) and the destination accumulates the stamps
+    // (with other trace policies the destination image is reset
+    // between loop steps, so the previous stamp may not be there
+    // anymore).
+    const bool skipOverlap = (prev.brush == brush && !m_useDynamics &&
+                              m_origBrushType != kImageBrushType &&
+                              (ink->isPaint() || ink->isEraser()) &&
+                              loop->getTracePolicy() == TracePolicy::Accumulate);
+
+    auto prevIt = stamp.begin();
+    const auto prevEnd = stamp.end();
+    for (const auto& scanline : stamp) {
+      const int v = y + scanline.y;
+      int u1 = x + scanline.x;
+      const int u2 = u1 + scanline.w - 1;
+
+      ink->prepareVForPointShape(loop, v);
+
+      if (!skipOverlap) {
+        doInkHline(u1, v, u2, loop);
+        continue;
+      }
+
+      // Advance to the scanlines of the previous stamp in this same
+      // row (both stamps share the scanline list, just displaced).
+      while (prevIt != prevEnd && prev.y + prevIt->y < v)
+        ++prevIt;
+
+      bool covered = false;
+      for (auto it = prevIt; it != prevEnd && prev.y + it->y == v; ++it) {
+        const int o1 = prev.x + it->x;
+        const int o2 = o1 + it->w - 1;
+        if (o2 < u1)
+          continue;
+        if (o1 > u2)
+          break;
+        if (u1 < o1)
+          doInkHline(u1, v, o1 - 1, loop);
+        u1 = o2 + 1;
+        if (u1 > u2) {
+          covered = true;
+          break;
+        }
+      }
+      if (!covered)
+        doInkHline(u1, v, u2, loop);
     }
+
+    prev.brush = brush;
+    prev.x = x;
+    prev.y = y;
     m_firstPoint = false;
   }
 
@@ -283,11 +359,12 @@ private:
   CompressedImage& getCompressedImage(doc::SymmetryIndex index)
   {
     auto& compressPtr = m_compressedImages[int(index)];
-    if (!compressPtr) {
-      compressPtr.reset(new CompressedImage(m_lastBrush->getSymmetryImage(index),
-                                            m_lastBrush->getSymmetryMask(index),
-                                            false));
-    }
+    if (!compressPtr)
+      compressPtr = std::make_shared<CompressedImage>();
+
+    const Image* image = m_lastBrush->getSymmetryImage(index);
+    if (!compressPtr->isUpToDate(image, false))
+      compressPtr->regenerate(image, m_lastBrush->getSymmetryMask(index), false);
     return *compressPtr;
   }
 };
@@ -296,6 +373,20 @@ class FloodFillPointShape : public PointShape {
 public:
   bool isFloodFill() override { return true; }
 
+  void resetExactModifiedArea() override
+  {
+    m_modifiedArea = gfx::Rect();
+    m_tracking = true;
+  }
+
+  bool getExactModifiedArea(gfx::Rect& area) const override
+  {
+    if (!m_tracking)
+      return false;
+    area = m_modifiedArea;
+    return true;
+  }
+
   void transformPoint(ToolLoop* loop, const Stroke::Pt& pt) override
   {
     const doc::Image* srcImage = loop->getFloodFillSrcImage();
@@ -314,6 +405,7 @@ public:
 
     loop->getInk()->prepareForPointShape(loop, true, wpt.x, wpt.y, pt.symmetry);
 
+    FillData data = { loop, gfx::Rect() };
     doc::algorithm::floodfill(
       srcImage,
       (loop->useMask() ? loop->getMask() : nullptr),
@@ -324,8 +416,16 @@ public:
       loop->getTolerance(),
       loop->getContiguous(),
       loop->isPixelConnectivityEightConnected(),
-      loop,
-      (AlgoHLine)doInkHline);
+      &data,
+      (AlgoHLine)fillHline);
+
+    if (!data.bounds.isEmpty()) {
+      // In tiles mode the fill ran in tile space, the dirty area is
+      // tracked in canvas coordinates.
+      if (tilesMode)
+        data.bounds = loop->getGrid().tileToCanvas(data.bounds);
+      m_modifiedArea |= data.bounds;
+    }
   }
 
   void getModifiedArea(ToolLoop* loop,
@@ -338,6 +438,20 @@ public:
   }
 
 private:
+  struct FillData {
+    ToolLoop* loop;
+    gfx::Rect bounds;
+  };
+
+  // Accumulates the emitted scanlines so getExactModifiedArea() can
+  // report the area that the fill actually touched (the estimation
+  // of getModifiedArea() is the whole canvas).
+  static void fillHline(int x1, int y, int x2, FillData* data)
+  {
+    data->bounds |= gfx::Rect(x1, y, x2 - x1 + 1, 1);
+    doInkHline(x1, y, x2, data->loop);
+  }
+
   gfx::Rect floodfillBounds(ToolLoop* loop, int x, int y) const
   {
     const doc::Image* srcImage = loop->getFloodFillSrcImage();
@@ -374,6 +488,11 @@ private:
 
     return bounds;
   }
+
+  // True between resetExactModifiedArea() and the end of the loop
+  // step (point shapes are singletons, see ToolBox).
+  bool m_tracking = false;
+  gfx::Rect m_modifiedArea;
 };
 
 class SprayPointShape : public PointShape {
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2016  David Capello
 //
 // This program is distributed under the terms of
@@ -13,6 +13,8 @@
 #include "gfx/point.h"
 #include "ui/pointer_type.h"
 
+#include <vector>
+
 namespace app { namespace tools {
 
 using Vec2 = base::Vector2d<float>;
@@ -59,6 +61,8 @@ private:
   float m_pressure;
 };
 
+typedef std::vector<Pointer> Pointers;
+
 }} // namespace app::tools
 
 #endif
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2021-2025  Igara Studio S.A.
+// Copyright (C) 2021-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -105,11 +105,77 @@ void Symmetry::generateStrokes(const Stroke& stroke, Strokes& strokes, ToolLoop*
   }
 }
 
+void Symmetry::generatePoints(const Stroke::Pt& pt, Stroke::Pts& pts, ToolLoop* loop)
+{
+  pts.push_back(pt);
+  const gen::SymmetryMode symmetryMode = tools::Symmetry::resolveMode(loop->getSymmetry()->mode());
+  switch (symmetryMode) {
+    case gen::SymmetryMode::NONE: ASSERT(false); break;
+
+    case gen::SymmetryMode::HORIZONTAL:
+      pts.push_back(calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::FLIPPED_X));
+      break;
+    case gen::SymmetryMode::VERTICAL:
+      pts.push_back(calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::FLIPPED_Y));
+      break;
+
+    case gen::SymmetryMode::BOTH: {
+      pts.push_back(calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::FLIPPED_X));
+
+      const Stroke::Pt pt3 = calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::FLIPPED_Y);
+      pts.push_back(pt3);
+      pts.push_back(calculateSymmetricalPoint(pt3, loop, doc::SymmetryIndex::FLIPPED_XY));
+      break;
+    }
+
+    case gen::SymmetryMode::RIGHT_DIAG:
+      pts.push_back(calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::ROT_FLIP_270));
+      break;
+
+    case gen::SymmetryMode::LEFT_DIAG:
+      pts.push_back(calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::ROT_FLIP_90));
+      break;
+
+    case gen::SymmetryMode::BOTH_DIAG: {
+      pts.push_back(calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::ROT_FLIP_270));
+      pts.push_back(calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::ROT_FLIP_90));
+      pts.push_back(calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::FLIPPED_XY, true));
+      break;
+    }
+
+    case gen::SymmetryMode::ALL: {
+      pts.push_back(calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::FLIPPED_X));
+
+      const Stroke::Pt pt3 = calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::FLIPPED_Y);
+      pts.push_back(pt3);
+      pts.push_back(calculateSymmetricalPoint(pt3, loop, doc::SymmetryIndex::FLIPPED_XY));
+
+      const Stroke::Pt pt5 = calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::ROT_FLIP_90);
+      pts.push_back(pt5);
+      pts.push_back(calculateSymmetricalPoint(pt5, loop, doc::SymmetryIndex::ROTATED_270));
+
+      const Stroke::Pt pt7 = calculateSymmetricalPoint(pt, loop, doc::SymmetryIndex::ROT_FLIP_270);
+      pts.push_back(pt7);
+      pts.push_back(calculateSymmetricalPoint(pt7, loop, doc::SymmetryIndex::ROTATED_90));
+      break;
+    }
+  }
+}
+
 void Symmetry::calculateSymmetricalStroke(const Stroke& refStroke,
                                           Stroke& stroke,
                                           ToolLoop* loop,
                                           const doc::SymmetryIndex symmetry,
                                           const bool isDoubleDiagonalSymmetry)
+{
+  for (const auto& pt : refStroke)
+    stroke.addPoint(calculateSymmetricalPoint(pt, loop, symmetry, isDoubleDiagonalSymmetry));
+}
+
+Stroke::Pt Symmetry::calculateSymmetricalPoint(const Stroke::Pt& pt,
+                                               ToolLoop* loop,
+                                               const doc::SymmetryIndex symmetry,
+                                               const bool isDoubleDiagonalSymmetry)
 {
   gfx::Size brushSize(1, 1);
   gfx::Point brushCenter(0, 0);
@@ -125,50 +191,48 @@ void Symmetry::calculateSymmetricalStroke(const Stroke& refStroke,
     }
   }
 
-  const bool isDynamic = loop->getDynamics().isDynamic();
-  for (const auto& pt : refStroke) {
-    if (isDynamic) {
-      brushSize = gfx::Size(pt.size, pt.size);
-      int center = (brushSize.w - brushSize.w % 2) / 2;
-      brushCenter = gfx::Point(center, center);
-    }
-    Stroke::Pt pt2 = pt;
-    pt2.symmetry = symmetry;
-    switch (symmetry) {
-      case doc::SymmetryIndex::ROT_FLIP_270: {
-        int adj_x = 0;
-        int adj_y = 0;
-        if (m_x - double(int(m_x)) > 0)
-          adj_y = 1;
-        if (m_y - double(int(m_y)) > 0)
-          adj_x = 1;
-        if (adj_x == 1 && adj_y == 1) {
-          adj_x = 0;
-          adj_y = 0;
-        }
-        pt2.x = -pt.y + m_x + m_y - (brushSize.w % 2 ? 1 : 0) + adj_x;
-        pt2.y = -pt.x + m_x + m_y - (brushSize.h % 2 ? 1 : 0) + adj_y;
-        break;
-      }
-      case doc::SymmetryIndex::ROT_FLIP_90:
-        pt2.x = pt.y + m_x - m_y + (m_x - int(m_x));
-        pt2.y = pt.x - m_x + m_y + (m_y - int(m_y));
-        break;
-      case doc::SymmetryIndex::ROTATED_90:
-      case doc::SymmetryIndex::ROTATED_270:
-        pt2.y = 2 * m_y - pt.y - (brushSize.h % 2 ? 1 : 0);
-        break;
-      case doc::SymmetryIndex::FLIPPED_X:
-      case doc::SymmetryIndex::FLIPPED_XY: {
-        pt2.x = 2 * (m_x + brushCenter.x) - pt.x - brushSize.w;
-        if (isDoubleDiagonalSymmetry)
-          pt2.y = 2 * (m_y + brushCenter.y) - pt.y - brushSize.h;
-        break;
+  if (loop->getDynamics().isDynamic()) {
+    brushSize = gfx::Size(pt.size, pt.size);
+    int center = (brushSize.w - brushSize.w % 2) / 2;
+    brushCenter = gfx::Point(center, center);
+  }
+
+  Stroke::Pt pt2 = pt;
+  pt2.symmetry = symmetry;
+  switch (symmetry) {
+    case doc::SymmetryIndex::ROT_FLIP_270: {
+      int adj_x = 0;
+      int adj_y = 0;
+      if (m_x - double(int(m_x)) > 0)
+        adj_y = 1;
+      if (m_y - double(int(m_y)) > 0)
+        adj_x = 1;
+      if (adj_x == 1 && adj_y == 1) {
+        adj_x = 0;
+        adj_y = 0;
       }
-      default: pt2.y = 2 * (m_y + brushCenter.y) - pt.y - brushSize.h; break;
+      pt2.x = -pt.y + m_x + m_y - (brushSize.w % 2 ? 1 : 0) + adj_x;
+      pt2.y = -pt.x + m_x + m_y - (brushSize.h % 2 ? 1 : 0) + adj_y;
+      break;
+    }
+    case doc::SymmetryIndex::ROT_FLIP_90:
+      pt2.x = pt.y + m_x - m_y + (m_x - int(m_x));
+      pt2.y = pt.x - m_x + m_y + (m_y - int(m_y));
+      break;
+    case doc::SymmetryIndex::ROTATED_90:
+    case doc::SymmetryIndex::ROTATED_270:
+      pt2.y = 2 * m_y - pt.y - (brushSize.h % 2 ? 1 : 0);
+      break;
+    case doc::SymmetryIndex::FLIPPED_X:
+    case doc::SymmetryIndex::FLIPPED_XY: {
+      pt2.x = 2 * (m_x + brushCenter.x) - pt.x - brushSize.w;
+      if (isDoubleDiagonalSymmetry)
+        pt2.y = 2 * (m_y + brushCenter.y) - pt.y - brushSize.h;
+      break;
     }
-    stroke.addPoint(pt2);
+    default: pt2.y = 2 * (m_y + brushCenter.y) - pt.y - brushSize.h; break;
   }
+  return pt2;
 }
 
 gen::SymmetryMode Symmetry::resolveMode(gen::SymmetryMode mode)
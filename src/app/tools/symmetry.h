@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2021-2025  Igara Studio S.A.
+// Copyright (C) 2021-2026  Igara Studio S.A.
 // Copyright (C) 2015  David Capello
 //
 // This program is distributed under the terms of
@@ -36,6 +36,13 @@ public:
 
   void generateStrokes(const Stroke& stroke, Strokes& strokes, ToolLoop* loop);
 
+  // Single-point version of generateStrokes() used in the hot path of
+  // the intertwiners (called for each stamped point of a stroke), so
+  // the caller can reuse the "pts" buffer instead of creating
+  // temporary strokes for each point. Appends the original point and
+  // its mirrored versions to "pts".
+  void generatePoints(const Stroke::Pt& pt, Stroke::Pts& pts, ToolLoop* loop);
+
   gen::SymmetryMode mode() const { return m_symmetryMode; }
 
   static gen::SymmetryMode resolveMode(gen::SymmetryMode mode);
@@ -47,6 +54,11 @@ private:
                                   const doc::SymmetryIndex symmetry,
                                   const bool isDoubleDiagonalSymmetry = false);
 
+  Stroke::Pt calculateSymmetricalPoint(const Stroke::Pt& pt,
+                                       ToolLoop* loop,
+                                       const doc::SymmetryIndex symmetry,
+                                       const bool isDoubleDiagonalSymmetry = false);
+
   gen::SymmetryMode m_symmetryMode;
   double m_x, m_y;
 };
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -27,6 +27,7 @@
 #include "gfx/point_io.h"
 #include "gfx/rect_io.h"
 #include "gfx/region.h"
+#include "ui/perf_probe.h"
 
 #include <algorithm>
 #include <climits>
@@ -93,6 +94,8 @@ void ToolLoopManager::notifyToolLoopModifiersChange()
 
 void ToolLoopManager::pressButton(const Pointer& pointer)
 {
+  ui::PerfProbe probe("app::tools::ToolLoopManager::pressButton");
+
   TOOL_TRACE("ToolLoopManager::pressButton", pointer.point());
 
   // A little patch to memorize initial Trace Policy in the
@@ -169,32 +172,45 @@ bool ToolLoopManager::releaseButton(const Pointer& pointer)
 
 void ToolLoopManager::movement(Pointer pointer)
 {
-  // Filter points with the stabilizer
-  if (m_dynamics.stabilizer && m_dynamics.stabilizerFactor > 0) {
-    const double f = m_dynamics.stabilizerFactor;
-    const gfx::Point delta = (pointer.point() - m_stabilizerCenter);
-    const double distance = std::sqrt(delta.x * delta.x + delta.y * delta.y);
-
-    const double angle = std::atan2(delta.y, delta.x);
-    const gfx::PointF newPoint(m_stabilizerCenter.x + distance / f * std::cos(angle),
-                               m_stabilizerCenter.y + distance / f * std::sin(angle));
-
-    m_stabilizerCenter = newPoint;
-
-    pointer = Pointer(gfx::Point(newPoint),
-                      pointer.velocity(),
-                      pointer.button(),
-                      pointer.type(),
-                      pointer.pressure());
-  }
+  movement(Pointers(1, pointer));
+}
 
-  m_lastPointer = pointer;
+void ToolLoopManager::movement(const Pointers& pointers)
+{
+  ui::PerfProbe probe("app::tools::ToolLoopManager::movement");
 
-  if (isCanceled())
+  ASSERT(!pointers.empty());
+  if (pointers.empty())
     return;
 
-  Stroke::Pt spritePoint = getSpriteStrokePt(pointer);
-  m_toolLoop->getController()->movement(m_toolLoop, m_stroke, spritePoint);
+  for (Pointer pointer : pointers) {
+    // Filter points with the stabilizer
+    if (m_dynamics.stabilizer && m_dynamics.stabilizerFactor > 0) {
+      const double f = m_dynamics.stabilizerFactor;
+      const gfx::Point delta = (pointer.point() - m_stabilizerCenter);
+      const double distance = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+
+      const double angle = std::atan2(delta.y, delta.x);
+      const gfx::PointF newPoint(m_stabilizerCenter.x + distance / f * std::cos(angle),
+                                 m_stabilizerCenter.y + distance / f * std::sin(angle));
+
+      m_stabilizerCenter = newPoint;
+
+      pointer = Pointer(gfx::Point(newPoint),
+                        pointer.velocity(),
+                        pointer.button(),
+                        pointer.type(),
+                        pointer.pressure());
+    }
+
+    m_lastPointer = pointer;
+
+    if (isCanceled())
+      return;
+
+    Stroke::Pt spritePoint = getSpriteStrokePt(pointer);
+    m_toolLoop->getController()->movement(m_toolLoop, m_stroke, spritePoint);
+  }
 
   std::string statusText;
   m_toolLoop->getController()->getStatusBarText(m_toolLoop, m_stroke, statusText);
@@ -274,12 +290,37 @@ void ToolLoopManager::doLoopStep(bool lastStep)
   if (!lastStep && m_toolLoop->isSelectionToolLoop())
     m_toolLoop->clearSelectionToolMask(false);
 
+  m_toolLoop->getPointShape()->resetExactModifiedArea();
+
   // Join or fill user points
   if (fillStrokes)
     m_toolLoop->getIntertwine()->fillStroke(m_toolLoop, main_stroke);
   else
     m_toolLoop->getIntertwine()->joinStroke(m_toolLoop, main_stroke);
 
+  // If the point shape tracked the exact area it modified (e.g. a
+  // flood fill, where calculateDirtyArea() had to assume the whole
+  // canvas), shrink the dirty region so we don't revalidate and
+  // redraw the full editor canvas for a small filled region. In
+  // tiled mode the tracked area doesn't cover the wrapped sub-lines,
+  // so we keep the conservative estimation there.
+  gfx::Rect exactArea;
+  if (m_toolLoop->getTiledMode() == TiledMode::NONE &&
+      m_toolLoop->getPointShape()->getExactModifiedArea(exactArea)) {
+    if (m_toolLoop->isSelectionToolLoop() && !exactArea.isEmpty())
+      exactArea.enlarge(1); // Same 'trail' borders as in calculateDirtyArea()
+
+    Region exactDirty(exactArea);
+    if (m_toolLoop->getTracePolicy() == TracePolicy::Last) {
+      m_nextDirtyArea = exactDirty;
+      exactDirty |= m_prevDirtyArea;
+    }
+
+    // Keep the viewport limits already applied to the dirty area.
+    exactDirty &= m_dirtyArea;
+    m_dirtyArea = exactDirty;
+  }
+
   if (m_toolLoop->getTracePolicy() == TracePolicy::Overlap) {
     // Copy destination to source (yes, destination to source). In
     // this way each new trace overlaps the previous one.
@@ -312,9 +353,9 @@ void ToolLoopManager::snapToGrid(Stroke::Pt& pt)
 void ToolLoopManager::calculateDirtyArea(const Strokes& strokes)
 {
   // Save the current dirty area if it's needed
-  Region prevDirtyArea;
+  m_prevDirtyArea.clear();
   if (m_toolLoop->getTracePolicy() == TracePolicy::Last)
-    prevDirtyArea = m_nextDirtyArea;
+    m_prevDirtyArea = m_nextDirtyArea;
 
   // Start with a fresh dirty area
   m_dirtyArea.clear();
@@ -355,7 +396,7 @@ void ToolLoopManager::calculateDirtyArea(const Strokes& strokes)
   // the new one)
   if (m_toolLoop->getTracePolicy() == TracePolicy::Last) {
     m_nextDirtyArea = m_dirtyArea;
-    m_dirtyArea.createUnion(m_dirtyArea, prevDirtyArea);
+    m_dirtyArea.createUnion(m_dirtyArea, m_prevDirtyArea);
   }
 
   // Apply tiled mode
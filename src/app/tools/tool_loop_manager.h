@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -79,6 +79,14 @@ public:
   // Should be called each time the user moves the mouse inside the editor.
   void movement(Pointer pointer);
 
+  // Processes several queued pointer positions in one step: all the
+  // positions are sent to the controller (so the stroke keeps every
+  // point) but the trace/ink pass runs just once for the merged
+  // polyline. Used to coalesce pointer events when each step is
+  // expensive (e.g. a big brush), so latency stays bounded instead of
+  // paying one full pass per queued event.
+  void movement(const Pointers& pointers);
+
   // Should be called when Shift+brush tool is used to disable stabilizer
   // on the line preview
   void disableMouseStabilizer();
@@ -100,6 +108,10 @@ private:
   Pointer m_lastPointer;
   gfx::Region m_dirtyArea;
   gfx::Region m_nextDirtyArea;
+  // Dirty area of the previous loop step (calculateDirtyArea() merges
+  // it into m_dirtyArea, doLoopStep() needs it separated in case the
+  // point shape reports an exact modified area after drawing).
+  gfx::Region m_prevDirtyArea;
   DynamicsOptions m_dynamics;
   gfx::PointF m_stabilizerCenter;
   doc::Brush* m_brush0 = nullptr;
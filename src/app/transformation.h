@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2024  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This program is distributed under the terms of
@@ -82,6 +82,13 @@ public:
   void angle(float angle) { m_angle = angle; }
   void skew(float angle) { m_skew = angle; }
 
+  bool operator==(const Transformation& other) const
+  {
+    return (m_bounds == other.m_bounds && m_pivot == other.m_pivot && m_angle == other.m_angle &&
+            m_skew == other.m_skew && m_cornerThick == other.m_cornerThick);
+  }
+  bool operator!=(const Transformation& other) const { return !operator==(other); }
+
   // Applies the transformation (rotation with angle/pivot) to the
   // current bounds (m_bounds).
   Corners transformedCorners() const;
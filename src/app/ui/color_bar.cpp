@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2024  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -53,6 +53,7 @@
 #include "app/ui_context.h"
 #include "app/util/cel_ops.h"
 #include "app/util/clipboard.h"
+#include "app/util/index_usage.h"
 #include "base/scoped_value.h"
 #include "doc/cel.h"
 #include "doc/cels_range.h"
@@ -172,6 +173,8 @@ ColorBar::ColorBar(TooltipManager* tooltipManager)
   , m_tilesetMode(TilesetMode::Auto)
   , m_redrawTimer(250, this)
   , m_redrawAll(false)
+  , m_changedFromIndex(-1)
+  , m_changedToIndex(-1)
   , m_implantChange(false)
   , m_selfPalChange(false)
   , m_splitterPalTilPos(50.0)
@@ -1747,8 +1750,26 @@ void ColorBar::onTimerTick()
   // Redraw just the current editor
   else {
     m_redrawAll = true;
-    if (auto editor = Editor::activeEditor())
-      editor->updateEditor(true);
+    if (auto editor = Editor::activeEditor()) {
+      // If we know which palette entries changed (e.g. dragging a
+      // slider in the color editor modifies one entry), repaint only
+      // the cels that actually use those indices instead of the
+      // whole canvas. The full update of the next timer tick fixes
+      // anything the preview might have missed.
+      gfx::Region rgn;
+      if (editor->sprite() && editor->sprite()->pixelFormat() == IMAGE_INDEXED &&
+          get_cels_region_using_indices(editor->sprite(),
+                                        editor->frame(),
+                                        m_changedFromIndex,
+                                        m_changedToIndex,
+                                        rgn)) {
+        if (!rgn.isEmpty())
+          editor->document()->notifySpritePixelsModified(editor->sprite(), rgn, editor->frame());
+      }
+      else
+        editor->updateEditor(true);
+    }
+    m_changedFromIndex = m_changedToIndex = -1;
   }
 }
 
@@ -1828,6 +1849,12 @@ void ColorBar::updateCurrentSpritePalette(const char* operationName)
       currentSpritePalette->countDiff(newPalette, &from, &to);
 
       if (from >= 0 && to >= from) {
+        // Accumulate the range of modified entries for the quick
+        // preview redraw in onTimerTick().
+        if (m_changedFromIndex < 0 || from < m_changedFromIndex)
+          m_changedFromIndex = from;
+        m_changedToIndex = std::max(m_changedToIndex, to);
+
         DocUndo* undo = document->undoHistory();
         std::unique_ptr<cmd::SetPalette> cmd(new cmd::SetPalette(sprite, frame, newPalette));
 
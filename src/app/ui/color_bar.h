@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2024  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -289,6 +289,12 @@ private:
   ui::Timer m_redrawTimer;
   bool m_redrawAll;
 
+  // Range of palette entries modified since the last quick preview
+  // redraw (-1 = unknown/none), used to repaint only the cels that
+  // use those indices while the user drags in the color editor.
+  int m_changedFromIndex;
+  int m_changedToIndex;
+
   // True if a palette change must be implant in the UndoHistory
   // (e.g. when two or more changes in the palette are made in a
   // very short time).
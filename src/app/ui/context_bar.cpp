@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -1901,6 +1901,7 @@ public:
 };
 
 ContextBar::ContextBar(TooltipManager* tooltipManager, ColorBar* colorBar)
+  : m_updateToolTimer(16) // ~1 tick per frame to coalesce updateForActiveTool() calls
 {
   auto& pref = Preferences::instance();
 
@@ -1973,6 +1974,11 @@ ContextBar::ContextBar(TooltipManager* tooltipManager, ColorBar* colorBar)
     [this, tooltipManager] { setupTooltips(tooltipManager); });
   m_dropPixelsConn = m_dropPixels->DropPixels.connect(&ContextBar::onDropPixels, this);
 
+  m_updateToolTimer.Tick.connect([this] {
+    m_updateToolTimer.stop();
+    updateForTool(App::instance()->activeTool());
+  });
+
   setActiveBrush(createBrushFromPreferences());
 
   initTheme();
@@ -2085,7 +2091,9 @@ void ContextBar::onActiveToolChange(tools::Tool* tool)
   if (m_activeBrush->type() != kImageBrushType)
     setActiveBrush(ContextBar::createBrushFromPreferences());
   else {
-    updateForTool(tool);
+    // The observer always notifies the new active tool, so we can use
+    // the coalesced update.
+    updateForActiveTool();
   }
 }
 
@@ -2132,11 +2140,22 @@ void ContextBar::updateSliceFields(const Site& site)
 
 void ContextBar::updateForActiveTool()
 {
-  updateForTool(App::instance()->activeTool());
+  // Just schedule the rebuild: updateForTool() reformats texts and
+  // shows/hides/relayouts dozens of widgets, and rapid tool switching
+  // or brush resizing can request several updates per frame (each
+  // preference change fires one), interleaved with the stroke
+  // handling. The timer tick coalesces them into one rebuild.
+  if (!m_updateToolTimer.isRunning())
+    m_updateToolTimer.start();
 }
 
 void ContextBar::updateForTool(tools::Tool* tool)
 {
+  // This synchronous rebuild supersedes any pending coalesced one
+  // (and must not be clobbered by it, e.g. updateForMovingPixels()
+  // adjusts some widgets right after calling us).
+  m_updateToolTimer.stop();
+
   // TODO Improve the design of the visibility of ContextBar
   // items. Actually this manual show/hide logic is a mess. There
   // should be a IContextBarUser interface, with a method to ask who
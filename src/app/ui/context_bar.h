@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -25,6 +25,7 @@
 #include "obs/signal.h"
 #include "render/gradient.h"
 #include "ui/box.h"
+#include "ui/timer.h"
 
 #include <vector>
 
@@ -67,6 +68,11 @@ public:
   ContextBar(ui::TooltipManager* tooltipManager, ColorBar* colorBar);
   ~ContextBar();
 
+  // Schedules an updateForTool() with the active tool for the next
+  // timer tick, coalescing several requests (e.g. rapid tool
+  // switching or brush resizing) into one rebuild per tick. Use
+  // updateForTool() directly when the rebuild must happen right now
+  // (e.g. to adjust some widgets just after it).
   void updateForActiveTool();
   void updateForTool(tools::Tool* tool);
   void updateForMovingPixels(const Transformation& t);
@@ -224,6 +230,9 @@ private:
   obs::scoped_connection m_opacityConn;
   obs::scoped_connection m_freehandAlgoConn;
   obs::scoped_connection m_contiguousConn;
+
+  // Timer to coalesce updateForActiveTool() calls (see that function)
+  ui::Timer m_updateToolTimer;
 };
 
 } // namespace app
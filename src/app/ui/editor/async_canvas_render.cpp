@@ -0,0 +1,296 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/ui/editor/async_canvas_render.h"
+
+#include "app/doc.h"
+#include "app/doc_access.h"
+#include "app/job_scheduler.h"
+#include "app/ui/editor/editor.h"
+#include "app/util/conversion_to_surface.h"
+#include "doc/image.h"
+#include "doc/image_ref.h"
+#include "doc/palette.h"
+#include "doc/sprite.h"
+#include "os/system.h"
+#include "render/render.h"
+#include "ui/graphics.h"
+#include "ui/system.h"
+
+namespace app {
+
+AsyncCanvasRender::AsyncCanvasRender(Editor* editor)
+  : m_editor(editor)
+  , m_doc(editor->document())
+  , m_uiToken(std::make_shared<int>(0))
+{
+}
+
+AsyncCanvasRender::~AsyncCanvasRender()
+{
+  // Discard pending completion notifications (we run in the UI
+  // thread, just like the notification itself).
+  m_uiToken.reset();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_stop = true;
+  m_cond.wait(lock, [this] { return !m_jobRunning; });
+}
+
+void AsyncCanvasRender::invalidate(const gfx::Region& spriteRgn)
+{
+  // Ignore the invalidation generated by our own completion
+  // notification, the buffer is already up-to-date.
+  if (m_publishing || spriteRgn.isEmpty())
+    return;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_dirty |= spriteRgn;
+}
+
+bool AsyncCanvasRender::requestRender(const Settings& settings)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_settings = settings;
+
+  const gfx::Size size = settings.spriteSize;
+  const bool frontUsable = (m_frontValid && m_frontFrame == settings.frame && m_front &&
+                            m_front->width() == size.w && m_front->height() == size.h &&
+                            m_front->colorSpace() == settings.colorSpace);
+
+  if ((!frontUsable || !m_dirty.isEmpty()) && !m_jobRunning && !m_stop) {
+    m_jobRunning = true;
+    JobScheduler::instance()->submitJob([this] { renderJob(); });
+  }
+  return frontUsable;
+}
+
+void AsyncCanvasRender::drawCompleted(ui::Graphics* g,
+                                      const gfx::Rect& spriteRc,
+                                      const gfx::Rect& dest,
+                                      const os::Sampling& sampling,
+                                      const os::Paint* paint,
+                                      const int mipLevel)
+{
+  // Holding the mutex while blitting keeps the job from swapping
+  // buffers (and then drawing into this one) in the middle of the
+  // operation.
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // Zoomed-out view: blit from the reduced mipmap buffer (close to
+  // the screen resolution) if the job already prepared this level,
+  // in other case we fallback to downsampling the full-resolution
+  // composite below (correct, just slower, and the next completed
+  // job brings the level for the new zoom).
+  if (mipLevel > 0 && m_mipFrontValid && m_mipFrontLevel == mipLevel && m_mipFront &&
+      m_mipFront->nativeHandle()) {
+    const int x = spriteRc.x >> mipLevel;
+    const int y = spriteRc.y >> mipLevel;
+    gfx::Rect src(x,
+                  y,
+                  ((spriteRc.x2() + (1 << mipLevel) - 1) >> mipLevel) - x,
+                  ((spriteRc.y2() + (1 << mipLevel) - 1) >> mipLevel) - y);
+    src &= gfx::Rect(0, 0, m_mipFront->width(), m_mipFront->height());
+    if (!src.isEmpty()) {
+      g->drawSurface(m_mipFront.get(), src, dest, sampling, paint);
+      return;
+    }
+  }
+
+  if (m_front && m_front->nativeHandle())
+    g->drawSurface(m_front.get(), spriteRc, dest, sampling, paint);
+}
+
+void AsyncCanvasRender::renderJob()
+{
+  while (true) {
+    Settings settings;
+    gfx::Region toRender;
+    gfx::Region newDirty;
+    bool full;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      settings = m_settings;
+
+      const gfx::Size size = settings.spriteSize;
+      full = (!m_frontValid || m_frontFrame != settings.frame || !m_front ||
+              m_front->width() != size.w || m_front->height() != size.h ||
+              m_front->colorSpace() != settings.colorSpace || !m_back ||
+              m_back->width() != size.w || m_back->height() != size.h ||
+              m_back->colorSpace() != settings.colorSpace);
+
+      if (m_stop || (!full && m_dirty.isEmpty())) {
+        // Checking the pending work and clearing m_jobRunning in the
+        // same critical section guarantees that a requestRender()
+        // adding new dirty regions either is processed by this job
+        // or submits a new one.
+        m_jobRunning = false;
+        m_cond.notify_all();
+        return;
+      }
+
+      newDirty = m_dirty;
+      m_dirty.clear();
+      if (full) {
+        toRender = gfx::Region(gfx::Rect(size));
+      }
+      else {
+        // Changes since the front buffer was completed + regions
+        // where the back buffer is older than the front one.
+        toRender = newDirty;
+        toRender |= m_backDirty;
+      }
+    }
+
+    if (!renderIntoBackBuffer(settings, toRender.bounds())) {
+      // The document is write-locked (e.g. a transaction is in
+      // progress): give up and retry from the next paint cycle.
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_dirty |= newDirty;
+      m_jobRunning = false;
+      m_cond.notify_all();
+      notifyEditor();
+      return;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      std::swap(m_front, m_back);
+      m_frontFrame = settings.frame;
+      m_frontValid = true;
+
+      if (settings.mipLevel > 0) {
+        // renderIntoBackBuffer() rewrote m_mipBack completely, so the
+        // old front mipmap just becomes the next scratch buffer.
+        std::swap(m_mipFront, m_mipBack);
+        m_mipFrontLevel = settings.mipLevel;
+        m_mipFrontValid = true;
+      }
+      else
+        m_mipFrontValid = false;
+
+      // After the swap the old front buffer misses everything
+      // modified after its own completion.
+      if (full)
+        m_backDirty = gfx::Region(gfx::Rect(settings.spriteSize));
+      else
+        m_backDirty = newDirty;
+    }
+    notifyEditor();
+  }
+}
+
+bool AsyncCanvasRender::renderIntoBackBuffer(const Settings& settings, const gfx::Rect& bounds)
+{
+  const gfx::Size size = settings.spriteSize;
+
+  // Only this job touches the back buffer, so it can be (re)created
+  // and written without holding the mutex.
+  if (!m_back || m_back->width() != size.w || m_back->height() != size.h ||
+      m_back->colorSpace() != settings.colorSpace) {
+    m_back = os::System::instance()->makeRgbaSurface(size.w, size.h, settings.colorSpace);
+  }
+  if (!m_composite || m_composite->width() != size.w || m_composite->height() != size.h) {
+    m_composite.reset(doc::Image::create(doc::IMAGE_RGB, size.w, size.h));
+    m_pyramid.setBase(m_composite);
+  }
+
+  const gfx::Rect rc = (bounds & gfx::Rect(size));
+  if (rc.isEmpty())
+    return true;
+
+  // Copy of the palette for the conversions done after releasing the
+  // document lock.
+  doc::Palette palette;
+
+  try {
+    // Lock the document to read/render it. We wait a little in case
+    // a write transaction is finishing, but we cannot block this
+    // scheduler thread for too long.
+    //
+    // The critical section covers just the work that reads document
+    // state (the composite render and the palette copy): writers
+    // (i.e. tools committing stroke segments) wait for readers, so
+    // every extra millisecond spent here with the lock held is
+    // potential brush latency. Everything below only touches our
+    // private buffers.
+    DocReader reader(m_doc, 250);
+
+    render::Render render;
+    render.setRefLayersVisiblity(true);
+    render.setNonactiveLayersOpacity(settings.nonactiveLayersOpacity);
+    render.setSelectedLayer(settings.selectedLayer);
+    render.setNewBlend(settings.newBlend);
+    render.setComposeGroups(settings.composeGroups);
+    render.setBgOptions(settings.bg);
+    if (settings.onionskin.type() != render::OnionskinType::NONE)
+      render.setOnionskin(settings.onionskin);
+
+    const doc::Sprite* sprite = m_doc->sprite();
+    render.renderSprite(m_composite.get(),
+                        sprite,
+                        settings.frame,
+                        gfx::ClipF(rc.x, rc.y, rc.x, rc.y, rc.w, rc.h));
+    palette = *sprite->palette(settings.frame);
+  }
+  catch (const LockedDocException&) {
+    return false;
+  }
+
+  m_pyramid.invalidate(rc);
+
+  convert_image_to_surface(m_composite.get(),
+                           &palette,
+                           m_back.get(),
+                           rc.x,
+                           rc.y,
+                           rc.x,
+                           rc.y,
+                           rc.w,
+                           rc.h);
+
+  // Prepare the reduced buffer for zoomed-out views: rebuild the
+  // out-of-date areas of the pyramid and convert the whole level
+  // (cheap, its area is the composite one divided by 4^level).
+  if (settings.mipLevel > 0) {
+    const doc::Image* level = m_pyramid.level(settings.mipLevel);
+    if (!m_mipBack || m_mipBack->width() != level->width() ||
+        m_mipBack->height() != level->height() || m_mipBack->colorSpace() != settings.colorSpace) {
+      m_mipBack = os::System::instance()->makeRgbaSurface(level->width(),
+                                                          level->height(),
+                                                          settings.colorSpace);
+    }
+    convert_image_to_surface(level,
+                             &palette,
+                             m_mipBack.get(),
+                             0,
+                             0,
+                             0,
+                             0,
+                             level->width(),
+                             level->height());
+  }
+  return true;
+}
+
+void AsyncCanvasRender::notifyEditor()
+{
+  ui::execute_from_ui_thread([this, token = std::weak_ptr<void>(m_uiToken)] {
+    // The token is reset in our destructor (also in the UI thread),
+    // so locking it guarantees that "this" is still alive.
+    if (token.lock()) {
+      m_publishing = true;
+      m_editor->invalidateCanvas();
+      m_publishing = false;
+    }
+  });
+}
+
+} // namespace app
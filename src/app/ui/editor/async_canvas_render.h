@@ -0,0 +1,158 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_UI_EDITOR_ASYNC_CANVAS_RENDER_H_INCLUDED
+#define APP_UI_EDITOR_ASYNC_CANVAS_RENDER_H_INCLUDED
+#pragma once
+
+#include "doc/frame.h"
+#include "doc/image_ref.h"
+#include "gfx/region.h"
+#include "os/color_space.h"
+#include "os/sampling.h"
+#include "os/surface.h"
+#include "render/bg_options.h"
+#include "render/mipmap_pyramid.h"
+#include "render/onionskin_options.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace doc {
+class Layer;
+}
+
+namespace os {
+class Paint;
+}
+
+namespace ui {
+class Graphics;
+}
+
+namespace app {
+class Doc;
+class Editor;
+
+// Asynchronous render pipeline for one Editor (experimental
+// "async_render" option): keeps a double-buffered composite of the
+// whole sprite canvas at 1:1 scale. The UI thread blits the last
+// completed buffer on paint (drawCompleted()) and submits dirty
+// sprite regions (invalidate() + requestRender()), which are
+// re-rendered by a background job that invalidates the editor again
+// when a fresh buffer is ready. This way zooming/panning a big
+// document never waits for a full composite inside the paint cycle,
+// at most it shows a stale region for one job run.
+class AsyncCanvasRender {
+public:
+  // Snapshot of everything that affects the composite, captured in
+  // the UI thread (see Editor::makeAsyncRenderSettings()) so the
+  // render job doesn't have to touch Preferences or editor state.
+  struct Settings {
+    doc::frame_t frame = 0;
+    gfx::Size spriteSize;
+    os::ColorSpaceRef colorSpace = nullptr;
+    const doc::Layer* selectedLayer = nullptr;
+    int nonactiveLayersOpacity = 255;
+    bool newBlend = true;
+    bool composeGroups = false;
+    render::BgOptions bg;
+    render::OnionskinOptions onionskin{ render::OnionskinType::NONE };
+    // Mipmap level for the current zoom (see
+    // render::MipmapPyramid::levelForScale()), so the job also
+    // prepares a downscaled buffer for zoomed-out views.
+    int mipLevel = 0;
+  };
+
+  AsyncCanvasRender(Editor* editor);
+
+  // Waits until the in-flight render job (if any) finishes.
+  ~AsyncCanvasRender();
+
+  // Marks a region (in sprite coordinates) as out-of-date in both
+  // buffers. Called from Editor::onInvalidateRegion(), i.e. any
+  // visual refresh of the editor conservatively re-renders the
+  // covered sprite area in the background.
+  void invalidate(const gfx::Region& spriteRgn);
+
+  // Returns true if there is a completed composite that matches the
+  // given frame/canvas (its content can still be stale if a job is
+  // re-rendering dirty regions). Schedules a background render job
+  // when the buffer is out-of-date. If it returns false the caller
+  // must render synchronously this time.
+  bool requestRender(const Settings& settings);
+
+  // Blits the last completed composite (the given sprite rectangle)
+  // on the graphics context. Only valid right after requestRender()
+  // returned true. When mipLevel > 0 and the matching mipmap buffer
+  // is ready, the blit reads from that reduced buffer instead of the
+  // full-resolution composite.
+  void drawCompleted(ui::Graphics* g,
+                     const gfx::Rect& spriteRc,
+                     const gfx::Rect& dest,
+                     const os::Sampling& sampling,
+                     const os::Paint* paint,
+                     const int mipLevel = 0);
+
+private:
+  void renderJob();
+  bool renderIntoBackBuffer(const Settings& settings, const gfx::Rect& bounds);
+  void notifyEditor();
+
+  Editor* m_editor;
+  Doc* m_doc;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_jobRunning = false;
+  bool m_stop = false;
+
+  // Last completed composite, read by the UI thread under m_mutex.
+  os::SurfaceRef m_front;
+  doc::frame_t m_frontFrame = -1;
+  bool m_frontValid = false;
+
+  // Scratch buffer, touched only by the render job.
+  os::SurfaceRef m_back;
+
+  // Full-resolution composite image and its mipmap pyramid, touched
+  // only by the render job (the surfaces above are converted from
+  // m_composite). Used to display zoomed-out views from a reduced
+  // level instead of downsampling the full-resolution buffer.
+  doc::ImageRef m_composite;
+  render::MipmapPyramid m_pyramid;
+
+  // Downscaled composite for the requested mip level: m_mipFront is
+  // read by the UI thread under m_mutex, m_mipBack only by the job.
+  os::SurfaceRef m_mipFront;
+  os::SurfaceRef m_mipBack;
+  int m_mipFrontLevel = 0;
+  bool m_mipFrontValid = false;
+
+  // Regions to re-render: m_dirty accumulates invalidations since
+  // the front buffer was completed, m_backDirty is where the back
+  // buffer is older than the front one (each job run renders the
+  // union of both).
+  gfx::Region m_dirty;
+  gfx::Region m_backDirty;
+
+  // Settings for the next job run (written by the UI thread, read by
+  // the job, both under m_mutex).
+  Settings m_settings;
+
+  // True while our own completion notification invalidates the
+  // editor (so it isn't taken as new dirty content). UI thread only.
+  bool m_publishing = false;
+
+  // Destroyed in our destructor (UI thread): pending notifications
+  // that cannot lock it anymore are discarded.
+  std::shared_ptr<void> m_uiToken;
+};
+
+} // namespace app
+
+#endif
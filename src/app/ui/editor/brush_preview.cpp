@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -210,10 +210,13 @@ void BrushPreview::show(const gfx::Point& screenPos)
     const auto& dynamics = App::instance()->contextBar()->getDynamics();
     if (brush->type() != doc::kImageBrushType && (dynamics.size != tools::DynamicSensor::Static ||
                                                   dynamics.angle != tools::DynamicSensor::Static)) {
-      brush.reset(new Brush(
+      // Re-use a cached brush so we don't regenerate the brush
+      // image/mask on each mouse movement (and its gen() is stable,
+      // which keeps the cached boundaries/UILayer valid too).
+      brush = App::instance()->brushes().getComputedBrush(
         brush->type(),
         (dynamics.size != tools::DynamicSensor::Static ? dynamics.minSize : brush->size()),
-        (dynamics.angle != tools::DynamicSensor::Static ? dynamics.minAngle : brush->angle())));
+        (dynamics.angle != tools::DynamicSensor::Static ? dynamics.minAngle : brush->angle()));
     }
   }
 
@@ -638,35 +641,31 @@ void BrushPreview::createBoundaries(const Site& site, const gfx::Point& spritePo
 
   const bool isOnePixel = (m_editor->getCurrentEditorTool()->getPointShape(0)->isPixel() ||
                            m_editor->getCurrentEditorTool()->getPointShape(0)->isFloodFill());
-  Image* brushImage = brush->image();
   m_brushGen = brush->gen();
 
-  Image* mask = nullptr;
-  bool deleteMask = true;
   if (tilemapMode == TilemapMode::Tiles) {
-    mask = Image::create(IMAGE_BITMAP, site.grid().tileSize().w, site.grid().tileSize().h);
+    std::unique_ptr<Image> mask(
+      Image::create(IMAGE_BITMAP, site.grid().tileSize().w, site.grid().tileSize().h));
     mask->clear((color_t)1);
+    m_brushBoundaries.regen(mask.get());
   }
   else if (isOnePixel) {
-    mask = Image::create(IMAGE_BITMAP, 1, 1);
+    std::unique_ptr<Image> mask(Image::create(IMAGE_BITMAP, 1, 1));
     mask->putPixel(0, 0, (color_t)1);
+    m_brushBoundaries.regen(mask.get());
   }
-  else if (brushImage->pixelFormat() != IMAGE_BITMAP) {
-    ASSERT(brush->maskBitmap());
-    deleteMask = false;
-    mask = brush->maskBitmap();
+  else {
+    // The boundary trace is cached in AppBrushes, so other editors
+    // (or re-selecting the same brush) don't repeat it.
+    m_brushBoundaries = App::instance()->brushes().getBrushBoundaries(brush.get());
   }
 
-  m_brushBoundaries.regen(mask ? mask : brushImage);
   if (tilemapMode == TilemapMode::Pixels) {
     if (!isOnePixel)
       m_brushBoundaries.offset(-brush->center().x, -brush->center().y);
   }
   else
     calculateTileBoundariesOrigin(site.grid(), spritePos);
-
-  if (deleteMask)
-    delete mask;
 }
 
 void BrushPreview::createCrosshairCursor(ui::Graphics* g, const gfx::Color cursorColor)
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2022-2025  Igara Studio S.A.
+// Copyright (C) 2022-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -34,6 +34,18 @@ DelayedMouseMove::DelayedMouseMove(DelayedMouseMoveDelegate* delegate,
   m_timer.Tick.connect([this] { commitMouseMove(); });
 }
 
+void DelayedMouseMove::setInterval(const int interval)
+{
+  if (m_timer.interval() == interval)
+    return;
+
+  // Stop the timer before changing its interval (a pending tick will
+  // not be lost: the next onMouseMove() restarts it or commits
+  // immediately).
+  stopTimer();
+  m_timer.setInterval(interval);
+}
+
 void DelayedMouseMove::reset()
 {
   m_mouseMoveReceived = false;
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2022-2024  Igara Studio S.A.
+// Copyright (C) 2022-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -38,6 +38,11 @@ public:
   // want to disable the delay between onMouseMove() -> onCommitMouseMove()
   DelayedMouseMove(DelayedMouseMoveDelegate* delegate, Editor* editor, const int interval);
 
+  // The interval can be adjusted at runtime, e.g. to start grouping
+  // mouse movements when each onCommitMouseMove() gets expensive.
+  int interval() const { return m_timer.interval(); }
+  void setInterval(const int interval);
+
   // Resets internals to receive an onMouseDown() again and
   // interpret a "one click" correctly again.
   void reset();
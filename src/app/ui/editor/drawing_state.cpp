@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2024  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -59,6 +59,18 @@ static int get_delay_interval_for_tool_loop(tools::ToolLoop* toolLoop)
   }
 }
 
+// When one tool loop step (ink pass) takes this long (in
+// milliseconds) we start coalescing queued pointer events for
+// freehand-like tools: all the positions received while the previous
+// step was running are intertwined as one polyline and processed in a
+// single step (see DrawingState::onCommitMouseMove()).
+static const int kCoalesceMovementThreshold = 10;
+
+// Delay used to group pointer events while coalescing is active.
+// Keep it short: it's just enough to let the already queued mouse
+// messages be dispatched before the commit.
+static const int kCoalesceMovementInterval = 5;
+
 DrawingState::DrawingState(Editor* editor, tools::ToolLoop* toolLoop, const DrawingType type)
   : m_editor(editor)
   , m_type(type)
@@ -71,6 +83,11 @@ DrawingState::DrawingState(Editor* editor, tools::ToolLoop* toolLoop, const Draw
   m_beforeCmdConn = UIContext::instance()->BeforeCommandExecution.connect(
     &DrawingState::onBeforeCommandExecution,
     this);
+
+  // Only tools that process each movement immediately (freehand-like
+  // tools) can coalesce events; tools that use a delay interval
+  // already group movements keeping just the last position.
+  m_canCoalesceMovement = (m_delayedMouseMove.interval() == 0);
 }
 
 DrawingState::~DrawingState()
@@ -266,14 +283,28 @@ bool DrawingState::onMouseMove(Editor* editor, MouseMessage* msg)
   // Use DelayedMouseMove for tools like line, rectangle, etc. (that
   // use the only the last mouse position) to filter out rapid mouse
   // movement.
-  m_delayedMouseMove.onMouseMove(msg);
+  if (m_coalesceMovement) {
+    // While coalescing, the commit is deferred with a short timer and
+    // we keep every pointer position received in between (freehand
+    // tools need the whole path, not just the last position).
+    if (m_delayedMouseMove.onMouseMove(msg))
+      m_pendingPointers.push_back(m_lastPointer);
+  }
+  else {
+    m_delayedMouseMove.onMouseMove(msg);
+  }
   return true;
 }
 
 void DrawingState::onCommitMouseMove(Editor* editor, const gfx::PointF& spritePos)
 {
   if (m_toolLoop && m_toolLoopManager && !m_toolLoopManager->isCanceled()) {
+    const base::tick_t start = base::current_tick();
+
     handleMouseMovement();
+
+    if (m_canCoalesceMovement)
+      updateMovementCoalescing(base::current_tick() - start);
   }
 }
 
@@ -368,7 +399,29 @@ void DrawingState::handleMouseMovement()
 {
   // Notify mouse movement to the tool
   ASSERT(m_toolLoopManager);
-  m_toolLoopManager->movement(m_lastPointer);
+
+  if (!m_pendingPointers.empty()) {
+    // Process all the coalesced pointer positions in one step. If
+    // m_lastPointer changed after the last queued position (e.g. by
+    // an onScrollChange()), it's included in the same batch.
+    tools::Pointers pointers;
+    pointers.swap(m_pendingPointers);
+    if (pointers.back().point() != m_lastPointer.point())
+      pointers.push_back(m_lastPointer);
+    m_toolLoopManager->movement(pointers);
+  }
+  else {
+    m_toolLoopManager->movement(m_lastPointer);
+  }
+}
+
+void DrawingState::updateMovementCoalescing(const base::tick_t stepDuration)
+{
+  const bool slow = (stepDuration >= kCoalesceMovementThreshold);
+  if (slow != m_coalesceMovement) {
+    m_coalesceMovement = slow;
+    m_delayedMouseMove.setInterval(slow ? kCoalesceMovementInterval : 0);
+  }
 }
 
 bool DrawingState::canExecuteCommands()
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -68,6 +68,7 @@ public:
 
 private:
   void handleMouseMovement();
+  void updateMovementCoalescing(const base::tick_t stepDuration);
   bool canExecuteCommands();
   void onBeforeCommandExecution(CommandExecutionEvent& ev);
   void destroyLoopIfCanceled(Editor* editor);
@@ -90,6 +91,19 @@ private:
   // button when onScrollChange() event is received.
   tools::Pointer m_lastPointer;
 
+  // Pointer positions received while a deferred commit is pending,
+  // processed as one tool loop step (one ink pass for the whole
+  // polyline). Used only when m_coalesceMovement is true.
+  tools::Pointers m_pendingPointers;
+
+  // True for freehand-like tools (the ones that commit each mouse
+  // movement immediately), where we enable event coalescing
+  // adaptively when a tool loop step becomes expensive.
+  bool m_canCoalesceMovement = false;
+
+  // True when we are currently grouping queued pointer events.
+  bool m_coalesceMovement = false;
+
   // Used to calculate the velocity of the mouse (whch is a sensor
   // to generate dynamic parameters).
   tools::VelocitySensor m_velocity;
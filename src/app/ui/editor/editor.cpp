@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -62,12 +62,14 @@
 #include "doc/doc.h"
 #include "doc/mask_boundaries.h"
 #include "doc/slice.h"
+#include "doc/slices.h"
 #include "fmt/format.h"
 #include "os/color_space.h"
 #include "os/sampling.h"
 #include "os/surface.h"
 #include "os/system.h"
 #include "render/rasterize.h"
+#include "ui/perf_probe.h"
 #include "ui/ui.h"
 #include "view/layers.h"
 
@@ -76,6 +78,7 @@
 #include <cstdio>
 #include <limits>
 #include <memory>
+#include <vector>
 
 namespace app {
 
@@ -156,6 +159,7 @@ Editor::Editor(Doc* document, EditorFlags flags, EditorStatePtr state)
   , m_padding(0, 0)
   , m_antsTimer(100, this)
   , m_antsOffset(0)
+  , m_prerenderTimer(100, this)
   , m_customizationDelegate(NULL)
   , m_docView(NULL)
   , m_flags(flags)
@@ -232,6 +236,9 @@ Editor::~Editor()
   setCustomizationDelegate(NULL);
 
   m_antsTimer.stop();
+  m_prerenderTimer.stop();
+  if (m_renderEngine)
+    m_renderEngine->removePlaybackCache(&m_frameCache);
 }
 
 void Editor::destroyEditorSharedInternals()
@@ -437,6 +444,39 @@ void Editor::setFrame(frame_t frame)
   // Invalidate canvas area
   invalidateCanvas();
   updateStatusBar();
+
+  // When the user stops stepping frames, pre-composite the adjacent
+  // ones (PlayState has its own lookahead while the animation is
+  // playing).
+  if (!m_isPlaying)
+    m_prerenderTimer.start();
+}
+
+bool Editor::prerenderAdjacentFrames()
+{
+  if (m_isPlaying || !m_sprite || !isVisible())
+    return false;
+
+  const frame_t last = m_sprite->lastFrame();
+  if (last == 0)
+    return false;
+
+  std::vector<frame_t> upcoming;
+  upcoming.reserve(2);
+  if (m_frame < last)
+    upcoming.push_back(m_frame + 1);
+  if (m_frame > 0)
+    upcoming.push_back(m_frame - 1);
+
+  PlaybackFrameCache::Settings settings;
+  auto& pref = Preferences::instance();
+  settings.newBlend = pref.experimental.newBlend();
+  settings.composeGroups = pref.experimental.composeGroups();
+
+  // Re-attach on each tick in case another editor (or a playback)
+  // attached its own cache in-between.
+  m_renderEngine->setPlaybackCache(&m_frameCache);
+  return m_frameCache.precompose(m_document, settings, upcoming);
 }
 
 void Editor::getSite(Site* site) const
@@ -668,8 +708,33 @@ void Editor::drawOneSpriteUnclippedRect(ui::Graphics* g,
     dest.h = rc.h;
   }
 
+  // Preview window of a zoomed-out sprite: composite at panel
+  // resolution instead of at full document resolution (the remaining
+  // scale to the exact panel size is applied in the blit below). The
+  // SimpleRenderer blends the reduced planes kept by the playback
+  // cache, so a playing preview of a big sprite costs panel-sized
+  // compositing on each pass of the loop.
+  int previewLevel = 0;
+  gfx::Rect rcR;
+  if (newEngine && m_docView && m_docView->isPreview() &&
+      m_renderEngine->type() == EditorRender::Type::kSimpleRenderer &&
+      !m_renderEngine->hasPreviewImage() && m_flashing == Flashing::None) {
+    previewLevel = render::MipmapPyramid::levelForScale(std::min(m_proj.scaleX(), m_proj.scaleY()));
+    if (previewLevel > 0) {
+      // Round rc2 out to the reduced pixel grid (the same mapping
+      // used to blit mipmap levels in AsyncCanvasRender).
+      const int x = rc2.x >> previewLevel;
+      const int y = rc2.y >> previewLevel;
+      rcR = gfx::Rect(x,
+                      y,
+                      ((rc2.x2() + (1 << previewLevel) - 1) >> previewLevel) - x,
+                      ((rc2.y2() + (1 << previewLevel) - 1) >> previewLevel) - y);
+    }
+  }
+
   // Convert the render to a os::Surface
   static os::SurfaceRef rendered = nullptr; // TODO move this to other centralized place
+  bool asyncBlit = false;
   const auto& renderProperties = m_renderEngine->properties();
   try {
     // Generate a "expose sprite pixels" notification. This is used by
@@ -677,83 +742,83 @@ void Editor::drawOneSpriteUnclippedRect(ui::Graphics* g,
     // the original cel) before it can be used by the RenderEngine.
     m_document->notifyExposeSpritePixels(m_sprite, gfx::Region(expose));
 
-    m_renderEngine->setComposeGroups(pref.experimental.composeGroups());
-    m_renderEngine->setNewBlendMethod(pref.experimental.newBlend());
-    m_renderEngine->setRefLayersVisiblity(true);
-    m_renderEngine->setSelectedLayer(m_layer);
-    m_renderEngine->setNonactiveLayersOpacity(otherLayersOpacity());
-    m_renderEngine->setupBackground(m_document, IMAGE_RGB);
-    m_renderEngine->disableOnionskin();
-
-    if ((m_flags & kShowOnionskin) == kShowOnionskin) {
-      if (m_docPref.onionskin.active()) {
-        OnionskinOptions opts(
-          (m_docPref.onionskin.type() == app::gen::OnionskinType::MERGE ?
-             render::OnionskinType::MERGE :
-             (m_docPref.onionskin.type() == app::gen::OnionskinType::RED_BLUE_TINT ?
-                render::OnionskinType::RED_BLUE_TINT :
-                render::OnionskinType::NONE)));
-
-        opts.position(m_docPref.onionskin.position());
-        opts.prevFrames(m_docPref.onionskin.prevFrames());
-        opts.nextFrames(m_docPref.onionskin.nextFrames());
-        opts.opacityBase(m_docPref.onionskin.opacityBase());
-        opts.opacityStep(m_docPref.onionskin.opacityStep());
-        opts.layer(m_docPref.onionskin.currentLayer() ? m_layer : nullptr);
-
-        Tag* tag = nullptr;
-        if (m_docPref.onionskin.loopTag())
-          tag = m_sprite->tags().innerTag(m_frame);
-        opts.loopTag(tag);
-
-        m_renderEngine->setOnionskin(opts);
-      }
+    // Asynchronous render pipeline: blit the last composite completed
+    // by the render job and let it refresh out-of-date regions in the
+    // background (the editor is invalidated again when a new
+    // composite is ready), so the paint cycle never waits for a full
+    // render of a big document.
+    if (canUseAsyncRender(newEngine)) {
+      if (!m_asyncRender)
+        m_asyncRender = std::make_unique<AsyncCanvasRender>(this);
+      asyncBlit = m_asyncRender->requestRender(makeAsyncRenderSettings());
     }
 
-    ExtraCelRef extraCel = m_document->extraCel();
-    if (extraCel && extraCel->type() != render::ExtraType::NONE &&
-        // We render the extra cel if:
-        ( // 1) it doesn't contains the brush preview (e.g. the user
-          // is transforming the selection),
-          extraCel->purpose() != ExtraCel::Purpose::BrushPreview
-          // 2) we are drawing the brush preview in a regular editor,
-          || !m_docView->isPreview()
-          // 3) we are drawing the brush preview in a preview editor
-          // and preferences (brushPreviewInPreview) says that we
-          // should do that.
-          || pref.cursor.brushPreviewInPreview())) {
-      m_renderEngine->setExtraImage(extraCel->type(),
-                                    extraCel->cel(),
-                                    extraCel->image(),
-                                    extraCel->blendMode(),
-                                    m_layer,
-                                    m_frame);
-    }
+    if (!asyncBlit) {
+      m_renderEngine->setComposeGroups(pref.experimental.composeGroups());
+      m_renderEngine->setNewBlendMethod(pref.experimental.newBlend());
+      m_renderEngine->setRefLayersVisiblity(true);
+      m_renderEngine->setSelectedLayer(m_layer);
+      m_renderEngine->setNonactiveLayersOpacity(otherLayersOpacity());
+      m_renderEngine->setupBackground(m_document, IMAGE_RGB);
+      m_renderEngine->disableOnionskin();
+
+      {
+        OnionskinOptions opts = onionskinOptions();
+        if (opts.type() != render::OnionskinType::NONE)
+          m_renderEngine->setOnionskin(opts);
+      }
 
-    // Render background first (e.g. new ShaderRenderer will paint the
-    // background on the screen first and then composite the rendered
-    // sprite on it.)
-    if (renderProperties.renderBgOnScreen) {
-      m_renderEngine->setProjection(m_proj);
-      m_renderEngine->renderCheckeredBackground(g->getInternalSurface(),
-                                                m_sprite,
-                                                gfx::Clip(dest.x + g->getInternalDeltaX(),
-                                                          dest.y + g->getInternalDeltaY(),
-                                                          m_proj.apply(rc2)));
-    }
+      ExtraCelRef extraCel = m_document->extraCel();
+      if (extraCel && extraCel->type() != render::ExtraType::NONE &&
+          // We render the extra cel if:
+          ( // 1) it doesn't contains the brush preview (e.g. the user
+            // is transforming the selection),
+            extraCel->purpose() != ExtraCel::Purpose::BrushPreview
+            // 2) we are drawing the brush preview in a regular editor,
+            || !m_docView->isPreview()
+            // 3) we are drawing the brush preview in a preview editor
+            // and preferences (brushPreviewInPreview) says that we
+            // should do that.
+            || pref.cursor.brushPreviewInPreview())) {
+        m_renderEngine->setExtraImage(extraCel->type(),
+                                      extraCel->cel(),
+                                      extraCel->image(),
+                                      extraCel->blendMode(),
+                                      m_layer,
+                                      m_frame);
+      }
 
-    // Create a temporary surface to draw the sprite on it
-    if (!rendered || rendered->width() < rc2.w || rendered->height() < rc2.h ||
-        rendered->colorSpace() != m_document->osColorSpace()) {
-      const int maxw = std::max(rc2.w, rendered ? rendered->width() : 0);
-      const int maxh = std::max(rc2.h, rendered ? rendered->height() : 0);
-      rendered = os::System::instance()->makeRgbaSurface(maxw, maxh, m_document->osColorSpace());
-    }
+      // Render background first (e.g. new ShaderRenderer will paint the
+      // background on the screen first and then composite the rendered
+      // sprite on it.)
+      if (renderProperties.renderBgOnScreen) {
+        m_renderEngine->setProjection(m_proj);
+        m_renderEngine->renderCheckeredBackground(g->getInternalSurface(),
+                                                  m_sprite,
+                                                  gfx::Clip(dest.x + g->getInternalDeltaX(),
+                                                            dest.y + g->getInternalDeltaY(),
+                                                            m_proj.apply(rc2)));
+      }
 
-    m_renderEngine->setProjection(newEngine ? render::Projection() : m_proj);
-    m_renderEngine->renderSprite(rendered.get(), m_sprite, m_frame, gfx::Clip(0, 0, rc2));
+      // Create a temporary surface to draw the sprite on it
+      const gfx::Rect renderRc = (previewLevel > 0 ? rcR : rc2);
+      if (!rendered || rendered->width() < renderRc.w || rendered->height() < renderRc.h ||
+          rendered->colorSpace() != m_document->osColorSpace()) {
+        const int maxw = std::max(renderRc.w, rendered ? rendered->width() : 0);
+        const int maxh = std::max(renderRc.h, rendered ? rendered->height() : 0);
+        rendered = os::System::instance()->makeRgbaSurface(maxw, maxh, m_document->osColorSpace());
+      }
 
-    m_renderEngine->removeExtraImage();
+      // The render engine is shared between editors, so the
+      // downsampling level is set explicitly on each render (0 for
+      // regular editors).
+      m_renderEngine->setDownsampleLevel(previewLevel);
+      m_renderEngine->setProjection(newEngine ? render::Projection() : m_proj);
+      m_renderEngine->renderSprite(rendered.get(), m_sprite, m_frame, gfx::Clip(0, 0, renderRc));
+
+      m_renderEngine->setDownsampleLevel(0);
+      m_renderEngine->removeExtraImage();
+    }
 
     // If the checkered background is visible in this sprite, we save
     // all settings of the background for this document.
@@ -764,7 +829,7 @@ void Editor::drawOneSpriteUnclippedRect(ui::Graphics* g,
     Console::showException(e);
   }
 
-  if (rendered && rendered->nativeHandle()) {
+  if (asyncBlit || (rendered && rendered->nativeHandle())) {
     os::Paint p;
     if (newEngine) {
       os::Sampling sampling;
@@ -799,8 +864,31 @@ void Editor::drawOneSpriteUnclippedRect(ui::Graphics* g,
         --destClip.h;
 
       IntersectClip clip(g, destClip);
-      if (clip)
-        g->drawSurface(rendered.get(), gfx::Rect(0, 0, rc2.w, rc2.h), dest, sampling, &p);
+      if (clip) {
+        if (asyncBlit) {
+          // The asynchronous buffer contains the whole sprite, so the
+          // source rectangle is the exposed sprite area itself. At
+          // zoom < 100% the blit can read from a reduced mipmap level
+          // of the composite instead of the full-resolution buffer.
+          m_asyncRender->drawCompleted(g,
+                                       gfx::Rect(rc2),
+                                       dest,
+                                       sampling,
+                                       &p,
+                                       render::MipmapPyramid::levelForScale(
+                                         std::min(m_proj.scaleX(), m_proj.scaleY())));
+        }
+        else if (previewLevel > 0) {
+          // The reduced render covers rc2 rounded out to the reduced
+          // grid, the sub-pixel stretch to fit "dest" is not visible
+          // at these zoom levels (same trade-off as the mipmap blit
+          // in AsyncCanvasRender::drawCompleted()).
+          g->drawSurface(rendered.get(), gfx::Rect(0, 0, rcR.w, rcR.h), dest, sampling, &p);
+        }
+        else {
+          g->drawSurface(rendered.get(), gfx::Rect(0, 0, rc2.w, rc2.h), dest, sampling, &p);
+        }
+      }
     }
     else {
       g->drawSurface(rendered.get(),
@@ -975,6 +1063,11 @@ void Editor::drawBackground(ui::Graphics* g)
 
 void Editor::drawSpriteUnclippedRect(ui::Graphics* g, const gfx::Rect& _rc)
 {
+  // Covers the sprite render plus the blit of the rendered image to
+  // the editor surface (the renderSprite probe inside measures just
+  // the render part).
+  ui::PerfProbe probe("app::Editor::drawSprite");
+
   gfx::Rect rc = _rc;
   // For odd zoom scales minor than 100% we have to add an extra window
   // just to make sure the whole rectangle is drawn.
@@ -1108,6 +1201,25 @@ void Editor::drawMaskBoundaries(ui::Graphics* g, doc::MaskBoundaries& segs, cons
   // Create the mask boundaries path
   segs.createPathIfNeeeded();
 
+  // Re-create the screen-space path only when the boundaries, the
+  // zoom, or the origin changed. The ants timer just animates the
+  // checkered pattern offset, the geometry is the same on each tick,
+  // so transforming the whole path again every 100ms is wasted work
+  // (noticeable with complex selections, e.g. from magic wand).
+  if (m_antsPathSource != &segs || m_antsPathVersion != segs.version() ||
+      m_antsPathZoom != m_proj.zoom() || m_antsPathOrigin != pt) {
+    // We translate the path instead of applying a matrix to the
+    // ui::Graphics so the "checkered" pattern is not scaled too.
+    m_antsPath.rewind();
+    segs.path().transform(m_proj.scaleMatrix(), &m_antsPath);
+    m_antsPath.offset(pt.x, pt.y);
+
+    m_antsPathSource = &segs;
+    m_antsPathVersion = segs.version();
+    m_antsPathZoom = m_proj.zoom();
+    m_antsPathOrigin = pt;
+  }
+
   ui::Paint paint;
   paint.style(ui::Paint::Stroke);
   set_checkered_paint_mode(paint,
@@ -1115,12 +1227,7 @@ void Editor::drawMaskBoundaries(ui::Graphics* g, doc::MaskBoundaries& segs, cons
                            gfx::rgba(0, 0, 0, 255),
                            gfx::rgba(255, 255, 255, 255));
 
-  // We translate the path instead of applying a matrix to the
-  // ui::Graphics so the "checkered" pattern is not scaled too.
-  gfx::Path path;
-  segs.path().transform(m_proj.scaleMatrix(), &path);
-  path.offset(pt.x, pt.y);
-  g->drawPath(path, paint);
+  g->drawPath(m_antsPath, paint);
 }
 
 void Editor::drawMaskSafe()
@@ -1203,6 +1310,17 @@ void Editor::drawGrid(Graphics* g,
   grid_color =
     gfx::rgba(gfx::getr(grid_color), gfx::getg(grid_color), gfx::getb(grid_color), alpha);
 
+  // When the cell size/origin are integers in screen coordinates
+  // (integer zoom levels, the common case) we can tile-blit a
+  // pre-rendered pattern of grid cells, which is a lot cheaper than
+  // drawing thousands of alpha-blended line primitives at high zoom
+  // levels (e.g. the pixel grid on a 4K viewport).
+  if (gridF.w == std::floor(gridF.w) && gridF.h == std::floor(gridF.h) &&
+      gridF.x == std::floor(gridF.x) && gridF.y == std::floor(gridF.y) &&
+      drawGridPattern(g, spriteBounds, gridF, grid_color)) {
+    return;
+  }
+
   // Draw horizontal lines
   int x1 = spriteBounds.x;
   int y1 = gridF.y;
@@ -1220,6 +1338,86 @@ void Editor::drawGrid(Graphics* g,
     g->drawVLine(grid_color, c, y1, spriteBounds.h);
 }
 
+bool Editor::drawGridPattern(ui::Graphics* g,
+                             const gfx::Rect& spriteBounds,
+                             const gfx::RectF& gridF,
+                             const gfx::Color color)
+{
+  // Maximum side of the cached pattern surface (cells bigger than
+  // this don't benefit from tiling anyway, there are just a few grid
+  // lines on screen in that case).
+  constexpr int kMaxPatternSize = 256;
+
+  const gfx::Size cell(int(gridF.w), int(gridF.h));
+  if (cell.w < 1 || cell.h < 1 || cell.w > kMaxPatternSize || cell.h > kMaxPatternSize)
+    return false;
+
+  GridPattern* pattern = nullptr;
+  for (auto& cached : m_gridPatterns) {
+    if (cached.surface && cached.cell == cell && cached.color == color) {
+      pattern = &cached;
+      break;
+    }
+  }
+  if (!pattern) {
+    // Pre-render a block of grid cells with the grid color (blending
+    // the lines over a transparent background, so blitting the
+    // pattern gives the same result as blending each line on screen,
+    // including the double-blended line intersections).
+    const gfx::Size size(cell.w * std::max(1, kMaxPatternSize / cell.w),
+                         cell.h * std::max(1, kMaxPatternSize / cell.h));
+    os::SurfaceRef surface = os::System::instance()->makeRgbaSurface(size.w, size.h);
+    if (!surface)
+      return false;
+    surface->clear();
+    {
+      ui::Graphics pg(surface);
+      for (int y = 0; y < size.h; y += cell.h)
+        pg.drawHLine(color, 0, y, size.w);
+      for (int x = 0; x < size.w; x += cell.w)
+        pg.drawVLine(color, x, 0, size.h);
+    }
+
+    pattern = &m_gridPatterns[m_nextGridPattern];
+    m_nextGridPattern = (m_nextGridPattern + 1) % int(std::size(m_gridPatterns));
+    pattern->surface = surface;
+    pattern->cell = cell;
+    pattern->color = color;
+  }
+
+  // Tile the pattern over the sprite bounds (one extra pixel on the
+  // right/bottom to include the closing grid lines, like the line
+  // loops of drawGrid() do), blitting just the blocks that intersect
+  // the area to redraw.
+  IntersectClip clip(
+    g,
+    gfx::Rect(spriteBounds.x, spriteBounds.y, spriteBounds.w + 1, spriteBounds.h + 1));
+  if (!clip)
+    return true;
+
+  const gfx::Rect vis = g->getClipBounds();
+  if (vis.isEmpty())
+    return true;
+
+  // First pattern block at the left/top of the visible area keeping
+  // the grid phase (block sizes are multiples of the cell size)
+  auto alignDown = [](const int pos, const int origin, const int period) {
+    int d = pos - origin;
+    d -= (d % period + period) % period;
+    return origin + d;
+  };
+  const int pw = pattern->surface->width();
+  const int ph = pattern->surface->height();
+  const int startX = alignDown(vis.x, int(gridF.x), pw);
+  const int startY = alignDown(vis.y, int(gridF.y), ph);
+
+  for (int y = startY; y < vis.y2(); y += ph)
+    for (int x = startX; x < vis.x2(); x += pw)
+      g->drawRgbaSurface(pattern->surface.get(), x, y);
+
+  return true;
+}
+
 void Editor::drawSlices(ui::Graphics* g)
 {
   if ((m_flags & kShowSlices) == 0)
@@ -2006,11 +2204,12 @@ bool Editor::selectSliceBox(const gfx::Rect& box)
     UIContext::instance()->notifyBeforeActiveSiteChanged();
 
   m_selectedSlices.clear();
-  for (auto slice : m_sprite->slices()) {
-    auto key = slice->getByFrame(m_frame);
-    if (key && key->bounds().intersects(box))
-      m_selectedSlices.insert(slice->id());
-  }
+
+  std::vector<doc::Slice*> slices;
+  m_sprite->slices().findInRect(m_frame, box, slices);
+  for (auto slice : slices)
+    m_selectedSlices.insert(slice->id());
+
   invalidate();
 
   if (isActive())
@@ -2092,6 +2291,10 @@ bool Editor::onProcessMessage(Message* msg)
           m_antsTimer.stop();
         }
       }
+      else if (static_cast<TimerMessage*>(msg)->timer() == &m_prerenderTimer) {
+        if (!prerenderAdjacentFrames())
+          m_prerenderTimer.stop();
+      }
       break;
 
     case kFocusEnterMessage: {
@@ -2448,6 +2651,25 @@ void Editor::onPaint(ui::PaintEvent& ev)
       }
 #endif // ENABLE_DEVMODE
 
+      // Performance overlay: avg/max time of each scoped probe since
+      // the last repaint (render, message generation, tool loop,
+      // etc.). Works in release builds, see ui/perf_probe.h.
+      if (Preferences::instance().perf.showPerfOverlay()) {
+        ui::set_perf_probes_enabled(true);
+
+        View* view = View::getView(this);
+        gfx::Point pt = view->viewportBounds().origin() - bounds().origin();
+        for (const auto& stats : ui::get_perf_probe_stats()) {
+          pt.y += g->measureText(stats.name).h;
+          std::string buf = fmt::format("{}: {:.2f} ms avg / {:.2f} ms max ({})",
+                                        stats.name,
+                                        stats.avgMs,
+                                        stats.maxMs,
+                                        stats.count);
+          g->drawText(buf, gfx::rgba(255, 255, 255, 255), gfx::rgba(0, 0, 0, 255), pt);
+        }
+      }
+
       // Draw the mask boundaries
       if (m_document->hasMaskBoundaries()) {
         drawMask(g);
@@ -2471,6 +2693,23 @@ void Editor::onInvalidateRegion(const gfx::Region& region)
 {
   Widget::onInvalidateRegion(region);
   m_brushPreview.invalidateRegion(region);
+
+  // Mark the invalidated sprite area as out-of-date in the
+  // asynchronous render pipeline (every visual refresh of the canvas
+  // goes through this point).
+  if (m_asyncRender && m_sprite) {
+    gfx::Region spriteRgn;
+    for (const gfx::Rect& rc : region) {
+      gfx::Rect sprRc = screenToEditor(rc);
+      // One extra pixel (plus rounding error at zoom < 100%) to be
+      // conservative.
+      sprRc.enlarge(1 + std::max(m_proj.removeX<int>(1), m_proj.removeY<int>(1)));
+      sprRc &= m_sprite->bounds();
+      if (!sprRc.isEmpty())
+        spriteRgn |= gfx::Region(sprRc);
+    }
+    m_asyncRender->invalidate(spriteRgn);
+  }
 }
 
 // When the current tool is changed
@@ -2681,7 +2920,18 @@ EditorHit Editor::calcHit(const gfx::Point& mouseScreenPos)
       if (m_docPref.show.slices()) {
         gfx::Point mainOffset(mainTilePosition());
 
-        for (auto slice : m_sprite->slices()) {
+        // Query the slices around the mouse position through the
+        // spatial index (all the hit regions checked below are
+        // inside the slice bounds, the margin just covers the
+        // rounding of the screen -> sprite conversion).
+        gfx::Rect queryBounds(screenToEditor(mouseScreenPos), gfx::Size(1, 1));
+        queryBounds.enlarge(2 + int(std::ceil(1.0 / m_proj.zoom().scale())));
+        queryBounds.offset(-mainOffset);
+
+        std::vector<doc::Slice*> slices;
+        m_sprite->slices().findInRect(m_frame, queryBounds, slices);
+
+        for (auto slice : slices) {
           auto key = slice->getByFrame(m_frame);
           if (key) {
             gfx::Rect bounds = key->bounds();
@@ -3178,6 +3428,74 @@ int Editor::otherLayersOpacity() const
     return Preferences::instance().experimental.nonactiveLayersOpacity();
 }
 
+render::OnionskinOptions Editor::onionskinOptions() const
+{
+  if ((m_flags & kShowOnionskin) != kShowOnionskin || !m_docPref.onionskin.active())
+    return OnionskinOptions(render::OnionskinType::NONE);
+
+  OnionskinOptions opts(
+    (m_docPref.onionskin.type() == app::gen::OnionskinType::MERGE ?
+       render::OnionskinType::MERGE :
+       (m_docPref.onionskin.type() == app::gen::OnionskinType::RED_BLUE_TINT ?
+          render::OnionskinType::RED_BLUE_TINT :
+          render::OnionskinType::NONE)));
+
+  opts.position(m_docPref.onionskin.position());
+  opts.prevFrames(m_docPref.onionskin.prevFrames());
+  opts.nextFrames(m_docPref.onionskin.nextFrames());
+  opts.opacityBase(m_docPref.onionskin.opacityBase());
+  opts.opacityStep(m_docPref.onionskin.opacityStep());
+  opts.layer(m_docPref.onionskin.currentLayer() ? m_layer : nullptr);
+
+  Tag* tag = nullptr;
+  if (m_docPref.onionskin.loopTag())
+    tag = m_sprite->tags().innerTag(m_frame);
+  opts.loopTag(tag);
+
+  return opts;
+}
+
+bool Editor::canUseAsyncRender(const bool newEngine) const
+{
+  // The asynchronous pipeline produces the plain sprite composite at
+  // 100% scale, so it can replace the render only when the new engine
+  // blits that same composite without extra content on it.
+  if (!newEngine || !Preferences::instance().experimental.asyncRender() ||
+      m_renderEngine->type() != EditorRender::Type::kSimpleRenderer ||
+      m_renderEngine->hasPreviewImage() || m_flashing != Flashing::None ||
+      (m_docView && m_docView->isPreview())) {
+    return false;
+  }
+
+  // The extra cel (brush preview/transformations) is composited
+  // inside the render, fallback to the synchronous path while it's
+  // active.
+  ExtraCelRef extraCel = m_document->extraCel();
+  if (extraCel && extraCel->type() != render::ExtraType::NONE)
+    return false;
+
+  return true;
+}
+
+AsyncCanvasRender::Settings Editor::makeAsyncRenderSettings()
+{
+  // Snapshot of everything that the render job needs, taken in the UI
+  // thread so the job never touches Preferences or editor state.
+  AsyncCanvasRender::Settings settings;
+  settings.frame = m_frame;
+  settings.spriteSize = m_sprite->bounds().size();
+  settings.colorSpace = m_document->osColorSpace();
+  settings.selectedLayer = m_layer;
+  settings.nonactiveLayersOpacity = otherLayersOpacity();
+  settings.newBlend = Preferences::instance().experimental.newBlend();
+  settings.composeGroups = Preferences::instance().experimental.composeGroups();
+  settings.bg = EditorRender::makeBgOptions(m_document, IMAGE_RGB);
+  settings.onionskin = onionskinOptions();
+  settings.mipLevel = render::MipmapPyramid::levelForScale(
+    std::min(m_proj.scaleX(), m_proj.scaleY()));
+  return settings;
+}
+
 // static
 void Editor::registerCommands()
 {
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -13,9 +13,11 @@
 #include "app/doc.h"
 #include "app/doc_observer.h"
 #include "app/pref/preferences.h"
+#include "app/render/playback_frame_cache.h"
 #include "app/tools/active_tool_observer.h"
 #include "app/tools/tool_loop_modifiers.h"
 #include "app/ui/color_source.h"
+#include "app/ui/editor/async_canvas_render.h"
 #include "app/ui/editor/brush_preview.h"
 #include "app/ui/editor/editor_hit.h"
 #include "app/ui/editor/editor_observers.h"
@@ -29,6 +31,7 @@
 #include "doc/selected_objects.h"
 #include "filters/tiled_mode.h"
 #include "gfx/fwd.h"
+#include "gfx/path.h"
 #include "obs/connection.h"
 #include "os/color_space.h"
 #include "render/projection.h"
@@ -167,6 +170,9 @@ public:
   // Draws the sprite taking care of the whole clipping region.
   void drawSpriteClipped(const gfx::Region& updateRegion);
 
+  // Invalidates the visible part of the sprite canvas.
+  void invalidateCanvas();
+
   void flashCurrentLayer();
 
   // Convert ui::Display coordinates (pixel relative to the top-left
@@ -376,6 +382,10 @@ private:
                 const gfx::Rect& gridBounds,
                 const app::Color& color,
                 int alpha);
+  bool drawGridPattern(ui::Graphics* g,
+                       const gfx::Rect& spriteBounds,
+                       const gfx::RectF& gridF,
+                       const gfx::Color color);
   void drawSlices(ui::Graphics* g);
   void drawTileNumbers(ui::Graphics* g, const Cel* cel);
   void drawCelBounds(ui::Graphics* g, const Cel* cel, const gfx::Color color);
@@ -409,12 +419,27 @@ private:
 
   gfx::Point calcExtraPadding(const render::Projection& proj);
 
-  void invalidateCanvas();
   void invalidateIfActive();
   void updateAutoCelGuides(ui::Message* msg);
 
+  // Pre-composites the frames adjacent to the current one in the
+  // background (called from the m_prerenderTimer tick, i.e. when the
+  // editor went idle after a frame change). Returns true while some
+  // composite is still pending.
+  bool prerenderAdjacentFrames();
+
   int otherLayersOpacity() const;
 
+  // Onionskin options to render this editor (type NONE when the
+  // onionskin must not be rendered).
+  render::OnionskinOptions onionskinOptions() const;
+
+  // True if drawOneSpriteUnclippedRect() can blit the composite from
+  // the asynchronous render pipeline instead of rendering the sprite
+  // inside the paint cycle.
+  bool canUseAsyncRender(const bool newEngine) const;
+  AsyncCanvasRender::Settings makeAsyncRenderSettings();
+
   // Stack of states. The top element in the stack is the current state (m_state).
   EditorStatesHistory m_statesHistory;
   EditorStatesHistory m_deletedStates;
@@ -438,6 +463,11 @@ private:
   // Brush preview
   BrushPreview m_brushPreview;
 
+  // Asynchronous render pipeline (experimental.async_render), created
+  // lazily the first time the canvas can be rendered in a background
+  // job.
+  std::unique_ptr<AsyncCanvasRender> m_asyncRender;
+
   tools::ToolLoopModifiers m_toolLoopModifiers;
 
   // Extra space around the sprite.
@@ -447,6 +477,38 @@ private:
   ui::Timer m_antsTimer;
   int m_antsOffset;
 
+  // Started when the active frame changes: while it's running we
+  // pre-composite the adjacent frames with background jobs, so
+  // stepping frames (onion skin, Left/Right keys) hits the cache
+  // instead of paying a full composite per keypress.
+  ui::Timer m_prerenderTimer;
+
+  // Pre-composited adjacent frames (see prerenderAdjacentFrames()).
+  PlaybackFrameCache m_frameCache;
+
+  // Cached screen-space path of the marching ants (the boundaries
+  // path already transformed with the current projection), so each
+  // m_antsTimer tick just re-strokes the same path with a new
+  // checkered pattern offset instead of transforming the whole
+  // boundaries path again.
+  gfx::Path m_antsPath;
+  const doc::MaskBoundaries* m_antsPathSource = nullptr;
+  int m_antsPathVersion = 0;
+  render::Zoom m_antsPathZoom = render::Zoom(1, 1);
+  gfx::Point m_antsPathOrigin;
+
+  // Cached grid patterns: a block of grid cells pre-rendered with the
+  // grid color that drawGrid() tile-blits instead of drawing each
+  // grid line individually (two slots so the grid and the pixel grid
+  // don't evict each other).
+  struct GridPattern {
+    os::SurfaceRef surface;
+    gfx::Size cell;
+    gfx::Color color = gfx::ColorNone;
+  };
+  GridPattern m_gridPatterns[2];
+  int m_nextGridPattern = 0;
+
   obs::scoped_connection m_samplingChangeConn;
   obs::scoped_connection m_fgColorChangeConn;
   obs::scoped_connection m_contextBarBrushChangeConn;
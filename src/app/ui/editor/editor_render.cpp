@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2023  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2018  David Capello
 //
 // This program is distributed under the terms of
@@ -15,6 +15,7 @@
 #include "app/pref/preferences.h"
 #include "app/render/shader_renderer.h"
 #include "app/render/simple_renderer.h"
+#include "ui/perf_probe.h"
 
 namespace app {
 
@@ -82,6 +83,12 @@ void EditorRender::setProjection(const render::Projection& projection)
 }
 
 void EditorRender::setupBackground(Doc* doc, doc::PixelFormat pixelFormat)
+{
+  m_renderer->setBgOptions(makeBgOptions(doc, pixelFormat));
+}
+
+// static
+render::BgOptions EditorRender::makeBgOptions(Doc* doc, doc::PixelFormat pixelFormat)
 {
   DocumentPreferences& docPref = Preferences::instance().document(doc);
   render::BgType bgType;
@@ -122,7 +129,7 @@ void EditorRender::setupBackground(Doc* doc, doc::PixelFormat pixelFormat)
   bg.color1 = color_utils::color_for_image_without_alpha(docPref.bg.color1(), pixelFormat);
   bg.color2 = color_utils::color_for_image_without_alpha(docPref.bg.color2(), pixelFormat);
   bg.stripeSize = tile;
-  m_renderer->setBgOptions(bg);
+  return bg;
 }
 
 void EditorRender::setTransparentBackground()
@@ -142,11 +149,13 @@ void EditorRender::setPreviewImage(const doc::Layer* layer,
                                    const gfx::Point& pos,
                                    const doc::BlendMode blendMode)
 {
+  m_hasPreviewImage = true;
   m_renderer->setPreviewImage(layer, frame, image, tileset, pos, blendMode);
 }
 
 void EditorRender::removePreviewImage()
 {
+  m_hasPreviewImage = false;
   m_renderer->removePreviewImage();
 }
 
@@ -175,11 +184,27 @@ void EditorRender::disableOnionskin()
   m_renderer->disableOnionskin();
 }
 
+void EditorRender::setPlaybackCache(PlaybackFrameCache* cache)
+{
+  m_renderer->setPlaybackCache(cache);
+}
+
+void EditorRender::removePlaybackCache(const PlaybackFrameCache* cache)
+{
+  m_renderer->removePlaybackCache(cache);
+}
+
+void EditorRender::setDownsampleLevel(const int level)
+{
+  m_renderer->setDownsampleLevel(level);
+}
+
 void EditorRender::renderSprite(os::Surface* dstSurface,
                                 const doc::Sprite* sprite,
                                 doc::frame_t frame,
                                 const gfx::ClipF& area)
 {
+  ui::PerfProbe probe("render::Render::renderSprite");
   m_renderer->renderSprite(dstSurface, sprite, frame, area);
 }
 
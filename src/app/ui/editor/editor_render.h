@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2018  David Capello
 //
 // This program is distributed under the terms of
@@ -36,6 +36,7 @@ class Surface;
 
 namespace app {
 class Doc;
+class PlaybackFrameCache;
 
 class EditorRender {
 public:
@@ -62,6 +63,10 @@ public:
   void setupBackground(Doc* doc, doc::PixelFormat pixelFormat);
   void setTransparentBackground();
 
+  // Returns the background options (checkered/transparent) that
+  // setupBackground() would configure for the given document.
+  static render::BgOptions makeBgOptions(Doc* doc, doc::PixelFormat pixelFormat);
+
   void setSelectedLayer(const doc::Layer* layer);
 
   void setPreviewImage(const doc::Layer* layer,
@@ -71,6 +76,7 @@ public:
                        const gfx::Point& pos,
                        const doc::BlendMode blendMode);
   void removePreviewImage();
+  bool hasPreviewImage() const { return m_hasPreviewImage; }
 
   void setExtraImage(render::ExtraType type,
                      const doc::Cel* cel,
@@ -83,6 +89,11 @@ public:
   void setOnionskin(const render::OnionskinOptions& options);
   void disableOnionskin();
 
+  void setPlaybackCache(PlaybackFrameCache* cache);
+  void removePlaybackCache(const PlaybackFrameCache* cache);
+
+  void setDownsampleLevel(const int level);
+
   void renderSprite(os::Surface* dstSurface,
                     const doc::Sprite* sprite,
                     doc::frame_t frame,
@@ -102,6 +113,7 @@ public:
 
 private:
   std::unique_ptr<Renderer> m_renderer;
+  bool m_hasPreviewImage = false;
 };
 
 } // namespace app
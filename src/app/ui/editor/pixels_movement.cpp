@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -41,12 +41,15 @@
 #include "doc/image.h"
 #include "doc/layer.h"
 #include "doc/mask.h"
+#include "doc/primitives.h"
 #include "doc/sprite.h"
 #include "doc/util.h"
 #include "gfx/region.h"
 #include "render/render.h"
+#include "ui/system.h"
 
 #include <algorithm>
+#include <thread>
 
 #if _DEBUG
   #define DUMP_INNER_CMDS() dumpInnerCmds()
@@ -125,6 +128,7 @@ PixelsMovement::PixelsMovement(Context* context,
   , m_canHandleFrameChange(false)
   , m_fastMode(false)
   , m_needsRotSpriteRedraw(false)
+  , m_uiToken(std::make_shared<int>(0))
 {
   // Save and Lock the TilemapMode.
   // TODO: enable TilemapMode exchanges during PixelMovement.
@@ -170,6 +174,8 @@ PixelsMovement::PixelsMovement(Context* context,
 
 PixelsMovement::~PixelsMovement()
 {
+  m_uiToken.reset();
+
   if (ColorBar::instance())
     ColorBar::instance()->unlockTilemapMode();
 }
@@ -191,12 +197,130 @@ void PixelsMovement::setFastMode(const bool fastMode)
   bool redraw = (m_fastMode && !fastMode);
   m_fastMode = fastMode;
   if (m_needsRotSpriteRedraw && redraw) {
-    redrawExtraImage();
-    update_screen_for_document(m_document);
     m_needsRotSpriteRedraw = false;
+
+    // Render the exact RotSprite result in a background thread
+    // keeping the FAST preview on screen meanwhile (a whole RotSprite
+    // pass over a big selection can take seconds and would freeze the
+    // UI right when the user pauses/finishes the drag).
+    if (!launchExactPreviewRender()) {
+      redrawExtraImage();
+      update_screen_for_document(m_document);
+    }
   }
 }
 
+// Renders the exact (RotSprite) version of the transformation preview
+// in a background thread and copies it into the extra cel when it's
+// ready. The thread works over copies of the original image/mask (the
+// layer render below the selection is prepared here, in the UI
+// thread), so it doesn't touch the document and the result can be
+// discarded safely if the transformation changed meanwhile (any
+// synchronous redraw of the extra cel increments m_exactPreviewGen).
+// Returns false if this transformation cannot be rendered in the
+// background (e.g. transforming tiles) and the caller must fallback to
+// the synchronous redraw.
+bool PixelsMovement::launchExactPreviewRender()
+{
+  // Transformed tilemaps don't use RotSprite at all.
+  if (m_site.tilemapMode() == TilemapMode::Tiles)
+    return false;
+
+  const Transformation transformation = m_currentData;
+  const gfx::Rect bounds = transformation.transformedBounds();
+  if (bounds.isEmpty() || !m_extraCel || !m_extraCel->image())
+    return false;
+
+  // Prepare the destination image with the layer render below the
+  // moving pixels, just like drawImage() does for the extra cel.
+  const auto corners = transformation.transformedCorners();
+  const gfx::Rect cornersBounds = corners.bounds(transformation.cornerThick());
+  const gfx::PointF pt(bounds.origin());
+
+  doc::ImageRef dst(Image::create(m_site.sprite()->pixelFormat(), bounds.w, bounds.h));
+  dst->setMaskColor(m_site.sprite()->transparentColor());
+  dst->clear(dst->maskColor());
+  {
+    render::Render render;
+    render.renderLayer(
+      dst.get(),
+      m_site.layer(),
+      m_site.frame(),
+      gfx::Clip(cornersBounds.x - pt.x, cornersBounds.y - pt.y, cornersBounds),
+      BlendMode::SRC);
+  }
+
+  // Copy the inputs so the thread doesn't share anything with the UI
+  // (drawImage() can change the mask color of m_originalImage at any
+  // time).
+  color_t maskColor = m_maskColor;
+  if (m_opaque) {
+    if (m_originalImage->pixelFormat() == IMAGE_INDEXED)
+      maskColor = -1;
+    else
+      maskColor = 0;
+  }
+  doc::ImageRef src(Image::createCopy(m_originalImage.get()));
+  src->setMaskColor(maskColor);
+  auto mask = std::make_shared<Mask>(*m_initialMask);
+
+  const int gen = ++m_exactPreviewGen;
+  std::thread([this,
+               token = std::weak_ptr<void>(m_uiToken),
+               gen,
+               corners,
+               pt,
+               dst,
+               src,
+               mask] {
+    bool ok = true;
+    try {
+      doc::algorithm::rotsprite_image(dst.get(),
+                                      src.get(),
+                                      mask->bitmap(),
+                                      int(corners.leftTop().x - pt.x),
+                                      int(corners.leftTop().y - pt.y),
+                                      int(corners.rightTop().x - pt.x),
+                                      int(corners.rightTop().y - pt.y),
+                                      int(corners.rightBottom().x - pt.x),
+                                      int(corners.rightBottom().y - pt.y),
+                                      int(corners.leftBottom().x - pt.x),
+                                      int(corners.leftBottom().y - pt.y));
+    }
+    catch (const std::bad_alloc&) {
+      ok = false;
+    }
+
+    ui::execute_from_ui_thread([this, token, gen, dst, ok] {
+      // The token is reset in our destructor (also in the UI thread),
+      // so locking it guarantees that "this" is still alive.
+      if (!token.lock())
+        return;
+
+      // A new drag started or the extra cel was redrawn for another
+      // transformation: the result is outdated, discard it (when the
+      // drag pauses again a new render is launched).
+      if (gen != m_exactPreviewGen || m_fastMode)
+        return;
+
+      if (!ok) {
+        // Not enough memory for RotSprite, keep the FAST preview.
+        StatusBar::instance()->showTip(1000,
+                                       Strings::statusbar_tips_not_enough_rotsprite_memory());
+        return;
+      }
+
+      if (m_extraCel && m_extraCel->image() &&
+          m_extraCel->image()->size() == dst->size()) {
+        copy_image(m_extraCel->image(), dst.get());
+        update_screen_for_document(m_document);
+      }
+    });
+  }).detach();
+
+  return true;
+}
+
 void PixelsMovement::flipImage(doc::algorithm::FlipType flipType)
 {
   m_innerCmds.push_back(InnerCmd::MakeFlip(flipType));
@@ -1108,6 +1232,10 @@ void PixelsMovement::setMaskColor(bool opaque, color_t mask_color)
 
 void PixelsMovement::redrawExtraImage(Transformation* transformation)
 {
+  // Any synchronous redraw outdates the exact preview that could be
+  // rendering in a background thread (launchExactPreviewRender()).
+  ++m_exactPreviewGen;
+
   if (!transformation)
     transformation = &m_currentData;
 
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -132,6 +132,7 @@ public:
 
 private:
   void setTransformationBase(const Transformation& t);
+  bool launchExactPreviewRender();
   void adjustPivot();
   bool editMultipleCels() const;
   void stampImage(bool finalStamp);
@@ -203,6 +204,16 @@ private:
   bool m_fastMode;
   bool m_needsRotSpriteRedraw;
 
+  // Generation of the exact RotSprite preview that is being rendered
+  // in a background thread (launchExactPreviewRender()). It's
+  // incremented on each synchronous redraw of the extra cel so stale
+  // background results are just discarded when they arrive.
+  int m_exactPreviewGen = 0;
+
+  // Reset in the destructor (in the UI thread) so queued UI-thread
+  // callbacks from background renders know if "this" is still alive.
+  std::shared_ptr<void> m_uiToken;
+
   // Commands used in the interaction with the transformed pixels.
   // This is used to re-create the whole interaction on each
   // modified cel when we are modifying multiples cels at the same
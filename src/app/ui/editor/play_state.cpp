@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2023  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -18,14 +18,20 @@
 #include "app/tools/ink.h"
 #include "app/ui/editor/editor.h"
 #include "app/ui/editor/editor_customization_delegate.h"
+#include "app/ui/editor/editor_render.h"
 #include "app/ui/editor/scrolling_state.h"
 #include "app/ui/skin/skin_theme.h"
+#include "app/ui/status_bar.h"
 #include "app/ui_context.h"
 #include "doc/tag.h"
+#include "fmt/format.h"
 #include "ui/manager.h"
 #include "ui/message.h"
 #include "ui/system.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace app {
 
 using namespace ui;
@@ -38,6 +44,7 @@ PlayState::PlayState(const bool playOnce, const bool playAll, const bool playSub
   , m_toScroll(false)
   , m_playTimer(10)
   , m_nextFrameTime(-1)
+  , m_droppedFrames(0)
   , m_refFrame(0)
   , m_tag(nullptr)
 {
@@ -50,6 +57,14 @@ PlayState::PlayState(const bool playOnce, const bool playAll, const bool playSub
     this);
 }
 
+PlayState::~PlayState()
+{
+  // In case the state is destroyed without passing through
+  // onLeaveState() (the renderer must not keep a pointer to our
+  // frame cache).
+  Editor::renderEngine().removePlaybackCache(&m_frameCache);
+}
+
 Tag* PlayState::playingTag() const
 {
   return m_tag;
@@ -106,10 +121,14 @@ void PlayState::onEnterState(Editor* editor)
       m_playAll  ? doc::Playback::PlayWithoutTagsInLoop :
                    doc::Playback::PlayInLoop,
       m_tag);
-    m_nextFrameTime = getNextFrameTime();
+    m_nextFrameTime = getNextFrameTime(m_editor->frame());
     m_curFrameTick = base::current_tick();
+    m_droppedFrames = 0;
     m_playTimer.start();
   }
+
+  // Start pre-compositing the frames to play in the background.
+  precomposeUpcomingFrames();
 }
 
 EditorState::LeaveAction PlayState::onLeaveState(Editor* editor, EditorState* newState)
@@ -119,6 +138,8 @@ EditorState::LeaveAction PlayState::onLeaveState(Editor* editor, EditorState* ne
   if (!m_toScroll) {
     m_playTimer.stop();
 
+    Editor::renderEngine().removePlaybackCache(&m_frameCache);
+
     if (m_playOnce || Preferences::instance().general.rewindOnStop())
       m_editor->setFrame(m_refFrame);
   }
@@ -212,21 +233,83 @@ void PlayState::onPlaybackTick()
 
   m_nextFrameTime -= (base::current_tick() - m_curFrameTick);
 
+  // The playback is scheduled by wall clock: if the UI fell behind
+  // (slow renders at big zoom levels, etc.) several frames can be due
+  // in a single tick. Only the last one is rendered, the others just
+  // advance the playback state and are counted as dropped, so the
+  // animation keeps its real timing instead of slowing down.
+  doc::frame_t frame = -1;
+  bool stopped = false;
   while (m_nextFrameTime <= 0) {
-    doc::frame_t frame = m_playback.nextFrame();
+    const doc::frame_t next = m_playback.nextFrame();
     if (m_playback.isStopped() ||
         // TODO invalid frame from Playback::nextFrame(), in this way
         //      we avoid any kind of crash or assert fail
-        frame < 0 || frame > m_editor->sprite()->lastFrame()) {
-      TRACEARGS("!!! PlayState: invalid frame from Playback::nextFrame() frame=", frame);
+        next < 0 || next > m_editor->sprite()->lastFrame()) {
+      TRACEARGS("!!! PlayState: invalid frame from Playback::nextFrame() frame=", next);
       m_editor->stop();
+      stopped = true;
       break;
     }
+    if (frame >= 0)
+      ++m_droppedFrames;
+    frame = next;
+    m_nextFrameTime += getNextFrameTime(frame);
+  }
+
+  if (frame >= 0 && !stopped) {
     m_editor->setFrame(frame);
-    m_nextFrameTime += getNextFrameTime();
+    if (m_droppedFrames > 0) {
+      StatusBar::instance()->setStatusText(
+        250,
+        fmt::format("Playback: {} dropped frame(s)", m_droppedFrames));
+    }
   }
 
   m_curFrameTick = base::current_tick();
+
+  precomposeUpcomingFrames();
+}
+
+void PlayState::precomposeUpcomingFrames()
+{
+  if (m_playback.isStopped())
+    return;
+
+  // doc::Playback cannot be cloned to query the real upcoming
+  // sequence (it owns the state of the tags being played), so we
+  // predict a plain forward loop through the current tag/sprite
+  // range. A mispredicted frame just wastes one background
+  // composite, and the current frame is always included, so a loop
+  // is fully cached after its first pass anyway.
+  const doc::Sprite* sprite = m_editor->sprite();
+  doc::frame_t from = 0;
+  doc::frame_t to = sprite->lastFrame();
+  if (const doc::Tag* tag = m_playback.tag()) {
+    from = std::clamp(tag->fromFrame(), doc::frame_t(0), to);
+    to = std::clamp(tag->toFrame(), from, to);
+  }
+
+  constexpr int kLookahead = 8;
+  const doc::frame_t nframes = to - from + 1;
+  doc::frame_t frame = std::clamp(m_editor->frame(), from, to);
+
+  std::vector<doc::frame_t> upcoming;
+  upcoming.reserve(std::min(int(nframes), kLookahead));
+  for (int i = 0; i < kLookahead && i < nframes; ++i) {
+    upcoming.push_back(frame);
+    frame = from + (frame - from + 1) % nframes;
+  }
+
+  PlaybackFrameCache::Settings settings;
+  auto& pref = Preferences::instance();
+  settings.newBlend = pref.experimental.newBlend();
+  settings.composeGroups = pref.experimental.composeGroups();
+
+  // Re-attach on each tick in case another playing editor attached
+  // its own cache in-between.
+  Editor::renderEngine().setPlaybackCache(&m_frameCache);
+  m_frameCache.precompose(m_editor->document(), settings, upcoming);
 }
 
 // Before executing any command, we stop the animation
@@ -257,9 +340,9 @@ void PlayState::onBeforeCommandExecution(CommandExecutionEvent& ev)
   m_editor->stop();
 }
 
-double PlayState::getNextFrameTime()
+double PlayState::getNextFrameTime(doc::frame_t frame)
 {
-  return m_editor->sprite()->frameDuration(m_editor->frame()) /
+  return m_editor->sprite()->frameDuration(frame) /
          m_editor->getAnimationSpeedMultiplier(); // The "speed multiplier" is a "duration divider"
 }
 
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2022  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -9,6 +9,7 @@
 #define APP_UI_EDITOR_PLAY_STATE_H_INCLUDED
 #pragma once
 
+#include "app/render/playback_frame_cache.h"
 #include "app/ui/editor/state_with_wheel_behavior.h"
 #include "base/time.h"
 #include "doc/frame.h"
@@ -27,6 +28,7 @@ class CommandExecutionEvent;
 class PlayState : public StateWithWheelBehavior {
 public:
   PlayState(const bool playOnce, const bool playAll, const bool playSubtags);
+  ~PlayState();
 
   doc::Tag* playingTag() const;
 
@@ -43,14 +45,20 @@ public:
 
 private:
   void onPlaybackTick();
+  void precomposeUpcomingFrames();
 
   // ContextObserver
   void onBeforeCommandExecution(CommandExecutionEvent& ev);
 
-  double getNextFrameTime();
+  double getNextFrameTime(doc::frame_t frame);
 
   Editor* m_editor;
   doc::Playback m_playback;
+
+  // Pre-composited frames of the sequence being played (filled in
+  // the background between ticks, so loops play from the cache after
+  // their first pass).
+  PlaybackFrameCache m_frameCache;
   bool m_playOnce;
   bool m_playAll;
   bool m_playSubtags;
@@ -62,6 +70,12 @@ private:
   double m_nextFrameTime;
   base::tick_t m_curFrameTick;
 
+  // Number of frames that were advanced but never rendered since the
+  // playback started: the clock runs on real time, so when rendering
+  // falls behind we skip frames instead of slowing the animation
+  // down.
+  int m_droppedFrames;
+
   doc::frame_t m_refFrame;
   doc::Tag* m_tag;
 
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -61,6 +61,7 @@
 #include "doc/layer_tilemap.h"
 #include "doc/mask.h"
 #include "doc/slice.h"
+#include "doc/slices.h"
 #include "doc/sprite.h"
 #include "fmt/format.h"
 #include "gfx/rect.h"
@@ -584,17 +585,16 @@ bool StandbyState::onUpdateStatusBar(Editor* editor)
 
     if (editor->docPref().show.slices()) {
       int count = 0;
-      for (auto slice : editor->document()->sprite()->slices()) {
-        auto key = slice->getByFrame(editor->frame());
-        if (key &&
-            key->bounds().contains(int(std::floor(spritePos.x)), int(std::floor(spritePos.y)))) {
-          if (++count == 3) {
-            buf += fmt::format(" :slice: ...");
-            break;
-          }
-
-          buf += fmt::format(" :slice: {}", slice->name());
+      const gfx::Rect hoverBounds(int(std::floor(spritePos.x)), int(std::floor(spritePos.y)), 1, 1);
+      std::vector<doc::Slice*> slices;
+      editor->document()->sprite()->slices().findInRect(editor->frame(), hoverBounds, slices);
+      for (auto slice : slices) {
+        if (++count == 3) {
+          buf += fmt::format(" :slice: ...");
+          break;
         }
+
+        buf += fmt::format(" :slice: {}", slice->name());
       }
     }
 
@@ -790,7 +790,9 @@ void StandbyState::onPivotChange(Editor* editor)
 {
   if (editor->isActive() && editor->editorFlags() & Editor::kShowMask &&
       editor->document()->isMaskVisible() && !editor->document()->mask()->isFrozen()) {
-    editor->invalidate();
+    // Only the handle/pivot rects change, no need to repaint the
+    // whole editor canvas.
+    m_decorator->getTransformHandles(editor)->invalidateHandles(editor, getTransformation(editor));
   }
 }
 
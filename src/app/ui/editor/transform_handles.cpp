@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2025  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -62,28 +62,26 @@ HandleType TransformHandles::getHandleAtPoint(Editor* editor,
   os::Surface* gfx = theme->parts.transformationHandle()->bitmap(0);
   double angle = transform.angle();
 
-  auto corners = transform.transformedCorners();
-
-  std::vector<gfx::Point> screenPoints;
-  getScreenPoints(editor, corners, screenPoints);
+  updateScreenGeometry(editor, transform);
 
   int handle_rs[2] = { gfx->width() * 2, gfx->width() * 3 };
   for (int i = 0; i < 2; ++i) {
     int handle_r = handle_rs[i];
     for (size_t c = 0; c < HANDLES; ++c) {
-      if (inHandle(pt,
-                   (screenPoints[handles_info[c].i1].x + screenPoints[handles_info[c].i2].x) / 2,
-                   (screenPoints[handles_info[c].i1].y + screenPoints[handles_info[c].i2].y) / 2,
-                   handle_r,
-                   handle_r,
-                   angle + handles_info[c].angle)) {
+      if (inHandle(
+            pt,
+            (m_screenPoints[handles_info[c].i1].x + m_screenPoints[handles_info[c].i2].x) / 2,
+            (m_screenPoints[handles_info[c].i1].y + m_screenPoints[handles_info[c].i2].y) / 2,
+            handle_r,
+            handle_r,
+            angle + handles_info[c].angle)) {
         return handles_info[c].handle[i];
       }
     }
   }
 
   // Check if the cursor is in the pivot
-  if (visiblePivot(angle) && getPivotHandleBounds(editor, transform, corners).contains(pt))
+  if (visiblePivot(angle) && getPivotHandleBounds(editor, transform, m_corners).contains(pt))
     return PivotHandle;
 
   return NoHandle;
@@ -93,10 +91,7 @@ void TransformHandles::drawHandles(Editor* editor, ui::Graphics* g, const Transf
 {
   double angle = transform.angle();
 
-  auto corners = transform.transformedCorners();
-
-  std::vector<gfx::Point> screenPoints;
-  getScreenPoints(editor, corners, screenPoints);
+  updateScreenGeometry(editor, transform);
 
   const gfx::Point origin = editor->bounds().origin();
 
@@ -114,10 +109,10 @@ void TransformHandles::drawHandles(Editor* editor, ui::Graphics* g, const Transf
     g->drawRect(gfx::rgba(255, 0, 0), gfx::Rect(a.x-2, a.y-2, 5, 5));
   }
   {   // Rotated bounds
-    const gfx::Point& a = screenPoints[0] - origin;
-    const gfx::Point& b = screenPoints[1] - origin;
-    const gfx::Point& c = screenPoints[2] - origin;
-    const gfx::Point& d = screenPoints[3] - origin;
+    const gfx::Point& a = m_screenPoints[0] - origin;
+    const gfx::Point& b = m_screenPoints[1] - origin;
+    const gfx::Point& c = m_screenPoints[2] - origin;
+    const gfx::Point& d = m_screenPoints[3] - origin;
 
     ui::Paint paint;
     paint.style(ui::Paint::Stroke);
@@ -142,8 +137,10 @@ void TransformHandles::drawHandles(Editor* editor, ui::Graphics* g, const Transf
     for (int i=0; i<2; ++i) {
       int handle_r = handle_rs[i];
       for (size_t c=0; c<HANDLES; ++c) {
-        int x = (screenPoints[handles_info[c].i1].x+screenPoints[handles_info[c].i2].x)/2 - origin.x;
-        int y = (screenPoints[handles_info[c].i1].y+screenPoints[handles_info[c].i2].y)/2 - origin.y;
+        int x = (m_screenPoints[handles_info[c].i1].x+m_screenPoints[handles_info[c].i2].x)/2
+              - origin.x;
+        int y = (m_screenPoints[handles_info[c].i1].y+m_screenPoints[handles_info[c].i2].y)/2
+              - origin.y;
         adjustHandle(x, y, handle_r, handle_r, angle + handles_info[c].angle);
         g->drawRect(
           gfx::rgba(255, 0, 0),
@@ -158,14 +155,14 @@ void TransformHandles::drawHandles(Editor* editor, ui::Graphics* g, const Transf
     drawHandle(
       editor,
       g,
-      (screenPoints[handles_info[c].i1].x + screenPoints[handles_info[c].i2].x) / 2 - origin.x,
-      (screenPoints[handles_info[c].i1].y + screenPoints[handles_info[c].i2].y) / 2 - origin.y,
+      (m_screenPoints[handles_info[c].i1].x + m_screenPoints[handles_info[c].i2].x) / 2 - origin.x,
+      (m_screenPoints[handles_info[c].i1].y + m_screenPoints[handles_info[c].i2].y) / 2 - origin.y,
       angle + handles_info[c].angle);
   }
 
   // Draw the pivot
   if (visiblePivot(angle)) {
-    gfx::Rect pivotBounds = getPivotHandleBounds(editor, transform, corners);
+    gfx::Rect pivotBounds = getPivotHandleBounds(editor, transform, m_corners);
     auto theme = SkinTheme::get(editor);
     os::Surface* part = theme->parts.pivotHandle()->bitmap(0);
 
@@ -175,32 +172,58 @@ void TransformHandles::drawHandles(Editor* editor, ui::Graphics* g, const Transf
 
 void TransformHandles::invalidateHandles(Editor* editor, const Transformation& transform)
 {
-  auto theme = SkinTheme::get(editor);
-  double angle = transform.angle();
+  // Invalidate the handles at the last position where they were drawn
+  // (so they are erased) and at their new position, instead of the
+  // whole editor canvas.
+  gfx::Region region;
+  if (m_cacheValid)
+    getHandlesRegion(editor, region);
+  updateScreenGeometry(editor, transform);
+  getHandlesRegion(editor, region);
+
+  editor->invalidateRegion(region);
+}
 
-  auto corners = transform.transformedCorners();
+void TransformHandles::updateScreenGeometry(Editor* editor, const Transformation& transform)
+{
+  const gfx::PointF origin = editor->editorToScreenF(gfx::PointF(0.0, 0.0));
+  const gfx::PointF unit = editor->editorToScreenF(gfx::PointF(1.0, 1.0));
+  const gfx::Point mainTile = editor->mainTilePosition();
+
+  if (m_cacheValid && transform == m_cachedTransform && origin == m_cachedOrigin &&
+      unit == m_cachedUnit && mainTile == m_cachedMainTile) {
+    return;
+  }
 
-  std::vector<gfx::Point> screenPoints;
-  getScreenPoints(editor, corners, screenPoints);
+  m_cachedTransform = transform;
+  m_cachedOrigin = origin;
+  m_cachedUnit = unit;
+  m_cachedMainTile = mainTile;
+  m_corners = transform.transformedCorners();
+  getScreenPoints(editor, m_corners, m_screenPoints);
+  m_cacheValid = true;
+}
+
+void TransformHandles::getHandlesRegion(Editor* editor, gfx::Region& region)
+{
+  auto theme = SkinTheme::get(editor);
+  os::Surface* part = theme->parts.transformationHandle()->bitmap(0);
+  const double angle = m_cachedTransform.angle();
 
-  // Invalidate each corner handle.
   for (size_t c = 0; c < HANDLES; ++c) {
-    os::Surface* part = theme->parts.transformationHandle()->bitmap(0);
-    int u = (screenPoints[handles_info[c].i1].x + screenPoints[handles_info[c].i2].x) / 2;
-    int v = (screenPoints[handles_info[c].i1].y + screenPoints[handles_info[c].i2].y) / 2;
+    int u = (m_screenPoints[handles_info[c].i1].x + m_screenPoints[handles_info[c].i2].x) / 2;
+    int v = (m_screenPoints[handles_info[c].i1].y + m_screenPoints[handles_info[c].i2].y) / 2;
 
     adjustHandle(u, v, part->width(), part->height(), angle + handles_info[c].angle);
 
-    editor->invalidateRect(gfx::Rect(u, v, part->width(), part->height()));
+    region |= gfx::Region(gfx::Rect(u, v, part->width(), part->height()));
   }
 
-  // Invalidate area where the pivot is.
-  if (visiblePivot(angle)) {
-    gfx::Rect pivotBounds = getPivotHandleBounds(editor, transform, corners);
-    os::Surface* part = theme->parts.pivotHandle()->bitmap(0);
-
-    editor->invalidateRect(gfx::Rect(pivotBounds.x, pivotBounds.y, part->width(), part->height()));
-  }
+  // Include the pivot area even when it's not visible, so toggling
+  // its visibility erases/paints it with the same invalidation.
+  gfx::Rect pivotBounds = getPivotHandleBounds(editor, m_cachedTransform, m_corners);
+  part = theme->parts.pivotHandle()->bitmap(0);
+  region |= gfx::Region(gfx::Rect(pivotBounds.x, pivotBounds.y, part->width(), part->height()));
 }
 
 gfx::Rect TransformHandles::getPivotHandleBounds(Editor* editor,
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2022  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -12,6 +12,7 @@
 #include "app/transformation.h"
 #include "app/ui/editor/handle_type.h"
 #include "gfx/point.h"
+#include "gfx/region.h"
 
 #include <vector>
 
@@ -36,6 +37,18 @@ public:
   void invalidateHandles(Editor* editor, const Transformation& transform);
 
 private:
+  // Recomputes the cached corners/screen points for the given
+  // transformation only if something changed since the last call (the
+  // transformation itself, or the zoom/scroll of the editor).
+  // Hit-testing and drawing happen on every mouse motion over the
+  // selection, so reusing the cached geometry avoids transforming the
+  // four corners to screen coordinates on each event.
+  void updateScreenGeometry(Editor* editor, const Transformation& transform);
+
+  // Appends the screen rects covered by the handles and the pivot to
+  // the given region using the cached geometry.
+  void getHandlesRegion(Editor* editor, gfx::Region& region);
+
   gfx::Rect getPivotHandleBounds(Editor* editor,
                                  const Transformation& transform,
                                  const Transformation::Corners& corners);
@@ -47,6 +60,18 @@ private:
   void getScreenPoints(Editor* editor,
                        const Transformation::Corners& corners,
                        std::vector<gfx::Point>& screenPoints) const;
+
+  // Cached geometry (see updateScreenGeometry()). The two reference
+  // points are editorToScreenF(0,0) and editorToScreenF(1,1): the
+  // editor -> screen mapping is affine, so they change if (and only
+  // if) the scroll, the zoom, or the pixel ratio changes.
+  Transformation m_cachedTransform;
+  gfx::PointF m_cachedOrigin;
+  gfx::PointF m_cachedUnit;
+  gfx::Point m_cachedMainTile;
+  Transformation::Corners m_corners;
+  std::vector<gfx::Point> m_screenPoints;
+  bool m_cacheValid = false;
 };
 
 } // namespace app
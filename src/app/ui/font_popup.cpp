@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2025  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -53,6 +53,7 @@
 
 #include <algorithm>
 #include <map>
+#include <vector>
 
 namespace app {
 
@@ -74,6 +75,7 @@ static std::map<std::string, ThumbnailInfo> g_thumbnails;
 class FontItem : public ListItem {
 public:
   struct ByName {};
+  struct SystemByName {};
 
   explicit FontItem(const FontInfo& fontInfo)
     : ListItem(fontInfo.humanString())
@@ -104,6 +106,21 @@ public:
     getCachedThumbnail();
   }
 
+  // Placeholder for a system font known only by its family name
+  // (from the cached index of a previous run): the typeface is
+  // resolved lazily through FontMgr::matchFamily() when the item is
+  // painted/selected.
+  FontItem(const std::string& name, SystemByName)
+    : ListItem(name)
+    , m_fontInfo(FontInfo::Type::System,
+                 name,
+                 FontInfo::kDefaultSize,
+                 text::FontStyle(),
+                 FontInfo::Flags::Antialias)
+  {
+    getCachedThumbnail();
+  }
+
   FontItem(const std::string& name, const text::FontStyle& style, const text::FontStyleSetRef& set)
     : ListItem(name)
     , m_fontInfo(FontInfo::Type::System,
@@ -319,6 +336,16 @@ FontPopup::FontPopup(const FontInfo& fontInfo)
   m_systemFontsSeparator = new SeparatorInView(Strings::font_popup_system_fonts());
   m_listBox.addChild(m_systemFontsSeparator);
 
+  // Fill the system fonts section instantly with the family names
+  // cached from a previous run: listSystemFonts() enumerates the
+  // real list in the background (the first enumeration can take
+  // seconds with thousands of installed fonts) and replaces these
+  // placeholders as it goes.
+  for (const std::string& name : fonts->cachedSystemFamilies()) {
+    m_listBox.addChild(new FontItem(name, FontItem::SystemByName()));
+    m_hasCachedSystemFonts = true;
+  }
+
   m_listFontsTask.run([this](base::task_token& token) { listSystemFonts(token); });
 }
 
@@ -459,6 +486,10 @@ void FontPopup::listSystemFonts(base::task_token& token)
   Fonts* fonts = Fonts::instance();
   bool empty = true;
 
+  // Family names found by this enumeration, cached for the next run
+  // (see Fonts::cachedSystemFamilies()).
+  std::vector<std::string> freshFamilies;
+
   // Get system fonts from laf-text module
   const text::FontMgrRef fontMgr = fonts->fontMgr();
   const int n = fontMgr->countFamilies();
@@ -471,6 +502,7 @@ void FontPopup::listSystemFonts(base::task_token& token)
         // weight, Upright slant, etc.)
         auto typeface = set->matchStyle(text::FontStyle());
         if (typeface) {
+          freshFamilies.push_back(name);
           ui::execute_from_ui_thread([=, &token] {
             if (token.canceled())
               return;
@@ -480,7 +512,14 @@ void FontPopup::listSystemFonts(base::task_token& token)
 
             int j = m_listBox.getChildIndex(m_systemFontsSeparator) + 1;
             for (; j < m_listBox.getItemsCount(); ++j) {
-              if (name < m_listBox.at(j)->text())
+              const std::string& itemText = m_listBox.at(j)->text();
+              if (name == itemText) {
+                // Replace the placeholder created from the cached
+                // family index with the fully resolved item.
+                delete m_listBox.at(j);
+                break;
+              }
+              if (name < itemText)
                 break;
             }
             m_listBox.insertChild(j, item);
@@ -535,7 +574,12 @@ done:;
   if (token.canceled())
     return;
 
-  if (empty) {
+  if (!freshFamilies.empty()) {
+    std::sort(freshFamilies.begin(), freshFamilies.end());
+    fonts->saveSystemFamiliesCache(freshFamilies);
+  }
+
+  if (empty && !m_hasCachedSystemFonts) {
     ui::execute_from_ui_thread([this, &token] {
       if (token.canceled())
         return;
@@ -545,10 +589,28 @@ done:;
     });
   }
 
-  ui::execute_from_ui_thread([this, &token] {
+  ui::execute_from_ui_thread([this, &token, freshFamilies] {
     if (token.canceled())
       return;
 
+    // Remove placeholders of cached families that don't exist
+    // anymore (uninstalled fonts): they were not replaced by the
+    // enumeration above.
+    if (m_hasCachedSystemFonts && !freshFamilies.empty()) {
+      int j = m_listBox.getChildIndex(m_systemFontsSeparator) + 1;
+      while (j < m_listBox.getItemsCount()) {
+        Widget* child = m_listBox.at(j);
+        if (dynamic_cast<FontItem*>(child) &&
+            !std::binary_search(freshFamilies.begin(), freshFamilies.end(), child->text())) {
+          delete child;
+        }
+        else {
+          ++j;
+        }
+      }
+      layout();
+    }
+
     // Stop the view relayout
     onTickRelayout();
     m_timer.stop();
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2021-2025  Igara Studio S.A.
+// Copyright (C) 2021-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -66,6 +66,10 @@ private:
   ui::Timer m_timer;
   ui::Widget* m_pinnedSeparator = nullptr;
   app::Task m_listFontsTask;
+
+  // True if the system fonts section was pre-filled with the family
+  // names cached from a previous run (see Fonts::cachedSystemFamilies()).
+  bool m_hasCachedSystemFonts = false;
 };
 
 } // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -295,6 +295,17 @@ namespace app {
 
 using namespace ui;
 
+// Increased each time the shortcuts of any Key change (see
+// Key::globalVersion()). Starts at 1 so callers can use 0 as an
+// always-stale value.
+static int g_keysVersion = 1;
+
+// static
+int Key::globalVersion()
+{
+  return g_keysVersion;
+}
+
 bool AppShortcut::fitsBetterThan(const KeyContext currentContext,
                                  const KeyContext thisShortcutContext,
                                  const KeyContext otherShortcutContext,
@@ -454,6 +465,7 @@ void Key::add(const ui::Shortcut& shortcut, const KeySource source, KeyboardShor
 {
   m_adds.push_back(AppShortcut(source, shortcut));
   m_shortcuts.reset();
+  ++g_keysVersion;
 
   // Remove the shortcut from other commands
   if (source == KeySource::ExtensionDefined || source == KeySource::UserDefined) {
@@ -567,6 +579,7 @@ void Key::disableShortcut(const ui::Shortcut& shortcut, const KeySource source)
 
   m_dels.push_back(AppShortcut(source, shortcut));
   m_shortcuts.reset();
+  ++g_keysVersion;
 }
 
 void Key::reset()
@@ -574,6 +587,7 @@ void Key::reset()
   erase_shortcuts(m_adds, KeySource::UserDefined);
   erase_shortcuts(m_dels, KeySource::UserDefined);
   m_shortcuts.reset();
+  ++g_keysVersion;
 }
 
 void Key::copyOriginalToUser()
@@ -587,6 +601,7 @@ void Key::copyOriginalToUser()
   for (const auto& kv : copy)
     m_adds.push_back(AppShortcut(KeySource::UserDefined, kv));
   m_shortcuts.reset();
+  ++g_keysVersion;
 }
 
 std::string Key::triggerString() const
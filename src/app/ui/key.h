@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -141,6 +141,11 @@ using DragVector = base::Vector2d<double>;
 // tool, or specific action.
 class Key {
 public:
+  // Increased each time the shortcuts of any Key change, so caches
+  // built over them (like the dispatch index in KeyboardShortcuts)
+  // know when they are stale.
+  static int globalVersion();
+
   Key(const Key& key);
   Key(Command* command, const Params& params, const KeyContext keyContext);
   Key(const KeyType type, tools::Tool* tool);
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -109,12 +109,14 @@ void KeyboardShortcuts::setKeys(const KeyboardShortcuts& keys, const bool cloneK
   else {
     m_keys = keys.m_keys;
   }
+  invalidateIndex();
   UserChange();
 }
 
 void KeyboardShortcuts::clear()
 {
   m_keys.clear();
+  invalidateIndex();
 }
 
 void KeyboardShortcuts::importFile(XMLElement* rootElement, KeySource source)
@@ -576,6 +578,18 @@ KeyContext KeyboardShortcuts::getCurrentKeyContext()
   return KeyContext::Normal;
 }
 
+void KeyboardShortcuts::rebuildIndex() const
+{
+  m_index.clear();
+  int pos = 0;
+  for (const KeyPtr& key : m_keys) {
+    for (const AppShortcut& shortcut : key->shortcuts())
+      m_index[shortcut.toString()].push_back(std::make_pair(pos, key));
+    ++pos;
+  }
+  m_indexVersion = Key::globalVersion();
+}
+
 KeyPtr KeyboardShortcuts::findBestKeyFromMessage(const ui::Message* msg,
                                                  KeyContext currentKeyContext,
                                                  std::optional<KeyType> filterByType) const
@@ -584,11 +598,48 @@ KeyPtr KeyboardShortcuts::findBestKeyFromMessage(const ui::Message* msg,
   int n = (contexts[0] != contexts[1] ? 2 : 1);
   KeyPtr bestKey = nullptr;
   const AppShortcut* bestShortcut = nullptr;
+
+  // For key messages we can use the index to check only the keys that
+  // contain a matching shortcut, instead of testing each shortcut of
+  // each binding (which builds two normalized strings per comparison,
+  // see ui::Shortcut::operator==). Mouse messages (wheel/drag
+  // customizations) keep the linear scan below.
+  std::vector<std::pair<int, KeyPtr>> candidates;
+  const auto* keyMsg = dynamic_cast<const KeyMessage*>(msg);
+  if (keyMsg) {
+    if (m_indexVersion != Key::globalVersion())
+      rebuildIndex();
+
+    // A shortcut matches a key message by its scancode or by its
+    // unicode char, i.e. with one of these two normalized strings
+    // (the same comparison done in ui::Shortcut::isPressed()).
+    auto collect = [this, &candidates](const Shortcut& pressed) {
+      auto it = m_index.find(pressed.toString());
+      if (it != m_index.end())
+        candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    };
+    if (keyMsg->scancode())
+      collect(Shortcut(keyMsg->modifiers(), keyMsg->scancode(), 0));
+    if (keyMsg->unicodeChar())
+      collect(Shortcut(keyMsg->modifiers(), kKeyNil, keyMsg->unicodeChar()));
+
+    // Keep the m_keys scan order (ties between equally-fitting
+    // shortcuts are resolved by the first one found) and remove keys
+    // matched by both strings.
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+      return a.first < b.first;
+    });
+    candidates.erase(std::unique(candidates.begin(),
+                                 candidates.end(),
+                                 [](const auto& a, const auto& b) { return a.first == b.first; }),
+                     candidates.end());
+  }
+
   for (int i = 0; i < n; ++i) {
-    for (const KeyPtr& key : m_keys) {
+    auto checkKey = [&](const KeyPtr& key) {
       // Skip keys that are not for the specific KeyType (e.g. only for commands).
       if (filterByType.has_value() && key->type() != *filterByType)
-        continue;
+        return;
 
       const AppShortcut* shortcut = key->isPressed(msg, contexts[i]);
       if (shortcut && (!bestKey || shortcut->fitsBetterThan(currentKeyContext,
@@ -598,6 +649,15 @@ KeyPtr KeyboardShortcuts::findBestKeyFromMessage(const ui::Message* msg,
         bestKey = key;
         bestShortcut = shortcut;
       }
+    };
+
+    if (keyMsg) {
+      for (const auto& candidate : candidates)
+        checkKey(candidate.second);
+    }
+    else {
+      for (const KeyPtr& key : m_keys)
+        checkKey(key);
     }
   }
   return bestKey;
@@ -703,6 +763,7 @@ void KeyboardShortcuts::clearMouseWheelKeys()
     else
       ++it;
   }
+  invalidateIndex();
 }
 
 void KeyboardShortcuts::addMissingMouseWheelKeys()
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2025  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -13,6 +13,10 @@
 #include "obs/signal.h"
 
 #include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace tinyxml2 {
 class XMLElement;
@@ -95,7 +99,19 @@ private:
                              const ui::Shortcut& shortcut,
                              bool removed);
 
+  void rebuildIndex() const;
+  void invalidateIndex() { m_indexVersion = 0; }
+
   mutable Keys m_keys;
+
+  // Index to dispatch key messages without scanning all the bindings:
+  // maps the normalized string of each shortcut (the representation
+  // that ui::Shortcut uses to compare shortcuts) to the keys that
+  // contain it, paired with their position in m_keys to keep the scan
+  // order. Rebuilt lazily when any Key changes (Key::globalVersion())
+  // or when m_keys membership changes (invalidateIndex()).
+  mutable std::unordered_map<std::string, std::vector<std::pair<int, KeyPtr>>> m_index;
+  mutable int m_indexVersion = 0; // 0 = always stale
 };
 
 inline std::string key_tooltip(const char* str,
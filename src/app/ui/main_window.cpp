@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -31,6 +31,7 @@
 #include "app/ui/layout_selector.h"
 #include "app/ui/main_menu_bar.h"
 #include "app/ui/notifications.h"
+#include "app/ui/navigator_window.h"
 #include "app/ui/preview_editor.h"
 #include "app/ui/skin/skin_property.h"
 #include "app/ui/skin/skin_theme.h"
@@ -134,6 +135,7 @@ void MainWindow::initialize()
   m_tabsBar = std::make_unique<WorkspaceTabs>(this);
   m_workspace = std::make_unique<Workspace>();
   m_previewEditor = std::make_unique<PreviewEditorWindow>();
+  m_navigator = std::make_unique<NavigatorWindow>();
   m_colorBar = std::make_unique<ColorBar>(m_tooltipManager);
   m_contextBar = std::make_unique<ContextBar>(m_tooltipManager, m_colorBar.get());
 
@@ -236,6 +238,7 @@ MainWindow::~MainWindow()
     m_homeView.reset();
   }
   m_contextBar.reset();
+  m_navigator.reset();
   m_previewEditor.reset();
 
   // Destroy the workspace first so ~Editor can dettach slots from
@@ -505,6 +508,8 @@ void MainWindow::onInitTheme(ui::InitThemeEvent& ev)
   noBorderNoChildSpacing();
   if (m_previewEditor)
     m_previewEditor->initTheme();
+  if (m_navigator)
+    m_navigator->initTheme();
 
   auto* theme = static_cast<skin::SkinTheme*>(this->theme());
   m_dock->setBgColor(theme->colors.windowFace());
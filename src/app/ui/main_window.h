@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -37,6 +37,7 @@ class INotificationDelegate;
 class Layout;
 class LayoutSelector;
 class MainMenuBar;
+class NavigatorWindow;
 class Notifications;
 class PreviewEditorWindow;
 class StatusBar;
@@ -68,6 +69,7 @@ public:
   ColorBar* colorBar() { return m_colorBar.get(); }
   ToolBar* toolBar() { return m_toolBar.get(); }
   PreviewEditorWindow* getPreviewEditor() { return m_previewEditor.get(); }
+  NavigatorWindow* getNavigator() { return m_navigator.get(); }
 #ifdef ENABLE_UPDATER
   CheckUpdateDelegate* getCheckUpdateDelegate();
 #endif
@@ -155,6 +157,7 @@ private:
   std::unique_ptr<Timeline> m_timeline;
   std::unique_ptr<Workspace> m_workspace;
   std::unique_ptr<PreviewEditorWindow> m_previewEditor;
+  std::unique_ptr<NavigatorWindow> m_navigator;
   std::unique_ptr<HomeView> m_homeView;
   std::unique_ptr<INotificationDelegate> m_scalePanic;
   std::unique_ptr<BrowserView> m_browserView;
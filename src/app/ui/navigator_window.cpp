@@ -0,0 +1,397 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/ui/navigator_window.h"
+
+#include "app/doc.h"
+#include "app/doc_event.h"
+#include "app/i18n/strings.h"
+#include "app/ini_file.h"
+#include "app/modules/gui.h"
+#include "app/pref/preferences.h"
+#include "app/ui/editor/editor.h"
+#include "app/ui/skin/skin_theme.h"
+#include "app/util/conversion_to_surface.h"
+#include "doc/image.h"
+#include "doc/sprite.h"
+#include "gfx/clip.h"
+#include "os/surface.h"
+#include "os/system.h"
+#include "render/mipmap_pyramid.h"
+#include "render/render.h"
+#include "ui/close_event.h"
+#include "ui/graphics.h"
+#include "ui/message.h"
+#include "ui/paint_event.h"
+#include "ui/size_hint_event.h"
+#include "ui/system.h"
+
+#include <algorithm>
+
+namespace app {
+
+using namespace app::skin;
+using namespace ui;
+
+// Widget that paints the reduced composite and the viewport
+// rectangle, and converts clicks/drags into editor scroll changes.
+class NavigatorWindow::NavigatorView : public ui::Widget {
+public:
+  NavigatorView()
+  {
+    setDoubleBuffered(true);
+  }
+
+  void setEditor(Editor* editor)
+  {
+    m_editor = editor;
+    m_composite.reset();
+    m_surface.reset();
+    invalidate();
+  }
+
+  void dirtyAll()
+  {
+    if (m_composite)
+      m_dirty = gfx::Region(m_composite->bounds());
+    invalidate();
+  }
+
+  void dirtyRegion(const gfx::Region& spriteRgn)
+  {
+    if (m_composite) {
+      for (const gfx::Rect& r : spriteRgn) {
+        // +2 covers the rounding of both edges when scaling down.
+        gfx::Rect r2(r.x >> m_level, r.y >> m_level, (r.w >> m_level) + 2, (r.h >> m_level) + 2);
+        r2 &= m_composite->bounds();
+        if (!r2.isEmpty())
+          m_dirty |= gfx::Region(r2);
+      }
+    }
+    invalidate();
+  }
+
+protected:
+  void onSizeHint(SizeHintEvent& ev) override
+  {
+    ev.setSizeHint(gfx::Size(128, 128) * guiscale());
+  }
+
+  void onPaint(PaintEvent& ev) override
+  {
+    Graphics* g = ev.graphics();
+    auto theme = SkinTheme::get(this);
+    const gfx::Rect rc = clientBounds();
+    g->fillRect(theme->colors.editorFace(), rc);
+
+    if (!m_editor || !m_editor->sprite() || rc.isEmpty())
+      return;
+
+    const doc::Sprite* sprite = m_editor->sprite();
+    updateComposite(sprite, rc);
+
+    const gfx::Rect dst = previewBounds(rc, sprite);
+    g->drawSurface(m_surface.get(), m_surface->bounds(), dst, os::Sampling(), nullptr);
+
+    // Viewport of the related editor
+    gfx::Rect vis = m_editor->getVisibleSpriteBounds();
+    vis &= sprite->bounds();
+    if (!vis.isEmpty()) {
+      gfx::Rect vp(dst.x + vis.x * dst.w / sprite->width(),
+                   dst.y + vis.y * dst.h / sprite->height(),
+                   std::max(2, vis.w * dst.w / sprite->width()),
+                   std::max(2, vis.h * dst.h / sprite->height()));
+      gfx::Rect outer = vp;
+      g->drawRect(gfx::rgba(0, 0, 0), outer.enlarge(1));
+      g->drawRect(gfx::rgba(255, 255, 255), vp);
+    }
+  }
+
+  bool onProcessMessage(Message* msg) override
+  {
+    switch (msg->type()) {
+      case kSetCursorMessage: ui::set_mouse_cursor(kArrowCursor); return true;
+
+      case kMouseDownMessage:
+        if (m_editor && m_editor->sprite()) {
+          captureMouse();
+          scrollEditorTo(static_cast<MouseMessage*>(msg)->position());
+          return true;
+        }
+        break;
+
+      case kMouseMoveMessage:
+        if (hasCapture()) {
+          scrollEditorTo(static_cast<MouseMessage*>(msg)->position());
+          return true;
+        }
+        break;
+
+      case kMouseUpMessage:
+        if (hasCapture()) {
+          releaseMouse();
+          return true;
+        }
+        break;
+    }
+    return Widget::onProcessMessage(msg);
+  }
+
+private:
+  // Area of the widget covered by the sprite overview (centered,
+  // preserving the sprite aspect ratio).
+  gfx::Rect previewBounds(const gfx::Rect& rc, const doc::Sprite* sprite) const
+  {
+    const double fit = std::min(double(rc.w) / sprite->width(), double(rc.h) / sprite->height());
+    const int w = std::max(1, int(sprite->width() * fit));
+    const int h = std::max(1, int(sprite->height() * fit));
+    return gfx::Rect(rc.x + rc.w / 2 - w / 2, rc.y + rc.h / 2 - h / 2, w, h);
+  }
+
+  // Rebuilds only the out-of-date areas of the reduced composite
+  // (the whole image when the sprite/level changed).
+  void updateComposite(const doc::Sprite* sprite, const gfx::Rect& rc)
+  {
+    const double fit = std::min(double(rc.w) / sprite->width(), double(rc.h) / sprite->height());
+    const int level = std::clamp(render::MipmapPyramid::levelForScale(fit),
+                                 0,
+                                 render::MipmapPyramid::kMaxLevel);
+    const int cw = std::max(1, (sprite->width() + (1 << level) - 1) >> level);
+    const int ch = std::max(1, (sprite->height() + (1 << level) - 1) >> level);
+
+    if (!m_composite || m_composite->width() != cw || m_composite->height() != ch ||
+        m_level != level) {
+      m_composite.reset(doc::Image::create(doc::IMAGE_RGB, cw, ch));
+      m_level = level;
+      m_dirty = gfx::Region(m_composite->bounds());
+      m_renderKey = 0;
+    }
+
+    if (!m_dirty.isEmpty()) {
+      // Most doc events just call dirtyAll() conservatively, so
+      // before re-rendering we compare the frame render key: equal
+      // keys mean the composited output didn't change and the current
+      // composite is still valid (a real pixel/layer/cel change bumps
+      // some object version and produces a different key).
+      const uint64_t renderKey = sprite->renderVersionKey(m_editor->frame());
+      if (renderKey == m_renderKey) {
+        m_dirty.clear();
+      }
+      else {
+        m_renderKey = renderKey;
+      }
+    }
+
+    if (!m_dirty.isEmpty()) {
+      auto& pref = Preferences::instance();
+      render::Render render;
+      render.setRefLayersVisiblity(true);
+      render.setNewBlend(pref.experimental.newBlend());
+      render.setComposeGroups(pref.experimental.composeGroups());
+      render.setBgOptions(render::BgOptions::MakeNone());
+      render.setProjection(render::Projection(sprite->pixelRatio(), render::Zoom(1, 1 << level)));
+      for (const gfx::Rect& r : m_dirty) {
+        render.renderSprite(m_composite.get(),
+                            sprite,
+                            m_editor->frame(),
+                            gfx::ClipF(r.x, r.y, r.x, r.y, r.w, r.h));
+      }
+      m_dirty.clear();
+      m_surfaceDirty = true;
+    }
+
+    if (!m_surface || m_surface->width() != cw || m_surface->height() != ch) {
+      m_surface = os::System::instance()->makeRgbaSurface(cw, ch);
+      m_surfaceDirty = true;
+    }
+    if (m_surfaceDirty) {
+      convert_image_to_surface(m_composite.get(), nullptr, m_surface.get(), 0, 0, 0, 0, cw, ch);
+      m_surfaceDirty = false;
+    }
+  }
+
+  void scrollEditorTo(const gfx::Point& screenPos)
+  {
+    const doc::Sprite* sprite = m_editor->sprite();
+    const gfx::Rect rc = clientBounds();
+    const gfx::Rect dst = previewBounds(rc, sprite);
+    const gfx::Point pos = screenPos - bounds().origin();
+    m_editor->centerInSpritePoint(
+      gfx::Point(std::clamp((pos.x - dst.x) * sprite->width() / std::max(1, dst.w),
+                            0,
+                            sprite->width() - 1),
+                 std::clamp((pos.y - dst.y) * sprite->height() / std::max(1, dst.h),
+                            0,
+                            sprite->height() - 1)));
+  }
+
+  Editor* m_editor = nullptr;
+  doc::ImageRef m_composite;
+  os::SurfaceRef m_surface;
+  int m_level = 0;
+  uint64_t m_renderKey = 0;
+  gfx::Region m_dirty;
+  bool m_surfaceDirty = true;
+};
+
+NavigatorWindow::NavigatorWindow()
+  : Window(WithTitleBar, Strings::navigator_title())
+  , m_isEnabled(get_config_bool("Navigator", "Enabled", false))
+  , m_editor(nullptr)
+  , m_view(new NavigatorView)
+{
+  setAutoRemap(false);
+  setWantFocus(false);
+
+  m_view->setExpansive(true);
+  addChild(m_view);
+
+  initTheme();
+}
+
+NavigatorWindow::~NavigatorWindow()
+{
+  set_config_bool("Navigator", "Enabled", m_isEnabled);
+  detachEditor();
+}
+
+void NavigatorWindow::setNavigatorEnabled(bool state)
+{
+  m_isEnabled = state;
+
+  updateUsingEditor(Editor::activeEditor());
+}
+
+void NavigatorWindow::updateUsingEditor(Editor* editor)
+{
+  if (!m_isEnabled || !editor) {
+    detachEditor();
+    if (isVisible())
+      closeWindow(nullptr);
+    return;
+  }
+
+  if (!editor->isActive())
+    return;
+
+  if (m_editor != editor) {
+    detachEditor();
+    attachEditor(editor);
+  }
+
+  if (!isVisible()) {
+    remapWindow();
+    centerWindow();
+    load_window_pos(this, "Navigator");
+    openWindow();
+  }
+
+  m_view->dirtyAll();
+}
+
+void NavigatorWindow::onDestroyEditor(Editor* editor)
+{
+  if (editor == m_editor)
+    detachEditor();
+}
+
+void NavigatorWindow::onScrollChanged(Editor* editor)
+{
+  if (editor == m_editor)
+    m_view->invalidate();
+}
+
+void NavigatorWindow::onZoomChanged(Editor* editor)
+{
+  if (editor == m_editor)
+    m_view->invalidate();
+}
+
+void NavigatorWindow::onAfterFrameChanged(Editor* editor)
+{
+  if (editor == m_editor)
+    m_view->dirtyAll();
+}
+
+void NavigatorWindow::onCloseDocument(Doc* doc)
+{
+  detachEditor();
+}
+
+void NavigatorWindow::onGeneralUpdate(DocEvent& ev)
+{
+  m_view->dirtyAll();
+}
+
+void NavigatorWindow::onSpritePixelsModified(DocEvent& ev)
+{
+  m_view->dirtyRegion(ev.region());
+}
+
+void NavigatorWindow::onAddLayer(DocEvent& ev)
+{
+  m_view->dirtyAll();
+}
+
+void NavigatorWindow::onAfterRemoveLayer(DocEvent& ev)
+{
+  m_view->dirtyAll();
+}
+
+void NavigatorWindow::onAddCel(DocEvent& ev)
+{
+  m_view->dirtyAll();
+}
+
+void NavigatorWindow::onAfterRemoveCel(DocEvent& ev)
+{
+  m_view->dirtyAll();
+}
+
+void NavigatorWindow::onLayerRestacked(DocEvent& ev)
+{
+  m_view->dirtyAll();
+}
+
+void NavigatorWindow::onSpriteSizeChanged(DocEvent& ev)
+{
+  m_view->dirtyAll();
+}
+
+void NavigatorWindow::onClose(ui::CloseEvent& ev)
+{
+  save_window_pos(this, "Navigator");
+
+  // Closing the window from its close button disables the navigator
+  // (like the preview editor does).
+  m_isEnabled = false;
+  detachEditor();
+}
+
+void NavigatorWindow::attachEditor(Editor* editor)
+{
+  m_editor = editor;
+  m_editor->add_observer(this);
+  m_editor->document()->add_observer(this);
+  m_view->setEditor(editor);
+}
+
+void NavigatorWindow::detachEditor()
+{
+  if (!m_editor)
+    return;
+
+  m_editor->document()->remove_observer(this);
+  m_editor->remove_observer(this);
+  m_editor = nullptr;
+  m_view->setEditor(nullptr);
+}
+
+} // namespace app
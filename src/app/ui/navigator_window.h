@@ -0,0 +1,74 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_UI_NAVIGATOR_WINDOW_H_INCLUDED
+#define APP_UI_NAVIGATOR_WINDOW_H_INCLUDED
+#pragma once
+
+#include "app/doc_observer.h"
+#include "app/ui/editor/editor_observer.h"
+#include "ui/window.h"
+
+namespace app {
+class Doc;
+class Editor;
+
+// Floating overview of the active sprite (View > Navigator): it
+// shows a power-of-two reduction of the composited canvas with the
+// viewport of the related editor drawn on top, and dragging inside
+// the panel scrolls that editor.
+//
+// The reduction is composited at mipmap granularity (see
+// render::MipmapPyramid::levelForScale()) and maintained
+// incrementally: document changes only re-render their dirty
+// rectangles scaled down, so panning/editing a huge canvas never
+// pays a second full-resolution render for the overview.
+class NavigatorWindow : public ui::Window,
+                        public EditorObserver,
+                        public DocObserver {
+public:
+  NavigatorWindow();
+  ~NavigatorWindow();
+
+  bool isNavigatorEnabled() const { return m_isEnabled; }
+  void setNavigatorEnabled(bool state);
+
+  void updateUsingEditor(Editor* editor);
+
+  // EditorObserver impl
+  void onDestroyEditor(Editor* editor) override;
+  void onScrollChanged(Editor* editor) override;
+  void onZoomChanged(Editor* editor) override;
+  void onAfterFrameChanged(Editor* editor) override;
+
+  // DocObserver impl
+  void onCloseDocument(Doc* doc) override;
+  void onGeneralUpdate(DocEvent& ev) override;
+  void onSpritePixelsModified(DocEvent& ev) override;
+  void onAddLayer(DocEvent& ev) override;
+  void onAfterRemoveLayer(DocEvent& ev) override;
+  void onAddCel(DocEvent& ev) override;
+  void onAfterRemoveCel(DocEvent& ev) override;
+  void onLayerRestacked(DocEvent& ev) override;
+  void onSpriteSizeChanged(DocEvent& ev) override;
+
+protected:
+  void onClose(ui::CloseEvent& ev) override;
+
+private:
+  class NavigatorView;
+
+  void attachEditor(Editor* editor);
+  void detachEditor();
+
+  bool m_isEnabled;
+  Editor* m_editor;
+  NavigatorView* m_view;
+};
+
+} // namespace app
+
+#endif
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -443,8 +443,7 @@ void SkinTheme::loadFontData()
   if (!rf.findFirst())
     throw base::Exception("File %s not found", fontsFilename.c_str());
 
-  XMLDocumentRef doc = open_xml(rf.filename());
-  XMLHandle handle(doc.get());
+  XMLHandle handle(open_xml_cached(rf.filename()));
 
   XMLElement* xmlFont = handle.FirstChildElement("fonts").FirstChildElement("font").ToElement();
   while (xmlFont) {
@@ -491,6 +490,9 @@ void SkinTheme::loadSheet()
   m_sheet = newSheet->applyScale(guiscale());
   m_sheet->setImmutable();
 
+  // Composed parts were blitted from the old sheet.
+  m_composedParts.clear();
+
   // Reset sprite sheet and font of all layer styles (to avoid
   // dangling pointers to os::Surface or text::Font).
   for (auto& it : m_styles) {
@@ -510,8 +512,7 @@ void SkinTheme::loadXml(BackwardCompatibility* backward)
   // Load the skin XML
   std::string xml_filename(base::join_path(m_path, "theme.xml"));
 
-  XMLDocumentRef doc = open_xml(xml_filename);
-  XMLHandle handle(doc.get());
+  XMLHandle handle(open_xml_cached(xml_filename));
 
   // Load Preferred scaling
   m_preferredScreenScaling = -1;
@@ -1048,8 +1049,17 @@ void SkinTheme::loadXml(BackwardCompatibility* backward)
           if (it != m_parts_by_id.end()) {
             SkinPartPtr part = it->second;
             if (part) {
-              if (layer.type() == ui::Style::Layer::Type::kIcon)
+              if (layer.type() == ui::Style::Layer::Type::kIcon) {
                 layer.setIcon(AddRef(part->bitmap(0)));
+                // Also give the layer the position of the icon inside
+                // the sheet, so it can be painted directly from the
+                // shared sheet texture (one texture bind for all the
+                // icons) instead of from the individual slice.
+                if (part->countBitmaps() == 1) {
+                  layer.setSpriteSheet(m_sheet);
+                  layer.setSpriteBounds(part->spriteBounds());
+                }
+              }
               else {
                 layer.setSpriteSheet(m_sheet);
                 layer.setSpriteBounds(part->spriteBounds());
@@ -1994,6 +2004,18 @@ void SkinTheme::drawRect(ui::Graphics* g,
                          SkinPart* skinPart,
                          const bool drawCenter)
 {
+  if (rc.isEmpty())
+    return;
+
+  // Compose the nine slices only the first time that this (part,
+  // size) pair is used, so repainting dozens of widgets with the
+  // same background (e.g. resizing the main window) is just one blit
+  // per widget.
+  if (os::Surface* composed = getComposedPart(skinPart, rc.size(), drawCenter)) {
+    g->drawRgbaSurface(composed, rc.x, rc.y);
+    return;
+  }
+
   Theme::drawSlices(g,
                     m_sheet.get(),
                     rc,
@@ -2003,6 +2025,47 @@ void SkinTheme::drawRect(ui::Graphics* g,
                     drawCenter);
 }
 
+os::Surface* SkinTheme::getComposedPart(const SkinPart* skinPart,
+                                        const gfx::Size& size,
+                                        const bool drawCenter)
+{
+  // Big backgrounds (whole panels/windows) change size on each
+  // resize step and would retain too much memory, compose those
+  // directly from the sheet.
+  if (size.w * size.h > 256 * 256 * guiscale() * guiscale())
+    return nullptr;
+
+  const auto key = std::make_tuple(skinPart, size.w, size.h, drawCenter);
+  auto it = m_composedParts.find(key);
+  if (it != m_composedParts.end())
+    return it->second.get();
+
+  os::SurfaceRef sur = os::System::instance()->makeRgbaSurface(size.w, size.h);
+  if (!sur)
+    return nullptr;
+
+  os::SurfaceLock lock(sur.get());
+
+  // Clear with transparent color (the part may not cover the center
+  // or can have transparent pixels).
+  os::Paint clear;
+  clear.color(gfx::rgba(0, 0, 0, 0));
+  clear.blendMode(os::BlendMode::Src);
+  sur->drawRect(gfx::Rect(size), clear);
+
+  os::Paint paint;
+  paint.color(gfx::ColorNone);
+  sur->drawSurfaceNine(m_sheet.get(),
+                       skinPart->spriteBounds(),
+                       skinPart->slicesBounds(),
+                       gfx::Rect(size),
+                       drawCenter,
+                       &paint);
+
+  m_composedParts[key] = sur;
+  return sur.get();
+}
+
 void SkinTheme::drawRectUsingUnscaledSheet(ui::Graphics* g,
                                            const gfx::Rect& rc,
                                            SkinPart* skinPart,
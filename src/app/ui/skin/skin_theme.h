@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2025  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -25,6 +25,7 @@
 #include <array>
 #include <map>
 #include <string>
+#include <tuple>
 
 namespace ui {
 class Entry;
@@ -189,6 +190,7 @@ private:
 
   os::SurfaceRef sliceSheet(os::SurfaceRef sur, const gfx::Rect& bounds);
   os::SurfaceRef sliceUnscaledSheet(os::SurfaceRef sur, const gfx::Rect& bounds);
+  os::Surface* getComposedPart(const SkinPart* skinPart, const gfx::Size& size, bool drawCenter);
   gfx::Color getWidgetBgColor(ui::Widget* widget);
   void drawText(ui::Graphics* g,
                 const char* t,
@@ -208,6 +210,10 @@ private:
   // Contains the sheet surface as is, without any scale.
   os::SurfaceRef m_unscaledSheet;
   std::map<std::string, SkinPartPtr> m_parts_by_id;
+  // Nine-slice parts already composed at a specific size, so
+  // repainting several widgets with the same background is just one
+  // blit per widget (cleared when the sheet is reloaded).
+  std::map<std::tuple<const SkinPart*, int, int, bool>, os::SurfaceRef> m_composedParts;
   // Stores the same SkinParts as m_parts_by_id but unscaled, using the same keys.
   std::map<std::string, SkinPartPtr> m_unscaledParts_by_id;
   std::map<std::string, gfx::Color> m_colors_by_id;
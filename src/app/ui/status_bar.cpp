@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -659,6 +659,8 @@ StatusBar* StatusBar::m_instance = NULL;
 
 StatusBar::StatusBar(TooltipManager* tooltipManager)
   : m_timeout(0)
+  , m_statusTextTimer(16) // ~1 tick per frame to coalesce setStatusText() calls
+  , m_hasPendingText(false)
   , m_about(new AboutStatusBar)
   , m_indicators(new Indicators)
   , m_docControls(new HBox)
@@ -667,6 +669,8 @@ StatusBar::StatusBar(TooltipManager* tooltipManager)
 {
   m_instance = this;
 
+  m_statusTextTimer.Tick.connect([this] { onStatusTextTimer(); });
+
   setDoubleBuffered(true);
   setFocusStop(true);
 
@@ -785,8 +789,14 @@ void StatusBar::showBackupIcon(BackupIcon icon)
 bool StatusBar::setStatusText(int msecs, const std::string& msg)
 {
   if ((base::current_tick() > m_timeout) || (msecs > 0)) {
-    showIndicators();
-    IndicatorsGeneration(m_indicators).add(msg.c_str());
+    // Just keep the text for the next timer tick: regenerating the
+    // indicators (parsing the text, looking up icons, relayout) for
+    // each call is wasteful when we can receive several per frame
+    // interleaved with the stroke handling.
+    m_pendingText = msg;
+    m_hasPendingText = true;
+    if (!m_statusTextTimer.isRunning())
+      m_statusTextTimer.start();
     m_timeout = base::current_tick() + msecs;
     return true;
   }
@@ -794,6 +804,35 @@ bool StatusBar::setStatusText(int msecs, const std::string& msg)
     return false;
 }
 
+void StatusBar::onStatusTextTimer()
+{
+  m_statusTextTimer.stop();
+  if (!m_hasPendingText)
+    return;
+
+  m_hasPendingText = false;
+  showIndicators();
+
+  // The generation re-uses the existing indicator widgets anyway, but
+  // we can skip it completely if the text that generated them didn't
+  // change (common when e.g. the mouse moves over the same pixel).
+  if (m_pendingText != m_lastText) {
+    m_lastText = m_pendingText;
+    IndicatorsGeneration(m_indicators).add(m_pendingText.c_str());
+  }
+}
+
+// Called before an immediate indicators generation (showTip(),
+// showColor(), etc.): the pending text was requested earlier, so the
+// new content supersedes it (same result as the old synchronous
+// order).
+void StatusBar::discardPendingStatusText()
+{
+  m_statusTextTimer.stop();
+  m_hasPendingText = false;
+  m_lastText.clear();
+}
+
 void StatusBar::showTip(int msecs, const std::string& msg)
 {
   ASSERT(msecs > 0);
@@ -821,6 +860,7 @@ void StatusBar::showTip(int msecs, const std::string& msg)
   m_tipwindow->startTimer();
 
   // Set the text in status-bar (with inmediate timeout)
+  discardPendingStatusText();
   IndicatorsGeneration(m_indicators).add(msg.c_str());
   m_timeout = base::current_tick();
 }
@@ -829,6 +869,7 @@ void StatusBar::showColor(int msecs, const app::Color& color, const std::string&
 {
   if ((base::current_tick() > m_timeout) || (msecs > 0)) {
     showIndicators();
+    discardPendingStatusText();
     IndicatorsGeneration gen(m_indicators);
     gen.add(color);
     if (!text.empty())
@@ -841,6 +882,7 @@ void StatusBar::showColor(int msecs, const app::Color& color, const std::string&
 void StatusBar::showTile(int msecs, doc::tile_t tile, const std::string& text)
 {
   if ((base::current_tick() > m_timeout) || (msecs > 0)) {
+    discardPendingStatusText();
     IndicatorsGeneration gen(m_indicators);
     gen.add(tile);
     if (!text.empty())
@@ -853,6 +895,7 @@ void StatusBar::showTile(int msecs, doc::tile_t tile, const std::string& text)
 void StatusBar::showTool(int msecs, tools::Tool* tool)
 {
   showIndicators();
+  discardPendingStatusText();
 
   ASSERT(tool != nullptr);
   IndicatorsGeneration(m_indicators).add(tool);
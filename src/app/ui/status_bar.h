@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2022  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -18,6 +18,7 @@
 #include "doc/tile.h"
 #include "ui/base.h"
 #include "ui/box.h"
+#include "ui/timer.h"
 
 #include <string>
 #include <vector>
@@ -62,6 +63,11 @@ public:
   void showDefaultText(Doc* doc);
   void showAbout();
 
+  // The text is not applied immediately: it's kept until the next
+  // timer tick so several calls in the same frame (e.g. one per mouse
+  // movement in the editor) cost just one indicators rebuild. The
+  // other show*() members apply immediately and discard any pending
+  // text.
   bool setStatusText(int msecs, const std::string& text);
   void showTip(int msecs, const std::string& msg);
   void showColor(int msecs, const Color& color, const std::string& text = std::string());
@@ -98,9 +104,19 @@ private:
   void onChangeZoom(const render::Zoom& zoom);
   void updateSnapToGridWindowPosition();
   void showIndicators();
+  void onStatusTextTimer();
+  void discardPendingStatusText();
 
   base::tick_t m_timeout;
 
+  // Deferred setStatusText() (see onStatusTextTimer()): the pending
+  // text to apply in the next tick, and the last text that
+  // regenerated the indicators (to skip re-parsing the same string).
+  ui::Timer m_statusTextTimer;
+  std::string m_pendingText;
+  std::string m_lastText;
+  bool m_hasPendingText;
+
   // About text
   class AboutStatusBar;
   AboutStatusBar* m_about;
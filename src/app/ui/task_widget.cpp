@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -22,7 +22,7 @@ namespace app {
 using namespace ui;
 using namespace app::skin;
 
-TaskWidget::TaskWidget(const Type type, base::task::func_t&& func)
+TaskWidget::TaskWidget(const Type type, base::task::func_t&& func, const Task::Priority priority)
   : Box(HORIZONTAL | HOMOGENEOUS)
   , m_monitorTimer(25)
   , m_cancelButton("Cancel")
@@ -71,7 +71,7 @@ TaskWidget::TaskWidget(const Type type, base::task::func_t&& func)
   });
   initTheme();
 
-  m_task.run(std::move(func));
+  m_task.run(std::move(func), priority);
 }
 
 void TaskWidget::onComplete()
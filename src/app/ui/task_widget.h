@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -26,7 +26,9 @@ public:
     kCancelAndProgress = 3,
   };
 
-  TaskWidget(const Type type, base::task::func_t&& func);
+  TaskWidget(const Type type,
+             base::task::func_t&& func,
+             Task::Priority priority = Task::Priority::kBackground);
   TaskWidget(base::task::func_t&& func) : TaskWidget(kCancelAndProgress, std::move(func)) {}
 
 protected:
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -1668,6 +1668,31 @@ void Timeline::onPaint(ui::PaintEvent& ev)
     const bool hasLayers = getDrawableLayers(&firstLayer, &lastLayer);
     getDrawableFrames(&firstFrame, &lastFrame);
 
+    // Restrict the drawable rows/columns to the damaged region, so a
+    // partial invalidation (e.g. only the previous and the new
+    // playhead columns during playback) doesn't visit every visible
+    // cell of the grid.
+    const gfx::Rect clipBounds = g->getClipBounds();
+    if (!clipBounds.isEmpty()) {
+      const int frameBaseX = separatorX() + m_separator_w - guiscale() - viewScroll().x;
+      if (clipBounds.x > frameBaseX)
+        firstFrame = std::max(firstFrame, getFrameInXPos(clipBounds.x - frameBaseX));
+      lastFrame = std::min(lastFrame, getFrameInXPos(std::max(0, clipBounds.x2() - 1 - frameBaseX)));
+
+      if (hasLayers) {
+        const int rowBaseY = topHeight() + headerBoxHeight() - viewScroll().y;
+        if (clipBounds.y > rowBaseY) {
+          lastLayer = std::min(
+            lastLayer,
+            layer_t(this->lastLayer() - (clipBounds.y - rowBaseY) / layerBoxHeight()));
+        }
+        firstLayer = std::max(
+          firstLayer,
+          layer_t(this->lastLayer() -
+                  std::max(0, clipBounds.y2() - 1 - rowBaseY) / layerBoxHeight()));
+      }
+    }
+
     drawTop(g);
 
     // Draw the header for layers.
@@ -2507,8 +2532,14 @@ void Timeline::drawCel(ui::Graphics* g,
     gfx::Rect thumb_bounds = gfx::Rect(bounds).shrink(skinTheme()->calcBorder(this, style));
 
     if (!thumb_bounds.isEmpty()) {
-      if (os::SurfaceRef surface =
-            thumb::get_cel_thumbnail(g->display(), cel, m_scaleUpToFit, thumb_bounds.size())) {
+      // Cached + generated in the background, scrolling the timeline
+      // doesn't scale images synchronously (the cel is painted
+      // without thumbnail until its entry is ready).
+      if (os::SurfaceRef surface = thumb::get_cached_cel_thumbnail(g->display(),
+                                                                   m_document,
+                                                                   cel,
+                                                                   m_scaleUpToFit,
+                                                                   thumb_bounds.size())) {
         const int t = std::clamp(thumb_bounds.w / 8, 4, 16);
         draw_checkered_grid(g, thumb_bounds, gfx::Size(t, t), docPref());
 
@@ -3346,6 +3377,11 @@ void Timeline::regenerateRows()
     m_rows[i++] = Row(layer, level, flags);
   });
 
+  m_rowIndexes.clear();
+  m_rowIndexes.reserve(m_rows.size());
+  for (size_t j = 0; j < m_rows.size(); ++j)
+    m_rowIndexes[m_rows[j].layer()] = layer_t(j);
+
   regenerateTagBands();
   updateScrollBars();
 }
@@ -4032,11 +4068,8 @@ doc::Layer* Timeline::getLayer(int layerIndex) const
 
 layer_t Timeline::getLayerIndex(const Layer* layer) const
 {
-  for (int i = 0; i < (int)m_rows.size(); i++)
-    if (m_rows[i].layer() == layer)
-      return i;
-
-  return -1;
+  const auto it = m_rowIndexes.find(layer);
+  return (it != m_rowIndexes.end() ? it->second : -1);
 }
 
 bool Timeline::isLayerActive(const layer_t layerIndex) const
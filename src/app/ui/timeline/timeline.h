@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -36,6 +36,7 @@
 #include "view/timeline_adapter.h"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace doc {
@@ -453,6 +454,11 @@ private:
   // Data used to display each row in the timeline
   std::vector<Row> m_rows;
 
+  // Cached layer -> row position, rebuilt in regenerateRows(), so
+  // getLayerIndex() doesn't have to search m_rows linearly on each
+  // mouse movement/paint.
+  std::unordered_map<const doc::Layer*, layer_t> m_rowIndexes;
+
   // Data used to display frame tags
   int m_tagBands;
   int m_tagFocusBand;
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -120,6 +120,7 @@ void UIContext::setActiveView(DocView* docView)
 
   mainWin->getTimeline()->updateUsingEditor(editor);
   mainWin->getPreviewEditor()->updateUsingEditor(editor);
+  mainWin->getNavigator()->updateUsingEditor(editor);
 
   // Update mouse widgets immediately after changing views rather
   // than waiting for mouse movement.
@@ -146,6 +147,10 @@ void UIContext::setActiveView(DocView* docView)
 
 void UIContext::onSetActiveDocument(Doc* document, bool notify)
 {
+  // Rehydrate the document if it was hibernated (and hibernate other
+  // cold ones) before any view of it is repainted.
+  m_hibernation.onActiveDocumentChange(document);
+
   notify = (notify && lastSelectedDoc() != document);
 
   if (notify)
@@ -306,6 +311,10 @@ void UIContext::onAddDocument(Doc* doc)
 {
   app::Context::onAddDocument(doc);
 
+  // Reload external tilesets automatically when their files change
+  // on disk.
+  m_tilesetWatch.addDocument(doc);
+
   // We don't create views in batch mode.
   if (!App::instance()->isGui())
     return;
@@ -323,6 +332,11 @@ void UIContext::onAddDocument(Doc* doc)
 
 void UIContext::onRemoveDocument(Doc* doc)
 {
+  // The document must be complete if it goes to the closed-docs list
+  // (or is deleted while hibernated).
+  m_hibernation.removeDocument(doc);
+  m_tilesetWatch.removeDocument(doc);
+
   app::Context::onRemoveDocument(doc);
 
   // We don't destroy views in batch mode.
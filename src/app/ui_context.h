@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2023  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -11,7 +11,9 @@
 
 #include "app/closed_docs.h"
 #include "app/context.h"
+#include "app/doc_hibernation.h"
 #include "app/docs_observer.h"
+#include "app/external_tileset_watch.h"
 
 #include <vector>
 
@@ -90,6 +92,8 @@ private:
   DocView* m_targetView = nullptr;
 
   ClosedDocs m_closedDocs;
+  DocHibernation m_hibernation;
+  ExternalTilesetWatch m_tilesetWatch;
 
   static UIContext* m_instance;
 };
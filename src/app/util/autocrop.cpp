@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This program is distributed under the terms of
@@ -12,6 +12,8 @@
 #include "app/util/autocrop.h"
 
 #include "app/snap_to_grid.h"
+#include "app/util/tuning.h"
+#include "base/thread_pool.h"
 #include "doc/algorithm/shrink_bounds.h"
 #include "doc/image.h"
 #include "doc/mask.h"
@@ -20,6 +22,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
 namespace app {
 
@@ -241,29 +244,47 @@ bool get_best_refcolor_for_trimming(doc::Image* image, color_t& refColor)
 gfx::Rect get_trimmed_bounds(const doc::Sprite* sprite, const bool byGrid)
 {
   gfx::Rect bounds;
+  const frame_t nframes = sprite->totalFrames();
+
+  // Compositing and scanning one frame is independent from the other
+  // frames, so we interleave the frames among some workers, each one
+  // with its own scratch image/renderer, and join the per-worker
+  // unions at the end (the result is the same as the old serial
+  // frame-by-frame union).
+  static base::thread_pool pool(tuned_worker_count());
+  const int ntasks = std::clamp(tuned_worker_count(), 1, int(nframes));
+  std::vector<gfx::Rect> taskBounds(ntasks);
+
+  for (int task = 0; task < ntasks; ++task) {
+    pool.execute([sprite, task, ntasks, nframes, &taskBounds] {
+      std::unique_ptr<Image> image(Image::create(sprite->spec()));
+      render::Render render;
+
+      gfx::Rect localBounds;
+      for (frame_t frame(task); frame < nframes; frame += ntasks) {
+        render.renderSprite(image.get(), sprite, frame);
+
+        gfx::Rect frameBounds;
+        doc::color_t refColor;
+        if (get_best_refcolor_for_trimming(image.get(), refColor) &&
+            doc::algorithm::shrink_bounds(image.get(), refColor, nullptr, frameBounds)) {
+          localBounds = localBounds.createUnion(frameBounds);
+        }
+      }
+      taskBounds[task] = localBounds;
+    });
+  }
+  pool.wait_all();
 
-  std::unique_ptr<Image> image_wrap(Image::create(sprite->spec()));
-  Image* image = image_wrap.get();
-
-  render::Render render;
-
-  for (frame_t frame(0); frame < sprite->totalFrames(); ++frame) {
-    render.renderSprite(image, sprite, frame);
-
-    gfx::Rect frameBounds;
-    doc::color_t refColor;
-    if (get_best_refcolor_for_trimming(image, refColor) &&
-        doc::algorithm::shrink_bounds(image, refColor, nullptr, frameBounds)) {
-      bounds = bounds.createUnion(frameBounds);
-    }
+  for (const gfx::Rect& taskRect : taskBounds)
+    bounds = bounds.createUnion(taskRect);
 
-    // TODO merge this code with the code in DocExporter::captureSamples()
-    if (byGrid) {
-      const gfx::Rect& gridBounds = sprite->gridBounds();
-      gfx::Point posTopLeft = snap_to_grid(gridBounds, bounds.origin(), PreferSnapTo::FloorGrid);
-      gfx::Point posBottomRight = snap_to_grid(gridBounds, bounds.point2(), PreferSnapTo::CeilGrid);
-      bounds = gfx::Rect(posTopLeft, posBottomRight);
-    }
+  // TODO merge this code with the code in DocExporter::captureSamples()
+  if (byGrid) {
+    const gfx::Rect& gridBounds = sprite->gridBounds();
+    gfx::Point posTopLeft = snap_to_grid(gridBounds, bounds.origin(), PreferSnapTo::FloorGrid);
+    gfx::Point posBottomRight = snap_to_grid(gridBounds, bounds.point2(), PreferSnapTo::CeilGrid);
+    bounds = gfx::Rect(posTopLeft, posBottomRight);
   }
   return bounds;
 }
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2023  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -13,7 +13,8 @@
 #include "doc/image.h"
 #include "gfx/region.h"
 
-#include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace app {
 
@@ -30,12 +31,12 @@ void save_image_region_in_buffer(const gfx::Region& region,
 
   // Save region pixels
   buffer.resize(reqBytes);
-  auto it = buffer.begin();
+  uint8_t* it = buffer.data();
   for (const auto& rc : region) {
+    const size_t rowBytes = bytesPerPixel * rc.w;
     for (int y = 0; y < rc.h; ++y) {
       auto p = (const uint8_t*)image->getPixelAddress(rc.x - imagePos.x, rc.y - imagePos.y + y);
-      const size_t rowBytes = bytesPerPixel * rc.w;
-      std::copy(p, p + rowBytes, it);
+      std::memcpy(it, p, rowBytes);
       it += rowBytes;
     }
   }
@@ -45,13 +46,19 @@ void swap_image_region_with_buffer(const gfx::Region& region,
                                    doc::Image* image,
                                    base::buffer& buffer)
 {
+  // Swap one full row per iteration through a temporary row buffer
+  // (three memcpy() calls vectorize a lot better than a byte-wise
+  // swap, and this is called on each undo/redo of a stroke).
   const size_t bytesPerPixel = image->bytesPerPixel();
-  auto it = buffer.begin();
+  std::vector<uint8_t> tmp(bytesPerPixel * image->width());
+  uint8_t* it = buffer.data();
   for (const auto& rc : region) {
+    const size_t rowBytes = bytesPerPixel * rc.w;
     for (int y = 0; y < rc.h; ++y) {
       auto p = (uint8_t*)image->getPixelAddress(rc.x, rc.y + y);
-      const size_t rowBytes = bytesPerPixel * rc.w;
-      std::swap_ranges(it, it + rowBytes, p);
+      std::memcpy(tmp.data(), p, rowBytes);
+      std::memcpy(p, it, rowBytes);
+      std::memcpy(it, tmp.data(), rowBytes);
       it += rowBytes;
     }
   }
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -22,6 +22,7 @@
 #include "app/cmd/set_cel_position.h"
 #include "app/cmd_sequence.h"
 #include "app/doc.h"
+#include "app/job_scheduler.h"
 #include "doc/algorithm/fill_selection.h"
 #include "doc/algorithm/flip_image.h"
 #include "doc/algorithm/resize_image.h"
@@ -36,6 +37,7 @@
 #include "doc/primitives.h"
 #include "doc/sprite.h"
 #include "doc/tileset.h"
+#include "doc/tileset_hash_table.h"
 #include "doc/tilesets.h"
 #include "gfx/region.h"
 #include "render/dithering.h"
@@ -46,6 +48,8 @@
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #define OPS_TRACE(...) // TRACE(__VA_ARGS__)
@@ -131,6 +135,10 @@ public:
   {
     m_flipped = !m_flipped;
     doc::algorithm::flip_image(m_image, m_image->bounds(), m_flipType);
+
+    // Invalidate the cached Image::contentHash() used by
+    // Tileset::findTileIndex() to match this flipped version
+    m_image->incrementVersion();
   }
   void reset()
   {
@@ -246,6 +254,45 @@ bool find_tile(doc::Tileset* tileset,
   return false;
 }
 
+// Cache of tile images already matched against (or added to) the
+// tileset while one region of modified tiles is processed. Big
+// brushes/fills touch a lot of tiles that end with exactly the same
+// content (e.g. tiles completely covered with the same solid color),
+// and without this cache each one of them repeats the whole
+// find_tile() search, which flips the tile image up to 8 times
+// looking for a flipped match.
+class TileImageCache {
+public:
+  bool get(const doc::ImageRef& tileImage,
+           doc::tile_index& tileIndex,
+           doc::tile_flags& tileFlags) const
+  {
+    const auto it = m_cache.find(tileImage);
+    if (it == m_cache.end())
+      return false;
+    tileIndex = it->second.first;
+    tileFlags = it->second.second;
+    return true;
+  }
+
+  void put(const doc::ImageRef& tileImage,
+           const doc::tile_index tileIndex,
+           const doc::tile_flags tileFlags)
+  {
+    m_cache.insert({ tileImage, { tileIndex, tileFlags } });
+  }
+
+private:
+  // Same hashing contract as TilesetHashTable: tile images were
+  // preprocessed with preprocess_transparent_pixels() and hashed by
+  // their cached Image::contentHash().
+  std::unordered_map<doc::ImageRef,
+                     std::pair<doc::tile_index, doc::tile_flags>,
+                     doc::details::tile_image_hash,
+                     doc::details::image_eq>
+    m_cache;
+};
+
 } // anonymous namespace
 
 void create_region_with_differences(const Image* a,
@@ -510,8 +557,17 @@ void draw_image_into_new_tilemap_cel(CmdSequence* cmds,
     ASSERT(tilemapBounds.h == newTilemap->height());
   }
 
-  for (const gfx::Point& tilePt : grid.tilesInCanvasRegion(gfx::Region(canvasBounds))) {
-    const gfx::Point tilePtInCanvas = grid.tileToCanvas(tilePt);
+  TileImageCache tileCache;
+
+  // Crop, mask, preprocess and hash all the tile images in parallel:
+  // it's most of the work of baking a tilemap from an image, and once
+  // each tile image carries its cached Image::contentHash() the
+  // matching loop below is mostly hash table lookups. Mutating the
+  // tileset (and the undo sequence) stays serial.
+  const std::vector<gfx::Point> tilePts = grid.tilesInCanvasRegion(gfx::Region(canvasBounds));
+  std::vector<doc::ImageRef> tileImages(tilePts.size());
+  JobScheduler::instance()->forkJoin(int(tilePts.size()), [&](int i) {
+    const gfx::Point tilePtInCanvas = grid.tileToCanvas(tilePts[i]);
     doc::ImageRef tileImage(doc::crop_image(srcImage,
                                             tilePtInCanvas.x - srcImagePos.x,
                                             tilePtInCanvas.y - srcImagePos.y,
@@ -522,26 +578,36 @@ void draw_image_into_new_tilemap_cel(CmdSequence* cmds,
       mask_image(tileImage.get(), grid.mask().get());
 
     preprocess_transparent_pixels(tileImage.get());
+    tileImage->contentHash(); // Warm up the cached hash
+    tileImages[i] = tileImage;
+  });
+
+  for (int i = 0; i < int(tilePts.size()); ++i) {
+    const gfx::Point& tilePt = tilePts[i];
+    doc::ImageRef tileImage = tileImages[i];
 
     doc::tile_index tileIndex;
     doc::tile_flags tileFlag = 0;
 
-    if (!find_tile(tileset, tileImage, tileIndex, tileFlag)) {
-      auto addTile = new cmd::AddTile(tileset, tileImage);
+    if (!tileCache.get(tileImage, tileIndex, tileFlag)) {
+      if (!find_tile(tileset, tileImage, tileIndex, tileFlag)) {
+        auto addTile = new cmd::AddTile(tileset, tileImage);
 
-      if (cmds)
-        cmds->executeAndAdd(addTile);
-      else {
-        // TODO a little hacky
-        addTile->execute(doc->context());
-      }
+        if (cmds)
+          cmds->executeAndAdd(addTile);
+        else {
+          // TODO a little hacky
+          addTile->execute(doc->context());
+        }
 
-      tileIndex = addTile->tileIndex();
+        tileIndex = addTile->tileIndex();
 
-      if (!cmds)
-        delete addTile;
+        if (!cmds)
+          delete addTile;
 
-      doc->notifyAfterAddTile(dstLayer, dstCel->frame(), tileIndex);
+        doc->notifyAfterAddTile(dstLayer, dstCel->frame(), tileIndex);
+      }
+      tileCache.put(tileImage, tileIndex, tileFlag);
     }
 
     // We were using newTilemap->putPixel() directly but received a
@@ -662,6 +728,8 @@ void modify_tilemap_cel_region(CmdSequence* cmds,
       });
     }
 
+    TileImageCache tileCache;
+
     for (const gfx::Point& tilePt : grid.tilesInCanvasRegion(regionToPatch)) {
       const int u = tilePt.x - newTilemapBounds.x;
       const int v = tilePt.y - newTilemapBounds.y;
@@ -686,8 +754,14 @@ void modify_tilemap_cel_region(CmdSequence* cmds,
       doc::tile_index tileIndex;
       doc::tile_flags tileFlag = 0;
 
-      if (find_tile(tileset, tileImage, tileIndex, tileFlag)) {
+      if (tileCache.get(tileImage, tileIndex, tileFlag)) {
+        // Identical content was already resolved for another tile of
+        // this same region (common with big brushes), we can re-use
+        // the result directly.
+      }
+      else if (find_tile(tileset, tileImage, tileIndex, tileFlag)) {
         // We can re-use an existent tile (tileIndex) from the tileset
+        tileCache.put(tileImage, tileIndex, tileFlag);
       }
       else if (tilesetMode == TilesetMode::Auto && t != doc::notile && ti >= 0 &&
                ti < tilesHistogram.size() &&
@@ -704,12 +778,14 @@ void modify_tilemap_cel_region(CmdSequence* cmds,
                                   false,
                                   tileIndex,
                                   tileset));
+        tileCache.put(tileImage, tileIndex, tileFlag);
       }
       else {
         auto addTile = new cmd::AddTile(tileset, tileImage);
         cmds->executeAndAdd(addTile);
 
         tileIndex = addTile->tileIndex();
+        tileCache.put(tileImage, tileIndex, tileFlag);
       }
 
       // If the tile changed, we have to remove the old tile index
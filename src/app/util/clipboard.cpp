@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -39,12 +39,14 @@
 #include "doc/algorithm/shrink_bounds.h"
 #include "doc/blend_image.h"
 #include "doc/doc.h"
+#include "doc/image_io.h"
 #include "render/dithering.h"
 #include "render/ordered_dither.h"
 #include "render/quantization.h"
 #include "view/cels.h"
 
 #include <memory>
+#include <sstream>
 #include <stdexcept>
 
 namespace app {
@@ -98,6 +100,14 @@ struct Clipboard::Data {
   // RGB/Grayscale/Indexed image
   ImageRef image;
 
+  // Compressed snapshot of a big copied image (doc::write_image()
+  // format): after a copy we only retain these bytes and the pixels
+  // are materialized again in decompressImage() when something
+  // actually pastes them, so repeated copies of big selections don't
+  // keep a second full-resolution image alive.
+  std::string compressedImage;
+  gfx::Size compressedImageSize;
+
   // The palette of the image (or tileset) if it's indexed
   std::shared_ptr<Palette> palette;
 
@@ -132,6 +142,7 @@ struct Clipboard::Data {
   {
     text.clear();
     image.reset();
+    compressedImage.clear();
     palette.reset();
     tilemap.reset();
     tileset.reset();
@@ -141,9 +152,36 @@ struct Clipboard::Data {
     slices.clear();
   }
 
+  // Big images are only worth the deflate round-trip (1MB of pixels
+  // compresses in a few milliseconds with the parallel image
+  // encoder).
+  static constexpr size_t kMinSizeToCompress = 1024 * 1024;
+
+  void compressImage()
+  {
+    if (!image || size_t(image->getMemSize()) < kMinSizeToCompress)
+      return;
+
+    std::ostringstream os(std::ios::binary);
+    if (doc::write_image(os, image.get())) {
+      compressedImage = os.str();
+      compressedImageSize = gfx::Size(image->width(), image->height());
+      image.reset();
+    }
+  }
+
+  void decompressImage()
+  {
+    if (image || compressedImage.empty())
+      return;
+
+    std::istringstream is(compressedImage);
+    image.reset(doc::read_image(is));
+  }
+
   ClipboardFormat format() const
   {
-    if (image)
+    if (image || !compressedImage.empty())
       return ClipboardFormat::Image;
     else if (tilemap)
       return ClipboardFormat::Tilemap;
@@ -256,6 +294,13 @@ void Clipboard::setData(Image* image,
                       image_source_is_transparent ? image->maskColor() : -1);
     }
   }
+
+  // Keep only the compressed bytes of big images copied by the user
+  // (set_native_clipboard=false means we are just re-caching data
+  // fetched from the native clipboard for an in-progress paste, where
+  // the pixels are needed right away).
+  if (set_native_clipboard)
+    m_data->compressImage();
 }
 
 bool Clipboard::copyFromDocument(const Site& site, bool merged)
@@ -856,6 +901,7 @@ ImageRef Clipboard::getImage(Palette* palette)
       setData(native_image, native_mask, native_palette, native_tileset, nullptr, false, false);
     }
   }
+  m_data->decompressImage();
   if (m_data->palette && palette)
     m_data->palette->copyColorsTo(palette);
   return m_data->image;
@@ -871,6 +917,10 @@ bool Clipboard::getImageSize(gfx::Size& size)
     size.h = m_data->image->height();
     return true;
   }
+  if (!m_data->compressedImage.empty()) {
+    size = m_data->compressedImageSize;
+    return true;
+  }
 
   return false;
 }
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020-2025  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2016-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -12,7 +12,9 @@
 #include "app/util/clipboard.h"
 
 #include "app/i18n/strings.h"
+#include "app/util/tuning.h"
 #include "base/serialization.h"
+#include "base/thread_pool.h"
 #include "clip/clip.h"
 #include "doc/color_scales.h"
 #include "doc/file/hex_file.h"
@@ -27,7 +29,10 @@
 #include "os/window.h"
 #include "ui/alert.h"
 
+#include <algorithm>
+#include <istream>
 #include <sstream>
+#include <streambuf>
 #include <string>
 #include <vector>
 
@@ -52,6 +57,37 @@ public:
   ~InhibitClipErrors() { show_clip_errors = m_saved; }
 };
 
+// std::istream that reads directly from an in-memory buffer, used to
+// decode the custom clipboard format in place instead of copying it
+// into a stringstream first (the buffer can be several MB for big
+// images).
+class InputBufferStream : private std::streambuf,
+                          public std::istream {
+public:
+  InputBufferStream(char* data, const size_t size)
+    : std::istream(static_cast<std::streambuf*>(this))
+  {
+    setg(data, data, data + size);
+  }
+};
+
+// Converts all the image rows to the raw RGBA format of the native
+// clipboard in parallel (interleaving rows among the workers, like
+// get_trimmed_bounds() does with frames).
+template<typename RowFn>
+void convert_rows_in_parallel(const int height, RowFn rowFn)
+{
+  static base::thread_pool pool(tuned_worker_count());
+  const int ntasks = std::clamp(tuned_worker_count(), 1, height);
+  for (int task = 0; task < ntasks; ++task) {
+    pool.execute([task, ntasks, height, &rowFn] {
+      for (int y = task; y < height; y += ntasks)
+        rowFn(y);
+    });
+  }
+  pool.wait_all();
+}
+
 void* native_window_handle()
 {
   auto system = os::System::instance();
@@ -110,7 +146,11 @@ bool Clipboard::setNativeBitmap(const doc::Image* image,
   if (!image)
     return false;
 
-  // Set custom clipboard formats
+  // Set custom clipboard formats. This is the compact representation
+  // (doc::write_image() compresses the pixels with zlib) preferred by
+  // getNativeBitmap(), so copying between two Aseprite instances
+  // doesn't depend on the raw RGBA image below, which is just a
+  // fallback for other applications.
   if (custom_image_format) {
     std::stringstream os;
     write32(os, (image ? 1 : 0) | (mask ? 2 : 0) | (palette ? 4 : 0) | (tileset ? 8 : 0));
@@ -124,14 +164,9 @@ bool Clipboard::setNativeBitmap(const doc::Image* image,
       doc::write_tileset(os, tileset);
 
     if (os.good()) {
-      size_t size = (size_t)os.tellp();
-      if (size > 0) {
-        std::vector<char> data(size);
-        os.seekp(0);
-        os.read(&data[0], size);
-
-        l.set_data(custom_image_format, &data[0], size);
-      }
+      const std::string data = os.str();
+      if (!data.empty())
+        l.set_data(custom_image_format, data.data(), data.size());
     }
   }
 
@@ -159,18 +194,17 @@ bool Clipboard::setNativeBitmap(const doc::Image* image,
     }
     case doc::IMAGE_GRAYSCALE: {
       const clip::image img(spec);
-      const doc::LockImageBits<doc::GrayscaleTraits> bits(image);
-      auto it = bits.begin();
-      uint32_t* dst = (uint32_t*)img.data();
-      for (int y = 0; y < image->height(); ++y) {
-        for (int x = 0; x < image->width(); ++x, ++it) {
-          doc::color_t c = *it;
-          *(dst++) = doc::rgba(doc::graya_getv(c),
-                               doc::graya_getv(c),
-                               doc::graya_getv(c),
-                               doc::graya_geta(c));
+      convert_rows_in_parallel(image->height(), [&](const int y) {
+        auto src = (const uint16_t*)image->rowSpan(y).data;
+        auto dst = (uint32_t*)(img.data() + y * spec.bytes_per_row);
+        for (int x = 0; x < image->width(); ++x) {
+          const doc::color_t c = src[x];
+          dst[x] = doc::rgba(doc::graya_getv(c),
+                             doc::graya_getv(c),
+                             doc::graya_getv(c),
+                             doc::graya_geta(c));
         }
-      }
+      });
       l.set_image(img);
       break;
     }
@@ -179,20 +213,19 @@ bool Clipboard::setNativeBitmap(const doc::Image* image,
         return false;
 
       const clip::image img(spec);
-      const doc::LockImageBits<doc::IndexedTraits> bits(image);
-      auto it = bits.begin();
-      uint32_t* dst = (uint32_t*)img.data();
-      for (int y = 0; y < image->height(); ++y) {
-        for (int x = 0; x < image->width(); ++x, ++it) {
-          doc::color_t c = palette->getEntry(*it);
+      convert_rows_in_parallel(image->height(), [&](const int y) {
+        auto src = (const uint8_t*)image->rowSpan(y).data;
+        auto dst = (uint32_t*)(img.data() + y * spec.bytes_per_row);
+        for (int x = 0; x < image->width(); ++x) {
+          doc::color_t c = palette->getEntry(src[x]);
 
           // Use alpha=0 for mask color
-          if (*it == indexMaskColor)
+          if (src[x] == indexMaskColor)
             c &= doc::rgba_rgb_mask;
 
-          *(dst++) = c;
+          dst[x] = c;
         }
-      }
+      });
       l.set_image(img);
       break;
     }
@@ -222,9 +255,7 @@ bool Clipboard::getNativeBitmap(doc::Image** image,
     if (size > 0) {
       std::vector<char> buf(size);
       if (l.get_data(custom_image_format, &buf[0], size)) {
-        std::stringstream is;
-        is.write(&buf[0], size);
-        is.seekp(0);
+        InputBufferStream is(&buf[0], size);
 
         int bits = read32(is);
         if (bits & 1)
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (c) 2020-2025  Igara Studio S.A.
+// Copyright (c) 2020-2026  Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This program is distributed under the terms of
@@ -278,6 +278,30 @@ void convert_image_to_surface(const doc::Image* image,
       break;
 
     case IMAGE_INDEXED:
+      // Fast path: precompute one surface color per palette entry so
+      // the per-pixel work is a plain table lookup (this conversion
+      // runs between every edit and the screen on indexed sprites).
+      if (fd.bitsPerPixel == 32) {
+        uint32_t lut[256];
+        const int ncolors = std::min(palette->size(), 256);
+        for (int i = 0; i < ncolors; ++i) {
+          lut[i] = convert_color_to_surface<IndexedTraits, os::kRgbaSurfaceFormat>(i,
+                                                                                   palette,
+                                                                                   image->spec(),
+                                                                                   &fd);
+        }
+        // Indexes out of the palette range are painted as transparent
+        // (just like the mask color entry).
+        std::fill(lut + ncolors, lut + 256, 0);
+
+        for (int v = 0; v < h; ++v, ++src_y, ++dst_y) {
+          const uint8_t* src_address = image->getPixelAddress(src_x, src_y);
+          auto* dst_address = (uint32_t*)surface->getData(dst_x, dst_y);
+          for (int u = 0; u < w; ++u)
+            dst_address[u] = lut[src_address[u]];
+        }
+        break;
+      }
       convert_image_to_surface_selector<
         IndexedTraits>(image, surface, src_x, src_y, dst_x, dst_y, w, h, palette, &fd);
       break;
@@ -297,4 +321,46 @@ void convert_image_to_surface(const doc::Image* image,
 #endif
 }
 
+doc::ImageRef wrap_surface_in_image(os::Surface* surface, const int w, const int h)
+{
+  if (w < 1 || h < 1 || w > surface->width() || h > surface->height())
+    return nullptr;
+
+  // Same layout check as the RGB fast path of
+  // convert_image_to_surface(): each 32bpp surface pixel must be a
+  // doc::rgba value.
+  os::SurfaceFormatData fd;
+  surface->getFormat(&fd);
+  if (fd.bitsPerPixel != 32 || gfx::ColorRShift != fd.redShift ||
+      gfx::ColorGShift != fd.greenShift || gfx::ColorBShift != fd.blueShift ||
+      gfx::ColorAShift != fd.alphaShift) {
+    return nullptr;
+  }
+
+  // Writing through the wrapped image bypasses the surface clip.
+  if (!surface->getClipBounds().contains(gfx::Rect(0, 0, w, h)))
+    return nullptr;
+
+#if LAF_SKIA
+  // Needed because Skia surfaces work with premultiplied alpha and
+  // the renderer composites unpremultiplied alpha RGB values.
+  ((os::SkiaSurface*)surface)->bitmap().setAlphaType(kUnpremul_SkAlphaType);
+#endif
+
+  uint8_t* pixels = surface->getData(0, 0);
+  const std::size_t rowBytes = (h > 1 ? std::size_t(surface->getData(0, 1) - pixels) :
+                                        RgbTraits::rowstride_bytes(w));
+  return doc::ImageRef(
+    Image::createWrap(ImageSpec(ColorMode::RGB, w, h, 0), pixels, rowBytes));
+}
+
+void notify_surface_pixels_changed(os::Surface* surface)
+{
+#if LAF_SKIA
+  // Increment SkBitmap generation ID so it's re-uploaded to the GPU
+  // as a texture if it's needed.
+  static_cast<os::SkiaSurface*>(surface)->bitmap().notifyPixelsChanged();
+#endif
+}
+
 } // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (c) 2020  Igara Studio S.A.
+// Copyright (c) 2020-2026  Igara Studio S.A.
 // Copyright (c) 2001-2014 David Capello
 //
 // This program is distributed under the terms of
@@ -9,6 +9,8 @@
 #define APP_UTIL_CONVERSION_TO_SURFACE_H_INCLUDED
 #pragma once
 
+#include "doc/image_ref.h"
+
 namespace doc {
 class Image;
 class Palette;
@@ -30,6 +32,16 @@ void convert_image_to_surface(const doc::Image* image,
                               int w,
                               int h);
 
+// Returns an IMAGE_RGB image that wraps the top-left w x h pixels of
+// the given surface directly (no copy), so a renderer can composite
+// into the surface and skip the staging image + conversion pass, or
+// nullptr if the surface layout doesn't match doc::rgba. The caller
+// must keep the surface locked (os::SurfaceLock) while the image is
+// alive and call notify_surface_pixels_changed() when it has finished
+// writing pixels.
+doc::ImageRef wrap_surface_in_image(os::Surface* surface, int w, int h);
+void notify_surface_pixels_changed(os::Surface* surface);
+
 } // namespace app
 
 #endif
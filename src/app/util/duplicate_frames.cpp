@@ -0,0 +1,87 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/util/duplicate_frames.h"
+
+#include "app/doc.h"
+#include "app/doc_api.h"
+#include "app/tx.h"
+#include "doc/cel.h"
+#include "doc/image.h"
+#include "doc/layer.h"
+#include "doc/primitives.h"
+#include "doc/sprite.h"
+
+namespace app {
+
+using namespace doc;
+
+namespace {
+
+// Returns true if both frames have exactly the same content in all
+// layers (cels in the same position, with the same opacity/z-index,
+// and the same pixels).
+bool same_frame_content(const Sprite* sprite, const frame_t a, const frame_t b)
+{
+  for (const Layer* layer : sprite->allLayers()) {
+    const Cel* celA = layer->cel(a);
+    const Cel* celB = layer->cel(b);
+    if (!celA && !celB)
+      continue;
+    if (!celA || !celB)
+      return false;
+
+    if (celA->x() != celB->x() || celA->y() != celB->y() || celA->opacity() != celB->opacity() ||
+        celA->zIndex() != celB->zIndex())
+      return false;
+
+    const Image* imgA = celA->image();
+    const Image* imgB = celB->image();
+    if (imgA == imgB) // Linked cels
+      continue;
+    if (!imgA || !imgB)
+      return false;
+
+    // The content hash is cached per image version, so comparing one
+    // frame against several candidates doesn't re-read the pixels
+    // each time. Equal hashes are still verified pixel by pixel
+    // before we merge the frames.
+    if (imgA->spec() != imgB->spec() || imgA->contentHash() != imgB->contentHash() ||
+        !is_same_image(imgA, imgB))
+      return false;
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int merge_duplicate_frames(Doc* doc, Sprite* sprite, Tx& tx)
+{
+  DocApi api = doc->getApi(tx);
+  int removed = 0;
+
+  // Compare each frame with the previous one walking backward, so
+  // removing a frame doesn't change the numbers of the frames that
+  // are still pending, and runs of duplicates accumulate their
+  // durations in the first frame of the run.
+  for (frame_t frame = sprite->lastFrame(); frame >= 1; --frame) {
+    if (!same_frame_content(sprite, frame - 1, frame))
+      continue;
+
+    api.setFrameDuration(sprite,
+                         frame - 1,
+                         sprite->frameDuration(frame - 1) + sprite->frameDuration(frame));
+    api.removeFrame(sprite, frame);
+    ++removed;
+  }
+  return removed;
+}
+
+} // namespace app
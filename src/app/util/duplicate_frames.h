@@ -0,0 +1,28 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_UTIL_DUPLICATE_FRAMES_H_INCLUDED
+#define APP_UTIL_DUPLICATE_FRAMES_H_INCLUDED
+#pragma once
+
+namespace doc {
+class Sprite;
+}
+
+namespace app {
+class Doc;
+class Tx;
+
+// Collapses each run of consecutive frames with identical content
+// into its first frame, accumulating the durations of the removed
+// frames (useful to clean up animations imported from videos, which
+// tend to repeat the same frame many times). Returns the number of
+// removed frames.
+int merge_duplicate_frames(Doc* doc, doc::Sprite* sprite, Tx& tx);
+
+} // namespace app
+
+#endif
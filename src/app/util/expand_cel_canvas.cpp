@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -368,8 +368,14 @@ void ExpandCelCanvas::commit()
         // TODO support for tilemap backgrounds?
         ASSERT(m_celImage.get() == m_cel->image());
 
-        m_cmds->executeAndAdd(
-          new cmd::CopyRegion(m_cel->image(), m_dstImage.get(), *regionToPatch, m_bounds.origin()));
+        // The background cel never moves, so we can pass it to
+        // CopyRegion to locate the modified region in the canvas.
+        m_cmds->executeAndAdd(new cmd::CopyRegion(m_cel->image(),
+                                                  m_dstImage.get(),
+                                                  *regionToPatch,
+                                                  m_bounds.origin(),
+                                                  false,
+                                                  m_cel));
       }
       else if (m_tilemapMode == TilemapMode::Tiles) {
         ASSERT(m_celImage.get() != m_cel->image());
@@ -447,7 +453,14 @@ Image* ExpandCelCanvas::getSourceCanvas()
       m_srcImage.reset(Image::create(m_sprite->pixelFormat(), m_bounds.w, m_bounds.h, src_buffer));
       m_srcImage->setMaskColor(m_sprite->transparentColor());
     }
-    m_srcImage->clear(m_srcImage->maskColor());
+
+    // The source canvas is not cleared here on purpose: it's only
+    // read through regions previously passed to
+    // validateSourceCanvas(), and that function defines (copies or
+    // clears) every pixel it marks as valid. Skipping the full-canvas
+    // clear keeps the stroke start latency independent of the canvas
+    // size (the shared src_buffer can contain data from a previous
+    // stroke).
   }
   return m_srcImage.get();
 }
@@ -463,6 +476,12 @@ Image* ExpandCelCanvas::getDestCanvas()
       m_dstImage.reset(Image::create(m_sprite->pixelFormat(), m_bounds.w, m_bounds.h, dst_buffer));
       m_dstImage->setMaskColor(m_sprite->transparentColor());
     }
+
+    // Unlike the source canvas, the destination must be fully defined
+    // from the start: it's used as the preview image in the render
+    // engine (see DrawingState::onEnterState()), which can read any
+    // pixel regardless of the validated regions (e.g. if the user
+    // scrolls or zooms in the middle of a stroke).
     m_dstImage->clear(m_dstImage->maskColor());
   }
   return m_dstImage.get();
@@ -512,6 +531,15 @@ void ExpandCelCanvas::validateSourceCanvas(const gfx::Region& rgn)
   EXP_TRACE(" ->", rgnToValidate.bounds());
 
   rgnToValidate.offset(zeroPos);
+
+  // Fast path: the whole area is valid already. Common when drawing
+  // long freehand strokes that pass several times over the same
+  // canvas area (e.g. with the pixel-perfect algorithm), where the
+  // region operations below get more expensive on each new stroke
+  // point as m_validSrcRegion accumulates more rectangles.
+  if (m_validSrcRegion.contains(rgnToValidate.bounds()) == gfx::Region::In)
+    return;
+
   rgnToValidate.createSubtraction(rgnToValidate, m_validSrcRegion);
   rgnToValidate.createIntersection(rgnToValidate, gfx::Region(m_srcImage->bounds()));
 
@@ -526,6 +554,14 @@ void ExpandCelCanvas::validateSourceCanvas(const gfx::Region& rgn)
     if (m_celImage->pixelFormat() == IMAGE_TILEMAP && m_srcImage->pixelFormat() != IMAGE_TILEMAP) {
       ASSERT(m_tilemapMode == TilemapMode::Pixels);
 
+      // The cel is rendered *over* the canvas (not copied), so the
+      // pixels to validate must start from the transparent color (the
+      // canvas is not pre-cleared anymore, see getSourceCanvas()).
+      gfx::Region rgnToRender;
+      rgnToRender.createSubtraction(rgnToValidate, rgnToClear);
+      for (const auto& rc : rgnToRender)
+        fill_rect(m_srcImage.get(), rc, m_srcImage->maskColor());
+
       // For tilemaps, we can use the Render class to render visible
       // tiles in the rgnToValidate of this cel.
       render::Render subRender;
@@ -612,6 +648,12 @@ void ExpandCelCanvas::validateDestCanvas(const gfx::Region& rgn)
 
   if (m_tilemapMode != TilemapMode::Tiles)
     rgnToValidate.offset(-m_bounds.origin());
+
+  // Fast path: the whole area is valid already (the source canvas
+  // was already validated above if it's needed).
+  if (m_validDstRegion.contains(rgnToValidate.bounds()) == gfx::Region::In)
+    return;
+
   rgnToValidate.createSubtraction(rgnToValidate, m_validDstRegion);
   rgnToValidate.createIntersection(rgnToValidate, gfx::Region(m_dstImage->bounds()));
 
@@ -78,8 +78,11 @@ public:
 
   gfx::Point getCelOrigin() const;
 
-  Image* getSourceCanvas(); // You can read pixels from here
-  Image* getDestCanvas();   // You can write pixels right here
+  // You can read pixels from here, but only inside regions already
+  // passed to validateSourceCanvas() (the canvas content is undefined
+  // elsewhere, it's materialized lazily region by region).
+  Image* getSourceCanvas();
+  Image* getDestCanvas(); // You can write pixels right here
 
   Tileset* getDestTileset(); // You can use this as a preview-tileset
                              // when the user is editing in "Manual" mode
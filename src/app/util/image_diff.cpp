@@ -0,0 +1,120 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/util/image_diff.h"
+
+#include "app/util/buffer_region.h"
+#include "base/debug.h"
+#include "base/exception.h"
+#include "doc/image.h"
+#include "gfx/point.h"
+
+#include "zlib.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace app {
+
+// Block size of the grid used to compare both images: small enough
+// so a localized edit doesn't save far away pixels, big enough to
+// keep the region and the memcmp() calls coarse.
+static constexpr int kBlockSize = 32;
+
+bool ImageDiff::create(const doc::Image* image, const doc::Image* other)
+{
+  ASSERT(!m_valid);
+  ASSERT(image);
+  ASSERT(other);
+
+  // With different specs (or bitmaps, where pixels aren't
+  // byte-aligned) the diff cannot be applied over a copy of the
+  // other image.
+  if (image->spec() != other->spec() || image->pixelFormat() == doc::IMAGE_BITMAP)
+    return false;
+
+  const int w = image->width();
+  const int h = image->height();
+  const int bpp = image->bytesPerPixel();
+
+  for (int y0 = 0; y0 < h; y0 += kBlockSize) {
+    const int bh = std::min(kBlockSize, h - y0);
+    for (int x0 = 0; x0 < w; x0 += kBlockSize) {
+      const int bw = std::min(kBlockSize, w - x0);
+
+      bool equal = true;
+      for (int y = y0; y < y0 + bh; ++y) {
+        if (std::memcmp(image->getPixelAddress(x0, y), other->getPixelAddress(x0, y), bw * bpp) !=
+            0) {
+          equal = false;
+          break;
+        }
+      }
+      if (!equal)
+        m_region |= gfx::Region(gfx::Rect(x0, y0, bw, bh));
+    }
+  }
+
+  if (!m_region.isEmpty())
+    save_image_region_in_buffer(m_region, image, gfx::Point(0, 0), m_buffer);
+
+  m_valid = true;
+  return true;
+}
+
+doc::ImageRef ImageDiff::apply(const doc::Image* other)
+{
+  ASSERT(m_valid);
+
+  doc::ImageRef result(doc::Image::createCopy(other));
+  if (!m_region.isEmpty()) {
+    uncompressBuffer();
+    swap_image_region_with_buffer(m_region, result.get(), m_buffer);
+  }
+  return result;
+}
+
+void ImageDiff::compress()
+{
+  // Already compressed, or too small to be worth it
+  if (m_rawSize > 0 || m_buffer.size() < 1024)
+    return;
+
+  uLongf outSize = compressBound(m_buffer.size());
+  base::buffer compressed(outSize);
+  if (compress2(compressed.data(), &outSize, m_buffer.data(), m_buffer.size(), Z_BEST_SPEED) !=
+      Z_OK) {
+    return; // Keep the raw pixels
+  }
+  if (outSize >= m_buffer.size())
+    return; // Incompressible data
+
+  compressed.resize(outSize);
+  compressed.shrink_to_fit();
+  m_rawSize = m_buffer.size();
+  m_buffer.swap(compressed);
+}
+
+void ImageDiff::uncompressBuffer()
+{
+  if (m_rawSize == 0)
+    return;
+
+  base::buffer raw(m_rawSize);
+  uLongf outSize = m_rawSize;
+  if (uncompress(raw.data(), &outSize, m_buffer.data(), m_buffer.size()) != Z_OK ||
+      outSize != m_rawSize) {
+    throw base::Exception("Error restoring compressed undo data");
+  }
+  m_buffer.swap(raw);
+  m_rawSize = 0;
+}
+
+} // namespace app
@@ -0,0 +1,61 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_UTIL_IMAGE_DIFF_H_INCLUDED
+#define APP_UTIL_IMAGE_DIFF_H_INCLUDED
+#pragma once
+
+#include "base/buffer.h"
+#include "doc/image_ref.h"
+#include "gfx/region.h"
+
+namespace app {
+
+// Stores the difference between two images with the same specs: the
+// region where they differ (aligned to a grid of 32x32 blocks) and
+// the pixels that one side has inside that region. Undoable commands
+// that replace a whole cel image (cmd::ReplaceImage/SetCelData) use
+// this to avoid keeping a full copy of the replaced image in the
+// undo history when only a small area changed, as the missing side
+// can be recreated from the live one plus the saved pixels.
+class ImageDiff {
+public:
+  // Compares both images and saves the pixels that "image" has
+  // inside the differing region. Returns false if the images don't
+  // have the same specs (in that case the caller must keep a full
+  // copy of the image).
+  bool create(const doc::Image* image, const doc::Image* other);
+
+  bool valid() const { return m_valid; }
+
+  // Returns a copy of "other" with the saved pixels applied in the
+  // differing region. After this call the diff keeps the pixels
+  // that "other" had in the region, so consecutive calls ping-pong
+  // between both sides of the diff (like cmd::CopyRegion between
+  // undo/redo).
+  doc::ImageRef apply(const doc::Image* other);
+
+  size_t memSize() const { return m_buffer.size(); }
+
+  // Deflates the saved pixels when this is part of a cold undo
+  // state (see Cmd::onCompressData()).
+  void compress();
+
+private:
+  void uncompressBuffer();
+
+  bool m_valid = false;
+  gfx::Region m_region;
+  base::buffer m_buffer;
+
+  // Size of the uncompressed m_buffer when it's deflated as a cold
+  // undo state, or 0 if m_buffer contains the raw pixels.
+  size_t m_rawSize = 0;
+};
+
+} // namespace app
+
+#endif
@@ -0,0 +1,120 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/util/index_usage.h"
+
+#include "doc/cel.h"
+#include "doc/cels_range.h"
+#include "doc/image.h"
+#include "doc/image_bits.h"
+#include "doc/layer.h"
+#include "doc/layer_tilemap.h"
+#include "doc/object_version.h"
+#include "doc/sprite.h"
+#include "doc/tileset.h"
+
+#include <bitset>
+#include <unordered_map>
+
+namespace app {
+
+namespace {
+
+struct ImageUsage {
+  doc::ObjectVersion version;
+  std::bitset<256> used;
+};
+
+// Cache of used palette indices per indexed image, keyed by image id
+// and validated with the image version, so only the images modified
+// since the last query are re-scanned (during a color drag the images
+// don't change at all and every preview hits the cache).
+std::unordered_map<doc::ObjectId, ImageUsage> g_cache;
+
+const std::bitset<256>& image_usage(const doc::Image* image)
+{
+  auto it = g_cache.find(image->id());
+  if (it != g_cache.end() && it->second.version == image->version())
+    return it->second.used;
+
+  // Don't let images of already closed sprites grow the cache
+  // forever.
+  if (g_cache.size() > 4096)
+    g_cache.clear();
+
+  ImageUsage& usage = g_cache[image->id()];
+  usage.version = image->version();
+  usage.used.reset();
+  for (const auto& i : doc::LockImageBits<doc::IndexedTraits>(image))
+    usage.used[i] = true;
+  return usage.used;
+}
+
+bool uses_range(const std::bitset<256>& used, const int fromIndex, const int toIndex)
+{
+  for (int i = fromIndex; i <= toIndex && i < 256; ++i) {
+    if (used[i])
+      return true;
+  }
+  return false;
+}
+
+} // anonymous namespace
+
+bool get_cels_region_using_indices(const doc::Sprite* sprite,
+                                   const doc::frame_t frame,
+                                   const int fromIndex,
+                                   const int toIndex,
+                                   gfx::Region& rgn)
+{
+  if (fromIndex < 0 || toIndex < fromIndex)
+    return false;
+
+  for (const doc::Cel* cel : sprite->cels(frame)) {
+    if (!cel->layer()->isVisibleHierarchy() || !cel->image())
+      continue;
+
+    const doc::Image* image = cel->image();
+    bool uses = false;
+
+    switch (image->pixelFormat()) {
+      case IMAGE_INDEXED: uses = uses_range(image_usage(image), fromIndex, toIndex); break;
+
+      case IMAGE_TILEMAP: {
+        // A tilemap cel shows pixels of its tileset, so we check the
+        // usage of the whole tileset (slightly conservative: tiles
+        // not placed in this cel count too).
+        ASSERT(cel->layer()->isTilemap());
+        const doc::Tileset* tileset = static_cast<doc::LayerTilemap*>(cel->layer())->tileset();
+        if (!tileset)
+          return false;
+        for (doc::tile_index ti = 0; ti < tileset->size(); ++ti) {
+          doc::ImageRef tile = tileset->get(ti);
+          if (tile && uses_range(image_usage(tile.get()), fromIndex, toIndex)) {
+            uses = true;
+            break;
+          }
+        }
+        break;
+      }
+
+      default:
+        // Non-indexed pixels, we don't know how the palette affects
+        // this cel.
+        return false;
+    }
+
+    if (uses)
+      rgn |= gfx::Region(cel->bounds());
+  }
+  return true;
+}
+
+} // namespace app
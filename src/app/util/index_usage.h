@@ -0,0 +1,35 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_UTIL_INDEX_USAGE_H_INCLUDED
+#define APP_UTIL_INDEX_USAGE_H_INCLUDED
+#pragma once
+
+#include "doc/frame.h"
+#include "gfx/region.h"
+
+namespace doc {
+class Sprite;
+}
+
+namespace app {
+
+// Returns true if the palette index usage of all the visible cels in
+// the given frame is known, filling "rgn" (canvas coordinates) with
+// the bounds of the cels that use some index in the [fromIndex,
+// toIndex] range. The per-image usage bitmap is cached and validated
+// with the image version, so after the first scan only modified
+// images are re-read. Returns false when the usage cannot be
+// determined and the caller must assume that every cel is affected.
+bool get_cels_region_using_indices(const doc::Sprite* sprite,
+                                   const doc::frame_t frame,
+                                   const int fromIndex,
+                                   const int toIndex,
+                                   gfx::Region& rgn);
+
+} // namespace app
+
+#endif
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024 Igara Studio S.A.
+// Copyright (C) 2019-2026 Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -13,6 +13,7 @@
 
 #include "app/doc.h"
 #include "app/site.h"
+#include "app/util/tuning.h"
 #include "doc/image.h"
 #include "doc/layer.h"
 #include "doc/mask.h"
@@ -57,8 +58,15 @@ doc::Image* new_image_from_mask(const Site& site,
   if (merged || site.layer()->isTilemap()) {
     render::Render render;
     render.setNewBlend(newBlend);
-    if (merged)
+    if (merged) {
+      // Merging all layers of a big selection is a full compositing
+      // pass, so use the tile-parallel renderer with the tile size
+      // calibrated for this machine (small areas keep the
+      // single-threaded path anyway).
+      render.setTileParallelism(true);
+      render.setTileSize(tuned_tile_size());
       render.renderSprite(dst.get(), srcSprite, site.frame(), gfx::Clip(0, 0, srcBounds));
+    }
     else {
       ASSERT(site.layer()->isTilemap());
       if (auto cel = site.cel()) {
@@ -10,6 +10,7 @@
 
 #include "app/commands/cmd_open_file.h"
 #include "app/context.h"
+#include "app/util/open_file_job.h"
 
 namespace app {
 
@@ -48,6 +49,21 @@ public:
       m_lastDecision = d;
   }
 
+  // Starts decoding the given files in background jobs, so following
+  // open() calls for them can take the already loaded documents
+  // instead of decoding one file at a time (used by the CLI in batch
+  // mode to open several files concurrently).
+  void prefetch(Context* ctx, const base::paths& filenames, const bool oneFrame)
+  {
+    const int flags = OpenFileCommand::loadDocumentFlags(
+      !oneFrame && m_lastDecision == gen::SequenceDecision::ASK,
+      oneFrame ? gen::SequenceDecision::NO : m_lastDecision,
+      oneFrame);
+
+    for (const auto& fn : filenames)
+      OpenFilePrefetch::instance()->start(ctx, fn, flags);
+  }
+
   const base::paths& usedFiles() const { return m_cmd.usedFiles(); }
 
 private:
@@ -1,11 +1,19 @@
 // Aseprite
-// Copyright (C) 2025  Igara Studio S.A.
+// Copyright (C) 2025-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
 
 #include "app/util/open_file_job.h"
 
+#include "app/doc.h"
+#include "app/job_scheduler.h"
+#include "app/util/conversion_to_surface.h"
+#include "doc/image.h"
+#include "os/surface.h"
+#include "os/system.h"
+#include "ui/alert.h"
+
 namespace app {
 
 void OpenFileJob::showProgressWindow()
@@ -34,4 +42,118 @@ void OpenFileJob::onJob()
   m_fop->done();
 }
 
+void OpenFileJob::onMonitoringTick()
+{
+  Job::onMonitoringTick();
+
+  // The decoder publishes a downsampled composite of the first frame
+  // while the rest of the file is still being loaded, show it as soon
+  // as it's available so the user sees the sprite content instead of
+  // just a progress bar.
+  if (m_previewShown)
+    return;
+
+  ui::Alert* alert = alertWindow();
+  if (!alert)
+    return;
+
+  const doc::ImageRef preview = m_fop->loadingPreviewImage();
+  if (!preview)
+    return;
+
+  os::SurfaceRef surface =
+    os::System::instance()->makeRgbaSurface(preview->width(), preview->height());
+  convert_image_to_surface(preview.get(),
+                           nullptr,
+                           surface.get(),
+                           0,
+                           0,
+                           0,
+                           0,
+                           preview->width(),
+                           preview->height());
+  alert->addImage(surface);
+  m_previewShown = true;
+}
+
+// static
+OpenFilePrefetch* OpenFilePrefetch::instance()
+{
+  static OpenFilePrefetch* prefetch = new OpenFilePrefetch;
+  return prefetch;
+}
+
+void OpenFilePrefetch::start(Context* ctx, const std::string& filename, const int flags)
+{
+  {
+    const std::lock_guard lock(m_mutex);
+    if (m_entries.find(filename) != m_entries.end())
+      return;
+  }
+
+  std::unique_ptr<FileOp> fop(FileOp::createLoadDocumentOperation(ctx, filename, flags));
+  if (!fop)
+    return;
+
+  FileOp* rawFop = fop.get();
+  const bool hasError = fop->hasError();
+  {
+    const std::lock_guard lock(m_mutex);
+    Entry& entry = m_entries[filename];
+    entry.fop = std::move(fop);
+    entry.flags = flags;
+    // Don't decode files that failed to be found/detected, take()
+    // will return the operation with its creation error.
+    entry.done = hasError;
+  }
+  if (hasError)
+    return;
+
+  JobScheduler::instance()->submitJob([this, rawFop, filename] {
+    try {
+      rawFop->operate();
+    }
+    catch (const std::exception& e) {
+      rawFop->setError("Error loading file:\n%s", e.what());
+    }
+    rawFop->done();
+
+    {
+      const std::lock_guard lock(m_mutex);
+      auto it = m_entries.find(filename);
+      if (it != m_entries.end())
+        it->second.done = true;
+    }
+    m_condition.notify_all();
+  });
+}
+
+std::unique_ptr<FileOp> OpenFilePrefetch::take(const std::string& filename, const int flags)
+{
+  std::unique_lock lock(m_mutex);
+
+  auto it = m_entries.find(filename);
+  if (it == m_entries.end() || it->second.flags != flags)
+    return nullptr;
+
+  // Wait for the background job to finish decoding this file.
+  m_condition.wait(lock, [&] { return it->second.done; });
+
+  std::unique_ptr<FileOp> fop = std::move(it->second.fop);
+  m_entries.erase(it);
+  return fop;
+}
+
+void OpenFilePrefetch::clear()
+{
+  std::unique_lock lock(m_mutex);
+
+  for (auto& it : m_entries) {
+    m_condition.wait(lock, [&] { return it.second.done; });
+    if (it.second.fop && it.second.fop->document())
+      delete it.second.fop->releaseDocument();
+  }
+  m_entries.clear();
+}
+
 } // namespace app
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2024-2025  Igara Studio S.A.
+// Copyright (C) 2024-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -12,6 +12,12 @@
 #include "app/i18n/strings.h"
 #include "app/job.h"
 
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
 namespace app {
 
 class OpenFileJob : public Job,
@@ -29,9 +35,54 @@ private:
   // Thread to do the hard work: load the file from the disk.
   virtual void onJob() override;
 
+  // Besides updating the progress bar, shows the downsampled
+  // first-frame preview published by the decoder (see
+  // FileOp::makeLoadingPreviewImage()) as soon as it's available.
+  virtual void onMonitoringTick() override;
+
   virtual void ackFileOpProgress(double progress) override { jobProgress(progress); }
 
   FileOp* m_fop;
+  bool m_previewShown = false;
+};
+
+// Background decoding of a batch of files that are about to be
+// opened. Each FileOp is created serially in the caller thread (where
+// sequence detection and user questions can happen) and its operate()
+// step (the actual file decoding) runs in a job scheduler job, so
+// opening several files from the CLI saturates the CPU cores. The job
+// pool works as a shared I/O budget: at most JobScheduler::threads()
+// files are being read/decoded at the same time.
+class OpenFilePrefetch {
+public:
+  static OpenFilePrefetch* instance();
+
+  // Creates the FileOp for the given file and starts decoding it in
+  // a background job. Does nothing if the file is already being
+  // prefetched.
+  void start(Context* ctx, const std::string& filename, const int flags);
+
+  // Returns the decoded operation for the given file if it was
+  // prefetched with the same flags (waiting for the background job if
+  // it's still in progress), or nullptr if the file has to be loaded
+  // by the caller.
+  std::unique_ptr<FileOp> take(const std::string& filename, const int flags);
+
+  // Waits for any decoding job in progress and discards the
+  // operations that were never taken (e.g. files that were consumed
+  // as part of an image sequence), deleting their loaded documents.
+  void clear();
+
+private:
+  struct Entry {
+    std::unique_ptr<FileOp> fop;
+    int flags = 0;
+    bool done = false;
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::map<std::string, Entry> m_entries;
 };
 
 } // namespace app
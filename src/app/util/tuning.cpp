@@ -0,0 +1,91 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "app/util/tuning.h"
+
+#include "app/pref/preferences.h"
+#include "base/chrono.h"
+#include "doc/blend_mode.h"
+#include "doc/blend_rows.h"
+#include "doc/color.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace app {
+
+namespace {
+
+// Measures how many RGBA pixels per millisecond this machine blends
+// with the row kernel used by the compositing hot loop.
+double blend_throughput()
+{
+  constexpr int kRowSize = 4096;
+  std::vector<doc::color_t> src(kRowSize, doc::rgba(130, 90, 40, 128));
+  std::vector<doc::color_t> dst(kRowSize, doc::rgba(30, 30, 30, 255));
+
+  const doc::BlendRowFunc blender = doc::get_rgba_row_blender(doc::BlendMode::NORMAL, true);
+
+  // Bounded to a couple of milliseconds so the calibration is
+  // invisible at startup (the first iterations also warm the caches,
+  // which matches the steady state of a real render).
+  base::Chrono chrono;
+  double rows = 0.0;
+  do {
+    for (int i = 0; i < 16; ++i, rows += 1.0)
+      blender(&dst[0], &src[0], kRowSize, 128, 0);
+  } while (chrono.elapsed() < 0.002);
+
+  return rows * kRowSize / (chrono.elapsed() * 1000.0);
+}
+
+int calibrate_tile_size()
+{
+  // A tile should take some milliseconds to compose: enough work to
+  // amortize the task dispatch, small enough that the pool can still
+  // balance the load between workers.
+  constexpr double kTargetMSecs = 2.0;
+  const double pixels = blend_throughput() * kTargetMSecs;
+
+  int side = 128;
+  while (side < 1024 && double(2 * side) * double(2 * side) <= pixels)
+    side *= 2;
+  return side;
+}
+
+} // anonymous namespace
+
+int tuned_worker_count()
+{
+  const int userValue = Preferences::instance().performance.workerThreads();
+  if (userValue > 0)
+    return std::clamp(userValue, 1, 256);
+
+  return std::max<int>(2, std::thread::hardware_concurrency());
+}
+
+int tuned_tile_size()
+{
+  auto& pref = Preferences::instance();
+
+  const int userValue = pref.performance.renderTileSize();
+  if (userValue > 0)
+    return std::clamp(userValue, 64, 2048);
+
+  int tileSize = pref.performance.calibratedTileSize();
+  if (tileSize == 0) {
+    tileSize = calibrate_tile_size();
+    pref.performance.calibratedTileSize(tileSize);
+  }
+  return tileSize;
+}
+
+} // namespace app
@@ -0,0 +1,29 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef APP_UTIL_TUNING_H_INCLUDED
+#define APP_UTIL_TUNING_H_INCLUDED
+#pragma once
+
+namespace app {
+
+// Number of workers that parallel subsystems (thread pools used to
+// process cels/frames/tiles) should use: one per CPU core, unless the
+// user overrides it with the performance.worker_threads preference.
+int tuned_worker_count();
+
+// Tile side (in pixels) for tile-parallel rendering. The first call
+// runs a short calibration that measures the blending throughput of
+// this machine and picks a tile that takes a few milliseconds to
+// compose, so slow machines get smaller tiles (better load balancing)
+// and fast machines get bigger ones (less scheduling overhead). The
+// result is saved in preferences so the calibration runs only once;
+// the performance.render_tile_size preference overrides everything.
+int tuned_tile_size();
+
+} // namespace app
+
+#endif
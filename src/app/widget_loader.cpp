@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This program is distributed under the terms of
@@ -99,8 +99,7 @@ Widget* WidgetLoader::loadWidgetFromXmlFile(const std::string& xmlFilename,
   m_tooltipManager = NULL;
   m_xmlTranslator.setStringIdPrefix(widgetId.c_str());
 
-  XMLDocumentRef doc = open_xml(xmlFilename);
-  XMLHandle handle(doc.get());
+  XMLHandle handle(open_xml_cached(xmlFilename));
 
   // Search the requested widget.
   XMLElement* xmlElement = handle.FirstChildElement("gui").FirstChildElement().ToElement();
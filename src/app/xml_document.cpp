@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This program is distributed under the terms of
@@ -13,9 +13,13 @@
 
 #include "app/xml_exception.h"
 #include "base/file_handle.h"
+#include "base/fs.h"
+#include "base/time.h"
 
 #include "tinyxml2.h"
 
+#include <map>
+
 namespace app {
 
 using namespace base;
@@ -35,6 +39,26 @@ XMLDocumentRef open_xml(const std::string& filename)
   return doc;
 }
 
+XMLDocument* open_xml_cached(const std::string& filename)
+{
+  struct CachedXml {
+    base::Time mtime;
+    XMLDocumentRef doc;
+  };
+  // Used from the UI thread only.
+  static std::map<std::string, CachedXml> cache;
+
+  const base::Time mtime = base::get_modification_time(filename);
+  auto it = cache.find(filename);
+  if (it != cache.end() && it->second.mtime == mtime)
+    return it->second.doc.get();
+
+  XMLDocumentRef doc = open_xml(filename);
+  XMLDocument* result = doc.get();
+  cache[filename] = CachedXml{ mtime, std::move(doc) };
+  return result;
+}
+
 void save_xml(XMLDocument* doc, const std::string& filename)
 {
   FileHandle file(open_file(filename, "wb"));
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This program is distributed under the terms of
@@ -21,6 +21,15 @@ namespace app {
 using XMLDocumentRef = std::unique_ptr<tinyxml2::XMLDocument>;
 
 XMLDocumentRef open_xml(const std::string& filename);
+
+// Returns a shared read-only document for the given file. Parsed
+// documents are cached by filename and re-parsed only when the file
+// modification time changes, so XMLs that are loaded several times
+// (widget definitions on each dialog creation, theme XMLs on each
+// regeneration, etc.) skip the disk access and the parsing. The
+// returned document is owned by the cache and must not be modified.
+tinyxml2::XMLDocument* open_xml_cached(const std::string& filename);
+
 void save_xml(tinyxml2::XMLDocument* doc, const std::string& filename);
 
 bool bool_attr(const tinyxml2::XMLElement* elem, const char* attrName, bool defaultVal);
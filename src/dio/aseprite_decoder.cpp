@@ -1,5 +1,5 @@
 // Aseprite Document IO Library
-// Copyright (c) 2018-2025 Igara Studio S.A.
+// Copyright (c) 2018-2026 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,6 +11,7 @@
 
 #include "dio/aseprite_decoder.h"
 
+#include "base/buffer.h"
 #include "base/cfile.h"
 #include "base/exception.h"
 #include "base/file_handle.h"
@@ -27,6 +28,7 @@
 #include "gfx/color_space.h"
 #include "zlib.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <vector>
 
@@ -92,8 +94,14 @@ bool AsepriteDecoder::decode()
 
   // Just one frame?
   doc::frame_t nframes = sprite->totalFrames();
-  if (nframes > 1 && delegate()->decodeOneFrame())
-    nframes = 1;
+  doc::frame_t onlyFrame = -1;
+  if (nframes > 1 && delegate()->decodeOneFrame()) {
+    onlyFrame = std::clamp(delegate()->frameToDecode(), doc::frame_t(0), doc::frame_t(nframes - 1));
+    nframes = onlyFrame + 1;
+  }
+
+  // File offset of each frame (from the frame index chunk, if any)
+  std::vector<size_t> frameOffsets;
 
   // Read frame by frame to end-of-file
   for (doc::frame_t frame = 0; frame < nframes; ++frame) {
@@ -111,8 +119,14 @@ bool AsepriteDecoder::decode()
       if (frame_header.duration > 0)
         sprite->setFrameDuration(frame, frame_header.duration);
 
+      // When we look for one specific frame we parse only the first
+      // frame (which contains the sprite structure: layers, tags,
+      // tilesets, etc.) and the wanted frame, the other frame bodies
+      // are skipped.
+      const bool parseChunks = (onlyFrame < 0 || frame == 0 || frame == onlyFrame);
+
       // Read chunks
-      for (uint32_t c = 0; c < frame_header.chunks; c++) {
+      for (uint32_t c = 0; parseChunks && c < frame_header.chunks; c++) {
         // Start chunk position
         size_t chunk_pos = f()->tell();
         delegate()->progress((float)chunk_pos / (float)header.size);
@@ -285,6 +299,8 @@ bool AsepriteDecoder::decode()
             break;
           }
 
+          case ASE_FILE_CHUNK_FRAME_INDEX: readFrameIndexChunk(frameOffsets); break;
+
           default:
             delegate()->incompatibilityError(
               fmt::format("Warning: Unsupported chunk type {0} (skipping)", chunk_type));
@@ -294,11 +310,23 @@ bool AsepriteDecoder::decode()
         // Skip chunk size
         f()->seek(chunk_pos + chunk_size);
       }
+
+      if (parseChunks)
+        delegate()->onFrameDecoded(sprite.get(), frame);
     }
 
     // Skip frame size
     f()->seek(frame_pos + frame_header.size);
 
+    // Seek directly to the wanted frame if the file contains a frame
+    // index (files without the index just skip the in-between frame
+    // headers one by one in this same loop).
+    if (frame == 0 && onlyFrame > 0 && onlyFrame < doc::frame_t(frameOffsets.size()) &&
+        frameOffsets[onlyFrame] > 0) {
+      f()->seek(frameOffsets[onlyFrame]);
+      frame = onlyFrame - 1; // The for() increments it to onlyFrame
+    }
+
     if (delegate()->isCanceled())
       break;
   }
@@ -643,14 +671,24 @@ void read_raw_image_templ(FileInterface* f,
                           const AsepriteHeader* header)
 {
   PixelIO<ImageTraits> pixel_io;
-  int x, y;
-  int w = image->width();
-  int h = image->height();
-
-  for (y = 0; y < h; ++y) {
-    for (x = 0; x < w; ++x) {
-      doc::put_pixel_fast<ImageTraits>(image, x, y, pixel_io.read_pixel(f));
+  const int w = image->width();
+  const int h = image->height();
+
+  // One readBytes() per row + a buffered conversion, instead of one
+  // virtual read8() call per color component of each pixel (the
+  // scanline has the same layout in the file and in doc::Image, see
+  // PixelIO::read_scanline()).
+  std::vector<uint8_t> scanline(image->widthBytes());
+  for (int y = 0; y < h; ++y) {
+    const size_t bytes_read = f->readBytes(&scanline[0], scanline.size());
+    if (bytes_read < scanline.size()) {
+      // Broken file, complete the row with zeros (as read8() returns
+      // 0 on EOF).
+      std::fill(scanline.begin() + bytes_read, scanline.end(), uint8_t(0));
     }
+    pixel_io.read_scanline((typename ImageTraits::address_t)image->getPixelAddress(0, y),
+                           w,
+                           &scanline[0]);
     delegate->progress((float)f->tell() / (float)header->size);
   }
 }
@@ -909,12 +947,26 @@ doc::Cel* AsepriteDecoder::readCelChunk(doc::Sprite* sprite,
 
       if (w > 0 && h > 0) {
         doc::ImageRef image(doc::Image::create(pixelFormat, w, h));
+
+        // Keep the compressed pixel data as-is so the client can save
+        // it back verbatim if the image is not modified (same as the
+        // cacheCompressedTilesets() path in readTilesetChunk()).
+        base::buffer compressed;
+        const size_t dataBeg = f()->tell();
+        if (delegate()->cacheCompressedCels() && chunk_end > dataBeg) {
+          compressed.resize(chunk_end - dataBeg);
+          f()->readBytes(&compressed[0], compressed.size());
+          f()->seek(dataBeg);
+        }
+
         read_compressed_image(f(), delegate(), image.get(), header, chunk_end);
 
         cel = std::make_unique<doc::Cel>(frame, image);
         cel->setPosition(x, y);
         cel->setOpacity(opacity);
         cel->setZIndex(zIndex);
+        if (!compressed.empty())
+          cel->setCompressedData(compressed);
       }
       break;
     }
@@ -1174,6 +1226,19 @@ void AsepriteDecoder::readUserDataChunk(doc::UserData* userData,
   }
 }
 
+void AsepriteDecoder::readFrameIndexChunk(std::vector<size_t>& frameOffsets)
+{
+  uint32_t nframes = read32();
+
+  frameOffsets.clear();
+  frameOffsets.reserve(nframes);
+  for (uint32_t i = 0; i < nframes && f()->ok(); ++i) {
+    // An offset can be zero if the file was truncated while saving
+    // (in that case we just don't use that index entry).
+    frameOffsets.push_back(read32());
+  }
+}
+
 void AsepriteDecoder::readSlicesChunk(doc::Slices& slices)
 {
   size_t nslices = read32(); // Number of slices
@@ -1,5 +1,5 @@
 // Aseprite Document IO Library
-// Copyright (c) 2023 Igara Studio S.A.
+// Copyright (c) 2023-2026 Igara Studio S.A.
 // Copyright (c) 2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -38,6 +38,22 @@ public:
   // to generate a thumbnail)
   virtual bool decodeOneFrame() { return false; }
 
+  // When decodeOneFrame() is true, indicates which frame should be
+  // decoded (the first frame by default). Frames in between are
+  // skipped (directly with one seek if the file contains a
+  // frame-offset index chunk). Note that palette changes and linked
+  // cels of the skipped frames are not loaded.
+  virtual doc::frame_t frameToDecode() { return 0; }
+
+  // Called when all the chunks of the given frame were processed (so
+  // the sprite already contains the cels/palettes of that frame),
+  // while the rest of the file is still being decoded. Progressive
+  // consumers can use it e.g. to show a preview of the first frame as
+  // soon as possible. The sprite is not mutated during this call, but
+  // it's still owned by the decoder (don't keep the pointer, wait for
+  // onSprite()).
+  virtual void onFrameDecoded(doc::Sprite* sprite, doc::frame_t frame) {}
+
   // Default color for slices without user data
   virtual doc::color_t defaultSliceColor() { return doc::rgba(0, 0, 255, 255); }
 
@@ -53,6 +69,10 @@ public:
   // tilesets exactly as they are in the disk (so we can save it
   // without re-compressing).
   virtual bool cacheCompressedTilesets() const { return false; }
+
+  // Same thing for the compressed pixel data of each cel (kept in
+  // doc::Cel::compressedData() to re-save unmodified cels verbatim).
+  virtual bool cacheCompressedCels() const { return false; }
 };
 
 } // namespace dio
@@ -0,0 +1,155 @@
+// Aseprite Document IO Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "dio/mapped_file_interface.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+  #include "base/win/win32_exception.h"
+
+  #include <windows.h>
+
+  #include "base/string.h"
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace dio {
+
+MappedFileInterface::MappedFileInterface(const std::string& filename)
+{
+#ifdef _WIN32
+  std::wstring wfn = base::from_utf8(filename);
+  HANDLE file = CreateFileW(wfn.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    CloseHandle(file);
+    return;
+  }
+
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    CloseHandle(file);
+    return;
+  }
+
+  const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!data) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return;
+  }
+
+  m_file = file;
+  m_mapping = mapping;
+  m_data = (const uint8_t*)data;
+  m_size = size_t(size.QuadPart);
+  m_ok = true;
+#else
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || st.st_size == 0) {
+    close(fd);
+    return;
+  }
+
+  void* data = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) {
+    close(fd);
+    return;
+  }
+
+  m_fd = fd;
+  m_data = (const uint8_t*)data;
+  m_size = size_t(st.st_size);
+  m_ok = true;
+#endif
+}
+
+MappedFileInterface::~MappedFileInterface()
+{
+#ifdef _WIN32
+  if (m_data)
+    UnmapViewOfFile((LPCVOID)m_data);
+  if (m_mapping)
+    CloseHandle((HANDLE)m_mapping);
+  if (m_file)
+    CloseHandle((HANDLE)m_file);
+#else
+  if (m_data)
+    munmap((void*)m_data, m_size);
+  if (m_fd >= 0)
+    close(m_fd);
+#endif
+}
+
+bool MappedFileInterface::ok() const
+{
+  return m_ok;
+}
+
+size_t MappedFileInterface::tell()
+{
+  return m_pos;
+}
+
+void MappedFileInterface::seek(size_t absPos)
+{
+  // Like fseek(), seeking beyond EOF is not an error by itself;
+  // following reads will fail.
+  m_pos = absPos;
+}
+
+uint8_t MappedFileInterface::read8()
+{
+  if (m_pos < m_size)
+    return m_data[m_pos++];
+
+  m_ok = false;
+  return 0;
+}
+
+size_t MappedFileInterface::readBytes(uint8_t* buf, size_t n)
+{
+  if (m_pos >= m_size) {
+    m_ok = false;
+    return 0;
+  }
+  const size_t available = std::min(n, m_size - m_pos);
+  std::memcpy(buf, m_data + m_pos, available);
+  m_pos += available;
+  if (available < n)
+    m_ok = false;
+  return available;
+}
+
+void MappedFileInterface::write8(uint8_t)
+{
+  m_ok = false; // Read-only interface
+}
+
+} // namespace dio
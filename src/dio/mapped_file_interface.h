@@ -0,0 +1,56 @@
+// Aseprite Document IO Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef DIO_MAPPED_FILE_INTERFACE_H_INCLUDED
+#define DIO_MAPPED_FILE_INTERFACE_H_INCLUDED
+#pragma once
+
+#include "dio/file_interface.h"
+
+#include <string>
+
+namespace dio {
+
+// Read-only FileInterface backed by a memory-mapped file: header
+// fields are decoded straight from the mapping without per-byte stdio
+// calls, and the OS pages file content in on demand instead of
+// reading it all upfront.
+class MappedFileInterface : public FileInterface {
+public:
+  MappedFileInterface(const std::string& filename);
+  ~MappedFileInterface();
+
+  MappedFileInterface(const MappedFileInterface&) = delete;
+  MappedFileInterface& operator=(const MappedFileInterface&) = delete;
+
+  bool ok() const override;
+  size_t tell() override;
+  void seek(size_t absPos) override;
+  uint8_t read8() override;
+  size_t readBytes(uint8_t* buf, size_t n) override;
+  void write8(uint8_t value) override; // Not supported (read-only)
+
+  // Direct access to the mapped bytes (zero-copy consumers, e.g.
+  // feeding a whole compressed cel chunk to zlib).
+  const uint8_t* data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+private:
+  const uint8_t* m_data = nullptr;
+  size_t m_size = 0;
+  size_t m_pos = 0;
+  bool m_ok = false;
+#ifdef _WIN32
+  void* m_file = nullptr;
+  void* m_mapping = nullptr;
+#else
+  int m_fd = -1;
+#endif
+};
+
+} // namespace dio
+
+#endif
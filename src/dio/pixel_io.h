@@ -1,5 +1,5 @@
 // Aseprite Document IO Library
-// Copyright (c) 2019 Igara Studio S.A.
+// Copyright (c) 2019-2026 Igara Studio S.A.
 // Copyright (c) 2017-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -47,21 +47,19 @@ public:
   }
   void read_scanline(doc::RgbTraits::address_t address, int w, uint8_t* buffer)
   {
-    for (int x = 0; x < w; ++x, ++address) {
-      r = *(buffer++);
-      g = *(buffer++);
-      b = *(buffer++);
-      a = *(buffer++);
-      *address = doc::rgba(r, g, b, a);
-    }
+    // Without state between iterations (contrast with the member
+    // variables used by read_pixel()) the compiler can vectorize
+    // this shuffle.
+    for (int x = 0; x < w; ++x, ++address, buffer += 4)
+      *address = doc::rgba(buffer[0], buffer[1], buffer[2], buffer[3]);
   }
   void write_scanline(doc::RgbTraits::address_t address, int w, uint8_t* buffer)
   {
-    for (int x = 0; x < w; ++x, ++address) {
-      *(buffer++) = doc::rgba_getr(*address);
-      *(buffer++) = doc::rgba_getg(*address);
-      *(buffer++) = doc::rgba_getb(*address);
-      *(buffer++) = doc::rgba_geta(*address);
+    for (int x = 0; x < w; ++x, ++address, buffer += 4) {
+      buffer[0] = doc::rgba_getr(*address);
+      buffer[1] = doc::rgba_getg(*address);
+      buffer[2] = doc::rgba_getb(*address);
+      buffer[3] = doc::rgba_geta(*address);
     }
   }
 };
@@ -84,17 +82,14 @@ public:
   }
   void read_scanline(doc::GrayscaleTraits::address_t address, int w, uint8_t* buffer)
   {
-    for (int x = 0; x < w; ++x, ++address) {
-      k = *(buffer++);
-      a = *(buffer++);
-      *address = doc::graya(k, a);
-    }
+    for (int x = 0; x < w; ++x, ++address, buffer += 2)
+      *address = doc::graya(buffer[0], buffer[1]);
   }
   void write_scanline(doc::GrayscaleTraits::address_t address, int w, uint8_t* buffer)
   {
-    for (int x = 0; x < w; ++x, ++address) {
-      *(buffer++) = doc::graya_getv(*address);
-      *(buffer++) = doc::graya_geta(*address);
+    for (int x = 0; x < w; ++x, ++address, buffer += 2) {
+      buffer[0] = doc::graya_getv(*address);
+      buffer[1] = doc::graya_geta(*address);
     }
   }
 };
@@ -116,8 +111,6 @@ public:
 
 template<>
 class PixelIO<doc::TilemapTraits> {
-  int b1, b2, b3, b4;
-
 public:
   doc::TilemapTraits::pixel_t read_pixel(FileInterface* f)
   {
@@ -135,13 +128,9 @@ public:
   }
   void read_scanline(doc::TilemapTraits::address_t address, int w, uint8_t* buffer)
   {
-    for (int x = 0; x < w; ++x, ++address) {
-      b1 = *(buffer++);
-      b2 = *(buffer++);
-      b3 = *(buffer++);
-      b4 = *(buffer++);
-      *address = ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
-    }
+    // Little endian
+    for (int x = 0; x < w; ++x, ++address, buffer += 4)
+      *address = ((buffer[3] << 24) | (buffer[2] << 16) | (buffer[1] << 8) | buffer[0]);
   }
 };
 
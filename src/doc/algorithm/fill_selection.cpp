@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2020 Igara Studio S.A.
+// Copyright (c) 2020-2026 Igara Studio S.A.
 // Copyright (c) 2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -37,22 +37,34 @@ void fill_selection(Image* image,
   auto it = maskBits.begin();
 
   for (int v = 0; v < rc.h; ++v) {
+    const int y = v + rc.y - imageBounds.y;
+    int start = -1;
+
     for (int u = 0; u < rc.w; ++u, ++it) {
       ASSERT(it != maskBits.end());
-      if (*it) {
-        gfx::Point pt(u + rc.x, v + rc.y);
 
-        if (grid) {
-          pt = grid->canvasToTile(pt);
-        }
-        else {
-          pt -= imageBounds.origin();
+      // Tilemaps go pixel-by-pixel (canvasToTile() is not linear)
+      if (grid) {
+        if (*it) {
+          const gfx::Point pt = grid->canvasToTile(gfx::Point(u + rc.x, v + rc.y));
+          put_pixel(image, pt.x, pt.y, color);
         }
+        continue;
+      }
 
-        // TODO use iterator
-        put_pixel(image, pt.x, pt.y, color);
+      // In other case we can fill each continuous run of selected
+      // pixels with one fill_rect() (it clips to the image bounds)
+      if (*it) {
+        if (start < 0)
+          start = u;
+      }
+      else if (start >= 0) {
+        fill_rect(image, start + rc.x - imageBounds.x, y, u - 1 + rc.x - imageBounds.x, y, color);
+        start = -1;
       }
     }
+    if (!grid && start >= 0)
+      fill_rect(image, start + rc.x - imageBounds.x, y, rc.w - 1 + rc.x - imageBounds.x, y, color);
   }
 
   ASSERT(it == maskBits.end());
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2023 Igara Studio S.A.
+// Copyright (c) 2023-2026 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,6 +11,7 @@
 
 #include "doc/algorithm/flip_image.h"
 
+#include "base/thread_pool.h"
 #include "doc/dispatch.h"
 #include "doc/image.h"
 #include "doc/mask.h"
@@ -19,12 +20,54 @@
 #include "gfx/rect.h"
 
 #include <algorithm>
+#include <cstring>
 #include <memory>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#if defined(__x86_64__) || defined(_WIN64)
+  #include <emmintrin.h>
+#endif
+
 namespace doc { namespace algorithm {
 
+namespace {
+
+base::thread_pool& flip_pool()
+{
+  static base::thread_pool pool(std::max<int>(2, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+// Runs fn(y0, y1) over horizontal bands of the [fromY, toY) rows in
+// parallel when there is enough work ("rowBytes" = bytes moved per
+// row). Sprite > Flip runs this for every cel of every frame, so big
+// sprites get all the cores.
+template<typename Fn>
+void for_each_row_band(const int fromY, const int toY, const int rowBytes, const Fn& fn)
+{
+  const int rows = toY - fromY;
+  const int threads = std::max<int>(2, std::thread::hardware_concurrency());
+  const int minRowsPerBand = std::max(1, 256 * 1024 / std::max(1, rowBytes));
+  const int nbands = std::clamp(rows / minRowsPerBand, 1, threads);
+  if (nbands <= 1) {
+    fn(fromY, toY);
+    return;
+  }
+
+  auto& pool = flip_pool();
+  const int bandHeight = rows / nbands;
+  for (int i = 0; i < nbands; ++i) {
+    const int y0 = fromY + i * bandHeight;
+    const int y1 = (i == nbands - 1 ? toY : y0 + bandHeight);
+    pool.execute([&fn, y0, y1] { fn(y0, y1); });
+  }
+  pool.wait_all();
+}
+
+} // anonymous namespace
+
 template<typename ImageTraits>
 void flip_image_with_put_pixel_fast_templ(Image* image, const gfx::Rect& bounds, FlipType flipType)
 {
@@ -74,30 +117,51 @@ void flip_image_with_rawptr_templ(Image* image, const gfx::Rect& bounds, FlipTyp
 {
   using address_t = typename ImageTraits::address_t;
 
+  const int rowBytes = bounds.w * ImageTraits::bytes_per_pixel;
+
   switch (flipType) {
     case FlipHorizontal:
-      for (int y = bounds.y; y < bounds.y2(); ++y) {
-        const int n = bounds.w / 2;
-        auto l = (address_t)image->getPixelAddress(bounds.x, y);
-        auto r = (address_t)image->getPixelAddress(bounds.x2() - 1, y);
+      for_each_row_band(bounds.y, bounds.y2(), rowBytes, [image, &bounds](int fromY, int toY) {
+        for (int y = fromY; y < toY; ++y) {
+          int n = bounds.w / 2;
+          auto l = (address_t)image->getPixelAddress(bounds.x, y);
+          auto r = (address_t)image->getPixelAddress(bounds.x2() - 1, y);
 
-        for (int x = 0; x < n; ++x, ++l, --r) {
-          std::swap(*l, *r);
+#if defined(__x86_64__) || defined(_WIN64)
+          if constexpr (ImageTraits::bytes_per_pixel == 4) {
+            // Reverse and swap four 32-bit pixels per shuffle (both
+            // blocks are disjoint as we swap w/2 pixels at most).
+            for (; n >= 4; n -= 4, l += 4, r -= 4) {
+              const __m128i lv = _mm_loadu_si128((const __m128i*)l);
+              const __m128i rv = _mm_loadu_si128((const __m128i*)(r - 3));
+              _mm_storeu_si128((__m128i*)(r - 3), _mm_shuffle_epi32(lv, 0x1b));
+              _mm_storeu_si128((__m128i*)l, _mm_shuffle_epi32(rv, 0x1b));
+            }
+          }
+#endif
+          for (; n > 0; --n, ++l, --r)
+            std::swap(*l, *r);
         }
-      }
+      });
       break;
 
     case FlipVertical: {
-      const int n = bounds.w;
-      int v = bounds.y2() - 1;
-      for (int y = bounds.y; y < bounds.y + bounds.h / 2; ++y, --v) {
-        auto t = (address_t)image->getPixelAddress(bounds.x, y);
-        auto b = (address_t)image->getPixelAddress(bounds.x, v);
+      for_each_row_band(bounds.y,
+                        bounds.y + bounds.h / 2,
+                        2 * rowBytes,
+                        [image, &bounds, rowBytes](int fromY, int toY) {
+                          std::vector<uint8_t> tmp(rowBytes);
+                          for (int y = fromY; y < toY; ++y) {
+                            const int v = bounds.y2() - 1 - (y - bounds.y);
+                            auto t = image->getPixelAddress(bounds.x, y);
+                            auto b = image->getPixelAddress(bounds.x, v);
 
-        for (int x = 0; x < n; ++x, ++t, ++b) {
-          std::swap(*t, *b);
-        }
-      }
+                            // Swap whole rows at once
+                            std::memcpy(&tmp[0], t, rowBytes);
+                            std::memcpy(t, b, rowBytes);
+                            std::memcpy(b, &tmp[0], rowBytes);
+                          }
+                        });
       break;
     }
 
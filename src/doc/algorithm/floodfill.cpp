@@ -5,11 +5,10 @@
 // - Adapted to Aseprite
 // - Added non-contiguous mode
 // - Added mask parameter
+// - Rewritten as a span-based scanline filler over raw row pointers
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
-//
-// TODO rewrite this algorithm from scratch
 
 #ifdef HAVE_CONFIG_H
   #include "config.h"
@@ -22,6 +21,7 @@
 #include "doc/primitives.h"
 #include "doc/primitives_fast.h"
 
+#include <algorithm>
 #include <climits>
 #include <cmath>
 #include <limits>
@@ -29,22 +29,6 @@
 
 namespace doc { namespace algorithm {
 
-struct FLOODED_LINE { // store segments which have been flooded
-  char flags;         // status of the segment
-  int lpos, rpos;     // left and right ends of segment
-  int y;              // y coordinate of the segment
-  int next;           // linked list if several per line
-};
-
-static std::vector<FLOODED_LINE> flood_buf;
-static int flood_count; /* number of flooded segments */
-
-#define FLOOD_IN_USE     1
-#define FLOOD_TODO_ABOVE 2
-#define FLOOD_TODO_BELOW 4
-
-#define FLOOD_LINE(c)    (&flood_buf[c])
-
 static inline bool color_equal_32_raw(color_t c1, color_t c2)
 {
   return (c1 == c2);
@@ -128,211 +112,133 @@ inline bool color_equal<TilemapTraits>(color_t c1, color_t c2, int tolerance)
   return color_equal_32_raw(c1, c2);
 }
 
-/* flooder:
- *  Fills a horizontal line around the specified position, and adds it
- *  to the list of drawn segments. Returns the first x coordinate after
- *  the part of the line which it has dealt with.
- */
-static int flooder(const Image* image,
-                   const Mask* mask,
-                   int x,
-                   int y,
-                   const gfx::Rect& bounds,
-                   color_t src_color,
-                   int tolerance,
-                   void* data,
-                   AlgoHLine proc)
-{
-#define MASKED(u, v)                                                                               \
-  (mask && (!mask->bounds().contains(u, v) ||                                                      \
-            (mask->bitmap() && !get_pixel_fast<BitmapTraits>(mask->bitmap(),                       \
-                                                             (u) - mask->bounds().x,               \
-                                                             (v) - mask->bounds().y))))
-
-  FLOODED_LINE* p;
-  int left = 0, right = 0;
-  int c;
-
-  switch (image->pixelFormat()) {
-    case IMAGE_RGB: {
-      uint32_t* address = reinterpret_cast<uint32_t*>(image->getPixelAddress(0, y));
-
-      // Check start pixel
-      if (!color_equal_32((int)*(address + x), src_color, tolerance) || MASKED(x, y))
-        return x + 1;
-
-      // Work left from starting point
-      for (left = x - 1; left >= bounds.x; left--) {
-        if (!color_equal_32((int)*(address + left), src_color, tolerance) || MASKED(left, y))
-          break;
-      }
-
-      // Work right from starting point
-      for (right = x + 1; right < bounds.x2(); right++) {
-        if (!color_equal_32((int)*(address + right), src_color, tolerance) || MASKED(right, y))
-          break;
-      }
-    } break;
-
-    case IMAGE_GRAYSCALE: {
-      uint16_t* address = reinterpret_cast<uint16_t*>(image->getPixelAddress(0, y));
-
-      // Check start pixel
-      if (!color_equal_16((int)*(address + x), src_color, tolerance) || MASKED(x, y))
-        return x + 1;
-
-      // Work left from starting point
-      for (left = x - 1; left >= bounds.x; left--) {
-        if (!color_equal_16((int)*(address + left), src_color, tolerance) || MASKED(left, y))
-          break;
-      }
-
-      // Work right from starting point
-      for (right = x + 1; right < bounds.x2(); right++) {
-        if (!color_equal_16((int)*(address + right), src_color, tolerance) || MASKED(right, y))
-          break;
-      }
-    } break;
-
-    case IMAGE_INDEXED: {
-      uint8_t* address = image->getPixelAddress(0, y);
-
-      // Check start pixel
-      if (!color_equal_8((int)*(address + x), src_color, tolerance) || MASKED(x, y))
-        return x + 1;
-
-      // Work left from starting point
-      for (left = x - 1; left >= bounds.x; left--) {
-        if (!color_equal_8((int)*(address + left), src_color, tolerance) || MASKED(left, y))
-          break;
-      }
-
-      // Work right from starting point
-      for (right = x + 1; right < bounds.x2(); right++) {
-        if (!color_equal_8((int)*(address + right), src_color, tolerance) || MASKED(right, y))
-          break;
-      }
-    } break;
-
-    case IMAGE_TILEMAP: {
-      // TODO add support for mask
-
-      uint32_t* address = reinterpret_cast<uint32_t*>(image->getPixelAddress(0, y));
-
-      // Check start pixel
-      if (!color_equal_32_raw((int)*(address + x), src_color))
-        return x + 1;
-
-      // Work left from starting point
-      for (left = x - 1; left >= bounds.x; left--) {
-        if (!color_equal_32_raw((int)*(address + left), src_color))
-          break;
-      }
-
-      // Work right from starting point
-      for (right = x + 1; right < bounds.x2(); right++) {
-        if (!color_equal_32_raw((int)*(address + right), src_color))
-          break;
-      }
-    } break;
-
-    default:
-      // Check start pixel
-      if (get_pixel(image, x, y) != src_color || MASKED(x, y))
-        return x + 1;
-
-      // Work left from starting point
-      for (left = x - 1; left >= bounds.x; left--) {
-        if (get_pixel(image, left, y) != src_color || MASKED(left, y))
-          break;
-      }
-
-      // Work right from starting point
-      for (right = x + 1; right < bounds.x2(); right++) {
-        if (get_pixel(image, right, y) != src_color || MASKED(right, y))
-          break;
-      }
-      break;
+namespace {
+
+// Bit per pixel inside the fill bounds marking pixels that were
+// already emitted in some span (we cannot look at the destination:
+// the AlgoHLine callback might write to a Mask instead of the image,
+// or might not change the pixel color at all).
+class VisitedMap {
+public:
+  VisitedMap(const gfx::Rect& bounds)
+    : m_bounds(bounds)
+    , m_bits((std::size_t(bounds.w) * bounds.h + 31) / 32, 0)
+  {
   }
 
-  left++;
-  right--;
-
-  /* draw the line */
-  (*proc)(left, y, right, data);
-
-  /* store it in the list of flooded segments */
-  c = y;
-  p = FLOOD_LINE(c);
+  bool operator()(int x, int y) const
+  {
+    const std::size_t i = index(x, y);
+    return (m_bits[i >> 5] & (1u << (i & 31))) != 0;
+  }
 
-  if (p->flags) {
-    while (p->next) {
-      c = p->next;
-      p = FLOOD_LINE(c);
+  void set(int x1, int x2, int y)
+  {
+    for (int x = x1; x <= x2; ++x) {
+      const std::size_t i = index(x, y);
+      m_bits[i >> 5] |= (1u << (i & 31));
     }
-
-    p->next = c = flood_count++;
-    flood_buf.resize(flood_count);
-    p = FLOOD_LINE(c);
   }
 
-  p->flags = FLOOD_IN_USE;
-  p->lpos = left;
-  p->rpos = right;
-  p->y = y;
-  p->next = 0;
-
-  if (y > bounds.y)
-    p->flags |= FLOOD_TODO_ABOVE;
+private:
+  std::size_t index(int x, int y) const
+  {
+    return std::size_t(y - m_bounds.y) * m_bounds.w + (x - m_bounds.x);
+  }
 
-  if (y + 1 < bounds.y2())
-    p->flags |= FLOOD_TODO_BELOW;
+  gfx::Rect m_bounds;
+  std::vector<uint32_t> m_bits;
+};
 
-  return right + 2;
-}
+} // anonymous namespace
 
-/* check_flood_line:
- *  Checks a line segment, using the scratch buffer is to store a list of
- *  segments which have already been drawn in order to minimise the required
- *  number of tests.
- */
-static int check_flood_line(const Image* image,
+// Scanline filler: emits maximal horizontal runs of matching pixels
+// working on raw row pointers, pushing each run once into an explicit
+// span stack and using a visited bitmap to never test a pixel twice.
+template<typename ImageTraits>
+static void contiguous_fill(const Image* image,
                             const Mask* mask,
-                            int y,
-                            int left,
-                            int right,
+                            const int x,
+                            const int y,
                             const gfx::Rect& bounds,
-                            int src_color,
-                            int tolerance,
+                            const color_t src_color,
+                            const int tolerance,
+                            const bool isEightConnected,
                             void* data,
                             AlgoHLine proc)
 {
-  int c;
-  FLOODED_LINE* p;
-  int ret = false;
-
-  while (left <= right) {
-    c = y;
+#define MASKED(u, v)                                                                               \
+  (mask && (!mask->bounds().contains(u, v) ||                                                      \
+            (mask->bitmap() && !get_pixel_fast<BitmapTraits>(mask->bitmap(),                       \
+                                                             (u) - mask->bounds().x,               \
+                                                             (v) - mask->bounds().y))))
 
-    for (;;) {
-      p = FLOOD_LINE(c);
+  VisitedMap visited(bounds);
+
+  auto rowAddress = [image](int v) {
+    return reinterpret_cast<typename ImageTraits::const_address_t>(image->getPixelAddress(0, v));
+  };
+  auto matches = [&](typename ImageTraits::const_address_t address, int u, int v) {
+    return (color_equal<ImageTraits>(color_t(*(address + u)), src_color, tolerance) &&
+            !MASKED(u, v));
+  };
+
+  // Emits the maximal run around (u, v), marks it as visited, and
+  // pushes it to explore its neighboring rows. Returns the right end
+  // of the run.
+  struct Span {
+    int x1, x2, y;
+  };
+  std::vector<Span> spans;
+  auto emitRun = [&](typename ImageTraits::const_address_t address, int u, int v) -> int {
+    int left = u;
+    int right = u;
+    while (left > bounds.x && !visited(left - 1, v) && matches(address, left - 1, v))
+      --left;
+    while (right < bounds.x2() - 1 && !visited(right + 1, v) && matches(address, right + 1, v))
+      ++right;
+    visited.set(left, right, v);
+    (*proc)(left, v, right, data);
+    spans.push_back(Span{ left, right, v });
+    return right;
+  };
+
+  // Initial span
+  {
+    auto address = rowAddress(y);
+    if (!matches(address, x, y))
+      return;
+    emitRun(address, x, y);
+  }
 
-      if ((left >= p->lpos) && (left <= p->rpos)) {
-        left = p->rpos + 2;
-        break;
+  while (!spans.empty()) {
+    const Span span = spans.back();
+    spans.pop_back();
+
+    for (int dy = -1; dy <= 1; dy += 2) {
+      const int v = span.y + dy;
+      if (v < bounds.y || v >= bounds.y2())
+        continue;
+
+      // In eight-connected mode the diagonal neighbors of the run
+      // ends are reachable too.
+      int x1 = span.x1;
+      int x2 = span.x2;
+      if (isEightConnected) {
+        x1 = std::max(bounds.x, x1 - 1);
+        x2 = std::min(bounds.x2() - 1, x2 + 1);
       }
 
-      c = p->next;
-
-      if (!c) {
-        left = flooder(image, mask, left, y, bounds, src_color, tolerance, data, proc);
-        ret = true;
-        break;
+      auto address = rowAddress(v);
+      for (int u = x1; u <= x2; ++u) {
+        if (visited(u, v) || !matches(address, u, v))
+          continue;
+        u = emitRun(address, u, v) + 1;
       }
     }
   }
 
-  return ret;
+#undef MASKED
 }
 
 template<typename ImageTraits>
@@ -403,188 +309,63 @@ void floodfill(const Image* image,
     return;
   }
 
-  /* set up the list of flooded segments */
-  flood_buf.resize(image->height());
-  flood_count = image->height();
-  FLOODED_LINE* p = (FLOODED_LINE*)&flood_buf[0];
-  for (int c = 0; c < flood_count; c++) {
-    p[c].flags = 0;
-    p[c].lpos = std::numeric_limits<int>::max();
-    p[c].rpos = std::numeric_limits<int>::min();
-    p[c].y = y;
-    p[c].next = 0;
-  }
-
-  // Start up the flood algorithm
-  flooder(image, mask, x, y, bounds, src_color, tolerance, data, proc);
-
-  // Continue as long as there are some segments still to test
-  bool done;
-  do {
-    done = true;
-
-    // For each line on the screen
-    for (int c = 0; c < flood_count; c++) {
-      p = FLOOD_LINE(c);
-
-      // Check below the segment?
-      if (p->flags & FLOOD_TODO_BELOW) {
-        p->flags &= ~FLOOD_TODO_BELOW;
-
-        if (isEightConnected) {
-          if (p->lpos + 1 < bounds.x2() && check_flood_line(image,
-                                                            mask,
-                                                            p->y + 1,
-                                                            p->lpos + 1,
-                                                            p->rpos,
-                                                            bounds,
-                                                            src_color,
-                                                            tolerance,
-                                                            data,
-                                                            proc)) {
-            done = false;
-            p = FLOOD_LINE(c);
-          }
-
-          if (p->lpos - 1 >= bounds.x && check_flood_line(image,
-                                                          mask,
-                                                          p->y + 1,
-                                                          p->lpos - 1,
-                                                          p->rpos,
-                                                          bounds,
-                                                          src_color,
-                                                          tolerance,
-                                                          data,
-                                                          proc)) {
-            done = false;
-            p = FLOOD_LINE(c);
-          }
-
-          if (p->rpos + 1 < bounds.x2() && check_flood_line(image,
-                                                            mask,
-                                                            p->y + 1,
-                                                            p->lpos,
-                                                            p->rpos + 1,
-                                                            bounds,
-                                                            src_color,
-                                                            tolerance,
-                                                            data,
-                                                            proc)) {
-            done = false;
-            p = FLOOD_LINE(c);
-          }
-
-          if (p->rpos - 1 >= bounds.x && check_flood_line(image,
-                                                          mask,
-                                                          p->y + 1,
-                                                          p->lpos,
-                                                          p->rpos - 1,
-                                                          bounds,
-                                                          src_color,
-                                                          tolerance,
-                                                          data,
-                                                          proc)) {
-            done = false;
-            p = FLOOD_LINE(c);
-          }
-        }
-
-        if (check_flood_line(image,
-                             mask,
-                             p->y + 1,
-                             p->lpos,
-                             p->rpos,
-                             bounds,
-                             src_color,
-                             tolerance,
-                             data,
-                             proc)) {
-          done = false;
-          p = FLOOD_LINE(c);
-        }
-      }
-
-      // Check above the segment?
-      if (p->flags & FLOOD_TODO_ABOVE) {
-        p->flags &= ~FLOOD_TODO_ABOVE;
-
-        if (isEightConnected) {
-          if (p->lpos + 1 < bounds.x2() && check_flood_line(image,
-                                                            mask,
-                                                            p->y - 1,
-                                                            p->lpos + 1,
-                                                            p->rpos,
-                                                            bounds,
-                                                            src_color,
-                                                            tolerance,
-                                                            data,
-                                                            proc)) {
-            done = false;
-            p = FLOOD_LINE(c);
-          }
-
-          if (p->lpos - 1 >= bounds.x && check_flood_line(image,
-                                                          mask,
-                                                          p->y - 1,
-                                                          p->lpos - 1,
-                                                          p->rpos,
-                                                          bounds,
-                                                          src_color,
-                                                          tolerance,
-                                                          data,
-                                                          proc)) {
-            done = false;
-            p = FLOOD_LINE(c);
-          }
-
-          if (p->rpos + 1 < bounds.x2() && check_flood_line(image,
-                                                            mask,
-                                                            p->y - 1,
-                                                            p->lpos,
-                                                            p->rpos + 1,
-                                                            bounds,
-                                                            src_color,
-                                                            tolerance,
-                                                            data,
-                                                            proc)) {
-            done = false;
-            p = FLOOD_LINE(c);
-          }
-
-          if (p->rpos - 1 >= bounds.x && check_flood_line(image,
-                                                          mask,
-                                                          p->y - 1,
-                                                          p->lpos,
-                                                          p->rpos - 1,
-                                                          bounds,
-                                                          src_color,
-                                                          tolerance,
-                                                          data,
-                                                          proc)) {
-            done = false;
-            p = FLOOD_LINE(c);
-          }
-        }
+  // The contiguous filler indexes its visited bitmap relative to
+  // bounds, so a seed outside bounds (even if inside the image) must
+  // be rejected here.
+  if (!bounds.contains(x, y))
+    return;
 
-        if (check_flood_line(image,
-                             mask,
-                             p->y - 1,
-                             p->lpos,
-                             p->rpos,
-                             bounds,
-                             src_color,
-                             tolerance,
-                             data,
-                             proc)) {
-          done = false;
-
-          // Special case shortcut for going backwards
-          if ((c > bounds.y) && (c < bounds.y2()))
-            c -= 2;
-        }
-      }
-    }
-  } while (!done);
+  switch (image->pixelFormat()) {
+    case IMAGE_RGB:
+      contiguous_fill<RgbTraits>(image,
+                                 mask,
+                                 x,
+                                 y,
+                                 bounds,
+                                 src_color,
+                                 tolerance,
+                                 isEightConnected,
+                                 data,
+                                 proc);
+      break;
+    case IMAGE_GRAYSCALE:
+      contiguous_fill<GrayscaleTraits>(image,
+                                       mask,
+                                       x,
+                                       y,
+                                       bounds,
+                                       src_color,
+                                       tolerance,
+                                       isEightConnected,
+                                       data,
+                                       proc);
+      break;
+    case IMAGE_INDEXED:
+      contiguous_fill<IndexedTraits>(image,
+                                     mask,
+                                     x,
+                                     y,
+                                     bounds,
+                                     src_color,
+                                     tolerance,
+                                     isEightConnected,
+                                     data,
+                                     proc);
+      break;
+    case IMAGE_TILEMAP:
+      // TODO add support for mask
+      contiguous_fill<TilemapTraits>(image,
+                                     nullptr,
+                                     x,
+                                     y,
+                                     bounds,
+                                     src_color,
+                                     tolerance,
+                                     isEightConnected,
+                                     data,
+                                     proc);
+      break;
+  }
 }
 
 }} // namespace doc::algorithm
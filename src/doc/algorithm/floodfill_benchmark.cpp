@@ -0,0 +1,123 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "doc/algorithm/floodfill.h"
+
+#include "doc/algorithm/random_image.h"
+#include "doc/image.h"
+#include "doc/image_ref.h"
+#include "doc/primitives.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace doc;
+
+static void count_hline(int x1, int y, int x2, void* data)
+{
+  *reinterpret_cast<int*>(data) += (x2 - x1 + 1);
+}
+
+// Worst case of the paint bucket: every pixel has the same color so
+// the fill expands to the whole canvas.
+void BM_FloodFillSolid(benchmark::State& state)
+{
+  const int w = state.range(0);
+  const int h = state.range(1);
+  const bool isEightConnected = state.range(2);
+  ImageRef img(Image::create(IMAGE_RGB, w, h));
+  clear_image(img.get(), rgba(100, 100, 100, 255));
+  for (auto _ : state) {
+    int pixels = 0;
+    algorithm::floodfill(img.get(),
+                         nullptr,
+                         w / 2,
+                         h / 2,
+                         img->bounds(),
+                         get_pixel(img.get(), w / 2, h / 2),
+                         0,
+                         true,
+                         isEightConnected,
+                         &pixels,
+                         count_hline);
+    benchmark::DoNotOptimize(pixels);
+  }
+  state.SetItemsProcessed(state.iterations() * w * h);
+}
+
+// Random pixels with a high tolerance: lots of small spans with
+// frequent color checks (a dithered/noisy area).
+void BM_FloodFillRandom(benchmark::State& state)
+{
+  const int w = state.range(0);
+  const int h = state.range(1);
+  const int tolerance = state.range(2);
+  ImageRef img(Image::create(IMAGE_RGB, w, h));
+  algorithm::random_image(img.get());
+  for (auto _ : state) {
+    int pixels = 0;
+    algorithm::floodfill(img.get(),
+                         nullptr,
+                         w / 2,
+                         h / 2,
+                         img->bounds(),
+                         get_pixel(img.get(), w / 2, h / 2),
+                         tolerance,
+                         true,
+                         false,
+                         &pixels,
+                         count_hline);
+    benchmark::DoNotOptimize(pixels);
+  }
+}
+
+// Non-contiguous mode (global color replacement) always visits the
+// whole image.
+void BM_FloodFillNonContiguous(benchmark::State& state)
+{
+  const int w = state.range(0);
+  const int h = state.range(1);
+  ImageRef img(Image::create(IMAGE_RGB, w, h));
+  algorithm::random_image(img.get());
+  for (auto _ : state) {
+    int pixels = 0;
+    algorithm::floodfill(img.get(),
+                         nullptr,
+                         w / 2,
+                         h / 2,
+                         img->bounds(),
+                         get_pixel(img.get(), w / 2, h / 2),
+                         128,
+                         false,
+                         false,
+                         &pixels,
+                         count_hline);
+    benchmark::DoNotOptimize(pixels);
+  }
+  state.SetItemsProcessed(state.iterations() * w * h);
+}
+
+BENCHMARK(BM_FloodFillSolid)
+  ->Args({ 256, 256, false })
+  ->Args({ 1024, 1024, false })
+  ->Args({ 4096, 4096, false })
+  ->Args({ 1024, 1024, true })
+  ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_FloodFillRandom)
+  ->Args({ 1024, 1024, 128 })
+  ->Args({ 1024, 1024, 192 })
+  ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_FloodFillNonContiguous)
+  ->Args({ 1024, 1024 })
+  ->Args({ 4096, 4096 })
+  ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
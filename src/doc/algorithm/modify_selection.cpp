@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2021 Igara Studio S.A.
+// Copyright (c) 2021-2026 Igara Studio S.A.
 // Copyright (c) 2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,15 +12,116 @@
 #include "doc/algorithm/modify_selection.h"
 
 #include "doc/image.h"
+#include "doc/image_impl.h"
 #include "doc/mask.h"
 #include "doc/primitives.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace doc { namespace algorithm {
 
+namespace {
+
+// Contiguous horizontal run of selected pixels [x1, x2)
+struct Run {
+  int x1, x2;
+};
+
+typedef std::vector<Run> Runs;
+
+// result = a ∩ b (both sorted and disjoint)
+void intersect_runs(const Runs& a, const Runs& b, Runs& result)
+{
+  result.clear();
+  std::size_t i = 0, j = 0;
+  while (i < a.size() && j < b.size()) {
+    const int x1 = std::max(a[i].x1, b[j].x1);
+    const int x2 = std::min(a[i].x2, b[j].x2);
+    if (x1 < x2)
+      result.push_back(Run{ x1, x2 });
+
+    if (a[i].x2 < b[j].x2)
+      ++i;
+    else
+      ++j;
+  }
+}
+
+// result = a - b (both sorted and disjoint)
+void subtract_runs(const Runs& a, const Runs& b, Runs& result)
+{
+  result.clear();
+  std::size_t j = 0;
+  for (const Run& run : a) {
+    int x = run.x1;
+    while (j < b.size() && b[j].x2 <= x)
+      ++j;
+
+    std::size_t k = j;
+    while (k < b.size() && b[k].x1 < run.x2) {
+      if (b[k].x1 > x)
+        result.push_back(Run{ x, b[k].x1 });
+      x = std::max(x, b[k].x2);
+      ++k;
+    }
+    if (x < run.x2)
+      result.push_back(Run{ x, run.x2 });
+  }
+}
+
+// Converts one row of the selection bitmap into runs
+void row_to_runs(const Image* bitmap, const int y, Runs& runs)
+{
+  runs.clear();
+
+  const LockImageBits<BitmapTraits> bits(bitmap, gfx::Rect(0, y, bitmap->width(), 1));
+  int x = 0;
+  int start = -1;
+  for (auto it = bits.begin(), end = bits.end(); it != end; ++it, ++x) {
+    if (*it) {
+      if (start < 0)
+        start = x;
+    }
+    else if (start >= 0) {
+      runs.push_back(Run{ start, x });
+      start = -1;
+    }
+  }
+  if (start >= 0)
+    runs.push_back(Run{ start, x });
+}
+
+// Fills a w-pixels boolean row from its run representation
+void runs_to_row(const Runs& runs, const int w, std::vector<uint8_t>& row)
+{
+  std::fill(row.begin(), row.end(), 0);
+  for (const Run& run : runs)
+    std::fill(row.begin() + std::max(0, run.x1), row.begin() + std::min(w, run.x2), 1);
+}
+
+} // anonymous namespace
+
 // TODO create morphological operators/functions in "doc" namespace
-// TODO the impl is not optimal, but is good enough as a first version
+//
+// Morphological expand/contract/border of the selection based on a
+// distance transform, so the cost is O(canvas) for any radius (the
+// old version ran one pass per kernel row, i.e. O(canvas x radius)):
+//
+// 1. A two-pass vertical distance transform computes, per pixel, the
+//    distance (capped at radius+1) to the nearest selected pixel of
+//    its column (unselected for contract/border, where anything
+//    outside the canvas also counts as unselected).
+// 2. The circle/square kernel is decomposed in one horizontal span
+//    per row; as the spans shrink with the vertical distance (the
+//    kernel is convex), the span of the *nearest* pixel in each
+//    column is the horizontal reach of that column, and one interval-
+//    cover sweep per output row resolves the dilation exactly.
+//
+// The result is bit-identical to applying the brush kernel on every
+// pixel (see modify_selection_tests.cpp).
 void modify_selection(const SelectionModifier modifier,
                       const Mask* srcMask,
                       Mask* dstMask,
@@ -30,11 +131,14 @@ void modify_selection(const SelectionModifier modifier,
   const doc::Image* srcImage = srcMask->bitmap();
   doc::Image* dstImage = dstMask->bitmap();
   const gfx::Point offset = srcMask->bounds().origin() - dstMask->bounds().origin();
+  const int w = srcImage->width();
+  const int h = srcImage->height();
+  if (w <= 0 || h <= 0)
+    return;
 
-  // Image bounds to clip get/put pixels
-  const gfx::Rect srcBounds = srcImage->bounds();
-
-  // Create a kernel
+  // Create a kernel (the center pixel is included: expand/contract/
+  // border over kernel+center are equivalent to the accumulator over
+  // the center-less kernel that the per-pixel version used)
   const int size = 2 * radius + 1;
   std::unique_ptr<doc::Image> kernel(doc::Image::create(IMAGE_BITMAP, size, size));
   doc::clear_image(kernel.get(), 0);
@@ -42,48 +146,159 @@ void modify_selection(const SelectionModifier modifier,
     doc::fill_ellipse(kernel.get(), 0, 0, size - 1, size - 1, 0, 0, 1);
   else
     doc::fill_rect(kernel.get(), 0, 0, size - 1, size - 1, 1);
-  doc::put_pixel(kernel.get(), radius, radius, 0);
-
-  int total = 0; // Number of 1s in the kernel image
-  for (int v = 0; v < size; ++v)
-    for (int u = 0; u < size; ++u)
-      total += kernel->getPixel(u, v);
-
-  for (int y = -radius; y < srcBounds.h + radius; ++y) {
-    for (int x = -radius; x < srcBounds.w + radius; ++x) {
-      doc::color_t c;
-      if (srcBounds.contains(x, y))
-        c = srcImage->getPixel(x, y);
-      else
-        c = 0;
-
-      int accum = 0;
-      for (int v = 0; v < size; ++v) {
-        for (int u = 0; u < size; ++u) {
-          if (kernel->getPixel(u, v)) {
-            if (srcBounds.contains(x + u - radius, y + v - radius))
-              accum += srcImage->getPixel(x - radius + u, y - radius + v);
-          }
-        }
+
+  // Horizontal reach per vertical distance: span[d] is the half-width
+  // of the kernel row at d rows from the center row (-1 if that row
+  // is empty). Both brush types are symmetric and convex, so the
+  // spans never grow with the distance.
+  std::vector<int> span(radius + 1);
+  for (int d = 0; d <= radius; ++d) {
+    int umax = -1;
+    for (int u = 0; u < size; ++u) {
+      if (kernel->getPixel(u, radius + d))
+        umax = u;
+    }
+    span[d] = (umax >= 0 ? umax - radius : -1);
+    ASSERT(d == 0 || span[d] <= span[d - 1]);
+  }
+
+  // Convert the selection bitmap into runs
+  std::vector<Runs> src(h);
+  for (int y = 0; y < h; ++y)
+    row_to_runs(srcImage, y, src[y]);
+
+  const bool expand = (modifier == SelectionModifier::Expand);
+
+  // Vertical distance transform, capped at radius+1 (="too far"):
+  // distance from each pixel to the nearest selected (expand) or
+  // unselected (contract/border) pixel of its column. For contract/
+  // border the virtual rows above and below the canvas count as
+  // unselected, like the zero-padding of the per-pixel version.
+  const int tooFar = std::min(radius + 1, 0xffff);
+  std::vector<uint16_t> dist(std::size_t(w) * h);
+  {
+    std::vector<uint8_t> row(w);
+    std::vector<uint16_t> cur(w);
+
+    // Bottom-up pass (distance to the nearest source pixel below)
+    // For contract/border the virtual row outside the canvas is
+    // itself an unselected source (distance 0 before stepping in)
+    std::fill(cur.begin(), cur.end(), uint16_t(expand ? tooFar : 0));
+    for (int y = h - 1; y >= 0; --y) {
+      runs_to_row(src[y], w, row);
+      uint16_t* distRow = &dist[std::size_t(y) * w];
+      for (int x = 0; x < w; ++x) {
+        const bool source = (expand ? row[x] != 0 : row[x] == 0);
+        cur[x] = uint16_t(source ? 0 : std::min(tooFar, cur[x] + 1));
+        distRow[x] = cur[x];
+      }
+    }
+
+    // Top-down pass (min with the distance to the nearest source
+    // pixel above)
+    // For contract/border the virtual row outside the canvas is
+    // itself an unselected source (distance 0 before stepping in)
+    std::fill(cur.begin(), cur.end(), uint16_t(expand ? tooFar : 0));
+    for (int y = 0; y < h; ++y) {
+      runs_to_row(src[y], w, row);
+      uint16_t* distRow = &dist[std::size_t(y) * w];
+      for (int x = 0; x < w; ++x) {
+        const bool source = (expand ? row[x] != 0 : row[x] == 0);
+        cur[x] = uint16_t(source ? 0 : std::min(tooFar, cur[x] + 1));
+        distRow[x] = std::min(distRow[x], cur[x]);
+      }
+    }
+  }
+
+  auto writeRow = [&](const int y, const Runs& runs) {
+    for (const Run& run : runs) {
+      // fill_rect() clips to the dst bitmap bounds
+      doc::fill_rect(dstImage,
+                     offset.x + run.x1,
+                     offset.y + y,
+                     offset.x + run.x2 - 1,
+                     offset.y + y,
+                     1);
+    }
+  };
+
+  // Interval-cover accumulator over the extended row [-radius,
+  // w+radius): each column x whose nearest source pixel is at
+  // vertical distance d covers [x-span[d], x+span[d]].
+  const int coverW = w + 2 * radius;
+  std::vector<int> diff(coverW + 1);
+
+  auto addSources = [&](const uint16_t* distRow, const int dy) {
+    for (int x = 0; x < w; ++x) {
+      const int d = int(distRow[x]) + dy;
+      if (d <= radius && span[d] >= 0) {
+        ++diff[x - span[d] + radius];
+        --diff[x + span[d] + radius + 1];
+      }
+    }
+  };
+
+  auto coverToRuns = [&](Runs& runs) {
+    runs.clear();
+    int active = 0;
+    int start = -1;
+    for (int i = 0; i < coverW; ++i) {
+      active += diff[i];
+      if (active > 0) {
+        if (start < 0)
+          start = i;
+      }
+      else if (start >= 0) {
+        runs.push_back(Run{ start - radius, i - radius });
+        start = -1;
       }
+    }
+    if (start >= 0)
+      runs.push_back(Run{ start - radius, coverW - radius });
+  };
+
+  Runs out, cover;
+  if (expand) {
+    for (int y = -radius; y < h + radius; ++y) {
+      std::fill(diff.begin(), diff.end(), 0);
+      if (y < 0) {
+        // Virtual row above the canvas: dy extra rows away from row 0
+        addSources(&dist[0], -y);
+      }
+      else if (y >= h) {
+        addSources(&dist[std::size_t(h - 1) * w], y - (h - 1));
+      }
+      else {
+        addSources(&dist[std::size_t(y) * w], 0);
+      }
+      coverToRuns(cover);
+      writeRow(y, cover);
+    }
+  }
+  else {
+    for (int y = 0; y < h; ++y) {
+      if (src[y].empty())
+        continue;
 
-      switch (modifier) {
-        case SelectionModifier::Border: {
-          c = (c && accum < total) ? 1 : 0;
-          break;
-        }
-        case SelectionModifier::Expand: {
-          c = (c || accum > 0) ? 1 : 0;
-          break;
-        }
-        case SelectionModifier::Contract: {
-          c = (c && accum == total) ? 1 : 0;
-          break;
-        }
+      // Cover of the pixels that have some unselected pixel inside
+      // their kernel (i.e. the ones that don't survive the erosion).
+      // The left/right canvas borders always reach radius columns
+      // inside, as the center row of the kernel is full width.
+      std::fill(diff.begin(), diff.end(), 0);
+      addSources(&dist[std::size_t(y) * w], 0);
+      if (radius > 0) {
+        ++diff[0]; // [-radius, radius) from the left border
+        --diff[2 * radius];
+        ++diff[w]; // [w-radius, w+radius) from the right border
+        --diff[coverW];
       }
+      coverToRuns(cover);
 
-      if (c)
-        doc::put_pixel(dstImage, offset.x + x, offset.y + y, 1);
+      if (modifier == SelectionModifier::Contract)
+        subtract_runs(src[y], cover, out);
+      else // Border: selected pixels that don't survive the erosion
+        intersect_runs(src[y], cover, out);
+      writeRow(y, out);
     }
   }
 }
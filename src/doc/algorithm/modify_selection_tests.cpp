@@ -0,0 +1,160 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include "gtest/gtest.h"
+
+#include "doc/algorithm/modify_selection.h"
+#include "doc/image.h"
+#include "doc/mask.h"
+#include "doc/primitives.h"
+
+#include <memory>
+
+using namespace doc;
+using namespace gfx;
+
+namespace {
+
+// Original per-pixel implementation, used as a reference to check
+// that the run-based modify_selection() gives identical results.
+void reference_modify_selection(const algorithm::SelectionModifier modifier,
+                                const Mask* srcMask,
+                                Mask* dstMask,
+                                const int radius,
+                                const BrushType brush)
+{
+  const Image* srcImage = srcMask->bitmap();
+  Image* dstImage = dstMask->bitmap();
+  const Point offset = srcMask->bounds().origin() - dstMask->bounds().origin();
+  const Rect srcBounds = srcImage->bounds();
+
+  const int size = 2 * radius + 1;
+  std::unique_ptr<Image> kernel(Image::create(IMAGE_BITMAP, size, size));
+  clear_image(kernel.get(), 0);
+  if (brush == kCircleBrushType)
+    fill_ellipse(kernel.get(), 0, 0, size - 1, size - 1, 0, 0, 1);
+  else
+    fill_rect(kernel.get(), 0, 0, size - 1, size - 1, 1);
+  put_pixel(kernel.get(), radius, radius, 0);
+
+  int total = 0;
+  for (int v = 0; v < size; ++v)
+    for (int u = 0; u < size; ++u)
+      total += kernel->getPixel(u, v);
+
+  for (int y = -radius; y < srcBounds.h + radius; ++y) {
+    for (int x = -radius; x < srcBounds.w + radius; ++x) {
+      color_t c;
+      if (srcBounds.contains(x, y))
+        c = srcImage->getPixel(x, y);
+      else
+        c = 0;
+
+      int accum = 0;
+      for (int v = 0; v < size; ++v) {
+        for (int u = 0; u < size; ++u) {
+          if (kernel->getPixel(u, v)) {
+            if (srcBounds.contains(x + u - radius, y + v - radius))
+              accum += srcImage->getPixel(x - radius + u, y - radius + v);
+          }
+        }
+      }
+
+      switch (modifier) {
+        case algorithm::SelectionModifier::Border:   c = (c && accum < total) ? 1 : 0; break;
+        case algorithm::SelectionModifier::Expand:   c = (c || accum > 0) ? 1 : 0; break;
+        case algorithm::SelectionModifier::Contract: c = (c && accum == total) ? 1 : 0; break;
+      }
+
+      if (c)
+        put_pixel(dstImage, offset.x + x, offset.y + y, 1);
+    }
+  }
+}
+
+::testing::AssertionResult cmp_masks(const Mask& expected, const Mask& actual)
+{
+  if (expected.bounds() != actual.bounds()) {
+    return ::testing::AssertionFailure()
+           << "ExpectedBounds=" << expected.bounds().x << "," << expected.bounds().y << ","
+           << expected.bounds().w << "," << expected.bounds().h
+           << " ActualBounds=" << actual.bounds().x << "," << actual.bounds().y << ","
+           << actual.bounds().w << "," << actual.bounds().h;
+  }
+  const Rect bounds = expected.bounds();
+  for (int y = bounds.y; y < bounds.y2(); ++y) {
+    for (int x = bounds.x; x < bounds.x2(); ++x) {
+      if (expected.containsPoint(x, y) != actual.containsPoint(x, y)) {
+        return ::testing::AssertionFailure()
+               << "Expected=" << expected.containsPoint(x, y)
+               << " Actual=" << actual.containsPoint(x, y) << " x=" << x << " y=" << y;
+      }
+    }
+  }
+  return ::testing::AssertionSuccess();
+}
+
+void compare_with_reference(const Mask& srcMask, const Rect& canvas)
+{
+  for (auto modifier : { algorithm::SelectionModifier::Border,
+                         algorithm::SelectionModifier::Expand,
+                         algorithm::SelectionModifier::Contract }) {
+    for (auto brush : { kCircleBrushType, kSquareBrushType }) {
+      for (int radius : { 1, 2, 3, 5 }) {
+        Mask expected, actual;
+
+        expected.reserve(canvas);
+        expected.freeze();
+        reference_modify_selection(modifier, &srcMask, &expected, radius, brush);
+        expected.unfreeze();
+
+        actual.reserve(canvas);
+        actual.freeze();
+        algorithm::modify_selection(modifier, &srcMask, &actual, radius, brush);
+        actual.unfreeze();
+
+        EXPECT_TRUE(cmp_masks(expected, actual))
+          << "modifier=" << (int)modifier << " brush=" << (int)brush << " radius=" << radius;
+      }
+    }
+  }
+}
+
+} // anonymous namespace
+
+TEST(ModifySelection, Rectangle)
+{
+  Mask srcMask;
+  srcMask.replace(Rect(5, 4, 12, 9));
+  compare_with_reference(srcMask, Rect(0, 0, 32, 24));
+}
+
+TEST(ModifySelection, TouchingCanvasBorder)
+{
+  Mask srcMask;
+  srcMask.replace(Rect(0, 0, 10, 8));
+  compare_with_reference(srcMask, Rect(0, 0, 16, 16));
+}
+
+TEST(ModifySelection, IrregularShape)
+{
+  Mask srcMask;
+  srcMask.replace(Rect(2, 2, 20, 16));
+  srcMask.freeze();
+  // Punch some holes and add some lonely pixels/stripes
+  fill_rect(srcMask.bitmap(), 3, 3, 6, 6, 0);
+  fill_rect(srcMask.bitmap(), 10, 2, 11, 13, 0);
+  fill_rect(srcMask.bitmap(), 0, 8, 19, 8, 0);
+  put_pixel(srcMask.bitmap(), 4, 4, 1);
+  srcMask.unfreeze();
+  compare_with_reference(srcMask, Rect(0, 0, 32, 24));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
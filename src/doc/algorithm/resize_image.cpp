@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2019-2025  Igara Studio S.A.
+// Copyright (c) 2019-2026  Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -13,34 +13,336 @@
 
 #include "doc/algorithm/rotsprite.h"
 #include "doc/image.h"
+#include "doc/image_ref.h"
 #include "doc/palette.h"
 #include "doc/primitives_fast.h"
 #include "doc/rgbmap.h"
 #include "gfx/point.h"
 
+#include <algorithm>
 #include <cmath>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+  #define DOC_RESIZE_IMAGE_SSE2 1
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #define DOC_RESIZE_IMAGE_NEON 1
+  #include <arm_neon.h>
+#endif
 
 namespace doc { namespace algorithm {
 
-template<typename ImageTraits>
-void resize_image_nearest(const Image* src, Image* dst)
+namespace {
+
+// Runs fn(y0, y1) over bands of destination rows, using plain
+// std::thread as the doc library cannot depend on the app job
+// scheduler (same approach as shrink_bounds.cpp). Small images are
+// processed in the calling thread.
+template<typename Fn>
+void for_each_row_band(const int height, const int rowPixels, Fn&& fn)
+{
+  int threads = int(std::thread::hardware_concurrency());
+  if (threads < 4 || height * rowPixels < 500 * 500) {
+    fn(0, height);
+    return;
+  }
+
+  threads = std::min(threads, height);
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (int i = 0; i < threads; ++i) {
+    const int y0 = height * i / threads;
+    const int y1 = height * (i + 1) / threads;
+    if (i < threads - 1)
+      pool.emplace_back([=, &fn] { fn(y0, y1); });
+    else
+      fn(y0, y1); // The calling thread processes the last band
+  }
+  for (auto& thread : pool)
+    thread.join();
+}
+
+// Precomputed horizontal sampling for one destination column: the two
+// source columns to read and the weight of the right one (in 256ths).
+struct BilinearColumn {
+  int u0, u1;
+  int w;
+};
+
+std::vector<BilinearColumn> make_bilinear_columns(const int srcW, const int dstW)
+{
+  std::vector<BilinearColumn> cols(dstW);
+  for (int x = 0; x < dstW; ++x) {
+    // 16.16 fixed-point source position, computed per column (instead
+    // of accumulating a step) so the last column maps exactly to the
+    // last source column.
+    const int64_t u = (dstW > 1 ? ((int64_t(x) * (srcW - 1)) << 16) / (dstW - 1) : 0);
+    BilinearColumn& c = cols[x];
+    c.u0 = std::min<int>(int(u >> 16), srcW - 1);
+    c.u1 = std::min(c.u0 + 1, srcW - 1);
+    c.w = (int(u >> 8) & 0xff);
+  }
+  return cols;
+}
+
+// Interpolates the 2x2 source pixels with fixed-point weights uw/vw
+// (in 256ths, weights of the right column and bottom row). All
+// implementations shift intermediates by 8 bits between the
+// horizontal and vertical passes so results match across platforms.
+#if DOC_RESIZE_IMAGE_SSE2
+
+inline uint32_t bilinear_rgba(const uint32_t c00,
+                              const uint32_t c01,
+                              const uint32_t c10,
+                              const uint32_t c11,
+                              const int uw,
+                              const int vw)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i wu =
+    _mm_unpacklo_epi64(_mm_set1_epi16(short(256 - uw)), _mm_set1_epi16(short(uw)));
+
+  // Two pixels per register as 16-bit channels: [c00 | c01]
+  __m128i top = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set_epi32(0, 0, int(c01), int(c00)), zero),
+                                wu);
+  __m128i bottom = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set_epi32(0, 0, int(c11), int(c10)), zero),
+                                   wu);
+
+  // c0*u2 + c1*uw <= 255*256, so the 16-bit lanes cannot overflow
+  top = _mm_srli_epi16(_mm_add_epi16(top, _mm_srli_si128(top, 8)), 8);
+  bottom = _mm_srli_epi16(_mm_add_epi16(bottom, _mm_srli_si128(bottom, 8)), 8);
+
+  const __m128i r = _mm_srli_epi16(
+    _mm_add_epi16(_mm_mullo_epi16(top, _mm_set1_epi16(short(256 - vw))),
+                  _mm_mullo_epi16(bottom, _mm_set1_epi16(short(vw)))),
+    8);
+  return uint32_t(_mm_cvtsi128_si32(_mm_packus_epi16(r, r)));
+}
+
+#elif DOC_RESIZE_IMAGE_NEON
+
+inline uint32_t bilinear_rgba(const uint32_t c00,
+                              const uint32_t c01,
+                              const uint32_t c10,
+                              const uint32_t c11,
+                              const int uw,
+                              const int vw)
+{
+  const uint16x8_t wu = vcombine_u16(vdup_n_u16(uint16_t(256 - uw)), vdup_n_u16(uint16_t(uw)));
+  const uint16x8_t top =
+    vmulq_u16(vmovl_u8(vreinterpret_u8_u64(vcreate_u64(uint64_t(c00) | (uint64_t(c01) << 32)))),
+              wu);
+  const uint16x8_t bottom =
+    vmulq_u16(vmovl_u8(vreinterpret_u8_u64(vcreate_u64(uint64_t(c10) | (uint64_t(c11) << 32)))),
+              wu);
+
+  const uint16x4_t t = vshr_n_u16(vadd_u16(vget_low_u16(top), vget_high_u16(top)), 8);
+  const uint16x4_t b = vshr_n_u16(vadd_u16(vget_low_u16(bottom), vget_high_u16(bottom)), 8);
+  const uint16x4_t r =
+    vshr_n_u16(vadd_u16(vmul_n_u16(t, uint16_t(256 - vw)), vmul_n_u16(b, uint16_t(vw))), 8);
+  return vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(r, r))), 0);
+}
+
+#else
+
+inline uint32_t bilinear_rgba(const uint32_t c00,
+                              const uint32_t c01,
+                              const uint32_t c10,
+                              const uint32_t c11,
+                              const int uw,
+                              const int vw)
+{
+  const int u2 = 256 - uw;
+  const int v2 = 256 - vw;
+  uint32_t result = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    const int top = ((((c00 >> shift) & 0xff) * u2 + ((c01 >> shift) & 0xff) * uw) >> 8);
+    const int bottom = ((((c10 >> shift) & 0xff) * u2 + ((c11 >> shift) & 0xff) * uw) >> 8);
+    result |= uint32_t((top * v2 + bottom * vw) >> 8) << shift;
+  }
+  return result;
+}
+
+#endif
+
+inline uint16_t bilinear_graya(const uint16_t c00,
+                               const uint16_t c01,
+                               const uint16_t c10,
+                               const uint16_t c11,
+                               const int uw,
+                               const int vw)
+{
+  const int u2 = 256 - uw;
+  const int v2 = 256 - vw;
+  const int kt = ((graya_getv(c00) * u2 + graya_getv(c01) * uw) >> 8);
+  const int kb = ((graya_getv(c10) * u2 + graya_getv(c11) * uw) >> 8);
+  const int at = ((graya_geta(c00) * u2 + graya_geta(c01) * uw) >> 8);
+  const int ab = ((graya_geta(c10) * u2 + graya_geta(c11) * uw) >> 8);
+  return graya((kt * v2 + kb * vw) >> 8, (at * v2 + ab * vw) >> 8);
+}
+
+// Returns the two source rows and bottom-row weight for a
+// destination row (same fixed-point mapping as the columns).
+inline void bilinear_row(const int y, const int srcH, const int dstH, int& v0, int& v1, int& vw)
+{
+  const int64_t v = (dstH > 1 ? ((int64_t(y) * (srcH - 1)) << 16) / (dstH - 1) : 0);
+  v0 = std::min<int>(int(v >> 16), srcH - 1);
+  v1 = std::min(v0 + 1, srcH - 1);
+  vw = (int(v >> 8) & 0xff);
+}
+
+void resize_image_bilinear_rgba(const Image* src, Image* dst)
+{
+  const std::vector<BilinearColumn> cols = make_bilinear_columns(src->width(), dst->width());
+  const int srcH = src->height();
+
+  for_each_row_band(dst->height(), dst->width(), [&](const int y0, const int y1) {
+    for (int y = y0; y < y1; ++y) {
+      int v0, v1, vw;
+      bilinear_row(y, srcH, dst->height(), v0, v1, vw);
+      auto s0 = get_pixel_address_fast<RgbTraits>(src, 0, v0);
+      auto s1 = get_pixel_address_fast<RgbTraits>(src, 0, v1);
+      auto d = get_pixel_address_fast<RgbTraits>(dst, 0, y);
+      for (int x = 0; x < dst->width(); ++x) {
+        const BilinearColumn& c = cols[x];
+        d[x] = bilinear_rgba(s0[c.u0], s0[c.u1], s1[c.u0], s1[c.u1], c.w, vw);
+      }
+    }
+  });
+}
+
+void resize_image_bilinear_graya(const Image* src, Image* dst)
 {
-  double x_ratio = double(src->width()) / double(dst->width());
-  double y_ratio = double(src->height()) / double(dst->height());
-  double px, py;
+  const std::vector<BilinearColumn> cols = make_bilinear_columns(src->width(), dst->width());
+  const int srcH = src->height();
+
+  for_each_row_band(dst->height(), dst->width(), [&](const int y0, const int y1) {
+    for (int y = y0; y < y1; ++y) {
+      int v0, v1, vw;
+      bilinear_row(y, srcH, dst->height(), v0, v1, vw);
+      auto s0 = get_pixel_address_fast<GrayscaleTraits>(src, 0, v0);
+      auto s1 = get_pixel_address_fast<GrayscaleTraits>(src, 0, v1);
+      auto d = get_pixel_address_fast<GrayscaleTraits>(dst, 0, y);
+      for (int x = 0; x < dst->width(); ++x) {
+        const BilinearColumn& c = cols[x];
+        d[x] = bilinear_graya(s0[c.u0], s0[c.u1], s1[c.u0], s1[c.u1], c.w, vw);
+      }
+    }
+  });
+}
 
-  LockImageBits<ImageTraits> dstBits(dst);
-  auto dstIt = dstBits.begin();
+void resize_image_bilinear_indexed(const Image* src,
+                                   Image* dst,
+                                   const Palette* pal,
+                                   const RgbMap* rgbmap,
+                                   const color_t maskColor)
+{
+  const std::vector<BilinearColumn> cols = make_bilinear_columns(src->width(), dst->width());
+  const int srcH = src->height();
 
+  // Single-threaded: RgbMap implementations (e.g. OctreeMap) memoize
+  // lookups internally and aren't thread-safe.
   for (int y = 0; y < dst->height(); ++y) {
-    py = std::floor(y * y_ratio);
-    for (int x = 0; x < dst->width(); ++x, ++dstIt) {
-      px = std::floor(x * x_ratio);
-      *dstIt = get_pixel_fast<ImageTraits>(src, int(px), int(py));
+    int v0, v1, vw;
+    bilinear_row(y, srcH, dst->height(), v0, v1, vw);
+    auto s0 = get_pixel_address_fast<IndexedTraits>(src, 0, v0);
+    auto s1 = get_pixel_address_fast<IndexedTraits>(src, 0, v1);
+    auto d = get_pixel_address_fast<IndexedTraits>(dst, 0, y);
+    for (int x = 0; x < dst->width(); ++x) {
+      const BilinearColumn& c = cols[x];
+      uint32_t color[4] = { s0[c.u0], s0[c.u1], s1[c.u0], s1[c.u1] };
+
+      // Convert indexes to RGBA values
+      for (int i = 0; i < 4; ++i) {
+        if (color[i] == maskColor)
+          color[i] = pal->getEntry(color[i]) & rgba_rgb_mask; // Set alpha = 0
+        else
+          color[i] = pal->getEntry(color[i]);
+      }
+
+      const uint32_t rgbaColor = bilinear_rgba(color[0], color[1], color[2], color[3], c.w, vw);
+      d[x] = rgbmap->mapColor(rgba_getr(rgbaColor),
+                              rgba_getg(rgbaColor),
+                              rgba_getb(rgbaColor),
+                              rgba_geta(rgbaColor));
     }
   }
 }
 
+// 2x2 box filter used to build the intermediate power-of-two levels
+// of a large downscale (odd edges replicate the last row/column).
+void downscale_box_rgba(const Image* src, Image* dst)
+{
+  const int srcW = src->width();
+  const int srcH = src->height();
+
+  for_each_row_band(dst->height(), dst->width(), [&](const int y0, const int y1) {
+    for (int y = y0; y < y1; ++y) {
+      auto s0 = get_pixel_address_fast<RgbTraits>(src, 0, std::min(2 * y, srcH - 1));
+      auto s1 = get_pixel_address_fast<RgbTraits>(src, 0, std::min(2 * y + 1, srcH - 1));
+      auto d = get_pixel_address_fast<RgbTraits>(dst, 0, y);
+      for (int x = 0; x < dst->width(); ++x) {
+        const int x0 = std::min(2 * x, srcW - 1);
+        const int x1 = std::min(2 * x + 1, srcW - 1);
+        const uint32_t c00 = s0[x0], c01 = s0[x1], c10 = s1[x0], c11 = s1[x1];
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+          const int sum = ((c00 >> shift) & 0xff) + ((c01 >> shift) & 0xff) +
+                          ((c10 >> shift) & 0xff) + ((c11 >> shift) & 0xff);
+          result |= uint32_t((sum + 2) >> 2) << shift;
+        }
+        d[x] = result;
+      }
+    }
+  });
+}
+
+void downscale_box_graya(const Image* src, Image* dst)
+{
+  const int srcW = src->width();
+  const int srcH = src->height();
+
+  for_each_row_band(dst->height(), dst->width(), [&](const int y0, const int y1) {
+    for (int y = y0; y < y1; ++y) {
+      auto s0 = get_pixel_address_fast<GrayscaleTraits>(src, 0, std::min(2 * y, srcH - 1));
+      auto s1 = get_pixel_address_fast<GrayscaleTraits>(src, 0, std::min(2 * y + 1, srcH - 1));
+      auto d = get_pixel_address_fast<GrayscaleTraits>(dst, 0, y);
+      for (int x = 0; x < dst->width(); ++x) {
+        const int x0 = std::min(2 * x, srcW - 1);
+        const int x1 = std::min(2 * x + 1, srcW - 1);
+        const uint16_t c00 = s0[x0], c01 = s0[x1], c10 = s1[x0], c11 = s1[x1];
+        const int k = graya_getv(c00) + graya_getv(c01) + graya_getv(c10) + graya_getv(c11);
+        const int a = graya_geta(c00) + graya_geta(c01) + graya_geta(c10) + graya_geta(c11);
+        d[x] = graya((k + 2) >> 2, (a + 2) >> 2);
+      }
+    }
+  });
+}
+
+} // anonymous namespace
+
+template<typename ImageTraits>
+void resize_image_nearest(const Image* src, Image* dst)
+{
+  const double x_ratio = double(src->width()) / double(dst->width());
+  const double y_ratio = double(src->height()) / double(dst->height());
+
+  // Precompute the source column of each destination column
+  std::vector<int> columns(dst->width());
+  for (int x = 0; x < dst->width(); ++x)
+    columns[x] = int(std::floor(x * x_ratio));
+
+  for_each_row_band(dst->height(), dst->width(), [&](const int y0, const int y1) {
+    for (int y = y0; y < y1; ++y) {
+      const int py = int(std::floor(y * y_ratio));
+      for (int x = 0; x < dst->width(); ++x)
+        put_pixel_fast<ImageTraits>(dst, x, y, get_pixel_fast<ImageTraits>(src, columns[x], py));
+    }
+  });
+}
+
 void resize_image(Image* src,
                   Image* dst,
                   const ResizeMethod method,
@@ -54,7 +356,6 @@ void resize_image(Image* src,
     fixup_image_transparent_colors(src);
 
   switch (method) {
-    // TODO optimize this
     case RESIZE_METHOD_NEAREST_NEIGHBOR: {
       ASSERT(src->pixelFormat() == dst->pixelFormat());
 
@@ -67,14 +368,7 @@ void resize_image(Image* src,
       break;
     }
 
-    // TODO optimize this
     case RESIZE_METHOD_BILINEAR: {
-      uint32_t color[4], dst_color = 0;
-      double u, v, du, dv;
-      int u_floor, u_floor2;
-      int v_floor, v_floor2;
-      int x, y;
-
       // We cannot do interpolations between RGB values on indexed
       // images without a palette/rgbmap.
       if (dst->pixelFormat() == IMAGE_INDEXED && (!pal || !rgbmap)) {
@@ -82,92 +376,34 @@ void resize_image(Image* src,
         return;
       }
 
-      u = v = 0.0;
-      du = (src->width() - 1) * 1.0 / (dst->width() - 1);
-      dv = (src->height() - 1) * 1.0 / (dst->height() - 1);
-      for (y = 0; y < dst->height(); ++y) {
-        for (x = 0; x < dst->width(); ++x) {
-          u_floor = (int)std::floor(u);
-          v_floor = (int)std::floor(v);
-
-          if (u_floor > src->width() - 1) {
-            u_floor = src->width() - 1;
-            u_floor2 = src->width() - 1;
-          }
-          else if (u_floor == src->width() - 1)
-            u_floor2 = u_floor;
-          else
-            u_floor2 = u_floor + 1;
-
-          if (v_floor > src->height() - 1) {
-            v_floor = src->height() - 1;
-            v_floor2 = src->height() - 1;
-          }
-          else if (v_floor == src->height() - 1)
-            v_floor2 = v_floor;
+      // For downscales to half size or less, plain bilinear samples
+      // at most a 2x2 neighborhood per output pixel and skips most of
+      // the source, which drops detail and costs a full-resolution
+      // pass per target size. Pre-reduce with a chain of 2x2 box
+      // filters instead (each level built from the previous one, so
+      // e.g. a 16x16 icon from a big sprite costs a few halvings) and
+      // let one bilinear pass cover the sub-2x remainder.
+      ImageRef reduced;
+      if (dst->pixelFormat() == IMAGE_RGB || dst->pixelFormat() == IMAGE_GRAYSCALE) {
+        while (2 * dst->width() <= src->width() && 2 * dst->height() <= src->height()) {
+          ImageRef half(Image::create(src->pixelFormat(),
+                                      std::max(1, (src->width() + 1) / 2),
+                                      std::max(1, (src->height() + 1) / 2)));
+          if (src->pixelFormat() == IMAGE_RGB)
+            downscale_box_rgba(src, half.get());
           else
-            v_floor2 = v_floor + 1;
-
-          // get the four colors
-          color[0] = src->getPixel(u_floor, v_floor);
-          color[1] = src->getPixel(u_floor2, v_floor);
-          color[2] = src->getPixel(u_floor, v_floor2);
-          color[3] = src->getPixel(u_floor2, v_floor2);
-
-          // calculate the interpolated color
-          double u1 = u - u_floor;
-          double v1 = v - v_floor;
-          double u2 = 1 - u1;
-          double v2 = 1 - v1;
-
-          switch (dst->pixelFormat()) {
-            case IMAGE_RGB: {
-              int r = int((rgba_getr(color[0]) * u2 + rgba_getr(color[1]) * u1) * v2 +
-                          (rgba_getr(color[2]) * u2 + rgba_getr(color[3]) * u1) * v1);
-              int g = int((rgba_getg(color[0]) * u2 + rgba_getg(color[1]) * u1) * v2 +
-                          (rgba_getg(color[2]) * u2 + rgba_getg(color[3]) * u1) * v1);
-              int b = int((rgba_getb(color[0]) * u2 + rgba_getb(color[1]) * u1) * v2 +
-                          (rgba_getb(color[2]) * u2 + rgba_getb(color[3]) * u1) * v1);
-              int a = int((rgba_geta(color[0]) * u2 + rgba_geta(color[1]) * u1) * v2 +
-                          (rgba_geta(color[2]) * u2 + rgba_geta(color[3]) * u1) * v1);
-              dst_color = rgba(r, g, b, a);
-              break;
-            }
-            case IMAGE_GRAYSCALE: {
-              int v = int((graya_getv(color[0]) * u2 + graya_getv(color[1]) * u1) * v2 +
-                          (graya_getv(color[2]) * u2 + graya_getv(color[3]) * u1) * v1);
-              int a = int((graya_geta(color[0]) * u2 + graya_geta(color[1]) * u1) * v2 +
-                          (graya_geta(color[2]) * u2 + graya_geta(color[3]) * u1) * v1);
-              dst_color = graya(v, a);
-              break;
-            }
-            case IMAGE_INDEXED: {
-              // Convert index to RGBA values
-              for (int i = 0; i < 4; ++i) {
-                if (color[i] == maskColor)
-                  color[i] = pal->getEntry(color[i]) & rgba_rgb_mask; // Set alpha = 0
-                else
-                  color[i] = pal->getEntry(color[i]);
-              }
-
-              int r = int((rgba_getr(color[0]) * u2 + rgba_getr(color[1]) * u1) * v2 +
-                          (rgba_getr(color[2]) * u2 + rgba_getr(color[3]) * u1) * v1);
-              int g = int((rgba_getg(color[0]) * u2 + rgba_getg(color[1]) * u1) * v2 +
-                          (rgba_getg(color[2]) * u2 + rgba_getg(color[3]) * u1) * v1);
-              int b = int((rgba_getb(color[0]) * u2 + rgba_getb(color[1]) * u1) * v2 +
-                          (rgba_getb(color[2]) * u2 + rgba_getb(color[3]) * u1) * v1);
-              int a = int((rgba_geta(color[0]) * u2 + rgba_geta(color[1]) * u1) * v2 +
-                          (rgba_geta(color[2]) * u2 + rgba_geta(color[3]) * u1) * v1);
-              dst_color = rgbmap->mapColor(r, g, b, a);
-              break;
-            }
-          }
-
-          dst->putPixel(x, y, dst_color);
-          u += du;
+            downscale_box_graya(src, half.get());
+          reduced = half;
+          src = reduced.get();
         }
-        u = 0.0;
-        v += dv;
+      }
+
+      switch (dst->pixelFormat()) {
+        case IMAGE_RGB:       resize_image_bilinear_rgba(src, dst); break;
+        case IMAGE_GRAYSCALE: resize_image_bilinear_graya(src, dst); break;
+        case IMAGE_INDEXED:
+          resize_image_bilinear_indexed(src, dst, pal, rgbmap, maskColor);
+          break;
       }
       break;
     }
@@ -0,0 +1,99 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "doc/algorithm/resize_image.h"
+
+#include "doc/color.h"
+#include "doc/image.h"
+#include "doc/image_ref.h"
+#include "doc/primitives.h"
+
+using namespace doc;
+using namespace gfx;
+
+TEST(ResizeImage, NearestExactMultiple)
+{
+  ImageRef src(Image::create(IMAGE_RGB, 2, 2));
+  src->putPixel(0, 0, rgba(255, 0, 0, 255));
+  src->putPixel(1, 0, rgba(0, 255, 0, 255));
+  src->putPixel(0, 1, rgba(0, 0, 255, 255));
+  src->putPixel(1, 1, rgba(255, 255, 0, 255));
+
+  ImageRef dst(Image::create(IMAGE_RGB, 4, 4));
+  algorithm::resize_image(src.get(),
+                          dst.get(),
+                          algorithm::RESIZE_METHOD_NEAREST_NEIGHBOR,
+                          nullptr,
+                          nullptr,
+                          0);
+
+  for (int y = 0; y < 4; ++y)
+    for (int x = 0; x < 4; ++x)
+      EXPECT_EQ(src->getPixel(x / 2, y / 2), dst->getPixel(x, y)) << "at " << x << "," << y;
+}
+
+TEST(ResizeImage, BilinearUniformColorStaysUniform)
+{
+  const color_t c = rgba(120, 70, 30, 255);
+  ImageRef src(Image::create(IMAGE_RGB, 10, 10));
+  clear_image(src.get(), c);
+
+  ImageRef dst(Image::create(IMAGE_RGB, 37, 23));
+  algorithm::resize_image(src.get(), dst.get(), algorithm::RESIZE_METHOD_BILINEAR, nullptr, nullptr, 0);
+
+  for (int y = 0; y < dst->height(); ++y)
+    for (int x = 0; x < dst->width(); ++x)
+      EXPECT_EQ(c, dst->getPixel(x, y)) << "at " << x << "," << y;
+}
+
+TEST(ResizeImage, BilinearPreservesCorners)
+{
+  ImageRef src(Image::create(IMAGE_RGB, 5, 4));
+  clear_image(src.get(), rgba(128, 128, 128, 255));
+  src->putPixel(0, 0, rgba(255, 0, 0, 255));
+  src->putPixel(4, 0, rgba(0, 255, 0, 255));
+  src->putPixel(0, 3, rgba(0, 0, 255, 255));
+  src->putPixel(4, 3, rgba(255, 255, 255, 255));
+
+  ImageRef dst(Image::create(IMAGE_RGB, 31, 17));
+  algorithm::resize_image(src.get(), dst.get(), algorithm::RESIZE_METHOD_BILINEAR, nullptr, nullptr, 0);
+
+  EXPECT_EQ(src->getPixel(0, 0), dst->getPixel(0, 0));
+  EXPECT_EQ(src->getPixel(4, 0), dst->getPixel(30, 0));
+  EXPECT_EQ(src->getPixel(0, 3), dst->getPixel(0, 16));
+  EXPECT_EQ(src->getPixel(4, 3), dst->getPixel(30, 16));
+}
+
+TEST(ResizeImage, BilinearDownscaleAveragesAllPixels)
+{
+  // A single bright pixel on a big image must still contribute to a
+  // heavy downscale (the 2x2 box-filtered pre-reduction guarantees
+  // it, a sparse bilinear sample at full resolution would miss it).
+  ImageRef src(Image::create(IMAGE_RGB, 8, 8));
+  clear_image(src.get(), rgba(0, 0, 0, 255));
+  src->putPixel(1, 1, rgba(255, 255, 255, 255));
+
+  ImageRef dst(Image::create(IMAGE_RGB, 2, 2));
+  algorithm::resize_image(src.get(), dst.get(), algorithm::RESIZE_METHOD_BILINEAR, nullptr, nullptr, 0);
+
+  // Two box halvings: 255 -> 64 -> 16 in the top-left quadrant
+  EXPECT_EQ(rgba(16, 16, 16, 255), dst->getPixel(0, 0));
+  EXPECT_EQ(rgba(0, 0, 0, 255), dst->getPixel(1, 0));
+  EXPECT_EQ(rgba(0, 0, 0, 255), dst->getPixel(0, 1));
+  EXPECT_EQ(rgba(0, 0, 0, 255), dst->getPixel(1, 1));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
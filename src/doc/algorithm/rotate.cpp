@@ -12,6 +12,7 @@
 #endif
 
 #include "base/pi.h"
+#include "base/thread_pool.h"
 #include "doc/blend_funcs.h"
 #include "doc/image.h"
 #include "doc/mask.h"
@@ -19,7 +20,9 @@
 #include "doc/primitives_fast.h"
 #include "fixmath/fixmath.h"
 
+#include <algorithm>
 #include <cmath>
+#include <thread>
 
 namespace doc { namespace algorithm {
 
@@ -321,8 +324,15 @@ public:
     ASSERT(m_it != m_end);
 
     int c = get_pixel_fast<RgbTraits>(spr, spr_x, spr_y);
-    if ((rgba_geta(m_mask_color) == 0) || ((c & rgba_rgb_mask) != (m_mask_color & rgba_rgb_mask)))
-      *m_it = rgba_blender_normal(*m_it, c);
+    if ((rgba_geta(m_mask_color) == 0) || ((c & rgba_rgb_mask) != (m_mask_color & rgba_rgb_mask))) {
+      // Fully opaque/transparent pixels don't need the blender
+      // (the common case when rotating regular cels).
+      const int a = rgba_geta(c);
+      if (a == 255)
+        *m_it = c;
+      else if (a != 0)
+        *m_it = rgba_blender_normal(*m_it, c);
+    }
   }
 
 private:
@@ -415,6 +425,11 @@ private:
  *  and last point in which the horizontal line passing through the centre is
  *  at least partly covered by the sprite. This is useful for doing
  *  anti-aliased blending.
+ *  Only the scanlines in the [draw_y0, draw_y1) range are drawn, so the
+ *  output can be partitioned in horizontal bands processed in parallel:
+ *  each worker traverses all the scanlines (the edge stepping is
+ *  incremental, but it's just a few fixed point additions per row) and
+ *  rasterizes only its own band.
  */
 template<class Traits, class Delegate>
 static void ase_parallelogram_map(Image* bmp,
@@ -423,7 +438,9 @@ static void ase_parallelogram_map(Image* bmp,
                                   fixed xs[4],
                                   fixed ys[4],
                                   int sub_pixel_accuracy,
-                                  Delegate delegate)
+                                  Delegate delegate,
+                                  int draw_y0,
+                                  int draw_y1)
 {
   /* Index in xs[] and ys[] to topmost point. */
   int top_index;
@@ -683,7 +700,7 @@ static void ase_parallelogram_map(Image* bmp,
       r_bmp_x_rounded = clip_right;
 
     /* Draw! */
-    if (l_bmp_x_rounded <= r_bmp_x_rounded) {
+    if (l_bmp_x_rounded <= r_bmp_x_rounded && bmp_y_i >= draw_y0 && bmp_y_i < draw_y1) {
       if (!sub_pixel_accuracy) {
         /* The bodies of these ifs are only reached extremely seldom,
            it's an ugly hack to avoid reading outside the sprite when
@@ -794,6 +811,56 @@ static void ase_parallelogram_map(Image* bmp,
   }
 }
 
+/* Partitions the destination scanlines covered by the parallelogram in
+   horizontal bands processed in parallel (each output row depends only
+   on the source image, so bands are independent). Workers draw disjoint
+   scanlines, each delegate copy locks the bits of its own rows. Small
+   outputs are not worth the dispatch overhead and keep the
+   single-threaded path. */
+template<class Traits, class Delegate>
+static void ase_parallelogram_map_banded(Image* bmp,
+                                         const Image* spr,
+                                         const Image* mask,
+                                         fixed xs[4],
+                                         fixed ys[4],
+                                         const Delegate& delegate)
+{
+  // Destination rows covered by the parallelogram, clipped to the
+  // image bounds.
+  int y0 = fixtoi(std::min({ ys[0], ys[1], ys[2], ys[3] }));
+  int y1 = fixtoi(std::max({ ys[0], ys[1], ys[2], ys[3] })) + 1;
+  y0 = std::max(y0, 0);
+  y1 = std::min(y1, bmp->height());
+
+  static base::thread_pool pool(std::max<int>(2, std::thread::hardware_concurrency()));
+  const int threads = std::max<int>(2, std::thread::hardware_concurrency());
+  const int minRowsPerBand = 64;
+  const int nbands = std::clamp((y1 - y0) / minRowsPerBand, 1, threads);
+  if (nbands <= 1) {
+    ase_parallelogram_map<Traits,
+                          Delegate>(bmp, spr, mask, xs, ys, false, delegate, 0, bmp->height());
+    return;
+  }
+
+  const int bandHeight = (y1 - y0) / nbands;
+  for (int i = 0; i < nbands; ++i) {
+    const int band_y0 = y0 + i * bandHeight;
+    const int band_y1 = (i == nbands - 1 ? y1 : band_y0 + bandHeight);
+    pool.execute([bmp, spr, mask, xs, ys, delegate, band_y0, band_y1] {
+      ase_parallelogram_map<Traits, Delegate>(bmp,
+                                              spr,
+                                              mask,
+                                              xs,
+                                              ys,
+                                              false,
+                                              delegate,
+                                              band_y0,
+                                              band_y1);
+    });
+  }
+  pool.wait_all();
+}
+
 /* _parallelogram_map_standard:
  *  Helper function for calling _parallelogram_map() with the appropriate
  *  scanline drawer. I didn't want to include this in the
@@ -809,55 +876,51 @@ static void ase_parallelogram_map_standard(Image* bmp,
   switch (bmp->pixelFormat()) {
     case IMAGE_RGB: {
       RgbDelegate delegate(sprite->maskColor());
-      ase_parallelogram_map<RgbTraits, RgbDelegate>(bmp, sprite, mask, xs, ys, false, delegate);
+      ase_parallelogram_map_banded<RgbTraits, RgbDelegate>(bmp, sprite, mask, xs, ys, delegate);
       break;
     }
 
     case IMAGE_GRAYSCALE: {
       GrayscaleDelegate delegate(sprite->maskColor());
-      ase_parallelogram_map<GrayscaleTraits, GrayscaleDelegate>(bmp,
-                                                                sprite,
-                                                                mask,
-                                                                xs,
-                                                                ys,
-                                                                false,
-                                                                delegate);
+      ase_parallelogram_map_banded<GrayscaleTraits, GrayscaleDelegate>(bmp,
+                                                                       sprite,
+                                                                       mask,
+                                                                       xs,
+                                                                       ys,
+                                                                       delegate);
       break;
     }
 
     case IMAGE_INDEXED: {
       IndexedDelegate delegate(sprite->maskColor());
-      ase_parallelogram_map<IndexedTraits, IndexedDelegate>(bmp,
-                                                            sprite,
-                                                            mask,
-                                                            xs,
-                                                            ys,
-                                                            false,
-                                                            delegate);
+      ase_parallelogram_map_banded<IndexedTraits, IndexedDelegate>(bmp,
+                                                                   sprite,
+                                                                   mask,
+                                                                   xs,
+                                                                   ys,
+                                                                   delegate);
       break;
     }
 
     case IMAGE_BITMAP: {
       BitmapDelegate delegate;
-      ase_parallelogram_map<BitmapTraits, BitmapDelegate>(bmp,
-                                                          sprite,
-                                                          mask,
-                                                          xs,
-                                                          ys,
-                                                          false,
-                                                          delegate);
+      ase_parallelogram_map_banded<BitmapTraits, BitmapDelegate>(bmp,
+                                                                 sprite,
+                                                                 mask,
+                                                                 xs,
+                                                                 ys,
+                                                                 delegate);
       break;
     }
 
     case IMAGE_TILEMAP: {
       TilemapDelegate delegate(sprite->maskColor());
-      ase_parallelogram_map<TilemapTraits, TilemapDelegate>(bmp,
-                                                            sprite,
-                                                            mask,
-                                                            xs,
-                                                            ys,
-                                                            false,
-                                                            delegate);
+      ase_parallelogram_map_banded<TilemapTraits, TilemapDelegate>(bmp,
+                                                                   sprite,
+                                                                   mask,
+                                                                   xs,
+                                                                   ys,
+                                                                   delegate);
       break;
     }
   }
@@ -9,12 +9,14 @@
   #include "config.h"
 #endif
 
+#include "base/thread_pool.h"
 #include "doc/algorithm/rotate.h"
 #include "doc/image.h"
 #include "doc/primitives.h"
 
 #include <algorithm>
 #include <memory>
+#include <thread>
 
 namespace doc { namespace algorithm {
 
@@ -22,8 +24,11 @@ namespace doc { namespace algorithm {
 // http://en.wikipedia.org/wiki/Pixel_art_scaling_algorithms#EPX.2FScale2.C3.97.2FAdvMAME2.C3.97
 // http://scale2x.sourceforge.net/algorithm.html
 // http://scale2x.sourceforge.net/scale2xandepx.html
+// Scales the [y0, y1) band of src rows into dst. Each output row only
+// reads src rows y-1..y+1, so disjoint bands can be processed by
+// different threads without synchronization.
 template<typename ImageTraits>
-static void image_scale2x_tpl(Image* dst, const Image* src, int src_w, int src_h)
+static void image_scale2x_tpl(Image* dst, const Image* src, int src_w, int src_h, int y0, int y1)
 {
 #if 0 // TODO complete this implementation that should be faster
       // than using a lot of get/put_pixel_fast calls.
@@ -123,12 +128,12 @@ static void image_scale2x_tpl(Image* dst, const Image* src, int src_w, int src_h
   #define D c[3]
   #define P c[4]
 
-  LockImageBits<ImageTraits> dstBits(dst, gfx::Rect(0, 0, src_w * 2, src_h * 2));
+  LockImageBits<ImageTraits> dstBits(dst, gfx::Rect(0, 2 * y0, src_w * 2, 2 * (y1 - y0)));
   auto dstIt = dstBits.begin();
   auto dstIt2 = dstIt;
 
   color_t c[5];
-  for (int y = 0; y < src_h; ++y) {
+  for (int y = y0; y < y1; ++y) {
     dstIt2 += src_w * 2;
     for (int x = 0; x < src_w; ++x) {
       P = get_pixel_fast<ImageTraits>(src, x, y);
@@ -153,14 +158,38 @@ static void image_scale2x_tpl(Image* dst, const Image* src, int src_w, int src_h
 #endif
 }
 
-static void image_scale2x(Image* dst, const Image* src, int src_w, int src_h)
+static void image_scale2x_band(Image* dst, const Image* src, int src_w, int src_h, int y0, int y1)
 {
   switch (src->pixelFormat()) {
-    case IMAGE_RGB:       image_scale2x_tpl<RgbTraits>(dst, src, src_w, src_h); break;
-    case IMAGE_GRAYSCALE: image_scale2x_tpl<GrayscaleTraits>(dst, src, src_w, src_h); break;
-    case IMAGE_INDEXED:   image_scale2x_tpl<IndexedTraits>(dst, src, src_w, src_h); break;
-    case IMAGE_BITMAP:    image_scale2x_tpl<BitmapTraits>(dst, src, src_w, src_h); break;
+    case IMAGE_RGB:       image_scale2x_tpl<RgbTraits>(dst, src, src_w, src_h, y0, y1); break;
+    case IMAGE_GRAYSCALE: image_scale2x_tpl<GrayscaleTraits>(dst, src, src_w, src_h, y0, y1); break;
+    case IMAGE_INDEXED:   image_scale2x_tpl<IndexedTraits>(dst, src, src_w, src_h, y0, y1); break;
+    case IMAGE_BITMAP:    image_scale2x_tpl<BitmapTraits>(dst, src, src_w, src_h, y0, y1); break;
+  }
+}
+
+static void image_scale2x(Image* dst, const Image* src, int src_w, int src_h)
+{
+  // Partition the output into horizontal bands processed in parallel
+  // (small images are not worth the dispatch overhead).
+  static base::thread_pool pool(std::max<int>(2, std::thread::hardware_concurrency()));
+  const int threads = std::max<int>(2, std::thread::hardware_concurrency());
+  const int minRowsPerBand = 64;
+  const int nbands = std::clamp(src_h / minRowsPerBand, 1, threads);
+  if (nbands == 1) {
+    image_scale2x_band(dst, src, src_w, src_h, 0, src_h);
+    return;
+  }
+
+  const int bandHeight = src_h / nbands;
+  for (int i = 0; i < nbands; ++i) {
+    const int y0 = i * bandHeight;
+    const int y1 = (i == nbands - 1 ? src_h : y0 + bandHeight);
+    pool.execute([dst, src, src_w, src_h, y0, y1] {
+      image_scale2x_band(dst, src, src_w, src_h, y0, y1);
+    });
   }
+  pool.wait_all();
 }
 
 void rotsprite_image(Image* bmp,
@@ -175,7 +204,7 @@ void rotsprite_image(Image* bmp,
                      int x4,
                      int y4)
 {
-  static ImageBufferPtr buf[3]; // TODO non-thread safe
+  static thread_local ImageBufferPtr buf[3];
 
   for (int i = 0; i < 3; ++i)
     if (!buf[i])
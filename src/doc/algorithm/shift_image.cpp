@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2019-2020 Igara Studio S.A.
+// Copyright (c) 2019-2026 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -14,16 +14,87 @@
 #include "base/pi.h"
 #include "doc/algorithm/shrink_bounds.h"
 #include "doc/cel.h"
+#include "doc/dispatch.h"
 #include "doc/image.h"
 #include "doc/layer.h"
 #include "doc/mask.h"
 #include "doc/primitives.h"
 #include "gfx/rect.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace doc { namespace algorithm {
 
+namespace {
+
+// Copies all the rows of "src" into the (x0, y0, src size) rectangle
+// of "dst", displacing them (dx, dy) pixels with wraparound inside
+// that rectangle. Each row is moved with two block copies (split at
+// the dx column) instead of one put_pixel() per pixel. dx/dy must be
+// already normalized to [0, w) x [0, h).
+template<typename ImageTraits>
+void shift_rows_templ(Image* dst,
+                      const Image* src,
+                      const int x0,
+                      const int y0,
+                      const int dx,
+                      const int dy)
+{
+  using address_t = typename ImageTraits::address_t;
+
+  const int w = src->width();
+  const int h = src->height();
+  for (int y = 0; y < h; ++y) {
+    auto s = (address_t)src->getPixelAddress(0, y);
+    auto d = (address_t)dst->getPixelAddress(x0, y0 + (y + dy) % h);
+    std::copy(s, s + (w - dx), d + dx);
+    std::copy(s + (w - dx), s + w, d);
+  }
+}
+
+// Generic fallback for IMAGE_BITMAP where we cannot copy row blocks
+// byte by byte.
+void shift_rows_slow(Image* dst,
+                     const Image* src,
+                     const int x0,
+                     const int y0,
+                     const int dx,
+                     const int dy)
+{
+  const int w = src->width();
+  const int h = src->height();
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      put_pixel(dst, x0 + (x + dx) % w, y0 + (y + dy) % h, get_pixel(src, x, y));
+    }
+  }
+}
+
+void shift_rows(Image* dst, const Image* src, const int x0, const int y0, int dx, int dy)
+{
+  // Use floor modulo (Euclidean remainder) to normalize the
+  // displacement.
+  dx = ((dx % src->width()) + src->width()) % src->width();
+  dy = ((dy % src->height()) + src->height()) % src->height();
+
+  if (dst->colorMode() == ColorMode::BITMAP) {
+    shift_rows_slow(dst, src, x0, y0, dx, dy);
+    return;
+  }
+
+  DOC_DISPATCH_BY_COLOR_MODE_EXCLUDE_BITMAP(dst->colorMode(),
+                                            shift_rows_templ,
+                                            dst,
+                                            src,
+                                            x0,
+                                            y0,
+                                            dx,
+                                            dy);
+}
+
+} // anonymous namespace
+
 void shift_image(Image* image, int dx, int dy, double angle)
 {
   gfx::Rect bounds(image->bounds());
@@ -47,14 +118,7 @@ void shift_image(Image* image, int dx, int dy, double angle)
   // could avoid this copy swapping rows and columns.
   ImageRef crop(crop_image(image, bounds.x, bounds.y, bounds.w, bounds.h, image->maskColor()));
 
-  for (int y = 0; y < bounds.h; ++y) {
-    for (int x = 0; x < bounds.w; ++x) {
-      put_pixel(image,
-                (bounds.w + dx + x) % bounds.w,
-                (bounds.h + dy + y) % bounds.h,
-                get_pixel(crop.get(), x, y));
-    }
-  }
+  shift_rows(image, crop.get(), 0, 0, dx, dy);
 }
 
 ImageRef shift_image_with_mask(const Cel* cel,
@@ -94,25 +158,7 @@ ImageRef shift_image_with_mask(const Cel* cel,
   imageToShift->copy(compImage.get(), gfx::Clip(0, 0, maskedBounds));
 
   // Shifting the masked area of the COMPOUND IMAGE (compImage).
-  const int xInitial = maskedBounds.x;
-  const int yInitial = maskedBounds.y;
-  const int wMask = maskedBounds.w;
-  const int hMask = maskedBounds.h;
-  for (int y = 0; y < hMask; ++y) {
-    for (int x = 0; x < wMask; ++x) {
-      // Use floor modulo (Euclidean remainder).
-      // Shifts are broken out and stored in separate variables
-      // to make them easier to recognize and change in the event
-      // that rem_eucl is implemented formally in the future.
-      const int xShift = ((dx + x) % wMask + wMask) % wMask;
-      const int yShift = ((dy + y) % hMask + hMask) % hMask;
-
-      put_pixel(compImage.get(),
-                xInitial + xShift,
-                yInitial + yShift,
-                get_pixel(imageToShift.get(), x, y));
-    }
-  }
+  shift_rows(compImage.get(), imageToShift.get(), maskedBounds.x, maskedBounds.y, dx, dy);
 
   // Bounds and Image shrinking (we have to fit compound image (compImage) and bounds
   // (compCelBounds))
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2019-2023 Igara Studio S.A.
+// Copyright (c) 2019-2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -20,8 +20,17 @@
 #include "doc/primitives_fast.h"
 #include "doc/tileset.h"
 
+#include <algorithm>
 #include <thread>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+  #define DOC_SHRINK_BOUNDS_SSE2 1
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #define DOC_SHRINK_BOUNDS_NEON 1
+  #include <arm_neon.h>
+#endif
+
 namespace doc { namespace algorithm {
 
 namespace {
@@ -57,56 +66,247 @@ bool is_same_pixel<BitmapTraits>(color_t pixel1, color_t pixel2)
   return pixel1 == pixel2;
 }
 
+// Compares a group of consecutive row pixels against the reference
+// color with the same semantics as is_same_pixel(). Specialized per
+// ImageTraits with SIMD compares; the generic version disables the
+// vectorized path in row_find_first_diff()/row_find_last_diff().
+template<typename ImageTraits>
+struct RowScan {
+  static constexpr bool enabled = false;
+  static constexpr int pixels_per_step = 1;
+
+  explicit RowScan(const color_t) {}
+  bool allSame(const typename ImageTraits::pixel_t*) const { return false; }
+};
+
+#if DOC_SHRINK_BOUNDS_SSE2
+
+template<>
+struct RowScan<RgbTraits> {
+  static constexpr bool enabled = true;
+  static constexpr int pixels_per_step = 4;
+
+  explicit RowScan(const color_t refpixel)
+    : m_ref(_mm_set1_epi32(int(refpixel)))
+    , m_refTransparent(rgba_geta(refpixel) == 0)
+  {
+  }
+
+  bool allSame(const uint32_t* p) const
+  {
+    const __m128i v = _mm_loadu_si128((const __m128i*)p);
+    __m128i eq = _mm_cmpeq_epi32(v, m_ref);
+    if (m_refTransparent) {
+      const __m128i a = _mm_and_si128(v, _mm_set1_epi32(int(rgba_a_mask)));
+      eq = _mm_or_si128(eq, _mm_cmpeq_epi32(a, _mm_setzero_si128()));
+    }
+    return (_mm_movemask_epi8(eq) == 0xffff);
+  }
+
+  __m128i m_ref;
+  bool m_refTransparent;
+};
+
+template<>
+struct RowScan<GrayscaleTraits> {
+  static constexpr bool enabled = true;
+  static constexpr int pixels_per_step = 8;
+
+  explicit RowScan(const color_t refpixel)
+    : m_ref(_mm_set1_epi16(short(refpixel)))
+    , m_refTransparent(graya_geta(refpixel) == 0)
+  {
+  }
+
+  bool allSame(const uint16_t* p) const
+  {
+    const __m128i v = _mm_loadu_si128((const __m128i*)p);
+    __m128i eq = _mm_cmpeq_epi16(v, m_ref);
+    if (m_refTransparent) {
+      const __m128i a = _mm_and_si128(v, _mm_set1_epi16(short(graya_a_mask)));
+      eq = _mm_or_si128(eq, _mm_cmpeq_epi16(a, _mm_setzero_si128()));
+    }
+    return (_mm_movemask_epi8(eq) == 0xffff);
+  }
+
+  __m128i m_ref;
+  bool m_refTransparent;
+};
+
+template<>
+struct RowScan<IndexedTraits> {
+  static constexpr bool enabled = true;
+  static constexpr int pixels_per_step = 16;
+
+  explicit RowScan(const color_t refpixel) : m_ref(_mm_set1_epi8(char(refpixel))) {}
+
+  bool allSame(const uint8_t* p) const
+  {
+    const __m128i v = _mm_loadu_si128((const __m128i*)p);
+    return (_mm_movemask_epi8(_mm_cmpeq_epi8(v, m_ref)) == 0xffff);
+  }
+
+  __m128i m_ref;
+};
+
+#elif DOC_SHRINK_BOUNDS_NEON
+
+template<>
+struct RowScan<RgbTraits> {
+  static constexpr bool enabled = true;
+  static constexpr int pixels_per_step = 4;
+
+  explicit RowScan(const color_t refpixel)
+    : m_ref(vdupq_n_u32(refpixel))
+    , m_refTransparent(rgba_geta(refpixel) == 0)
+  {
+  }
+
+  bool allSame(const uint32_t* p) const
+  {
+    const uint32x4_t v = vld1q_u32(p);
+    uint32x4_t eq = vceqq_u32(v, m_ref);
+    if (m_refTransparent) {
+      const uint32x4_t a = vandq_u32(v, vdupq_n_u32(rgba_a_mask));
+      eq = vorrq_u32(eq, vceqq_u32(a, vdupq_n_u32(0)));
+    }
+    return (vminvq_u32(eq) == 0xffffffff);
+  }
+
+  uint32x4_t m_ref;
+  bool m_refTransparent;
+};
+
+template<>
+struct RowScan<GrayscaleTraits> {
+  static constexpr bool enabled = true;
+  static constexpr int pixels_per_step = 8;
+
+  explicit RowScan(const color_t refpixel)
+    : m_ref(vdupq_n_u16(uint16_t(refpixel)))
+    , m_refTransparent(graya_geta(refpixel) == 0)
+  {
+  }
+
+  bool allSame(const uint16_t* p) const
+  {
+    const uint16x8_t v = vld1q_u16(p);
+    uint16x8_t eq = vceqq_u16(v, m_ref);
+    if (m_refTransparent) {
+      const uint16x8_t a = vandq_u16(v, vdupq_n_u16(graya_a_mask));
+      eq = vorrq_u16(eq, vceqq_u16(a, vdupq_n_u16(0)));
+    }
+    return (vminvq_u16(eq) == 0xffff);
+  }
+
+  uint16x8_t m_ref;
+  bool m_refTransparent;
+};
+
+template<>
+struct RowScan<IndexedTraits> {
+  static constexpr bool enabled = true;
+  static constexpr int pixels_per_step = 16;
+
+  explicit RowScan(const color_t refpixel) : m_ref(vdupq_n_u8(uint8_t(refpixel))) {}
+
+  bool allSame(const uint8_t* p) const
+  {
+    return (vminvq_u8(vceqq_u8(vld1q_u8(p), m_ref)) == 0xff);
+  }
+
+  uint8x16_t m_ref;
+};
+
+#endif
+
+// Returns the index of the first pixel in ptr[0..n) that is different
+// from refpixel, or n if the whole row matches.
+template<typename ImageTraits>
+int row_find_first_diff(const typename ImageTraits::pixel_t* ptr, const int n, color_t refpixel)
+{
+  int x = 0;
+  if constexpr (RowScan<ImageTraits>::enabled) {
+    const RowScan<ImageTraits> scan(refpixel);
+    constexpr int step = RowScan<ImageTraits>::pixels_per_step;
+    for (; x + step <= n; x += step) {
+      // The scalar loop below finds the exact pixel inside the group
+      if (!scan.allSame(ptr + x))
+        break;
+    }
+  }
+  for (; x < n; ++x) {
+    if (!is_same_pixel<ImageTraits>(ptr[x], refpixel))
+      return x;
+  }
+  return n;
+}
+
+// Returns the index of the last pixel in ptr[0..n) that is different
+// from refpixel, or -1 if the whole row matches.
 template<typename ImageTraits>
-bool shrink_bounds_left_templ(const Image* image, gfx::Rect& bounds, color_t refpixel, int rowPixels)
+int row_find_last_diff(const typename ImageTraits::pixel_t* ptr, const int n, color_t refpixel)
 {
-  int u, v;
-  // Shrink left side
-  for (u = bounds.x; u < bounds.x2(); ++u) {
-    auto ptr = get_pixel_address_fast<ImageTraits>(image, u, v = bounds.y);
-    for (; v < bounds.y2(); ++v, ptr += rowPixels) {
-      ASSERT(ptr == get_pixel_address_fast<ImageTraits>(image, u, v));
-      if (!is_same_pixel<ImageTraits>(*ptr, refpixel))
-        return (!bounds.isEmpty());
+  int x = n;
+  if constexpr (RowScan<ImageTraits>::enabled) {
+    const RowScan<ImageTraits> scan(refpixel);
+    constexpr int step = RowScan<ImageTraits>::pixels_per_step;
+    for (; x >= step; x -= step) {
+      if (!scan.allSame(ptr + x - step))
+        break;
     }
-    ++bounds.x;
-    --bounds.w;
   }
+  for (int i = x - 1; i >= 0; --i) {
+    if (!is_same_pixel<ImageTraits>(ptr[i], refpixel))
+      return i;
+  }
+  return -1;
+}
+
+template<typename ImageTraits>
+bool shrink_bounds_left_templ(const Image* image, gfx::Rect& bounds, color_t refpixel)
+{
+  // Shrink left side: the new left side is the minimum column (among
+  // all rows) with a pixel different from refpixel. Scanning row by
+  // row (instead of column by column) keeps the memory access
+  // sequential so several pixels can be matched per instruction, and
+  // each row only needs to be scanned up to the minimum found so far.
+  int firstDiff = bounds.w;
+  for (int v = bounds.y; v < bounds.y2() && firstDiff > 0; ++v) {
+    auto ptr = get_pixel_address_fast<ImageTraits>(image, bounds.x, v);
+    firstDiff = std::min(firstDiff, row_find_first_diff<ImageTraits>(ptr, firstDiff, refpixel));
+  }
+  bounds.x += firstDiff;
+  bounds.w -= firstDiff;
   return (!bounds.isEmpty());
 }
 
 template<typename ImageTraits>
-bool shrink_bounds_right_templ(const Image* image,
-                               gfx::Rect& bounds,
-                               color_t refpixel,
-                               int rowPixels)
+bool shrink_bounds_right_templ(const Image* image, gfx::Rect& bounds, color_t refpixel)
 {
-  int u, v;
-  // Shrink right side
-  for (u = bounds.x2() - 1; u >= bounds.x; --u) {
-    auto ptr = get_pixel_address_fast<ImageTraits>(image, u, v = bounds.y);
-    for (; v < bounds.y2(); ++v, ptr += rowPixels) {
-      ASSERT(ptr == get_pixel_address_fast<ImageTraits>(image, u, v));
-      if (!is_same_pixel<ImageTraits>(*ptr, refpixel))
-        return (!bounds.isEmpty());
-    }
-    --bounds.w;
+  // Shrink right side: the maximum column with a pixel different from
+  // refpixel (each row is scanned starting from the maximum found so
+  // far).
+  int lastDiff = -1;
+  for (int v = bounds.y; v < bounds.y2() && lastDiff < bounds.w - 1; ++v) {
+    auto ptr = get_pixel_address_fast<ImageTraits>(image, bounds.x, v);
+    const int i =
+      row_find_last_diff<ImageTraits>(ptr + lastDiff + 1, bounds.w - lastDiff - 1, refpixel);
+    if (i >= 0)
+      lastDiff += 1 + i;
   }
+  bounds.w = lastDiff + 1;
   return (!bounds.isEmpty());
 }
 
 template<typename ImageTraits>
 bool shrink_bounds_top_templ(const Image* image, gfx::Rect& bounds, color_t refpixel)
 {
-  int u, v;
   // Shrink top side
-  for (v = bounds.y; v < bounds.y2(); ++v) {
-    auto ptr = get_pixel_address_fast<ImageTraits>(image, u = bounds.x, v);
-    for (; u < bounds.x2(); ++u, ++ptr) {
-      ASSERT(ptr == get_pixel_address_fast<ImageTraits>(image, u, v));
-      if (!is_same_pixel<ImageTraits>(*ptr, refpixel))
-        return (!bounds.isEmpty());
-    }
+  for (int v = bounds.y; v < bounds.y2(); ++v) {
+    auto ptr = get_pixel_address_fast<ImageTraits>(image, bounds.x, v);
+    if (row_find_first_diff<ImageTraits>(ptr, bounds.w, refpixel) < bounds.w)
+      return (!bounds.isEmpty());
     ++bounds.y;
     --bounds.h;
   }
@@ -116,15 +316,11 @@ bool shrink_bounds_top_templ(const Image* image, gfx::Rect& bounds, color_t refp
 template<typename ImageTraits>
 bool shrink_bounds_bottom_templ(const Image* image, gfx::Rect& bounds, color_t refpixel)
 {
-  int u, v;
   // Shrink bottom side
-  for (v = bounds.y2() - 1; v >= bounds.y; --v) {
-    auto ptr = get_pixel_address_fast<ImageTraits>(image, u = bounds.x, v);
-    for (; u < bounds.x2(); ++u, ++ptr) {
-      ASSERT(ptr == get_pixel_address_fast<ImageTraits>(image, u, v));
-      if (!is_same_pixel<ImageTraits>(*ptr, refpixel))
-        return (!bounds.isEmpty());
-    }
+  for (int v = bounds.y2() - 1; v >= bounds.y; --v) {
+    auto ptr = get_pixel_address_fast<ImageTraits>(image, bounds.x, v);
+    if (row_find_first_diff<ImageTraits>(ptr, bounds.w, refpixel) < bounds.w)
+      return (!bounds.isEmpty());
     --bounds.h;
   }
   return (!bounds.isEmpty());
@@ -133,8 +329,6 @@ bool shrink_bounds_bottom_templ(const Image* image, gfx::Rect& bounds, color_t r
 template<typename ImageTraits>
 bool shrink_bounds_templ(const Image* image, gfx::Rect& bounds, color_t refpixel)
 {
-  // Pixels per row
-  const int rowPixels = image->rowPixels();
   const int canvasSize = image->width() * image->height();
   if ((std::thread::hardware_concurrency() >= 4) &&
       ((image->pixelFormat() == IMAGE_RGB && canvasSize >= 800 * 800) ||
@@ -144,9 +338,9 @@ bool shrink_bounds_templ(const Image* image, gfx::Rect& bounds, color_t refpixel
     // TODO use a base::thread_pool and a base::task for each border
 
     std::thread left(
-      [&] { shrink_bounds_left_templ<ImageTraits>(image, leftBounds, refpixel, rowPixels); });
+      [&] { shrink_bounds_left_templ<ImageTraits>(image, leftBounds, refpixel); });
     std::thread right(
-      [&] { shrink_bounds_right_templ<ImageTraits>(image, rightBounds, refpixel, rowPixels); });
+      [&] { shrink_bounds_right_templ<ImageTraits>(image, rightBounds, refpixel); });
     std::thread top([&] { shrink_bounds_top_templ<ImageTraits>(image, topBounds, refpixel); });
     std::thread bottom(
       [&] { shrink_bounds_bottom_templ<ImageTraits>(image, bottomBounds, refpixel); });
@@ -161,8 +355,8 @@ bool shrink_bounds_templ(const Image* image, gfx::Rect& bounds, color_t refpixel
     return !bounds.isEmpty();
   }
   else {
-    return shrink_bounds_left_templ<ImageTraits>(image, bounds, refpixel, rowPixels) &&
-           shrink_bounds_right_templ<ImageTraits>(image, bounds, refpixel, rowPixels) &&
+    return shrink_bounds_left_templ<ImageTraits>(image, bounds, refpixel) &&
+           shrink_bounds_right_templ<ImageTraits>(image, bounds, refpixel) &&
            shrink_bounds_top_templ<ImageTraits>(image, bounds, refpixel) &&
            shrink_bounds_bottom_templ<ImageTraits>(image, bounds, refpixel);
   }
@@ -358,24 +552,38 @@ bool shrink_bounds(const Image* image, const color_t refpixel, const Layer* laye
 
 bool shrink_cel_bounds(const Cel* cel, const color_t refpixel, gfx::Rect& bounds)
 {
-  if (shrink_bounds(cel->image(), refpixel, cel->layer(), bounds)) {
-    // For tilemaps, we have to convert imgBounds (in tiles
-    // coordinates) to canvas coordinates using the Grid specs.
-    if (cel->layer()->isTilemap()) {
+  // For tilemaps we don't use the CelData cache, as the cel content
+  // depends on the tileset pixels too (not just on the tilemap image
+  // version).
+  if (cel->layer()->isTilemap()) {
+    if (shrink_bounds(cel->image(), refpixel, cel->layer(), bounds)) {
+      // We have to convert bounds (in tiles coordinates) to canvas
+      // coordinates using the Grid specs.
       doc::LayerTilemap* tilemapLayer = static_cast<doc::LayerTilemap*>(cel->layer());
       doc::Tileset* tileset = tilemapLayer->tileset();
       doc::Grid grid = tileset->grid();
       grid.origin(grid.origin() + cel->position());
       bounds = grid.tileToCanvas(bounds);
+      return true;
     }
-    else {
-      bounds.offset(cel->position());
-    }
-    return true;
-  }
-  else {
     return false;
   }
+
+  // Reuse the content bounds cached in the CelData when the cel image
+  // wasn't modified since the last scan (so repeated trims/exports
+  // don't rescan unchanged cels). An empty cached rectangle means
+  // that the whole image matches the reference color.
+  const CelData* celData = cel->data();
+  if (!celData->getContentBoundsCache(refpixel, bounds)) {
+    if (!shrink_bounds(cel->image(), refpixel, nullptr, bounds))
+      bounds = gfx::Rect();
+    celData->setContentBoundsCache(refpixel, bounds);
+  }
+  if (bounds.isEmpty())
+    return false;
+
+  bounds.offset(cel->position());
+  return true;
 }
 
 bool shrink_bounds2(const Image* a, const Image* b, const gfx::Rect& startBounds, gfx::Rect& bounds)
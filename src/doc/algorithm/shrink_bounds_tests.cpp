@@ -0,0 +1,76 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "doc/algorithm/shrink_bounds.h"
+
+#include "doc/color.h"
+#include "doc/image.h"
+#include "doc/image_ref.h"
+#include "doc/primitives.h"
+
+using namespace doc;
+using namespace gfx;
+
+template<typename T>
+class ShrinkBounds : public testing::Test {
+protected:
+  ShrinkBounds() {}
+};
+
+using ImageCanvasTraits = testing::Types<RgbTraits, GrayscaleTraits, IndexedTraits>;
+TYPED_TEST_SUITE(ShrinkBounds, ImageCanvasTraits);
+
+TYPED_TEST(ShrinkBounds, TrimToContent)
+{
+  using ImageTraits = TypeParam;
+
+  // Odd size so the vectorized row scans leave a scalar remainder
+  ImageRef img(Image::create(ImageTraits::pixel_format, 73, 69));
+  clear_image(img.get(), 0);
+
+  gfx::Rect rc;
+  EXPECT_FALSE(algorithm::shrink_bounds(img.get(), 0, nullptr, rc));
+
+  put_pixel(img.get(), 31, 20, 1);
+  EXPECT_TRUE(algorithm::shrink_bounds(img.get(), 0, nullptr, rc));
+  EXPECT_EQ(gfx::Rect(31, 20, 1, 1), rc);
+
+  put_pixel(img.get(), 70, 66, 1);
+  EXPECT_TRUE(algorithm::shrink_bounds(img.get(), 0, nullptr, rc));
+  EXPECT_EQ(gfx::Rect(31, 20, 40, 47), rc);
+
+  put_pixel(img.get(), 0, 0, 1);
+  put_pixel(img.get(), 72, 68, 1);
+  EXPECT_TRUE(algorithm::shrink_bounds(img.get(), 0, nullptr, rc));
+  EXPECT_EQ(img->bounds(), rc);
+}
+
+TEST(ShrinkBoundsRgb, TransparentPixelsMatchTransparentRef)
+{
+  // Fully transparent pixels match a transparent reference color even
+  // when their RGB values differ
+  ImageRef img(Image::create(IMAGE_RGB, 40, 40));
+  clear_image(img.get(), rgba(90, 60, 30, 0));
+
+  gfx::Rect rc;
+  EXPECT_FALSE(algorithm::shrink_bounds(img.get(), rgba(0, 0, 0, 0), nullptr, rc));
+
+  put_pixel(img.get(), 10, 12, rgba(255, 0, 0, 255));
+  EXPECT_TRUE(algorithm::shrink_bounds(img.get(), rgba(0, 0, 0, 0), nullptr, rc));
+  EXPECT_EQ(gfx::Rect(10, 12, 1, 1), rc);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
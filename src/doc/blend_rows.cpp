@@ -0,0 +1,290 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "doc/blend_rows.h"
+
+#include "doc/blend_funcs.h"
+#include "doc/blend_internals.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+  #define DOC_BLEND_ROWS_SSE2 1
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #define DOC_BLEND_ROWS_NEON 1
+  #include <arm_neon.h>
+#endif
+
+namespace doc {
+
+namespace {
+
+// Generic fallback: apply the scalar per-pixel blender along the row.
+// One indirect call per row instead of one per pixel.
+template<BlendFunc F>
+void rgba_row_scalar(color_t* dst, const color_t* src, int n, int opacity, color_t maskColor)
+{
+  for (int x = 0; x < n; ++x, ++dst, ++src) {
+    if (*src != maskColor)
+      *dst = F(*dst, *src, opacity);
+  }
+}
+
+// SRC copies every source pixel, including transparent/mask-colored
+// ones, just like the BlendMode::SRC case of BlenderHelper.
+void rgba_row_src(color_t* dst, const color_t* src, int n, int opacity, color_t maskColor)
+{
+  std::copy(src, src + n, dst);
+}
+
+#if DOC_BLEND_ROWS_SSE2
+
+// SSE2 normal ("over") blend. Real layers are dominated by runs of
+// fully-opaque and fully-transparent pixels: opaque source pixels just
+// replace the destination and transparent ones are no-ops, so both can
+// be resolved four at a time with a couple of compares. Only groups
+// that mix partial alpha fall back to the scalar blender, keeping the
+// result bit-exact with rgba_blender_normal().
+void rgba_row_sse2_normal(color_t* dst, const color_t* src, int n, int opacity, color_t maskColor)
+{
+  const __m128i aMask = _mm_set1_epi32(0xff000000);
+  const __m128i vMaskColor = _mm_set1_epi32(int(maskColor));
+  const bool fullOpacity = (opacity == 255);
+
+  int x = 0;
+  for (; x + 4 <= n; x += 4, dst += 4, src += 4) {
+    const __m128i s = _mm_loadu_si128((const __m128i*)src);
+
+    // Pixels to skip: alpha == 0 or equal to the mask color
+    const __m128i alpha = _mm_and_si128(s, aMask);
+    const __m128i skip = _mm_or_si128(_mm_cmpeq_epi32(alpha, _mm_setzero_si128()),
+                                      _mm_cmpeq_epi32(s, vMaskColor));
+    const int skipBits = _mm_movemask_epi8(skip);
+    if (skipBits == 0xffff)
+      continue; // Whole group is transparent
+
+    if (fullOpacity) {
+      const __m128i opaque = _mm_cmpeq_epi32(alpha, aMask);
+      if ((_mm_movemask_epi8(_mm_or_si128(opaque, skip))) == 0xffff) {
+        // Each pixel is either opaque (copy src) or skipped (keep dst)
+        const __m128i d = _mm_loadu_si128((const __m128i*)dst);
+        const __m128i r = _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, s));
+        _mm_storeu_si128((__m128i*)dst, r);
+        continue;
+      }
+    }
+
+    // Mixed group with partial alpha: exact scalar blend
+    rgba_row_scalar<rgba_blender_normal>(dst, src, 4, opacity, maskColor);
+  }
+
+  if (x < n)
+    rgba_row_scalar<rgba_blender_normal>(dst, src, n - x, opacity, maskColor);
+}
+
+#endif // DOC_BLEND_ROWS_SSE2
+
+#if DOC_BLEND_ROWS_NEON
+
+// NEON variant of the opaque/transparent group classifier (see the
+// SSE2 kernel above for the rationale).
+void rgba_row_neon_normal(color_t* dst, const color_t* src, int n, int opacity, color_t maskColor)
+{
+  const uint32x4_t aMask = vdupq_n_u32(0xff000000);
+  const uint32x4_t vMaskColor = vdupq_n_u32(maskColor);
+  const bool fullOpacity = (opacity == 255);
+
+  int x = 0;
+  for (; x + 4 <= n; x += 4, dst += 4, src += 4) {
+    const uint32x4_t s = vld1q_u32(src);
+
+    const uint32x4_t alpha = vandq_u32(s, aMask);
+    const uint32x4_t skip = vorrq_u32(vceqq_u32(alpha, vdupq_n_u32(0)), vceqq_u32(s, vMaskColor));
+    if (vminvq_u32(skip) == 0xffffffff)
+      continue; // Whole group is transparent
+
+    if (fullOpacity) {
+      const uint32x4_t opaque = vceqq_u32(alpha, aMask);
+      if (vminvq_u32(vorrq_u32(opaque, skip)) == 0xffffffff) {
+        const uint32x4_t d = vld1q_u32(dst);
+        vst1q_u32(dst, vbslq_u32(skip, d, s));
+        continue;
+      }
+    }
+
+    rgba_row_scalar<rgba_blender_normal>(dst, src, 4, opacity, maskColor);
+  }
+
+  if (x < n)
+    rgba_row_scalar<rgba_blender_normal>(dst, src, n - x, opacity, maskColor);
+}
+
+#endif // DOC_BLEND_ROWS_NEON
+
+} // anonymous namespace
+
+BlendRowFunc get_rgba_row_blender(BlendMode blendMode, const bool newBlend)
+{
+  // Mirrors get_rgba_blender() but returns row-oriented wrappers (the
+  // template instantiation bakes the per-pixel function into the loop,
+  // so the compiler can inline it).
+#define ROW(name)          rgba_row_scalar<rgba_blender_##name>
+#define ROW_NEW(name)      (newBlend ? ROW(name##_n) : ROW(name))
+
+  switch (blendMode) {
+    case BlendMode::SRC:       return rgba_row_src;
+    case BlendMode::MERGE:     return ROW(merge);
+    case BlendMode::NEG_BW:    return ROW(neg_bw);
+    case BlendMode::RED_TINT:  return ROW(red_tint);
+    case BlendMode::BLUE_TINT: return ROW(blue_tint);
+    case BlendMode::DST_OVER:  return ROW(normal_dst_over);
+
+    case BlendMode::NORMAL:
+#if DOC_BLEND_ROWS_SSE2
+      return rgba_row_sse2_normal;
+#elif DOC_BLEND_ROWS_NEON
+      return rgba_row_neon_normal;
+#else
+      return ROW(normal);
+#endif
+
+    case BlendMode::MULTIPLY:       return ROW_NEW(multiply);
+    case BlendMode::SCREEN:         return ROW_NEW(screen);
+    case BlendMode::OVERLAY:        return ROW_NEW(overlay);
+    case BlendMode::DARKEN:         return ROW_NEW(darken);
+    case BlendMode::LIGHTEN:        return ROW_NEW(lighten);
+    case BlendMode::COLOR_DODGE:    return ROW_NEW(color_dodge);
+    case BlendMode::COLOR_BURN:     return ROW_NEW(color_burn);
+    case BlendMode::HARD_LIGHT:     return ROW_NEW(hard_light);
+    case BlendMode::SOFT_LIGHT:     return ROW_NEW(soft_light);
+    case BlendMode::DIFFERENCE:     return ROW_NEW(difference);
+    case BlendMode::EXCLUSION:      return ROW_NEW(exclusion);
+    case BlendMode::HSL_HUE:        return ROW_NEW(hsl_hue);
+    case BlendMode::HSL_SATURATION: return ROW_NEW(hsl_saturation);
+    case BlendMode::HSL_COLOR:      return ROW_NEW(hsl_color);
+    case BlendMode::HSL_LUMINOSITY: return ROW_NEW(hsl_luminosity);
+    case BlendMode::ADDITION:       return ROW_NEW(addition);
+    case BlendMode::SUBTRACT:       return ROW_NEW(subtract);
+    case BlendMode::DIVIDE:         return ROW_NEW(divide);
+  }
+
+#undef ROW
+#undef ROW_NEW
+
+  ASSERT(false);
+  return rgba_row_src;
+}
+
+void rgba_blend_color_row(color_t* dst,
+                          const color_t* src,
+                          const int n,
+                          const color_t color,
+                          const int opacity)
+{
+  int t;
+  const int sa = MUL_UN8(rgba_geta(color), opacity, t);
+
+  // Fully transparent paint: keep the backdrop
+  if (sa == 0) {
+    if (dst != src)
+      std::copy(src, src + n, dst);
+    return;
+  }
+
+  // The scaled paint, i.e. the result over a transparent backdrop
+  const color_t colorSa = (color & rgba_rgb_mask) | (sa << rgba_a_shift);
+
+  // Fully opaque paint replaces any backdrop
+  if (sa == 255) {
+    std::fill(dst, dst + n, colorSa);
+    return;
+  }
+
+  auto scalarRun = [color, opacity](color_t* d, const color_t* s, int count) {
+    for (int i = 0; i < count; ++i, ++d, ++s)
+      *d = rgba_blender_normal(*s, color, opacity);
+  };
+
+#if DOC_BLEND_ROWS_SSE2
+  // Groups of four transparent backdrops take the scaled paint and
+  // groups of four opaque backdrops use a vector kernel (with Ba=255
+  // the composite simplifies to Ra=255, Rc = Bc + (Sc-Bc)*Sa/255,
+  // truncated toward zero exactly like rgba_blender_normal()). Groups
+  // mixing partial alpha fall back to the scalar blender.
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i aMask = _mm_set1_epi32(0xff000000);
+  const __m128i vColorSa = _mm_set1_epi32(int(colorSa));
+  const __m128i c16 = _mm_unpacklo_epi8(_mm_set1_epi32(int(color)), zero);
+  const __m128i vSa = _mm_set1_epi16(short(sa));
+  const __m128i vDiv255 = _mm_set1_epi16(short(0x8081));
+
+  int x = 0;
+  for (; x + 4 <= n; x += 4, dst += 4, src += 4) {
+    const __m128i s = _mm_loadu_si128((const __m128i*)src);
+    const __m128i alpha = _mm_and_si128(s, aMask);
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xffff) {
+      _mm_storeu_si128((__m128i*)dst, vColorSa);
+      continue;
+    }
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, aMask)) == 0xffff) {
+      const __m128i b16[2] = { _mm_unpacklo_epi8(s, zero), _mm_unpackhi_epi8(s, zero) };
+      __m128i r16[2];
+      for (int h = 0; h < 2; ++h) {
+        // (Sc-Bc)*Sa/255 on the magnitude, reapplying the sign to
+        // match C's truncated division for negative deltas
+        const __m128i diff = _mm_sub_epi16(c16, b16[h]);
+        const __m128i sign = _mm_cmpgt_epi16(zero, diff);
+        const __m128i mag = _mm_sub_epi16(_mm_xor_si128(diff, sign), sign);
+        const __m128i prod = _mm_mullo_epi16(mag, vSa);
+        // Exact floor(prod/255) for any 16-bit dividend
+        __m128i q = _mm_srli_epi16(_mm_mulhi_epu16(prod, vDiv255), 7);
+        q = _mm_sub_epi16(_mm_xor_si128(q, sign), sign);
+        r16[h] = _mm_add_epi16(b16[h], q);
+      }
+      const __m128i r = _mm_or_si128(_mm_packus_epi16(r16[0], r16[1]), aMask);
+      _mm_storeu_si128((__m128i*)dst, r);
+      continue;
+    }
+
+    scalarRun(dst, src, 4);
+  }
+
+  if (x < n)
+    scalarRun(dst, src, n - x);
+#elif DOC_BLEND_ROWS_NEON
+  // Transparent groups take the scaled paint; everything else goes
+  // through the scalar blender to stay bit-exact.
+  const uint32x4_t aMask = vdupq_n_u32(0xff000000);
+  const uint32x4_t vColorSa = vdupq_n_u32(colorSa);
+
+  int x = 0;
+  for (; x + 4 <= n; x += 4, dst += 4, src += 4) {
+    const uint32x4_t s = vld1q_u32(src);
+    const uint32x4_t alpha = vandq_u32(s, aMask);
+
+    if (vmaxvq_u32(alpha) == 0) {
+      vst1q_u32(dst, vColorSa);
+      continue;
+    }
+
+    scalarRun(dst, src, 4);
+  }
+
+  if (x < n)
+    scalarRun(dst, src, n - x);
+#else
+  scalarRun(dst, src, n);
+#endif
+}
+
+} // namespace doc
@@ -0,0 +1,40 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef DOC_BLEND_ROWS_H_INCLUDED
+#define DOC_BLEND_ROWS_H_INCLUDED
+#pragma once
+
+#include "doc/blend_mode.h"
+#include "doc/color.h"
+
+namespace doc {
+
+// Blends a row of "n" contiguous RGBA pixels from "src" over "dst".
+// Pixels equal to "maskColor" in "src" are skipped (same semantics as
+// the per-pixel BlenderHelper). Row blenders are the bulk counterpart
+// of BlendFunc: one call per scanline instead of one call per pixel.
+typedef void (*BlendRowFunc)(color_t* dst,
+                             const color_t* src,
+                             int n,
+                             int opacity,
+                             color_t maskColor);
+
+// Returns the best row blender available for the given blend mode
+// (SSE2/NEON kernels when compiled for those targets, falling back to
+// a scalar loop with the regular BlendFunc inlined).
+BlendRowFunc get_rgba_row_blender(BlendMode blendMode, bool newBlend);
+
+// Blends the constant "color" over a row of "n" RGBA pixels read from
+// "src", writing the results into "dst". Bit-exact with calling
+// rgba_blender_normal(src[i], color, opacity) per pixel ("src" and
+// "dst" can point to the same row). Used by paint inks to process
+// whole scanlines of a brush stamp at once.
+void rgba_blend_color_row(color_t* dst, const color_t* src, int n, color_t color, int opacity);
+
+} // namespace doc
+
+#endif
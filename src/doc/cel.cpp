@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2019-2024 Igara Studio S.A.
+// Copyright (c) 2019-2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -172,6 +172,24 @@ void Cel::copyNonsharedPropertiesFrom(const Cel* fromCel)
   setZIndex(fromCel->zIndex());
 }
 
+void Cel::discardCompressedData()
+{
+  if (!m_compressedData.empty()) {
+    m_compressedData.clear();
+    m_compressedDataImageId = NullId;
+    m_compressedDataVersion = 0;
+  }
+}
+
+void Cel::setCompressedData(const base::buffer& buffer) const
+{
+  if (!buffer.empty() && image()) {
+    m_compressedData = buffer;
+    m_compressedDataImageId = image()->id();
+    m_compressedDataVersion = image()->version();
+  }
+}
+
 void Cel::fixupImage()
 {
   // Change the mask color to the sprite mask color
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2019-2024 Igara Studio S.A.
+// Copyright (c) 2019-2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,6 +9,7 @@
 #define DOC_CEL_H_INCLUDED
 #pragma once
 
+#include "base/buffer.h"
 #include "base/disable_copying.h"
 #include "doc/cel_data.h"
 #include "doc/frame.h"
@@ -70,6 +71,18 @@ public:
   void setParentLayer(LayerImage* layer);
   Grid grid() const;
 
+  // Cached compressed pixel data of the cel image read/written
+  // directly from .aseprite files (same mechanism as
+  // Tileset::compressedData() for tilesets). The cache is valid only
+  // while the cel still references the same image object with the
+  // same version, i.e. while the pixels weren't modified since the
+  // file was loaded.
+  void discardCompressedData();
+  void setCompressedData(const base::buffer& buffer) const;
+  const base::buffer& compressedData() const { return m_compressedData; }
+  ObjectId compressedDataImageId() const { return m_compressedDataImageId; }
+  ObjectVersion compressedDataVersion() const { return m_compressedDataVersion; }
+
   // Copies properties that are not shared between linked cels
   // (CelData), like the z-index.
   void copyNonsharedPropertiesFrom(const Cel* fromCel);
@@ -82,6 +95,11 @@ private:
   CelDataRef m_data;
   int m_zIndex = 0;
 
+  // See compressedData()
+  mutable base::buffer m_compressedData;
+  mutable ObjectId m_compressedDataImageId = NullId;
+  mutable ObjectVersion m_compressedDataVersion = 0;
+
   Cel();
   DISABLE_COPYING(Cel);
 };
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2019-2022 Igara Studio S.A.
+// Copyright (c) 2019-2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -26,6 +26,8 @@ CelData::CelData(const ImageRef& image)
   , m_opacity(255)
   , m_bounds(0, 0, image ? image->width() : 0, image ? image->height() : 0)
   , m_boundsF(nullptr)
+  , m_contentBoundsVersion(0)
+  , m_contentBoundsRefColor(0)
 {
 }
 
@@ -35,6 +37,8 @@ CelData::CelData(const CelData& celData)
   , m_opacity(celData.m_opacity)
   , m_bounds(celData.m_bounds)
   , m_boundsF(celData.m_boundsF ? std::make_unique<gfx::RectF>(*celData.m_boundsF) : nullptr)
+  , m_contentBoundsVersion(0)
+  , m_contentBoundsRefColor(0)
 {
 }
 
@@ -47,6 +51,11 @@ void CelData::setImage(const ImageRef& image, Layer* layer)
   ASSERT(image.get());
 
   m_image = image;
+
+  // The content bounds cache is keyed with the version counter of the
+  // old image, which is unrelated to the new image's one.
+  m_contentBounds.reset();
+
   adjustBounds(layer);
 }
 
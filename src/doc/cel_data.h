@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,6 +9,7 @@
 #define DOC_CEL_DATA_H_INCLUDED
 #pragma once
 
+#include "doc/color.h"
 #include "doc/image_ref.h"
 #include "doc/object.h"
 #include "doc/with_user_data.h"
@@ -79,6 +80,33 @@ public:
 
   bool hasBoundsF() const { return m_boundsF != nullptr; }
 
+  // Cached content bounds: the result of
+  // doc::algorithm::shrink_cel_bounds() in image coordinates (i.e.
+  // without the cel position applied). An empty rectangle means that
+  // the whole image matches the reference color. The cache is keyed
+  // with the image version, so any undoable command that modifies the
+  // pixels (and calls Image::incrementVersion()) invalidates it
+  // automatically, and repeated trims/exports don't rescan unchanged
+  // cels.
+  bool getContentBoundsCache(color_t refpixel, gfx::Rect& bounds) const
+  {
+    if (!m_contentBounds || m_contentBoundsVersion != m_image->version() ||
+        m_contentBoundsRefColor != refpixel)
+      return false;
+    bounds = *m_contentBounds;
+    return true;
+  }
+
+  void setContentBoundsCache(color_t refpixel, const gfx::Rect& bounds) const
+  {
+    if (m_contentBounds)
+      *m_contentBounds = bounds;
+    else
+      m_contentBounds = std::make_unique<gfx::Rect>(bounds);
+    m_contentBoundsVersion = m_image->version();
+    m_contentBoundsRefColor = refpixel;
+  }
+
   virtual int getMemSize() const override
   {
     ASSERT(m_image);
@@ -95,6 +123,12 @@ private:
   // Special bounds for reference layers that can have subpixel
   // position.
   mutable std::unique_ptr<gfx::RectF> m_boundsF;
+
+  // Cache for get/setContentBoundsCache(), valid only while the
+  // image version matches m_contentBoundsVersion.
+  mutable std::unique_ptr<gfx::Rect> m_contentBounds;
+  mutable ObjectVersion m_contentBoundsVersion;
+  mutable color_t m_contentBoundsRefColor;
 };
 
 typedef std::shared_ptr<CelData> CelDataRef;
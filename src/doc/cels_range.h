@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2023 Igara Studio S.A.
+// Copyright (c) 2023-2026 Igara Studio S.A.
 // Copyright (c) 2001-2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -10,19 +10,18 @@
 #pragma once
 
 #include "doc/cel_list.h"
-#include "doc/frame.h"
-#include "doc/object_id.h"
-#include "doc/selected_frames.h"
-
-#include <set>
 
 namespace doc {
 
-class Cel;
-class Layer;
 class SelectedFrames;
 class Sprite;
 
+// Contiguous list of the sprite cels that belong to the given frames,
+// built once at construction time. Iterating the range is just a scan
+// over one flat array, instead of chasing the layer hierarchy and
+// looking up each (layer, frame) pair again on every step (which is
+// cache-hostile on sprites with many layers). Cels are ordered by
+// layer (bottom layer first) and, inside each layer, by frame.
 class CelsRange {
 public:
   enum Flags {
@@ -32,51 +31,19 @@ public:
 
   CelsRange(const Sprite* sprite, const SelectedFrames& selFrames, const Flags flags = ALL);
 
-  class iterator {
-  public:
-    typedef Cel* value_type;
-    typedef std::ptrdiff_t difference_type;
-    typedef Cel** pointer;
-    typedef Cel*& reference;
-    typedef std::forward_iterator_tag iterator_category;
-
-    iterator(const SelectedFrames& selFrames);
-    iterator(const Sprite* sprite, const SelectedFrames& selFrames, const Flags flags);
-
-    bool operator==(const iterator& other) const { return m_cel == other.m_cel; }
-
-    bool operator!=(const iterator& other) const { return !operator==(other); }
-
-    Cel* operator*() const { return m_cel; }
-
-    iterator& operator++();
-
-  private:
-    Cel* m_cel;
-    const SelectedFrames& m_selFrames;
-    frames::const_iterator m_frameIterator;
-    Flags m_flags;
-    std::set<ObjectId> m_visited;
-  };
+  using iterator = CelList::const_iterator;
 
-  iterator begin() { return m_begin; }
-  iterator end() { return m_end; }
+  iterator begin() const { return m_cels.begin(); }
+  iterator end() const { return m_cels.end(); }
 
-  int size()
-  {
-    int count = 0;
-    for (auto it = begin(), e = end(); it != e; ++it)
-      ++count;
-    return count;
-  }
+  int size() const { return int(m_cels.size()); }
 
   // Converts the CelsRange into a CelList (which indeed it's an
   // array).
-  CelList toList();
+  CelList toList() const { return m_cels; }
 
 private:
-  SelectedFrames m_selFrames;
-  iterator m_begin, m_end;
+  CelList m_cels;
 };
 
 } // namespace doc
@@ -1,4 +1,5 @@
 // Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,12 +13,34 @@
 
 #include "doc/primitives.h"
 #include "doc/primitives_fast.h"
+#include "gfx/point.h"
+
+#include <algorithm>
 
 namespace doc {
 
+CompressedImage::CompressedImage()
+  : m_image(nullptr)
+  , m_imageId(NullId)
+  , m_imageVersion(0)
+  , m_diffColors(false)
+{
+}
+
 CompressedImage::CompressedImage(const Image* image, const Image* maskBitmap, bool diffColors)
-  : m_image(image)
+  : CompressedImage()
+{
+  regenerate(image, maskBitmap, diffColors);
+}
+
+void CompressedImage::regenerate(const Image* image, const Image* maskBitmap, bool diffColors)
 {
+  m_image = image;
+  m_imageId = image->id();
+  m_imageVersion = image->version();
+  m_diffColors = diffColors;
+  m_scanlines.clear();
+
   color_t c1, c2, mask = image->maskColor();
 
   for (int y = 0; y < image->height(); ++y) {
@@ -59,4 +82,30 @@ CompressedImage::CompressedImage(const Image* image, const Image* maskBitmap, bo
   }
 }
 
+gfx::Rect CompressedImage::bounds() const
+{
+  gfx::Rect bounds;
+  for (const Scanline& scanline : m_scanlines)
+    bounds |= gfx::Rect(scanline.x, scanline.y, scanline.w, 1);
+  return bounds;
+}
+
+bool CompressedImage::contains(int x, int y) const
+{
+  // Scanlines are generated top to bottom and left to right, so we
+  // can binary search the last scanline that starts at or before the
+  // given point.
+  auto it = std::upper_bound(m_scanlines.begin(),
+                             m_scanlines.end(),
+                             gfx::Point(x, y),
+                             [](const gfx::Point& pt, const Scanline& scanline) {
+                               return (pt.y < scanline.y) ||
+                                      (pt.y == scanline.y && pt.x < scanline.x);
+                             });
+  if (it == m_scanlines.begin())
+    return false;
+  --it;
+  return (it->y == y && x >= it->x && x < it->x + it->w);
+}
+
 } // namespace doc
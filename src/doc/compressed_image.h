@@ -1,4 +1,5 @@
 // Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -10,6 +11,9 @@
 
 #include "doc/color.h"
 #include "doc/image.h"
+#include "doc/object_id.h"
+#include "doc/object_version.h"
+#include "gfx/rect.h"
 
 #include <vector>
 
@@ -26,12 +30,29 @@ public:
   typedef std::vector<Scanline> Scanlines;
   typedef Scanlines::const_iterator const_iterator;
 
+  // Creates an empty compressed image, regenerate() must be called
+  // before using it.
+  CompressedImage();
+
   // If diffColors is true, it generates one Scanline instance for
   // each different color. If it's false, it generates a scanline
   // for each row of consecutive pixels different than the mask
   // color.
   CompressedImage(const Image* image, const Image* maskBitmap, bool diffColors);
 
+  // Rebuilds the scanlines from the given image reusing the already
+  // allocated scanline storage.
+  void regenerate(const Image* image, const Image* maskBitmap, bool diffColors);
+
+  // Returns true if the scanlines still represent the given source
+  // image, so a caller that keeps the CompressedImage alive can
+  // regenerate it only when the source pixels really changed.
+  bool isUpToDate(const Image* image, const bool diffColors) const
+  {
+    return (image && image->id() == m_imageId && image->version() == m_imageVersion &&
+            diffColors == m_diffColors);
+  }
+
   const_iterator begin() const { return m_scanlines.begin(); }
   const_iterator end() const { return m_scanlines.end(); }
 
@@ -39,8 +60,20 @@ public:
   int width() const { return m_image->width(); }
   int height() const { return m_image->height(); }
 
+  bool empty() const { return m_scanlines.empty(); }
+
+  // Tight bounds of the compressed pixels, O(scanlines).
+  gfx::Rect bounds() const;
+
+  // Returns true if the point is inside a scanline (i.e. the pixel
+  // is not masked/transparent), O(log(scanlines)).
+  bool contains(int x, int y) const;
+
 private:
   const Image* m_image;
+  ObjectId m_imageId;
+  ObjectVersion m_imageVersion;
+  bool m_diffColors;
   Scanlines m_scanlines;
 };
 
@@ -0,0 +1,103 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "doc/compressed_image.h"
+#include "doc/image.h"
+#include "doc/primitives.h"
+
+using namespace doc;
+
+TEST(CompressedImage, ScanlinesAndQueries)
+{
+  std::unique_ptr<Image> image(Image::create(IMAGE_INDEXED, 8, 4));
+  clear_image(image.get(), 0);
+  // Two runs in row 1 and one run in row 2
+  put_pixel(image.get(), 1, 1, 5);
+  put_pixel(image.get(), 2, 1, 5);
+  put_pixel(image.get(), 5, 1, 5);
+  put_pixel(image.get(), 3, 2, 7);
+
+  CompressedImage ci(image.get(), nullptr, false);
+  ASSERT_FALSE(ci.empty());
+
+  auto it = ci.begin();
+  EXPECT_EQ(1, it->y);
+  EXPECT_EQ(1, it->x);
+  EXPECT_EQ(2, it->w);
+  ++it;
+  EXPECT_EQ(1, it->y);
+  EXPECT_EQ(5, it->x);
+  EXPECT_EQ(1, it->w);
+  ++it;
+  EXPECT_EQ(2, it->y);
+  EXPECT_EQ(3, it->x);
+  EXPECT_EQ(1, it->w);
+  ++it;
+  EXPECT_EQ(ci.end(), it);
+
+  EXPECT_EQ(gfx::Rect(1, 1, 5, 2), ci.bounds());
+
+  EXPECT_TRUE(ci.contains(1, 1));
+  EXPECT_TRUE(ci.contains(2, 1));
+  EXPECT_TRUE(ci.contains(5, 1));
+  EXPECT_TRUE(ci.contains(3, 2));
+  EXPECT_FALSE(ci.contains(0, 1));
+  EXPECT_FALSE(ci.contains(3, 1));
+  EXPECT_FALSE(ci.contains(6, 1));
+  EXPECT_FALSE(ci.contains(3, 0));
+  EXPECT_FALSE(ci.contains(3, 3));
+}
+
+TEST(CompressedImage, IsUpToDateAndRegenerate)
+{
+  std::unique_ptr<Image> image(Image::create(IMAGE_INDEXED, 4, 1));
+  clear_image(image.get(), 0);
+  put_pixel(image.get(), 1, 0, 3);
+
+  CompressedImage ci;
+  EXPECT_FALSE(ci.isUpToDate(image.get(), false));
+
+  ci.regenerate(image.get(), nullptr, false);
+  EXPECT_TRUE(ci.isUpToDate(image.get(), false));
+  EXPECT_FALSE(ci.isUpToDate(image.get(), true)); // Other diffColors value
+  EXPECT_EQ(gfx::Rect(1, 0, 1, 1), ci.bounds());
+
+  // A modified version of the image invalidates the scanlines
+  put_pixel(image.get(), 3, 0, 3);
+  image->incrementVersion();
+  EXPECT_FALSE(ci.isUpToDate(image.get(), false));
+
+  ci.regenerate(image.get(), nullptr, false);
+  EXPECT_TRUE(ci.isUpToDate(image.get(), false));
+  EXPECT_EQ(gfx::Rect(1, 0, 3, 1), ci.bounds());
+  EXPECT_TRUE(ci.contains(3, 0));
+  EXPECT_FALSE(ci.contains(2, 0));
+
+  // Another image instance (even with equal pixels) is not
+  // considered up-to-date because object IDs are never reused
+  std::unique_ptr<Image> other(Image::createCopy(image.get()));
+  EXPECT_FALSE(ci.isUpToDate(other.get(), false));
+
+  CompressedImage empty(other.get(), nullptr, false);
+  clear_image(other.get(), 0);
+  other->incrementVersion();
+  empty.regenerate(other.get(), nullptr, false);
+  EXPECT_TRUE(empty.empty());
+  EXPECT_TRUE(empty.bounds().isEmpty());
+  EXPECT_FALSE(empty.contains(1, 0));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
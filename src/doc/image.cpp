@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2018-2024 Igara Studio S.A.
+// Copyright (c) 2018-2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -17,9 +17,86 @@
 #include "doc/palette.h"
 #include "doc/primitives.h"
 #include "doc/rgbmap.h"
+#include "gfx/region.h"
+
+#include <algorithm>
+#include <cstring>
 
 namespace doc {
 
+namespace {
+
+int bytes_per_pixel(const ColorMode mode)
+{
+  switch (mode) {
+    case ColorMode::RGB:       return 4;
+    case ColorMode::GRAYSCALE: return 2;
+    case ColorMode::INDEXED:   return 1;
+    case ColorMode::TILEMAP:   return 4;
+    default:                   return 0;
+  }
+}
+
+// Converts one row of pixels between color modes for
+// Image::readRegion()/writeRegion(). Returns false if the conversion
+// is not supported ("palette" is required when the source pixels are
+// indexed).
+bool convert_row(const uint8_t* src,
+                 const ColorMode srcMode,
+                 uint8_t* dst,
+                 const ColorMode dstMode,
+                 const int w,
+                 const Palette* palette)
+{
+  if (srcMode == ColorMode::RGB && dstMode == ColorMode::GRAYSCALE) {
+    auto s = (const uint32_t*)src;
+    auto d = (uint16_t*)dst;
+    for (int x = 0; x < w; ++x, ++s, ++d)
+      *d = graya(rgba_luma(*s), rgba_geta(*s));
+    return true;
+  }
+  if (srcMode == ColorMode::GRAYSCALE && dstMode == ColorMode::RGB) {
+    auto s = (const uint16_t*)src;
+    auto d = (uint32_t*)dst;
+    for (int x = 0; x < w; ++x, ++s, ++d) {
+      const uint8_t v = graya_getv(*s);
+      *d = rgba(v, v, v, graya_geta(*s));
+    }
+    return true;
+  }
+  if (srcMode == ColorMode::INDEXED && palette) {
+    if (dstMode == ColorMode::RGB) {
+      auto d = (uint32_t*)dst;
+      for (int x = 0; x < w; ++x, ++d)
+        *d = (src[x] < palette->size() ? palette->getEntry(src[x]) : 0);
+      return true;
+    }
+    if (dstMode == ColorMode::GRAYSCALE) {
+      auto d = (uint16_t*)dst;
+      for (int x = 0; x < w; ++x, ++d) {
+        const color_t c = (src[x] < palette->size() ? palette->getEntry(src[x]) : 0);
+        *d = graya(rgba_luma(c), rgba_geta(c));
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+// Common checks of readRegion()/writeRegion(): sub-byte BITMAP pixels
+// don't fit the byte-span semantics, and tilemaps can only be copied
+// as tilemaps.
+bool supported_region_modes(const ColorMode a, const ColorMode b)
+{
+  if (a == ColorMode::BITMAP || b == ColorMode::BITMAP)
+    return false;
+  if ((a == ColorMode::TILEMAP || b == ColorMode::TILEMAP) && a != b)
+    return false;
+  return true;
+}
+
+} // anonymous namespace
+
 Image::Image(const ImageSpec& spec) : Object(ObjectType::Image), m_spec(spec)
 {
 }
@@ -33,6 +110,139 @@ int Image::getMemSize() const
   return sizeof(Image) + rowBytes() * height();
 }
 
+bool Image::readRegion(const gfx::Rect& bounds,
+                       const ColorMode dstColorMode,
+                       uint8_t* dst,
+                       const std::size_t dstRowBytes,
+                       const Palette* palette) const
+{
+  const ColorMode srcColorMode = colorMode();
+  if (!supported_region_modes(srcColorMode, dstColorMode))
+    return false;
+
+  const gfx::Rect rc = (bounds & this->bounds());
+  if (rc.isEmpty())
+    return true;
+
+  // The external buffer covers the requested bounds, skip the part
+  // clipped out on the top/left sides
+  const int dstBpp = bytes_per_pixel(dstColorMode);
+  dst += dstRowBytes * (rc.y - bounds.y) + std::size_t(dstBpp) * (rc.x - bounds.x);
+
+  const std::size_t rowSize = std::size_t(bytesPerPixel()) * rc.w;
+  for (int y = 0; y < rc.h; ++y) {
+    const uint8_t* srcRow = getPixelAddress(rc.x, rc.y + y);
+    uint8_t* dstRow = dst + dstRowBytes * y;
+
+    if (srcColorMode == dstColorMode)
+      std::memcpy(dstRow, srcRow, rowSize);
+    else if (!convert_row(srcRow, srcColorMode, dstRow, dstColorMode, rc.w, palette))
+      return false;
+  }
+  return true;
+}
+
+bool Image::writeRegion(const gfx::Rect& bounds,
+                        const ColorMode srcColorMode,
+                        const uint8_t* src,
+                        const std::size_t srcRowBytes,
+                        const Palette* palette)
+{
+  const ColorMode dstColorMode = colorMode();
+  if (!supported_region_modes(srcColorMode, dstColorMode))
+    return false;
+
+  const gfx::Rect rc = (bounds & this->bounds());
+  if (rc.isEmpty())
+    return true;
+
+  addDamage(rc);
+
+  const int srcBpp = bytes_per_pixel(srcColorMode);
+  src += srcRowBytes * (rc.y - bounds.y) + std::size_t(srcBpp) * (rc.x - bounds.x);
+
+  const std::size_t rowSize = std::size_t(bytesPerPixel()) * rc.w;
+  for (int y = 0; y < rc.h; ++y) {
+    const uint8_t* srcRow = src + srcRowBytes * y;
+    uint8_t* dstRow = getPixelAddress(rc.x, rc.y + y);
+
+    if (srcColorMode == dstColorMode)
+      std::memcpy(dstRow, srcRow, rowSize);
+    else if (!convert_row(srcRow, srcColorMode, dstRow, dstColorMode, rc.w, palette))
+      return false;
+  }
+  return true;
+}
+
+void Image::trackDamage(const bool state)
+{
+  if (state && m_damageTiles.empty()) {
+    m_damageCols = (width() + kDamageTileSize - 1) / kDamageTileSize;
+    const int rows = (height() + kDamageTileSize - 1) / kDamageTileSize;
+    m_damageTiles.assign(std::size_t(m_damageCols) * rows, 0);
+  }
+  else if (!state) {
+    m_damageTiles.clear();
+    m_damageCols = 0;
+  }
+}
+
+void Image::markDamagedTiles(const gfx::Rect& bounds)
+{
+  const gfx::Rect rc = (bounds & this->bounds());
+  if (rc.isEmpty())
+    return;
+
+  const int u1 = rc.x / kDamageTileSize;
+  const int u2 = (rc.x2() - 1) / kDamageTileSize;
+  const int v1 = rc.y / kDamageTileSize;
+  const int v2 = (rc.y2() - 1) / kDamageTileSize;
+  for (int v = v1; v <= v2; ++v)
+    std::fill(m_damageTiles.begin() + v * m_damageCols + u1,
+              m_damageTiles.begin() + v * m_damageCols + u2 + 1,
+              uint8_t(1));
+}
+
+gfx::Region Image::consumeDamage()
+{
+  gfx::Region rgn;
+  if (m_damageTiles.empty())
+    return rgn;
+
+  const int rows = int(m_damageTiles.size()) / m_damageCols;
+  for (int v = 0; v < rows; ++v) {
+    for (int u = 0; u < m_damageCols; ++u) {
+      if (!m_damageTiles[v * m_damageCols + u])
+        continue;
+
+      // Coalesce each horizontal run of damaged tiles in one rectangle
+      int u2 = u;
+      while (u2 + 1 < m_damageCols && m_damageTiles[v * m_damageCols + u2 + 1])
+        ++u2;
+
+      const gfx::Rect rc = gfx::Rect(u * kDamageTileSize,
+                                     v * kDamageTileSize,
+                                     (u2 - u + 1) * kDamageTileSize,
+                                     kDamageTileSize) &
+                           bounds();
+      rgn.createUnion(rgn, gfx::Region(rc));
+      u = u2;
+    }
+  }
+  std::fill(m_damageTiles.begin(), m_damageTiles.end(), uint8_t(0));
+  return rgn;
+}
+
+uint64_t Image::contentHash() const
+{
+  if (!m_hashValid || m_hashVersion != version()) {
+    m_hash = calculate_image_hash64(this);
+    m_hashVersion = version();
+    m_hashValid = true;
+  }
+  return m_hash;
+}
+
 // static
 Image* Image::create(PixelFormat format, int width, int height, const ImageBufferPtr& buffer)
 {
@@ -63,4 +273,22 @@ Image* Image::createCopy(const Image* image, const ImageBufferPtr& buffer)
   return crop_image(image, 0, 0, image->width(), image->height(), image->maskColor(), buffer);
 }
 
+// static
+Image* Image::createWrap(const ImageSpec& spec, uint8_t* pixels, const std::size_t rowBytes)
+{
+  ASSERT(pixels);
+  ASSERT(spec.width() >= 1 && spec.height() >= 1);
+  if (!pixels || spec.width() < 1 || spec.height() < 1)
+    return nullptr;
+
+  switch (spec.colorMode()) {
+    case ColorMode::RGB:       return new ImageImpl<RgbTraits>(spec, pixels, rowBytes);
+    case ColorMode::GRAYSCALE: return new ImageImpl<GrayscaleTraits>(spec, pixels, rowBytes);
+    case ColorMode::INDEXED:   return new ImageImpl<IndexedTraits>(spec, pixels, rowBytes);
+    case ColorMode::BITMAP:    return new ImageImpl<BitmapTraits>(spec, pixels, rowBytes);
+    case ColorMode::TILEMAP:   return new ImageImpl<TilemapTraits>(spec, pixels, rowBytes);
+  }
+  return nullptr;
+}
+
 } // namespace doc
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2018-2024 Igara Studio S.A.
+// Copyright (c) 2018-2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -20,6 +20,12 @@
 #include "gfx/rect.h"
 #include "gfx/size.h"
 
+#include <vector>
+
+namespace gfx {
+class Region;
+}
+
 namespace doc {
 
 template<typename ImageTraits>
@@ -28,6 +34,21 @@ class Palette;
 class Pen;
 class RgbMap;
 
+// One row of pixels of an Image: a contiguous span of widthBytes()
+// bytes (the hidden alignment bytes after them are not part of the
+// span). This is a stable API for bulk pixel I/O from external
+// tooling (e.g. format plugins), so rows can be moved with memcpy
+// semantics instead of per-pixel get/put calls.
+struct ImageRowSpan {
+  uint8_t* data;
+  int size; // Bytes of visible pixels in the row
+};
+
+struct ImageConstRowSpan {
+  const uint8_t* data;
+  int size;
+};
+
 class Image : public Object {
 public:
   enum LockType {
@@ -43,6 +64,12 @@ public:
   static Image* create(const ImageSpec& spec, const ImageBufferPtr& buffer = ImageBufferPtr());
   static Image* createCopy(const Image* image, const ImageBufferPtr& buffer = ImageBufferPtr());
 
+  // Creates an image that wraps external pixel storage instead of
+  // owning it (e.g. the locked pixels of an os::Surface), using
+  // "rowBytes" as the distance between consecutive rows. The caller
+  // must keep the storage alive (and locked) while the image exists.
+  static Image* createWrap(const ImageSpec& spec, uint8_t* pixels, std::size_t rowBytes);
+
   virtual ~Image();
 
   const ImageSpec& spec() const { return m_spec; }
@@ -74,6 +101,42 @@ public:
 
   virtual int getMemSize() const override;
 
+  // Returns a hash of the pixel content, useful to compare images
+  // from different documents quickly (e.g. app::compare_docs()). The
+  // result is cached and recalculated only when the image version
+  // changes, so code modifying pixels directly must call
+  // incrementVersion() to keep it in sync (as all app::Cmds do).
+  uint64_t contentHash() const;
+
+  // Granularity of the optional damage accumulator (see
+  // trackDamage()): damage is recorded per tile of this many pixels
+  // on each side.
+  static constexpr int kDamageTileSize = 32;
+
+  // Optional damage tracking: when enabled, the image accumulates the
+  // modified area in a coarse tile bitmap that the mutation APIs
+  // below (putPixel, clear, copy, drawHLine, fillRect, blendRect, and
+  // writeRegion) keep updated, so consumers that today invalidate the
+  // whole image can derive the exact dirty region with
+  // consumeDamage(). Direct pixel access (LockImageBits, the
+  // doc/primitives_fast.h helpers) bypasses these APIs, so code
+  // writing pixels that way must call addDamage() itself.
+  bool trackingDamage() const { return !m_damageTiles.empty(); }
+  void trackDamage(const bool state);
+
+  // Marks "bounds" (clipped to the image bounds) as modified. Cheap
+  // no-op while tracking is disabled.
+  void addDamage(const gfx::Rect& bounds)
+  {
+    if (trackingDamage())
+      markDamagedTiles(bounds);
+  }
+
+  // Returns the area modified since tracking was enabled (or since
+  // the previous call) as tile-aligned rectangles clipped to the
+  // image bounds, and clears the accumulator.
+  gfx::Region consumeDamage();
+
   template<typename ImageTraits>
   ImageBits<ImageTraits> lockBits(LockType lockType, const gfx::Rect& bounds)
   {
@@ -104,6 +167,34 @@ public:
   virtual void fillRect(int x1, int y1, int x2, int y2, color_t color) = 0;
   virtual void blendRect(int x1, int y1, int x2, int y2, color_t color, int opacity) = 0;
 
+  // Span of the y-th row of pixels. Note that rows are not
+  // necessarily equally spaced in memory (e.g. images created in lazy
+  // strip mode, or wrapping an external buffer), so ask for each row
+  // instead of assuming a uniform stride from the first address.
+  ImageRowSpan rowSpan(const int y) { return ImageRowSpan{ getPixelAddress(0, y), widthBytes() }; }
+  ImageConstRowSpan rowSpan(const int y) const
+  {
+    return ImageConstRowSpan{ getPixelAddress(0, y), widthBytes() };
+  }
+
+  // Bulk copy of the "bounds" region (clipped to the image) to/from
+  // an external buffer of contiguous "colorMode" rows separated by
+  // "rowBytes" bytes. Same-mode copies are plain row memcpy's, and
+  // RGB <-> GRAYSCALE and INDEXED -> RGB/GRAYSCALE pixels (a palette
+  // is required to read indexed ones) are converted on the fly.
+  // Returns false for unsupported conversions (e.g. anything that
+  // would need an RgbMap, or sub-byte BITMAP pixels).
+  bool readRegion(const gfx::Rect& bounds,
+                  const ColorMode dstColorMode,
+                  uint8_t* dst,
+                  const std::size_t dstRowBytes,
+                  const Palette* palette = nullptr) const;
+  bool writeRegion(const gfx::Rect& bounds,
+                   const ColorMode srcColorMode,
+                   const uint8_t* src,
+                   const std::size_t srcRowBytes,
+                   const Palette* palette = nullptr);
+
   ReadIterator readArea() const { return ReadIterator(this, this->bounds()); }
   WriteIterator writeArea() { return WriteIterator(this, this->bounds()); }
 
@@ -126,7 +217,21 @@ protected:
   size_t m_rowBytes;
 
 private:
+  void markDamagedTiles(const gfx::Rect& bounds);
+
   ImageSpec m_spec;
+
+  // Damage accumulator (see trackDamage()): one flag per tile of
+  // kDamageTileSize^2 pixels in row-major order, empty while tracking
+  // is disabled.
+  std::vector<uint8_t> m_damageTiles;
+  int m_damageCols = 0;
+
+  // Cached result of contentHash() and the version of the image when
+  // it was calculated.
+  mutable uint64_t m_hash = 0;
+  mutable ObjectVersion m_hashVersion = 0;
+  mutable bool m_hashValid = false;
 };
 
 } // namespace doc
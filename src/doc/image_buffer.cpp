@@ -0,0 +1,89 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "doc/image_buffer.h"
+
+#include <map>
+#include <mutex>
+
+namespace doc {
+
+namespace {
+
+// Buffers smaller than this aren't worth pooling (malloc handles them
+// well enough and pooling them would just fragment the pool).
+constexpr std::size_t kMinPooledSize = 64 * 1024;
+
+// Maximum number of bytes retained by the pool. Buffers returned when
+// the pool is full are freed normally.
+constexpr std::size_t kMaxPoolBytes = 256 * 1024 * 1024;
+
+// A buffer is reused for a request only if it isn't bigger than twice
+// the requested size, to avoid parking huge buffers behind small
+// recurrent requests.
+constexpr std::size_t kMaxWaste = 2;
+
+struct BufferPool {
+  std::mutex mutex;
+  // Free buffers keyed by their capacity (multimap: several buffers
+  // of the same size class can be pooled, e.g. src/dst pairs).
+  std::multimap<std::size_t, std::unique_ptr<ImageBuffer>> free;
+  std::size_t totalBytes = 0;
+};
+
+BufferPool& pool()
+{
+  static BufferPool p;
+  return p;
+}
+
+void return_to_pool(ImageBuffer* rawBuffer)
+{
+  std::unique_ptr<ImageBuffer> buffer(rawBuffer);
+
+  BufferPool& p = pool();
+  std::lock_guard<std::mutex> lock(p.mutex);
+  if (p.totalBytes + buffer->size() > kMaxPoolBytes)
+    return; // The pool is full, free the buffer normally
+
+  p.totalBytes += buffer->size();
+  p.free.emplace(buffer->size(), std::move(buffer));
+}
+
+} // anonymous namespace
+
+ImageBufferPtr get_pooled_image_buffer(std::size_t size)
+{
+  if (size < kMinPooledSize)
+    return std::make_shared<ImageBuffer>(size);
+
+  std::unique_ptr<ImageBuffer> buffer;
+  {
+    BufferPool& p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+
+    // Smallest pooled buffer that fits the request
+    auto it = p.free.lower_bound(size);
+    if (it != p.free.end() && it->first <= kMaxWaste * size) {
+      buffer = std::move(it->second);
+      p.totalBytes -= it->first;
+      p.free.erase(it);
+    }
+  }
+
+  if (!buffer)
+    buffer = std::make_unique<ImageBuffer>(size);
+
+  // The custom deleter sends the buffer back to the pool when the
+  // last reference is gone.
+  return ImageBufferPtr(buffer.release(), &return_to_pool);
+}
+
+} // namespace doc
@@ -63,6 +63,15 @@ private:
 
 using ImageBufferPtr = std::shared_ptr<ImageBuffer>;
 
+// Returns a buffer of at least the given size taken from a global
+// pool of recycled buffers (or a freshly allocated one if no pooled
+// buffer fits). When the returned ImageBufferPtr loses its last
+// reference the buffer goes back to the pool instead of being freed,
+// so temporary images of similar sizes (tool loops, rendering,
+// playback) stop hitting malloc/free for multi-megabyte blocks on
+// every frame. Thread-safe.
+ImageBufferPtr get_pooled_image_buffer(std::size_t size);
+
 } // namespace doc
 
 #endif
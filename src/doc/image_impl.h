@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (C) 2018-2023  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,6 +12,8 @@
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <vector>
 
 #include "doc/blend_funcs.h"
 #include "doc/image.h"
@@ -31,20 +33,88 @@ public:
   using const_address_t = typename traits_t::const_address_t;
 
 private:
+  // Number of rows per strip in lazy strip mode (see
+  // ImageSpec::lazyStrips()).
+  static constexpr int kStripRows = 64;
+
   ImageBufferPtr m_buffer;
   address_t* m_rows;
   address_t m_bits;
 
+  // Lazy strip mode only: pixel storage for each strip of kStripRows
+  // rows (null until the strip is materialized), the row pointer
+  // table (m_rows points to it, with null entries for rows of
+  // non-materialized strips), and the uniform color that virtual
+  // strips represent (so clear() is O(1)).
+  std::vector<std::unique_ptr<uint8_t[]>> m_strips;
+  std::vector<address_t> m_lazyRows;
+  color_t m_stripFill = 0;
+
   inline address_t getLineAddress(int y)
   {
     ASSERT(y >= 0 && y < height());
+    if (!m_rows[y])
+      materializeStrip(y);
     return m_rows[y];
   }
 
   inline const_address_t getLineAddress(int y) const
   {
-    ASSERT(y >= 0 && y < height());
-    return m_rows[y];
+    // Materializing a strip on read access keeps the image logically
+    // unmodified (the strip is filled with the color it already
+    // represented).
+    return const_cast<ImageImpl<Traits>*>(this)->getLineAddress(y);
+  }
+
+  // Allocates the strip that contains the row "y" and fills it with
+  // the color that its rows represented while they were virtual.
+  void materializeStrip(int y)
+  {
+    const int strip = y / kStripRows;
+    const int firstRow = strip * kStripRows;
+    const int rows = std::min<int>(kStripRows, height() - firstRow);
+
+    ASSERT(strip >= 0 && strip < int(m_strips.size()));
+    ASSERT(!m_strips[strip]);
+
+    // Zero-initialized, so we only have to paint non-zero fills
+    m_strips[strip] = std::make_unique<uint8_t[]>(m_rowBytes * rows);
+
+    auto addr = m_strips[strip].get();
+    for (int v = firstRow; v < firstRow + rows; ++v) {
+      m_rows[v] = (address_t)addr;
+      addr += m_rowBytes;
+    }
+
+    if (m_stripFill != 0) {
+      if constexpr (Traits::pixels_per_byte == 0) {
+        for (int v = firstRow; v < firstRow + rows; ++v) {
+          address_t p = m_rows[v];
+          std::fill(p, p + width(), m_stripFill);
+        }
+      }
+      else {
+        const uint8_t byte = (Traits::pixels_per_byte == 8 ? (m_stripFill ? 0xff : 0x00) :
+                                                             uint8_t(m_stripFill));
+        std::fill(m_strips[strip].get(), m_strips[strip].get() + m_rowBytes * rows, byte);
+      }
+    }
+  }
+
+  // In lazy strip mode makes all the strips virtual again
+  // representing the given uniform color, and returns true (so
+  // clear() doesn't have to touch any pixel). Pixel addresses
+  // obtained before this call must not be used anymore.
+  bool discardStrips(color_t color)
+  {
+    if (m_strips.empty())
+      return false;
+
+    m_stripFill = color;
+    std::fill(m_lazyRows.begin(), m_lazyRows.end(), (address_t) nullptr);
+    for (auto& strip : m_strips)
+      strip.reset();
+    return true;
   }
 
 public:
@@ -64,12 +134,24 @@ public:
 
     m_rowBytes = Traits::rowstride_bytes(width());
 
+    // Lazy strip mode: no pixel storage is allocated here, each strip
+    // of kStripRows rows is materialized on first access (an external
+    // buffer cannot be shared between images in this mode, so a
+    // provided one forces the regular contiguous allocation).
+    if (spec.lazyStrips() && !m_buffer) {
+      m_strips.resize((height() + kStripRows - 1) / kStripRows);
+      m_lazyRows.resize(height(), nullptr);
+      m_rows = m_lazyRows.data();
+      m_bits = nullptr;
+      return;
+    }
+
     const std::size_t for_rows = doc_align_size(sizeof(address_t) * height());
     const std::size_t for_pixels = m_rowBytes * height();
     const std::size_t required_size = for_pixels + for_rows;
 
     if (!m_buffer)
-      m_buffer = std::make_shared<ImageBuffer>(required_size);
+      m_buffer = get_pooled_image_buffer(required_size);
     else
       m_buffer->resizeIfNecessary(required_size);
 
@@ -85,6 +167,26 @@ public:
     }
   }
 
+  // Wraps external pixel storage (see Image::createWrap()): only the
+  // row pointer table is allocated here, each row points into the
+  // caller's buffer every "rowBytes" bytes.
+  ImageImpl(const ImageSpec& spec, uint8_t* pixels, const std::size_t rowBytes) : Image(spec)
+  {
+    ASSERT(Traits::color_mode == spec.colorMode());
+    ASSERT(rowBytes >= Traits::rowstride_bytes(width()));
+
+    m_rowBytes = rowBytes;
+    m_buffer = std::make_shared<ImageBuffer>(sizeof(address_t) * height());
+    m_rows = (address_t*)m_buffer->buffer();
+    m_bits = (address_t)pixels;
+
+    auto addr = pixels;
+    for (int y = 0; y < height(); ++y) {
+      m_rows[y] = (address_t)addr;
+      addr += m_rowBytes;
+    }
+  }
+
   uint8_t* getPixelAddress(int x, int y) const override
   {
     ASSERT(x >= 0 && x < width());
@@ -106,11 +208,16 @@ public:
     ASSERT(x >= 0 && x < width());
     ASSERT(y >= 0 && y < height());
 
+    addDamage(gfx::Rect(x, y, 1, 1));
     *address(x, y) = color;
   }
 
   void clear(color_t color) override
   {
+    addDamage(bounds());
+    if (discardStrips(color))
+      return;
+
     const int w = width();
     const int h = height();
     for (int y = 0; y < h; ++y) {
@@ -128,6 +235,8 @@ public:
     if (!area.clip(width(), height(), src->width(), src->height()))
       return;
 
+    addDamage(gfx::Rect(area.dst.x, area.dst.y, area.size.w, area.size.h));
+
     for (int end_y = area.dst.y + area.size.h; area.dst.y < end_y; ++area.dst.y, ++area.src.y) {
       src_address = src->address(area.src.x, area.src.y);
       dst_address = address(area.dst.x, area.dst.y);
@@ -138,16 +247,30 @@ public:
 
   void drawHLine(int x1, int y, int x2, color_t color) override
   {
-    LockImageBits<Traits> bits(this, gfx::Rect(x1, y, x2 - x1 + 1, 1));
-    typename LockImageBits<Traits>::iterator it(bits.begin());
-    typename LockImageBits<Traits>::iterator end(bits.end());
+    addDamage(gfx::Rect(x1, y, x2 - x1 + 1, 1));
 
-    for (; it != end; ++it)
-      *it = color;
+    if constexpr (Traits::pixels_per_byte == 0) {
+      // Whole-byte pixels: plain span fill, cheaper than creating a
+      // LockImageBits iterator for each scanline.
+      address_t p = address(x1, y);
+      std::fill(p, p + (x2 - x1 + 1), color);
+    }
+    else {
+      // Sub-byte pixels (bitmaps): the iterator handles the bit
+      // addressing.
+      LockImageBits<Traits> bits(this, gfx::Rect(x1, y, x2 - x1 + 1, 1));
+      typename LockImageBits<Traits>::iterator it(bits.begin());
+      typename LockImageBits<Traits>::iterator end(bits.end());
+
+      for (; it != end; ++it)
+        *it = color;
+    }
   }
 
   void fillRect(int x1, int y1, int x2, int y2, color_t color) override
   {
+    addDamage(gfx::Rect(x1, y1, x2 - x1 + 1, y2 - y1 + 1));
+
     // Fill the first line
     ImageImpl<Traits>::drawHLine(x1, y1, x2, color);
 
@@ -234,6 +357,8 @@ inline void ImageImpl<RgbTraits>::blendRect(int x1,
   address_t addr;
   int x, y;
 
+  addDamage(gfx::Rect(x1, y1, x2 - x1 + 1, y2 - y1 + 1));
+
   for (y = y1; y <= y2; ++y) {
     addr = (address_t)getPixelAddress(x1, y);
     for (x = x1; x <= x2; ++x) {
@@ -246,6 +371,10 @@ inline void ImageImpl<RgbTraits>::blendRect(int x1,
 template<>
 inline void ImageImpl<IndexedTraits>::clear(color_t color)
 {
+  addDamage(bounds());
+  if (discardStrips(color))
+    return;
+
   uint8_t* p = address(0, 0);
   std::fill(p, p + rowBytes() * height(), color);
 }
@@ -253,6 +382,10 @@ inline void ImageImpl<IndexedTraits>::clear(color_t color)
 template<>
 inline void ImageImpl<BitmapTraits>::clear(color_t color)
 {
+  addDamage(bounds());
+  if (discardStrips(color))
+    return;
+
   uint8_t* p = address(0, 0);
   std::fill(p, p + rowBytes() * height(), (color ? 0xff : 0x00));
 }
@@ -275,6 +408,8 @@ inline void ImageImpl<BitmapTraits>::putPixel(int x, int y, color_t color)
   ASSERT(x >= 0 && x < width());
   ASSERT(y >= 0 && y < height());
 
+  addDamage(gfx::Rect(x, y, 1, 1));
+
   std::div_t d = std::div(x, 8);
   if (color)
     (*(getLineAddress(y) + d.quot)) |= (1 << d.rem);
@@ -293,6 +428,8 @@ void copy_bitmaps(Image* dst, const Image* src, gfx::Clip area);
 template<>
 inline void ImageImpl<BitmapTraits>::copy(const Image* src, gfx::Clip area)
 {
+  // copy_bitmaps() clips "area" itself, over-marking here is harmless
+  addDamage(gfx::Rect(area.dst.x, area.dst.y, area.size.w, area.size.h));
   copy_bitmaps(this, src, area);
 }
 
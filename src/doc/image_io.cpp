@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2019-2024  Igara Studio S.A.
+// Copyright (c) 2019-2026  Igara Studio S.A.
 // Copyright (c) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -13,6 +13,7 @@
 
 #include "base/exception.h"
 #include "base/serialization.h"
+#include "base/thread_pool.h"
 #include "doc/cancel_io.h"
 #include "doc/image.h"
 #include "zlib.h"
@@ -20,6 +21,8 @@
 #include <algorithm>
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <vector>
 
 namespace doc {
 
@@ -28,16 +31,170 @@ using namespace base::serialization::little_endian;
 
 // TODO Create a zlib wrapper for iostreams
 
-bool write_image(std::ostream& os, const Image* image, CancelIO* cancel)
+namespace {
+
+// Big images are split into stripes of rows that are compressed (and
+// decompressed) in parallel, each one as an independent zlib stream.
+// The MSB of the pixel format octet marks the striped layout, so the
+// single-stream layout written by previous versions is still read
+// with the original code path (and old readers reject the unknown
+// pixel format instead of inflating garbage).
+const int kStripedImageFlag = 0x80;
+
+// Marks a delta-encoded image: the blob stores the XOR of the image
+// against a base image blob (referenced by object ID/version), see
+// write_image_delta(). As with the striped flag, old readers reject
+// the unknown pixel format instead of restoring garbage.
+const int kDeltaImageFlag = 0x40;
+
+// Minimum raw bytes per stripe, so tiny images don't pay the
+// per-stream overhead (they keep the old single-stream layout).
+const int kMinStripeBytes = 128 * 1024;
+
+base::thread_pool& io_pool()
 {
-  write32(os, image->id());
-  write8(os, image->pixelFormat()); // Pixel format
-  write16(os, image->width());      // Width
-  write16(os, image->height());     // Height
-  write32(os, image->maskColor());  // Mask color
+  static base::thread_pool pool(std::max<int>(2, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+// Compresses the [y0, y1) rows of the image into "output". Returns
+// false on a zlib error (it doesn't throw as it runs in a worker
+// thread).
+bool deflate_rows(const Image* image, const int y0, const int y1, std::vector<uint8_t>& output)
+{
+  z_stream zstream;
+  zstream.zalloc = (alloc_func)0;
+  zstream.zfree = (free_func)0;
+  zstream.opaque = (voidpf)0;
+  int err = deflateInit(&zstream, Z_DEFAULT_COMPRESSION);
+  if (err != Z_OK)
+    return false;
+
+  std::vector<uint8_t> compressed(4096);
+
+  for (int y = y0; y < y1; ++y) {
+    const ImageConstRowSpan row = image->rowSpan(y);
+    zstream.next_in = (Bytef*)row.data;
+    zstream.avail_in = row.size;
+    int flush = (y == y1 - 1 ? Z_FINISH : Z_NO_FLUSH);
+
+    do {
+      zstream.next_out = (Bytef*)&compressed[0];
+      zstream.avail_out = compressed.size();
+
+      err = deflate(&zstream, flush);
+      if (err != Z_OK && err != Z_STREAM_END && err != Z_BUF_ERROR) {
+        deflateEnd(&zstream);
+        return false;
+      }
+
+      int output_bytes = compressed.size() - zstream.avail_out;
+      if (output_bytes > 0)
+        output.insert(output.end(), &compressed[0], &compressed[output_bytes]);
+    } while (zstream.avail_out == 0);
+  }
+
+  return (deflateEnd(&zstream) == Z_OK);
+}
+
+// Decompresses one stripe into the [y0, y1) rows of the image.
+// Returns false on a zlib error.
+bool inflate_rows(Image* image, const int y0, const int y1, const std::vector<uint8_t>& input)
+{
+  z_stream zstream;
+  zstream.zalloc = (alloc_func)0;
+  zstream.zfree = (free_func)0;
+  zstream.opaque = (voidpf)0;
+  int err = inflateInit(&zstream);
+  if (err != Z_OK)
+    return false;
+
+  zstream.next_in = (Bytef*)input.data();
+  zstream.avail_in = (uInt)input.size();
+
+  for (int y = y0; y < y1; ++y) {
+    const ImageRowSpan row = image->rowSpan(y);
+    zstream.next_out = (Bytef*)row.data;
+    zstream.avail_out = row.size;
+
+    while (zstream.avail_out > 0) {
+      err = inflate(&zstream, Z_NO_FLUSH);
+      if (err == Z_STREAM_END)
+        break;
+      if (err != Z_OK && err != Z_BUF_ERROR) {
+        inflateEnd(&zstream);
+        return false;
+      }
+      if (zstream.avail_in == 0)
+        break; // Truncated stream, keep the rows we've got
+    }
+    if (err == Z_STREAM_END)
+      break;
+  }
 
+  inflateEnd(&zstream);
+  return true;
+}
+
+} // anonymous namespace
+
+bool write_image(std::ostream& os, const Image* image, CancelIO* cancel)
+{
   // Number of bytes for visible pixels on each row
   const int widthBytes = image->widthBytes();
+  const int height = image->height();
+
+  // Number of stripes to compress in parallel (1 = old single-stream
+  // layout).
+  int nstripes = 1;
+  const int64_t rawBytes = int64_t(widthBytes) * height;
+  if (rawBytes >= 2 * int64_t(kMinStripeBytes)) {
+    nstripes = int(std::min<int64_t>(std::max<int>(2, std::thread::hardware_concurrency()),
+                                     rawBytes / kMinStripeBytes));
+    nstripes = std::min(nstripes, height);
+  }
+
+  write32(os, image->id());
+  write8(os, image->pixelFormat() | (nstripes > 1 ? kStripedImageFlag : 0)); // Pixel format
+  write16(os, image->width());                                               // Width
+  write16(os, image->height());                                              // Height
+  write32(os, image->maskColor());                                           // Mask color
+
+  if (nstripes > 1) {
+    const int rowsPerStripe = (height + nstripes - 1) / nstripes;
+    nstripes = (height + rowsPerStripe - 1) / rowsPerStripe;
+    write16(os, nstripes);
+    write16(os, rowsPerStripe);
+
+    if (cancel && cancel->isCanceled())
+      return false;
+
+    std::vector<std::vector<uint8_t>> stripes(nstripes);
+    std::vector<int> results(nstripes, 0);
+    auto& pool = io_pool();
+    for (int i = 0; i < nstripes; ++i) {
+      const int y0 = i * rowsPerStripe;
+      const int y1 = std::min(height, y0 + rowsPerStripe);
+      pool.execute([image, y0, y1, &stripes, &results, i] {
+        results[i] = deflate_rows(image, y0, y1, stripes[i]);
+      });
+    }
+    pool.wait_all();
+
+    if (cancel && cancel->isCanceled())
+      return false;
+
+    for (int i = 0; i < nstripes; ++i) {
+      if (!results[i])
+        throw base::Exception("ZLib error compressing image stripe.");
+
+      write32(os, stripes[i].size());
+      if (!stripes[i].empty() &&
+          os.write((char*)stripes[i].data(), stripes[i].size()).fail())
+        throw base::Exception("Error writing compressed image pixels.\n");
+    }
+    return true;
+  }
 
 #if 0
   {
@@ -105,7 +262,9 @@ bool write_image(std::ostream& os, const Image* image, CancelIO* cancel)
 Image* read_image(std::istream& is, const bool setId)
 {
   ObjectId id = read32(is);
-  int pixelFormat = read8(is);     // Pixel format
+  int pixelFormat = read8(is); // Pixel format
+  const bool striped = ((pixelFormat & kStripedImageFlag) != 0);
+  pixelFormat &= ~kStripedImageFlag;
   int width = read16(is);          // Width
   int height = read16(is);         // Height
   uint32_t maskColor = read32(is); // Mask color
@@ -119,6 +278,48 @@ Image* read_image(std::istream& is, const bool setId)
 
   const int widthBytes = image->widthBytes();
 
+  if (striped) {
+    const int nstripes = read16(is);
+    const int rowsPerStripe = read16(is);
+    if (nstripes < 1 || rowsPerStripe < 1 || int64_t(rowsPerStripe) * (nstripes - 1) >= height ||
+        int64_t(rowsPerStripe) * nstripes < height)
+      return nullptr;
+
+    // Read all the compressed stripes first (the stream is
+    // sequential), then inflate them in parallel.
+    std::vector<std::vector<uint8_t>> stripes(nstripes);
+    for (int i = 0; i < nstripes; ++i) {
+      const int len = read32(is);
+      stripes[i].resize(len);
+      if (len > 0 && is.read((char*)stripes[i].data(), len).fail()) {
+        ASSERT(false);
+        throw base::Exception("Error reading stream to restore image");
+      }
+    }
+
+    std::vector<int> results(nstripes, 0);
+    auto& pool = io_pool();
+    for (int i = 0; i < nstripes; ++i) {
+      Image* imagePtr = image.get();
+      const int y0 = i * rowsPerStripe;
+      const int y1 = std::min(height, y0 + rowsPerStripe);
+      pool.execute([imagePtr, y0, y1, &stripes, &results, i] {
+        results[i] = inflate_rows(imagePtr, y0, y1, stripes[i]);
+      });
+    }
+    pool.wait_all();
+
+    for (int i = 0; i < nstripes; ++i) {
+      if (!results[i])
+        throw base::Exception("ZLib error decompressing image stripe.");
+    }
+
+    image->setMaskColor(maskColor);
+    if (setId)
+      image->setId(id);
+    return image.release();
+  }
+
 #if 0
   {
     for (int c=0; c<image->height(); c++)
@@ -209,4 +410,207 @@ Image* read_image(std::istream& is, const bool setId)
   return image.release();
 }
 
+bool write_image_delta(std::ostream& os,
+                       const Image* image,
+                       const Image* base,
+                       const ObjectVersion baseVersion,
+                       CancelIO* cancel)
+{
+  ASSERT(image->pixelFormat() == base->pixelFormat());
+  ASSERT(image->width() == base->width());
+  ASSERT(image->height() == base->height());
+
+  const int widthBytes = image->widthBytes();
+  const int height = image->height();
+
+  write32(os, image->id());
+  write8(os, image->pixelFormat() | kDeltaImageFlag); // Pixel format
+  write16(os, image->width());                        // Width
+  write16(os, image->height());                       // Height
+  write32(os, image->maskColor());                    // Mask color
+  write32(os, base->id());                            // Base image
+  write32(os, baseVersion);                           // Base image blob version
+
+  // Deltas are small (adjacent frames tend to be similar), a single
+  // zlib stream is enough (no striped layout here).
+  std::ostream::pos_type total_output_pos = os.tellp();
+  write32(os, 0); // Compressed size (we update this value later)
+
+  z_stream zstream;
+  zstream.zalloc = (alloc_func)0;
+  zstream.zfree = (free_func)0;
+  zstream.opaque = (voidpf)0;
+  int err = deflateInit(&zstream, Z_DEFAULT_COMPRESSION);
+  if (err != Z_OK)
+    throw base::Exception("ZLib error %d in deflateInit().", err);
+
+  std::vector<uint8_t> delta(widthBytes);
+  std::vector<uint8_t> compressed(4096);
+  int total_output_bytes = 0;
+
+  for (int y = 0; y < height; y++) {
+    if (cancel && cancel->isCanceled()) {
+      deflateEnd(&zstream);
+      return false;
+    }
+
+    const ImageConstRowSpan src = image->rowSpan(y);
+    const ImageConstRowSpan bas = base->rowSpan(y);
+    for (int i = 0; i < widthBytes; ++i)
+      delta[i] = (src.data[i] ^ bas.data[i]);
+
+    zstream.next_in = (Bytef*)&delta[0];
+    zstream.avail_in = widthBytes;
+    int flush = (y == height - 1 ? Z_FINISH : Z_NO_FLUSH);
+
+    do {
+      zstream.next_out = (Bytef*)&compressed[0];
+      zstream.avail_out = compressed.size();
+
+      // Compress
+      err = deflate(&zstream, flush);
+      if (err != Z_OK && err != Z_STREAM_END && err != Z_BUF_ERROR)
+        throw base::Exception("ZLib error %d in deflate().", err);
+
+      int output_bytes = compressed.size() - zstream.avail_out;
+      if (output_bytes > 0) {
+        if (os.write((char*)&compressed[0], output_bytes).fail())
+          throw base::Exception("Error writing compressed image delta.\n");
+
+        total_output_bytes += output_bytes;
+      }
+    } while (zstream.avail_out == 0);
+  }
+
+  err = deflateEnd(&zstream);
+  if (err != Z_OK)
+    throw base::Exception("ZLib error %d in deflateEnd().", err);
+
+  std::ostream::pos_type bak = os.tellp();
+  os.seekp(total_output_pos);
+  write32(os, total_output_bytes);
+  os.seekp(bak);
+  return true;
+}
+
+bool read_image_delta_ref(std::istream& is, ObjectId& baseId, ObjectVersion& baseVersion)
+{
+  read32(is);                        // Object ID
+  int pixelFormat = read8(is);       // Pixel format
+  if ((pixelFormat & kDeltaImageFlag) == 0 || is.fail())
+    return false;
+  read16(is);                        // Width
+  read16(is);                        // Height
+  read32(is);                        // Mask color
+  baseId = read32(is);
+  baseVersion = read32(is);
+  return !is.fail();
+}
+
+Image* read_image_delta(std::istream& is, const Image* base, const bool setId)
+{
+  ObjectId id = read32(is);
+  int pixelFormat = read8(is); // Pixel format
+  if ((pixelFormat & kDeltaImageFlag) == 0)
+    return nullptr;
+  pixelFormat &= ~kDeltaImageFlag;
+  int width = read16(is);          // Width
+  int height = read16(is);         // Height
+  uint32_t maskColor = read32(is); // Mask color
+  read32(is);                      // Base image (already resolved by the caller)
+  read32(is);                      // Base image blob version
+
+  if ((pixelFormat != IMAGE_RGB && pixelFormat != IMAGE_GRAYSCALE && pixelFormat != IMAGE_INDEXED &&
+       pixelFormat != IMAGE_BITMAP && pixelFormat != IMAGE_TILEMAP) ||
+      (width < 1 || height < 1) || (width > 0xfffff || height > 0xfffff))
+    return nullptr;
+
+  // The base must match the delta layout exactly.
+  if (base->pixelFormat() != pixelFormat || base->width() != width || base->height() != height)
+    return nullptr;
+
+  std::unique_ptr<Image> image(Image::create(static_cast<PixelFormat>(pixelFormat), width, height));
+
+  const int widthBytes = image->widthBytes();
+  int avail_bytes = read32(is);
+
+  z_stream zstream;
+  zstream.zalloc = (alloc_func)0;
+  zstream.zfree = (free_func)0;
+  zstream.opaque = (voidpf)0;
+
+  int err = inflateInit(&zstream);
+  if (err != Z_OK)
+    throw base::Exception("ZLib error %d in inflateInit().", err);
+
+  int remain = avail_bytes;
+
+  std::vector<uint8_t> compressed(4096);
+  int y = 0;
+  uint8_t* address = nullptr;
+  uint8_t* address_end = nullptr;
+
+  while (remain > 0) {
+    int len = std::min(remain, int(compressed.size()));
+    if (is.read((char*)&compressed[0], len).fail()) {
+      ASSERT(false);
+      throw base::Exception("Error reading stream to restore image delta");
+    }
+
+    int bytes_read = (int)is.gcount();
+    if (bytes_read == 0) {
+      ASSERT(remain == 0);
+      break;
+    }
+
+    remain -= bytes_read;
+
+    zstream.next_in = (Bytef*)&compressed[0];
+    zstream.avail_in = (uInt)bytes_read;
+
+    do {
+      if (address == address_end) {
+        if (y < image->height()) {
+          address = image->getPixelAddress(0, y++);
+          address_end = address + widthBytes;
+        }
+        else {
+          // See the analogous case in read_image()
+          ASSERT(y == image->height());
+          ASSERT(err == Z_OK);
+        }
+      }
+
+      zstream.next_out = (Bytef*)address;
+      zstream.avail_out = address_end - address;
+
+      err = inflate(&zstream, Z_NO_FLUSH);
+      if (err != Z_OK && err != Z_STREAM_END && err != Z_BUF_ERROR)
+        throw base::Exception("ZLib error %d in inflate().", err);
+
+      int uncompressed_bytes = (int)((address_end - address) - zstream.avail_out);
+      if (uncompressed_bytes > 0) {
+        address += uncompressed_bytes;
+      }
+    } while (zstream.avail_in != 0 && zstream.avail_out == 0);
+  }
+
+  err = inflateEnd(&zstream);
+  if (err != Z_OK)
+    throw base::Exception("ZLib error %d in inflateEnd().", err);
+
+  // Apply the delta on the base pixels (XOR is its own inverse).
+  for (y = 0; y < height; ++y) {
+    const ImageRowSpan dst = image->rowSpan(y);
+    const ImageConstRowSpan bas = base->rowSpan(y);
+    for (int i = 0; i < widthBytes; ++i)
+      dst.data[i] ^= bas.data[i];
+  }
+
+  image->setMaskColor(maskColor);
+  if (setId)
+    image->setId(id);
+  return image.release();
+}
+
 } // namespace doc
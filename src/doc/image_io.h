@@ -1,4 +1,5 @@
 // Aseprite Document Library
+// Copyright (c) 2019-2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -8,6 +9,9 @@
 #define DOC_IMAGE_IO_H_INCLUDED
 #pragma once
 
+#include "doc/object_id.h"
+#include "doc/object_version.h"
+
 #include <iosfwd>
 
 namespace doc {
@@ -18,6 +22,27 @@ class Image;
 bool write_image(std::ostream& os, const Image* image, CancelIO* cancel = nullptr);
 Image* read_image(std::istream& is, bool setId = true);
 
+// Writes "image" as a XOR delta against "base" (an image with the
+// same pixel format and dimensions, e.g. the previous cel of the same
+// layer): unchanged areas turn into runs of zeros that compress to
+// almost nothing. "baseVersion" identifies the serialized blob of the
+// base that the reader must use to reconstruct the pixels.
+bool write_image_delta(std::ostream& os,
+                       const Image* image,
+                       const Image* base,
+                       ObjectVersion baseVersion,
+                       CancelIO* cancel = nullptr);
+
+// If the stream contains a delta-encoded image, returns true and the
+// reference to its base image blob. The stream position is not
+// restored, the caller must seek back before calling read_image() or
+// read_image_delta().
+bool read_image_delta_ref(std::istream& is, ObjectId& baseId, ObjectVersion& baseVersion);
+
+// Reads a delta-encoded image applying the delta on "base" (which
+// must be the image blob referenced by read_image_delta_ref()).
+Image* read_image_delta(std::istream& is, const Image* base, bool setId = true);
+
 } // namespace doc
 
 #endif
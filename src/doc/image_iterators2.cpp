@@ -15,6 +15,36 @@ namespace doc {
 ReadIterator::ReadIterator(const Image* image, const gfx::Rect& bounds, const IteratorStart start)
   : m_rows(bounds.h)
 {
+  // Images with lazy strips don't have one contiguous buffer, each
+  // row address is fetched lazily in nextLazyLine() (materializing
+  // the strip of that row if necessary).
+  if (image->spec().lazyStrips()) {
+    m_image = image;
+    switch (start) {
+      case IteratorStart::TopLeft:
+        m_x = bounds.x;
+        m_y = bounds.y;
+        m_nextRow = 1;
+        break;
+      case IteratorStart::TopRight:
+        m_x = bounds.x2() - 1;
+        m_y = bounds.y;
+        m_nextRow = 1;
+        break;
+      case IteratorStart::BottomLeft:
+        m_x = bounds.x;
+        m_y = bounds.y2() - 1;
+        m_nextRow = -1;
+        break;
+      case IteratorStart::BottomRight:
+        m_x = bounds.x2() - 1;
+        m_y = bounds.y2() - 1;
+        m_nextRow = -1;
+        break;
+    }
+    return;
+  }
+
   switch (start) {
     case IteratorStart::TopLeft:
       m_addr = image->getPixelAddress(bounds.x, bounds.y);
@@ -36,4 +66,11 @@ ReadIterator::ReadIterator(const Image* image, const gfx::Rect& bounds, const It
   m_addr -= m_nextRow; // This is canceled in the first nextLine() call.
 }
 
+void ReadIterator::nextLazyLine()
+{
+  if (m_rows > 0)
+    m_addr = m_image->getPixelAddress(m_x, m_y);
+  m_y += m_nextRow;
+}
+
 } // namespace doc
@@ -37,7 +37,12 @@ public:
 
   bool nextLine()
   {
-    m_addr += m_nextRow;
+    // Images with lazy strips have no contiguous storage, so the next
+    // row address must be fetched from the image itself.
+    if (m_image)
+      nextLazyLine();
+    else
+      m_addr += m_nextRow;
     return (m_rows-- > 0);
   }
 
@@ -45,8 +50,16 @@ protected:
   uint8_t* m_addr = nullptr;
 
 private:
+  void nextLazyLine();
+
   int m_rows = 0;
   int m_nextRow = 0;
+
+  // Only used for images with lazy strips (see
+  // ImageSpec::lazyStrips()): the iterated image and the position of
+  // the next row to visit (m_nextRow keeps the row step, +1 or -1).
+  const Image* m_image = nullptr;
+  int m_x = 0, m_y = 0;
 };
 
 class WriteIterator : public ReadIterator {
@@ -48,6 +48,15 @@ public:
   // The transparent color for colored images (0 by default) or just 0 for RGBA and Grayscale
   color_t maskColor() const { return m_maskColor; }
 
+  // True if the image can allocate its pixel storage lazily in
+  // fixed-height strips of rows that are materialized on first
+  // access, instead of one big contiguous buffer up front (useful for
+  // huge, mostly-empty canvases). This is just a storage hint: it
+  // doesn't change the visible content of the image and is ignored in
+  // operator==().
+  bool lazyStrips() const { return m_lazyStrips; }
+  void setLazyStrips(const bool lazy) { m_lazyStrips = lazy; }
+
   void setColorMode(const ColorMode colorMode) { m_colorMode = colorMode; }
   void setWidth(const int width) { m_size.w = width; }
   void setHeight(const int height) { m_size.h = height; }
@@ -81,6 +90,7 @@ private:
   gfx::Size m_size;
   color_t m_maskColor;
   gfx::ColorSpaceRef m_colorSpace;
+  bool m_lazyStrips = false;
 };
 
 } // namespace doc
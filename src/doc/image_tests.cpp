@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2018-2025 Igara Studio S.A.
+// Copyright (c) 2018-2026 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -13,7 +13,9 @@
 
 #include "doc/algorithm/random_image.h"
 #include "doc/image.h"
+#include "doc/palette.h"
 #include "doc/primitives.h"
+#include "gfx/region.h"
 
 #include <memory>
 
@@ -152,6 +154,112 @@ TEST(Image, DiffRgbImages)
   ASSERT_FALSE(is_same_image(a.get(), b.get()));
 }
 
+TEST(Image, CreateWrap)
+{
+  // 8x4 RGBA pixels with 3 extra padding pixels per row
+  const int w = 8, h = 4, stride = 11;
+  std::vector<uint32_t> pixels(stride * h, rgba(1, 2, 3, 4));
+
+  std::unique_ptr<Image> img(Image::createWrap(ImageSpec(ColorMode::RGB, w, h, 0),
+                                               (uint8_t*)pixels.data(),
+                                               stride * sizeof(uint32_t)));
+  ASSERT_TRUE(img != nullptr);
+  EXPECT_EQ(rgba(1, 2, 3, 4), get_pixel(img.get(), 0, 0));
+  EXPECT_EQ(rgba(1, 2, 3, 4), get_pixel(img.get(), w - 1, h - 1));
+
+  // Writes through the image land in the external buffer respecting
+  // the row stride (and nothing leaks into the padding)
+  clear_image(img.get(), rgba(50, 60, 70, 80));
+  put_pixel(img.get(), 2, 1, rgba(255, 0, 0, 255));
+  EXPECT_EQ(rgba(255, 0, 0, 255), pixels[stride * 1 + 2]);
+  EXPECT_EQ(rgba(50, 60, 70, 80), pixels[stride * 1 + 3]);
+  EXPECT_EQ(rgba(1, 2, 3, 4), pixels[stride * 1 + w]);
+}
+
+TEST(Image, ReadWriteRegion)
+{
+  std::unique_ptr<Image> img(Image::create(IMAGE_RGB, 4, 4));
+  clear_image(img.get(), rgba(1, 2, 3, 4));
+  put_pixel(img.get(), 1, 1, rgba(10, 20, 30, 40));
+  put_pixel(img.get(), 2, 1, rgba(50, 60, 70, 80));
+
+  // Same-mode read, region clipped on all sides (the external buffer
+  // keeps the requested layout, only the intersection is touched)
+  std::vector<uint32_t> buf(3 * 3, rgba(9, 9, 9, 9));
+  ASSERT_TRUE(img->readRegion(gfx::Rect(-1, -1, 3, 3),
+                              ColorMode::RGB,
+                              (uint8_t*)buf.data(),
+                              3 * sizeof(uint32_t)));
+  EXPECT_EQ(rgba(9, 9, 9, 9), buf[0]);      // Clipped out
+  EXPECT_EQ(rgba(1, 2, 3, 4), buf[3 + 1]);  // (0, 0)
+  EXPECT_EQ(rgba(10, 20, 30, 40), buf[6 + 2]); // (1, 1)
+
+  // Same-mode write round trip
+  buf.assign(2 * 2, rgba(100, 101, 102, 103));
+  ASSERT_TRUE(img->writeRegion(gfx::Rect(2, 2, 2, 2),
+                               ColorMode::RGB,
+                               (const uint8_t*)buf.data(),
+                               2 * sizeof(uint32_t)));
+  EXPECT_EQ(rgba(100, 101, 102, 103), get_pixel(img.get(), 2, 2));
+  EXPECT_EQ(rgba(100, 101, 102, 103), get_pixel(img.get(), 3, 3));
+  EXPECT_EQ(rgba(1, 2, 3, 4), get_pixel(img.get(), 1, 2));
+
+  // RGB -> GRAYSCALE conversion on the fly
+  std::vector<uint16_t> gray(2);
+  ASSERT_TRUE(
+    img->readRegion(gfx::Rect(1, 1, 2, 1), ColorMode::GRAYSCALE, (uint8_t*)gray.data(), 0));
+  EXPECT_EQ(graya(rgba_luma(rgba(10, 20, 30, 40)), 40), gray[0]);
+  EXPECT_EQ(graya(rgba_luma(rgba(50, 60, 70, 80)), 80), gray[1]);
+
+  // INDEXED -> RGB needs a palette (and fails without one)
+  std::unique_ptr<Image> idx(Image::create(IMAGE_INDEXED, 2, 1));
+  put_pixel(idx.get(), 0, 0, 1);
+  put_pixel(idx.get(), 1, 0, 200); // Out of palette range -> 0
+
+  Palette pal(frame_t(0), 2);
+  pal.setEntry(1, rgba(255, 0, 0, 255));
+
+  std::vector<uint32_t> rgb(2);
+  EXPECT_FALSE(img->readRegion(gfx::Rect(0, 0, 2, 1), ColorMode::INDEXED, (uint8_t*)rgb.data(), 0));
+  ASSERT_TRUE(
+    idx->readRegion(gfx::Rect(0, 0, 2, 1), ColorMode::RGB, (uint8_t*)rgb.data(), 0, &pal));
+  EXPECT_EQ(rgba(255, 0, 0, 255), rgb[0]);
+  EXPECT_EQ(0u, rgb[1]);
+}
+
+TEST(Image, DamageTracking)
+{
+  std::unique_ptr<Image> img(Image::create(IMAGE_RGB, 100, 70));
+  clear_image(img.get(), 0);
+
+  // Disabled by default: mutations don't accumulate anything
+  EXPECT_FALSE(img->trackingDamage());
+  put_pixel(img.get(), 10, 10, 1);
+  EXPECT_TRUE(img->consumeDamage().isEmpty());
+
+  img->trackDamage(true);
+  EXPECT_TRUE(img->trackingDamage());
+
+  // One pixel marks its whole tile
+  put_pixel(img.get(), 10, 10, 1);
+  gfx::Region rgn = img->consumeDamage();
+  EXPECT_EQ(gfx::Rect(0, 0, Image::kDamageTileSize, Image::kDamageTileSize), rgn.bounds());
+
+  // Consuming clears the accumulator
+  EXPECT_TRUE(img->consumeDamage().isEmpty());
+
+  // A rectangle crossing tiles, clipped to the image bounds on the
+  // right/bottom sides
+  fill_rect(img.get(), 40, 40, 99, 69, 1);
+  rgn = img->consumeDamage();
+  EXPECT_EQ(gfx::Rect(32, 32, 68, 38), rgn.bounds());
+  EXPECT_TRUE(rgn.contains(gfx::Point(99, 69)));
+  EXPECT_FALSE(rgn.contains(gfx::Point(10, 10)));
+
+  img->trackDamage(false);
+  EXPECT_FALSE(img->trackingDamage());
+}
+
 TYPED_TEST(ImageAllTypes, DrawHLine)
 {
   using ImageTraits = TypeParam;
@@ -214,6 +322,59 @@ TYPED_TEST(ImageAllTypes, FillRect)
   }
 }
 
+TYPED_TEST(ImageAllTypes, LazyStrips)
+{
+  using ImageTraits = TypeParam;
+
+  // Several strips plus a partial one at the bottom
+  const int w = 33;
+  const int h = 200;
+
+  ImageSpec spec((ColorMode)ImageTraits::pixel_format, w, h);
+  spec.setLazyStrips(true);
+
+  std::unique_ptr<Image> image(Image::create(spec));
+  std::unique_ptr<Image> expected(Image::create(ImageTraits::pixel_format, w, h));
+
+  // clear() on a lazy image doesn't materialize anything, but the
+  // color must be visible anyway
+  image->clear(1);
+  expected->clear(1);
+
+  for (int i = 0; i < 1000; ++i) {
+    const int x = rand() % w;
+    const int y = rand() % h;
+    const color_t c = rand() % ImageTraits::max_value;
+    put_pixel(image.get(), x, y, c);
+    put_pixel(expected.get(), x, y, c);
+  }
+
+  // A rectangle crossing strip boundaries
+  fill_rect(image.get(), 5, 60, 20, 140, 1);
+  fill_rect(expected.get(), 5, 60, 20, 140, 1);
+
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      ASSERT_EQ(get_pixel(expected.get(), x, y), get_pixel(image.get(), x, y));
+
+  // Iterators see the same content
+  {
+    const LockImageBits<ImageTraits> bits((const Image*)image.get());
+    auto it = bits.begin(), end = bits.end();
+    for (int y = 0; y < h; ++y)
+      for (int x = 0; x < w; ++x, ++it) {
+        ASSERT_TRUE(it != end);
+        ASSERT_EQ(get_pixel(expected.get(), x, y), *it);
+      }
+  }
+
+  // Clearing again discards all the materialized strips
+  image->clear(0);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      ASSERT_EQ(0u, get_pixel(image.get(), x, y));
+}
+
 TYPED_TEST(ImageAllTypesNoBitmap, NewIterators)
 {
   using ImageTraits = TypeParam;
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2022-2024 Igara Studio S.A.
+// Copyright (c) 2022-2026 Igara Studio S.A.
 // Copyright (c) 2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,8 +9,10 @@
 #define DOC_KEYFRAMES_H_INCLUDED
 #pragma once
 
+#include "base/debug.h"
 #include "doc/frame.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -120,6 +122,17 @@ public:
       m_keys.push_back(Key(key.frame(), std::make_unique<T>(*key.value())));
   }
 
+  // Bulk-load constructor: takes an already built list of keys
+  // (which must be sorted by frame) avoiding the per-key shifting
+  // cost of calling insert() repeatedly.
+  Keyframes(List&& keys) : m_keys(std::move(keys))
+  {
+#ifdef _DEBUG
+    for (std::size_t i = 1; i < m_keys.size(); ++i)
+      ASSERT(m_keys[i - 1].frame() < m_keys[i].frame());
+#endif
+  }
+
   void insert(const frame_t frame, std::unique_ptr<T>&& value)
   {
     auto it = getIterator(frame);
@@ -136,6 +149,7 @@ public:
         ++it;
       m_keys.insert(it, Key(frame, std::move(value)));
     }
+    m_lastIndex = -1;
   }
 
   void remove(const frame_t frame)
@@ -143,6 +157,7 @@ public:
     auto it = getIterator(frame);
     if (it != end())
       m_keys.erase(it);
+    m_lastIndex = -1;
   }
 
   T* operator[](const frame_t frame)
@@ -161,18 +176,34 @@ public:
   std::size_t size() const { return m_keys.size(); }
   bool empty() const { return m_keys.empty(); }
 
+  // Returns the key that governs the given frame (the last key with
+  // key.frame() <= frame), the first key if the frame precedes all
+  // keys, or end() if there are no keys at all.
   iterator getIterator(const frame_t frame)
   {
-    auto it = m_keys.begin(), end = m_keys.end();
-    auto next = it;
-    for (; it != end; it = next) {
-      ++next;
-      if (((frame >= it->frame()) && (next == end || frame < next->frame())) ||
-          (frame < it->frame())) {
-        return it;
+    if (m_keys.empty())
+      return m_keys.end();
+
+    // Fast path: playback resolves properties frame by frame, so
+    // consecutive queries usually fall in the same interval as the
+    // last one (or in the next one).
+    if (m_lastIndex >= 0 && m_lastIndex < int(m_keys.size())) {
+      for (int i = m_lastIndex; i <= m_lastIndex + 1; ++i) {
+        if (i < int(m_keys.size()) && governsFrame(i, frame)) {
+          m_lastIndex = i;
+          return m_keys.begin() + i;
+        }
       }
     }
-    return end;
+
+    auto it = std::upper_bound(m_keys.begin(),
+                               m_keys.end(),
+                               frame,
+                               [](const frame_t f, const Key& key) { return f < key.frame(); });
+    if (it != m_keys.begin())
+      --it;
+    m_lastIndex = int(it - m_keys.begin());
+    return it;
   }
 
   frame_t fromFrame() const
@@ -195,7 +226,19 @@ public:
   }
 
 private:
+  // True if getIterator(frame) must return the key at index "i".
+  bool governsFrame(const int i, const frame_t frame) const
+  {
+    if (frame < m_keys[i].frame())
+      return (i == 0); // Before the first key we return the first key
+    return (i + 1 == int(m_keys.size()) || frame < m_keys[i + 1].frame());
+  }
+
   List m_keys;
+
+  // Index of the key returned by the last getIterator() call (-1 if
+  // the cache is not valid, e.g. after a keys modification).
+  int m_lastIndex = -1;
 };
 
 } // namespace doc
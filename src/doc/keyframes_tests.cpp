@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2022 Igara Studio S.A.
+// Copyright (c) 2022-2026 Igara Studio S.A.
 // Copyright (c) 2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -138,6 +138,54 @@ TEST(Keyframes, BugEmptyCount)
   EXPECT_EQ(5, **k.range(8, 9).begin());
 }
 
+TEST(Keyframes, BulkLoad)
+{
+  Keyframes<int>::List list;
+  list.push_back(Keyframes<int>::Key(1, std::make_unique<int>(10)));
+  list.push_back(Keyframes<int>::Key(4, std::make_unique<int>(40)));
+  list.push_back(Keyframes<int>::Key(9, std::make_unique<int>(90)));
+
+  Keyframes<int> k(std::move(list));
+  EXPECT_EQ(3, k.size());
+  EXPECT_EQ(1, k.fromFrame());
+  EXPECT_EQ(9, k.toFrame());
+  EXPECT_EQ(nullptr, k[0]);
+  EXPECT_EQ(10, *k[1]);
+  EXPECT_EQ(10, *k[3]);
+  EXPECT_EQ(40, *k[4]);
+  EXPECT_EQ(40, *k[8]);
+  EXPECT_EQ(90, *k[9]);
+  EXPECT_EQ(90, *k[100]);
+}
+
+TEST(Keyframes, SequentialAndRandomLookups)
+{
+  // Queries in playback order (which hit the cached interval) must
+  // return the same keys as random/backward queries (which fall back
+  // to the binary search).
+  Keyframes<int> k;
+  for (int i = 0; i < 32; ++i)
+    k.insert(i * 3, std::make_unique<int>(i));
+
+  for (frame_t f = 0; f < 100; ++f)
+    EXPECT_EQ(std::min(int(f) / 3, 31), *k[f]);
+
+  for (frame_t f = 99; f >= 0; --f)
+    EXPECT_EQ(std::min(int(f) / 3, 31), *k[f]);
+
+  EXPECT_EQ(10, *k[30]);
+  EXPECT_EQ(0, *k[2]);
+  EXPECT_EQ(31, *k[1000]);
+  EXPECT_EQ(nullptr, k[-1]);
+
+  // Mutations invalidate the cached interval
+  EXPECT_EQ(5, *k[17]);
+  k.remove(15);
+  EXPECT_EQ(4, *k[17]);
+  k.insert(16, std::make_unique<int>(99));
+  EXPECT_EQ(99, *k[17]);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -20,6 +20,7 @@
 #include "doc/tilesets.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 
 namespace doc {
@@ -417,6 +418,9 @@ void LayerGroup::destroyAllLayers()
   for (Layer* layer : m_layers)
     delete layer;
   m_layers.clear();
+
+  if (sprite())
+    sprite()->invalidateLayerIndexes();
 }
 
 int LayerGroup::getMemSize() const
@@ -546,6 +550,9 @@ void LayerGroup::addLayer(Layer* layer)
 {
   m_layers.push_back(layer);
   layer->setParent(this);
+
+  if (sprite())
+    sprite()->invalidateLayerIndexes();
 }
 
 void LayerGroup::removeLayer(Layer* layer)
@@ -555,6 +562,9 @@ void LayerGroup::removeLayer(Layer* layer)
   m_layers.erase(it);
 
   layer->setParent(nullptr);
+
+  if (sprite())
+    sprite()->invalidateLayerIndexes();
 }
 
 void LayerGroup::insertLayer(Layer* layer, Layer* after)
@@ -568,6 +578,9 @@ void LayerGroup::insertLayer(Layer* layer, Layer* after)
   m_layers.insert(after_it, layer);
 
   layer->setParent(this);
+
+  if (sprite())
+    sprite()->invalidateLayerIndexes();
 }
 
 void LayerGroup::insertLayerBefore(Layer* layer, Layer* before)
@@ -579,6 +592,9 @@ void LayerGroup::insertLayerBefore(Layer* layer, Layer* before)
   m_layers.insert(before_it, layer);
 
   layer->setParent(this);
+
+  if (sprite())
+    sprite()->invalidateLayerIndexes();
 }
 
 void LayerGroup::stackLayer(Layer* layer, Layer* after)
@@ -615,4 +631,58 @@ layer_t LayerGroup::getLayerIndex(const Layer* layer) const
   return this->getLayerIndex(layer, index);
 }
 
+ObjectVersion LayerGroup::contentVersion(const frame_t frame) const
+{
+  // Covers visibility/structure changes (the layer version) and cel
+  // movements/resizes (the cel/cel data versions); pixel edits don't
+  // matter here because they cannot change the cel bounds.
+  ObjectVersion v = version();
+  for (const Layer* child : m_layers) {
+    v += child->version();
+    if (child->isGroup()) {
+      v += static_cast<const LayerGroup*>(child)->contentVersion(frame);
+    }
+    else if (const Cel* cel = child->cel(frame)) {
+      v += cel->version();
+      v += cel->data()->version();
+    }
+  }
+  return v;
+}
+
+gfx::Rect LayerGroup::contentBounds(const frame_t frame) const
+{
+  const ObjectVersion v = contentVersion(frame);
+  auto it = m_contentBoundsCache.find(frame);
+  if (it != m_contentBoundsCache.end() && it->second.version == v)
+    return it->second.bounds;
+
+  gfx::Rect bounds;
+  for (const Layer* child : m_layers) {
+    if (!child->isVisible())
+      continue;
+
+    if (child->isGroup()) {
+      bounds |= static_cast<const LayerGroup*>(child)->contentBounds(frame);
+    }
+    else if (const Cel* cel = child->cel(frame)) {
+      // Reference cels can have non-integer bounds
+      if (child->isReference()) {
+        const gfx::RectF& rcF = cel->boundsF();
+        const int x1 = int(std::floor(rcF.x));
+        const int y1 = int(std::floor(rcF.y));
+        bounds |= gfx::Rect(x1,
+                            y1,
+                            int(std::ceil(rcF.x2())) - x1,
+                            int(std::ceil(rcF.y2())) - y1);
+      }
+      else
+        bounds |= cel->bounds();
+    }
+  }
+
+  m_contentBoundsCache[frame] = ContentBoundsCache{ v, bounds };
+  return bounds;
+}
+
 } // namespace doc
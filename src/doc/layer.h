@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -18,7 +18,9 @@
 #include "doc/layer_list.h"
 #include "doc/object.h"
 #include "doc/with_user_data.h"
+#include "gfx/rect.h"
 
+#include <map>
 #include <string>
 
 namespace doc {
@@ -240,12 +242,28 @@ public:
 
   layer_t getLayerIndex(const Layer* layer) const;
 
+  // Union of the bounds of all the cels of the visible sublayers at
+  // the given frame, recursively for child groups (an empty rectangle
+  // if the group has no content in that frame). Used to cull whole
+  // groups when rendering a small area (see RenderPlan). The result
+  // is cached per frame and revalidated comparing an aggregate of
+  // the sublayer/cel versions (all app::Cmds increment versions).
+  gfx::Rect contentBounds(frame_t frame) const;
+
 private:
   void destroyAllLayers();
 
   layer_t getLayerIndex(const Layer* layer, layer_t& index) const;
 
+  ObjectVersion contentVersion(frame_t frame) const;
+
+  struct ContentBoundsCache {
+    ObjectVersion version = 0;
+    gfx::Rect bounds;
+  };
+
   LayerList m_layers;
+  mutable std::map<frame_t, ContentBoundsCache> m_contentBoundsCache;
 };
 
 } // namespace doc
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2025 Igara Studio S.A.
+// Copyright (c) 2025-2026 Igara Studio S.A.
 // Copyright (c) 2001-2015 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -13,6 +13,9 @@
 
 #include "doc/image.h"
 #include "doc/mask.h"
+#include "doc/primitives_fast.h"
+
+#include <cstdint>
 
 namespace doc {
 
@@ -21,6 +24,7 @@ void MaskBoundaries::reset()
   m_segs.clear();
   if (!m_path.isEmpty())
     m_path.rewind();
+  ++m_version;
 }
 
 void MaskBoundaries::regen(const Mask* mask)
@@ -361,12 +365,124 @@ void MaskBoundaries::regen(const Image* bitmap)
   ASSERT(prevIt == bits.end());
 }
 
+void MaskBoundaries::regen(const Mask* mask, const gfx::Rect& dirtyBounds)
+{
+  ASSERT(mask);
+  if (!mask || mask->isEmpty()) {
+    reset();
+    return;
+  }
+
+  const gfx::Rect maskBounds = mask->bounds();
+
+  // Dirty rect in bitmap coordinates, expanded one pixel so the edges
+  // in the dirty border are regenerated too, and clipped to the
+  // bitmap.
+  gfx::Rect d = dirtyBounds;
+  d.offset(-maskBounds.x, -maskBounds.y);
+  d.enlarge(1);
+  d &= gfx::Rect(0, 0, maskBounds.w, maskBounds.h);
+
+  // Full regen when there is nothing to update incrementally or the
+  // changed area covers most of the mask anyway.
+  if (m_segs.empty() || d.isEmpty() ||
+      std::int64_t(d.w) * d.h * 2 >= std::int64_t(maskBounds.w) * maskBounds.h) {
+    regen(mask);
+    return;
+  }
+
+  // The edges regenerated below (in absolute coordinates): horizontal
+  // edges in rows [dabs.y, dabs.y2()] / columns [dabs.x, dabs.x2()),
+  // and vertical edges in columns [dabs.x, dabs.x2()] / rows
+  // [dabs.y, dabs.y2()). First drop (or truncate, for segments
+  // crossing the dirty border) the old segments covering those edges.
+  const gfx::Rect dabs(d.x + maskBounds.x, d.y + maskBounds.y, d.w, d.h);
+  list_type kept;
+  kept.reserve(m_segs.size());
+  for (const Segment& seg : m_segs) {
+    const gfx::Rect& rc = seg.bounds();
+    if (seg.horizontal()) {
+      if (rc.y < dabs.y || rc.y > dabs.y2() || rc.x >= dabs.x2() || rc.x2() <= dabs.x) {
+        kept.push_back(seg);
+        continue;
+      }
+      if (rc.x < dabs.x)
+        kept.push_back(Segment(seg.open(), gfx::Rect(rc.x, rc.y, dabs.x - rc.x, 0)));
+      if (rc.x2() > dabs.x2())
+        kept.push_back(Segment(seg.open(), gfx::Rect(dabs.x2(), rc.y, rc.x2() - dabs.x2(), 0)));
+    }
+    else {
+      if (rc.x < dabs.x || rc.x > dabs.x2() || rc.y >= dabs.y2() || rc.y2() <= dabs.y) {
+        kept.push_back(seg);
+        continue;
+      }
+      if (rc.y < dabs.y)
+        kept.push_back(Segment(seg.open(), gfx::Rect(rc.x, rc.y, 0, dabs.y - rc.y)));
+      if (rc.y2() > dabs.y2())
+        kept.push_back(Segment(seg.open(), gfx::Rect(rc.x, dabs.y2(), 0, rc.y2() - dabs.y2())));
+    }
+  }
+  m_segs.swap(kept);
+
+  const Image* bitmap = mask->bitmap();
+  auto pix = [bitmap](int u, int v) -> bool {
+    if (u < 0 || v < 0 || u >= bitmap->width() || v >= bitmap->height())
+      return false;
+    return get_pixel_fast<BitmapTraits>(bitmap, u, v) != 0;
+  };
+
+  // Horizontal edges (edge in row y separates pixel rows y-1 and y);
+  // consecutive edges with the same open flag are merged in one run.
+  for (int y = d.y; y <= d.y2(); ++y) {
+    int runStart = -1;
+    bool runOpen = false;
+    for (int x = d.x; x <= d.x2(); ++x) {
+      const bool below = pix(x, y);
+      const bool edge = (x < d.x2() && pix(x, y - 1) != below);
+      if (runStart >= 0 && (!edge || below != runOpen)) {
+        m_segs.push_back(
+          Segment(runOpen, gfx::Rect(runStart + maskBounds.x, y + maskBounds.y, x - runStart, 0)));
+        runStart = -1;
+      }
+      if (edge && runStart < 0) {
+        runStart = x;
+        runOpen = below;
+      }
+    }
+  }
+
+  // Vertical edges (edge in column x separates pixel columns x-1 and x)
+  for (int x = d.x; x <= d.x2(); ++x) {
+    int runStart = -1;
+    bool runOpen = false;
+    for (int y = d.y; y <= d.y2(); ++y) {
+      const bool right = pix(x, y);
+      const bool edge = (y < d.y2() && pix(x - 1, y) != right);
+      if (runStart >= 0 && (!edge || right != runOpen)) {
+        m_segs.push_back(
+          Segment(runOpen, gfx::Rect(x + maskBounds.x, runStart + maskBounds.y, 0, y - runStart)));
+        runStart = -1;
+      }
+      if (edge && runStart < 0) {
+        runStart = y;
+        runOpen = right;
+      }
+    }
+  }
+
+  // The cached path is outdated now
+  if (!m_path.isEmpty())
+    m_path.rewind();
+  ++m_version;
+}
+
 void MaskBoundaries::offset(int x, int y)
 {
   for (Segment& seg : m_segs)
     seg.offset(x, y);
 
   m_path.offset(x, y);
+  ++m_version;
 }
 
 void MaskBoundaries::createPathIfNeeeded()
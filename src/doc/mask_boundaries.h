@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2020-2025 Igara Studio S.A.
+// Copyright (c) 2020-2026 Igara Studio S.A.
 // Copyright (c) 2001-2015 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -48,6 +48,13 @@ public:
   void regen(const Mask* mask);
   void regen(const Image* bitmap);
 
+  // Incremental mode: updates only the segments that intersect
+  // dirtyBounds (in the same coordinate space as regen(Mask*), i.e.
+  // including the mask origin), keeping every other segment as is.
+  // Falls back to a full regen() when there are no previous segments
+  // or the dirty area covers most of the mask.
+  void regen(const Mask* mask, const gfx::Rect& dirtyBounds);
+
   const_iterator begin() const { return m_segs.begin(); }
   const_iterator end() const { return m_segs.end(); }
   iterator begin() { return m_segs.begin(); }
@@ -56,11 +63,17 @@ public:
   void offset(int x, int y);
   gfx::Path& path() { return m_path; }
 
+  // Number that changes each time the boundaries are modified, so
+  // cached representations of them (e.g. the path transformed to
+  // screen coordinates) can know when they must be rebuilt.
+  int version() const { return m_version; }
+
   void createPathIfNeeeded();
 
 private:
   list_type m_segs;
   gfx::Path m_path;
+  int m_version = 1;
 };
 
 } // namespace doc
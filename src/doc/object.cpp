@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -13,8 +13,11 @@
 
 #include "base/debug.h"
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <set>
 
 namespace doc {
 
@@ -23,8 +26,37 @@ static ObjectId newId = 0;
 // TODO Profile this and see if an unordered_map is better
 static std::map<ObjectId, Object*> objects;
 
+// Opt-in allocation instrumentation (see set_object_stats_enabled()).
+// The flag is atomic so the creation/destruction hot path can check
+// it without taking g_mutex, which guards the containers.
+static std::atomic<bool> g_statsEnabled(false);
+static std::set<Object*> g_liveObjects;
+static std::map<ObjectType, ObjectStats> g_stats;
+
+static void track_object_creation(Object* obj, const ObjectType type)
+{
+  if (!g_statsEnabled.load(std::memory_order_relaxed))
+    return;
+
+  const std::lock_guard lock(g_mutex);
+  g_liveObjects.insert(obj);
+  ++g_stats[type].totalCount;
+}
+
+static void track_object_destruction(Object* obj)
+{
+  if (!g_statsEnabled.load(std::memory_order_relaxed))
+    return;
+
+  const std::lock_guard lock(g_mutex);
+  // The object might not be registered if tracking was enabled after
+  // its creation.
+  g_liveObjects.erase(obj);
+}
+
 Object::Object(ObjectType type) : m_type(type), m_id(0), m_version(0)
 {
+  track_object_creation(this, m_type);
 }
 
 Object::Object(const Object& other)
@@ -32,12 +64,15 @@ Object::Object(const Object& other)
   , m_id(0)      // We don't copy the ID
   , m_version(0) // We don't copy the version
 {
+  track_object_creation(this, m_type);
 }
 
 Object::~Object()
 {
   if (m_id)
     setId(0);
+
+  track_object_destruction(this);
 }
 
 int Object::getMemSize() const
@@ -109,4 +144,60 @@ Object* get_object(ObjectId id)
     return nullptr;
 }
 
+void set_object_stats_enabled(const bool enabled)
+{
+  const std::lock_guard lock(g_mutex);
+  // Restart from zero in both directions: when disabling we must
+  // drop the registered pointers (destructions are not tracked
+  // anymore), and enabling starts a fresh capture.
+  g_liveObjects.clear();
+  g_stats.clear();
+  g_statsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool object_stats_enabled()
+{
+  return g_statsEnabled.load(std::memory_order_relaxed);
+}
+
+std::map<ObjectType, ObjectStats> get_object_stats()
+{
+  const std::lock_guard lock(g_mutex);
+
+  for (auto& it : g_stats) {
+    it.second.liveCount = 0;
+    it.second.liveBytes = 0;
+  }
+  for (const Object* obj : g_liveObjects) {
+    ObjectStats& stats = g_stats[obj->type()];
+    ++stats.liveCount;
+    stats.liveBytes += obj->getMemSize();
+  }
+  for (auto& it : g_stats)
+    it.second.peakBytes = std::max(it.second.peakBytes, it.second.liveBytes);
+
+  return g_stats;
+}
+
+const char* object_type_name(const ObjectType type)
+{
+  switch (type) {
+    case ObjectType::Image:        return "Image";
+    case ObjectType::Palette:      return "Palette";
+    case ObjectType::Mask:         return "Mask";
+    case ObjectType::Cel:          return "Cel";
+    case ObjectType::CelData:      return "CelData";
+    case ObjectType::LayerImage:   return "LayerImage";
+    case ObjectType::LayerGroup:   return "LayerGroup";
+    case ObjectType::Sprite:       return "Sprite";
+    case ObjectType::Document:     return "Document";
+    case ObjectType::Tag:          return "Tag";
+    case ObjectType::Slice:        return "Slice";
+    case ObjectType::LayerTilemap: return "LayerTilemap";
+    case ObjectType::Tileset:      return "Tileset";
+    case ObjectType::Tilesets:     return "Tilesets";
+    default:                       return "Unknown";
+  }
+}
+
 } // namespace doc
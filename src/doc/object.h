@@ -1,4 +1,5 @@
 // Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2015 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,6 +13,9 @@
 #include "doc/object_type.h"
 #include "doc/object_version.h"
 
+#include <cstddef>
+#include <map>
+
 namespace doc {
 
 class Object {
@@ -54,6 +58,36 @@ inline T* get(ObjectId id)
   return static_cast<T*>(get_object(id));
 }
 
+// Per-type statistics of live Object instances (see
+// set_object_stats_enabled()).
+struct ObjectStats {
+  std::size_t liveCount = 0;  // Objects alive right now
+  std::size_t liveBytes = 0;  // Sum of getMemSize() of the live objects
+  std::size_t peakBytes = 0;  // Maximum liveBytes seen by get_object_stats()
+  std::size_t totalCount = 0; // Objects created since tracking was enabled
+};
+
+// Opt-in allocation instrumentation: while it's enabled each Object
+// registers itself on creation so get_object_stats() can report
+// per-type live counts and memory usage, useful to chase leaks or
+// track the memory of a long session without an external profiler
+// attached. It adds a small cost to each object creation/destruction
+// so it's disabled by default. Enabling it (again) restarts the
+// stats from zero.
+void set_object_stats_enabled(bool enabled);
+bool object_stats_enabled();
+
+// Returns the stats of each object type created since tracking was
+// enabled. Sizes are gathered calling getMemSize() on each live
+// object, so objects being created/destroyed by background jobs at
+// the same time can be counted with a stale size (this is a
+// diagnostic mode, numbers are approximations anyway).
+std::map<ObjectType, ObjectStats> get_object_stats();
+
+// Human-readable name of an object type (e.g. for the object stats
+// report).
+const char* object_type_name(ObjectType type);
+
 } // namespace doc
 
 #endif
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2020-2024 Igara Studio S.A.
+// Copyright (c) 2020-2026 Igara Studio S.A.
 // Copyright (c) 2001-2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -14,11 +14,13 @@
 #include "base/base.h"
 #include "doc/image.h"
 #include "doc/palette_gradient_type.h"
+#include "doc/palette_planes.h"
 #include "doc/remap.h"
 #include "gfx/hsv.h"
 #include "gfx/rgb.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <limits>
 
@@ -339,6 +341,30 @@ void Palette::initBestfit()
   }
 }
 
+// As the scan in findBestfit() only sees 5 bits per channel, every
+// color inside the same 5-bits-per-channel bucket maps to the same
+// palette entry, so we can memoize the whole domain in a flat table
+// (2^20 entries, 2MB) instead of keeping a tree. The table is stamped
+// with the palette modifications counter and the mask index it was
+// built for; a mismatch just allocates a fresh table (the shared_ptr
+// keeps the old one alive for threads still reading it).
+struct Palette::BestfitCache {
+  static constexpr uint16_t kNoEntry = 0xffff;
+
+  int modifications;
+  int maskIndex;
+  std::vector<std::atomic<uint16_t>> entries;
+
+  BestfitCache(int modifications, int maskIndex)
+    : modifications(modifications)
+    , maskIndex(maskIndex)
+    , entries(1 << 20)
+  {
+    for (auto& entry : entries)
+      entry.store(kNoEntry, std::memory_order_relaxed);
+  }
+};
+
 int Palette::findBestfit(int r, int g, int b, int a, int mask_index) const
 {
   ASSERT(r >= 0 && r <= 255);
@@ -356,6 +382,21 @@ int Palette::findBestfit(int r, int g, int b, int a, int mask_index) const
   if (a == 0 && mask_index >= 0)
     return mask_index;
 
+  std::shared_ptr<BestfitCache> cache;
+  {
+    const std::lock_guard<std::mutex> lock(m_bestfitMutex);
+    if (!m_bestfitCache || m_bestfitCache->modifications != m_modifications ||
+        m_bestfitCache->maskIndex != mask_index) {
+      m_bestfitCache = std::make_shared<BestfitCache>(m_modifications, mask_index);
+    }
+    cache = m_bestfitCache;
+  }
+
+  const uint32_t key = (r << 15) | (g << 10) | (b << 5) | a;
+  const uint16_t cached = cache->entries[key].load(std::memory_order_relaxed);
+  if (cached != BestfitCache::kNoEntry)
+    return cached;
+
   int bestfit = 0;
   int lowest = std::numeric_limits<int>::max();
   int size = std::min(256, int(m_colors.size()));
@@ -371,8 +412,11 @@ int Palette::findBestfit(int r, int g, int b, int a, int mask_index) const
         if (coldiff < lowest) {
           coldiff += col_diff_a[(((rgba_geta(rgb) >> 3) - a) & 127)];
           if (coldiff < lowest && i != mask_index) {
-            if (coldiff == 0)
-              return i;
+            if (coldiff == 0) {
+              bestfit = i;
+              lowest = 0;
+              break;
+            }
 
             bestfit = i;
             lowest = coldiff;
@@ -381,6 +425,8 @@ int Palette::findBestfit(int r, int g, int b, int a, int mask_index) const
       }
     }
   }
+
+  cache->entries[key].store(uint16_t(bestfit), std::memory_order_relaxed);
   return bestfit;
 }
 
@@ -394,6 +440,17 @@ int Palette::findMaskColor() const
   return -1;
 }
 
+std::shared_ptr<const PalettePlanes> Palette::planes() const
+{
+  const std::lock_guard<std::mutex> lock(m_planesMutex);
+  if (!m_planes || m_planes->modifications() != m_modifications) {
+    auto planes = std::make_shared<PalettePlanes>();
+    planes->rebuild(*this);
+    m_planes = std::move(planes);
+  }
+  return m_planes;
+}
+
 void Palette::applyRemap(const Remap& remap)
 {
   Palette original(*this);
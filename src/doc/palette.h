@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (C) 2020-2023  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -15,11 +15,14 @@
 #include "doc/object.h"
 #include "doc/palette_gradient_type.h"
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace doc {
 
+class PalettePlanes;
 class Remap;
 
 class Palette : public Object {
@@ -100,17 +103,42 @@ public:
 
   void applyRemap(const Remap& remap);
 
+  // Returns a packed structure-of-arrays mirror of the palette
+  // channels (plus precomputed HSV/luma/lightness), rebuilt lazily
+  // when the palette changes. The shared_ptr keeps a consistent
+  // snapshot alive even if the palette is modified while a caller is
+  // still reading it.
+  std::shared_ptr<const PalettePlanes> planes() const;
+
   // TODO add undo/redo support of entry names
   void setEntryName(const int i, const std::string& name);
   const std::string& getEntryName(const int i) const;
 
 private:
+  struct BestfitCache;
+
   frame_t m_frame;
   std::vector<color_t> m_colors;
   std::vector<std::string> m_names;
   int m_modifications;
   std::string m_filename; // If the palette is associated with a file.
   std::string m_comment;  // Some extra comment from the .gpl file (author, website, etc.).
+
+  // Memoized findBestfit() results, one entry per 5-bits-per-channel
+  // RGBA value (the precision findBestfit() already works with). It's
+  // created lazily on the first lookup and replaced when
+  // m_modifications or the requested mask index change, so it never
+  // has to be invalidated explicitly by palette mutators. Lookups can
+  // happen concurrently from background threads (e.g. parallel
+  // dithering bands sharing the same palette): each call pins the
+  // cache with a local reference and the entries are atomics.
+  mutable std::shared_ptr<BestfitCache> m_bestfitCache;
+  mutable std::mutex m_bestfitMutex;
+
+  // Lazily-built SoA mirror of the palette (see planes()), stamped
+  // with the modifications counter of the palette it was built from.
+  mutable std::shared_ptr<const PalettePlanes> m_planes;
+  mutable std::mutex m_planesMutex;
 };
 
 } // namespace doc
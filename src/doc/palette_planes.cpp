@@ -0,0 +1,58 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "doc/palette_planes.h"
+
+#include "doc/color.h"
+#include "doc/palette.h"
+#include "gfx/hsv.h"
+#include "gfx/rgb.h"
+
+#include <algorithm>
+
+namespace doc {
+
+void PalettePlanes::rebuild(const Palette& palette)
+{
+  const int n = palette.size();
+
+  m_modifications = palette.getModifications();
+  m_r.resize(n);
+  m_g.resize(n);
+  m_b.resize(n);
+  m_a.resize(n);
+  m_hue.resize(n);
+  m_saturation.resize(n);
+  m_value.resize(n);
+  m_lightness.resize(n);
+  m_luma.resize(n);
+
+  for (int i = 0; i < n; ++i) {
+    const color_t c = palette.getEntry(i);
+    const int r = rgba_getr(c);
+    const int g = rgba_getg(c);
+    const int b = rgba_getb(c);
+
+    m_r[i] = r;
+    m_g[i] = g;
+    m_b[i] = b;
+    m_a[i] = rgba_geta(c);
+
+    const gfx::Hsv hsv(gfx::Rgb(r, g, b));
+    m_hue[i] = hsv.hueInt();
+    m_saturation[i] = hsv.saturationInt();
+    m_value[i] = hsv.valueInt();
+
+    m_luma[i] = rgb_luma(r * r, g * g, b * b);
+    m_lightness[i] = (std::min(r, std::min(g, b)) + std::max(r, std::max(g, b))) / 2;
+  }
+}
+
+} // namespace doc
@@ -0,0 +1,63 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef DOC_PALETTE_PLANES_H_INCLUDED
+#define DOC_PALETTE_PLANES_H_INCLUDED
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace doc {
+
+class Palette;
+
+// Packed structure-of-arrays mirror of the channels of a Palette,
+// with the HSV/luma/lightness of each entry precomputed, so
+// operations that evaluate every entry (sorting, similarity
+// computations, etc.) can run over contiguous planes instead of
+// unpacking every rgba() value again on each comparison. Instances
+// are obtained with Palette::planes(), which rebuilds the mirror
+// only when the palette changes.
+class PalettePlanes {
+public:
+  // Fills the planes from the given palette (reusing the allocated
+  // storage) and stamps the mirror with the palette modifications
+  // counter.
+  void rebuild(const Palette& palette);
+
+  int modifications() const { return m_modifications; }
+  int size() const { return int(m_r.size()); }
+
+  const std::vector<uint8_t>& r() const { return m_r; }
+  const std::vector<uint8_t>& g() const { return m_g; }
+  const std::vector<uint8_t>& b() const { return m_b; }
+  const std::vector<uint8_t>& a() const { return m_a; }
+
+  // HSV components in the same integer ranges used by gfx::Hsv
+  // (hue 0-360, saturation/value 0-100).
+  const std::vector<int16_t>& hue() const { return m_hue; }
+  const std::vector<uint8_t>& saturation() const { return m_saturation; }
+  const std::vector<uint8_t>& value() const { return m_value; }
+
+  // Approximated perceptual luminance (rgb_luma() over the squared
+  // sRGB channels, like SortPaletteBy::LUMA).
+  const std::vector<int32_t>& luma() const { return m_luma; }
+
+  // HSL lightness ((min + max) / 2).
+  const std::vector<uint8_t>& lightness() const { return m_lightness; }
+
+private:
+  int m_modifications = -1;
+  std::vector<uint8_t> m_r, m_g, m_b, m_a;
+  std::vector<int16_t> m_hue;
+  std::vector<uint8_t> m_saturation, m_value, m_lightness;
+  std::vector<int32_t> m_luma;
+};
+
+} // namespace doc
+
+#endif
@@ -0,0 +1,70 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "doc/palette.h"
+
+using namespace doc;
+
+TEST(Palette, FindBestfitExactColors)
+{
+  Palette pal(frame_t(0), 4);
+  pal.setEntry(0, rgba(0, 0, 0, 255));
+  pal.setEntry(1, rgba(255, 0, 0, 255));
+  pal.setEntry(2, rgba(0, 255, 0, 255));
+  pal.setEntry(3, rgba(0, 0, 255, 255));
+
+  // Exact matches (asked twice so the second call goes through the
+  // memoized table and must return the same entry).
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(0, pal.findBestfit(0, 0, 0, 255, -1));
+    EXPECT_EQ(1, pal.findBestfit(255, 0, 0, 255, -1));
+    EXPECT_EQ(2, pal.findBestfit(0, 255, 0, 255, -1));
+    EXPECT_EQ(3, pal.findBestfit(0, 0, 255, 255, -1));
+  }
+
+  // Near matches.
+  EXPECT_EQ(1, pal.findBestfit(250, 10, 10, 255, -1));
+  EXPECT_EQ(2, pal.findBestfit(10, 250, 10, 255, -1));
+
+  // Transparent colors map to the mask index.
+  EXPECT_EQ(0, pal.findBestfit(128, 128, 128, 0, 0));
+}
+
+TEST(Palette, FindBestfitTracksPaletteChanges)
+{
+  Palette pal(frame_t(0), 2);
+  pal.setEntry(0, rgba(0, 0, 0, 255));
+  pal.setEntry(1, rgba(255, 255, 255, 255));
+
+  // Black is the closest entry (the green-weighted metric penalizes
+  // white's green distance more than black's red distance).
+  EXPECT_EQ(0, pal.findBestfit(255, 0, 0, 255, -1));
+
+  // A better candidate invalidates the memoized results.
+  pal.addEntry(rgba(255, 0, 0, 255));
+  EXPECT_EQ(2, pal.findBestfit(255, 0, 0, 255, -1));
+
+  pal.setEntry(2, rgba(0, 0, 255, 255));
+  EXPECT_EQ(0, pal.findBestfit(255, 0, 0, 255, -1));
+
+  // A different mask index must not reuse results memoized for the
+  // previous one.
+  EXPECT_EQ(0, pal.findBestfit(16, 16, 16, 255, -1));
+  EXPECT_EQ(2, pal.findBestfit(16, 16, 16, 255, 0));
+}
+
+int main(int argc, char** argv)
+{
+  Palette::initBestfit();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2018-2023 Igara Studio S.A.
+// Copyright (c) 2018-2026 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -523,15 +523,26 @@ void remap_image(Image* image, const Remap& remap)
   ASSERT(image->pixelFormat() == IMAGE_INDEXED || image->pixelFormat() == IMAGE_TILEMAP);
 
   switch (image->pixelFormat()) {
-    case IMAGE_INDEXED:
-      transform_image<IndexedTraits>(image, [&remap](color_t c) -> color_t {
-        auto to = remap[c];
-        if (to != Remap::kUnused)
-          return to;
-        else
-          return c;
-      });
+    case IMAGE_INDEXED: {
+      // Flatten the remap into a plain 256-entry table (resolving the
+      // kUnused/out-of-range entries once) so the inner loop is a
+      // single byte lookup over the raw rows instead of a branchy
+      // ranged lookup per pixel.
+      uint8_t lut[256];
+      for (int i = 0; i < 256; ++i) {
+        const int to = remap[i];
+        lut[i] = (to != Remap::kUnused ? to : i);
+      }
+
+      const int w = image->width();
+      const int h = image->height();
+      for (int y = 0; y < h; ++y) {
+        uint8_t* row = image->getPixelAddress(0, y);
+        for (int x = 0; x < w; ++x)
+          row[x] = lut[row[x]];
+      }
       break;
+    }
     case IMAGE_TILEMAP:
       transform_image<TilemapTraits>(image, [&remap](color_t c) -> color_t {
         auto to = remap[tile_geti(c)];
@@ -588,15 +599,43 @@ uint32_t calculate_image_hash(const Image* img, const gfx::Rect& bounds)
   return 0;
 }
 
+uint64_t calculate_image_hash64(const Image* image)
+{
+  // Number of bytes with real pixel data on each row (bitmaps pack 8
+  // pixels per byte).
+  const size_t widthBytes = (image->colorMode() == ColorMode::BITMAP ?
+                              BitmapTraits::width_bytes(image->width()) :
+                              image->widthBytes());
+
+  // Lazy images (ImageSpec::lazyStrips()) don't store all their rows
+  // in one contiguous buffer.
+  if (widthBytes == size_t(image->rowBytes()) && !image->spec().lazyStrips()) {
+    return CityHash64((const char*)image->getPixelAddress(0, 0), widthBytes * image->height());
+  }
+  else {
+    std::vector<uint8_t> buf(widthBytes * image->height());
+    uint8_t* dst = &buf[0];
+    for (int y = 0; y < image->height(); ++y, dst += widthBytes) {
+      auto src = (const uint8_t*)image->getPixelAddress(0, y);
+      std::copy(src, src + widthBytes, dst);
+    }
+    return CityHash64((const char*)&buf[0], buf.size());
+  }
+}
+
 void preprocess_transparent_pixels(Image* image)
 {
+  bool modified = false;
+
   switch (image->pixelFormat()) {
     case IMAGE_RGB: {
       LockImageBits<RgbTraits> bits(image);
       auto it = bits.begin(), end = bits.end();
       for (; it != end; ++it) {
-        if (rgba_geta(*it) == 0)
+        if (rgba_geta(*it) == 0 && *it != 0) {
           *it = 0;
+          modified = true;
+        }
       }
       break;
     }
@@ -605,12 +644,18 @@ void preprocess_transparent_pixels(Image* image)
       LockImageBits<GrayscaleTraits> bits(image);
       auto it = bits.begin(), end = bits.end();
       for (; it != end; ++it) {
-        if (graya_geta(*it) == 0)
+        if (graya_geta(*it) == 0 && *it != 0) {
           *it = 0;
+          modified = true;
+        }
       }
       break;
     }
   }
+
+  // Keep the cached Image::contentHash() in sync with the new pixels
+  if (modified)
+    image->incrementVersion();
 }
 
 } // namespace doc
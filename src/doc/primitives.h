@@ -75,6 +75,12 @@ void remap_image(Image* image, const Remap& remap);
 
 uint32_t calculate_image_hash(const Image* image, const gfx::Rect& bounds);
 
+// 64-bit hash of the raw pixel bytes of the whole image (used by
+// Image::contentHash() to compare images between documents). Note
+// that, unlike is_same_image(), fully transparent pixels with
+// different RGB values produce different hashes.
+uint64_t calculate_image_hash64(const Image* image);
+
 // Sets RGB values to 0 when alpha=0 (to match images with alpha=0
 // in tilesets/calculate_image_hash)
 void preprocess_transparent_pixels(Image* image);
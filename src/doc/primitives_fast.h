@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2023 Igara Studio S.A.
+// Copyright (c) 2023-2026 Igara Studio S.A.
 // Copyright (c) 2001-2015 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -14,6 +14,8 @@
 #include "doc/image_impl.h"
 #include "doc/image_traits.h"
 
+#include <algorithm>
+
 namespace doc {
 
 template<typename ImageTraits>
@@ -46,6 +48,34 @@ inline void put_pixel_fast(Image* image, int x, int y, typename Traits::pixel_t
   *(((ImageImpl<Traits>*)image)->address(x, y)) = color;
 }
 
+// Fills the [x1, x2] horizontal span without bounds checks (use
+// doc::draw_hline() when you need clipping). Loops that paint one
+// scanline per iteration and already know the pixel format can inline
+// this instead of paying a virtual Image::drawHLine() call per row.
+template<class Traits>
+inline void fill_hline_fast(Image* image, int x1, int y, int x2, typename Traits::pixel_t color)
+{
+  ASSERT(x1 >= 0 && x1 <= x2 && x2 < image->width());
+  ASSERT(y >= 0 && y < image->height());
+
+  typename Traits::address_t p = ((ImageImpl<Traits>*)image)->address(x1, y);
+  std::fill(p, p + (x2 - x1 + 1), color);
+}
+
+// Fills the [x1, x2]x[y1, y2] rectangle without bounds checks (use
+// doc::fill_rect() when you need clipping).
+template<class Traits>
+inline void fill_rect_fast(Image* image,
+                           int x1,
+                           int y1,
+                           int x2,
+                           int y2,
+                           typename Traits::pixel_t color)
+{
+  for (int y = y1; y <= y2; ++y)
+    fill_hline_fast<Traits>(image, x1, y, x2, color);
+}
+
 //////////////////////////////////////////////////////////////////////
 // Bitmap specialization
 
@@ -72,6 +102,17 @@ inline void put_pixel_fast<BitmapTraits>(Image* image, int x, int y, BitmapTrait
     *image->getPixelAddress(x, y) &= ~(1 << (x % 8));
 }
 
+template<>
+inline void fill_hline_fast<BitmapTraits>(Image* image,
+                                          int x1,
+                                          int y,
+                                          int x2,
+                                          BitmapTraits::pixel_t color)
+{
+  for (int x = x1; x <= x2; ++x)
+    put_pixel_fast<BitmapTraits>(image, x, y, color);
+}
+
 #endif // DOC_USE_BITMAP_AS_1BPP
 
 } // namespace doc
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2023-2025  Igara Studio S.A.
+// Copyright (c) 2023-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -81,6 +81,64 @@ TYPED_TEST(Primitives, IsSameImage)
   }
 }
 
+TYPED_TEST(Primitives, ContentHash)
+{
+  using ImageTraits = TypeParam;
+
+  ImageRef a(Image::create(ImageTraits::pixel_format, 67, 43));
+  doc::algorithm::random_image(a.get());
+
+  ImageRef b(Image::createCopy(a.get()));
+  EXPECT_EQ(calculate_image_hash64(a.get()), calculate_image_hash64(b.get()));
+  EXPECT_EQ(a->contentHash(), b->contentHash());
+
+  auto old = get_pixel_fast<ImageTraits>(b.get(), 31, 20);
+  put_pixel_fast<ImageTraits>(b.get(), 31, 20, old != 0 ? 0 : 1);
+  EXPECT_NE(calculate_image_hash64(a.get()), calculate_image_hash64(b.get()));
+
+  // The cached hash is refreshed only when the version changes
+  EXPECT_EQ(a->contentHash(), b->contentHash());
+  b->incrementVersion();
+  EXPECT_NE(a->contentHash(), b->contentHash());
+}
+
+TYPED_TEST(Primitives, HLineAndRectSpans)
+{
+  using ImageTraits = TypeParam;
+
+  ImageRef a(Image::create(ImageTraits::pixel_format, 19, 11));
+  clear_image(a.get(), 0);
+
+  // Whole scanline, partial spans, and one-pixel spans
+  draw_hline(a.get(), 0, 0, 18, 1);
+  draw_hline(a.get(), 3, 5, 13, 1);
+  draw_hline(a.get(), 7, 7, 7, 1);
+  fill_rect_fast<ImageTraits>(a.get(), 2, 9, 16, 10, 1);
+
+  for (int v = 0; v < a->height(); ++v)
+    for (int u = 0; u < a->width(); ++u) {
+      const bool inside = (v == 0) || (v == 5 && u >= 3 && u <= 13) || (v == 7 && u == 7) ||
+                          (v >= 9 && u >= 2 && u <= 16);
+      EXPECT_EQ(inside ? 1 : 0, get_pixel_fast<ImageTraits>(a.get(), u, v))
+        << " in (" << u << ", " << v << ")";
+    }
+}
+
+TEST(PreprocessTransparentPixels, InvalidatesContentHash)
+{
+  ImageRef a(Image::create(IMAGE_RGB, 8, 8));
+  clear_image(a.get(), rgba(255, 0, 0, 0)); // Transparent pixels with garbage RGB
+
+  const uint64_t hash1 = a->contentHash();
+  preprocess_transparent_pixels(a.get()); // Sets RGB=0 when alpha=0
+  EXPECT_NE(hash1, a->contentHash());
+
+  // An already preprocessed image keeps its cached hash valid
+  const uint64_t hash2 = a->contentHash();
+  preprocess_transparent_pixels(a.get());
+  EXPECT_EQ(hash2, a->contentHash());
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2023  Igara Studio S.A.
+// Copyright (c) 2023-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -15,9 +15,42 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace doc {
 
+namespace {
+
+// Memoization of the z-index resolution: playback of a sprite that
+// animates z-indexes resolves the same (layer, z-index) sequence once
+// per frame of the loop, so instead of re-sorting the layer list on
+// every render we keep the resulting permutation keyed by a hash of
+// the input sequence (layer/cel ids + orders + z-indexes, so any
+// layer or z-index change produces a different key).
+std::mutex g_zIndexCacheMutex;
+std::unordered_map<uint64_t, std::vector<uint32_t>> g_zIndexCache;
+
+uint64_t z_index_cache_key(const RenderPlan::Items& items)
+{
+  auto combine = [](const uint64_t h, const uint64_t v) {
+    return (h ^ v) * uint64_t(1099511628211ull); // FNV-1a style mixing
+  };
+
+  uint64_t key = uint64_t(14695981039346656037ull);
+  key = combine(key, items.size());
+  for (const auto& item : items) {
+    key = combine(key, item.layer ? item.layer->id() : 0);
+    key = combine(key, item.cel ? item.cel->id() : 0);
+    key = combine(key, uint64_t(uint32_t(item.order)) | (uint64_t(uint32_t(item.zIndex())) << 32));
+  }
+  return key;
+}
+
+} // anonymous namespace
+
 RenderPlan::RenderPlan()
 {
 }
@@ -34,6 +67,13 @@ void RenderPlan::addLayer(const Layer* layer, const frame_t frame)
   if (!layer->isVisible())
     return;
 
+  // Cull the whole group (and its sublayers) if its content cannot
+  // touch the area being rendered.
+  if (layer->isGroup() && !m_clipBounds.isEmpty() &&
+      !static_cast<const LayerGroup*>(layer)->contentBounds(frame).intersects(m_clipBounds)) {
+    return;
+  }
+
   if (layer->isGroup() && !m_composeGroups) {
     for (auto* const child : static_cast<const LayerGroup*>(layer)->layers()) {
       addLayer(child, frame);
@@ -63,9 +103,46 @@ void RenderPlan::processZIndexes() const
   // Order cels using its "order" number in m_items array + cel z-index offset
   for (Item& item : m_items)
     item.order = item.order + item.zIndex();
-  std::sort(m_items.begin(), m_items.end(), [](const Item& a, const Item& b) {
-    return (a.order < b.order) || (a.order == b.order && (a.zIndex() < b.zIndex()));
-  });
+
+  const uint64_t key = z_index_cache_key(m_items);
+  std::vector<uint32_t> perm;
+  {
+    const std::lock_guard<std::mutex> lock(g_zIndexCacheMutex);
+    auto it = g_zIndexCache.find(key);
+    if (it != g_zIndexCache.end() && it->second.size() == m_items.size())
+      perm = it->second;
+  }
+
+  if (perm.empty()) {
+    // Sort a permutation of indexes (with the index itself as final
+    // tie-breaker so the result is deterministic and cacheable)
+    // instead of the items directly, so the result can be reused the
+    // next time the same sequence has to be resolved.
+    perm.resize(m_items.size());
+    for (uint32_t i = 0; i < uint32_t(perm.size()); ++i)
+      perm[i] = i;
+    std::sort(perm.begin(), perm.end(), [this](const uint32_t ai, const uint32_t bi) {
+      const Item& a = m_items[ai];
+      const Item& b = m_items[bi];
+      if (a.order != b.order)
+        return a.order < b.order;
+      if (a.zIndex() != b.zIndex())
+        return a.zIndex() < b.zIndex();
+      return ai < bi;
+    });
+
+    const std::lock_guard<std::mutex> lock(g_zIndexCacheMutex);
+    // Don't let closed sprites/old animations grow the cache forever.
+    if (g_zIndexCache.size() > 1024)
+      g_zIndexCache.clear();
+    g_zIndexCache[key] = perm;
+  }
+
+  Items sorted;
+  sorted.reserve(m_items.size());
+  for (const uint32_t i : perm)
+    sorted.push_back(m_items[i]);
+  m_items.swap(sorted);
 }
 
 } // namespace doc
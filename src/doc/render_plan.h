@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (c) 2023  Igara Studio S.A.
+// Copyright (c) 2023-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -11,6 +11,7 @@
 #include "doc/cel.h"
 #include "doc/cel_list.h"
 #include "doc/frame.h"
+#include "gfx/rect.h"
 
 namespace doc {
 class Layer;
@@ -46,6 +47,13 @@ public:
 
   void addLayer(const Layer* layer, const frame_t frame);
 
+  // Area of the sprite canvas that will be rendered with this plan:
+  // groups whose cached content bounds (LayerGroup::contentBounds())
+  // don't touch it are skipped entirely, so rendering a small dirty
+  // rectangle doesn't have to visit deeply nested layer hierarchies.
+  // Must be set before addLayer().
+  void setClipBounds(const gfx::Rect& clip) { m_clipBounds = clip; }
+
 private:
   void processZIndexes() const;
 
@@ -53,6 +61,7 @@ private:
   mutable Items m_items;
   mutable bool m_processZIndex = true;
   bool m_composeGroups = false;
+  gfx::Rect m_clipBounds;
 };
 
 } // namespace doc
@@ -1,4 +1,5 @@
 // Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,11 +13,96 @@
 
 #include "base/debug.h"
 #include "doc/slice.h"
+#include "gfx/rect.h"
 
 #include <algorithm>
+#include <memory>
 
 namespace doc {
 
+// Uniform grid with the slice keys of one frame, used to answer
+// findInRect() queries without walking the whole slice list.
+class SlicesIndex {
+  // Grid cell size in canvas pixels (a trade-off between the number
+  // of buckets and the number of slices per bucket).
+  static const int kCellSize = 64;
+
+  struct Entry {
+    Slice* slice;
+    gfx::Rect bounds;
+  };
+
+public:
+  SlicesIndex(const Slices& slices, const frame_t frame) : m_frame(frame)
+  {
+    for (Slice* slice : slices) {
+      const SliceKey* key = slice->getByFrame(frame);
+      if (!key || key->isEmpty())
+        continue;
+
+      m_bounds |= key->bounds();
+      m_entries.push_back(Entry{ slice, key->bounds() });
+    }
+
+    m_cols = std::max(1, (m_bounds.w + kCellSize - 1) / kCellSize);
+    m_rows = std::max(1, (m_bounds.h + kCellSize - 1) / kCellSize);
+    m_cells.resize(m_cols * m_rows);
+
+    for (std::size_t i = 0; i < m_entries.size(); ++i) {
+      int u0, v0, u1, v1;
+      getCellsRange(m_entries[i].bounds, u0, v0, u1, v1);
+      for (int v = v0; v <= v1; ++v)
+        for (int u = u0; u <= u1; ++u)
+          m_cells[v * m_cols + u].push_back(uint32_t(i));
+    }
+  }
+
+  frame_t frame() const { return m_frame; }
+
+  void query(const gfx::Rect& rc, std::vector<Slice*>& result) const
+  {
+    if (m_entries.empty() || !m_bounds.intersects(rc))
+      return;
+
+    m_candidates.clear();
+
+    int u0, v0, u1, v1;
+    getCellsRange(rc, u0, v0, u1, v1);
+    for (int v = v0; v <= v1; ++v)
+      for (int u = u0; u <= u1; ++u) {
+        const std::vector<uint32_t>& cell = m_cells[v * m_cols + u];
+        m_candidates.insert(m_candidates.end(), cell.begin(), cell.end());
+      }
+
+    // Sort candidates (entries are in the same order of the slices
+    // list) and remove the duplicated ones from adjacent cells.
+    std::sort(m_candidates.begin(), m_candidates.end());
+    m_candidates.erase(std::unique(m_candidates.begin(), m_candidates.end()), m_candidates.end());
+
+    for (uint32_t i : m_candidates) {
+      if (m_entries[i].bounds.intersects(rc))
+        result.push_back(m_entries[i].slice);
+    }
+  }
+
+private:
+  void getCellsRange(const gfx::Rect& rc, int& u0, int& v0, int& u1, int& v1) const
+  {
+    u0 = std::clamp((rc.x - m_bounds.x) / kCellSize, 0, m_cols - 1);
+    v0 = std::clamp((rc.y - m_bounds.y) / kCellSize, 0, m_rows - 1);
+    u1 = std::clamp((rc.x2() - 1 - m_bounds.x) / kCellSize, 0, m_cols - 1);
+    v1 = std::clamp((rc.y2() - 1 - m_bounds.y) / kCellSize, 0, m_rows - 1);
+  }
+
+  frame_t m_frame;
+  gfx::Rect m_bounds;
+  int m_cols = 1;
+  int m_rows = 1;
+  std::vector<std::vector<uint32_t>> m_cells;
+  std::vector<Entry> m_entries;
+  mutable std::vector<uint32_t> m_candidates;
+};
+
 Slices::Slices(Sprite* sprite) : m_sprite(sprite)
 {
 }
@@ -36,6 +122,7 @@ void Slices::add(Slice* slice)
   // user can drag the new slices instead of the originally selected ones.
   m_slices.insert(m_slices.begin(), slice);
   slice->setOwner(this);
+  invalidateIndex();
 }
 
 void Slices::remove(Slice* slice)
@@ -46,6 +133,7 @@ void Slices::remove(Slice* slice)
     m_slices.erase(it);
 
   slice->setOwner(nullptr);
+  invalidateIndex();
 }
 
 Slice* Slices::getByName(const std::string& name) const
@@ -66,4 +154,17 @@ Slice* Slices::getById(ObjectId id) const
   return nullptr;
 }
 
+void Slices::findInRect(const frame_t frame, const gfx::Rect& rc, std::vector<Slice*>& result) const
+{
+  if (!m_index || m_index->frame() != frame)
+    m_index = std::make_unique<SlicesIndex>(*this, frame);
+
+  m_index->query(rc, result);
+}
+
+void Slices::invalidateIndex()
+{
+  m_index.reset();
+}
+
 } // namespace doc
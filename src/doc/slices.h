@@ -1,4 +1,5 @@
 // Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,14 +10,18 @@
 #pragma once
 
 #include "base/disable_copying.h"
+#include "doc/frame.h"
 #include "doc/object_id.h"
+#include "gfx/fwd.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace doc {
 
 class Slice;
+class SlicesIndex;
 class Sprite;
 
 class Slices {
@@ -37,6 +42,19 @@ public:
   Slice* getByName(const std::string& name) const;
   Slice* getById(const ObjectId id) const;
 
+  // Adds to "result" the slices (in the same order of this list, so
+  // the hit-testing priority is kept) with a key in the given frame
+  // whose bounds intersect the given rectangle. Uses a spatial index
+  // over the slice keys of the frame, so queries don't walk the
+  // whole list (documents from auto-slicers can contain thousands of
+  // slices).
+  void findInRect(const frame_t frame, const gfx::Rect& rc, std::vector<Slice*>& result) const;
+
+  // Discards the spatial index used by findInRect(). Called
+  // automatically when slices are added/removed or their keys
+  // change.
+  void invalidateIndex();
+
   iterator begin() { return m_slices.begin(); }
   iterator end() { return m_slices.end(); }
   const_iterator begin() const { return m_slices.begin(); }
@@ -48,6 +66,9 @@ public:
 private:
   Sprite* m_sprite;
   List m_slices;
+  // Spatial index for findInRect(), created on-demand for the last
+  // queried frame.
+  mutable std::unique_ptr<SlicesIndex> m_index;
 
   DISABLE_COPYING(Slices);
 };
@@ -0,0 +1,90 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "doc/slice.h"
+#include "doc/slices.h"
+
+using namespace doc;
+
+TEST(Slices, FindInRect)
+{
+  Slices slices(nullptr);
+
+  auto* a = new Slice;
+  a->setName("a");
+  a->insert(0, SliceKey(gfx::Rect(0, 0, 16, 16)));
+  slices.add(a);
+
+  auto* b = new Slice;
+  b->setName("b");
+  b->insert(0, SliceKey(gfx::Rect(100, 100, 16, 16)));
+  // "b" exists in frame 2 with other bounds
+  b->insert(2, SliceKey(gfx::Rect(0, 0, 8, 8)));
+  slices.add(b);
+
+  std::vector<Slice*> result;
+  slices.findInRect(0, gfx::Rect(4, 4, 1, 1), result);
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ(a, result[0]);
+
+  result.clear();
+  slices.findInRect(0, gfx::Rect(0, 0, 128, 128), result);
+  ASSERT_EQ(2, result.size());
+  // Slices::add() inserts at the beginning of the list and the
+  // results keep the list order.
+  EXPECT_EQ(b, result[0]);
+  EXPECT_EQ(a, result[1]);
+
+  result.clear();
+  slices.findInRect(0, gfx::Rect(32, 32, 8, 8), result);
+  EXPECT_TRUE(result.empty());
+
+  // In frame 2 "b" moved over "a"
+  result.clear();
+  slices.findInRect(2, gfx::Rect(4, 4, 1, 1), result);
+  ASSERT_EQ(2, result.size());
+  EXPECT_EQ(b, result[0]);
+  EXPECT_EQ(a, result[1]);
+}
+
+TEST(Slices, FindInRectAfterChanges)
+{
+  Slices slices(nullptr);
+
+  auto* a = new Slice;
+  a->insert(0, SliceKey(gfx::Rect(0, 0, 16, 16)));
+  slices.add(a);
+
+  std::vector<Slice*> result;
+  slices.findInRect(0, gfx::Rect(40, 40, 1, 1), result);
+  EXPECT_TRUE(result.empty());
+
+  // Changing a key must invalidate the index used by findInRect()
+  a->insert(0, SliceKey(gfx::Rect(32, 32, 16, 16)));
+  slices.findInRect(0, gfx::Rect(40, 40, 1, 1), result);
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ(a, result[0]);
+
+  // Removing the slice too
+  slices.remove(a);
+  result.clear();
+  slices.findInRect(0, gfx::Rect(40, 40, 1, 1), result);
+  EXPECT_TRUE(result.empty());
+
+  delete a;
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
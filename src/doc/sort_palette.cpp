@@ -1,4 +1,5 @@
 // Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
 // Copyright (c) 2001-2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -18,179 +19,120 @@
 
 #include "doc/image.h"
 #include "doc/palette.h"
+#include "doc/palette_planes.h"
 #include "doc/remap.h"
-#include "gfx/hsv.h"
-#include "gfx/rgb.h"
 
 #include <algorithm>
-#include <limits>
+#include <vector>
 
 namespace doc {
 
-using namespace gfx;
-
 namespace {
 
-struct PalEntryWithIndex {
+// Sort keys precomputed per palette entry (from the palette SoA
+// planes), so std::stable_sort() compares two integers instead of
+// unpacking/converting the entry colors on each comparison. The
+// secondary key breaks ties the same way the old per-comparison
+// predicate did (e.g. saturation sorts fall back to value).
+struct PalEntryKeys {
   int index;
-  color_t color;
+  int32_t key1, key2;
+  bool transparent;
 };
 
-struct PalEntryWithIndexPredicate {
-  SortPaletteBy channel;
+struct PalEntryKeysPredicate {
   bool ascending;
 
-  PalEntryWithIndexPredicate(SortPaletteBy channel, bool ascending)
-    : channel(channel)
-    , ascending(ascending)
+  explicit PalEntryKeysPredicate(bool ascending) : ascending(ascending) {}
+
+  bool operator()(const PalEntryKeys& a, const PalEntryKeys& b) const
   {
+    // Handle cases where, e.g., transparent yellow is visually
+    // indistinguishable from transparent black. Push 0 alpha toward
+    // index 0, regardless of sort order being ascending or
+    // descending (the stable sort keeps the original order between
+    // transparent entries).
+    if (a.transparent || b.transparent)
+      return (a.transparent && !b.transparent);
+
+    if (a.key1 != b.key1)
+      return (ascending ? a.key1 < b.key1 : b.key1 < a.key1);
+    if (a.key2 != b.key2)
+      return (ascending ? a.key2 < b.key2 : b.key2 < a.key2);
+    return false;
   }
+};
 
-  bool operator()(const PalEntryWithIndex& a, const PalEntryWithIndex& b)
-  {
-    const color_t c1 = a.color;
-    const color_t c2 = b.color;
-
-    // Handle cases where, e.g., transparent yellow
-    // is visually indistinguishable from transparent
-    // black. Push 0 alpha toward index 0, regardless
-    // of sort order being ascending or descending.
-    const uint8_t a1 = rgba_geta(c1);
-    const uint8_t a2 = rgba_geta(c2);
-
-    if (a1 == 0 && a2 == 0) {
-      return true;
-    }
-    else if (a1 == 0) {
-      return true;
-    }
-    else if (a2 == 0) {
-      return false;
-    }
+} // anonymous namespace
 
-    const uint8_t r1 = rgba_getr(c1);
-    const uint8_t g1 = rgba_getg(c1);
-    const uint8_t b1 = rgba_getb(c1);
+Remap sort_palette(const Palette* palette, const SortPaletteBy channel, const bool ascending)
+{
+  const auto planes = palette->planes();
+  const int n = planes->size();
 
-    const uint8_t r2 = rgba_getr(c2);
-    const uint8_t g2 = rgba_getg(c2);
-    const uint8_t b2 = rgba_getb(c2);
+  std::vector<PalEntryKeys> tmp(n);
+  for (int i = 0; i < n; ++i) {
+    PalEntryKeys& e = tmp[i];
+    e.index = i;
+    e.transparent = (planes->a()[i] == 0);
+    e.key2 = 0;
 
     switch (channel) {
-      case SortPaletteBy::RED:   return (ascending ? r1 < r2 : r2 < r1);
+      case SortPaletteBy::RED:   e.key1 = planes->r()[i]; break;
 
-      case SortPaletteBy::GREEN: return (ascending ? g1 < g2 : g2 < g1);
+      case SortPaletteBy::GREEN: e.key1 = planes->g()[i]; break;
 
-      case SortPaletteBy::BLUE:  return (ascending ? b1 < b2 : b2 < b1);
+      case SortPaletteBy::BLUE:  e.key1 = planes->b()[i]; break;
 
-      case SortPaletteBy::ALPHA: return (ascending ? a1 < a2 : a2 < a1);
+      case SortPaletteBy::ALPHA: e.key1 = planes->a()[i]; break;
 
-      case SortPaletteBy::HUE:   {
-        const Hsv hsv1(Rgb(r1, g1, b1));
-        const Hsv hsv2(Rgb(r2, g2, b2));
-
-        // When a color is desaturated, its hue
-        // is the quotient of division by zero.
-        // It is not zero, which is red.
-        const int sat1 = hsv1.saturationInt();
-        const int sat2 = hsv2.saturationInt();
-
-        if (sat1 == 0 && sat2 == 0) {
-          const int val1 = hsv1.valueInt();
-          const int val2 = hsv2.valueInt();
-          return (ascending ? val1 < val2 : val2 < val1);
-        }
-        else if (sat1 == 0) {
-          return ascending;
+      case SortPaletteBy::HUE:
+        // When a color is desaturated, its hue is the quotient of
+        // division by zero. It is not zero, which is red. Desaturated
+        // entries are sorted apart by value, before every hue.
+        if (planes->saturation()[i] == 0) {
+          e.key1 = -1;
+          e.key2 = planes->value()[i];
         }
-        else if (sat2 == 0) {
-          return !ascending;
+        else {
+          e.key1 = planes->hue()[i];
         }
-
-        const int hue1 = hsv1.hueInt();
-        const int hue2 = hsv2.hueInt();
-        return (ascending ? hue1 < hue2 : hue2 < hue1);
-      }
-
-      case SortPaletteBy::SATURATION: {
-        // This could be inlined with
-        // (max(r, g, b) - min(r, g, b)) / max(r, g, b)
-        // but (1.) there is already opportunity for
-        // confusion: HSV and HSL saturation share
-        // the same name but arise from different
-        // calculations; (2.) HSV components can
-        // almost never be compared in isolation.
-        const Hsv hsv1(Rgb(r1, g1, b1));
-        const Hsv hsv2(Rgb(r2, g2, b2));
-        const int sat1 = hsv1.saturationInt();
-        const int sat2 = hsv2.saturationInt();
-        if (sat1 == sat2) {
-          const int val1 = hsv1.valueInt();
-          const int val2 = hsv2.valueInt();
-          return (ascending ? val1 < val2 : val2 < val1);
-        }
-        return (ascending ? sat1 < sat2 : sat2 < sat1);
-      }
-
-      case SortPaletteBy::VALUE: {
-        const Hsv hsv1(Rgb(r1, g1, b1));
-        const Hsv hsv2(Rgb(r2, g2, b2));
-        const int val1 = hsv1.valueInt();
-        const int val2 = hsv2.valueInt();
-        if (val1 == val2) {
-          const int sat1 = hsv1.saturationInt();
-          const int sat2 = hsv2.saturationInt();
-          return (ascending ? sat1 < sat2 : sat2 < sat1);
-        }
-        return (ascending ? val1 < val2 : val2 < val1);
-      }
-
-      case SortPaletteBy::LUMA: {
-        // Perceptual, or relative, luminance.
-        // Finds the square for fast approximation
-        // of 2.4 or 2.2 exponent needed to convert
-        // from gamma to linear. Assumes that the
-        // source for palette colors is sRGB.
-        const int lum1 = rgb_luma(r1 * r1, g1 * g1, b1 * b1);
-        const int lum2 = rgb_luma(r2 * r2, g2 * g2, b2 * b2);
-        return (ascending ? lum1 < lum2 : lum2 < lum1);
-      }
-
-      case SortPaletteBy::LIGHTNESS: {
+        break;
+
+      case SortPaletteBy::SATURATION:
+        // HSV components can almost never be compared in isolation:
+        // ties are broken with the value component.
+        e.key1 = planes->saturation()[i];
+        e.key2 = planes->value()[i];
+        break;
+
+      case SortPaletteBy::VALUE:
+        e.key1 = planes->value()[i];
+        e.key2 = planes->saturation()[i];
+        break;
+
+      case SortPaletteBy::LUMA:
+        // Perceptual, or relative, luminance (see
+        // PalettePlanes::luma()).
+        e.key1 = planes->luma()[i];
+        break;
+
+      case SortPaletteBy::LIGHTNESS:
         // HSL Lightness
-        const int mn1 = std::min(r1, std::min(g1, b1));
-        const int mx1 = std::max(r1, std::max(g1, b1));
-        const int light1 = (mn1 + mx1) / 2;
+        e.key1 = planes->lightness()[i];
+        break;
 
-        const int mn2 = std::min(r2, std::min(g2, b2));
-        const int mx2 = std::max(r2, std::max(g2, b2));
-        const int light2 = (mn2 + mx2) / 2;
-
-        return (ascending ? light1 < light2 : light2 < light1);
-      }
-
-      default: {
+      default:
         ASSERT(false);
-        return false;
-      }
+        e.key1 = 0;
+        break;
     }
   }
-};
-
-} // anonymous namespace
-
-Remap sort_palette(const Palette* palette, const SortPaletteBy channel, const bool ascending)
-{
-  std::vector<PalEntryWithIndex> tmp(palette->size());
-  for (int i = 0; i < palette->size(); ++i) {
-    tmp[i].index = i;
-    tmp[i].color = palette->getEntry(i);
-  }
 
-  std::stable_sort(tmp.begin(), tmp.end(), PalEntryWithIndexPredicate(channel, ascending));
+  std::stable_sort(tmp.begin(), tmp.end(), PalEntryKeysPredicate(ascending));
 
   Remap remap(palette->size());
-  for (int i = 0; i < palette->size(); ++i)
+  for (int i = 0; i < n; ++i)
     remap.map(tmp[i].index, i);
 
   return remap;
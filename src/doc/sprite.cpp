@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (C) 2018-2024  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -29,9 +29,13 @@
 #include "doc/tilesets.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <functional>
 #include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace doc {
@@ -323,6 +327,19 @@ bool Sprite::hasVisibleReferenceLayers() const
   return root()->hasVisibleReferenceLayers();
 }
 
+layer_t Sprite::layerIndex(const Layer* layer) const
+{
+  if (m_layerIndexes.empty()) {
+    const LayerList layers = allLayers();
+    m_layerIndexes.reserve(layers.size());
+    for (layer_t i = 0; i < layer_t(layers.size()); ++i)
+      m_layerIndexes[layers[i]] = i;
+  }
+
+  const auto it = m_layerIndexes.find(layer);
+  return (it != m_layerIndexes.end() ? it->second : -1);
+}
+
 //////////////////////////////////////////////////////////////////////
 // Palettes
 
@@ -631,6 +648,60 @@ void Sprite::getTilemapsByTileset(const Tileset* tileset, std::vector<ImageRef>&
   }
 }
 
+void Sprite::getDuplicatedCels(std::vector<CelList>& groups) const
+{
+  for (Layer* layer : allLayers()) {
+    if (!layer->isImage())
+      continue;
+
+    CelList cels;
+    layer->getCels(cels);
+
+    // Keep one representative cel per CelData (linked cels already
+    // share their image buffer) and bucket them by content hash.
+    std::unordered_set<ObjectId> seenData;
+    std::unordered_map<uint32_t, CelList> byHash;
+    for (Cel* cel : cels) {
+      if (!seenData.insert(cel->dataRef()->id()).second)
+        continue;
+
+      const uint32_t hash = calculate_image_hash(cel->image(), cel->image()->bounds());
+      byHash[hash].push_back(cel);
+    }
+
+    for (auto& it : byHash) {
+      CelList& candidates = it.second;
+      if (candidates.size() < 2)
+        continue;
+
+      // Split each bucket in groups of really equal cels (linking
+      // cels shares the whole CelData, so position and opacity must
+      // match too, not just the pixels).
+      std::vector<bool> grouped(candidates.size(), false);
+      for (std::size_t i = 0; i < candidates.size(); ++i) {
+        if (grouped[i])
+          continue;
+
+        CelList group;
+        group.push_back(candidates[i]);
+        for (std::size_t j = i + 1; j < candidates.size(); ++j) {
+          if (grouped[j])
+            continue;
+
+          if (candidates[i]->position() == candidates[j]->position() &&
+              candidates[i]->opacity() == candidates[j]->opacity() &&
+              is_same_image(candidates[i]->image(), candidates[j]->image())) {
+            group.push_back(candidates[j]);
+            grouped[j] = true;
+          }
+        }
+        if (group.size() > 1)
+          groups.push_back(std::move(group));
+      }
+    }
+  }
+}
+
 void Sprite::remapImages(const Remap& remap)
 {
   ASSERT(pixelFormat() == IMAGE_INDEXED);
@@ -638,8 +709,31 @@ void Sprite::remapImages(const Remap& remap)
 
   std::vector<ImageRef> images;
   getImages(images);
-  for (ImageRef& image : images)
-    remap_image(image.get(), remap);
+
+  // Palette reordering rewrites every indexed cel and tileset image
+  // of the sprite. The images are independent, so on long animations
+  // they are remapped in parallel; an atomic cursor balances the work
+  // because image sizes vary wildly (empty cels vs. full frames).
+  const int nthreads = std::clamp<int>(std::thread::hardware_concurrency(), 1, int(images.size()));
+  if (nthreads > 1) {
+    std::atomic<size_t> next(0);
+    auto worker = [&images, &remap, &next] {
+      size_t i;
+      while ((i = next++) < images.size())
+        remap_image(images[i].get(), remap);
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < nthreads; ++i)
+      threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+      thread.join();
+  }
+  else {
+    for (ImageRef& image : images)
+      remap_image(image.get(), remap);
+  }
 }
 
 void Sprite::remapTilemaps(const Tileset* tileset, const Remap& remap)
@@ -712,6 +806,61 @@ void Sprite::pickCels(const gfx::PointF& pos,
   }
 }
 
+//////////////////////////////////////////////////////////////////////
+// Render invalidation keys
+
+static void mix_version_key(uint64_t& hash, const uint64_t value)
+{
+  // FNV-1a over the 8 bytes of the value
+  for (int i = 0; i < 8; ++i) {
+    hash ^= (value >> (8 * i)) & 0xff;
+    hash *= 0x100000001b3ull;
+  }
+}
+
+static void mix_layer_version_key(uint64_t& hash, const Layer* layer, const frame_t frame)
+{
+  mix_version_key(hash, layer->id());
+  mix_version_key(hash, layer->version());
+
+  if (layer->isImage()) {
+    if (const Cel* cel = layer->cel(frame)) {
+      mix_version_key(hash, cel->version());
+      mix_version_key(hash, cel->data()->version());
+      mix_version_key(hash, cel->image()->id());
+      mix_version_key(hash, cel->image()->version());
+    }
+    if (layer->isTilemap()) {
+      if (const Tileset* tileset = static_cast<const LayerTilemap*>(layer)->tileset())
+        mix_version_key(hash, tileset->version());
+    }
+  }
+  else if (layer->isGroup()) {
+    for (const Layer* child : static_cast<const LayerGroup*>(layer)->layers())
+      mix_layer_version_key(hash, child, frame);
+  }
+}
+
+uint64_t Sprite::renderVersionKey(const Layer* layer, frame_t frame) const
+{
+  uint64_t hash = 0xcbf29ce484222325ull; // FNV-1a offset basis
+  mix_layer_version_key(hash, layer, frame);
+  return (hash != 0 ? hash : 1);
+}
+
+uint64_t Sprite::renderVersionKey(frame_t frame) const
+{
+  uint64_t hash = 0xcbf29ce484222325ull;
+  mix_version_key(hash, version());
+  mix_layer_version_key(hash, m_root, frame);
+
+  if (const Palette* pal = palette(frame)) {
+    mix_version_key(hash, pal->id());
+    mix_version_key(hash, pal->getModifications());
+  }
+  return (hash != 0 ? hash : 1);
+}
+
 //////////////////////////////////////////////////////////////////////
 // Iterators
 
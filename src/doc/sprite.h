@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -29,8 +29,10 @@
 #include "doc/with_user_data.h"
 #include "gfx/rect.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #define DOC_SPRITE_MAX_WIDTH  65535
@@ -148,6 +150,18 @@ public:
   layer_t allLayersCount() const;
   bool hasVisibleReferenceLayers() const;
 
+  // Returns the position of the given layer in the allLayers() order
+  // (pre-order of the whole hierarchy), or -1 if the layer is not in
+  // this sprite. The indexes are cached and rebuilt only when the
+  // layer hierarchy changes, so interactive code (timeline painting,
+  // range ops while dragging) can compare layer positions in O(1)
+  // instead of searching linearly in a LayerList.
+  layer_t layerIndex(const Layer* layer) const;
+
+  // Discards the cached layerIndex() map (called from LayerGroup
+  // when layers are added/removed/moved).
+  void invalidateLayerIndexes() { m_layerIndexes.clear(); }
+
   ////////////////////////////////////////
   // Palettes
 
@@ -209,6 +223,12 @@ public:
   // TODO replace this with a co-routine when we start using C++20 (std::generator<ImageRef>)
   void getTilemapsByTileset(const Tileset* tileset, std::vector<ImageRef>& images) const;
 
+  // Groups cels of the same layer with identical content (same image
+  // pixels, position, and opacity), i.e. candidates to be converted
+  // into linked cels sharing one image buffer/CelData. Each returned
+  // group contains at least two cels that don't share data yet.
+  void getDuplicatedCels(std::vector<CelList>& groups) const;
+
   void remapImages(const Remap& remap);
   void remapTilemaps(const Tileset* tileset, const Remap& remap);
   void pickCels(const gfx::PointF& pos,
@@ -216,6 +236,24 @@ public:
                 const RenderPlan& plan,
                 CelList& cels) const;
 
+  ////////////////////////////////////////
+  // Render invalidation keys
+
+  // Returns a key that aggregates the version of every object
+  // (doc::Object::version()) that affects the composited output of
+  // the given layer (and its children) in the given frame: the layer
+  // flags/opacity/blend mode, the cel z-index, position and opacity,
+  // the cel image pixels and, for tilemaps, the tileset. Two equal
+  // keys mean the rendered output didn't change, so render caches
+  // (thumbnails, overviews, onion skin) can compare keys cheaply
+  // instead of invalidating on every document change. Never returns 0
+  // (a 0 can be used as the "nothing cached yet" value).
+  uint64_t renderVersionKey(const Layer* layer, frame_t frame) const;
+
+  // Aggregate for the whole frame (all the layers bottom-up), also
+  // mixing the sprite version and the frame palette.
+  uint64_t renderVersionKey(frame_t frame) const;
+
   ////////////////////////////////////////
   // Iterators
 
@@ -257,6 +295,9 @@ private:
   LayerGroup* m_root;        // main group of layers
   gfx::Rect m_gridBounds;    // grid settings
 
+  // Cached layer -> allLayers() position map (see layerIndex())
+  mutable std::unordered_map<const Layer*, layer_t> m_layerIndexes;
+
   // Current rgb map
   mutable std::unique_ptr<RgbMap> m_rgbMap;
 
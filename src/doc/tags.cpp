@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -40,6 +40,7 @@ void Tags::add(Tag* tag)
   }
   m_tags.insert(it, tag);
   tag->setOwner(this);
+  m_frameIndexValid = false;
 }
 
 void Tags::remove(Tag* tag)
@@ -50,6 +51,7 @@ void Tags::remove(Tag* tag)
     m_tags.erase(it);
 
   tag->setOwner(nullptr);
+  m_frameIndexValid = false;
 }
 
 Tag* Tags::getByName(const std::string& name) const
@@ -71,6 +73,34 @@ Tag* Tags::getById(ObjectId id) const
 }
 
 Tag* Tags::innerTag(const frame_t frame) const
+{
+  if (!m_frameIndexValid)
+    rebuildFrameIndex();
+
+  const auto it = std::upper_bound(m_frameIndex.begin(),
+                                   m_frameIndex.end(),
+                                   frame,
+                                   [](const frame_t frame, const FrameIndexEntry& entry) {
+                                     return frame < entry.fromFrame;
+                                   });
+  return (it != m_frameIndex.begin() ? (it - 1)->inner : nullptr);
+}
+
+Tag* Tags::outerTag(const frame_t frame) const
+{
+  if (!m_frameIndexValid)
+    rebuildFrameIndex();
+
+  const auto it = std::upper_bound(m_frameIndex.begin(),
+                                   m_frameIndex.end(),
+                                   frame,
+                                   [](const frame_t frame, const FrameIndexEntry& entry) {
+                                     return frame < entry.fromFrame;
+                                   });
+  return (it != m_frameIndex.begin() ? (it - 1)->outer : nullptr);
+}
+
+Tag* Tags::innerTagScan(const frame_t frame) const
 {
   const Tag* found = nullptr;
   for (const Tag* tag : *this) {
@@ -83,7 +113,7 @@ Tag* Tags::innerTag(const frame_t frame) const
   return const_cast<Tag*>(found);
 }
 
-Tag* Tags::outerTag(const frame_t frame) const
+Tag* Tags::outerTagScan(const frame_t frame) const
 {
   const Tag* found = nullptr;
   for (const Tag* tag : *this) {
@@ -96,4 +126,35 @@ Tag* Tags::outerTag(const frame_t frame) const
   return const_cast<Tag*>(found);
 }
 
+// Rebuilds the frame index used by innerTag()/outerTag(): the tag
+// boundaries split the timeline in at most 2n+1 elementary ranges
+// where the inner/outer tags cannot change, so we resolve each range
+// once here (with the same linear scans used before, to keep the
+// exact tie-breaking behavior between same-length tags) and then each
+// query is just a binary search over the ranges.
+void Tags::rebuildFrameIndex() const
+{
+  m_frameIndex.clear();
+
+  std::vector<frame_t> bounds;
+  bounds.reserve(2 * m_tags.size());
+  for (const Tag* tag : *this) {
+    bounds.push_back(tag->fromFrame());
+    bounds.push_back(tag->toFrame() + 1);
+  }
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+  m_frameIndex.reserve(bounds.size());
+  for (const frame_t fromFrame : bounds) {
+    FrameIndexEntry entry;
+    entry.fromFrame = fromFrame;
+    entry.inner = innerTagScan(fromFrame);
+    entry.outer = outerTagScan(fromFrame);
+    m_frameIndex.push_back(entry);
+  }
+
+  m_frameIndexValid = true;
+}
+
 } // namespace doc
@@ -1,5 +1,5 @@
 // Aseprite Document Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -53,9 +53,29 @@ public:
   const TagsList& getInternalList() const { return m_tags; }
 
 private:
+  // One entry per elementary frame range of the tag boundaries, with
+  // the inner/outer tags resolved for that whole range (see
+  // rebuildFrameIndex()).
+  struct FrameIndexEntry {
+    frame_t fromFrame;
+    Tag* inner;
+    Tag* outer;
+  };
+
+  Tag* innerTagScan(const frame_t frame) const;
+  Tag* outerTagScan(const frame_t frame) const;
+  void rebuildFrameIndex() const;
+
   Sprite* m_sprite;
   TagsList m_tags;
 
+  // Lazily-built index to resolve innerTag()/outerTag() with a binary
+  // search instead of scanning all tags per query (these queries run
+  // per-frame during playback). Invalidated on add()/remove(), which
+  // every tag range edit goes through (Tag::setFrameRange()).
+  mutable std::vector<FrameIndexEntry> m_frameIndex;
+  mutable bool m_frameIndexValid = false;
+
   DISABLE_COPYING(Tags);
 };
 
@@ -0,0 +1,97 @@
+// Aseprite Document Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "doc/tag.h"
+#include "doc/tags.h"
+
+using namespace doc;
+
+TEST(Tags, InnerOuterTag)
+{
+  Tags tags(nullptr);
+
+  auto* a = new Tag(0, 9); // Covers everything
+  a->setName("a");
+  tags.add(a);
+
+  auto* b = new Tag(2, 5);
+  b->setName("b");
+  tags.add(b);
+
+  auto* c = new Tag(3, 4);
+  c->setName("c");
+  tags.add(c);
+
+  EXPECT_EQ(a, tags.innerTag(0));
+  EXPECT_EQ(b, tags.innerTag(2));
+  EXPECT_EQ(c, tags.innerTag(3));
+  EXPECT_EQ(c, tags.innerTag(4));
+  EXPECT_EQ(b, tags.innerTag(5));
+  EXPECT_EQ(a, tags.innerTag(9));
+  EXPECT_EQ(nullptr, tags.innerTag(-1));
+  EXPECT_EQ(nullptr, tags.innerTag(10));
+
+  EXPECT_EQ(a, tags.outerTag(0));
+  EXPECT_EQ(a, tags.outerTag(4));
+  EXPECT_EQ(a, tags.outerTag(9));
+  EXPECT_EQ(nullptr, tags.outerTag(10));
+}
+
+TEST(Tags, InnerOuterTagAfterEdits)
+{
+  Tags tags(nullptr);
+
+  auto* a = new Tag(0, 3);
+  a->setName("a");
+  tags.add(a);
+
+  auto* b = new Tag(6, 8);
+  b->setName("b");
+  tags.add(b);
+
+  EXPECT_EQ(a, tags.innerTag(3));
+  EXPECT_EQ(nullptr, tags.innerTag(4));
+  EXPECT_EQ(b, tags.innerTag(6));
+
+  // Moving a tag range goes through Tags::remove()/add() and must
+  // invalidate previous queries
+  b->setFrameRange(4, 8);
+  EXPECT_EQ(b, tags.innerTag(4));
+  EXPECT_EQ(b, tags.outerTag(8));
+
+  tags.remove(a);
+  EXPECT_EQ(nullptr, tags.innerTag(0));
+  EXPECT_EQ(nullptr, tags.outerTag(3));
+  EXPECT_EQ(b, tags.innerTag(5));
+
+  delete a;
+}
+
+TEST(Tags, SameLengthTagsTieBreaking)
+{
+  Tags tags(nullptr);
+
+  // Two same-length overlapping tags: the first one in the list order
+  // must win for both queries (like the old linear scan did)
+  auto* a = new Tag(0, 4);
+  a->setName("a");
+  tags.add(a);
+
+  auto* b = new Tag(2, 6);
+  b->setName("b");
+  tags.add(b);
+
+  EXPECT_EQ(a, tags.innerTag(3));
+  EXPECT_EQ(a, tags.outerTag(3));
+  EXPECT_EQ(b, tags.innerTag(5));
+  EXPECT_EQ(b, tags.outerTag(5));
+}
@@ -317,13 +317,22 @@ void Tileset::notifyTileContentChange(const tile_index ti)
     hashImage(ti, m_tiles[ti]);
 
 #else // Regenerate the whole hash map (at the moment this is the
-      // only way to make it work correctly)
+      // only way to make it work correctly). As TilesetHashTable uses
+      // the hash cached in each tile image (Image::contentHash()),
+      // the re-generation only re-visits the pixels of the modified
+      // tile, the other tiles just reuse their cached hashes.
 
   (void)ti; // unused
 
-  if (ti >= 0 && ti < m_tiles.size() && m_tiles[ti].image)
+  if (ti >= 0 && ti < m_tiles.size() && m_tiles[ti].image) {
     preprocess_transparent_pixels(m_tiles[ti].image.get());
 
+    // The tile pixels were modified, invalidate its cached
+    // contentHash() (e.g. for INDEXED tiles where
+    // preprocess_transparent_pixels() doesn't touch the image).
+    m_tiles[ti].image->incrementVersion();
+  }
+
   rehash();
 
 #endif
@@ -17,9 +17,24 @@
 #include <unordered_map>
 
 namespace doc {
+namespace details {
+
+// Hashes a tile using the content hash cached in the Image itself
+// (Image::contentHash()), so re-generating the tileset hash table
+// after a tile changes doesn't walk the pixels of unmodified tiles
+// again. It relies on the same contract as contentHash(): code
+// modifying tile pixels must call Image::incrementVersion() (which
+// Tileset::notifyTileContentChange() does), and on tile images being
+// preprocessed with preprocess_transparent_pixels() so the raw bytes
+// of equal tiles match.
+struct tile_image_hash {
+  size_t operator()(const ImageRef& i) const { return size_t(i->contentHash()); }
+};
+
+} // namespace details
 
 // A hash table used to match Image pixels data <-> tileset index
-typedef std::unordered_map<ImageRef, tile_index, details::image_hash, details::image_eq>
+typedef std::unordered_map<ImageRef, tile_index, details::tile_image_hash, details::image_eq>
   TilesetHashTable;
 
 } // namespace doc
@@ -0,0 +1,345 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "filters/box_blur_filter.h"
+
+#include "base/task.h"
+#include "base/thread_pool.h"
+#include "doc/image.h"
+#include "doc/palette.h"
+#include "doc/primitives_fast.h"
+#include "doc/rgbmap.h"
+#include "filters/filter_indexed_data.h"
+#include "filters/filter_manager.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace filters {
+
+using namespace doc;
+
+namespace {
+
+// Don't spawn a task for less lines than this, the queueing overhead
+// would eat the gain.
+const int kMinLinesPerBand = 64;
+
+// Box-blurs one line of "n" samples spaced "stride" bytes apart using
+// a running sum: one sample enters the window and one leaves it per
+// step, so the cost is O(n) for any radius. The window is clamped at
+// the edges and normalized by the real number of samples it covers,
+// so borders don't darken. "tmp" must have room for n samples.
+void box_blur_line(uint8_t* data, const int stride, const int n, const int r, uint8_t* tmp)
+{
+  for (int i = 0; i < n; ++i)
+    tmp[i] = data[i * stride];
+
+  const int last = std::min(r, n - 1);
+  int sum = 0;
+  int count = 0;
+  for (int i = 0; i <= last; ++i, ++count)
+    sum += tmp[i];
+
+  for (int i = 0; i < n; ++i) {
+    data[i * stride] = (sum + count / 2) / count;
+
+    const int add = i + r + 1;
+    if (add < n) {
+      sum += tmp[add];
+      ++count;
+    }
+    const int remove = i - r;
+    if (remove >= 0) {
+      sum -= tmp[remove];
+      --count;
+    }
+  }
+}
+
+// Applies "passes" box blurs to a w*h plane of samples. Each pass
+// blurs all rows and then all columns; as rows (and columns) are
+// independent from each other they are distributed in bands between
+// the worker threads.
+void box_blur_plane(std::vector<uint8_t>& plane,
+                    const int w,
+                    const int h,
+                    const int radius,
+                    const int passes,
+                    base::task_token& token)
+{
+  static base::thread_pool pool(std::max<int>(2, std::thread::hardware_concurrency()));
+  const int threads = std::max<int>(2, std::thread::hardware_concurrency());
+  uint8_t* data = plane.data();
+
+  for (int pass = 0; pass < passes && !token.canceled(); ++pass) {
+    // Horizontal
+    int nbands = std::clamp(h / kMinLinesPerBand, 1, threads);
+    for (int band = 0; band < nbands; ++band) {
+      const int y0 = h * band / nbands;
+      const int y1 = h * (band + 1) / nbands;
+      pool.execute([data, w, radius, y0, y1, &token] {
+        std::vector<uint8_t> tmp(w);
+        for (int y = y0; y < y1 && !token.canceled(); ++y)
+          box_blur_line(data + y * w, 1, w, radius, tmp.data());
+      });
+    }
+    pool.wait_all();
+
+    // Vertical
+    nbands = std::clamp(w / kMinLinesPerBand, 1, threads);
+    for (int band = 0; band < nbands; ++band) {
+      const int x0 = w * band / nbands;
+      const int x1 = w * (band + 1) / nbands;
+      pool.execute([data, w, h, radius, x0, x1, &token] {
+        std::vector<uint8_t> tmp(h);
+        for (int x = x0; x < x1 && !token.canceled(); ++x)
+          box_blur_line(data + x, w, h, radius, tmp.data());
+      });
+    }
+    pool.wait_all();
+  }
+}
+
+// Blurs one 8-bit channel of the image in place (the channel is given
+// by its bit shift inside the pixel, e.g. rgba_r_shift).
+template<typename Traits>
+void blur_channel(Image* image,
+                  const int shift,
+                  const int radius,
+                  const int passes,
+                  base::task_token& token)
+{
+  const int w = image->width();
+  const int h = image->height();
+  const auto mask = typename Traits::pixel_t(typename Traits::pixel_t(0xff) << shift);
+  std::vector<uint8_t> plane(w * h);
+
+  for (int y = 0; y < h; ++y) {
+    auto row = (const typename Traits::pixel_t*)image->getPixelAddress(0, y);
+    for (int x = 0; x < w; ++x)
+      plane[y * w + x] = (row[x] >> shift) & 0xff;
+  }
+
+  box_blur_plane(plane, w, h, radius, passes, token);
+  if (token.canceled())
+    return;
+
+  for (int y = 0; y < h; ++y) {
+    auto row = (typename Traits::pixel_t*)image->getPixelAddress(0, y);
+    for (int x = 0; x < w; ++x) {
+      row[x] = (row[x] & ~mask) | (typename Traits::pixel_t(plane[y * w + x]) << shift);
+    }
+  }
+}
+
+}; // namespace
+
+BoxBlurFilter::BoxBlurFilter()
+  : m_radius(4)
+  , m_passes(3)
+  , m_cachedSrc(nullptr)
+  , m_cachedVersion(0)
+  , m_cachedRadius(-1)
+  , m_cachedPasses(-1)
+  , m_cachedIndexTarget(false)
+{
+}
+
+void BoxBlurFilter::setRadius(int radius)
+{
+  m_radius = std::max(1, radius);
+}
+
+void BoxBlurFilter::setPasses(int passes)
+{
+  m_passes = std::clamp(passes, 1, 8);
+}
+
+const char* BoxBlurFilter::getName()
+{
+  return "Box Blur";
+}
+
+const doc::Image* BoxBlurFilter::ensureBlurred(FilterManager* filterMgr)
+{
+  const Image* src = filterMgr->getSourceImage();
+  const bool indexTarget = (src->pixelFormat() == IMAGE_INDEXED &&
+                            (filterMgr->getTarget() & TARGET_INDEX_CHANNEL) != 0);
+
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_blurred && m_cachedSrc == src && m_cachedVersion == src->version() &&
+      m_cachedRadius == m_radius && m_cachedPasses == m_passes &&
+      m_cachedIndexTarget == indexTarget)
+    return m_blurred.get();
+
+  base::task_token& token = filterMgr->taskToken();
+  ImageRef blurred;
+
+  switch (src->pixelFormat()) {
+    case IMAGE_RGB:
+      blurred.reset(Image::createCopy(src));
+      blur_channel<RgbTraits>(blurred.get(), rgba_r_shift, m_radius, m_passes, token);
+      blur_channel<RgbTraits>(blurred.get(), rgba_g_shift, m_radius, m_passes, token);
+      blur_channel<RgbTraits>(blurred.get(), rgba_b_shift, m_radius, m_passes, token);
+      blur_channel<RgbTraits>(blurred.get(), rgba_a_shift, m_radius, m_passes, token);
+      break;
+
+    case IMAGE_GRAYSCALE:
+      blurred.reset(Image::createCopy(src));
+      blur_channel<GrayscaleTraits>(blurred.get(), graya_v_shift, m_radius, m_passes, token);
+      blur_channel<GrayscaleTraits>(blurred.get(), graya_a_shift, m_radius, m_passes, token);
+      break;
+
+    case IMAGE_INDEXED:
+      if (indexTarget) {
+        // Blur the indices themselves (like Median Blur does for the
+        // index channel).
+        blurred.reset(Image::createCopy(src));
+        blur_channel<IndexedTraits>(blurred.get(), 0, m_radius, m_passes, token);
+      }
+      else {
+        // Blur in RGB space and let applyToIndexed() remap the result
+        // to the palette.
+        const Palette* pal = filterMgr->getIndexedData()->getPalette();
+        blurred.reset(Image::create(IMAGE_RGB, src->width(), src->height()));
+        for (int y = 0; y < src->height(); ++y) {
+          auto srcRow = (const uint8_t*)src->getPixelAddress(0, y);
+          auto dstRow = (uint32_t*)blurred->getPixelAddress(0, y);
+          for (int x = 0; x < src->width(); ++x)
+            dstRow[x] = pal->getEntry(srcRow[x]);
+        }
+        blur_channel<RgbTraits>(blurred.get(), rgba_r_shift, m_radius, m_passes, token);
+        blur_channel<RgbTraits>(blurred.get(), rgba_g_shift, m_radius, m_passes, token);
+        blur_channel<RgbTraits>(blurred.get(), rgba_b_shift, m_radius, m_passes, token);
+        blur_channel<RgbTraits>(blurred.get(), rgba_a_shift, m_radius, m_passes, token);
+      }
+      break;
+  }
+
+  // Don't cache a half-blurred image if the preview was canceled (the
+  // rows won't be used anyway because every row loop checks the
+  // token).
+  if (token.canceled() || !blurred)
+    return src;
+
+  m_blurred = blurred;
+  m_cachedSrc = src;
+  m_cachedVersion = src->version();
+  m_cachedRadius = m_radius;
+  m_cachedPasses = m_passes;
+  m_cachedIndexTarget = indexTarget;
+  return m_blurred.get();
+}
+
+void BoxBlurFilter::applyToRgba(FilterManager* filterMgr)
+{
+  const Image* blurred = ensureBlurred(filterMgr);
+  int color, c, r, g, b, a;
+
+  FILTER_LOOP_THROUGH_ROW_BEGIN(uint32_t)
+  {
+    color = *src_address;
+    c = get_pixel_fast<RgbTraits>(blurred, x, y);
+
+    if (target & TARGET_RED_CHANNEL)
+      r = rgba_getr(c);
+    else
+      r = rgba_getr(color);
+
+    if (target & TARGET_GREEN_CHANNEL)
+      g = rgba_getg(c);
+    else
+      g = rgba_getg(color);
+
+    if (target & TARGET_BLUE_CHANNEL)
+      b = rgba_getb(c);
+    else
+      b = rgba_getb(color);
+
+    if (target & TARGET_ALPHA_CHANNEL)
+      a = rgba_geta(c);
+    else
+      a = rgba_geta(color);
+
+    *dst_address = rgba(r, g, b, a);
+  }
+  FILTER_LOOP_THROUGH_ROW_END()
+}
+
+void BoxBlurFilter::applyToGrayscale(FilterManager* filterMgr)
+{
+  const Image* blurred = ensureBlurred(filterMgr);
+  int color, c, k, a;
+
+  FILTER_LOOP_THROUGH_ROW_BEGIN(uint16_t)
+  {
+    color = *src_address;
+    c = get_pixel_fast<GrayscaleTraits>(blurred, x, y);
+
+    if (target & TARGET_GRAY_CHANNEL)
+      k = graya_getv(c);
+    else
+      k = graya_getv(color);
+
+    if (target & TARGET_ALPHA_CHANNEL)
+      a = graya_geta(c);
+    else
+      a = graya_geta(color);
+
+    *dst_address = graya(k, a);
+  }
+  FILTER_LOOP_THROUGH_ROW_END()
+}
+
+void BoxBlurFilter::applyToIndexed(FilterManager* filterMgr)
+{
+  const Image* blurred = ensureBlurred(filterMgr);
+  const Palette* pal = filterMgr->getIndexedData()->getPalette();
+  const RgbMap* rgbmap = filterMgr->getIndexedData()->getRgbMap();
+  int color, c, r, g, b, a;
+
+  FILTER_LOOP_THROUGH_ROW_BEGIN(uint8_t)
+  {
+    if (target & TARGET_INDEX_CHANNEL) {
+      *dst_address = get_pixel_fast<IndexedTraits>(blurred, x, y);
+    }
+    else {
+      color = pal->getEntry(*src_address);
+      c = get_pixel_fast<RgbTraits>(blurred, x, y);
+
+      if (target & TARGET_RED_CHANNEL)
+        r = rgba_getr(c);
+      else
+        r = rgba_getr(color);
+
+      if (target & TARGET_GREEN_CHANNEL)
+        g = rgba_getg(c);
+      else
+        g = rgba_getg(color);
+
+      if (target & TARGET_BLUE_CHANNEL)
+        b = rgba_getb(c);
+      else
+        b = rgba_getb(color);
+
+      if (target & TARGET_ALPHA_CHANNEL)
+        a = rgba_geta(c);
+      else
+        a = rgba_geta(color);
+
+      *dst_address = rgbmap->mapColor(r, g, b, a);
+    }
+  }
+  FILTER_LOOP_THROUGH_ROW_END()
+}
+
+} // namespace filters
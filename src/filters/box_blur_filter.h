@@ -0,0 +1,64 @@
+// Aseprite
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This program is distributed under the terms of
+// the End-User License Agreement for Aseprite.
+
+#ifndef FILTERS_BOX_BLUR_FILTER_H_INCLUDED
+#define FILTERS_BOX_BLUR_FILTER_H_INCLUDED
+#pragma once
+
+#include "doc/image_ref.h"
+#include "doc/object_version.h"
+#include "filters/filter.h"
+
+#include <mutex>
+
+namespace filters {
+
+// Box blur implemented with a running sum per scanline, so the cost
+// per pixel is constant and doesn't depend on the radius (a radius-50
+// blur takes the same time as a radius-2 blur). Repeating the box
+// several times converges to a Gaussian blur (3 passes is the usual
+// approximation).
+class BoxBlurFilter : public Filter {
+public:
+  BoxBlurFilter();
+
+  void setRadius(int radius);
+  void setPasses(int passes);
+
+  int getRadius() const { return m_radius; }
+  int getPasses() const { return m_passes; }
+
+  // Filter implementation
+  const char* getName() override;
+  void applyToRgba(FilterManager* filterMgr) override;
+  void applyToGrayscale(FilterManager* filterMgr) override;
+  void applyToIndexed(FilterManager* filterMgr) override;
+  bool supportsParallelRows() const override { return true; }
+
+private:
+  // Returns the whole source image blurred with the current
+  // parameters, computing it the first time a row asks for it (the
+  // per-row apply*() functions just copy the targeted channels from
+  // this image). The result is cached between rows and between
+  // preview restarts while the source image and parameters don't
+  // change.
+  const doc::Image* ensureBlurred(FilterManager* filterMgr);
+
+  int m_radius;
+  int m_passes;
+
+  std::mutex m_mutex;
+  doc::ImageRef m_blurred;
+  const doc::Image* m_cachedSrc;
+  doc::ObjectVersion m_cachedVersion;
+  int m_cachedRadius;
+  int m_cachedPasses;
+  bool m_cachedIndexTarget;
+};
+
+} // namespace filters
+
+#endif
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2016  David Capello
 //
 // This program is distributed under the terms of
@@ -19,13 +19,25 @@
 #include "filters/filter_indexed_data.h"
 #include "filters/filter_manager.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace filters {
 
 using namespace doc;
 
-ColorCurveFilter::ColorCurveFilter() : m_cmap(256)
+ColorCurveFilter::ColorCurveFilter()
+  : m_cmap(256)
+  , m_lutTarget(-1)
+  , m_lutR(256)
+  , m_lutG(256)
+  , m_lutB(256)
+  , m_lutA(256)
+  , m_lutK(256)
+  , m_indexLutTarget(-1)
+  , m_indexLutPalette(nullptr)
+  , m_indexLutVersion(0)
+  , m_indexLut(256)
 {
 }
 
@@ -41,6 +53,57 @@ void ColorCurveFilter::generateMap()
   m_curve.getValues(0, 255, m_cmap);
   for (int c = 0; c < 256; c++)
     m_cmap[c] = std::clamp(m_cmap[c], 0, 255);
+
+  // Invalidate the compiled LUTs
+  m_lutTarget = -1;
+  m_indexLutTarget = -1;
+}
+
+void ColorCurveFilter::updateLuts(const Target target)
+{
+  if (target == m_lutTarget)
+    return;
+
+  for (int c = 0; c < 256; ++c) {
+    const uint8_t mapped = uint8_t(m_cmap[c]);
+    m_lutR[c] = (target & TARGET_RED_CHANNEL ? mapped : uint8_t(c));
+    m_lutG[c] = (target & TARGET_GREEN_CHANNEL ? mapped : uint8_t(c));
+    m_lutB[c] = (target & TARGET_BLUE_CHANNEL ? mapped : uint8_t(c));
+    m_lutA[c] = (target & TARGET_ALPHA_CHANNEL ? mapped : uint8_t(c));
+    m_lutK[c] = (target & TARGET_GRAY_CHANNEL ? mapped : uint8_t(c));
+  }
+  m_lutTarget = target;
+}
+
+void ColorCurveFilter::updateIndexLut(FilterManager* filterMgr)
+{
+  const Target target = filterMgr->getTarget();
+  const Palette* pal = filterMgr->getIndexedData()->getPalette();
+  if (target == m_indexLutTarget && pal == m_indexLutPalette && pal->version() == m_indexLutVersion)
+    return;
+
+  updateLuts(target);
+
+  const RgbMap* rgbmap = filterMgr->getIndexedData()->getRgbMap();
+  const int n = pal->size();
+  for (int i = 0; i < 256; ++i) {
+    int c = i;
+    if (target & TARGET_INDEX_CHANNEL) {
+      c = m_cmap[i];
+    }
+    else if (i < n) {
+      const color_t e = pal->getEntry(i);
+      c = rgbmap->mapColor(m_lutR[rgba_getr(e)],
+                           m_lutG[rgba_getg(e)],
+                           m_lutB[rgba_getb(e)],
+                           m_lutA[rgba_geta(e)]);
+    }
+    m_indexLut[i] = uint8_t(std::clamp(c, 0, n - 1));
+  }
+
+  m_indexLutTarget = target;
+  m_indexLutPalette = pal;
+  m_indexLutVersion = pal->version();
 }
 
 const char* ColorCurveFilter::getName()
@@ -50,85 +113,42 @@ const char* ColorCurveFilter::getName()
 
 void ColorCurveFilter::applyToRgba(FilterManager* filterMgr)
 {
-  int c, r, g, b, a;
+  updateLuts(filterMgr->getTarget());
 
   FILTER_LOOP_THROUGH_ROW_BEGIN(uint32_t)
   {
-    c = *src_address;
-
-    r = rgba_getr(c);
-    g = rgba_getg(c);
-    b = rgba_getb(c);
-    a = rgba_geta(c);
-
-    if (target & TARGET_RED_CHANNEL)
-      r = m_cmap[r];
-    if (target & TARGET_GREEN_CHANNEL)
-      g = m_cmap[g];
-    if (target & TARGET_BLUE_CHANNEL)
-      b = m_cmap[b];
-    if (target & TARGET_ALPHA_CHANNEL)
-      a = m_cmap[a];
-
-    *dst_address = rgba(r, g, b, a);
+    const color_t c = *src_address;
+
+    *dst_address = rgba(m_lutR[rgba_getr(c)],
+                        m_lutG[rgba_getg(c)],
+                        m_lutB[rgba_getb(c)],
+                        m_lutA[rgba_geta(c)]);
   }
   FILTER_LOOP_THROUGH_ROW_END()
 }
 
 void ColorCurveFilter::applyToGrayscale(FilterManager* filterMgr)
 {
-  int c, k, a;
+  updateLuts(filterMgr->getTarget());
 
   FILTER_LOOP_THROUGH_ROW_BEGIN(uint16_t)
   {
-    c = *src_address;
+    const color_t c = *src_address;
 
-    k = graya_getv(c);
-    a = graya_geta(c);
-
-    if (target & TARGET_GRAY_CHANNEL)
-      k = m_cmap[k];
-    if (target & TARGET_ALPHA_CHANNEL)
-      a = m_cmap[a];
-
-    *dst_address = graya(k, a);
+    *dst_address = graya(m_lutK[graya_getv(c)], m_lutA[graya_geta(c)]);
   }
   FILTER_LOOP_THROUGH_ROW_END()
 }
 
 void ColorCurveFilter::applyToIndexed(FilterManager* filterMgr)
 {
-  const Palette* pal = filterMgr->getIndexedData()->getPalette();
-  const RgbMap* rgbmap = filterMgr->getIndexedData()->getRgbMap();
-  int c, r, g, b, a;
+  // Remap the whole palette once (O(palette) RgbMap queries) and then
+  // apply the row with a single index -> index lookup per pixel
+  updateIndexLut(filterMgr);
 
   FILTER_LOOP_THROUGH_ROW_BEGIN(uint8_t)
   {
-    c = *src_address;
-
-    if (target & TARGET_INDEX_CHANNEL) {
-      c = m_cmap[c];
-    }
-    else {
-      c = pal->getEntry(c);
-      r = rgba_getr(c);
-      g = rgba_getg(c);
-      b = rgba_getb(c);
-      a = rgba_geta(c);
-
-      if (target & TARGET_RED_CHANNEL)
-        r = m_cmap[r];
-      if (target & TARGET_GREEN_CHANNEL)
-        g = m_cmap[g];
-      if (target & TARGET_BLUE_CHANNEL)
-        b = m_cmap[b];
-      if (target & TARGET_ALPHA_CHANNEL)
-        a = m_cmap[a];
-
-      c = rgbmap->mapColor(r, g, b, a);
-    }
-
-    *dst_address = std::clamp(c, 0, pal->size() - 1);
+    *dst_address = m_indexLut[*src_address];
   }
   FILTER_LOOP_THROUGH_ROW_END()
 }
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This program is distributed under the terms of
@@ -9,10 +9,17 @@
 #define FILTERS_COLOR_CURVE_FILTER_H_INCLUDED
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
+#include "doc/object_version.h"
 #include "filters/color_curve.h"
 #include "filters/filter.h"
+#include "filters/target.h"
+
+namespace doc {
+class Palette;
+}
 
 namespace filters {
 
@@ -32,8 +39,28 @@ public:
 private:
   void generateMap();
 
+  // Compiles one LUT per channel for the given target (identity for
+  // non-targeted channels), so rows are applied with branch-free
+  // table lookups.
+  void updateLuts(const Target target);
+
+  // Compiles the index -> index LUT that remaps the whole palette
+  // through the curve and the RgbMap, so indexed rows cost one lookup
+  // per pixel (O(palette) RgbMap queries instead of O(pixels)).
+  void updateIndexLut(FilterManager* filterMgr);
+
   ColorCurve m_curve;
   std::vector<int> m_cmap;
+
+  // Per-channel LUTs compiled for m_lutTarget
+  Target m_lutTarget;
+  std::vector<uint8_t> m_lutR, m_lutG, m_lutB, m_lutA, m_lutK;
+
+  // Palette remap compiled for m_indexLutTarget/m_indexLutPalette
+  Target m_indexLutTarget;
+  const doc::Palette* m_indexLutPalette;
+  doc::ObjectVersion m_indexLutVersion;
+  std::vector<uint8_t> m_indexLut;
 };
 
 } // namespace filters
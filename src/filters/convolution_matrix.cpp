@@ -24,4 +24,43 @@ ConvolutionMatrix::ConvolutionMatrix(int width, int height)
 {
 }
 
+bool ConvolutionMatrix::getSeparableKernels(std::vector<int>& row,
+                                            std::vector<int>& col,
+                                            int& scale) const
+{
+  // Find the first non-zero element (x0, y0); its row and column are
+  // the candidate 1D kernels.
+  int x0 = -1, y0 = -1;
+  for (int y = 0; y < m_height && y0 < 0; ++y) {
+    for (int x = 0; x < m_width; ++x) {
+      if (value(x, y) != 0) {
+        x0 = x;
+        y0 = y;
+        break;
+      }
+    }
+  }
+  if (y0 < 0) // Null matrix
+    return false;
+
+  // The matrix is rank 1 iff every element satisfies
+  //   value(x, y) * value(x0, y0) == value(x, y0) * value(x0, y)
+  // (a cross-product test, so we never divide integers).
+  for (int y = 0; y < m_height; ++y) {
+    for (int x = 0; x < m_width; ++x) {
+      if (value(x, y) * value(x0, y0) != value(x, y0) * value(x0, y))
+        return false;
+    }
+  }
+
+  row.resize(m_width);
+  col.resize(m_height);
+  for (int x = 0; x < m_width; ++x)
+    row[x] = value(x, y0);
+  for (int y = 0; y < m_height; ++y)
+    col[y] = value(x0, y);
+  scale = value(x0, y0);
+  return true;
+}
+
 } // namespace filters
@@ -54,6 +54,13 @@ public:
   int& value(int x, int y) { return m_data[y * m_width + x]; }
   const int& value(int x, int y) const { return m_data[y * m_width + x]; }
 
+  // Returns true if the matrix is separable, i.e. if it is the outer
+  // product of a column vector and a row vector (like the stock blur
+  // kernels). In that case it fills "row", "col" and "scale" so that
+  // value(x, y) * scale == col[y] * row[x] for every element, which
+  // lets ConvolutionMatrixFilter convolve in two 1D passes.
+  bool getSeparableKernels(std::vector<int>& row, std::vector<int>& col, int& scale) const;
+
 private:
   std::string m_name;      // Name
   int m_width, m_height;   // Size of the matrix
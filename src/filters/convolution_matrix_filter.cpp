@@ -114,15 +114,72 @@ struct GetPixelsDelegateIndexed : public GetPixelsDelegate {
   }
 };
 
+// Delegates for the vertical pass of the separable fast path: they
+// accumulate one column-weighted sum per window column. A window
+// touching a fully transparent pixel is flagged so the caller can
+// fall back to the 2D gather for that pixel (the adaptive "div"
+// used for transparent pixels is not separable).
+
+struct VerticalPassRgba {
+  const int* col;
+  int i, r, g, b, a, transparent;
+
+  void reset(const int* colKernel)
+  {
+    col = colKernel;
+    i = r = g = b = a = transparent = 0;
+  }
+
+  void operator()(RgbTraits::pixel_t color)
+  {
+    const int f = col[i++];
+    if (rgba_geta(color) == 0)
+      ++transparent;
+    else if (f) {
+      r += rgba_getr(color) * f;
+      g += rgba_getg(color) * f;
+      b += rgba_getb(color) * f;
+      a += rgba_geta(color) * f;
+    }
+  }
+};
+
+struct VerticalPassGrayscale {
+  const int* col;
+  int i, v, a, transparent;
+
+  void reset(const int* colKernel)
+  {
+    col = colKernel;
+    i = v = a = transparent = 0;
+  }
+
+  void operator()(GrayscaleTraits::pixel_t color)
+  {
+    const int f = col[i++];
+    if (graya_geta(color) == 0)
+      ++transparent;
+    else if (f) {
+      v += graya_getv(color) * f;
+      a += graya_geta(color) * f;
+    }
+  }
+};
+
 } // namespace
 
-ConvolutionMatrixFilter::ConvolutionMatrixFilter() : m_matrix(NULL), m_tiledMode(TiledMode::NONE)
+ConvolutionMatrixFilter::ConvolutionMatrixFilter()
+  : m_matrix(NULL)
+  , m_tiledMode(TiledMode::NONE)
+  , m_separable(false)
+  , m_sepScale(0)
 {
 }
 
 void ConvolutionMatrixFilter::setMatrix(const std::shared_ptr<ConvolutionMatrix>& matrix)
 {
   m_matrix = matrix;
+  m_separable = (matrix && matrix->getSeparableKernels(m_sepRow, m_sepCol, m_sepScale));
 }
 
 void ConvolutionMatrixFilter::setTiledMode(TiledMode tiledMode)
@@ -135,11 +192,193 @@ const char* ConvolutionMatrixFilter::getName()
   return "Convolution Matrix";
 }
 
+bool ConvolutionMatrixFilter::applySeparableToRgba(FilterManager* filterMgr)
+{
+  const int64_t div = int64_t(m_matrix->getDiv()) * m_sepScale;
+  if (!m_separable || div == 0)
+    return false;
+
+  const Image* src = filterMgr->getSourceImage();
+  const int w = m_matrix->getWidth();
+  const int h = m_matrix->getHeight();
+  const int cx = m_matrix->getCenterX();
+  const int cy = m_matrix->getCenterY();
+  const int bias = m_matrix->getBias();
+  const int x1 = filterMgr->x();
+
+  // Vertical pass: one column-weighted sum per window column of this
+  // row, covering every window of the row (the extra w-1 columns are
+  // shared between neighboring pixels, which is where the speedup
+  // comes from).
+  std::vector<VerticalPassRgba> vert(filterMgr->getWidth() + w - 1);
+  for (int i = 0; i < int(vert.size()); ++i) {
+    vert[i].reset(m_sepCol.data());
+    get_neighboring_pixels<RgbTraits>(src,
+                                      x1 - cx + i,
+                                      filterMgr->y(),
+                                      1,
+                                      h,
+                                      0,
+                                      cy,
+                                      m_tiledMode,
+                                      vert[i]);
+  }
+
+  uint32_t color;
+  GetPixelsDelegateRgba slow;
+
+  FILTER_LOOP_THROUGH_ROW_BEGIN(uint32_t)
+  {
+    // Horizontal pass: row-weighted sum of the vertical sums.
+    const VerticalPassRgba* v = &vert[x - x1];
+    int64_t r = 0, g = 0, b = 0, a = 0;
+    int64_t cdiv = div, adiv = div;
+    int transparent = 0;
+    for (int dx = 0; dx < w; ++dx) {
+      const int f = m_sepRow[dx];
+      transparent += v[dx].transparent;
+      if (f) {
+        r += int64_t(v[dx].r) * f;
+        g += int64_t(v[dx].g) * f;
+        b += int64_t(v[dx].b) * f;
+        a += int64_t(v[dx].a) * f;
+      }
+    }
+
+    color = get_pixel_fast<RgbTraits>(src, x, y);
+
+    if (transparent) {
+      // The window touches transparent pixels: use the generic gather
+      // (with its per-pixel adjusted div) for this pixel.
+      slow.reset(m_matrix.get());
+      get_neighboring_pixels<RgbTraits>(src, x, y, w, h, cx, cy, m_tiledMode, slow);
+      if (slow.div == 0) {
+        *dst_address = color;
+        continue;
+      }
+      r = slow.r;
+      g = slow.g;
+      b = slow.b;
+      a = slow.a;
+      cdiv = slow.div;
+      adiv = m_matrix->getDiv();
+    }
+
+    int ir, ig, ib, ia;
+
+    if (target & TARGET_RED_CHANNEL)
+      ir = std::clamp(int(r / cdiv) + bias, 0, 255);
+    else
+      ir = rgba_getr(color);
+
+    if (target & TARGET_GREEN_CHANNEL)
+      ig = std::clamp(int(g / cdiv) + bias, 0, 255);
+    else
+      ig = rgba_getg(color);
+
+    if (target & TARGET_BLUE_CHANNEL)
+      ib = std::clamp(int(b / cdiv) + bias, 0, 255);
+    else
+      ib = rgba_getb(color);
+
+    if (target & TARGET_ALPHA_CHANNEL)
+      ia = std::clamp(int(a / adiv) + bias, 0, 255);
+    else
+      ia = rgba_geta(color);
+
+    *dst_address = rgba(ir, ig, ib, ia);
+  }
+  FILTER_LOOP_THROUGH_ROW_END()
+  return true;
+}
+
+bool ConvolutionMatrixFilter::applySeparableToGrayscale(FilterManager* filterMgr)
+{
+  const int64_t div = int64_t(m_matrix->getDiv()) * m_sepScale;
+  if (!m_separable || div == 0)
+    return false;
+
+  const Image* src = filterMgr->getSourceImage();
+  const int w = m_matrix->getWidth();
+  const int h = m_matrix->getHeight();
+  const int cx = m_matrix->getCenterX();
+  const int cy = m_matrix->getCenterY();
+  const int bias = m_matrix->getBias();
+  const int x1 = filterMgr->x();
+
+  std::vector<VerticalPassGrayscale> vert(filterMgr->getWidth() + w - 1);
+  for (int i = 0; i < int(vert.size()); ++i) {
+    vert[i].reset(m_sepCol.data());
+    get_neighboring_pixels<GrayscaleTraits>(src,
+                                            x1 - cx + i,
+                                            filterMgr->y(),
+                                            1,
+                                            h,
+                                            0,
+                                            cy,
+                                            m_tiledMode,
+                                            vert[i]);
+  }
+
+  uint16_t color;
+  GetPixelsDelegateGrayscale slow;
+
+  FILTER_LOOP_THROUGH_ROW_BEGIN(uint16_t)
+  {
+    const VerticalPassGrayscale* vcol = &vert[x - x1];
+    int64_t v = 0, a = 0;
+    int64_t cdiv = div, adiv = div;
+    int transparent = 0;
+    for (int dx = 0; dx < w; ++dx) {
+      const int f = m_sepRow[dx];
+      transparent += vcol[dx].transparent;
+      if (f) {
+        v += int64_t(vcol[dx].v) * f;
+        a += int64_t(vcol[dx].a) * f;
+      }
+    }
+
+    color = get_pixel_fast<GrayscaleTraits>(src, x, y);
+
+    if (transparent) {
+      slow.reset(m_matrix.get());
+      get_neighboring_pixels<GrayscaleTraits>(src, x, y, w, h, cx, cy, m_tiledMode, slow);
+      if (slow.div == 0) {
+        *dst_address = color;
+        continue;
+      }
+      v = slow.v;
+      a = slow.a;
+      cdiv = slow.div;
+      adiv = m_matrix->getDiv();
+    }
+
+    int iv, ia;
+
+    if (target & TARGET_GRAY_CHANNEL)
+      iv = std::clamp(int(v / cdiv) + bias, 0, 255);
+    else
+      iv = graya_getv(color);
+
+    if (target & TARGET_ALPHA_CHANNEL)
+      ia = std::clamp(int(a / adiv) + bias, 0, 255);
+    else
+      ia = graya_geta(color);
+
+    *dst_address = graya(iv, ia);
+  }
+  FILTER_LOOP_THROUGH_ROW_END()
+  return true;
+}
+
 void ConvolutionMatrixFilter::applyToRgba(FilterManager* filterMgr)
 {
   if (!m_matrix)
     return;
 
+  if (applySeparableToRgba(filterMgr))
+    return;
+
   const Image* src = filterMgr->getSourceImage();
   uint32_t color;
   GetPixelsDelegateRgba delegate;
@@ -201,6 +440,9 @@ void ConvolutionMatrixFilter::applyToGrayscale(FilterManager* filterMgr)
   if (!m_matrix)
     return;
 
+  if (applySeparableToGrayscale(filterMgr))
+    return;
+
   const Image* src = filterMgr->getSourceImage();
   uint16_t color;
   GetPixelsDelegateGrayscale delegate;
@@ -13,6 +13,7 @@
 #include "filters/tiled_mode.h"
 
 #include <memory>
+#include <vector>
 
 namespace filters {
 
@@ -35,8 +36,21 @@ public:
   void applyToIndexed(FilterManager* filterMgr);
 
 private:
+  // Fast path for separable matrices (two 1D passes instead of the
+  // full 2D gather). They return false if the fast path cannot be
+  // used and the caller must run the generic loop.
+  bool applySeparableToRgba(FilterManager* filterMgr);
+  bool applySeparableToGrayscale(FilterManager* filterMgr);
+
   std::shared_ptr<ConvolutionMatrix> m_matrix;
   TiledMode m_tiledMode;
+
+  // 1D kernels when the matrix is separable (see
+  // ConvolutionMatrix::getSeparableKernels()).
+  bool m_separable;
+  std::vector<int> m_sepRow;
+  std::vector<int> m_sepCol;
+  int m_sepScale;
 };
 
 } // namespace filters
@@ -44,6 +44,12 @@ public:
 
   // Applies the filter to the color palette.
   virtual void applyToPalette(FilterManager* filterMgr) {}
+
+  // Returns true if the apply*() member functions can be called for
+  // different rows from different threads at the same time (i.e. the
+  // filter doesn't keep mutable state between rows), so the whole
+  // target can be processed in parallel row bands.
+  virtual bool supportsParallelRows() const { return false; }
 };
 
 // Filter that support applying it only to palette colors.
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019-2023  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -17,7 +17,7 @@
 // through a row of the target. Skips non-selected areas.
 // Requires the "filterMgr" variable.
 #define FILTER_LOOP_THROUGH_ROW_BEGIN(Type)                                                        \
-  const Target target = filterMgr->getTarget();                                                    \
+  [[maybe_unused]] const Target target = filterMgr->getTarget();                                   \
   auto src_address = (const Type*)filterMgr->getSourceAddress();                                   \
   auto dst_address = (Type*)filterMgr->getDestinationAddress();                                    \
   int x = filterMgr->x();                                                                          \
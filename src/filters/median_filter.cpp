@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2020  Igara Studio S.A.
+// Copyright (C) 2020-2026  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This program is distributed under the terms of
@@ -27,72 +27,130 @@ namespace filters {
 using namespace doc;
 
 namespace {
-struct GetPixelsDelegateRgba {
-  std::vector<std::vector<uint8_t>>& channel;
-  int c;
 
-  GetPixelsDelegateRgba(std::vector<std::vector<uint8_t>>& channel) : channel(channel) {}
+// Delegates for get_neighboring_pixels() that accumulate one column
+// of the sliding window into the per-channel histograms. With
+// sign=+1 a column enters the window, with sign=-1 it leaves it.
 
-  void reset() { c = 0; }
+struct HistogramColumnRgba {
+  std::vector<std::vector<int>>& histogram;
+  int sign;
+
+  HistogramColumnRgba(std::vector<std::vector<int>>& histogram) : histogram(histogram), sign(1) {}
 
   void operator()(RgbTraits::pixel_t color)
   {
-    channel[0][c] = rgba_getr(color);
-    channel[1][c] = rgba_getg(color);
-    channel[2][c] = rgba_getb(color);
-    channel[3][c] = rgba_geta(color);
-    c++;
+    histogram[0][rgba_getr(color)] += sign;
+    histogram[1][rgba_getg(color)] += sign;
+    histogram[2][rgba_getb(color)] += sign;
+    histogram[3][rgba_geta(color)] += sign;
   }
 };
 
-struct GetPixelsDelegateGrayscale {
-  std::vector<std::vector<uint8_t>>& channel;
-  int c;
-
-  GetPixelsDelegateGrayscale(std::vector<std::vector<uint8_t>>& channel) : channel(channel) {}
+struct HistogramColumnGrayscale {
+  std::vector<std::vector<int>>& histogram;
+  int sign;
 
-  void reset() { c = 0; }
+  HistogramColumnGrayscale(std::vector<std::vector<int>>& histogram)
+    : histogram(histogram)
+    , sign(1)
+  {
+  }
 
   void operator()(GrayscaleTraits::pixel_t color)
   {
-    channel[0][c] = graya_getv(color);
-    channel[1][c] = graya_geta(color);
-    c++;
+    histogram[0][graya_getv(color)] += sign;
+    histogram[1][graya_geta(color)] += sign;
   }
 };
 
-struct GetPixelsDelegateIndexed {
+struct HistogramColumnIndexed {
   const Palette* pal;
-  std::vector<std::vector<uint8_t>>& channel;
+  std::vector<std::vector<int>>& histogram;
   Target target;
-  int c;
+  int sign;
 
-  GetPixelsDelegateIndexed(const Palette* pal,
-                           std::vector<std::vector<uint8_t>>& channel,
-                           Target target)
+  HistogramColumnIndexed(const Palette* pal,
+                         std::vector<std::vector<int>>& histogram,
+                         Target target)
     : pal(pal)
-    , channel(channel)
+    , histogram(histogram)
     , target(target)
+    , sign(1)
   {
   }
 
-  void reset() { c = 0; }
-
   void operator()(IndexedTraits::pixel_t color)
   {
     if (target & TARGET_INDEX_CHANNEL) {
-      channel[0][c] = color;
+      histogram[0][color] += sign;
     }
     else {
       color_t rgb = pal->getEntry(color);
-      channel[0][c] = rgba_getr(rgb);
-      channel[1][c] = rgba_getg(rgb);
-      channel[2][c] = rgba_getb(rgb);
-      channel[3][c] = rgba_geta(rgb);
+      histogram[0][rgba_getr(rgb)] += sign;
+      histogram[1][rgba_getg(rgb)] += sign;
+      histogram[2][rgba_getb(rgb)] += sign;
+      histogram[3][rgba_geta(rgb)] += sign;
     }
-    c++;
   }
 };
+
+// Moves the sliding window to be centered in (x, y), updating the
+// histograms incrementally: if we are at the pixel next to the
+// previous one, one column leaves the window and one column enters it
+// (cost O(height) instead of O(width*height)). Columns are gathered
+// with get_neighboring_pixels() using a 1-pixel wide matrix, so edge
+// clamping and tiled modes behave exactly like the full 2D gather.
+template<typename Traits, typename Delegate>
+void update_window_histograms(const Image* src,
+                              const int x,
+                              const int y,
+                              const int width,
+                              const int height,
+                              const TiledMode tiledMode,
+                              int& histX,
+                              int& histY,
+                              std::vector<std::vector<int>>& histogram,
+                              Delegate& delegate)
+{
+  const int firstCol = x - width / 2;
+
+  auto column = [&](int col, int sign) {
+    delegate.sign = sign;
+    get_neighboring_pixels<Traits>(src, col, y, 1, height, 0, height / 2, tiledMode, delegate);
+  };
+
+  if (y == histY && x == histX + 1) {
+    column(firstCol - 1, -1);
+    column(firstCol + width - 1, +1);
+  }
+  else {
+    // First pixel of the row (or a gap from skipped pixels): rebuild
+    // the whole window.
+    for (auto& channel : histogram)
+      std::fill(channel.begin(), channel.end(), 0);
+    for (int dx = 0; dx < width; ++dx)
+      column(firstCol + dx, +1);
+  }
+
+  histX = x;
+  histY = y;
+}
+
+// Returns the value in the given position of the sorted sequence
+// represented by the histogram (medianPos = ncolors/2, as the old
+// sort-based implementation took sorted[ncolors/2]).
+inline int histogram_median(const std::vector<int>& histogram, const int medianPos)
+{
+  int accum = 0;
+  for (int value = 0; value < 256; ++value) {
+    accum += histogram[value];
+    if (accum > medianPos)
+      return value;
+  }
+  return 255;
+}
+
 }; // namespace
 
 MedianFilter::MedianFilter()
@@ -100,7 +158,9 @@ MedianFilter::MedianFilter()
   , m_width(1)
   , m_height(1)
   , m_ncolors(0)
-  , m_channel(4)
+  , m_histogram(4)
+  , m_histX(-1)
+  , m_histY(-1)
 {
 }
 
@@ -119,7 +179,7 @@ void MedianFilter::setSize(int width, int height)
   m_ncolors = width * height;
 
   for (int c = 0; c < 4; ++c)
-    m_channel[c].resize(m_ncolors);
+    m_histogram[c].assign(256, 0);
 }
 
 const char* MedianFilter::getName()
@@ -130,49 +190,43 @@ const char* MedianFilter::getName()
 void MedianFilter::applyToRgba(FilterManager* filterMgr)
 {
   const Image* src = filterMgr->getSourceImage();
+  const int medianPos = m_ncolors / 2;
   int color, r, g, b, a;
-  GetPixelsDelegateRgba delegate(m_channel);
+  HistogramColumnRgba delegate(m_histogram);
+  m_histY = -1; // Force a full window rebuild for this row
 
   FILTER_LOOP_THROUGH_ROW_BEGIN(uint32_t)
   {
-    delegate.reset();
-    get_neighboring_pixels<RgbTraits>(src,
-                                      x,
-                                      y,
-                                      m_width,
-                                      m_height,
-                                      m_width / 2,
-                                      m_height / 2,
-                                      m_tiledMode,
-                                      delegate);
+    update_window_histograms<RgbTraits>(src,
+                                        x,
+                                        y,
+                                        m_width,
+                                        m_height,
+                                        m_tiledMode,
+                                        m_histX,
+                                        m_histY,
+                                        m_histogram,
+                                        delegate);
 
     color = get_pixel_fast<RgbTraits>(src, x, y);
 
-    if (target & TARGET_RED_CHANNEL) {
-      std::sort(m_channel[0].begin(), m_channel[0].end());
-      r = m_channel[0][m_ncolors / 2];
-    }
+    if (target & TARGET_RED_CHANNEL)
+      r = histogram_median(m_histogram[0], medianPos);
     else
       r = rgba_getr(color);
 
-    if (target & TARGET_GREEN_CHANNEL) {
-      std::sort(m_channel[1].begin(), m_channel[1].end());
-      g = m_channel[1][m_ncolors / 2];
-    }
+    if (target & TARGET_GREEN_CHANNEL)
+      g = histogram_median(m_histogram[1], medianPos);
     else
       g = rgba_getg(color);
 
-    if (target & TARGET_BLUE_CHANNEL) {
-      std::sort(m_channel[2].begin(), m_channel[2].end());
-      b = m_channel[2][m_ncolors / 2];
-    }
+    if (target & TARGET_BLUE_CHANNEL)
+      b = histogram_median(m_histogram[2], medianPos);
     else
       b = rgba_getb(color);
 
-    if (target & TARGET_ALPHA_CHANNEL) {
-      std::sort(m_channel[3].begin(), m_channel[3].end());
-      a = m_channel[3][m_ncolors / 2];
-    }
+    if (target & TARGET_ALPHA_CHANNEL)
+      a = histogram_median(m_histogram[3], medianPos);
     else
       a = rgba_geta(color);
 
@@ -184,35 +238,33 @@ void MedianFilter::applyToRgba(FilterManager* filterMgr)
 void MedianFilter::applyToGrayscale(FilterManager* filterMgr)
 {
   const Image* src = filterMgr->getSourceImage();
+  const int medianPos = m_ncolors / 2;
   int color, k, a;
-  GetPixelsDelegateGrayscale delegate(m_channel);
+  HistogramColumnGrayscale delegate(m_histogram);
+  m_histY = -1; // Force a full window rebuild for this row
 
   FILTER_LOOP_THROUGH_ROW_BEGIN(uint16_t)
   {
-    delegate.reset();
-    get_neighboring_pixels<GrayscaleTraits>(src,
-                                            x,
-                                            y,
-                                            m_width,
-                                            m_height,
-                                            m_width / 2,
-                                            m_height / 2,
-                                            m_tiledMode,
-                                            delegate);
+    update_window_histograms<GrayscaleTraits>(src,
+                                              x,
+                                              y,
+                                              m_width,
+                                              m_height,
+                                              m_tiledMode,
+                                              m_histX,
+                                              m_histY,
+                                              m_histogram,
+                                              delegate);
 
     color = get_pixel_fast<GrayscaleTraits>(src, x, y);
 
-    if (target & TARGET_GRAY_CHANNEL) {
-      std::sort(m_channel[0].begin(), m_channel[0].end());
-      k = m_channel[0][m_ncolors / 2];
-    }
+    if (target & TARGET_GRAY_CHANNEL)
+      k = histogram_median(m_histogram[0], medianPos);
     else
       k = graya_getv(color);
 
-    if (target & TARGET_ALPHA_CHANNEL) {
-      std::sort(m_channel[1].begin(), m_channel[1].end());
-      a = m_channel[1][m_ncolors / 2];
-    }
+    if (target & TARGET_ALPHA_CHANNEL)
+      a = histogram_median(m_histogram[1], medianPos);
     else
       a = graya_geta(color);
 
@@ -226,55 +278,48 @@ void MedianFilter::applyToIndexed(FilterManager* filterMgr)
   const Image* src = filterMgr->getSourceImage();
   const Palette* pal = filterMgr->getIndexedData()->getPalette();
   const RgbMap* rgbmap = filterMgr->getIndexedData()->getRgbMap();
+  const int medianPos = m_ncolors / 2;
   int color, r, g, b, a;
-  GetPixelsDelegateIndexed delegate(pal, m_channel, filterMgr->getTarget());
+  HistogramColumnIndexed delegate(pal, m_histogram, filterMgr->getTarget());
+  m_histY = -1; // Force a full window rebuild for this row
 
   FILTER_LOOP_THROUGH_ROW_BEGIN(uint8_t)
   {
-    delegate.reset();
-    get_neighboring_pixels<IndexedTraits>(src,
-                                          x,
-                                          y,
-                                          m_width,
-                                          m_height,
-                                          m_width / 2,
-                                          m_height / 2,
-                                          m_tiledMode,
-                                          delegate);
+    update_window_histograms<IndexedTraits>(src,
+                                            x,
+                                            y,
+                                            m_width,
+                                            m_height,
+                                            m_tiledMode,
+                                            m_histX,
+                                            m_histY,
+                                            m_histogram,
+                                            delegate);
 
     if (target & TARGET_INDEX_CHANNEL) {
-      std::sort(m_channel[0].begin(), m_channel[0].end());
-      *dst_address = m_channel[0][m_ncolors / 2];
+      *dst_address = histogram_median(m_histogram[0], medianPos);
     }
     else {
       color = get_pixel_fast<IndexedTraits>(src, x, y);
       color = pal->getEntry(color);
 
-      if (target & TARGET_RED_CHANNEL) {
-        std::sort(m_channel[0].begin(), m_channel[0].end());
-        r = m_channel[0][m_ncolors / 2];
-      }
+      if (target & TARGET_RED_CHANNEL)
+        r = histogram_median(m_histogram[0], medianPos);
       else
         r = rgba_getr(color);
 
-      if (target & TARGET_GREEN_CHANNEL) {
-        std::sort(m_channel[1].begin(), m_channel[1].end());
-        g = m_channel[1][m_ncolors / 2];
-      }
+      if (target & TARGET_GREEN_CHANNEL)
+        g = histogram_median(m_histogram[1], medianPos);
       else
-        g = rgba_getg(pal->getEntry(color));
+        g = rgba_getg(color);
 
-      if (target & TARGET_BLUE_CHANNEL) {
-        std::sort(m_channel[2].begin(), m_channel[2].end());
-        b = m_channel[2][m_ncolors / 2];
-      }
+      if (target & TARGET_BLUE_CHANNEL)
+        b = histogram_median(m_histogram[2], medianPos);
       else
         b = rgba_getb(color);
 
-      if (target & TARGET_ALPHA_CHANNEL) {
-        std::sort(m_channel[3].begin(), m_channel[3].end());
-        a = m_channel[3][m_ncolors / 2];
-      }
+      if (target & TARGET_ALPHA_CHANNEL)
+        a = histogram_median(m_histogram[3], medianPos);
       else
         a = rgba_geta(color);
 
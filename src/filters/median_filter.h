@@ -38,7 +38,12 @@ private:
   int m_width;
   int m_height;
   int m_ncolors;
-  std::vector<std::vector<uint8_t>> m_channel;
+  // Per-channel 256-bin histograms of the sliding window, updated
+  // incrementally column by column, plus the window position they
+  // represent (see update_window_histograms() in median_filter.cpp).
+  std::vector<std::vector<int>> m_histogram;
+  int m_histX;
+  int m_histY;
 };
 
 } // namespace filters
@@ -1,5 +1,5 @@
 // Aseprite
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 //
 // This program is distributed under the terms of
 // the End-User License Agreement for Aseprite.
@@ -11,13 +11,15 @@
 #include "filters/outline_filter.h"
 
 #include "doc/image.h"
+#include "doc/image_traits.h"
 #include "doc/palette.h"
 #include "doc/rgbmap.h"
 #include "filters/filter_indexed_data.h"
 #include "filters/filter_manager.h"
-#include "filters/neighboring_pixels.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <vector>
 
 namespace filters {
 
@@ -25,63 +27,119 @@ using namespace doc;
 
 namespace {
 
-struct GetPixelsDelegate {
-  color_t bgColor;
-  int transparent; // Transparent pixels
-  int opaque;      // Opaque pixels
-  int matrix;
-  int bit;
+// One bit per column of the sprite row (1 = opaque matte), so the
+// "is there some opaque/transparent pixel around?" question is
+// answered with bitwise ops over 64 columns per word instead of
+// visiting the eight neighbors of each pixel.
+using BitRow = std::vector<uint64_t>;
 
-  void init(const color_t bgColor, const OutlineFilter::Matrix matrix)
-  {
-    this->bgColor = bgColor;
-    this->matrix = (int)matrix;
-  }
-
-  void reset()
-  {
-    transparent = opaque = 0;
-    bit = 1;
-  }
-};
+inline bool get_bit(const BitRow& row, const int x)
+{
+  return (row[x >> 6] >> (x & 63)) & 1;
+}
 
-struct GetPixelsDelegateRgba : public GetPixelsDelegate {
-  void operator()(RgbTraits::pixel_t color)
-  {
-    if (rgba_geta(color) == 0 || color == bgColor)
-      transparent += (matrix & bit ? 1 : 0);
-    else
-      opaque += (matrix & bit ? 1 : 0);
-    bit <<= 1;
+// Fills "dst" so its bit x is the bit (x-1) of "src" (i.e. the matte
+// of the left neighbor of each column), resolving column -1 with the
+// given X-axis tiling (wrap) or clamping to column 0 like
+// get_neighboring_pixels() does.
+void left_neighbors(const BitRow& src, BitRow& dst, const int w, const bool tiledX)
+{
+  uint64_t carry = 0;
+  for (std::size_t i = 0; i < src.size(); ++i) {
+    const uint64_t v = src[i];
+    dst[i] = (v << 1) | carry;
+    carry = (v >> 63);
   }
-};
+  if (tiledX ? get_bit(src, w - 1) : get_bit(src, 0))
+    dst[0] |= 1;
+  else
+    dst[0] &= ~uint64_t(1);
+}
 
-struct GetPixelsDelegateGrayscale : public GetPixelsDelegate {
-  void operator()(GrayscaleTraits::pixel_t color)
-  {
-    if (graya_geta(color) == 0 || color == bgColor)
-      transparent += (matrix & bit ? 1 : 0);
-    else
-      opaque += (matrix & bit ? 1 : 0);
-    bit <<= 1;
+// Like left_neighbors() but bit x takes the bit (x+1) of "src",
+// resolving column w with tiling or clamping to column w-1.
+void right_neighbors(const BitRow& src, BitRow& dst, const int w, const bool tiledX)
+{
+  uint64_t carry = 0;
+  for (int i = int(src.size()) - 1; i >= 0; --i) {
+    const uint64_t v = src[i];
+    dst[i] = (v >> 1) | (carry << 63);
+    carry = (v & 1);
   }
-};
+  const int last = w - 1;
+  if (tiledX ? get_bit(src, 0) : get_bit(src, w - 1))
+    dst[last >> 6] |= (uint64_t(1) << (last & 63));
+  else
+    dst[last >> 6] &= ~(uint64_t(1) << (last & 63));
+}
 
-struct GetPixelsDelegateIndexed : public GetPixelsDelegate {
-  const Palette* pal;
+// Builds, for the given row, one bitmask telling which columns have
+// some opaque neighbor selected by the matrix, and another one for
+// transparent neighbors ("transparent" meaning zero alpha or the
+// filter background color, as the old per-pixel delegates did).
+template<typename Traits, typename IsOpaque>
+void build_neighbor_masks(const Image* src,
+                          const int y,
+                          const int matrix,
+                          const TiledMode tiledMode,
+                          const IsOpaque& isOpaque,
+                          BitRow& anyOpaque,
+                          BitRow& anyTransparent)
+{
+  const int w = src->width();
+  const int h = src->height();
+  const bool tiledX = (int(tiledMode) & int(TiledMode::X_AXIS)) != 0;
+  const bool tiledY = (int(tiledMode) & int(TiledMode::Y_AXIS)) != 0;
+  const std::size_t words = (w + 63) / 64;
+
+  anyOpaque.assign(words, 0);
+  anyTransparent.assign(words, 0);
+
+  BitRow matte(words), trans(words), shifted(words);
+
+  for (int dy = 0; dy < 3; ++dy) {
+    // Matrix bits are numbered by rows (bit 0 = top-left neighbor),
+    // so these are the left/center/right bits of this matrix row.
+    const int rowBits = (matrix >> (3 * dy)) & 7;
+    if (!rowBits)
+      continue;
+
+    int gety = y + dy - 1;
+    if (gety < 0)
+      gety = (tiledY ? h - 1 : 0);
+    else if (gety >= h)
+      gety = (tiledY ? 0 : h - 1);
+
+    std::fill(matte.begin(), matte.end(), 0);
+    auto address = reinterpret_cast<typename Traits::const_address_t>(src->getPixelAddress(0, gety));
+    for (int x = 0; x < w; ++x, ++address) {
+      if (isOpaque(*address))
+        matte[x >> 6] |= (uint64_t(1) << (x & 63));
+    }
+    for (std::size_t i = 0; i < words; ++i)
+      trans[i] = ~matte[i];
 
-  GetPixelsDelegateIndexed(const Palette* pal) : pal(pal) {}
+    for (int pass = 0; pass < 2; ++pass) {
+      const BitRow& bits = (pass == 0 ? matte : trans);
+      BitRow& any = (pass == 0 ? anyOpaque : anyTransparent);
 
-  void operator()(IndexedTraits::pixel_t color)
-  {
-    color_t rgba = pal->getEntry(color);
-    if (rgba_geta(rgba) == 0 || color == bgColor)
-      transparent += (matrix & bit ? 1 : 0);
-    else
-      opaque += (matrix & bit ? 1 : 0);
-    bit <<= 1;
+      if (rowBits & 1) {
+        left_neighbors(bits, shifted, w, tiledX);
+        for (std::size_t i = 0; i < words; ++i)
+          any[i] |= shifted[i];
+      }
+      if (rowBits & 2) {
+        for (std::size_t i = 0; i < words; ++i)
+          any[i] |= bits[i];
+      }
+      if (rowBits & 4) {
+        right_neighbors(bits, shifted, w, tiledX);
+        for (std::size_t i = 0; i < words; ++i)
+          any[i] |= shifted[i];
+      }
+    }
   }
-};
+}
 
 } // namespace
 
@@ -102,24 +160,31 @@ const char* OutlineFilter::getName()
 void OutlineFilter::applyToRgba(FilterManager* filterMgr)
 {
   const Image* src = filterMgr->getSourceImage();
-  int r, g, b, a, n;
+  int r, g, b, a;
   color_t c;
   bool isTransparent;
 
-  GetPixelsDelegateRgba delegate;
-  delegate.init(m_bgColor, m_matrix);
+  const color_t bgColor = m_bgColor;
+  const auto isOpaque = [bgColor](const RgbTraits::pixel_t color) {
+    return (rgba_geta(color) != 0 && color != bgColor);
+  };
+  BitRow anyOpaque, anyTransparent;
+  build_neighbor_masks<RgbTraits>(src,
+                                  filterMgr->y(),
+                                  (int)m_matrix,
+                                  m_tiledMode,
+                                  isOpaque,
+                                  anyOpaque,
+                                  anyTransparent);
+  const BitRow& outlined = (m_place == Place::Outside ? anyOpaque : anyTransparent);
 
   FILTER_LOOP_THROUGH_ROW_BEGIN(uint32_t)
   {
-    delegate.reset();
-    get_neighboring_pixels<RgbTraits>(src, x, y, 3, 3, 1, 1, m_tiledMode, delegate);
-
     c = *src_address;
-    n = (m_place == Place::Outside ? delegate.opaque : delegate.transparent);
     isTransparent = (rgba_geta(c) == 0 || c == m_bgColor);
 
-    if ((n >= 1) && ((m_place == Place::Outside && isTransparent) ||
-                     (m_place == Place::Inside && !isTransparent))) {
+    if (get_bit(outlined, x) && ((m_place == Place::Outside && isTransparent) ||
+                                 (m_place == Place::Inside && !isTransparent))) {
       r = (target & TARGET_RED_CHANNEL ? rgba_getr(m_color) : rgba_getr(c));
       g = (target & TARGET_GREEN_CHANNEL ? rgba_getg(m_color) : rgba_getg(c));
       b = (target & TARGET_BLUE_CHANNEL ? rgba_getb(m_color) : rgba_getb(c));
@@ -135,24 +200,31 @@ void OutlineFilter::applyToRgba(FilterManager* filterMgr)
 void OutlineFilter::applyToGrayscale(FilterManager* filterMgr)
 {
   const Image* src = filterMgr->getSourceImage();
-  int k, a, n;
+  int k, a;
   color_t c;
   bool isTransparent;
 
-  GetPixelsDelegateGrayscale delegate;
-  delegate.init(m_bgColor, m_matrix);
+  const color_t bgColor = m_bgColor;
+  const auto isOpaque = [bgColor](const GrayscaleTraits::pixel_t color) {
+    return (graya_geta(color) != 0 && color != bgColor);
+  };
+  BitRow anyOpaque, anyTransparent;
+  build_neighbor_masks<GrayscaleTraits>(src,
+                                        filterMgr->y(),
+                                        (int)m_matrix,
+                                        m_tiledMode,
+                                        isOpaque,
+                                        anyOpaque,
+                                        anyTransparent);
+  const BitRow& outlined = (m_place == Place::Outside ? anyOpaque : anyTransparent);
 
   FILTER_LOOP_THROUGH_ROW_BEGIN(uint16_t)
   {
-    delegate.reset();
-    get_neighboring_pixels<GrayscaleTraits>(src, x, y, 3, 3, 1, 1, m_tiledMode, delegate);
-
     c = *src_address;
-    n = (m_place == Place::Outside ? delegate.opaque : delegate.transparent);
     isTransparent = (graya_geta(c) == 0 || c == m_bgColor);
 
-    if ((n >= 1) && ((m_place == Place::Outside && isTransparent) ||
-                     (m_place == Place::Inside && !isTransparent))) {
+    if (get_bit(outlined, x) && ((m_place == Place::Outside && isTransparent) ||
+                                 (m_place == Place::Inside && !isTransparent))) {
       k = (target & TARGET_GRAY_CHANNEL ? graya_getv(m_color) : graya_getv(c));
       a = (target & TARGET_ALPHA_CHANNEL ? graya_geta(m_color) : graya_geta(c));
       c = graya(k, a);
@@ -168,20 +240,27 @@ void OutlineFilter::applyToIndexed(FilterManager* filterMgr)
   const Image* src = filterMgr->getSourceImage();
   const Palette* pal = filterMgr->getIndexedData()->getPalette();
   const RgbMap* rgbmap = filterMgr->getIndexedData()->getRgbMap();
-  int r, g, b, a, n;
+  int r, g, b, a;
   color_t c;
   bool isTransparent;
 
-  GetPixelsDelegateIndexed delegate(pal);
-  delegate.init(m_bgColor, m_matrix);
+  const color_t bgColor = m_bgColor;
+  const auto isOpaque = [bgColor, pal](const IndexedTraits::pixel_t color) {
+    return (rgba_geta(pal->getEntry(color)) != 0 && color != bgColor);
+  };
+  BitRow anyOpaque, anyTransparent;
+  build_neighbor_masks<IndexedTraits>(src,
+                                      filterMgr->y(),
+                                      (int)m_matrix,
+                                      m_tiledMode,
+                                      isOpaque,
+                                      anyOpaque,
+                                      anyTransparent);
+  const BitRow& outlined = (m_place == Place::Outside ? anyOpaque : anyTransparent);
 
   FILTER_LOOP_THROUGH_ROW_BEGIN(uint8_t)
   {
-    delegate.reset();
-    get_neighboring_pixels<IndexedTraits>(src, x, y, 3, 3, 1, 1, m_tiledMode, delegate);
-
     c = *src_address;
-    n = (m_place == Place::Outside ? delegate.opaque : delegate.transparent);
 
     if (target & TARGET_INDEX_CHANNEL) {
       isTransparent = (c == m_bgColor);
@@ -190,8 +269,8 @@ void OutlineFilter::applyToIndexed(FilterManager* filterMgr)
       isTransparent = (rgba_geta(pal->getEntry(c)) == 0 || c == m_bgColor);
     }
 
-    if ((n >= 1) && ((m_place == Place::Outside && isTransparent) ||
-                     (m_place == Place::Inside && !isTransparent))) {
+    if (get_bit(outlined, x) && ((m_place == Place::Outside && isTransparent) ||
+                                 (m_place == Place::Inside && !isTransparent))) {
       if (target & TARGET_INDEX_CHANNEL) {
         c = m_color;
       }
@@ -44,6 +44,7 @@ public:
   void applyToRgba(FilterManager* filterMgr);
   void applyToGrayscale(FilterManager* filterMgr);
   void applyToIndexed(FilterManager* filterMgr);
+  bool supportsParallelRows() const override { return true; }
 
 private:
   Place m_place;
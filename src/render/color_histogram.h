@@ -107,6 +107,36 @@ public:
     }
   }
 
+  // Accumulates all the samples of "other" into this histogram (used
+  // to merge per-thread histograms after a parallel counting phase).
+  void merge(const ColorHistogram& other)
+  {
+    for (std::size_t i = 0; i < m_histogram.size(); ++i) {
+      if (m_histogram[i] < std::numeric_limits<std::size_t>::max() - other.m_histogram[i])
+        m_histogram[i] += other.m_histogram[i];
+      else
+        m_histogram[i] = std::numeric_limits<std::size_t>::max();
+    }
+
+    if (!other.m_useHighPrecision)
+      m_useHighPrecision = false;
+
+    if (m_useHighPrecision) {
+      for (doc::color_t color : other.m_highPrecision) {
+        auto it = std::find(m_highPrecision.begin(), m_highPrecision.end(), color);
+        if (it == m_highPrecision.end()) {
+          if (m_highPrecision.size() < 256) {
+            m_highPrecision.push_back(color);
+          }
+          else {
+            m_useHighPrecision = false;
+            break;
+          }
+        }
+      }
+    }
+  }
+
   bool isHighPrecision() { return m_useHighPrecision; }
   int highPrecisionSize() { return m_highPrecision.size(); }
 
@@ -1,5 +1,5 @@
 // Aseprite Render Library
-// Copyright (c) 2019-2020 Igara Studio S.A.
+// Copyright (c) 2019-2026 Igara Studio S.A.
 // Copyright (c) 2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -13,10 +13,171 @@
 
 #include "base/vector2d.h"
 #include "doc/image.h"
+#include "doc/primitives_fast.h"
 #include "render/dithering_matrix.h"
 
+#include <cmath>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+  #define RENDER_GRADIENT_SSE2 1
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #define RENDER_GRADIENT_NEON 1
+  #include <arm_neon.h>
+#endif
+
 namespace render {
 
+namespace {
+
+// The gradient projection is affine in x/y, so instead of projecting
+// each pixel onto the gradient vector, each row computes its starting
+// projection and walks it with a per-pixel delta. The span helpers
+// below then turn a row of projections into pixels.
+
+// f[i] = f0 + i*df
+void affine_span(float* f, const int n, const double f0, const double df)
+{
+  double v = f0;
+  for (int i = 0; i < n; ++i, v += df)
+    f[i] = float(v);
+}
+
+// f[i] = sqrt((dx0 + i*ddx)^2 + dy2), i.e. the distance used by the
+// radial gradient (dy2 is constant per row).
+void sqrt_span(float* f, const int n, const double dx0, const double ddx, const double dy2)
+{
+  int i = 0;
+#if RENDER_GRADIENT_SSE2
+  __m128 dx = _mm_setr_ps(float(dx0),
+                          float(dx0 + ddx),
+                          float(dx0 + 2 * ddx),
+                          float(dx0 + 3 * ddx));
+  const __m128 step = _mm_set1_ps(float(4 * ddx));
+  const __m128 vdy2 = _mm_set1_ps(float(dy2));
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(f + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), vdy2)));
+    dx = _mm_add_ps(dx, step);
+  }
+#elif RENDER_GRADIENT_NEON
+  float dx0s[4] = { float(dx0), float(dx0 + ddx), float(dx0 + 2 * ddx), float(dx0 + 3 * ddx) };
+  float32x4_t dx = vld1q_f32(dx0s);
+  const float32x4_t step = vdupq_n_f32(float(4 * ddx));
+  const float32x4_t vdy2 = vdupq_n_f32(float(dy2));
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(f + i, vsqrtq_f32(vmlaq_f32(vdy2, dx, dx)));
+    dx = vaddq_f32(dx, step);
+  }
+#endif
+  for (; i < n; ++i) {
+    const double dx1 = dx0 + ddx * i;
+    f[i] = float(std::sqrt(dx1 * dx1 + dy2));
+  }
+}
+
+// Converts projections into interpolation weights in 256ths
+// (clamping the ends of the gradient to the stop colors).
+void weights_span(uint16_t* w, const float* f, const int n)
+{
+  for (int i = 0; i < n; ++i) {
+    const float v = f[i];
+    w[i] = (v <= 0.0f ? 0 : v >= 1.0f ? 256 : uint16_t(v * 256.0f + 0.5f));
+  }
+}
+
+// dst[i] = c0 + (c1-c0) * w[i]/256, per RGBA channel.
+void blend_span(uint32_t* dst, const uint16_t* w, const int n, const doc::color_t c0, const doc::color_t c1)
+{
+  int i = 0;
+#if RENDER_GRADIENT_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  // Each stop color duplicated in two 4x16-bit halves to blend two
+  // pixels per iteration.
+  const __m128i vc0 = _mm_unpacklo_epi8(_mm_set1_epi32(int(c0)), zero);
+  const __m128i vc1 = _mm_unpacklo_epi8(_mm_set1_epi32(int(c1)), zero);
+  const __m128i v256 = _mm_set1_epi16(256);
+  for (; i + 2 <= n; i += 2) {
+    const __m128i wv = _mm_unpacklo_epi64(_mm_set1_epi16(w[i]), _mm_set1_epi16(w[i + 1]));
+    const __m128i iv = _mm_sub_epi16(v256, wv);
+    // Each 16-bit lane is at most 255*256, so the sum fits.
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(vc0, iv), _mm_mullo_epi16(vc1, wv));
+    t = _mm_srli_epi16(t, 8);
+    _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(t, t));
+  }
+#elif RENDER_GRADIENT_NEON
+  const uint8x8_t c0x2 = vreinterpret_u8_u64(vdup_n_u64(uint64_t(c0) | (uint64_t(c0) << 32)));
+  const uint8x8_t c1x2 = vreinterpret_u8_u64(vdup_n_u64(uint64_t(c1) | (uint64_t(c1) << 32)));
+  const uint16x8_t vc0 = vmovl_u8(c0x2);
+  const uint16x8_t vc1 = vmovl_u8(c1x2);
+  const uint16x8_t v256 = vdupq_n_u16(256);
+  for (; i + 2 <= n; i += 2) {
+    const uint16x8_t wv = vcombine_u16(vdup_n_u16(w[i]), vdup_n_u16(w[i + 1]));
+    const uint16x8_t iv = vsubq_u16(v256, wv);
+    uint16x8_t t = vmlaq_u16(vmulq_u16(vc0, iv), vc1, wv);
+    t = vshrq_n_u16(t, 8);
+    vst1_u8((uint8_t*)(dst + i), vmovn_u16(t));
+  }
+#endif
+  for (; i < n; ++i) {
+    const int wi = w[i];
+    const int vi = 256 - wi;
+    dst[i] = doc::rgba((doc::rgba_getr(c0) * vi + doc::rgba_getr(c1) * wi) >> 8,
+                       (doc::rgba_getg(c0) * vi + doc::rgba_getg(c1) * wi) >> 8,
+                       (doc::rgba_getb(c0) * vi + doc::rgba_getb(c1) * wi) >> 8,
+                       (doc::rgba_geta(c0) * vi + doc::rgba_geta(c1) * wi) >> 8);
+  }
+}
+
+// dst[i] = (f[i] < thr[i] ? c0 : c1), used for dithered gradients
+// where thr is the dithering matrix row converted to thresholds.
+void select_span(uint32_t* dst,
+                 const float* f,
+                 const float* thr,
+                 const int n,
+                 const doc::color_t c0,
+                 const doc::color_t c1)
+{
+  int i = 0;
+#if RENDER_GRADIENT_SSE2
+  const __m128i vc0 = _mm_set1_epi32(int(c0));
+  const __m128i vc1 = _mm_set1_epi32(int(c1));
+  for (; i + 4 <= n; i += 4) {
+    const __m128i mask =
+      _mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(f + i), _mm_loadu_ps(thr + i)));
+    _mm_storeu_si128((__m128i*)(dst + i),
+                     _mm_or_si128(_mm_and_si128(mask, vc0), _mm_andnot_si128(mask, vc1)));
+  }
+#elif RENDER_GRADIENT_NEON
+  const uint32x4_t vc0 = vdupq_n_u32(c0);
+  const uint32x4_t vc1 = vdupq_n_u32(c1);
+  for (; i + 4 <= n; i += 4) {
+    const uint32x4_t mask = vcltq_f32(vld1q_f32(f + i), vld1q_f32(thr + i));
+    vst1q_u32(dst + i, vbslq_u32(mask, vc0, vc1));
+  }
+#endif
+  for (; i < n; ++i)
+    dst[i] = (f[i] < thr[i] ? c0 : c1);
+}
+
+// One threshold row per dithering matrix row, tiled to the image
+// width, so the inner loop doesn't evaluate the matrix modulo per
+// pixel: f*(maxValue+2) < m+1  <=>  f < (m+1)/(maxValue+2).
+std::vector<std::vector<float>> make_threshold_rows(const render::DitheringMatrix& matrix,
+                                                    const int width)
+{
+  const float div = float(matrix.maxValue() + 2);
+  std::vector<std::vector<float>> rows(matrix.rows());
+  for (int r = 0; r < matrix.rows(); ++r) {
+    rows[r].resize(width);
+    for (int x = 0; x < width; ++x)
+      rows[r][x] = float(matrix(r, x) + 1) / div;
+  }
+  return rows;
+}
+
+} // anonymous namespace
+
 void render_rgba_gradient(doc::Image* img,
                           const gfx::Point imgPos,
                           const gfx::Point p0,
@@ -72,53 +233,39 @@ void render_rgba_linear_gradient(doc::Image* img,
     c1 = (c0 & doc::rgba_rgb_mask);
   }
 
-  const uint8_t r0 = doc::rgba_getr(c0);
-  const uint8_t g0 = doc::rgba_getg(c0);
-  const uint8_t b0 = doc::rgba_getb(c0);
-  const uint8_t a0 = doc::rgba_geta(c0);
-
-  const uint8_t r1 = doc::rgba_getr(c1);
-  const uint8_t g1 = doc::rgba_getg(c1);
-  const uint8_t b1 = doc::rgba_getb(c1);
-  const uint8_t a1 = doc::rgba_geta(c1);
-
-  doc::LockImageBits<doc::RgbTraits> bits(img);
-  auto it = bits.begin();
   const int width = img->width();
   const int height = img->height();
 
+  // Projection of the first pixel of each row onto the gradient
+  // vector, and its per-column/per-row deltas.
+  const double dfdx = w.x / wmag;
+  const double dfdy = w.y / wmag;
+  double frow = ((imgPos.x - u.x) * w.x + (imgPos.y - u.y) * w.y) / wmag;
+
+  std::vector<float> fbuf(width);
+
   if (matrix.rows() == 1 && matrix.cols() == 1) {
-    for (int y = 0; y < height; ++y) {
-      for (int x = 0; x < width; ++x, ++it) {
-        base::Vector2d<double> q(imgPos.x + x, imgPos.y + y);
-        q -= u;
-        double f = (q * w) / wmag;
-
-        doc::color_t c;
-        if (f < 0.0)
-          c = c0;
-        else if (f > 1.0)
-          c = c1;
-        else {
-          c = doc::rgba(int(r0 + f * (r1 - r0) + 1e-7),
-                        int(g0 + f * (g1 - g0) + 1e-7),
-                        int(b0 + f * (b1 - b0) + 1e-7),
-                        int(a0 + f * (a1 - a0) + 1e-7));
-        }
-
-        *it = c;
-      }
+    std::vector<uint16_t> wbuf(width);
+    for (int y = 0; y < height; ++y, frow += dfdy) {
+      affine_span(fbuf.data(), width, frow, dfdx);
+      weights_span(wbuf.data(), fbuf.data(), width);
+      blend_span(doc::get_pixel_address_fast<doc::RgbTraits>(img, 0, y),
+                 wbuf.data(),
+                 width,
+                 c0,
+                 c1);
     }
   }
   else {
-    for (int y = 0; y < height; ++y) {
-      for (int x = 0; x < width; ++x, ++it) {
-        base::Vector2d<double> q(imgPos.x + x, imgPos.y + y);
-        q -= u;
-        double f = (q * w) / wmag;
-
-        *it = (f * (matrix.maxValue() + 2) < matrix(y, x) + 1 ? c0 : c1);
-      }
+    const auto thrRows = make_threshold_rows(matrix, width);
+    for (int y = 0; y < height; ++y, frow += dfdy) {
+      affine_span(fbuf.data(), width, frow, dfdx);
+      select_span(doc::get_pixel_address_fast<doc::RgbTraits>(img, 0, y),
+                  fbuf.data(),
+                  thrRows[y % matrix.rows()].data(),
+                  width,
+                  c0,
+                  c1);
     }
   }
 }
@@ -157,57 +304,42 @@ void render_rgba_radial_gradient(doc::Image* img,
     c1 = (c0 & doc::rgba_rgb_mask);
   }
 
-  const uint8_t r0 = doc::rgba_getr(c0);
-  const uint8_t g0 = doc::rgba_getg(c0);
-  const uint8_t b0 = doc::rgba_getb(c0);
-  const uint8_t a0 = doc::rgba_geta(c0);
-
-  const uint8_t r1 = doc::rgba_getr(c1);
-  const uint8_t g1 = doc::rgba_getg(c1);
-  const uint8_t b1 = doc::rgba_getb(c1);
-  const uint8_t a1 = doc::rgba_geta(c1);
-
-  doc::LockImageBits<doc::RgbTraits> bits(img);
-  auto it = bits.begin();
   const int width = img->width();
   const int height = img->height();
 
+  // Distance from the gradient center in a space where the ellipse
+  // defined by p0/p1 is the unit circle (the x part advances by a
+  // constant delta along the row).
+  const base::Vector2d<double> center = (u + v) / 2;
+  const double ddx = 1.0 / std::fabs(w.x);
+  const double dx0 = (imgPos.x - center.x) / std::fabs(w.x);
+
+  std::vector<float> fbuf(width);
+
   if (matrix.rows() == 1 && matrix.cols() == 1) {
+    std::vector<uint16_t> wbuf(width);
     for (int y = 0; y < height; ++y) {
-      for (int x = 0; x < width; ++x, ++it) {
-        base::Vector2d<double> q(imgPos.x + x, imgPos.y + y);
-        q -= (u + v) / 2;
-        q.x /= std::fabs(w.x);
-        q.y /= std::fabs(w.y);
-        double f = std::sqrt(q.x * q.x + q.y * q.y);
-
-        doc::color_t c;
-        if (f < 0.0)
-          c = c0;
-        else if (f > 1.0)
-          c = c1;
-        else {
-          c = doc::rgba(int(r0 + f * (r1 - r0) + 1e-7),
-                        int(g0 + f * (g1 - g0) + 1e-7),
-                        int(b0 + f * (b1 - b0) + 1e-7),
-                        int(a0 + f * (a1 - a0) + 1e-7));
-        }
-
-        *it = c;
-      }
+      const double qy = (imgPos.y + y - center.y) / std::fabs(w.y);
+      sqrt_span(fbuf.data(), width, dx0, ddx, qy * qy);
+      weights_span(wbuf.data(), fbuf.data(), width);
+      blend_span(doc::get_pixel_address_fast<doc::RgbTraits>(img, 0, y),
+                 wbuf.data(),
+                 width,
+                 c0,
+                 c1);
     }
   }
   else {
+    const auto thrRows = make_threshold_rows(matrix, width);
     for (int y = 0; y < height; ++y) {
-      for (int x = 0; x < width; ++x, ++it) {
-        base::Vector2d<double> q(imgPos.x + x, imgPos.y + y);
-        q -= (u + v) / 2;
-        q.x /= std::fabs(w.x);
-        q.y /= std::fabs(w.y);
-        double f = std::sqrt(q.x * q.x + q.y * q.y);
-
-        *it = (f * (matrix.maxValue() + 2) < matrix(y, x) + 1 ? c0 : c1);
-      }
+      const double qy = (imgPos.y + y - center.y) / std::fabs(w.y);
+      sqrt_span(fbuf.data(), width, dx0, ddx, qy * qy);
+      select_span(doc::get_pixel_address_fast<doc::RgbTraits>(img, 0, y),
+                  fbuf.data(),
+                  thrRows[y % matrix.rows()].data(),
+                  width,
+                  c0,
+                  c1);
     }
   }
 }
@@ -0,0 +1,103 @@
+// Aseprite Render Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "doc/image.h"
+#include "doc/image_ref.h"
+#include "doc/primitives.h"
+#include "render/dithering_matrix.h"
+#include "render/gradient.h"
+
+using namespace doc;
+using namespace render;
+
+TEST(Gradient, LinearStopsAndMidpoint)
+{
+  ImageRef img(Image::create(IMAGE_RGB, 101, 3));
+  const color_t c0 = rgba(0, 0, 0, 255);
+  const color_t c1 = rgba(255, 255, 255, 255);
+
+  render_rgba_linear_gradient(img.get(),
+                              gfx::Point(0, 0),
+                              gfx::Point(0, 0),
+                              gfx::Point(100, 0),
+                              c0,
+                              c1,
+                              DitheringMatrix());
+
+  EXPECT_EQ(c0, img->getPixel(0, 0));
+  EXPECT_EQ(c1, img->getPixel(100, 0));
+
+  // The projection is horizontal, each column must be uniform.
+  for (int x = 0; x < img->width(); ++x) {
+    EXPECT_EQ(img->getPixel(x, 0), img->getPixel(x, 1));
+    EXPECT_EQ(img->getPixel(x, 0), img->getPixel(x, 2));
+  }
+
+  // Middle column is half way between the stops.
+  const color_t mid = img->getPixel(50, 0);
+  EXPECT_NEAR(128, rgba_getr(mid), 1);
+  EXPECT_NEAR(128, rgba_geta(mid), 1);
+}
+
+TEST(Gradient, LinearDitheredUsesOnlyStopColors)
+{
+  ImageRef img(Image::create(IMAGE_RGB, 64, 64));
+  const color_t c0 = rgba(255, 0, 0, 255);
+  const color_t c1 = rgba(0, 0, 255, 255);
+  const DitheringMatrix matrix = BayerMatrix::make(8);
+
+  render_rgba_linear_gradient(img.get(),
+                              gfx::Point(0, 0),
+                              gfx::Point(0, 0),
+                              gfx::Point(63, 63),
+                              c0,
+                              c1,
+                              matrix);
+
+  int n0 = 0, n1 = 0;
+  for (int y = 0; y < img->height(); ++y) {
+    for (int x = 0; x < img->width(); ++x) {
+      const color_t c = img->getPixel(x, y);
+      ASSERT_TRUE(c == c0 || c == c1) << "at " << x << "," << y;
+      (c == c0 ? ++n0 : ++n1);
+    }
+  }
+  // Both stops must appear (the gradient covers the whole image).
+  EXPECT_GT(n0, 0);
+  EXPECT_GT(n1, 0);
+}
+
+TEST(Gradient, RadialCenterAndOutside)
+{
+  ImageRef img(Image::create(IMAGE_RGB, 33, 33));
+  const color_t c0 = rgba(10, 20, 30, 255);
+  const color_t c1 = rgba(200, 100, 50, 255);
+
+  render_rgba_radial_gradient(img.get(),
+                              gfx::Point(0, 0),
+                              gfx::Point(0, 0),
+                              gfx::Point(32, 32),
+                              c0,
+                              c1,
+                              DitheringMatrix());
+
+  // Distance 0 in the center, >= 1 in the corners.
+  EXPECT_EQ(c0, img->getPixel(16, 16));
+  EXPECT_EQ(c1, img->getPixel(0, 0));
+  EXPECT_EQ(c1, img->getPixel(32, 32));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
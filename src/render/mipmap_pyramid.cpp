@@ -0,0 +1,146 @@
+// Aseprite Render Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "render/mipmap_pyramid.h"
+
+#include "doc/image.h"
+#include "doc/image_impl.h"
+
+#include <algorithm>
+
+namespace render {
+
+using namespace doc;
+
+namespace {
+
+// Ceiling halving so that every source pixel is covered by some
+// destination pixel even for odd dimensions.
+inline int half_size(int size)
+{
+  return std::max(1, (size + 1) / 2);
+}
+
+// Downscales srcRc (in dst coordinates) of "src" into "dst" with a
+// 2x2 box filter (plain per-channel average, good enough for
+// display purposes).
+void downscale_2x2(const Image* src, Image* dst, const gfx::Rect& dstRc)
+{
+  const int srcMaxX = src->width() - 1;
+  const int srcMaxY = src->height() - 1;
+
+  for (int y = dstRc.y; y < dstRc.y2(); ++y) {
+    const int sy0 = std::min(2 * y, srcMaxY);
+    const int sy1 = std::min(2 * y + 1, srcMaxY);
+    auto row0 = (const uint32_t*)src->getPixelAddress(0, sy0);
+    auto row1 = (const uint32_t*)src->getPixelAddress(0, sy1);
+    auto dstRow = (uint32_t*)dst->getPixelAddress(dstRc.x, y);
+
+    for (int x = dstRc.x; x < dstRc.x2(); ++x, ++dstRow) {
+      const int sx0 = std::min(2 * x, srcMaxX);
+      const int sx1 = std::min(2 * x + 1, srcMaxX);
+      const uint32_t a = row0[sx0];
+      const uint32_t b = row0[sx1];
+      const uint32_t c = row1[sx0];
+      const uint32_t d = row1[sx1];
+
+      // Average the four RGBA pixels channel by channel: two
+      // half-sums of the low 7 bits of each byte keep everything in
+      // 32 bits without overflowing into the neighbor channel.
+      const uint32_t ab = ((a >> 1) & 0x7f7f7f7f) + ((b >> 1) & 0x7f7f7f7f);
+      const uint32_t cd = ((c >> 1) & 0x7f7f7f7f) + ((d >> 1) & 0x7f7f7f7f);
+      *dstRow = ((ab >> 1) & 0x7f7f7f7f) + ((cd >> 1) & 0x7f7f7f7f);
+    }
+  }
+}
+
+} // anonymous namespace
+
+// static
+doc::ImageRef MipmapPyramid::reduce(const doc::ImageRef& base, const int level)
+{
+  ASSERT(base && base->pixelFormat() == IMAGE_RGB);
+  ASSERT(level >= 0);
+
+  doc::ImageRef src = base;
+  for (int i = 0; i < level; ++i) {
+    doc::ImageRef dst(Image::create(IMAGE_RGB, half_size(src->width()), half_size(src->height())));
+    downscale_2x2(src.get(), dst.get(), dst->bounds());
+    src = dst;
+  }
+  return src;
+}
+
+// static
+int MipmapPyramid::levelForScale(double scale)
+{
+  int level = 0;
+  while (level < kMaxLevel && scale <= 1.0 / (2 << level))
+    ++level;
+  return level;
+}
+
+void MipmapPyramid::setBase(const doc::ImageRef& base)
+{
+  ASSERT(!base || base->pixelFormat() == IMAGE_RGB);
+  m_base = base;
+  m_levels.clear();
+}
+
+void MipmapPyramid::invalidate(const gfx::Rect& baseBounds)
+{
+  gfx::Rect rc = baseBounds;
+  for (auto& level : m_levels) {
+    // Ceiling halving of both corners so the dirty area fully covers
+    // the downscaled pixels.
+    rc = gfx::Rect(rc.x / 2, rc.y / 2, (rc.x2() + 1) / 2 - rc.x / 2, (rc.y2() + 1) / 2 - rc.y / 2);
+    rc &= level.image->bounds();
+    if (!rc.isEmpty())
+      level.dirty |= gfx::Region(rc);
+  }
+}
+
+const doc::Image* MipmapPyramid::level(const int level)
+{
+  ASSERT(m_base);
+  ASSERT(level >= 0 && level <= kMaxLevel);
+
+  if (level == 0)
+    return m_base.get();
+
+  // Create missing levels (fully dirty, they are rebuilt below).
+  while (int(m_levels.size()) < level) {
+    const Image* prev = (m_levels.empty() ? m_base.get() : m_levels.back().image.get());
+    Level newLevel;
+    newLevel.image.reset(
+      Image::create(IMAGE_RGB, half_size(prev->width()), half_size(prev->height())));
+    newLevel.dirty = gfx::Region(newLevel.image->bounds());
+    m_levels.push_back(std::move(newLevel));
+  }
+
+  for (int i = 1; i <= level; ++i)
+    validateLevel(i);
+
+  return m_levels[level - 1].image.get();
+}
+
+void MipmapPyramid::validateLevel(const int level)
+{
+  Level& l = m_levels[level - 1];
+  if (l.dirty.isEmpty())
+    return;
+
+  const Image* prev = (level == 1 ? m_base.get() : m_levels[level - 2].image.get());
+  for (const gfx::Rect& rc : l.dirty)
+    downscale_2x2(prev, l.image.get(), rc);
+  l.dirty.clear();
+}
+
+} // namespace render
@@ -0,0 +1,71 @@
+// Aseprite Render Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef RENDER_MIPMAP_PYRAMID_H_INCLUDED
+#define RENDER_MIPMAP_PYRAMID_H_INCLUDED
+#pragma once
+
+#include "doc/image_ref.h"
+#include "gfx/rect.h"
+#include "gfx/region.h"
+
+#include <vector>
+
+namespace render {
+
+// Power-of-two mipmap pyramid of a RGBA composite image. Each level
+// halves the previous one with a 2x2 box filter, so zoomed-out views
+// of a big composite can be displayed from a level close to the
+// screen resolution instead of sampling the full-resolution image.
+//
+// Levels are rebuilt lazily: invalidate() just accumulates dirty
+// rectangles and level() downscales only the out-of-date areas.
+class MipmapPyramid {
+public:
+  // Maximum number of reduced levels (level 5 = 1/32 = ~3% zoom).
+  static const int kMaxLevel = 5;
+
+  // Returns the pyramid level that should be used to display the
+  // base image at the given scale (0 = the base image itself, e.g.
+  // a 25% zoom returns level 2, i.e. the 1/4 image).
+  static int levelForScale(double scale);
+
+  // Returns a copy of "base" downscaled "level" times with the same
+  // 2x2 box filter used between pyramid levels (for one-shot
+  // reductions that don't need to keep a pyramid alive). Level 0
+  // returns "base" itself.
+  static doc::ImageRef reduce(const doc::ImageRef& base, int level);
+
+  // Sets the base (level 0) image. It must be a doc::IMAGE_RGB
+  // image. The caller keeps the ownership and must invalidate() the
+  // areas it modifies.
+  void setBase(const doc::ImageRef& base);
+  const doc::ImageRef& base() const { return m_base; }
+
+  // Marks an area of the base image as modified (in base image
+  // coordinates).
+  void invalidate(const gfx::Rect& baseBounds);
+
+  // Returns the image of the given level ("level" halvings of the
+  // base image), rebuilding out-of-date areas. Level 0 returns the
+  // base image itself.
+  const doc::Image* level(const int level);
+
+private:
+  struct Level {
+    doc::ImageRef image;
+    gfx::Region dirty; // Out-of-date area in this level's coordinates
+  };
+
+  void validateLevel(const int level);
+
+  doc::ImageRef m_base;
+  std::vector<Level> m_levels; // m_levels[i] = level i+1
+};
+
+} // namespace render
+
+#endif
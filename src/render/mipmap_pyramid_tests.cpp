@@ -0,0 +1,101 @@
+// Aseprite Render Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "render/mipmap_pyramid.h"
+
+#include "doc/image.h"
+#include "doc/primitives.h"
+
+using namespace doc;
+using namespace render;
+
+TEST(MipmapPyramid, LevelForScale)
+{
+  EXPECT_EQ(0, MipmapPyramid::levelForScale(1.0));
+  EXPECT_EQ(0, MipmapPyramid::levelForScale(0.75));
+  EXPECT_EQ(1, MipmapPyramid::levelForScale(0.5));
+  EXPECT_EQ(2, MipmapPyramid::levelForScale(0.25));
+  EXPECT_EQ(3, MipmapPyramid::levelForScale(0.125));
+  // ~12% zoom uses the 1/8 level
+  EXPECT_EQ(3, MipmapPyramid::levelForScale(0.12));
+  // Clamped to the deepest level
+  EXPECT_EQ(MipmapPyramid::kMaxLevel, MipmapPyramid::levelForScale(0.001));
+}
+
+TEST(MipmapPyramid, DownscaleAndSizes)
+{
+  ImageRef base(Image::create(IMAGE_RGB, 8, 8));
+  clear_image(base.get(), rgba(100, 60, 20, 255));
+
+  MipmapPyramid pyramid;
+  pyramid.setBase(base);
+
+  const Image* l1 = pyramid.level(1);
+  ASSERT_TRUE(l1);
+  EXPECT_EQ(4, l1->width());
+  EXPECT_EQ(4, l1->height());
+  EXPECT_EQ(rgba(100, 60, 20, 255), get_pixel(l1, 0, 0));
+
+  // Odd sizes are halved with ceiling so every pixel is covered
+  ImageRef odd(Image::create(IMAGE_RGB, 5, 3));
+  pyramid.setBase(odd);
+  const Image* oddL1 = pyramid.level(1);
+  EXPECT_EQ(3, oddL1->width());
+  EXPECT_EQ(2, oddL1->height());
+  EXPECT_EQ(1, pyramid.level(2)->height());
+}
+
+TEST(MipmapPyramid, BoxFilterAverage)
+{
+  ImageRef base(Image::create(IMAGE_RGB, 2, 2));
+  put_pixel(base.get(), 0, 0, rgba(255, 0, 0, 255));
+  put_pixel(base.get(), 1, 0, rgba(0, 255, 0, 255));
+  put_pixel(base.get(), 0, 1, rgba(0, 0, 255, 255));
+  put_pixel(base.get(), 1, 1, rgba(0, 0, 0, 255));
+
+  MipmapPyramid pyramid;
+  pyramid.setBase(base);
+
+  const color_t c = get_pixel(pyramid.level(1), 0, 0);
+  // Each channel is averaged with two half-sums (each one truncates
+  // one bit), so the result can be slightly below 255/4=63.
+  EXPECT_NEAR(63, rgba_getr(c), 1);
+  EXPECT_NEAR(63, rgba_getg(c), 1);
+  EXPECT_NEAR(63, rgba_getb(c), 1);
+  EXPECT_NEAR(255, rgba_geta(c), 1);
+}
+
+TEST(MipmapPyramid, LazyInvalidation)
+{
+  ImageRef base(Image::create(IMAGE_RGB, 16, 16));
+  clear_image(base.get(), rgba(0, 0, 0, 255));
+
+  MipmapPyramid pyramid;
+  pyramid.setBase(base);
+  EXPECT_EQ(rgba(0, 0, 0, 255), get_pixel(pyramid.level(2), 0, 0));
+
+  // Without invalidate() the levels keep the old content
+  clear_image(base.get(), rgba(255, 255, 255, 255));
+  EXPECT_EQ(rgba(0, 0, 0, 255), get_pixel(pyramid.level(2), 0, 0));
+
+  // Invalidating just one area rebuilds only that area
+  pyramid.invalidate(gfx::Rect(0, 0, 4, 4));
+  const Image* l2 = pyramid.level(2);
+  EXPECT_NEAR(255, rgba_getr(get_pixel(l2, 0, 0)), 3);
+  EXPECT_EQ(rgba(0, 0, 0, 255), get_pixel(l2, 3, 3));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,5 @@
 // Aseprite Render Library
-// Copyright (c) 2019-2022  Igara Studio S.A.
+// Copyright (c) 2019-2026  Igara Studio S.A.
 // Copyright (c) 2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,15 +11,45 @@
 
 #include "render/ordered_dither.h"
 
+#include "doc/octree_map.h"
+#include "doc/primitives_fast.h"
+#include "doc/rgbmap_rgb5a3.h"
 #include "render/dithering.h"
 #include "render/dithering_matrix.h"
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
+#include <memory>
+#include <thread>
 #include <vector>
 
 namespace render {
 
+namespace {
+
+// Each worker thread of the parallel dithering path needs its own
+// RgbMap: implementations memoize inside mapColor() (RgbMapRGB5A3
+// fills its table lazily, OctreeMap caches palette indices in its
+// nodes), so sharing one across threads is a data race. A clone
+// regenerated from the same palette/mask/criteria returns the same
+// indices, so the output doesn't depend on the band split. Returns
+// nullptr for unknown implementations (the caller must stay
+// single-threaded in that case).
+std::unique_ptr<doc::RgbMap> clone_rgbmap(const doc::RgbMap* rgbmap, const doc::Palette* palette)
+{
+  std::unique_ptr<doc::RgbMap> clone;
+  switch (rgbmap->rgbmapAlgorithm()) {
+    case doc::RgbMapAlgorithm::RGB5A3: clone = std::make_unique<doc::RgbMapRGB5A3>(); break;
+    case doc::RgbMapAlgorithm::OCTREE: clone = std::make_unique<doc::OctreeMap>(); break;
+    default:                           return nullptr;
+  }
+  clone->regenerateMap(palette, rgbmap->maskIndex(), rgbmap->fitCriteria());
+  return clone;
+}
+
+} // anonymous namespace
+
 // Base 2x2 dither matrix, called D(2):
 int BayerMatrix::D2[4] = { 0, 2, 3, 1 };
 
@@ -229,7 +259,76 @@ void dither_rgb_image_to_indexed(DitheringAlgorithmBase& algorithm,
 
   algorithm.start(srcImage, dstImage, dithering.factor());
 
+  // Dithering::matrix() returns a copy, take it once instead of
+  // copying the matrix on each pixel.
+  const DitheringMatrix matrix = dithering.matrix();
+
   if (algorithm.dimensions() == 1) {
+    // 1D algorithms (the ordered dithers) decide each pixel
+    // independently and don't keep state between pixels, so big
+    // images are split in row bands across threads, each band
+    // dithering with its own RgbMap clone (see clone_rgbmap()).
+    // The caller's band keeps reporting progress/cancellation to
+    // the delegate; other bands just poll the stop flag per row.
+    int threads = std::min<int>(std::thread::hardware_concurrency(), h / 64);
+    if (threads >= 2 && rgbmap) {
+      std::vector<std::unique_ptr<doc::RgbMap>> clones;
+      for (int i = 1; i < threads; ++i) {
+        auto clone = clone_rgbmap(rgbmap, palette);
+        if (!clone)
+          break;
+        clones.push_back(std::move(clone));
+      }
+      threads = int(clones.size()) + 1;
+
+      if (threads >= 2) {
+        std::atomic<bool> stop(false);
+        std::atomic<int> rowsDone(0);
+
+        auto ditherBand =
+          [&](const doc::RgbMap* bandMap, const int y0, const int y1, const bool isCaller) {
+            for (int y = y0; y < y1 && !stop; ++y) {
+              auto srcIt = doc::get_pixel_address_fast<doc::RgbTraits>(srcImage, 0, y);
+              auto dstIt = doc::get_pixel_address_fast<doc::IndexedTraits>(dstImage, 0, y);
+              for (int x = 0; x < w; ++x, ++srcIt, ++dstIt) {
+                *dstIt =
+                  algorithm.ditherRgbPixelToIndex(matrix, *srcIt, x, y, bandMap, palette);
+              }
+              ++rowsDone;
+
+              if (isCaller && delegate) {
+                if (!delegate->continueTask()) {
+                  stop = true;
+                  return;
+                }
+                delegate->notifyTaskProgress(double(rowsDone) / double(h));
+              }
+            }
+          };
+
+        const int bandHeight = (h + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        for (int i = 1; i < threads; ++i) {
+          const int y0 = i * bandHeight;
+          const int y1 = std::min(h, y0 + bandHeight);
+          if (y0 < y1) {
+            workers.emplace_back(
+              [&, i, y0, y1] { ditherBand(clones[i - 1].get(), y0, y1, false); });
+          }
+        }
+        ditherBand(rgbmap, 0, std::min(h, bandHeight), true);
+        for (auto& worker : workers)
+          worker.join();
+
+        if (stop)
+          return; // Canceled, same early-return as the serial loop below
+        if (delegate)
+          delegate->notifyTaskProgress(1.0);
+        algorithm.finish();
+        return;
+      }
+    }
+
     const doc::LockImageBits<doc::RgbTraits> srcBits(srcImage);
     doc::LockImageBits<doc::IndexedTraits> dstBits(dstImage);
     auto srcIt = srcBits.begin();
@@ -239,7 +338,7 @@ void dither_rgb_image_to_indexed(DitheringAlgorithmBase& algorithm,
       for (int x = 0; x < w; ++x, ++srcIt, ++dstIt) {
         ASSERT(srcIt != srcBits.end());
         ASSERT(dstIt != dstBits.end());
-        *dstIt = algorithm.ditherRgbPixelToIndex(dithering.matrix(), *srcIt, x, y, rgbmap, palette);
+        *dstIt = algorithm.ditherRgbPixelToIndex(matrix, *srcIt, x, y, rgbmap, palette);
 
         if (delegate) {
           if (!delegate->continueTask())
@@ -256,16 +355,17 @@ void dither_rgb_image_to_indexed(DitheringAlgorithmBase& algorithm,
     auto dstIt = doc::get_pixel_address_fast<doc::IndexedTraits>(dstImage, 0, 0);
     const bool zigZag = algorithm.zigZag();
 
+    // 2D algorithms (error diffusion) carry the quantization error
+    // from each pixel to the next one, and with the zig-zag scan
+    // each row starts right where the previous one finished, so
+    // rows cannot overlap in time (progress/cancellation is checked
+    // once per row, the inner loop is pure dithering).
     for (int y = 0; y < h; ++y) {
       if (zigZag && (y & 1)) { // Odd row: go from right-to-left
         dstIt += w - 1;
         for (int x = w - 1; x >= 0; --x, --dstIt) {
           ASSERT(dstIt == doc::get_pixel_address_fast<doc::IndexedTraits>(dstImage, x, y));
           *dstIt = algorithm.ditherRgbToIndex2D(x, y, rgbmap, palette);
-          if (delegate) {
-            if (!delegate->continueTask())
-              return;
-          }
         }
         dstIt += w + 1;
       }
@@ -273,14 +373,11 @@ void dither_rgb_image_to_indexed(DitheringAlgorithmBase& algorithm,
         for (int x = 0; x < w; ++x, ++dstIt) {
           ASSERT(dstIt == doc::get_pixel_address_fast<doc::IndexedTraits>(dstImage, x, y));
           *dstIt = algorithm.ditherRgbToIndex2D(x, y, rgbmap, palette);
-
-          if (delegate) {
-            if (!delegate->continueTask())
-              return;
-          }
         }
       }
       if (delegate) {
+        if (!delegate->continueTask())
+          return;
         delegate->notifyTaskProgress(double(y + 1) / double(h));
       }
     }
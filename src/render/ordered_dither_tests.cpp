@@ -1,5 +1,5 @@
 // Aseprite Render Library
-// Copyright (c) 2019 Igara Studio S.A.
+// Copyright (c) 2019-2026 Igara Studio S.A.
 // Copyright (c) 2001-2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,6 +11,11 @@
 
 #include <gtest/gtest.h>
 
+#include "doc/image.h"
+#include "doc/image_ref.h"
+#include "doc/palette.h"
+#include "doc/rgbmap_rgb5a3.h"
+#include "render/dithering.h"
 #include "render/dithering_matrix.h"
 #include "render/ordered_dither.h"
 
@@ -51,6 +56,47 @@ TEST(BayerMatrix, CheckD8)
       EXPECT_EQ(expected[c++], matrix(i, j));
 }
 
+// The image is tall enough to be dithered in parallel row bands, the
+// result must be identical to dithering each pixel serially.
+TEST(OrderedDither, BandsDontChangeOutput)
+{
+  const int w = 64;
+  const int h = 192;
+  ImageRef src(Image::create(IMAGE_RGB, w, h));
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      src->putPixel(x, y, rgba(255 * x / (w - 1), 255 * y / (h - 1), 128, 255));
+
+  Palette pal(frame_t(0), 8);
+  pal.setEntry(0, rgba(0, 0, 0, 255));
+  pal.setEntry(1, rgba(255, 255, 255, 255));
+  pal.setEntry(2, rgba(255, 0, 0, 255));
+  pal.setEntry(3, rgba(0, 255, 0, 255));
+  pal.setEntry(4, rgba(0, 0, 255, 255));
+  pal.setEntry(5, rgba(255, 255, 0, 255));
+  pal.setEntry(6, rgba(0, 255, 255, 255));
+  pal.setEntry(7, rgba(255, 0, 255, 255));
+
+  RgbMapRGB5A3 rgbmap;
+  rgbmap.regenerateMap(&pal, -1);
+
+  const DitheringMatrix matrix = BayerMatrix::make(8);
+  ImageRef dst(Image::create(IMAGE_INDEXED, w, h));
+  OrderedDither algorithm;
+  dither_rgb_image_to_indexed(algorithm, Dithering(DitheringAlgorithm::Old, matrix), src.get(), dst.get(), &rgbmap, &pal);
+
+  RgbMapRGB5A3 refMap;
+  refMap.regenerateMap(&pal, -1);
+  OrderedDither reference;
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      const color_t expected =
+        reference.ditherRgbPixelToIndex(matrix, src->getPixel(x, y), x, y, &refMap, &pal);
+      ASSERT_EQ(expected, dst->getPixel(x, y)) << "at " << x << "," << y;
+    }
+  }
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -11,6 +11,7 @@
 
 #include "render/quantization.h"
 
+#include "base/thread_pool.h"
 #include "doc/image.h"
 #include "doc/layer.h"
 #include "doc/octree_map.h"
@@ -28,6 +29,7 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <thread>
 #include <vector>
 
 namespace render {
@@ -77,23 +79,76 @@ Palette* create_palette_from_sprite(const Sprite* sprite,
   render::Render render;
   render.setNewBlend(newBlend);
 
-  // Feed the optimizer with all rendered frames
-  for (frame_t frame = fromFrame; frame <= toFrame; ++frame) {
-    render.renderSprite(flat_image.get(), sprite, frame);
+  // Feed the optimizer with all rendered frames. Frames are processed
+  // in waves of hardware_concurrency() size: each wave renders its
+  // frames in parallel (one Render clone + flat image per slot), and
+  // the histogram phase runs in the same tasks for the mergeable
+  // RGB5A3 optimizer, or serially per wave for the octree (progress
+  // and cancellation are checked between waves on the caller thread).
+  const int nframes = toFrame - fromFrame + 1;
+  const int nslots =
+    std::clamp<int>(std::thread::hardware_concurrency(), 1, std::max(1, nframes));
+
+  if (nslots > 1) {
+    static base::thread_pool pool(std::max<int>(2, std::thread::hardware_concurrency()));
+
+    std::vector<ImageRef> slotImages(nslots);
+    std::vector<render::Render> slotRenders(nslots);
+    std::vector<PaletteOptimizer> slotOptimizers(nslots);
+    for (int i = 0; i < nslots; ++i) {
+      slotImages[i].reset(Image::create(IMAGE_RGB, sprite->width(), sprite->height()));
+      slotRenders[i].setNewBlend(newBlend);
+    }
 
-    switch (mapAlgo) {
-      case RgbMapAlgorithm::RGB5A3: optimizer.feedWithImage(flat_image.get(), withAlpha); break;
-      case RgbMapAlgorithm::OCTREE:
-        octreemap.feedWithImage(flat_image.get(), withAlpha, maskColor);
-        break;
-      default: ASSERT(false); break;
+    for (frame_t base = fromFrame; base <= toFrame; base += nslots) {
+      const int waveSize = std::min<int>(nslots, toFrame - base + 1);
+      for (int i = 0; i < waveSize; ++i) {
+        pool.execute([&, i, base] {
+          slotRenders[i].renderSprite(slotImages[i].get(), sprite, base + i);
+          if (mapAlgo == RgbMapAlgorithm::RGB5A3)
+            slotOptimizers[i].feedWithImage(slotImages[i].get(), withAlpha);
+        });
+      }
+      pool.wait_all();
+
+      if (mapAlgo == RgbMapAlgorithm::OCTREE) {
+        for (int i = 0; i < waveSize; ++i)
+          octreemap.feedWithImage(slotImages[i].get(), withAlpha, maskColor);
+      }
+
+      if (delegate) {
+        if (!delegate->continueTask())
+          return nullptr;
+
+        delegate->notifyTaskProgress(double(base + waveSize - fromFrame) /
+                                     double(toFrame - fromFrame + 1));
+      }
     }
 
-    if (delegate) {
-      if (!delegate->continueTask())
-        return nullptr;
+    if (mapAlgo == RgbMapAlgorithm::RGB5A3) {
+      for (int i = 0; i < nslots; ++i)
+        optimizer.merge(slotOptimizers[i]);
+    }
+  }
+  else {
+    for (frame_t frame = fromFrame; frame <= toFrame; ++frame) {
+      render.renderSprite(flat_image.get(), sprite, frame);
+
+      switch (mapAlgo) {
+        case RgbMapAlgorithm::RGB5A3: optimizer.feedWithImage(flat_image.get(), withAlpha); break;
+        case RgbMapAlgorithm::OCTREE:
+          octreemap.feedWithImage(flat_image.get(), withAlpha, maskColor);
+          break;
+        default: ASSERT(false); break;
+      }
+
+      if (delegate) {
+        if (!delegate->continueTask())
+          return nullptr;
 
-      delegate->notifyTaskProgress(double(frame - fromFrame + 1) / double(toFrame - fromFrame + 1));
+        delegate->notifyTaskProgress(double(frame - fromFrame + 1) /
+                                     double(toFrame - fromFrame + 1));
+      }
     }
   }
 
@@ -435,6 +490,12 @@ void PaletteOptimizer::feedWithImage(const Image* image,
   }
 }
 
+void PaletteOptimizer::merge(const PaletteOptimizer& other)
+{
+  m_histogram.merge(other.m_histogram);
+  m_withAlpha |= other.m_withAlpha;
+}
+
 void PaletteOptimizer::feedWithRgbaColor(color_t color)
 {
   m_histogram.addSamples(color, 1);
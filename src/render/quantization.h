@@ -32,6 +32,9 @@ public:
   void feedWithImage(const doc::Image* image, const bool withAlpha);
   void feedWithImage(const doc::Image* image, const gfx::Rect& bounds, const bool withAlpha);
   void feedWithRgbaColor(doc::color_t color);
+  // Merges the samples of another optimizer (used after feeding
+  // per-thread optimizers in parallel).
+  void merge(const PaletteOptimizer& other);
   void calculate(doc::Palette* palette, int maskIndex);
   bool isHighPrecision() { return m_histogram.isHighPrecision(); }
   int highPrecisionSize() { return m_histogram.highPrecisionSize(); }
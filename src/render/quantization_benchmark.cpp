@@ -0,0 +1,92 @@
+// Aseprite Render Library
+// Copyright (c) 2026 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "render/quantization.h"
+
+#include "doc/algorithm/random_image.h"
+#include "doc/cel.h"
+#include "doc/image.h"
+#include "doc/layer.h"
+#include "doc/palette.h"
+#include "doc/sprite.h"
+#include "render/dithering.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+using namespace doc;
+using namespace render;
+
+static Sprite* make_random_sprite(const int w, const int h)
+{
+  Sprite* spr = Sprite::MakeStdSprite(ImageSpec(ColorMode::RGB, w, h));
+  LayerImage* lay = static_cast<LayerImage*>(spr->root()->firstLayer());
+  algorithm::random_image(lay->cel(0)->image());
+  return spr;
+}
+
+void BM_CreatePaletteFromSprite(benchmark::State& state)
+{
+  const int w = state.range(0);
+  const int h = state.range(1);
+  const auto mapAlgo = RgbMapAlgorithm(state.range(2));
+  std::unique_ptr<Sprite> spr(make_random_sprite(w, h));
+  for (auto _ : state) {
+    std::unique_ptr<Palette> pal(create_palette_from_sprite(spr.get(),
+                                                            0,
+                                                            spr->lastFrame(),
+                                                            true,
+                                                            nullptr,
+                                                            nullptr,
+                                                            true,
+                                                            mapAlgo));
+    benchmark::DoNotOptimize(pal);
+  }
+  state.SetItemsProcessed(state.iterations() * w * h);
+}
+
+void BM_ConvertRgbToIndexed(benchmark::State& state)
+{
+  const int w = state.range(0);
+  const int h = state.range(1);
+  const auto mapAlgo = RgbMapAlgorithm(state.range(2));
+  std::unique_ptr<Sprite> spr(make_random_sprite(w, h));
+  const Image* src = static_cast<LayerImage*>(spr->root()->firstLayer())->cel(0)->image();
+  std::unique_ptr<Palette> pal(
+    create_palette_from_sprite(spr.get(), 0, spr->lastFrame(), true, nullptr, nullptr, true, mapAlgo));
+  spr->setPalette(pal.get(), true);
+  std::unique_ptr<Image> dst(Image::create(IMAGE_INDEXED, w, h));
+  for (auto _ : state) {
+    convert_pixel_format(src,
+                         dst.get(),
+                         IMAGE_INDEXED,
+                         Dithering(),
+                         spr->rgbMap(0),
+                         pal.get(),
+                         false,
+                         0);
+  }
+  state.SetItemsProcessed(state.iterations() * w * h);
+}
+
+#define QUANTIZATION_ARGS()                                                                        \
+  ->Args({ 256, 256, int(RgbMapAlgorithm::RGB5A3) })                                               \
+    ->Args({ 1024, 1024, int(RgbMapAlgorithm::RGB5A3) })                                           \
+    ->Args({ 1024, 1024, int(RgbMapAlgorithm::OCTREE) })                                           \
+    ->Args({ 4096, 4096, int(RgbMapAlgorithm::RGB5A3) })
+
+BENCHMARK(BM_CreatePaletteFromSprite)
+QUANTIZATION_ARGS()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_ConvertRgbToIndexed)
+QUANTIZATION_ARGS()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,5 +1,5 @@
 // Aseprite Render Library
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,8 +12,10 @@
 #include "render/render.h"
 
 #include "base/gcd.h"
+#include "base/thread_pool.h"
 #include "doc/blend_internals.h"
 #include "doc/blend_mode.h"
+#include "doc/blend_rows.h"
 #include "doc/doc.h"
 #include "doc/image.h"
 #include "doc/layer_tilemap.h"
@@ -24,7 +26,11 @@
 #include "gfx/clip.h"
 #include "gfx/region.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <mutex>
+#include <thread>
 
 #define TRACE_RENDER_CEL(...) // TRACE
 
@@ -32,6 +38,12 @@ namespace render {
 
 namespace {
 
+// Tile side used by the tile-parallel renderSprite() mode.
+constexpr int kRenderTileSize = 256;
+
+// Byte budget for the tilemap rendered-row strip cache.
+constexpr size_t kTilemapStripCacheLimit = 32 * 1024 * 1024;
+
 //////////////////////////////////////////////////////////////////////
 // Scaled composite
 
@@ -64,6 +76,21 @@ void composite_image_without_scale(Image* dst,
 
   ASSERT(!srcBounds.isEmpty());
 
+  // RGB -> RGB rows are contiguous in both images, so we can use the
+  // row-oriented blenders (SIMD when available) instead of iterating
+  // pixel by pixel.
+  if constexpr (DstTraits::color_mode == ColorMode::RGB &&
+                SrcTraits::color_mode == ColorMode::RGB) {
+    const doc::BlendRowFunc rowFn = doc::get_rgba_row_blender(blendMode, newBlend);
+    const color_t maskColor = src->maskColor();
+    for (int y = 0; y < srcBounds.h; ++y) {
+      auto* dstRow = (color_t*)dst->getPixelAddress(dstBounds.x, dstBounds.y + y);
+      const auto* srcRow = (const color_t*)src->getPixelAddress(srcBounds.x, srcBounds.y + y);
+      rowFn(dstRow, srcRow, srcBounds.w, opacity, maskColor);
+    }
+    return;
+  }
+
   // Lock all necessary bits
   const LockImageBits<SrcTraits> srcBits(src, srcBounds);
   LockImageBits<DstTraits> dstBits(dst, dstBounds);
@@ -149,6 +176,53 @@ void composite_image_scale_up(Image* dst,
 
   gfx::Rect dstBounds = area.dstBounds();
   int bottom = dstBounds.y2() - 1;
+
+  // RGB -> RGB: blend each source row with one row-blender call (the
+  // per-mode math is inlined in it, no indirect call per pixel) and
+  // replicate the blended scanline with plain fills, using raw row
+  // pointers instead of the checked iterators.
+  if constexpr (DstTraits::color_mode == ColorMode::RGB &&
+                SrcTraits::color_mode == ColorMode::RGB) {
+    const doc::BlendRowFunc rowFn = doc::get_rgba_row_blender(blendMode, newBlend);
+    const color_t maskColor = src->maskColor();
+    std::vector<color_t> scanline(srcBounds.w);
+
+    int dstY = dstBounds.y;
+    for (int y = 0; y < srcBounds.h; ++y) {
+      const auto* srcRow = (const color_t*)src->getPixelAddress(srcBounds.x, srcBounds.y + y);
+
+      // Gather the dst pixel under the first replica of each src
+      // pixel and blend the whole row at once.
+      {
+        const auto* dstRow = (const color_t*)dst->getPixelAddress(dstBounds.x, dstY);
+        int dstX = 0;
+        for (int x = 0; x < srcBounds.w; ++x) {
+          scanline[x] = dstRow[dstX];
+          dstX += (x == 0 ? first_px_w : px_w);
+          if (dstX >= dstBounds.w)
+            dstX = dstBounds.w - 1;
+        }
+      }
+      rowFn(scanline.data(), srcRow, srcBounds.w, opacity, maskColor);
+
+      // Replicate the blended scanline into the block of dst rows
+      // covered by this src row.
+      const int blockH = (y == 0 && first_px_h > 0 ? first_px_h : px_h);
+      for (int py = 0; py < blockH; ++py) {
+        auto* dstRow = (color_t*)dst->getPixelAddress(dstBounds.x, dstY);
+        int dstX = 0;
+        for (int x = 0; x < srcBounds.w && dstX < dstBounds.w; ++x) {
+          const int w = std::min((x == 0 ? first_px_w : px_w), dstBounds.w - dstX);
+          std::fill_n(dstRow + dstX, w, scanline[x]);
+          dstX += w;
+        }
+        if (++dstY > bottom)
+          return;
+      }
+    }
+    return;
+  }
+
   int line_h;
 
   // the scanline variable is used to blend src/dst pixels one time for each pixel
@@ -513,6 +587,25 @@ CompositeImageFunc get_fastest_composition_path(const Projection& proj,
   }
 }
 
+// Composition path used to resolve tiles into the flat strips of the
+// tilemap row cache: always at 1:1 scale (the projection is applied
+// later, when the strip is composited like a regular cel image).
+CompositeImageFunc get_tile_resolution_path(const PixelFormat format, const tile_flags tileFlags)
+{
+  const Projection identity;
+  switch (format) {
+    case IMAGE_RGB:
+      return get_fastest_composition_path<RgbTraits, RgbTraits>(identity, false, tileFlags);
+    case IMAGE_GRAYSCALE:
+      return get_fastest_composition_path<GrayscaleTraits, GrayscaleTraits>(identity,
+                                                                            false,
+                                                                            tileFlags);
+    case IMAGE_INDEXED:
+      return get_fastest_composition_path<IndexedTraits, IndexedTraits>(identity, false, tileFlags);
+  }
+  return nullptr;
+}
+
 bool has_visible_reference_layers(const LayerGroup* group)
 {
   for (const Layer* child : group->layers()) {
@@ -540,6 +633,8 @@ Render::Render()
   , m_extraCel(nullptr)
   , m_extraImage(nullptr)
   , m_newBlendMethod(true)
+  , m_tileParallelism(false)
+  , m_tileSize(kRenderTileSize)
   , m_globalOpacity(255)
   , m_selectedLayerForOpacity(nullptr)
   , m_selectedLayer(nullptr)
@@ -574,6 +669,16 @@ void Render::setComposeGroups(const bool composeGroup)
   m_composeGroups = composeGroup;
 }
 
+void Render::setTileParallelism(const bool tileParallelism)
+{
+  m_tileParallelism = tileParallelism;
+}
+
+void Render::setTileSize(const int tileSize)
+{
+  m_tileSize = std::max(64, tileSize);
+}
+
 void Render::setProjection(const Projection& projection)
 {
   m_proj = projection;
@@ -680,6 +785,14 @@ void Render::renderSprite(Image* dstImage,
 {
   m_sprite = sprite;
 
+  // Tile-parallel mode: big areas are split into square tiles and
+  // composited across a thread pool (each tile is an independent
+  // renderSprite() call over a sub-clip).
+  if (m_tileParallelism && area.size.w * area.size.h >= 2 * m_tileSize * m_tileSize) {
+    renderSpriteTiled(dstImage, sprite, frame, area);
+    return;
+  }
+
   CompositeImageFunc compositeImage =
     getImageComposition(dstImage->pixelFormat(), m_sprite->pixelFormat(), sprite->root());
   if (!compositeImage)
@@ -752,12 +865,60 @@ void Render::renderSprite(Image* dstImage,
   }
 }
 
+void Render::renderSpriteTiled(Image* dstImage,
+                               const Sprite* sprite,
+                               frame_t frame,
+                               const gfx::ClipF& area)
+{
+  // One shared pool for all Render instances; a mutex serializes
+  // dispatch+wait so concurrent renders don't steal each other's
+  // completion (nested tiled renders are disabled in the clones).
+  static base::thread_pool pool(std::max<int>(2, std::thread::hardware_concurrency()));
+  static std::mutex poolMutex;
+
+  std::lock_guard lock(poolMutex);
+
+  for (int ty = 0; ty < area.size.h; ty += m_tileSize) {
+    for (int tx = 0; tx < area.size.w; tx += m_tileSize) {
+      const int tw = std::min<int>(m_tileSize, area.size.w - tx);
+      const int th = std::min<int>(m_tileSize, area.size.h - ty);
+      const gfx::ClipF tileArea(area.dst.x + tx, area.dst.y + ty,
+                                area.src.x + tx, area.src.y + ty,
+                                tw, th);
+      pool.execute([this, dstImage, sprite, frame, tileArea] {
+        // Each worker uses its own Render so mutable compositing
+        // state (m_globalOpacity, m_tmpBuf, etc.) is not shared.
+        Render tileRender(*this);
+        tileRender.m_tileParallelism = false;
+        tileRender.m_tmpBuf.reset();
+        tileRender.renderSprite(dstImage, sprite, frame, tileArea);
+      });
+    }
+  }
+
+  pool.wait_all();
+}
+
 void Render::renderSpriteLayers(Image* dstImage,
                                 const gfx::ClipF& area,
                                 frame_t frame,
                                 CompositeImageFunc compositeImage)
 {
   doc::RenderPlan plan(m_composeGroups);
+
+  // Cull groups that cannot touch the rendered area. Disabled when a
+  // cel image is going to be substituted on the fly (brush preview /
+  // extra cel), as the substitute may fall outside the group content
+  // bounds.
+  if (!m_previewImage && !m_extraImage) {
+    // area.src is in projected coordinates, the group content bounds
+    // used by the plan are in sprite ones.
+    gfx::Rect clip = m_proj.remove(
+      gfx::Rect(int(area.src.x), int(area.src.y), area.size.w, area.size.h));
+    clip.enlarge(1); // Round-off safety margin
+    plan.setClipBounds(clip);
+  }
+
   plan.addLayer(m_sprite->root(), frame);
 
   // Draw the background layer.
@@ -859,23 +1020,171 @@ void Render::renderOnionskin(Image* dstImage,
         else if (m_onionskin.type() == OnionskinType::RED_BLUE_TINT)
           blendMode = (frameOut < frame ? BlendMode::RED_TINT : BlendMode::BLUE_TINT);
 
+        // Render background only for "in-front" onion skinning and
+        // when opacity is < 255
+        const bool renderBackground =
+          (m_globalOpacity < 255 && m_onionskin.position() == OnionskinPosition::INFRONT);
+
         doc::RenderPlan plan(m_composeGroups);
         plan.addLayer(onionLayer, frameIn);
-        renderPlan(plan,
-                   dstImage,
-                   area,
-                   frameIn,
-                   compositeImage,
-                   // Render background only for "in-front" onion skinning and
-                   // when opacity is < 255
-                   (m_globalOpacity < 255 && m_onionskin.position() == OnionskinPosition::INFRONT),
-                   true,
-                   blendMode);
+
+        // Try to re-blend a cached pre-composited plane of this frame
+        // (much cheaper than re-compositing all its layers on every
+        // repaint). With an unspecified blend mode each layer has to
+        // be blended with its own mode against dstImage, which a flat
+        // plane cannot represent, so we use the slow path.
+        const Image* plane = nullptr;
+        if (blendMode != BlendMode::UNSPECIFIED)
+          plane = getOnionskinPlane(plan, frameIn, dstImage->pixelFormat(), renderBackground);
+
+        CompositeImageFunc planeComposite = nullptr;
+        if (plane)
+          planeComposite = getImageComposition(dstImage->pixelFormat(),
+                                               plane->pixelFormat(),
+                                               nullptr);
+
+        if (plane && planeComposite) {
+          renderImage(dstImage,
+                      plane,
+                      m_sprite->palette(frameIn),
+                      gfx::RectF(m_sprite->bounds()),
+                      area,
+                      planeComposite,
+                      m_globalOpacity,
+                      blendMode);
+        }
+        else {
+          renderPlan(plan,
+                     dstImage,
+                     area,
+                     frameIn,
+                     compositeImage,
+                     renderBackground,
+                     true,
+                     blendMode);
+        }
       }
     }
   }
 }
 
+const Image* Render::getOnionskinPlane(doc::RenderPlan& plan,
+                                       const frame_t frame,
+                                       const PixelFormat dstFormat,
+                                       const bool renderBackground)
+{
+  // Previews and extra cels change how individual cels are
+  // composited, and with composed groups the plan contains group
+  // items whose sub-layers the cache key cannot see.
+  if (m_previewImage || m_extraCel || m_composeGroups || dstFormat == IMAGE_TILEMAP)
+    return nullptr;
+
+  // Don't cache planes of huge sprites (each plane is a full extra
+  // canvas in memory).
+  if (m_sprite->width() * m_sprite->height() > 2048 * 2048)
+    return nullptr;
+
+  // Tilemap cels depend on tileset content that the key cannot track
+  // cheaply.
+  for (const auto& item : plan.items()) {
+    if (item.layer->isTilemap())
+      return nullptr;
+  }
+
+  const uint64_t key = onionskinPlaneKey(plan, frame, dstFormat, renderBackground);
+
+  OnionskinPlane* entry = nullptr;
+  for (auto& cached : m_onionskinCache) {
+    if (cached.frame == frame) {
+      if (cached.key == key)
+        return cached.image.get();
+      entry = &cached;
+      break;
+    }
+  }
+
+  const CompositeImageFunc planeComposite =
+    getImageComposition(dstFormat, m_sprite->pixelFormat(), nullptr);
+  if (!planeComposite)
+    return nullptr;
+
+  ImageRef plane(
+    Image::create(ImageSpec((ColorMode)dstFormat, m_sprite->width(), m_sprite->height())));
+  clear_image(plane.get(), plane->maskColor());
+
+  // Render the frame at 1:1 scale with full opacity, the onion-skin
+  // opacity/tint is applied when the plane is blended into the
+  // destination image.
+  const Projection oldProj = m_proj;
+  const int oldOpacity = m_globalOpacity;
+  m_proj = Projection();
+  m_globalOpacity = 255;
+
+  renderPlan(plan,
+             plane.get(),
+             gfx::Clip(m_sprite->bounds()),
+             frame,
+             planeComposite,
+             renderBackground,
+             true,
+             BlendMode::UNSPECIFIED);
+
+  m_proj = oldProj;
+  m_globalOpacity = oldOpacity;
+
+  if (!entry) {
+    if (m_onionskinCache.size() >= 16)
+      m_onionskinCache.erase(m_onionskinCache.begin());
+    m_onionskinCache.push_back(OnionskinPlane());
+    entry = &m_onionskinCache.back();
+    entry->frame = frame;
+  }
+  entry->key = key;
+  entry->image = plane;
+  return entry->image.get();
+}
+
+uint64_t Render::onionskinPlaneKey(const doc::RenderPlan& plan,
+                                   const frame_t frame,
+                                   const PixelFormat dstFormat,
+                                   const bool renderBackground) const
+{
+  auto combine = [](const uint64_t h, const uint64_t v) {
+    return (h ^ v) * uint64_t(1099511628211ull); // FNV-1a style mixing
+  };
+
+  uint64_t key = uint64_t(14695981039346656037ull);
+  key = combine(key, m_sprite->id());
+  key = combine(key, uint64_t(frame));
+  key = combine(key, uint64_t(dstFormat));
+  key = combine(key, uint64_t(renderBackground ? 1 : 0));
+  key = combine(key, uint64_t(m_newBlendMethod ? 1 : 0));
+  key = combine(key, uint64_t(m_flags));
+  key = combine(key, uint64_t(m_nonactiveLayersOpacity));
+  key = combine(key, uint64_t(m_sprite->width()) | (uint64_t(m_sprite->height()) << 32));
+  if (const Palette* pal = m_sprite->palette(frame)) {
+    key = combine(key, pal->id());
+    key = combine(key, pal->version());
+  }
+
+  for (const auto& item : plan.items()) {
+    const Layer* layer = item.layer;
+    const Cel* cel = (item.cel ? item.cel : layer->cel(frame));
+
+    key = combine(key, layer->id());
+    key = combine(key, uint64_t(layer->opacity()) | (uint64_t(layer->blendMode()) << 16) |
+                         (uint64_t(m_selectedLayerForOpacity == layer ? 1 : 0) << 32));
+    if (!cel)
+      continue;
+
+    key = combine(key, cel->id());
+    key = combine(key, cel->image()->version());
+    key = combine(key, uint64_t(uint32_t(cel->x())) | (uint64_t(uint32_t(cel->y())) << 32));
+    key = combine(key, uint64_t(cel->opacity()) | (uint64_t(uint32_t(cel->zIndex())) << 16));
+  }
+  return key;
+}
+
 void Render::renderCheckeredBackground(Image* image, const gfx::Clip& area)
 {
   int x, y, u, v;
@@ -916,22 +1225,42 @@ void Render::renderCheckeredBackground(Image* image, const gfx::Clip& area)
       break;
   }
 
-  // Draw checkered background (tile by tile)
-  int u_start = u;
-  for (y = y_start - tile_h; y < image->height() + tile_h; y += tile_h) {
-    for (x = x_start - tile_w; x < image->width() + tile_w; x += tile_w) {
-      gfx::Rect fillRc = dstBounds.createIntersection(gfx::Rect(x, y, tile_w, tile_h));
-      if (!fillRc.isEmpty())
-        fill_rect(image,
-                  fillRc.x,
-                  fillRc.y,
-                  fillRc.x + fillRc.w - 1,
-                  fillRc.y + fillRc.h - 1,
-                  (((u + v)) & 1) ? m_bg.color2 : m_bg.color1);
-      ++u;
+  dstBounds &= image->bounds();
+  if (dstBounds.isEmpty())
+    return;
+
+  // Instead of filling the area tile by tile (slow when the zoom
+  // makes each tile just a few pixels wide), we precompute the two
+  // scanlines of the pattern (one for even checker rows, one for odd
+  // ones) and then fill the area copying the right scanline on each
+  // row.
+  const int bpp = image->bytesPerPixel();
+  const size_t rowSize = size_t(dstBounds.w) * bpp;
+  std::vector<uint8_t> rows[2];
+  rows[0].resize(rowSize);
+  rows[1].resize(rowSize);
+
+  for (int i = 0; i < dstBounds.w; ++i) {
+    x = dstBounds.x + i;
+
+    // Column of the checker pattern for this pixel (both terms are
+    // non-negative as x_start <= 0 <= x).
+    const int uu = u + (x - x_start + tile_w) / tile_w;
+    const color_t colors[2] = { ((uu & 1) ? m_bg.color2 : m_bg.color1),
+                                ((uu & 1) ? m_bg.color1 : m_bg.color2) };
+    for (int parity = 0; parity < 2; ++parity) {
+      uint8_t* dst = &rows[parity][size_t(i) * bpp];
+      switch (bpp) {
+        case 1: *dst = uint8_t(colors[parity]); break;
+        case 2: *reinterpret_cast<uint16_t*>(dst) = uint16_t(colors[parity]); break;
+        case 4: *reinterpret_cast<uint32_t*>(dst) = colors[parity]; break;
+      }
     }
-    u = u_start;
-    ++v;
+  }
+
+  for (y = dstBounds.y; y < dstBounds.y2(); ++y) {
+    const int vv = v + (y - y_start + tile_h) / tile_h;
+    std::memcpy(image->getPixelAddress(dstBounds.x, y), rows[vv & 1].data(), rowSize);
   }
 }
 
@@ -1184,6 +1513,119 @@ void Render::renderPlan(RenderPlan& plan,
   }
 }
 
+const Image* Render::getTilemapRowStrip(const Image* cel_image,
+                                        const Tileset* tileset,
+                                        const doc::Grid& grid,
+                                        const Palette* pal,
+                                        const int v)
+{
+  if (!m_sprite)
+    return nullptr;
+
+  const int w = cel_image->width();
+
+  // Collect the current row state, used to validate a cached strip
+  // (and to know what we have to resolve into a new one).
+  std::vector<tile_t> cells(w);
+  std::vector<ObjectId> tileIds(w);
+  std::vector<ObjectVersion> tileVersions(w);
+  for (int u = 0; u < w; ++u) {
+    const tile_t t = get_pixel_fast<TilemapTraits>(cel_image, u, v);
+    cells[u] = t;
+    tileIds[u] = NullId;
+    tileVersions[u] = 0;
+    if (t != doc::notile) {
+      if (const ImageRef tileImg = tileset->get(tile_geti(t))) {
+        tileIds[u] = tileImg->id();
+        tileVersions[u] = tileImg->version();
+      }
+    }
+  }
+
+  const ObjectId tilemapId = cel_image->id();
+  for (auto it = m_tilemapStripCache.begin(); it != m_tilemapStripCache.end(); ++it) {
+    if (it->tilemap != tilemapId || it->row != v)
+      continue;
+
+    if (it->cells == cells && it->tileIds == tileIds && it->tileVersions == tileVersions) {
+      // Cache hit: move the entry to the front (LRU order)
+      if (it != m_tilemapStripCache.begin())
+        std::rotate(m_tilemapStripCache.begin(), it, it + 1);
+      return m_tilemapStripCache.front().image.get();
+    }
+
+    // Out-of-date (the row cells or some tile pixels changed)
+    m_tilemapStripCache.erase(it);
+    break;
+  }
+
+  const gfx::Rect stripBounds = grid.tileToCanvas(gfx::Rect(0, v, w, 1));
+  if (stripBounds.w < 1 || stripBounds.h < 1)
+    return nullptr;
+
+  ImageRef image(Image::create(m_sprite->pixelFormat(), stripBounds.w, stripBounds.h));
+  image->setMaskColor(m_sprite->transparentColor());
+  clear_image(image.get(), image->maskColor());
+
+  for (int u = 0; u < w; ++u) {
+    const tile_t t = cells[u];
+    if (t == doc::notile)
+      continue;
+
+    const ImageRef tileImg = tileset->get(tile_geti(t));
+    if (!tileImg)
+      continue;
+
+    // Give up caching if tiles don't match the sprite pixel format
+    // (the per-tile code path handles any conversion).
+    if (tileImg->pixelFormat() != image->pixelFormat())
+      return nullptr;
+
+    const tile_flags f = tile_getf(t);
+    const CompositeImageFunc fn = get_tile_resolution_path(image->pixelFormat(), f);
+    if (!fn)
+      return nullptr;
+
+    const gfx::Rect tileBounds = grid.tileToCanvas(gfx::Rect(u, v, 1, 1));
+    fn(image.get(),
+       tileImg.get(),
+       pal,
+       gfx::ClipF(tileBounds.x - stripBounds.x,
+                  tileBounds.y - stripBounds.y,
+                  0,
+                  0,
+                  tileBounds.w,
+                  tileBounds.h),
+       255,
+       BlendMode::NORMAL,
+       1.0,
+       1.0,
+       m_newBlendMethod,
+       f);
+  }
+
+  TilemapStrip strip;
+  strip.tilemap = tilemapId;
+  strip.row = v;
+  strip.cells = std::move(cells);
+  strip.tileIds = std::move(tileIds);
+  strip.tileVersions = std::move(tileVersions);
+  strip.image = image;
+  m_tilemapStripCache.insert(m_tilemapStripCache.begin(), std::move(strip));
+
+  // Evict least-recently-used strips when we exceed the byte budget
+  size_t total = 0;
+  for (size_t i = 0; i < m_tilemapStripCache.size(); ++i) {
+    total += m_tilemapStripCache[i].image->getMemSize();
+    if (total > kTilemapStripCacheLimit && i > 0) {
+      m_tilemapStripCache.erase(m_tilemapStripCache.begin() + i, m_tilemapStripCache.end());
+      break;
+    }
+  }
+
+  return m_tilemapStripCache.front().image.get();
+}
+
 void Render::renderCel(Image* dst_image,
                        const Cel* cel,
                        const Sprite* sprite,
@@ -1289,7 +1731,19 @@ void Render::renderCel(Image* dst_image,
                      tilesToDraw.w,
                      tilesToDraw.h);
 
-    for (int v = tilesToDraw.y; v < tilesToDraw.y2(); ++v) {
+    // Whole rows can be composited from the rendered-row strip cache
+    // (like a flat layer) when we are drawing the real cel content
+    // with its real tileset (i.e. no preview image/tileset and no
+    // extra cel), except into another tilemap.
+    const bool useStrips = (dst_image->pixelFormat() != IMAGE_TILEMAP && m_sprite && cel &&
+                            cel_image == cel->image() && tileset == tilemapLayer->tileset());
+    const CompositeImageFunc stripComposite =
+      (useStrips ? getImageComposition(dst_image->pixelFormat(), m_sprite->pixelFormat(), nullptr) :
+                   nullptr);
+
+    // Composites one row of the map resolving each cell through the
+    // tileset (fallback when the row cannot come from the cache).
+    auto drawTileRow = [&](const int v) {
       for (int u = tilesToDraw.x; u < tilesToDraw.x2(); ++u) {
         auto tileBoundsOnCanvas = grid.tileToCanvas(gfx::Rect(u, v, 1, 1));
         TRACE_RENDER_CEL(" - tile (%d %d) -> (%d %d %d %d)\n",
@@ -1326,6 +1780,23 @@ void Render::renderCel(Image* dst_image,
           }
         }
       }
+    };
+
+    for (int v = tilesToDraw.y; v < tilesToDraw.y2(); ++v) {
+      if (useStrips && stripComposite) {
+        if (const Image* strip = getTilemapRowStrip(cel_image, tileset, grid, pal, v)) {
+          renderImage(dst_image,
+                      strip,
+                      pal,
+                      gfx::RectF(grid.tileToCanvas(gfx::Rect(0, v, cel_image->width(), 1))),
+                      area,
+                      stripComposite,
+                      opacity,
+                      blendMode);
+          continue;
+        }
+      }
+      drawTileRow(v);
     }
   }
   else {
@@ -1,5 +1,5 @@
 // Aseprite Render Library
-// Copyright (c) 2019-2023 Igara Studio S.A.
+// Copyright (c) 2019-2026 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -24,6 +24,8 @@
 #include "render/onionskin_options.h"
 #include "render/projection.h"
 
+#include <vector>
+
 namespace doc {
 class Cel;
 class Image;
@@ -59,6 +61,17 @@ public:
   void setRefLayersVisiblity(const bool visible);
   void setNonactiveLayersOpacity(const int opacity);
   void setNewBlend(const bool newBlend);
+
+  // Enables compositing renderSprite() output in square tiles across
+  // a thread pool (layer blending is independent per tile). Useful
+  // for full-canvas renders of big sprites; small areas keep the
+  // single-threaded path.
+  void setTileParallelism(const bool tileParallelism);
+
+  // Tile side used by the tile-parallel path (256 pixels by default).
+  // Callers can set a size tuned for the machine (e.g. smaller tiles
+  // on slow CPUs for better load balancing).
+  void setTileSize(const int tileSize);
   void setComposeGroups(bool composeGroup);
   void setProjection(const Projection& projection);
   void setBgOptions(const BgOptions& bg);
@@ -125,6 +138,8 @@ public:
                  const BlendMode blendMode);
 
 private:
+  void renderSpriteTiled(Image* dstImage, const Sprite* sprite, frame_t frame, const gfx::ClipF& area);
+
   void renderSpriteLayers(Image* dstImage,
                           const gfx::ClipF& area,
                           frame_t frame,
@@ -142,6 +157,22 @@ private:
                        const frame_t frame,
                        const CompositeImageFunc compositeImage);
 
+  // Returns a cached plane with the given onion-skin frame already
+  // composited (at 1:1 scale, full opacity, in dstFormat), rendering
+  // it only when the frame content changed since the last call.
+  // Returns nullptr when the frame cannot be cached (e.g. active
+  // previews/extra cels, huge sprites, tilemaps) and the caller must
+  // composite the frame the slow way.
+  const Image* getOnionskinPlane(doc::RenderPlan& plan,
+                                 const frame_t frame,
+                                 const PixelFormat dstFormat,
+                                 const bool renderBackground);
+
+  uint64_t onionskinPlaneKey(const doc::RenderPlan& plan,
+                             const frame_t frame,
+                             const PixelFormat dstFormat,
+                             const bool renderBackground) const;
+
   void renderPlan(doc::RenderPlan& plan,
                   Image* image,
                   const gfx::Clip& area,
@@ -179,6 +210,18 @@ private:
 
   bool checkIfWeShouldUsePreview(const Cel* cel) const;
 
+  // Returns a horizontal strip of the tilemap row "v" with all its
+  // tiles already resolved (flips applied, 1:1 scale, tileset pixel
+  // format), rebuilding it only when the row cells or the pixels of
+  // its referenced tiles changed since the last call. Returns nullptr
+  // if the row cannot be cached (e.g. unsupported tile format) and
+  // the caller must composite tile by tile.
+  const Image* getTilemapRowStrip(const Image* cel_image,
+                                  const Tileset* tileset,
+                                  const doc::Grid& grid,
+                                  const Palette* pal,
+                                  const int v);
+
   int m_flags;
   int m_nonactiveLayersOpacity;
   const Sprite* m_sprite;
@@ -190,6 +233,8 @@ private:
   const Image* m_extraImage;
   BlendMode m_extraBlendMode;
   bool m_newBlendMethod;
+  bool m_tileParallelism;
+  int m_tileSize;
   BgOptions m_bg;
   int m_globalOpacity;
   const Layer* m_selectedLayerForOpacity;
@@ -200,6 +245,36 @@ private:
   gfx::Point m_previewPos;
   BlendMode m_previewBlendMode;
   OnionskinOptions m_onionskin;
+
+  // Pre-composited onion-skin frames so repaints (e.g. scrubbing the
+  // timeline) only re-blend each plane with its opacity/tint instead
+  // of re-compositing all its layers. Each plane is keyed with a hash
+  // of the source cels, so editing a frame only invalidates its own
+  // plane.
+  struct OnionskinPlane {
+    frame_t frame;
+    uint64_t key;
+    ImageRef image;
+  };
+  std::vector<OnionskinPlane> m_onionskinCache;
+
+  // Rendered-row cache for tilemap layers: each entry is one tilemap
+  // row composited as a flat strip (see getTilemapRowStrip()), so
+  // scrolling a big tilemap re-blends full strips like a regular
+  // flat layer instead of resolving each map cell through the
+  // tileset. Entries remember the cell values and the version of
+  // each referenced tile image, so editing a tile only rebuilds the
+  // strips that use it. Kept in LRU order (front = most recent).
+  struct TilemapStrip {
+    doc::ObjectId tilemap; // Id of the tilemap image
+    int row;
+    std::vector<tile_t> cells;
+    std::vector<doc::ObjectId> tileIds;
+    std::vector<doc::ObjectVersion> tileVersions;
+    ImageRef image;
+  };
+  std::vector<TilemapStrip> m_tilemapStripCache;
+
   ImageBufferPtr m_tmpBuf;
   bool m_composeGroups = false;
 };
@@ -251,6 +251,49 @@ TEST(Render, BugWithMultiplesOf3ZoomFactors)
   }
 }
 
+TEST(Render, OnionskinCacheInvalidation)
+{
+  std::shared_ptr<Document> doc = std::make_shared<Document>();
+  doc->sprites().add(Sprite::MakeStdSprite(ImageSpec(ColorMode::RGB, 2, 2)));
+  Sprite* sprite = doc->sprite();
+  sprite->addFrame(frame_t(1));
+
+  auto layer = static_cast<LayerImage*>(sprite->root()->firstLayer());
+
+  // Frame 0: only the top-left pixel is opaque
+  Image* img0 = layer->cel(frame_t(0))->image();
+  clear_image(img0, 0);
+  put_pixel(img0, 0, 0, rgba(255, 0, 0, 255));
+
+  // Frame 1: empty
+  ImageRef img1(Image::create(IMAGE_RGB, 2, 2));
+  clear_image(img1.get(), 0);
+  layer->addCel(new Cel(frame_t(1), img1));
+
+  Render render;
+  OnionskinOptions opts(OnionskinType::MERGE);
+  opts.prevFrames(1);
+  opts.opacityBase(128);
+  render.setOnionskin(opts);
+
+  std::unique_ptr<Image> dst(Image::create(IMAGE_RGB, 2, 2));
+  render.renderSprite(dst.get(), sprite, frame_t(1));
+  EXPECT_NE(0u, get_pixel(dst.get(), 0, 0)); // Onion skin of frame 0
+  EXPECT_EQ(0u, get_pixel(dst.get(), 1, 1));
+
+  // A second render (now using the cached onion-skin plane) must
+  // produce the same output
+  std::unique_ptr<Image> dst2(Image::create(IMAGE_RGB, 2, 2));
+  render.renderSprite(dst2.get(), sprite, frame_t(1));
+  EXPECT_TRUE(is_same_image(dst.get(), dst2.get()));
+
+  // Editing frame 0 must invalidate its cached plane
+  put_pixel(img0, 1, 1, rgba(0, 0, 255, 255));
+  img0->incrementVersion();
+  render.renderSprite(dst.get(), sprite, frame_t(1));
+  EXPECT_NE(0u, get_pixel(dst.get(), 1, 1));
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
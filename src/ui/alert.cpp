@@ -1,5 +1,5 @@
 // Aseprite UI Library
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -40,6 +40,7 @@
 #include "ui/box.h"
 #include "ui/button.h"
 #include "ui/grid.h"
+#include "ui/image_view.h"
 #include "ui/label.h"
 #include "ui/scale.h"
 #include "ui/separator.h"
@@ -51,7 +52,11 @@
 
 namespace ui {
 
-Alert::Alert() : Window(WithTitleBar), m_progress(nullptr), m_progressPlaceholder(nullptr)
+Alert::Alert()
+  : Window(WithTitleBar)
+  , m_progress(nullptr)
+  , m_imageView(nullptr)
+  , m_progressPlaceholder(nullptr)
 {
   auto box1 = new Box(VERTICAL);
   auto box2 = new Box(VERTICAL);
@@ -67,12 +72,14 @@ Alert::Alert() : Window(WithTitleBar), m_progress(nullptr), m_progressPlaceholde
   // Pseudo separators (only to fill blank space)
   auto box4 = new Box(0);
   auto box5 = new Box(0);
+  m_imagePlaceholder = new Box(HORIZONTAL);
   m_progressPlaceholder = new Box(0);
 
   box4->setExpansive(true);
   box5->setExpansive(true);
   box4->noBorderNoChildSpacing();
   box5->noBorderNoChildSpacing();
+  m_imagePlaceholder->noBorderNoChildSpacing();
   m_progressPlaceholder->noBorderNoChildSpacing();
 
   // Setup parent <-> children relationship
@@ -80,6 +87,7 @@ Alert::Alert() : Window(WithTitleBar), m_progress(nullptr), m_progressPlaceholde
   addChild(box1);
 
   box1->addChild(box4); // Filler
+  box1->addChild(m_imagePlaceholder);
   box1->addChild(box2); // Labels
   box1->addChild(m_progressPlaceholder);
   box1->addChild(box5); // Filler
@@ -141,6 +149,22 @@ CheckBox* Alert::addCheckBox(const std::string& text)
   return checkBox;
 }
 
+void Alert::addImage(const os::Ref<os::Surface>& surface)
+{
+  if (m_imageView) {
+    m_imagePlaceholder->removeChild(m_imageView);
+    delete m_imageView;
+  }
+
+  m_imageView = new ImageView(surface, CENTER);
+  m_imageView->setExpansive(true);
+  m_imagePlaceholder->addChild(m_imageView);
+  m_imagePlaceholder->setVisible(true);
+
+  if (isVisible())
+    expandWindow(sizeHint());
+}
+
 void Alert::setProgress(double progress)
 {
   ASSERT(m_progress);
@@ -1,5 +1,5 @@
 // Aseprite UI Library
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,16 +9,22 @@
 #define UI_ALERT_H_INCLUDED
 #pragma once
 
+#include "os/ref.h"
 #include "ui/window.h"
 
 #include <memory>
 #include <string>
 #include <vector>
 
+namespace os {
+class Surface;
+}
+
 namespace ui {
 
 class Box;
 class CheckBox;
+class ImageView;
 class Slider;
 
 class Alert;
@@ -36,6 +42,12 @@ public:
   void addProgress();
   void setProgress(double progress);
 
+  // Adds (or replaces) an image shown above the labels. Can be
+  // called while the window is already open (e.g. a preview that
+  // becomes available in the middle of a job), in that case the
+  // window is expanded to make room for it.
+  void addImage(const os::Ref<os::Surface>& surface);
+
   CheckBox* addCheckBox(const std::string& text);
 
   int show();
@@ -47,6 +59,8 @@ private:
   void processString(std::string& buf);
 
   Slider* m_progress;
+  ImageView* m_imageView;
+  Box* m_imagePlaceholder;
   Box* m_labelsPlaceholder;
   Box* m_buttonsPlaceholder;
   Box* m_progressPlaceholder;
@@ -1,5 +1,5 @@
 // Aseprite UI Library
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -31,6 +31,7 @@
 #include "text/text_blob.h"
 #include "ui/display.h"
 #include "ui/scale.h"
+#include "ui/text_blob_cache.h"
 #include "ui/theme.h"
 
 #include <algorithm>
@@ -456,7 +457,7 @@ void Graphics::drawUIText(const std::string& str,
     return;
 
   auto fontMgr = get_theme()->fontMgr();
-  auto textBlob = text::TextBlob::MakeWithShaper(fontMgr, m_font, str);
+  auto textBlob = get_cached_text_blob(fontMgr, m_font, str);
 
   Paint paint;
   if (gfx::geta(bg) > 0) { // Paint background
@@ -598,8 +599,7 @@ gfx::Size Graphics::doUIStringAlgorithm(const std::string& str,
     else
       line = str.substr(beg);
 
-    text::TextBlobRef lineBlob =
-      text::TextBlob::MakeWithShaper(get_theme()->fontMgr(), m_font, line);
+    text::TextBlobRef lineBlob = get_cached_text_blob(get_theme()->fontMgr(), m_font, line);
     gfx::SizeF lineSize;
     if (lineBlob) {
       lineSize = lineBlob->bounds().size();
@@ -1,5 +1,5 @@
 // Aseprite UI Library
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -21,6 +21,7 @@
 
 #include "ui/manager.h"
 
+#include "base/chrono.h"
 #include "base/concurrent_queue.h"
 #include "base/contains.h"
 #include "base/remove_from_container.h"
@@ -37,6 +38,7 @@
 #include "ui/base.h"
 #include "ui/drag_event.h"
 #include "ui/intern.h"
+#include "ui/perf_probe.h"
 #include "ui/ui.h"
 
 #include <algorithm>
@@ -84,6 +86,7 @@ typedef std::list<Message*> Messages;
 typedef std::list<Filter*> Filters;
 
 Manager* Manager::m_defaultManager = nullptr;
+Manager::PaintCounters Manager::m_paintCounters;
 
 static std::thread::id manager_thread;
 
@@ -349,6 +352,8 @@ bool Manager::generateMessages()
 {
   ASSERT(manager_thread == std::this_thread::get_id());
 
+  PerfProbe probe("ui::Manager::generateMessages");
+
   // First check: there are windows to manage?
   if (children().empty())
     return false;
@@ -628,6 +633,24 @@ void Manager::handleMouseMove(Display* display,
 
   // Send the mouse movement message
   Widget* dst = (capture_widget ? capture_widget : mouse_widget);
+
+  // When nobody captured the mouse there is no drag/paint loop
+  // interested in the full movement path, only the latest position
+  // matters for hover feedback. So we can coalesce consecutive
+  // movements to the same widget, keeping the hover latency at one
+  // round even when events pile up behind a slow repaint or come
+  // from a high-rate pointing device. Movements with the mouse
+  // captured are kept untouched because tools consume every point of
+  // the stroke.
+  if (!capture_widget && !msg_queue.empty()) {
+    Message* last = msg_queue.back();
+    if (last->type() == kMouseMoveMessage && last->recipient() == dst &&
+        last->display() == display) {
+      delete last;
+      msg_queue.pop_back();
+    }
+  }
+
   enqueueMessage(newMouseMessage(kMouseMoveMessage,
                                  display,
                                  dst,
@@ -1244,6 +1267,22 @@ void Manager::removePaintMessagesForDisplay(Display* display)
   }
 }
 
+void Manager::coalescePaintMessages(Widget* widget, gfx::Region& region)
+{
+  ASSERT(manager_thread == std::this_thread::get_id());
+
+  for (auto it = msg_queue.begin(); it != msg_queue.end();) {
+    Message* msg = *it;
+    if (msg->type() == kPaintMessage && msg->recipient() == widget) {
+      region |= gfx::Region(static_cast<PaintMessage*>(msg)->rect());
+      delete msg;
+      it = msg_queue.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
 void Manager::addMessageFilter(int message, Widget* widget)
 {
   ASSERT(manager_thread == std::this_thread::get_id());
@@ -2038,7 +2077,12 @@ bool Manager::sendMessageToWidget(Message* msg, Widget* widget)
 #endif
 
       // Call the message handler
+      base::Chrono chrono;
       used = widget->sendMessage(msg);
+
+      m_paintCounters.messages++;
+      m_paintCounters.pixels += uint64_t(paintMsg->rect().w) * uint64_t(paintMsg->rect().h);
+      m_paintCounters.seconds += chrono.elapsed();
     }
 
     // Restore clip region for paint messages.
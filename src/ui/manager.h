@@ -101,6 +101,25 @@ public:
   void removeMessagesForDisplay(Display* display);
   void removePaintMessagesForDisplay(Display* display);
 
+  // Removes the queued (not yet dispatched) paint messages for the
+  // given widget, merging their areas into the given region. Used by
+  // Widget::flushRedraw() to coalesce all the damage of one widget
+  // into one batch of disjoint rectangles, so each screen pixel is
+  // painted at most once even if it was invalidated several times
+  // between redraws.
+  void coalescePaintMessages(Widget* widget, gfx::Region& region);
+
+  // Accumulated kPaintMessage statistics, useful to measure overdraw
+  // (painted pixels per frame) and paint time from benchmarks or
+  // devmode tools.
+  struct PaintCounters {
+    uint64_t messages = 0; // Number of processed paint messages
+    uint64_t pixels = 0;   // Sum of the painted areas in pixels
+    double seconds = 0.0;  // Time spent inside paint handlers
+  };
+  static const PaintCounters& paintCounters() { return m_paintCounters; }
+  static void resetPaintCounters() { m_paintCounters = PaintCounters(); }
+
   void addMessageFilter(int message, Widget* widget);
   void removeMessageFilter(int message, Widget* widget);
   void removeMessageFilterFor(Widget* widget);
@@ -219,6 +238,7 @@ private:
   void broadcastKeyMsg(Message* msg);
 
   static Manager* m_defaultManager;
+  static PaintCounters m_paintCounters;
 
   WidgetsList m_garbage;
   Display m_display;
@@ -0,0 +1,137 @@
+// Aseprite UI Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "ui/perf_probe.h"
+
+#include "ui/system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <ostream>
+
+namespace ui {
+
+namespace {
+
+// Ring buffer of the most recent events: enough for a couple of
+// minutes of interactive work, bounded so leaving the probes enabled
+// doesn't grow memory.
+constexpr int kMaxEvents = 65536;
+
+struct Event {
+  const char* name;
+  long long startUs;
+  long long durUs;
+};
+
+struct Aggregate {
+  int count = 0;
+  long long totalUs = 0;
+  long long maxUs = 0;
+};
+
+bool g_enabled = false;
+std::vector<Event> g_events;
+int g_nextEvent = 0;
+
+// Aggregates since the last get_perf_probe_stats() call. Keyed by
+// name pointer: probe names are string literals so the same probe
+// always passes the same address.
+std::map<const char*, Aggregate> g_aggregates;
+
+long long now_us()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+} // anonymous namespace
+
+bool perf_probes_enabled()
+{
+  return g_enabled;
+}
+
+void set_perf_probes_enabled(const bool state)
+{
+  assert_ui_thread();
+
+  if (g_enabled == state)
+    return;
+
+  g_enabled = state;
+  if (state && g_events.capacity() == 0)
+    g_events.reserve(kMaxEvents);
+}
+
+PerfProbe::PerfProbe(const char* name) : m_name(name), m_start(g_enabled ? now_us() : -1)
+{
+}
+
+PerfProbe::~PerfProbe()
+{
+  if (m_start < 0)
+    return;
+
+  assert_ui_thread();
+
+  const Event ev = { m_name, m_start, now_us() - m_start };
+  if (int(g_events.size()) < kMaxEvents) {
+    g_events.push_back(ev);
+  }
+  else {
+    g_events[g_nextEvent] = ev;
+    g_nextEvent = (g_nextEvent + 1) % kMaxEvents;
+  }
+
+  Aggregate& a = g_aggregates[m_name];
+  ++a.count;
+  a.totalUs += ev.durUs;
+  a.maxUs = std::max(a.maxUs, ev.durUs);
+}
+
+std::vector<PerfProbeStats> get_perf_probe_stats()
+{
+  assert_ui_thread();
+
+  std::vector<PerfProbeStats> result;
+  result.reserve(g_aggregates.size());
+  for (const auto& [name, a] : g_aggregates) {
+    result.push_back(PerfProbeStats{ name,
+                                     a.count,
+                                     0.001 * a.totalUs / a.count,
+                                     0.001 * a.maxUs });
+  }
+  g_aggregates.clear();
+  return result;
+}
+
+void write_perf_trace(std::ostream& os)
+{
+  assert_ui_thread();
+
+  os << "{\"traceEvents\":[";
+
+  // Oldest events first (the ring might have wrapped around).
+  const int n = int(g_events.size());
+  for (int i = 0; i < n; ++i) {
+    const Event& ev = g_events[(g_nextEvent + i) % n];
+    if (i > 0)
+      os << ",";
+    os << "{\"name\":\"" << ev.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+       << ",\"ts\":" << ev.startUs << ",\"dur\":" << ev.durUs << "}";
+  }
+
+  os << "]}";
+}
+
+} // namespace ui
@@ -0,0 +1,58 @@
+// Aseprite UI Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef UI_PERF_PROBE_H_INCLUDED
+#define UI_PERF_PROBE_H_INCLUDED
+#pragma once
+
+#include <iosfwd>
+#include <vector>
+
+namespace ui {
+
+// Scoped probes to measure hot paths of the UI thread in production
+// builds (e.g. sprite rendering, message generation, tool loops).
+// When probes are disabled (the default) each probe is just one
+// boolean check, so the instrumented code can ship enabled in release
+// builds. Probed times can be shown on-screen (Editor overlay) or
+// dumped as a JSON trace (DumpPerfTrace command).
+
+bool perf_probes_enabled();
+void set_perf_probes_enabled(const bool state);
+
+// Measures the time between its construction and destruction and
+// records one event in the trace buffer. The name must be a string
+// literal (it's stored by pointer).
+class PerfProbe {
+public:
+  PerfProbe(const char* name);
+  ~PerfProbe();
+
+private:
+  const char* m_name;
+  long long m_start; // Microseconds (-1 when probes are disabled)
+};
+
+struct PerfProbeStats {
+  const char* name;
+  int count;
+  double avgMs;
+  double maxMs;
+};
+
+// Returns the times aggregated per probe name since the last call
+// (i.e. each call starts a new measurement window). Used by the
+// on-screen overlay to show stats between repaints.
+std::vector<PerfProbeStats> get_perf_probe_stats();
+
+// Writes all the events still in the trace buffer using the Trace
+// Event format, so the output can be opened with chrome://tracing or
+// Perfetto.
+void write_perf_trace(std::ostream& os);
+
+} // namespace ui
+
+#endif
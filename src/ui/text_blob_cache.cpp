@@ -0,0 +1,80 @@
+// Aseprite UI Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "ui/text_blob_cache.h"
+
+#include "text/font.h"
+#include "text/text_blob.h"
+#include "ui/system.h"
+
+#include <list>
+#include <map>
+#include <utility>
+
+namespace ui {
+
+namespace {
+
+// Maximum number of cached blobs: big enough to cover all the
+// visible text of several panels, small enough so stale strings
+// (e.g. old status bar messages) don't accumulate.
+constexpr int kMaxCachedBlobs = 512;
+
+struct CachedBlob {
+  // Keeps the font alive so the key (its address) cannot be reused
+  // by another font while this entry exists.
+  text::FontRef font;
+  std::string text;
+  text::TextBlobRef blob;
+};
+
+// Most recently used blobs are moved to the front of the list,
+// eviction happens at the back. The map only indexes the list.
+using BlobList = std::list<CachedBlob>;
+using BlobKey = std::pair<const text::Font*, std::string>;
+
+BlobList g_blobs;
+std::map<BlobKey, BlobList::iterator> g_index;
+
+} // anonymous namespace
+
+text::TextBlobRef get_cached_text_blob(const text::FontMgrRef& fontMgr,
+                                       const text::FontRef& font,
+                                       const std::string& text)
+{
+  assert_ui_thread();
+
+  if (!font || text.empty())
+    return nullptr;
+
+  BlobKey key(font.get(), text);
+  auto it = g_index.find(key);
+  if (it != g_index.end()) {
+    g_blobs.splice(g_blobs.begin(), g_blobs, it->second);
+    return g_blobs.front().blob;
+  }
+
+  text::TextBlobRef blob = text::TextBlob::MakeWithShaper(fontMgr, font, text);
+  if (!blob)
+    return nullptr;
+
+  g_blobs.push_front(CachedBlob{ font, text, blob });
+  g_index[std::move(key)] = g_blobs.begin();
+
+  if (int(g_blobs.size()) > kMaxCachedBlobs) {
+    const CachedBlob& last = g_blobs.back();
+    g_index.erase(BlobKey(last.font.get(), last.text));
+    g_blobs.pop_back();
+  }
+
+  return blob;
+}
+
+} // namespace ui
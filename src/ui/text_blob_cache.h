@@ -0,0 +1,29 @@
+// Aseprite UI Library
+// Copyright (C) 2026  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef UI_TEXT_BLOB_CACHE_H_INCLUDED
+#define UI_TEXT_BLOB_CACHE_H_INCLUDED
+#pragma once
+
+#include "text/fwd.h"
+
+#include <string>
+
+namespace ui {
+
+// Returns a shaped TextBlob for the given font/text pair, reusing a
+// recently shaped one when possible. Shaping text is a slow
+// operation and the UI re-paints the same strings (menu items,
+// timeline layer names, status bar text, etc.) frame after frame, so
+// blobs are kept in a small LRU cache. Must be called from the UI
+// thread.
+text::TextBlobRef get_cached_text_blob(const text::FontMgrRef& fontMgr,
+                                       const text::FontRef& font,
+                                       const std::string& text);
+
+} // namespace ui
+
+#endif
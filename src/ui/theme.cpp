@@ -1,5 +1,5 @@
 // Aseprite UI Library
-// Copyright (C) 2019-2025  Igara Studio S.A.
+// Copyright (C) 2019-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -25,6 +25,7 @@
 #include "ui/size_hint_event.h"
 #include "ui/style.h"
 #include "ui/system.h"
+#include "ui/text_blob_cache.h"
 #include "ui/view.h"
 #include "ui/widget.h"
 #include "ui/window.h"
@@ -523,7 +524,7 @@ void Theme::paintLayer(Graphics* g,
         }
         else {
           if (!textBlob || style->font() != nullptr)
-            textBlob = text::TextBlob::MakeWithShaper(m_fontMgr, g->font(), text);
+            textBlob = get_cached_text_blob(m_fontMgr, g->font(), text);
 
           if (textBlob) {
             const gfx::RectF blobSize = textBlob->bounds();
@@ -567,8 +568,18 @@ void Theme::paintLayer(Graphics* g,
 
     case Style::Layer::Type::kIcon: {
       os::Surface* icon = providedIcon ? providedIcon : layer.icon();
-      if (icon) {
-        const gfx::Size iconSize(icon->width(), icon->height());
+
+      // Prefer the sprite sheet + sprite bounds when the theme
+      // provided them for this icon: drawing the sub-rectangle
+      // directly from the (shared) sheet means every icon samples the
+      // same texture, so GPU backends can batch all the icons of a
+      // widget/toolbar in one draw instead of binding one tiny
+      // texture per icon.
+      const bool fromSheet = (!providedIcon && layer.spriteSheet() &&
+                              !layer.spriteBounds().isEmpty());
+      if (icon || fromSheet) {
+        const gfx::Size iconSize = (fromSheet ? layer.spriteBounds().size() :
+                                                gfx::Size(icon->width(), icon->height()));
         const gfx::Border padding = style->padding();
         gfx::Point pt;
 
@@ -590,7 +601,29 @@ void Theme::paintLayer(Graphics* g,
 
         pt += layer.offset();
 
-        if (layer.color() != gfx::ColorNone)
+        if (fromSheet) {
+          const gfx::Rect& sprite = layer.spriteBounds();
+          if (layer.color() != gfx::ColorNone) {
+            g->drawColoredRgbaSurface(layer.spriteSheet(),
+                                      layer.color(),
+                                      sprite.x,
+                                      sprite.y,
+                                      pt.x,
+                                      pt.y,
+                                      sprite.w,
+                                      sprite.h);
+          }
+          else {
+            g->drawRgbaSurface(layer.spriteSheet(),
+                               sprite.x,
+                               sprite.y,
+                               pt.x,
+                               pt.y,
+                               sprite.w,
+                               sprite.h);
+          }
+        }
+        else if (layer.color() != gfx::ColorNone)
           g->drawColoredRgbaSurface(icon, layer.color(), pt.x, pt.y);
         else
           g->drawRgbaSurface(icon, pt.x, pt.y);
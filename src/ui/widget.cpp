@@ -1,5 +1,5 @@
 // Aseprite UI Library
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -77,6 +77,8 @@ Widget::Widget(WidgetType type)
   , m_parent(nullptr)
   , m_parentIndex(-1)
   , m_sizeHint(nullptr)
+  , m_cachedSizeHint(0, 0)
+  , m_validSizeHint(false)
   , m_mnemonic(0)
   , m_minSize(0, 0)
   , m_maxSize(std::numeric_limits<int>::max(), std::numeric_limits<int>::max())
@@ -175,8 +177,10 @@ void Widget::setTextQuiet(const std::string& text)
   assert_ui_thread();
 
   // Reset blob
-  if (m_text != text)
+  if (m_text != text) {
     m_blob.reset();
+    invalidateSizeHint();
+  }
 
   m_text = text;
   enableFlags(HAS_TEXT);
@@ -194,6 +198,7 @@ void Widget::setFont(const text::FontRef& font)
   if (m_font != font) {
     m_font = font;
     m_blob.reset();
+    invalidateSizeHint();
     onSetFont();
   }
 }
@@ -221,6 +226,7 @@ void Widget::setTheme(Theme* theme)
 
   m_theme = theme;
   m_font = nullptr;
+  invalidateSizeHint();
 
   for (auto child : children())
     child->setTheme(theme);
@@ -239,6 +245,7 @@ void Widget::setStyle(Style* style)
   m_maxSize = m_theme->calcMaxSize(this, style);
   if (style->font())
     m_font = style->font();
+  invalidateSizeHint();
 }
 
 // ===============================================================
@@ -253,6 +260,7 @@ void Widget::setVisible(bool state)
     if (hasFlags(HIDDEN)) {
       disableFlags(HIDDEN);
       invalidate();
+      invalidateSizeHint(); // Hidden widgets are skipped by parent layouts
 
       onVisible(true);
     }
@@ -262,6 +270,7 @@ void Widget::setVisible(bool state)
       if (auto man = manager())
         man->freeWidget(this); // Free from manager
       enableFlags(HIDDEN);
+      invalidateSizeHint();
 
       // As this widget was hidden we need to invalidate the area it was
       // occupying
@@ -281,6 +290,7 @@ void Widget::setEnabled(bool state)
     if (hasFlags(DISABLED)) {
       disableFlags(DISABLED);
       invalidate();
+      invalidateSizeHint(); // Styles can measure differently per state
 
       onEnable(true);
     }
@@ -292,6 +302,7 @@ void Widget::setEnabled(bool state)
 
       enableFlags(DISABLED);
       invalidate();
+      invalidateSizeHint();
 
       onEnable(false);
     }
@@ -306,6 +317,7 @@ void Widget::setSelected(bool state)
     if (!hasFlags(SELECTED)) {
       enableFlags(SELECTED);
       invalidate();
+      invalidateSizeHint();
 
       onSelect(true);
     }
@@ -314,6 +326,7 @@ void Widget::setSelected(bool state)
     if (hasFlags(SELECTED)) {
       disableFlags(SELECTED);
       invalidate();
+      invalidateSizeHint();
 
       onSelect(false);
     }
@@ -596,6 +609,7 @@ void Widget::addChild(Widget* child)
   m_children.push_back(child);
   child->m_parent = this;
   child->m_parentIndex = i;
+  invalidateSizeHint();
 }
 
 void Widget::removeChild(const WidgetsList::iterator& it)
@@ -627,6 +641,7 @@ void Widget::removeChild(const WidgetsList::iterator& it)
 
   child->m_parent = nullptr;
   child->m_parentIndex = -1;
+  invalidateSizeHint();
 }
 
 void Widget::removeChild(Widget* child)
@@ -672,6 +687,7 @@ void Widget::replaceChild(Widget* oldChild, Widget* newChild)
 
   newChild->m_parent = this;
   newChild->m_parentIndex = index;
+  invalidateSizeHint();
 }
 
 void Widget::insertChild(int index, Widget* child)
@@ -689,6 +705,7 @@ void Widget::insertChild(int index, Widget* child)
 
   child->m_parent = this;
   child->m_parentIndex = index;
+  invalidateSizeHint();
 }
 
 void Widget::moveChildTo(Widget* thisChild, Widget* toThisPosition)
@@ -710,6 +727,7 @@ void Widget::moveChildTo(Widget* thisChild, Widget* toThisPosition)
   thisChild->m_parentIndex = to;
   for (++it, end = m_children.end(); it != end; ++it)
     ++(*it)->m_parentIndex;
+  invalidateSizeHint();
 }
 
 // ===============================================================
@@ -718,6 +736,14 @@ void Widget::moveChildTo(Widget* thisChild, Widget* toThisPosition)
 
 void Widget::layout()
 {
+  // layout() is the explicit signal that something in this widget
+  // changed, and some onSizeHint() implementations depend on state
+  // that the widget itself doesn't track (e.g. the active document),
+  // so here we discard the memoized hints of the whole subtree (the
+  // ancestors are dirtied by the regular upward propagation).
+  invalidateSizeHint();
+  invalidateSizeHintsDown();
+
   setBounds(bounds());
   invalidate();
 }
@@ -826,6 +852,7 @@ void Widget::setBoundsQuietly(const gfx::Rect& rc)
 void Widget::setBorder(const Border& br)
 {
   m_border = br;
+  invalidateSizeHint();
 
 #ifdef _DEBUG
   if (m_style) {
@@ -840,6 +867,7 @@ void Widget::setBorder(const Border& br)
 void Widget::setChildSpacing(int childSpacing)
 {
   m_childSpacing = childSpacing;
+  invalidateSizeHint();
 
 #ifdef _DEBUG
   if (m_style) {
@@ -855,6 +883,7 @@ void Widget::noBorderNoChildSpacing()
 {
   m_border = gfx::Border(0, 0, 0, 0);
   m_childSpacing = 0;
+  invalidateSizeHint();
 
 #ifdef _DEBUG
   if (m_style) {
@@ -1094,6 +1123,7 @@ void Widget::setMinSize(const gfx::Size& sz)
   ASSERT(sz.w <= m_maxSize.w);
   ASSERT(sz.h <= m_maxSize.h);
   m_minSize = sz;
+  invalidateSizeHint();
 }
 
 void Widget::setMaxSize(const gfx::Size& sz)
@@ -1101,6 +1131,7 @@ void Widget::setMaxSize(const gfx::Size& sz)
   ASSERT(sz.w >= m_minSize.w);
   ASSERT(sz.h >= m_minSize.h);
   m_maxSize = sz;
+  invalidateSizeHint();
 }
 
 void Widget::setMinMaxSize(const gfx::Size& minSz, const gfx::Size& maxSz)
@@ -1109,16 +1140,19 @@ void Widget::setMinMaxSize(const gfx::Size& minSz, const gfx::Size& maxSz)
   ASSERT(minSz.h <= maxSz.h);
   m_minSize = minSz;
   m_maxSize = maxSz;
+  invalidateSizeHint();
 }
 
 void Widget::resetMinSize()
 {
   m_minSize = gfx::Size(0, 0);
+  invalidateSizeHint();
 }
 
 void Widget::resetMaxSize()
 {
   m_maxSize = gfx::Size(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+  invalidateSizeHint();
 }
 
 void Widget::flushRedraw()
@@ -1161,6 +1195,12 @@ void Widget::flushRedraw()
         widget->m_updateRegion &= drawable;
       }
 
+      // Merge the damage of paint messages still queued for this
+      // widget, so overlapping invalidations between redraws produce
+      // a single batch of disjoint rectangles and each screen pixel
+      // is painted at most once.
+      manager->coalescePaintMessages(widget, widget->m_updateRegion);
+
       std::size_t c, nrects = widget->m_updateRegion.size();
       Region::const_iterator it = widget->m_updateRegion.begin();
 
@@ -1449,6 +1489,13 @@ Size Widget::sizeHint()
   if (m_sizeHint)
     return *m_sizeHint;
 
+  // Return the memoized hint of the last calculation when the widget
+  // constraints didn't change since then (layouts ask for the hint of
+  // each widget several times, and window resizes don't change hints
+  // at all).
+  if (m_validSizeHint)
+    return m_cachedSizeHint;
+
   SizeHintEvent ev(this, Size(0, 0));
 
   // Call onSizeHint() only when the theme is set, as generally
@@ -1461,6 +1508,9 @@ Size Widget::sizeHint()
   Size sz(ev.sizeHint());
   sz.w = std::clamp(sz.w, m_minSize.w, m_maxSize.w);
   sz.h = std::clamp(sz.h, m_minSize.h, m_maxSize.h);
+
+  m_cachedSizeHint = sz;
+  m_validSizeHint = true;
   return sz;
 }
 
@@ -1501,6 +1551,7 @@ void Widget::setSizeHint(const Size& fixedSize)
 {
   delete m_sizeHint;
   m_sizeHint = new Size(fixedSize);
+  invalidateSizeHint();
 }
 
 void Widget::setSizeHint(int fixedWidth, int fixedHeight)
@@ -1513,9 +1564,29 @@ void Widget::resetSizeHint()
   if (m_sizeHint) {
     delete m_sizeHint;
     m_sizeHint = nullptr;
+    invalidateSizeHint();
   }
 }
 
+void Widget::invalidateSizeHint()
+{
+  m_validSizeHint = false;
+
+  // An ancestor with a dirty hint implies that all its own ancestors
+  // (that depend on its subtree) are dirty too, because the bit is
+  // propagated up on each invalidation, so the walk can stop at the
+  // first one that wasn't re-calculated yet.
+  for (Widget* widget = m_parent; widget && widget->m_validSizeHint; widget = widget->m_parent)
+    widget->m_validSizeHint = false;
+}
+
+void Widget::invalidateSizeHintsDown()
+{
+  m_validSizeHint = false;
+  for (auto child : m_children)
+    child->invalidateSizeHintsDown();
+}
+
 // ===============================================================
 // FOCUS & MOUSE
 // ===============================================================
@@ -1824,9 +1895,10 @@ void Widget::onBroadcastMouseMessage(const gfx::Point& screenPos, WidgetsList& t
 
 void Widget::onInitTheme(InitThemeEvent& ev)
 {
-  // Reset cached font and TextBlob
+  // Reset cached font, TextBlob, and size hint
   m_font.reset();
   m_blob.reset();
+  invalidateSizeHint();
 
   // Create a copy of the children list and iterate it, just in case a
   // initTheme() modifies this list (e.g. this can happen in some
@@ -1,5 +1,5 @@
 // Aseprite UI Library
-// Copyright (C) 2018-2025  Igara Studio S.A.
+// Copyright (C) 2018-2026  Igara Studio S.A.
 // Copyright (C) 2001-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -338,6 +338,14 @@ public:
   void setSizeHint(int fixedWidth, int fixedHeight);
   void resetSizeHint();
 
+  // Discards the memoized sizeHint() of this widget and of all its
+  // ancestors (their hints depend on ours). Called automatically from
+  // the member functions that change the layout constraints
+  // (text/font/style/children/borders/etc.); widgets whose
+  // onSizeHint() depends on external state can call it manually when
+  // that state changes.
+  void invalidateSizeHint();
+
   // ===============================================================
   // MOUSE, FOCUS & KEYBOARD
   // ===============================================================
@@ -455,6 +463,7 @@ private:
   void paint(Graphics* graphics, const gfx::Region& drawRegion, const bool isBg);
   bool paintEvent(Graphics* graphics, const bool isBg);
   void setDirtyFlag();
+  void invalidateSizeHintsDown();
 
   WidgetType m_type; // Widget's type
   std::string m_id;  // Widget's id
@@ -472,6 +481,11 @@ private:
   int m_parentIndex; // Location/index of this widget in the parent's Widget::m_children vector
   gfx::Size* m_sizeHint;
 
+  // Memoized result of the last dynamic sizeHint() calculation, valid
+  // until invalidateSizeHint() is called (see that function).
+  gfx::Size m_cachedSizeHint;
+  bool m_validSizeHint;
+
   // Keyboard shortcut to access this widget like Alt+mnemonic.  If
   // kMnemonicModifiersMask bit is zero, it means that the mnemonic
   // can be used without Alt or Command key modifiers (useful for
@@ -1,5 +1,5 @@
 // Aseprite UI Library
-// Copyright (C) 2022  Igara Studio S.A.
+// Copyright (C) 2022-2026  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -55,3 +55,25 @@ TEST(Widget, ParentIndex)
   EXPECT_EQ(2, d.parentIndex());
   EXPECT_EQ(3, c.parentIndex());
 }
+
+TEST(Widget, SizeHintMemoization)
+{
+  // A widget without style hints its minimum size, which lets us
+  // check that changing a constraint discards the memoized hint.
+  Widget a, b;
+  a.addChild(&b);
+
+  b.setMinSize(gfx::Size(10, 10));
+  EXPECT_EQ(gfx::Size(10, 10), b.sizeHint());
+  EXPECT_EQ(gfx::Size(10, 10), b.sizeHint()); // Memoized result
+
+  b.setMinSize(gfx::Size(20, 30));
+  EXPECT_EQ(gfx::Size(20, 30), b.sizeHint());
+
+  // Fixed hints bypass the memoized dynamic hint and restore it when
+  // reset.
+  b.setSizeHint(gfx::Size(5, 5));
+  EXPECT_EQ(gfx::Size(5, 5), b.sizeHint());
+  b.resetSizeHint();
+  EXPECT_EQ(gfx::Size(20, 30), b.sizeHint());
+}